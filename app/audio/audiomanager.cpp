@@ -87,22 +87,12 @@ bool AudioManager::PushToOutput(const AudioParams &params, const QByteArray &sam
     return false;
   }
 
+  // Callers convert into GetConfigOutputParams() before pushing, so in practice the stream
+  // opened at startup is reused here and this only reopens as a fallback
   if (output_params_ != params || output_stream_ == nullptr) {
-    output_params_ = params;
-
-    CloseOutputStream();
-
-    PaStreamParameters p = GetPortAudioParams(params, output_device_);
-
-    PaError r = Pa_OpenStream(&output_stream_, nullptr, &p, output_params_.sample_rate(), paFramesPerBufferUnspecified, paNoFlag, OutputCallback, output_buffer_);
-    if (r != paNoError) {
-      // Unhandled error
-      //qCritical() << "Failed to open output stream:" << Pa_GetErrorText(r);
-      if (error) *error = Pa_GetErrorText(r);
+    if (!OpenOutputStream(params, error)) {
       return false;
     }
-
-    output_buffer_->set_bytes_per_frame(output_params_.samples_to_bytes(1));
   }
 
   output_buffer_->write(samples);
@@ -146,6 +136,27 @@ PaSampleFormat AudioManager::GetPortAudioSampleFormat(SampleFormat fmt)
   return 0;
 }
 
+bool AudioManager::OpenOutputStream(const AudioParams &params, QString *error)
+{
+  output_params_ = params;
+
+  CloseOutputStream();
+
+  PaStreamParameters p = GetPortAudioParams(params, output_device_);
+
+  PaError r = Pa_OpenStream(&output_stream_, nullptr, &p, output_params_.sample_rate(), paFramesPerBufferUnspecified, paNoFlag, OutputCallback, output_buffer_);
+  if (r != paNoError) {
+    // Unhandled error
+    //qCritical() << "Failed to open output stream:" << Pa_GetErrorText(r);
+    if (error) *error = Pa_GetErrorText(r);
+    return false;
+  }
+
+  output_buffer_->set_bytes_per_frame(output_params_.samples_to_bytes(1));
+
+  return true;
+}
+
 void AudioManager::CloseOutputStream()
 {
   if (output_stream_) {
@@ -179,6 +190,13 @@ void AudioManager::SetOutputDevice(PaDeviceIndex device)
   CloseOutputStream();
 }
 
+void AudioManager::ReopenOutputStream()
+{
+  if (output_device_ != paNoDevice && output_buffer_) {
+    OpenOutputStream(GetConfigOutputParams());
+  }
+}
+
 void AudioManager::SetInputDevice(PaDeviceIndex device)
 {
   if (device == paNoDevice) {
@@ -269,6 +287,13 @@ PaDeviceIndex AudioManager::FindDeviceByName(const QString &s, bool is_output_de
   return is_output_device ? Pa_GetDefaultOutputDevice() : Pa_GetDefaultInputDevice();
 }
 
+AudioParams AudioManager::GetConfigOutputParams()
+{
+  return AudioParams(OLIVE_CONFIG("AudioOutputSampleRate").toInt(),
+                     OLIVE_CONFIG("AudioOutputChannelLayout").toULongLong(),
+                     SampleFormat::from_string(OLIVE_CONFIG("AudioOutputSampleFormat").toString().toStdString()));
+}
+
 PaStreamParameters AudioManager::GetPortAudioParams(const AudioParams &params, PaDeviceIndex device)
 {
   PaStreamParameters p;
@@ -284,6 +309,7 @@ PaStreamParameters AudioManager::GetPortAudioParams(const AudioParams &params, P
 
 AudioManager::AudioManager() :
   output_stream_(nullptr),
+  output_buffer_(nullptr),
   input_stream_(nullptr),
   input_encoder_(nullptr)
 {
@@ -305,6 +331,11 @@ AudioManager::AudioManager() :
   output_buffer_ = new PreviewAudioDevice(this);
   output_buffer_->open(PreviewAudioDevice::ReadWrite);
   connect(output_buffer_, &PreviewAudioDevice::Notify, this, &AudioManager::OutputNotify);
+
+  // Open the stream up front at the fixed format from the preferences so the first playback
+  // doesn't stall on Pa_OpenStream, and reopen at the new format when the preferences change
+  connect(this, &AudioManager::OutputParamsChanged, this, &AudioManager::ReopenOutputStream);
+  ReopenOutputStream();
 }
 
 AudioManager::~AudioManager()
@@ -28,6 +28,7 @@
 
 #include "audiovisualwaveform.h"
 #include "audio/audioprocessor.h"
+#include "audio/loudnessanalyzer.h"
 #include "common/define.h"
 #include "codec/ffmpeg/ffmpegencoder.h"
 #include "render/audioplaybackcache.h"
@@ -83,6 +84,24 @@ public:
 
   static PaStreamParameters GetPortAudioParams(const AudioParams &p, PaDeviceIndex device);
 
+  /**
+   * @brief The fixed output format from the user's preferences
+   *
+   * Playback code converts into this format rather than the device following sequence
+   * parameters, so the output stream can stay open when the user switches between sequences.
+   */
+  static AudioParams GetConfigOutputParams();
+
+  /**
+   * @brief Loudness meter fed with the same samples that get pushed to the output device
+   *
+   * Only accessed from the main thread, like PushToOutput.
+   */
+  LoudnessAnalyzer *loudness_meter()
+  {
+    return &loudness_meter_;
+  }
+
 signals:
   void OutputNotify();
 
@@ -95,8 +114,15 @@ private:
 
   static PaSampleFormat GetPortAudioSampleFormat(SampleFormat fmt);
 
+  bool OpenOutputStream(const AudioParams &params, QString *error = nullptr);
+
   void CloseOutputStream();
 
+  /**
+   * @brief (Re)open the output stream at the preferences format on the current device
+   */
+  void ReopenOutputStream();
+
   static AudioManager* instance_;
 
   PaDeviceIndex output_device_;
@@ -109,6 +135,8 @@ private:
 
   FFmpegEncoder *input_encoder_;
 
+  LoudnessAnalyzer loudness_meter_;
+
 };
 
 }
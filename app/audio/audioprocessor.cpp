@@ -36,6 +36,7 @@ AudioProcessor::AudioProcessor()
   filter_graph_ = nullptr;
   in_frame_ = nullptr;
   out_frame_ = nullptr;
+  tempo_ = 1.0;
 }
 
 AudioProcessor::~AudioProcessor()
@@ -82,37 +83,22 @@ bool AudioProcessor::Open(const AudioParams &from, const AudioParams &to, double
   AVFilterContext *previous_filter = buffersrc_ctx_;
 
   // Create tempo
-  bool create_tempo;
-  if ((create_tempo = !qFuzzyCompare(tempo, 1.0))) {
-    // Create audio tempo filters: FFmpeg's atempo can only be set between 0.5 and 2.0. If the requested speed is outside
-    // those boundaries, we need to daisychain more than one together.
-    double base = (tempo > 1.0) ? 2.0 : 0.5;
-    double speed_log = log(tempo) / log(base);
-
-    // This is the number of how many 0.5 or 2.0 tempos we need to daisychain
-    int whole = std::floor(speed_log);
+  QVector<double> tempo_stages = GetTempoStages(tempo);
+  bool create_tempo = !tempo_stages.isEmpty();
 
-    // Set speed_log to the remainder
-    speed_log -= whole;
+  foreach (double filter_tempo, tempo_stages) {
+    previous_filter = CreateTempoFilter(filter_graph_,
+                                        previous_filter,
+                                        filter_tempo);
 
-    for (int i=0;i<=whole;i++) {
-      double filter_tempo = (i == whole) ? std::pow(base, speed_log) : base;
-
-      if (qFuzzyCompare(filter_tempo, 1.0)) {
-        // This filter would do nothing
-        continue;
-      }
-
-      previous_filter = CreateTempoFilter(filter_graph_,
-                                          previous_filter,
-                                          filter_tempo);
-
-      if (!previous_filter) {
-        qCritical() << "Failed to create audio tempo filter";
-        Close();
-        return false;
-      }
+    if (!previous_filter) {
+      qCritical() << "Failed to create audio tempo filter";
+      Close();
+      return false;
     }
+
+    // Keep the contexts around so SetTempo can retune them live
+    tempo_ctxs_.append(previous_filter);
   }
 
   // Create conversion filter
@@ -187,6 +173,7 @@ bool AudioProcessor::Open(const AudioParams &from, const AudioParams &to, double
 
   from_ = from;
   to_ = to;
+  tempo_ = tempo;
 
   return true;
 }
@@ -198,6 +185,8 @@ void AudioProcessor::Close()
     filter_graph_ = nullptr;
     buffersrc_ctx_ = nullptr;
     buffersink_ctx_ = nullptr;
+    tempo_ctxs_.clear();
+    tempo_ = 1.0;
   }
 
   if (in_frame_) {
@@ -211,6 +200,42 @@ void AudioProcessor::Close()
   }
 }
 
+bool AudioProcessor::SetTempo(double tempo)
+{
+  if (!IsOpen()) {
+    qCritical() << "Tried to set tempo on closed processor";
+    return false;
+  }
+
+  if (qFuzzyCompare(tempo, tempo_)) {
+    // Nothing to do
+    return true;
+  }
+
+  QVector<double> tempo_stages = GetTempoStages(tempo);
+
+  if (tempo_stages.size() != tempo_ctxs_.size()) {
+    // The new tempo needs a different number of daisychained filters, which means relinking the
+    // graph - that can't be done live, so the caller has to re-open
+    return false;
+  }
+
+  for (int i=0; i<tempo_stages.size(); i++) {
+    char speed_param[20];
+    snprintf(speed_param, 20, "%f", tempo_stages.at(i));
+
+    int r = avfilter_process_command(tempo_ctxs_.at(i), "tempo", speed_param, nullptr, 0, 0);
+    if (r < 0) {
+      // Fall back to a rebuild on FFmpeg builds where atempo doesn't accept commands
+      return false;
+    }
+  }
+
+  tempo_ = tempo;
+
+  return true;
+}
+
 int AudioProcessor::Convert(float **in, int nb_in_samples, AudioProcessor::Buffer *output)
 {
   if (!IsOpen()) {
@@ -245,6 +270,20 @@ int AudioProcessor::Convert(float **in, int nb_in_samples, AudioProcessor::Buffe
     AudioProcessor::Buffer &result = *output;
     result.resize(nb_channels);
 
+    // Reserve roughly the expected output size up front so the per-frame resizes in the pull
+    // loop below don't each reallocate and copy the buffer
+    if (in && nb_in_samples) {
+      qint64 estimated_samples = qRound64(double(nb_in_samples) * to_.sample_rate() / (from_.sample_rate() * tempo_));
+      int estimated_bytes = estimated_samples * to_.bytes_per_sample_per_channel();
+      if (to_.format().is_packed()) {
+        estimated_bytes *= to_.channel_count();
+      }
+
+      for (int i=0; i<nb_channels; i++) {
+        result[i].reserve(estimated_bytes);
+      }
+    }
+
     int byte_offset = 0;
 
     while (true) {
@@ -285,6 +324,37 @@ void AudioProcessor::Flush()
   }
 }
 
+QVector<double> AudioProcessor::GetTempoStages(double tempo)
+{
+  QVector<double> stages;
+
+  if (!qFuzzyCompare(tempo, 1.0)) {
+    // FFmpeg's atempo can only be set between 0.5 and 2.0. If the requested speed is outside
+    // those boundaries, we need to daisychain more than one together.
+    double base = (tempo > 1.0) ? 2.0 : 0.5;
+    double speed_log = log(tempo) / log(base);
+
+    // This is the number of how many 0.5 or 2.0 tempos we need to daisychain
+    int whole = std::floor(speed_log);
+
+    // Set speed_log to the remainder
+    speed_log -= whole;
+
+    for (int i=0;i<=whole;i++) {
+      double filter_tempo = (i == whole) ? std::pow(base, speed_log) : base;
+
+      if (qFuzzyCompare(filter_tempo, 1.0)) {
+        // This filter would do nothing
+        continue;
+      }
+
+      stages.append(filter_tempo);
+    }
+  }
+
+  return stages;
+}
+
 AVFilterContext *AudioProcessor::CreateTempoFilter(AVFilterGraph* graph, AVFilterContext* link, const double &tempo)
 {
   // Set up tempo param, which is taken as a C string
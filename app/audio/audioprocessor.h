@@ -24,6 +24,7 @@
 #include <inttypes.h>
 #include <olive/core/core.h>
 #include <QByteArray>
+#include <QVector>
 
 extern "C" {
 #include <libavfilter/avfilter.h>
@@ -48,6 +49,18 @@ public:
 
   void Close();
 
+  /**
+   * @brief Change the tempo of an open processor without rebuilding the filter graph
+   *
+   * Sends live process commands to the existing atempo filters, which is far cheaper than a
+   * close/open cycle and doesn't drop any buffered audio. Returns false if the new tempo needs
+   * a different filter chain (or the filters don't support commands), in which case the caller
+   * should fall back to re-opening the processor.
+   */
+  bool SetTempo(double tempo);
+
+  double tempo() const { return tempo_; }
+
   bool IsOpen() const { return filter_graph_; }
 
   using Buffer = QVector<QByteArray>;
@@ -61,12 +74,21 @@ public:
 private:
   static AVFilterContext* CreateTempoFilter(AVFilterGraph *graph, AVFilterContext *link, const double& tempo);
 
+  /**
+   * @brief Decompose a tempo into per-filter values within atempo's 0.5 - 2.0 range
+   */
+  static QVector<double> GetTempoStages(double tempo);
+
   AVFilterGraph* filter_graph_;
 
   AVFilterContext* buffersrc_ctx_;
 
   AVFilterContext* buffersink_ctx_;
 
+  QVector<AVFilterContext*> tempo_ctxs_;
+
+  double tempo_;
+
   AudioParams from_;
   AVSampleFormat from_fmt_;
 
@@ -20,18 +20,32 @@
 
 #include "audiovisualwaveform.h"
 
+#include <QCache>
 #include <QDebug>
+#include <QFile>
+#include <QtMath>
+#include <QtConcurrent/QtConcurrent>
 #include <QtGlobal>
 
 #include "config/config.h"
+#include "samplekernels.h"
 
 namespace olive {
 
 const rational AudioVisualWaveform::kMinimumSampleRate = rational(1, 8);
 const rational AudioVisualWaveform::kMaximumSampleRate = 1024;
 
+// Waveform painting goes through tiles of this width cached by content, zoom and height, so
+// scrolling and repainting mostly blit pixmaps instead of re-running per-pixel line drawing
+const int kWaveformTileWidth = 256;
+
+// Tile pool size in kilobytes. Tiles are cheap to blit but comparatively expensive to
+// regenerate, so this is sized to comfortably hold the visible timeline across many tracks.
+static QCache<QString, QPixmap> waveform_tile_cache(65536);
+
 AudioVisualWaveform::AudioVisualWaveform() :
-  channels_(0)
+  channels_(0),
+  paint_key_(GeneratePaintKey())
 {
   for (rational i=kMinimumSampleRate; i<=kMaximumSampleRate; i*=2) {
     mipmapped_data_.insert({i, Sample()});
@@ -50,17 +64,42 @@ void AudioVisualWaveform::OverwriteSamplesFromBuffer(const SampleBuffer &samples
 
   double chunk_size = double(sample_rate) / double(target_rate);
 
-  for (size_t i=0; i<samples_length; i+=channels_) {
-    size_t src_start = qRound((double(i) * chunk_size)) / channels_;
-    size_t src_end = qMin(size_t(qRound64((double(i + channels_) * chunk_size))) / channels_, samples.sample_count());
+  auto summarize_range = [this, &samples, &data, start_index, chunk_size](size_t from, size_t to) {
+    for (size_t i=from; i<to; i+=channels_) {
+      size_t src_start = qRound((double(i) * chunk_size)) / channels_;
+      size_t src_end = qMin(size_t(qRound64((double(i + channels_) * chunk_size))) / channels_, samples.sample_count());
 
-    Sample summary = SumSamples(samples,
-                                src_start,
-                                src_end - src_start);
+      Sample summary = SumSamples(samples,
+                                  src_start,
+                                  src_end - src_start);
 
-    memcpy(&data.data()[i + start_index],
-        summary.data(),
-        summary.size() * sizeof(SamplePerChannel));
+      memcpy(&data.data()[i + start_index],
+          summary.data(),
+          summary.size() * sizeof(SamplePerChannel));
+    }
+  };
+
+  // Every output sample summarizes an independent slice of the input, so large buffers (e.g.
+  // conforming an hour-long file) are split across the thread pool. Small buffers aren't worth
+  // the dispatch overhead.
+  const size_t minimum_parallel_length = size_t(channels_) * 4096;
+  int thread_count = QThread::idealThreadCount();
+
+  if (samples_length >= minimum_parallel_length && thread_count > 1) {
+    size_t total_chunks = samples_length / channels_;
+    size_t chunks_per_job = (total_chunks + thread_count - 1) / thread_count;
+
+    QVector<QFuture<void> > jobs;
+    for (size_t from=0; from<samples_length; from+=chunks_per_job*channels_) {
+      size_t to = qMin(samples_length, from + chunks_per_job*channels_);
+      jobs.append(QtConcurrent::run(summarize_range, from, to));
+    }
+
+    for (QFuture<void> &job : jobs) {
+      job.waitForFinished();
+    }
+  } else {
+    summarize_range(0, samples_length);
   }
 }
 
@@ -128,6 +167,8 @@ void AudioVisualWaveform::OverwriteSamples(const SampleBuffer &samples, int samp
 
   rational sample_length(samples.sample_count(), sample_rate);
   length_ = qMax(length_, start + sample_length);
+
+  paint_key_ = GeneratePaintKey();
 }
 
 void AudioVisualWaveform::OverwriteSums(const AudioVisualWaveform &sums, const rational &dest, const rational& offset, const rational& length)
@@ -172,6 +213,8 @@ void AudioVisualWaveform::OverwriteSums(const AudioVisualWaveform &sums, const r
   }
 
   length_ = qMax(length_, dest + ((length.isNull()) ? sums.length() - offset : length));
+
+  paint_key_ = GeneratePaintKey();
 }
 
 void AudioVisualWaveform::OverwriteSilence(const rational &start, const rational &length)
@@ -198,6 +241,8 @@ void AudioVisualWaveform::OverwriteSilence(const rational &start, const rational
   }
 
   length_ = qMax(length_, start + length);
+
+  paint_key_ = GeneratePaintKey();
 }
 
 void AudioVisualWaveform::TrimIn(rational length)
@@ -231,6 +276,8 @@ void AudioVisualWaveform::TrimIn(rational length)
   }
 
   length_ = qMax(rational(0), length_ - length);
+
+  paint_key_ = GeneratePaintKey();
 }
 
 AudioVisualWaveform AudioVisualWaveform::Mid(const rational &offset) const
@@ -268,6 +315,8 @@ void AudioVisualWaveform::Resize(const rational &length)
   }
 
   length_ = length;
+
+  paint_key_ = GeneratePaintKey();
 }
 
 void AudioVisualWaveform::TrimRange(const rational &in, const rational &length)
@@ -303,45 +352,8 @@ AudioVisualWaveform::Sample AudioVisualWaveform::GetSummaryFromTime(const ration
 
 void ExpandMinMaxChannel(const float *a, size_t length, float &min_val, float &max_val)
 {
-#if defined(Q_PROCESSOR_X86) || defined(Q_PROCESSOR_ARM)
-  // SSE optimized
-
-  // load the first 4 elements of 'a' into min and max (they are 4 * 32 = 128 bits)
-  __m128 max = _mm_loadu_ps(a);
-  __m128 min = _mm_loadu_ps(a);
-
-  // loop over 'a' and compare current elements with min and max 4 by 4.
-  // we need to make sure we don't read out of boundaries should 'a' length be not mod. 4
-  for(size_t i = 4; i < length-4; i+=4) {
-    __m128 cur = _mm_loadu_ps(a + i);
-    max = _mm_max_ps(max, cur);
-    min = _mm_min_ps(min, cur);
-  }
-  // so we read the last 4 (or less) elements in a safe manner.
-  __m128 cur = _mm_loadu_ps(a + length - 4);
-  max = _mm_max_ps(max, cur);
-  min = _mm_min_ps(min, cur);
-  // this potentially overlaps up to the last 3 elements but it's not an issue.
-
-  // min and max will contain 4 min and max. To get the absolute min and max
-  // we need to compare the 4 values over themselves by shuffling each time.
-  for (size_t i = 0; i < 3; i++) {
-    max = _mm_max_ps(max, _mm_shuffle_ps(max, max, 0x93));
-    min = _mm_min_ps(min, _mm_shuffle_ps(min, min, 0x93));
-  }
-  // now min and max contain 4 identical items each representing min and max value respectively.
-
-  // and we store the first one into a float variable.
-  _mm_store_ss(&max_val, max);
-  _mm_store_ss(&min_val, min);
-  // I bet you don't find annotated low level code very often.
-#else
-  // Standard unoptimized function
-  for (size_t i=0; i<length; i++) {
-    min_val = std::min(min_val, a[i]);
-    max_val = std::max(max_val, a[i]);
-  }
-#endif
+  // Runtime-dispatched to the widest SIMD reduction the CPU supports
+  SampleKernels::MinMax(a, length, &min_val, &max_val);
 }
 
 AudioVisualWaveform::Sample AudioVisualWaveform::SumSamples(const SampleBuffer &samples, size_t start_index, size_t length)
@@ -425,6 +437,35 @@ void AudioVisualWaveform::DrawSample(QPainter *painter, const Sample& sample, in
   }
 }
 
+void AudioVisualWaveform::DrawWaveformPixels(QPainter *painter, const Sample &arr, int channel_count, double rate, double scale, qint64 wave_pixel_start, int pixel_count, int y, int height, bool rectified)
+{
+  Sample summary;
+  size_t summary_index = -1;
+
+  size_t next_sample_index = std::min(arr.size(),
+                                      size_t(std::floor(rate * static_cast<double>(wave_pixel_start) / scale)) * channel_count);
+
+  for (int i=0; i<pixel_count; i++) {
+    size_t sample_index = next_sample_index;
+
+    if (sample_index >= arr.size()) {
+      break;
+    }
+
+    next_sample_index = std::min(arr.size(),
+                                 size_t(std::floor(rate * static_cast<double>(wave_pixel_start + i + 1) / scale)) * channel_count);
+
+    if (summary_index != sample_index) {
+      summary = AudioVisualWaveform::ReSumSamples(&arr.at(sample_index),
+                                                  qMax(size_t(channel_count), next_sample_index - sample_index),
+                                                  channel_count);
+      summary_index = sample_index;
+    }
+
+    DrawSample(painter, summary, i, y, height, rectified);
+  }
+}
+
 void AudioVisualWaveform::DrawWaveform(QPainter *painter, const QRect& rect, const double& scale, const AudioVisualWaveform &samples, const rational& start_time)
 {
   if (samples.mipmapped_data_.empty()) {
@@ -437,45 +478,181 @@ void AudioVisualWaveform::DrawWaveform(QPainter *painter, const QRect& rect, con
   double rate_dbl = rate.toDouble();
   const Sample& arr = using_mipmap->second;
 
-  size_t start_sample_index = samples.time_to_samples(start_time - samples.virtual_start_, rate_dbl);
+  if (samples.time_to_samples(start_time - samples.virtual_start_, rate_dbl) >= arr.size()) {
+    return;
+  }
+
+  const QRect& viewport = painter->viewport();
+  QPoint top_left = painter->transform().map(viewport.topLeft());
+
+  int start = qMax(rect.x(), -top_left.x());
+  int end = qMin(rect.right(), -top_left.x() + viewport.width());
 
-  if (start_sample_index >= arr.size()) {
+  if (end <= start) {
     return;
   }
 
-  size_t next_sample_index = start_sample_index;
-  size_t sample_index;
+  bool rectified = Config::Cached().rectified_waveforms;
 
-  Sample summary;
-  size_t summary_index = -1;
+  // Tiles live in the waveform's own pixel space, so they're independent of which clip is
+  // being painted where - every clip sharing this waveform at this zoom reuses the same tiles
+  // and scrolling just re-blits them
+  double waveform_offset = (start_time - samples.virtual_start_).toDouble() * scale;
 
-  const QRect& viewport = painter->viewport();
-  QPoint top_left = painter->transform().map(viewport.topLeft());
+  qint64 wave_start = qMax(qint64(0), qint64(std::floor(waveform_offset + (start - rect.x()))));
+  qint64 wave_end = qint64(std::ceil(waveform_offset + (end - rect.x())));
 
-  size_t start = qMax(rect.x(), -top_left.x());
-  size_t end = qMin(rect.right(), -top_left.x() + viewport.width());
+  qreal dpr = painter->device()->devicePixelRatioF();
 
-  bool rectified = OLIVE_CONFIG("RectifiedWaveforms").toBool();
+  painter->save();
+  painter->setClipRect(QRect(start, rect.y(), end - start, rect.height()), Qt::IntersectClip);
 
-  for (size_t i=start;i<end;i++) {
-    sample_index = next_sample_index;
+  for (qint64 tile=wave_start/kWaveformTileWidth; tile*kWaveformTileWidth<wave_end; tile++) {
+    QString key = QStringLiteral("%1:%2:%3:%4:%5:%6:%7")
+        .arg(QString::number(samples.paint_key_),
+             QString::number(tile),
+             QString::number(scale),
+             QString::number(rect.height()),
+             QString::number(rectified),
+             QString::number(painter->pen().color().rgba()),
+             QString::number(dpr));
 
-    if (sample_index == arr.size()) {
-      break;
+    QPixmap *pm = waveform_tile_cache.object(key);
+
+    if (!pm) {
+      pm = new QPixmap(qCeil(kWaveformTileWidth * dpr), qCeil(rect.height() * dpr));
+      pm->setDevicePixelRatio(dpr);
+      pm->fill(Qt::transparent);
+
+      QPainter tile_painter(pm);
+      tile_painter.setPen(painter->pen());
+      DrawWaveformPixels(&tile_painter, arr, samples.channel_count(), rate_dbl, scale,
+                         tile * kWaveformTileWidth, kWaveformTileWidth, 0, rect.height(), rectified);
+      tile_painter.end();
+
+      waveform_tile_cache.insert(key, pm, pm->width() * pm->height() * pm->depth() / 8 / 1024);
     }
 
-    next_sample_index = std::min(arr.size(),
-                                 size_t(start_sample_index + std::floor(rate_dbl * static_cast<double>(i - rect.x() + 1) / scale) * samples.channel_count()));
+    painter->drawPixmap(QPointF(rect.x() - waveform_offset + tile * kWaveformTileWidth, rect.y()), *pm);
+  }
 
-    if (summary_index != sample_index) {
-      summary = AudioVisualWaveform::ReSumSamples(&arr.at(sample_index),
-                                                  qMax(size_t(samples.channel_count()), next_sample_index - sample_index),
-                                                  samples.channel_count());
-      summary_index = sample_index;
+  painter->restore();
+}
+
+quint64 AudioVisualWaveform::GeneratePaintKey()
+{
+  static QAtomicInteger<quint64> counter(1);
+
+  return counter.fetchAndAddRelaxed(1);
+}
+
+// Cache files are native-endian since they never leave the machine; the magic/version pair
+// guards against format changes
+const quint32 kWaveformFileMagic = 0x4F565746; // "OVWF"
+const quint32 kWaveformFileVersion = 1;
+
+struct WaveformFileHeader {
+  quint32 magic;
+  quint32 version;
+  qint32 channels;
+  qint32 virtual_start_num;
+  qint32 virtual_start_den;
+  qint32 length_num;
+  qint32 length_den;
+  quint32 mipmap_count;
+};
+
+struct WaveformFileLevel {
+  qint32 rate_num;
+  qint32 rate_den;
+  quint64 sample_count;
+};
+
+bool AudioVisualWaveform::Save(const QString &filename) const
+{
+  QFile f(filename);
+  if (!f.open(QFile::WriteOnly)) {
+    return false;
+  }
+
+  WaveformFileHeader header;
+  header.magic = kWaveformFileMagic;
+  header.version = kWaveformFileVersion;
+  header.channels = channels_;
+  header.virtual_start_num = virtual_start_.numerator();
+  header.virtual_start_den = virtual_start_.denominator();
+  header.length_num = length_.numerator();
+  header.length_den = length_.denominator();
+  header.mipmap_count = mipmapped_data_.size();
+
+  f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  for (auto it=mipmapped_data_.cbegin(); it!=mipmapped_data_.cend(); it++) {
+    WaveformFileLevel level;
+    level.rate_num = it->first.numerator();
+    level.rate_den = it->first.denominator();
+    level.sample_count = it->second.size();
+
+    f.write(reinterpret_cast<const char*>(&level), sizeof(level));
+    f.write(reinterpret_cast<const char*>(it->second.data()), it->second.size() * sizeof(SamplePerChannel));
+  }
+
+  return f.error() == QFile::NoError;
+}
+
+bool AudioVisualWaveform::Load(const QString &filename)
+{
+  QFile f(filename);
+  if (!f.open(QFile::ReadOnly)) {
+    return false;
+  }
+
+  qint64 file_size = f.size();
+  const uchar *map = f.map(0, file_size);
+  if (!map || size_t(file_size) < sizeof(WaveformFileHeader)) {
+    return false;
+  }
+
+  // Copy rather than cast in case the mapping isn't aligned for our fields
+  WaveformFileHeader header;
+  memcpy(&header, map, sizeof(header));
+
+  if (header.magic != kWaveformFileMagic || header.version != kWaveformFileVersion) {
+    return false;
+  }
+
+  // Load into a temporary map so a truncated file can't leave us half-populated
+  std::map<rational, Sample> loaded;
+  size_t pos = sizeof(header);
+
+  for (quint32 i=0; i<header.mipmap_count; i++) {
+    if (pos + sizeof(WaveformFileLevel) > size_t(file_size)) {
+      return false;
+    }
+
+    WaveformFileLevel level;
+    memcpy(&level, map + pos, sizeof(level));
+    pos += sizeof(level);
+
+    size_t data_size = level.sample_count * sizeof(SamplePerChannel);
+    if (pos + data_size > size_t(file_size)) {
+      return false;
     }
 
-    DrawSample(painter, summary, i, rect.y(), rect.height(), rectified);
+    Sample &samples = loaded[rational(level.rate_num, level.rate_den)];
+    samples.resize(level.sample_count);
+    memcpy(samples.data(), map + pos, data_size);
+    pos += data_size;
   }
+
+  channels_ = header.channels;
+  virtual_start_ = rational(header.virtual_start_num, header.virtual_start_den);
+  length_ = rational(header.length_num, header.length_den);
+  mipmapped_data_ = std::move(loaded);
+
+  paint_key_ = GeneratePaintKey();
+
+  return true;
 }
 
 size_t AudioVisualWaveform::time_to_samples(const rational &time, double sample_rate) const
@@ -54,6 +54,7 @@ public:
   void set_channel_count(int channels)
   {
     channels_ = channels;
+    paint_key_ = GeneratePaintKey();
   }
 
   const rational& length() const
@@ -102,12 +103,32 @@ public:
 
   Sample GetSummaryFromTime(const rational& start, const rational& length) const;
 
+  /**
+   * @brief Serialize every mipmap level to a versioned binary cache file
+   */
+  bool Save(const QString &filename) const;
+
+  /**
+   * @brief Restore mipmap levels from a file written by Save()
+   *
+   * The file is mapped into memory and each level is restored with a single bulk copy, so this
+   * is drastically cheaper than resummarizing the audio.
+   */
+  bool Load(const QString &filename);
+
   static Sample SumSamples(const SampleBuffer &samples, size_t start_index, size_t length);
 
   static Sample ReSumSamples(const SamplePerChannel *samples, size_t nb_samples, int nb_channels);
 
   static void DrawSample(QPainter* painter, const Sample &sample, int x, int y, int height, bool rectified);
 
+  /**
+   * @brief Paint this waveform into a rect
+   *
+   * Rendering goes through a pool of cached tiles keyed on the waveform's content, so
+   * repainting while scrolling (or painting several clips that share a waveform) is mostly
+   * pixmap blits rather than per-pixel line drawing.
+   */
   static void DrawWaveform(QPainter* painter, const QRect &rect, const double &scale, const AudioVisualWaveform& samples, const rational &start_time);
 
   // Must be a power of 2
@@ -126,6 +147,15 @@ private:
 
   void ValidateVirtualStart(const rational &new_start);
 
+  /**
+   * @brief Get a globally unique key identifying one waveform state for the tile cache
+   *
+   * Mutating methods take a fresh key so stale tiles simply stop being referenced.
+   */
+  static quint64 GeneratePaintKey();
+
+  static void DrawWaveformPixels(QPainter *painter, const Sample &arr, int channel_count, double rate, double scale, qint64 wave_pixel_start, int pixel_count, int y, int height, bool rectified);
+
   rational virtual_start_;
 
   int channels_;
@@ -134,6 +164,8 @@ private:
 
   rational length_;
 
+  quint64 paint_key_;
+
 };
 
 }
@@ -0,0 +1,249 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "loudnessanalyzer.h"
+
+#include <cmath>
+#include <limits>
+#include <QtGlobal>
+
+namespace olive {
+
+// Gating blocks are 400ms with 75% overlap per BS.1770, so energy is collected in 100ms steps
+// and a block is the sum of four consecutive steps
+const int kStepsPerBlock = 4;
+const int kStepsPerShortTerm = 30;
+
+// Absolute gating threshold in LUFS below which blocks never count towards integrated loudness
+const double kAbsoluteGateThreshold = -70.0;
+
+// Blocks quieter than this far below the absolute-gated average are excluded from the final
+// integrated measurement
+const double kRelativeGateOffset = -10.0;
+
+LoudnessAnalyzer::LoudnessAnalyzer() :
+  step_size_(0),
+  step_progress_(0),
+  step_accumulator_(0.0),
+  integrated_sum_(0.0)
+{
+}
+
+void LoudnessAnalyzer::SetParams(const AudioParams &params)
+{
+  if (params_ != params) {
+    params_ = params;
+
+    Reset();
+  }
+}
+
+void LoudnessAnalyzer::Reset()
+{
+  step_size_ = params_.sample_rate() / 10;
+  step_progress_ = 0;
+  step_accumulator_ = 0.0;
+  step_powers_.clear();
+
+  integrated_blocks_.clear();
+  integrated_sum_ = 0.0;
+
+  shelf_state_.assign(params_.channel_count(), {0.0, 0.0, 0.0, 0.0});
+  highpass_state_.assign(params_.channel_count(), {0.0, 0.0, 0.0, 0.0});
+
+  // BS.1770 weights front channels at unity, surrounds at +1.5dB and excludes the LFE. We
+  // assume the standard SMPTE order (FL FR FC LFE BL BR) for 5.1 and meter everything else
+  // at unity, which is exact for the mono/stereo sequences that dominate here.
+  channel_weights_.assign(params_.channel_count(), 1.0);
+  if (params_.channel_count() == 6) {
+    channel_weights_[3] = 0.0;
+    channel_weights_[4] = 1.41;
+    channel_weights_[5] = 1.41;
+  }
+
+  InitFilters();
+}
+
+void LoudnessAnalyzer::PushSamples(const SampleBuffer &samples)
+{
+  if (!step_size_ || samples.audio_params().channel_count() != params_.channel_count()) {
+    return;
+  }
+
+  for (size_t i=0; i<samples.sample_count(); i++) {
+    for (int ch=0; ch<params_.channel_count(); ch++) {
+      if (qIsNull(channel_weights_[ch])) {
+        continue;
+      }
+
+      double filtered = ProcessFilter(shelf_, shelf_state_[ch], samples.data(ch)[i]);
+      filtered = ProcessFilter(highpass_, highpass_state_[ch], filtered);
+
+      step_accumulator_ += channel_weights_[ch] * filtered * filtered;
+    }
+
+    step_progress_++;
+
+    if (step_progress_ == step_size_) {
+      // Finished a 100ms step - store its mean power
+      step_powers_.push_back(step_accumulator_ / static_cast<double>(step_size_));
+      step_accumulator_ = 0.0;
+      step_progress_ = 0;
+
+      if (step_powers_.size() > kStepsPerShortTerm) {
+        step_powers_.pop_front();
+      }
+
+      if (step_powers_.size() >= kStepsPerBlock) {
+        // Each new step completes another overlapped 400ms gating block
+        double block_power = 0.0;
+        for (size_t j=step_powers_.size()-kStepsPerBlock; j<step_powers_.size(); j++) {
+          block_power += step_powers_.at(j);
+        }
+        block_power /= kStepsPerBlock;
+
+        if (PowerToLoudness(block_power) > kAbsoluteGateThreshold) {
+          integrated_blocks_.push_back(block_power);
+          integrated_sum_ += block_power;
+        }
+      }
+    }
+  }
+}
+
+double LoudnessAnalyzer::GetMomentaryLoudness() const
+{
+  if (step_powers_.empty()) {
+    return -std::numeric_limits<double>::infinity();
+  }
+
+  size_t count = std::min(step_powers_.size(), size_t(kStepsPerBlock));
+  double power = 0.0;
+  for (size_t i=step_powers_.size()-count; i<step_powers_.size(); i++) {
+    power += step_powers_.at(i);
+  }
+
+  return PowerToLoudness(power / static_cast<double>(count));
+}
+
+double LoudnessAnalyzer::GetShortTermLoudness() const
+{
+  if (step_powers_.empty()) {
+    return -std::numeric_limits<double>::infinity();
+  }
+
+  double power = 0.0;
+  for (size_t i=0; i<step_powers_.size(); i++) {
+    power += step_powers_.at(i);
+  }
+
+  return PowerToLoudness(power / static_cast<double>(step_powers_.size()));
+}
+
+double LoudnessAnalyzer::GetIntegratedLoudness() const
+{
+  if (integrated_blocks_.empty()) {
+    return -std::numeric_limits<double>::infinity();
+  }
+
+  // Second gating stage: exclude blocks well below the average of everything that passed the
+  // absolute gate
+  double relative_gate = PowerToLoudness(integrated_sum_ / static_cast<double>(integrated_blocks_.size())) + kRelativeGateOffset;
+
+  double power = 0.0;
+  size_t count = 0;
+  for (size_t i=0; i<integrated_blocks_.size(); i++) {
+    if (PowerToLoudness(integrated_blocks_.at(i)) > relative_gate) {
+      power += integrated_blocks_.at(i);
+      count++;
+    }
+  }
+
+  if (!count) {
+    return -std::numeric_limits<double>::infinity();
+  }
+
+  return PowerToLoudness(power / static_cast<double>(count));
+}
+
+void LoudnessAnalyzer::InitFilters()
+{
+  double fs = params_.sample_rate();
+
+  if (!(fs > 0)) {
+    return;
+  }
+
+  // Both stages are derived from the analog prototypes in BS.1770 via the bilinear transform
+  // so they stay accurate at any sample rate rather than hardcoding the published 48kHz
+  // coefficients
+
+  {
+    // Stage 1: high shelf modelling the acoustic effect of the head
+    const double f0 = 1681.974450955533;
+    const double gain_db = 3.999843853973347;
+    const double q = 0.7071752369554196;
+
+    double k = std::tan(M_PI * f0 / fs);
+    double vh = std::pow(10.0, gain_db / 20.0);
+    double vb = std::pow(vh, 0.4996667741545416);
+    double a0 = 1.0 + k / q + k * k;
+
+    shelf_.b0 = (vh + vb * k / q + k * k) / a0;
+    shelf_.b1 = 2.0 * (k * k - vh) / a0;
+    shelf_.b2 = (vh - vb * k / q + k * k) / a0;
+    shelf_.a1 = 2.0 * (k * k - 1.0) / a0;
+    shelf_.a2 = (1.0 - k / q + k * k) / a0;
+  }
+
+  {
+    // Stage 2: RLB high-pass weighting
+    const double f0 = 38.13547087602444;
+    const double q = 0.5003270373238773;
+
+    double k = std::tan(M_PI * f0 / fs);
+    double a0 = 1.0 + k / q + k * k;
+
+    highpass_.b0 = 1.0;
+    highpass_.b1 = -2.0;
+    highpass_.b2 = 1.0;
+    highpass_.a1 = 2.0 * (k * k - 1.0) / a0;
+    highpass_.a2 = (1.0 - k / q + k * k) / a0;
+  }
+}
+
+double LoudnessAnalyzer::ProcessFilter(const Biquad &f, FilterState &s, double x) const
+{
+  double y = f.b0 * x + f.b1 * s.x1 + f.b2 * s.x2 - f.a1 * s.y1 - f.a2 * s.y2;
+
+  s.x2 = s.x1;
+  s.x1 = x;
+  s.y2 = s.y1;
+  s.y1 = y;
+
+  return y;
+}
+
+double LoudnessAnalyzer::PowerToLoudness(double power)
+{
+  return -0.691 + 10.0 * std::log10(power);
+}
+
+}
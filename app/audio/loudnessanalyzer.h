@@ -0,0 +1,124 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef LOUDNESSANALYZER_H
+#define LOUDNESSANALYZER_H
+
+#include <deque>
+#include <olive/core/core.h>
+#include <vector>
+
+namespace olive {
+
+using namespace core;
+
+/**
+ * @brief Incremental EBU R128 (ITU-R BS.1770) loudness meter
+ *
+ * Samples are pushed in playback/encode order and the analyzer maintains momentary (400ms),
+ * short-term (3s) and gated integrated loudness as it goes, so metering a program costs a
+ * single pass over audio we were already handling anyway.
+ *
+ * Not thread-safe - each consumer (preview playback, an export task) keeps its own instance.
+ */
+class LoudnessAnalyzer
+{
+public:
+  LoudnessAnalyzer();
+
+  /**
+   * @brief Set the parameters of the audio that will be pushed
+   *
+   * Changing the parameters resets the measurement since the K-weighting filter is dependent
+   * on the sample rate.
+   */
+  void SetParams(const AudioParams &params);
+
+  /**
+   * @brief Clear all filter state and start a new measurement
+   */
+  void Reset();
+
+  /**
+   * @brief Push planar float samples in presentation order
+   */
+  void PushSamples(const SampleBuffer &samples);
+
+  /**
+   * @brief Loudness of the last 400ms in LUFS
+   *
+   * Returns -infinity when nothing has been measured yet.
+   */
+  double GetMomentaryLoudness() const;
+
+  /**
+   * @brief Loudness of the last 3 seconds in LUFS
+   */
+  double GetShortTermLoudness() const;
+
+  /**
+   * @brief Gated program loudness since the last reset in LUFS
+   */
+  double GetIntegratedLoudness() const;
+
+private:
+  struct Biquad
+  {
+    double b0, b1, b2, a1, a2;
+  };
+
+  struct FilterState
+  {
+    double x1, x2, y1, y2;
+  };
+
+  void InitFilters();
+
+  double ProcessFilter(const Biquad &f, FilterState &s, double x) const;
+
+  static double PowerToLoudness(double power);
+
+  AudioParams params_;
+
+  // K-weighting per BS.1770: a high shelf modelling the acoustic effect of the head followed
+  // by a high-pass (RLB) weighting
+  Biquad shelf_;
+  Biquad highpass_;
+
+  std::vector<FilterState> shelf_state_;
+  std::vector<FilterState> highpass_state_;
+
+  std::vector<double> channel_weights_;
+
+  // Energy is accumulated in 100ms steps; gating blocks are 400ms with 75% overlap, i.e. the
+  // sum of four consecutive steps
+  size_t step_size_;
+  size_t step_progress_;
+  double step_accumulator_;
+  std::deque<double> step_powers_;
+
+  std::vector<double> integrated_blocks_;
+  double integrated_sum_;
+
+};
+
+}
+
+#endif // LOUDNESSANALYZER_H
@@ -0,0 +1,469 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "samplekernels.h"
+
+#include <QtGlobal>
+
+#if defined(Q_PROCESSOR_X86)
+#include <immintrin.h>
+#if defined(Q_CC_MSVC)
+#include <intrin.h>
+#endif
+#elif defined(Q_PROCESSOR_ARM) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace olive {
+
+namespace {
+
+void SumScalar(const float *a, const float *b, float *dst, size_t count)
+{
+  for (size_t i=0; i<count; i++) {
+    dst[i] = a[i] + b[i];
+  }
+}
+
+void GainScalar(float *buf, float gain, size_t count)
+{
+  for (size_t i=0; i<count; i++) {
+    buf[i] *= gain;
+  }
+}
+
+void OffsetScalar(float *buf, float offset, size_t count)
+{
+  for (size_t i=0; i<count; i++) {
+    buf[i] += offset;
+  }
+}
+
+void DivideScalar(float *buf, float divisor, size_t count)
+{
+  for (size_t i=0; i<count; i++) {
+    buf[i] /= divisor;
+  }
+}
+
+void ClampScalar(float *buf, size_t count)
+{
+  for (size_t i=0; i<count; i++) {
+    buf[i] = qBound(-1.0f, buf[i], 1.0f);
+  }
+}
+
+void MinMaxScalar(const float *buf, size_t count, float *min, float *max)
+{
+  for (size_t i=0; i<count; i++) {
+    *min = qMin(*min, buf[i]);
+    *max = qMax(*max, buf[i]);
+  }
+}
+
+#if defined(Q_PROCESSOR_X86)
+
+// SSE baseline used when the CPU doesn't support AVX2
+
+void SumSSE(const float *a, const float *b, float *dst, size_t count)
+{
+  size_t vec_count = count & ~size_t(3);
+
+  for (size_t i=0; i<vec_count; i+=4) {
+    _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+  }
+
+  SumScalar(a + vec_count, b + vec_count, dst + vec_count, count - vec_count);
+}
+
+void GainSSE(float *buf, float gain, size_t count)
+{
+  size_t vec_count = count & ~size_t(3);
+
+  __m128 mult = _mm_set1_ps(gain);
+
+  for (size_t i=0; i<vec_count; i+=4) {
+    _mm_storeu_ps(buf + i, _mm_mul_ps(_mm_loadu_ps(buf + i), mult));
+  }
+
+  GainScalar(buf + vec_count, gain, count - vec_count);
+}
+
+void OffsetSSE(float *buf, float offset, size_t count)
+{
+  size_t vec_count = count & ~size_t(3);
+
+  __m128 add = _mm_set1_ps(offset);
+
+  for (size_t i=0; i<vec_count; i+=4) {
+    _mm_storeu_ps(buf + i, _mm_add_ps(_mm_loadu_ps(buf + i), add));
+  }
+
+  OffsetScalar(buf + vec_count, offset, count - vec_count);
+}
+
+void DivideSSE(float *buf, float divisor, size_t count)
+{
+  size_t vec_count = count & ~size_t(3);
+
+  __m128 div = _mm_set1_ps(divisor);
+
+  for (size_t i=0; i<vec_count; i+=4) {
+    _mm_storeu_ps(buf + i, _mm_div_ps(_mm_loadu_ps(buf + i), div));
+  }
+
+  DivideScalar(buf + vec_count, divisor, count - vec_count);
+}
+
+void ClampSSE(float *buf, size_t count)
+{
+  size_t vec_count = count & ~size_t(3);
+
+  __m128 min = _mm_set1_ps(-1.0f);
+  __m128 max = _mm_set1_ps(1.0f);
+
+  for (size_t i=0; i<vec_count; i+=4) {
+    _mm_storeu_ps(buf + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(buf + i), min), max));
+  }
+
+  ClampScalar(buf + vec_count, count - vec_count);
+}
+
+void MinMaxSSE(const float *buf, size_t count, float *min, float *max)
+{
+  size_t vec_count = count & ~size_t(3);
+
+  if (vec_count) {
+    __m128 min_acc = _mm_set1_ps(*min);
+    __m128 max_acc = _mm_set1_ps(*max);
+
+    for (size_t i=0; i<vec_count; i+=4) {
+      __m128 cur = _mm_loadu_ps(buf + i);
+      min_acc = _mm_min_ps(min_acc, cur);
+      max_acc = _mm_max_ps(max_acc, cur);
+    }
+
+    // Fold the 4 lanes down to one by shuffling and comparing
+    for (int i=0; i<3; i++) {
+      min_acc = _mm_min_ps(min_acc, _mm_shuffle_ps(min_acc, min_acc, 0x93));
+      max_acc = _mm_max_ps(max_acc, _mm_shuffle_ps(max_acc, max_acc, 0x93));
+    }
+
+    _mm_store_ss(min, min_acc);
+    _mm_store_ss(max, max_acc);
+  }
+
+  MinMaxScalar(buf + vec_count, count - vec_count, min, max);
+}
+
+// The AVX2 kernels are compiled per-function rather than building this whole file with -mavx2
+// so that nothing outside them requires AVX2, keeping the binary runnable on older CPUs
+#if defined(Q_CC_GNU) || defined(Q_CC_CLANG)
+#define OLIVE_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+// MSVC allows AVX intrinsics without a target attribute or arch flag
+#define OLIVE_TARGET_AVX2
+#endif
+
+OLIVE_TARGET_AVX2 void SumAVX2(const float *a, const float *b, float *dst, size_t count)
+{
+  size_t vec_count = count & ~size_t(7);
+
+  for (size_t i=0; i<vec_count; i+=8) {
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+  }
+
+  SumScalar(a + vec_count, b + vec_count, dst + vec_count, count - vec_count);
+}
+
+OLIVE_TARGET_AVX2 void GainAVX2(float *buf, float gain, size_t count)
+{
+  size_t vec_count = count & ~size_t(7);
+
+  __m256 mult = _mm256_set1_ps(gain);
+
+  for (size_t i=0; i<vec_count; i+=8) {
+    _mm256_storeu_ps(buf + i, _mm256_mul_ps(_mm256_loadu_ps(buf + i), mult));
+  }
+
+  GainScalar(buf + vec_count, gain, count - vec_count);
+}
+
+OLIVE_TARGET_AVX2 void OffsetAVX2(float *buf, float offset, size_t count)
+{
+  size_t vec_count = count & ~size_t(7);
+
+  __m256 add = _mm256_set1_ps(offset);
+
+  for (size_t i=0; i<vec_count; i+=8) {
+    _mm256_storeu_ps(buf + i, _mm256_add_ps(_mm256_loadu_ps(buf + i), add));
+  }
+
+  OffsetScalar(buf + vec_count, offset, count - vec_count);
+}
+
+OLIVE_TARGET_AVX2 void DivideAVX2(float *buf, float divisor, size_t count)
+{
+  size_t vec_count = count & ~size_t(7);
+
+  __m256 div = _mm256_set1_ps(divisor);
+
+  for (size_t i=0; i<vec_count; i+=8) {
+    _mm256_storeu_ps(buf + i, _mm256_div_ps(_mm256_loadu_ps(buf + i), div));
+  }
+
+  DivideScalar(buf + vec_count, divisor, count - vec_count);
+}
+
+OLIVE_TARGET_AVX2 void ClampAVX2(float *buf, size_t count)
+{
+  size_t vec_count = count & ~size_t(7);
+
+  __m256 min = _mm256_set1_ps(-1.0f);
+  __m256 max = _mm256_set1_ps(1.0f);
+
+  for (size_t i=0; i<vec_count; i+=8) {
+    _mm256_storeu_ps(buf + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(buf + i), min), max));
+  }
+
+  ClampScalar(buf + vec_count, count - vec_count);
+}
+
+OLIVE_TARGET_AVX2 void MinMaxAVX2(const float *buf, size_t count, float *min, float *max)
+{
+  size_t vec_count = count & ~size_t(7);
+
+  if (vec_count) {
+    __m256 min_acc = _mm256_set1_ps(*min);
+    __m256 max_acc = _mm256_set1_ps(*max);
+
+    for (size_t i=0; i<vec_count; i+=8) {
+      __m256 cur = _mm256_loadu_ps(buf + i);
+      min_acc = _mm256_min_ps(min_acc, cur);
+      max_acc = _mm256_max_ps(max_acc, cur);
+    }
+
+    // Fold the two 128-bit halves together, then the 4 remaining lanes down to one
+    __m128 min128 = _mm_min_ps(_mm256_castps256_ps128(min_acc), _mm256_extractf128_ps(min_acc, 1));
+    __m128 max128 = _mm_max_ps(_mm256_castps256_ps128(max_acc), _mm256_extractf128_ps(max_acc, 1));
+
+    for (int i=0; i<3; i++) {
+      min128 = _mm_min_ps(min128, _mm_shuffle_ps(min128, min128, 0x93));
+      max128 = _mm_max_ps(max128, _mm_shuffle_ps(max128, max128, 0x93));
+    }
+
+    _mm_store_ss(min, min128);
+    _mm_store_ss(max, max128);
+  }
+
+  MinMaxScalar(buf + vec_count, count - vec_count, min, max);
+}
+
+bool CpuHasAVX2()
+{
+#if defined(Q_CC_GNU) || defined(Q_CC_CLANG)
+  return __builtin_cpu_supports("avx2");
+#else
+  int info[4];
+
+  __cpuid(info, 0);
+  if (info[0] < 7) {
+    return false;
+  }
+
+  __cpuidex(info, 7, 0);
+  return info[1] & (1 << 5);
+#endif
+}
+
+#elif defined(Q_PROCESSOR_ARM) && defined(__ARM_NEON)
+
+void SumNEON(const float *a, const float *b, float *dst, size_t count)
+{
+  size_t vec_count = count & ~size_t(3);
+
+  for (size_t i=0; i<vec_count; i+=4) {
+    vst1q_f32(dst + i, vaddq_f32(vld1q_f32(a + i), vld1q_f32(b + i)));
+  }
+
+  SumScalar(a + vec_count, b + vec_count, dst + vec_count, count - vec_count);
+}
+
+void GainNEON(float *buf, float gain, size_t count)
+{
+  size_t vec_count = count & ~size_t(3);
+
+  for (size_t i=0; i<vec_count; i+=4) {
+    vst1q_f32(buf + i, vmulq_n_f32(vld1q_f32(buf + i), gain));
+  }
+
+  GainScalar(buf + vec_count, gain, count - vec_count);
+}
+
+void OffsetNEON(float *buf, float offset, size_t count)
+{
+  size_t vec_count = count & ~size_t(3);
+
+  float32x4_t add = vdupq_n_f32(offset);
+
+  for (size_t i=0; i<vec_count; i+=4) {
+    vst1q_f32(buf + i, vaddq_f32(vld1q_f32(buf + i), add));
+  }
+
+  OffsetScalar(buf + vec_count, offset, count - vec_count);
+}
+
+#if defined(__aarch64__)
+// 32-bit NEON has no float division instruction, so armv7 keeps the scalar divide
+void DivideNEON(float *buf, float divisor, size_t count)
+{
+  size_t vec_count = count & ~size_t(3);
+
+  float32x4_t div = vdupq_n_f32(divisor);
+
+  for (size_t i=0; i<vec_count; i+=4) {
+    vst1q_f32(buf + i, vdivq_f32(vld1q_f32(buf + i), div));
+  }
+
+  DivideScalar(buf + vec_count, divisor, count - vec_count);
+}
+#endif
+
+void ClampNEON(float *buf, size_t count)
+{
+  size_t vec_count = count & ~size_t(3);
+
+  float32x4_t min = vdupq_n_f32(-1.0f);
+  float32x4_t max = vdupq_n_f32(1.0f);
+
+  for (size_t i=0; i<vec_count; i+=4) {
+    vst1q_f32(buf + i, vminq_f32(vmaxq_f32(vld1q_f32(buf + i), min), max));
+  }
+
+  ClampScalar(buf + vec_count, count - vec_count);
+}
+
+void MinMaxNEON(const float *buf, size_t count, float *min, float *max)
+{
+  size_t vec_count = count & ~size_t(3);
+
+  if (vec_count) {
+    float32x4_t min_acc = vdupq_n_f32(*min);
+    float32x4_t max_acc = vdupq_n_f32(*max);
+
+    for (size_t i=0; i<vec_count; i+=4) {
+      float32x4_t cur = vld1q_f32(buf + i);
+      min_acc = vminq_f32(min_acc, cur);
+      max_acc = vmaxq_f32(max_acc, cur);
+    }
+
+    // Pairwise-fold the 4 lanes down to one
+    float32x2_t min2 = vpmin_f32(vget_low_f32(min_acc), vget_high_f32(min_acc));
+    min2 = vpmin_f32(min2, min2);
+    float32x2_t max2 = vpmax_f32(vget_low_f32(max_acc), vget_high_f32(max_acc));
+    max2 = vpmax_f32(max2, max2);
+
+    *min = vget_lane_f32(min2, 0);
+    *max = vget_lane_f32(max2, 0);
+  }
+
+  MinMaxScalar(buf + vec_count, count - vec_count, min, max);
+}
+
+#endif
+
+}
+
+SampleKernels::Functions::Functions()
+{
+  sum = SumScalar;
+  gain = GainScalar;
+  offset = OffsetScalar;
+  divide = DivideScalar;
+  clamp = ClampScalar;
+  minmax = MinMaxScalar;
+
+#if defined(Q_PROCESSOR_X86)
+  if (CpuHasAVX2()) {
+    sum = SumAVX2;
+    gain = GainAVX2;
+    offset = OffsetAVX2;
+    divide = DivideAVX2;
+    clamp = ClampAVX2;
+    minmax = MinMaxAVX2;
+  } else {
+    sum = SumSSE;
+    gain = GainSSE;
+    offset = OffsetSSE;
+    divide = DivideSSE;
+    clamp = ClampSSE;
+    minmax = MinMaxSSE;
+  }
+#elif defined(Q_PROCESSOR_ARM) && defined(__ARM_NEON)
+  // NEON is baseline on every ARM we ship for, no runtime check needed
+  sum = SumNEON;
+  gain = GainNEON;
+  offset = OffsetNEON;
+#if defined(__aarch64__)
+  divide = DivideNEON;
+#endif
+  clamp = ClampNEON;
+  minmax = MinMaxNEON;
+#endif
+}
+
+const SampleKernels::Functions &SampleKernels::GetFunctions()
+{
+  // Function-local static so the CPU probe happens exactly once, on first use
+  static const Functions f;
+  return f;
+}
+
+void SampleKernels::Sum(const float *a, const float *b, float *dst, size_t count)
+{
+  GetFunctions().sum(a, b, dst, count);
+}
+
+void SampleKernels::Gain(float *buf, float gain, size_t count)
+{
+  GetFunctions().gain(buf, gain, count);
+}
+
+void SampleKernels::Offset(float *buf, float offset, size_t count)
+{
+  GetFunctions().offset(buf, offset, count);
+}
+
+void SampleKernels::Divide(float *buf, float divisor, size_t count)
+{
+  GetFunctions().divide(buf, divisor, count);
+}
+
+void SampleKernels::Clamp(float *buf, size_t count)
+{
+  GetFunctions().clamp(buf, count);
+}
+
+void SampleKernels::MinMax(const float *buf, size_t count, float *min, float *max)
+{
+  GetFunctions().minmax(buf, count, min, max);
+}
+
+}
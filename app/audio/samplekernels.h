@@ -0,0 +1,91 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef SAMPLEKERNELS_H
+#define SAMPLEKERNELS_H
+
+#include <cstddef>
+
+namespace olive {
+
+/**
+ * @brief Runtime-dispatched SIMD kernels for bulk float sample processing
+ *
+ * Mixing many audio tracks together runs these inner loops once per track per channel, so on
+ * large sequences they dominate the audio render cost. Each kernel picks the widest
+ * implementation the CPU actually supports at runtime (AVX2 on x86, NEON on ARM), falling
+ * back to a scalar loop, so the binary itself stays runnable on any machine.
+ */
+class SampleKernels {
+public:
+  /**
+   * @brief dst[i] = a[i] + b[i] — mixing two sample planes together
+   */
+  static void Sum(const float *a, const float *b, float *dst, size_t count);
+
+  /**
+   * @brief buf[i] *= gain
+   */
+  static void Gain(float *buf, float gain, size_t count);
+
+  /**
+   * @brief buf[i] += offset — also covers subtraction with a negated offset
+   */
+  static void Offset(float *buf, float offset, size_t count);
+
+  /**
+   * @brief buf[i] /= divisor
+   *
+   * Kept as a true division rather than a reciprocal multiply so results match the scalar
+   * path bit-for-bit.
+   */
+  static void Divide(float *buf, float divisor, size_t count);
+
+  /**
+   * @brief Clamp every sample to the [-1.0, 1.0] range
+   */
+  static void Clamp(float *buf, size_t count);
+
+  /**
+   * @brief Expand *min and *max to cover every sample in the buffer
+   *
+   * The caller initializes *min and *max (e.g. to zero); they are only ever widened.
+   */
+  static void MinMax(const float *buf, size_t count, float *min, float *max);
+
+private:
+  struct Functions {
+    Functions();
+
+    void (*sum)(const float *a, const float *b, float *dst, size_t count);
+    void (*gain)(float *buf, float gain, size_t count);
+    void (*offset)(float *buf, float offset, size_t count);
+    void (*divide)(float *buf, float divisor, size_t count);
+    void (*clamp)(float *buf, size_t count);
+    void (*minmax)(const float *buf, size_t count, float *min, float *max);
+  };
+
+  static const Functions &GetFunctions();
+
+};
+
+}
+
+#endif // SAMPLEKERNELS_H
@@ -0,0 +1,311 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "clibenchmarkmanager.h"
+
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QThread>
+
+#include <algorithm>
+#include <deque>
+
+#include "cli/clitask/clitaskdialog.h"
+#include "codec/decoder.h"
+#include "node/project/footage/footage.h"
+#include "node/project/sequence/sequence.h"
+#include "render/rendermanager.h"
+#include "task/project/load/load.h"
+
+namespace olive {
+
+namespace {
+
+/**
+ * @brief Submit requests in order with up to `pipeline_depth` tickets in flight
+ *
+ * Returns the sorted request-to-completion latencies in milliseconds. Depth 1 models a user
+ * waiting on each result (seeking/scrubbing); a small window models the playback prequeue.
+ */
+QVector<qint64> ExecuteWorkload(Project *project, Sequence *sequence, const QVector<rational> &times, int pipeline_depth)
+{
+  VideoParams video_params = sequence->GetVideoParams();
+  RenderManager *manager = RenderManager::instance();
+
+  std::deque<std::pair<RenderTicketPtr, QElapsedTimer> > in_flight;
+  QVector<qint64> latencies;
+  latencies.reserve(times.size());
+
+  foreach (const rational &time, times) {
+    RenderManager::RenderVideoParams rvp(sequence,
+                                         video_params,
+                                         sequence->GetAudioParams(),
+                                         time,
+                                         project->color_manager(),
+                                         RenderMode::kOffline);
+
+    QElapsedTimer timer;
+    timer.start();
+    in_flight.push_back(std::make_pair(manager->RenderFrame(rvp), timer));
+
+    while (in_flight.size() >= size_t(pipeline_depth)) {
+      in_flight.front().first->WaitForFinished();
+      latencies.append(in_flight.front().second.elapsed());
+      in_flight.pop_front();
+    }
+  }
+
+  while (!in_flight.empty()) {
+    in_flight.front().first->WaitForFinished();
+    latencies.append(in_flight.front().second.elapsed());
+    in_flight.pop_front();
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+
+  return latencies;
+}
+
+qint64 Percentile(const QVector<qint64> &sorted, double fraction)
+{
+  if (sorted.isEmpty()) {
+    return 0;
+  }
+
+  return sorted.at(qMin(sorted.size() - 1, int(fraction * sorted.size())));
+}
+
+}
+
+CLIBenchmarkManager::CLIBenchmarkManager()
+{
+}
+
+bool CLIBenchmarkManager::Run(const QString &project_filename, const QString &workload)
+{
+  if (project_filename.isEmpty()) {
+    qCritical().noquote() << tr("You must specify a project file to benchmark");
+    return false;
+  }
+
+  if (!QFileInfo::exists(project_filename)) {
+    qCritical().noquote() << tr("Specified project does not exist");
+    return false;
+  }
+
+  ProjectLoadTask load_task(project_filename);
+  CLITaskDialog load_dialog(&load_task);
+
+  if (!load_dialog.Run()) {
+    qCritical().noquote() << tr("Project failed to load: %1").arg(load_task.GetError());
+    return false;
+  }
+
+  std::unique_ptr<Project> project(load_task.GetLoadedProject());
+
+  QVector<Sequence*> sequences;
+  foreach (Node* node, project->nodes()) {
+    if (Sequence* sequence = dynamic_cast<Sequence*>(node)) {
+      sequences.append(sequence);
+    }
+  }
+
+  if (sequences.isEmpty()) {
+    qCritical().noquote() << tr("Project contains no sequences, nothing to benchmark");
+    return false;
+  }
+
+  Sequence* sequence = sequences.first();
+  if (sequences.size() > 1) {
+    qWarning().noquote() << tr("Project has multiple sequences, benchmarking \"%1\"").arg(sequence->GetLabel());
+  }
+
+  VideoParams video_params = sequence->GetVideoParams();
+  rational timebase = video_params.frame_rate_as_time_base();
+  if (timebase.isNull()) {
+    qCritical().noquote() << tr("Sequence has no frame rate, cannot iterate frames");
+    return false;
+  }
+
+  TimeRangeListFrameIterator iterator({TimeRange(0, sequence->GetLength())}, timebase);
+  if (!iterator.size()) {
+    qCritical().noquote() << tr("Sequence is empty, nothing to benchmark");
+    return false;
+  }
+
+  if (!workload.isEmpty()) {
+    return RunWorkloads(project.get(), sequence, workload);
+  }
+
+  RenderManager *manager = RenderManager::instance();
+
+  // Keep one ticket in flight per hardware thread and wait for them in submission order. The
+  // exact window size isn't critical since completed tickets return from WaitForFinished()
+  // immediately - it just has to be deep enough to keep every render thread busy.
+  const size_t maximum_rendered_frames = QThread::idealThreadCount();
+
+  std::deque<RenderTicketPtr> tickets;
+  int frames_rendered = 0;
+
+  QElapsedTimer timer;
+  timer.start();
+
+  rational frame;
+  while (iterator.GetNext(&frame)) {
+    RenderManager::RenderVideoParams rvp(sequence,
+                                         video_params,
+                                         sequence->GetAudioParams(),
+                                         frame,
+                                         project->color_manager(),
+                                         RenderMode::kOffline);
+
+    tickets.push_back(manager->RenderFrame(rvp));
+
+    if (tickets.size() >= maximum_rendered_frames) {
+      tickets.front()->WaitForFinished();
+      tickets.pop_front();
+      frames_rendered++;
+    }
+  }
+
+  while (!tickets.empty()) {
+    tickets.front()->WaitForFinished();
+    tickets.pop_front();
+    frames_rendered++;
+  }
+
+  qint64 elapsed = timer.elapsed();
+  double fps = elapsed ? frames_rendered * 1000.0 / elapsed : 0.0;
+
+  qInfo().noquote() << tr("Rendered %1 frame(s) in %2 ms (%3 fps)")
+                       .arg(QString::number(frames_rendered),
+                            QString::number(elapsed),
+                            QString::number(fps, 'f', 1));
+
+  return true;
+}
+
+bool CLIBenchmarkManager::RunWorkloads(Project *project, Sequence *sequence, const QString &workload)
+{
+  const rational timebase = sequence->GetVideoParams().frame_rate_as_time_base();
+  const int64_t frame_count = Timecode::time_to_timestamp(sequence->GetLength(), timebase);
+
+  if (frame_count <= 0) {
+    qCritical().noquote() << tr("Sequence is shorter than one frame, nothing to benchmark");
+    return false;
+  }
+
+  // Decoder statistics are keyed per media file, so collect the project's footage up front to
+  // diff them around each workload
+  QStringList footage_files;
+  foreach (Node *node, project->nodes()) {
+    if (Footage *footage = dynamic_cast<Footage*>(node)) {
+      if (!footage_files.contains(footage->filename())) {
+        footage_files.append(footage->filename());
+      }
+    }
+  }
+
+  foreach (const QString &name, workload.split(',')) {
+    QVector<rational> times;
+    int pipeline_depth = 1;
+
+    // Fixed seed so every run replays the identical request sequence - numbers from different
+    // runs on the same fixture are only comparable if the requests were too
+    QRandomGenerator rng(0x0B5E55ED);
+
+    if (name == QStringLiteral("seek")) {
+      // Random jumps across the sequence - the pattern clicking around the timeline produces
+      for (int i=0; i<100; i++) {
+        times.append(Timecode::timestamp_to_time(rng.bounded(quint32(frame_count)), timebase));
+      }
+    } else if (name == QStringLiteral("scrub")) {
+      // Gestures of a jump followed by a drag through consecutive 2-frame steps
+      for (int g=0; g<25; g++) {
+        int64_t start = rng.bounded(quint32(frame_count));
+
+        for (int s=0; s<16; s++) {
+          times.append(Timecode::timestamp_to_time(qMin(frame_count - 1, start + s * 2), timebase));
+        }
+      }
+    } else if (name == QStringLiteral("play")) {
+      // Sequential playback from the start, capped at 10 seconds. A small ticket window mirrors
+      // the playback prequeue, so latencies here reflect frame delivery rather than round trips.
+      int64_t play_frames = qMin(frame_count, int64_t(sequence->GetVideoParams().frame_rate().toDouble() * 10.0));
+
+      for (int64_t i=0; i<play_frames; i++) {
+        times.append(Timecode::timestamp_to_time(i, timebase));
+      }
+
+      pipeline_depth = 4;
+    } else {
+      qCritical().noquote() << tr("Unknown workload \"%1\" (supported: seek, scrub, play)").arg(name);
+      return false;
+    }
+
+    QVector<Decoder::Statistics> stats_before;
+    foreach (const QString &file, footage_files) {
+      stats_before.append(Decoder::GetStatistics(file));
+    }
+
+    QElapsedTimer total;
+    total.start();
+
+    QVector<qint64> latencies = ExecuteWorkload(project, sequence, times, pipeline_depth);
+
+    qint64 elapsed = total.elapsed();
+
+    qint64 sum = 0;
+    foreach (qint64 latency, latencies) {
+      sum += latency;
+    }
+    double mean = latencies.isEmpty() ? 0.0 : double(sum) / latencies.size();
+
+    qInfo().noquote() << tr("%1: %2 request(s) in %3 ms - mean %4 ms, p50 %5 ms, p90 %6 ms, p99 %7 ms, max %8 ms")
+                         .arg(name,
+                              QString::number(latencies.size()),
+                              QString::number(elapsed),
+                              QString::number(mean, 'f', 1),
+                              QString::number(Percentile(latencies, 0.5)),
+                              QString::number(Percentile(latencies, 0.9)),
+                              QString::number(Percentile(latencies, 0.99)),
+                              QString::number(latencies.isEmpty() ? 0 : latencies.last()));
+
+    for (int i=0; i<footage_files.size(); i++) {
+      Decoder::Statistics after = Decoder::GetStatistics(footage_files.at(i));
+      const Decoder::Statistics &before = stats_before.at(i);
+
+      qint64 hits = after.frame_cache_hits - before.frame_cache_hits;
+      qint64 misses = after.frame_cache_misses - before.frame_cache_misses;
+      qint64 lookups = hits + misses;
+
+      qInfo().noquote() << tr("  %1: %2 seek(s), %3 frame(s) decoded, cache hit rate %4%")
+                           .arg(QFileInfo(footage_files.at(i)).fileName(),
+                                QString::number(after.seek_count - before.seek_count),
+                                QString::number(after.frames_decoded - before.frames_decoded),
+                                QString::number(lookups ? 100.0 * hits / lookups : 0.0, 'f', 1));
+    }
+  }
+
+  return true;
+}
+
+}
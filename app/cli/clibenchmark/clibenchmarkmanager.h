@@ -0,0 +1,62 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef CLIBENCHMARKMANAGER_H
+#define CLIBENCHMARKMANAGER_H
+
+#include <QObject>
+
+namespace olive {
+
+class Project;
+class Sequence;
+
+/**
+ * @brief Drives the headless benchmarks (`--benchmark` and `--benchmark-workload`)
+ *
+ * With no workload, replays every frame of the project's first sequence through the render
+ * pipeline as fast as the scheduler will take them. Core forces the no-op "dummy" render
+ * backend for this mode, so the reported frames/sec reflects graph traversal and thread
+ * scheduling rather than GPU or codec speed - running the same project across releases gives
+ * an apples-to-apples number for threading regressions.
+ *
+ * With a workload ("seek", "scrub" and/or "play", comma-separated), replays scripted
+ * interactive request patterns against the real render backend and reports per-request latency
+ * percentiles plus decoder cache hit rates per media file. Requests are submitted to
+ * RenderManager directly - the same layer ViewerWidget submits to, minus the GUI session a
+ * widget would require - and the patterns are seeded deterministically so runs on the same
+ * fixture are comparable.
+ */
+class CLIBenchmarkManager : public QObject
+{
+  Q_OBJECT
+public:
+  CLIBenchmarkManager();
+
+  bool Run(const QString &project_filename, const QString &workload);
+
+private:
+  bool RunWorkloads(Project *project, Sequence *sequence, const QString &workload);
+
+};
+
+}
+
+#endif // CLIBENCHMARKMANAGER_H
@@ -20,11 +20,322 @@
 
 #include "cliexportmanager.h"
 
+#include <QFileInfo>
+#include <QTextStream>
+#include <QtConcurrent/QtConcurrent>
+
+#include "cli/clitask/clitaskdialog.h"
+#include "codec/ffmpeg/ffmpegencoder.h"
+#include "node/project/sequence/sequence.h"
+#include "task/project/load/load.h"
+
 namespace olive {
 
-CLIExportManager::CLIExportManager()
+CLIExportManager::CLIExportManager() :
+  worker_index_(-1),
+  worker_count_(0),
+  join_(false)
+{
+}
+
+bool CLIExportManager::Run(const QString &project_filename)
 {
+  if (preset_file_.isEmpty()) {
+    qCritical().noquote() << tr("You must specify an export preset with --export-preset");
+    return false;
+  }
+
+  EncodingParams params;
+  {
+    QFile preset(preset_file_);
+    if (!preset.open(QFile::ReadOnly) || !params.Load(&preset)) {
+      qCritical().noquote() << tr("Failed to load export preset: %1").arg(preset_file_);
+      return false;
+    }
+  }
+
+  if (params.filename().isEmpty()) {
+    qCritical().noquote() << tr("Export preset does not contain an output filename");
+    return false;
+  }
+
+  if (join_) {
+    // Joining only stitches files the workers already produced, no project needed
+    return Join(params);
+  }
+
+  if (project_filename.isEmpty()) {
+    qCritical().noquote() << tr("You must specify a project file to export");
+    return false;
+  }
+
+  if (!QFileInfo::exists(project_filename)) {
+    qCritical().noquote() << tr("Specified project does not exist");
+    return false;
+  }
+
+  ProjectLoadTask load_task(project_filename);
+  CLITaskDialog load_dialog(&load_task);
+
+  if (!load_dialog.Run()) {
+    qCritical().noquote() << tr("Project failed to load: %1").arg(load_task.GetError());
+    return false;
+  }
+
+  std::unique_ptr<Project> project(load_task.GetLoadedProject());
+
+  Sequence* sequence = PickSequence(project.get());
+  if (!sequence) {
+    return false;
+  }
+
+  if (worker_count_ > 1) {
+    if (worker_index_ < 0 || worker_index_ >= worker_count_) {
+      qCritical().noquote() << tr("Worker index must be between 0 and %1").arg(worker_count_ - 1);
+      return false;
+    }
+
+    rational timebase = params.video_params().time_base();
+    if (!params.video_enabled() || timebase.isNull()) {
+      qCritical().noquote() << tr("Export preset has no video frame rate, cannot split into worker ranges");
+      return false;
+    }
+
+    TimeRange full_range = params.has_custom_range() ? params.custom_range()
+                                                     : TimeRange(0, sequence->GetLength());
+
+    // Split the range into even frame-aligned slices, one per worker
+    TimeRangeListFrameIterator iterator({full_range}, timebase);
+    int64_t total_frames = iterator.size();
+    int64_t frames_per_worker = (total_frames + worker_count_ - 1) / worker_count_;
+
+    int64_t start = frames_per_worker * worker_index_;
+    if (start >= total_frames) {
+      qInfo().noquote() << tr("Worker %1 has no frames to render").arg(worker_index_);
+      return true;
+    }
+    int64_t end = qMin(start + frames_per_worker, total_frames);
+
+    EncodingParams worker_params = params;
+    worker_params.set_custom_range(TimeRange(full_range.in() + Timecode::timestamp_to_time(start, timebase),
+                                             full_range.in() + Timecode::timestamp_to_time(end, timebase)));
+    worker_params.SetFilename(GetWorkerFilename(params.filename(), QStringLiteral("wk%1").arg(worker_index_)));
+    worker_params.DisableAudio();
+    worker_params.DisableSubtitles();
+
+    if (!RunExport(sequence, project->color_manager(), worker_params)) {
+      return false;
+    }
+
+    if (worker_index_ == 0 && params.audio_enabled()) {
+      // The first worker also encodes the whole audio track in one piece so segment boundaries
+      // can't introduce codec priming gaps; it's interleaved with the video during the join
+      EncodingParams audio_params = params;
+      audio_params.SetFilename(GetWorkerFilename(params.filename(), QStringLiteral("audio")));
+      audio_params.DisableVideo();
+      audio_params.DisableSubtitles();
+
+      if (!RunExport(sequence, project->color_manager(), audio_params)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  return RunExport(sequence, project->color_manager(), params);
+}
+
+bool CLIExportManager::RunQueue(const QString &queue_filename)
+{
+  QFile queue_file(queue_filename);
+  if (!queue_file.open(QFile::ReadOnly | QFile::Text)) {
+    qCritical().noquote() << tr("Failed to open export queue file: %1").arg(queue_filename);
+    return false;
+  }
+
+  // Each job is a project filename paired with the preset to export it with
+  QVector<QPair<QString, QString> > jobs;
+
+  QTextStream stream(&queue_file);
+  int line_number = 0;
+  while (!stream.atEnd()) {
+    line_number++;
+
+    QString line = stream.readLine().trimmed();
+    if (line.isEmpty() || line.startsWith('#')) {
+      continue;
+    }
+
+    int tab = line.indexOf('\t');
+    if (tab == -1) {
+      qCritical().noquote() << tr("Line %1 of queue file is not \"project<TAB>preset\"").arg(line_number);
+      return false;
+    }
+
+    jobs.append(qMakePair(line.left(tab).trimmed(), line.mid(tab + 1).trimmed()));
+  }
+
+  if (jobs.isEmpty()) {
+    qCritical().noquote() << tr("Export queue file contains no jobs");
+    return false;
+  }
+
+  bool all_succeeded = true;
+
+  // The next job's project is always loading and probing its footage on another thread while
+  // the current job renders and drains its encoders, so back-to-back jobs hand over without a
+  // stall. The decoder and OCIO processor caches are process-wide, so nothing warm is lost in
+  // the transition either.
+  QFuture<Project*> next_load = QtConcurrent::run(LoadQueuedProject, jobs.first().first);
+
+  for (int i=0; i<jobs.size(); i++) {
+    std::unique_ptr<Project> project(next_load.result());
 
+    if (i + 1 < jobs.size()) {
+      next_load = QtConcurrent::run(LoadQueuedProject, jobs.at(i + 1).first);
+    }
+
+    qInfo().noquote() << tr("Export queue: job %1 of %2").arg(QString::number(i + 1), QString::number(jobs.size()));
+
+    if (!project) {
+      // LoadQueuedProject already reported why
+      all_succeeded = false;
+      continue;
+    }
+
+    EncodingParams params;
+    {
+      QFile preset(jobs.at(i).second);
+      if (!preset.open(QFile::ReadOnly) || !params.Load(&preset)) {
+        qCritical().noquote() << tr("Failed to load export preset: %1").arg(jobs.at(i).second);
+        all_succeeded = false;
+        continue;
+      }
+    }
+
+    if (params.filename().isEmpty()) {
+      qCritical().noquote() << tr("Export preset does not contain an output filename: %1").arg(jobs.at(i).second);
+      all_succeeded = false;
+      continue;
+    }
+
+    Sequence* sequence = PickSequence(project.get());
+    if (!sequence) {
+      all_succeeded = false;
+      continue;
+    }
+
+    if (!RunExport(sequence, project->color_manager(), params)) {
+      all_succeeded = false;
+    }
+  }
+
+  return all_succeeded;
+}
+
+Project *CLIExportManager::LoadQueuedProject(const QString &filename)
+{
+  if (!QFileInfo::exists(filename)) {
+    qCritical().noquote() << tr("Specified project does not exist: %1").arg(filename);
+    return nullptr;
+  }
+
+  // No CLITaskDialog here - this runs concurrently with the previous job's export, whose
+  // progress owns the console
+  ProjectLoadTask load_task(filename);
+  if (!load_task.Start()) {
+    qCritical().noquote() << tr("Project failed to load: %1").arg(load_task.GetError());
+    return nullptr;
+  }
+
+  return load_task.GetLoadedProject();
+}
+
+Sequence *CLIExportManager::PickSequence(Project *project)
+{
+  QVector<Sequence*> sequences;
+  foreach (Node* node, project->nodes()) {
+    if (Sequence* sequence = dynamic_cast<Sequence*>(node)) {
+      sequences.append(sequence);
+    }
+  }
+
+  if (sequences.isEmpty()) {
+    qCritical().noquote() << tr("Project contains no sequences, nothing to export");
+    return nullptr;
+  }
+
+  Sequence* sequence = sequences.first();
+  if (sequences.size() > 1) {
+    qWarning().noquote() << tr("Project has multiple sequences, exporting \"%1\"").arg(sequence->GetLabel());
+  }
+
+  return sequence;
+}
+
+bool CLIExportManager::RunExport(ViewerOutput *viewer, ColorManager *color_manager, const EncodingParams &params)
+{
+  ExportTask export_task(viewer, color_manager, params);
+  CLITaskDialog export_dialog(&export_task);
+
+  if (export_dialog.Run()) {
+    qInfo().noquote() << tr("Exported \"%1\"").arg(params.filename());
+    return true;
+  } else {
+    qCritical().noquote() << tr("Export failed: %1").arg(export_task.GetError());
+    return false;
+  }
+}
+
+bool CLIExportManager::Join(const EncodingParams &params)
+{
+  if (Encoder::GetTypeFromFormat(params.format()) != Encoder::kEncoderTypeFFmpeg) {
+    qCritical().noquote() << tr("Only FFmpeg formats can be joined from worker segments");
+    return false;
+  }
+
+  QVector<QString> segments;
+  for (int i=0; i<worker_count_; i++) {
+    QString segment_filename = GetWorkerFilename(params.filename(), QStringLiteral("wk%1").arg(i));
+
+    if (!QFileInfo::exists(segment_filename)) {
+      qCritical().noquote() << tr("Missing worker segment: %1").arg(segment_filename);
+      return false;
+    }
+
+    segments.append(segment_filename);
+  }
+
+  QString audio_filename = GetWorkerFilename(params.filename(), QStringLiteral("audio"));
+  if (!QFileInfo::exists(audio_filename)) {
+    audio_filename.clear();
+  }
+
+  QString error;
+  if (!FFmpegEncoder::ConcatenateSegments(segments, audio_filename, params.filename(), &error)) {
+    qCritical().noquote() << tr("Failed to join worker segments: %1").arg(error);
+    return false;
+  }
+
+  // The worker intermediates are no longer needed
+  foreach (const QString& segment_filename, segments) {
+    QFile::remove(segment_filename);
+  }
+  if (!audio_filename.isEmpty()) {
+    QFile::remove(audio_filename);
+  }
+
+  qInfo().noquote() << tr("Joined %1 worker segment(s) into \"%2\"").arg(QString::number(worker_count_), params.filename());
+
+  return true;
+}
+
+QString CLIExportManager::GetWorkerFilename(const QString &filename, const QString &suffix)
+{
+  // Insert the suffix before the extension so FFmpeg can still determine the format from it
+  QFileInfo fi(filename);
+  return fi.dir().filePath(QStringLiteral("%1.%2.%3").arg(fi.completeBaseName(), suffix, fi.suffix()));
 }
 
 }
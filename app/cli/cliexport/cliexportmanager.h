@@ -25,10 +25,84 @@
 
 namespace olive {
 
+class Sequence;
+
+/**
+ * @brief Drives headless exports, optionally splitting them across several machines
+ *
+ * In the default mode the whole sequence is exported on this machine using the encoding
+ * parameters loaded from a preset file. In worker mode (`--farm-worker N --farm-count M`) this
+ * instance renders only its slice of the frame range into a segment file next to the output, so
+ * any number of machines with access to the same project and output directory (e.g. spawned
+ * over SSH) can render in parallel. Once all workers have finished, a join pass
+ * (`--farm-join --farm-count M`) losslessly stitches the segments and the separately encoded
+ * audio into the final file.
+ *
+ * Queue mode (`--export-queue <file>`) runs a batch of jobs back-to-back in one process. Since
+ * decoders and OCIO processors live in process-wide caches (see RenderManager and Renderer),
+ * jobs that share media reuse them instead of reopening everything per job, and the next job's
+ * project is loaded and probed while the previous job's tail is still encoding, so transitions
+ * don't stall the pipeline.
+ */
 class CLIExportManager : public QObject
 {
+  Q_OBJECT
 public:
   CLIExportManager();
+
+  void SetPreset(const QString &preset_file)
+  {
+    preset_file_ = preset_file;
+  }
+
+  void SetWorker(int index, int count)
+  {
+    worker_index_ = index;
+    worker_count_ = count;
+  }
+
+  void SetJoin(int count)
+  {
+    join_ = true;
+    worker_count_ = count;
+  }
+
+  bool Run(const QString &project_filename);
+
+  /**
+   * @brief Run every job in a queue file back-to-back
+   *
+   * Each non-empty line of the file is `project-file<TAB>preset-file`; lines starting with `#`
+   * are comments. Failed jobs are reported and skipped so a nightly batch always runs to the
+   * end; returns true only if every job succeeded.
+   */
+  bool RunQueue(const QString &queue_filename);
+
+private:
+  bool RunExport(ViewerOutput *viewer, ColorManager *color_manager, const EncodingParams &params);
+
+  /**
+   * @brief Load a project without console progress so it can run concurrently with an export
+   */
+  static Project *LoadQueuedProject(const QString &filename);
+
+  /**
+   * @brief Pick the sequence a headless export renders, printing errors/warnings as appropriate
+   */
+  static Sequence *PickSequence(Project *project);
+
+  bool Join(const EncodingParams &params);
+
+  static QString GetWorkerFilename(const QString &filename, const QString &suffix);
+
+  QString preset_file_;
+
+  int worker_index_;
+
+  int worker_count_;
+
+  bool join_;
+
 };
 
 }
@@ -0,0 +1,303 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "clifixturemanager.h"
+
+#include <QDir>
+#include <QFileInfo>
+
+#include <memory>
+
+#include "codec/encoder.h"
+#include "codec/exportcodec.h"
+#include "codec/exportformat.h"
+#include "codec/frame.h"
+#include "node/block/clip/clip.h"
+#include "node/filter/blur/blur.h"
+#include "node/project/folder/folder.h"
+#include "node/project/footage/footage.h"
+#include "node/project/sequence/sequence.h"
+#include "node/project/serializer/serializer.h"
+#include "timeline/timelineundogeneral.h"
+
+namespace olive {
+
+CLIFixtureManager::CLIFixtureManager()
+{
+}
+
+bool CLIFixtureManager::Run(const QString &output_dir, const QString &spec)
+{
+  // Spec defaults - every value here is part of the reproducibility contract, so changing one
+  // invalidates comparisons against previously reported numbers
+  QString codec_name = QStringLiteral("h264");
+  int width = 1920;
+  int height = 1080;
+  int fps = 30;
+  int gop = -1;
+  double duration = 10.0;
+  int tracks = 4;
+  int clips = 50;
+  double cliplen = 2.0;
+  int effects = 1;
+
+  if (!spec.isEmpty()) {
+    foreach (const QString &entry, spec.split(',')) {
+      QStringList kv = entry.split('=');
+      if (kv.size() != 2) {
+        qCritical().noquote() << tr("Invalid fixture spec entry \"%1\", expected key=value").arg(entry);
+        return false;
+      }
+
+      const QString &key = kv.at(0);
+      const QString &value = kv.at(1);
+
+      if (key == QStringLiteral("codec")) {
+        codec_name = value;
+      } else if (key == QStringLiteral("width")) {
+        width = value.toInt();
+      } else if (key == QStringLiteral("height")) {
+        height = value.toInt();
+      } else if (key == QStringLiteral("fps")) {
+        fps = value.toInt();
+      } else if (key == QStringLiteral("gop")) {
+        gop = value.toInt();
+      } else if (key == QStringLiteral("duration")) {
+        duration = value.toDouble();
+      } else if (key == QStringLiteral("tracks")) {
+        tracks = value.toInt();
+      } else if (key == QStringLiteral("clips")) {
+        clips = value.toInt();
+      } else if (key == QStringLiteral("cliplen")) {
+        cliplen = value.toDouble();
+      } else if (key == QStringLiteral("effects")) {
+        effects = value.toInt();
+      } else {
+        qCritical().noquote() << tr("Unknown fixture spec key \"%1\"").arg(key);
+        return false;
+      }
+    }
+  }
+
+  if (width <= 0 || height <= 0 || fps <= 0 || duration <= 0 || tracks <= 0 || clips <= 0 || cliplen <= 0) {
+    qCritical().noquote() << tr("Fixture spec values must be positive");
+    return false;
+  }
+
+  ExportCodec::Codec codec;
+  ExportFormat::Format format;
+
+  if (codec_name == QStringLiteral("h264")) {
+    codec = ExportCodec::kCodecH264;
+    format = ExportFormat::kFormatMPEG4Video;
+  } else if (codec_name == QStringLiteral("h265")) {
+    codec = ExportCodec::kCodecH265;
+    format = ExportFormat::kFormatMPEG4Video;
+  } else if (codec_name == QStringLiteral("prores")) {
+    codec = ExportCodec::kCodecProRes;
+    format = ExportFormat::kFormatQuickTime;
+  } else if (codec_name == QStringLiteral("dnxhd")) {
+    codec = ExportCodec::kCodecDNxHD;
+    format = ExportFormat::kFormatQuickTime;
+  } else if (codec_name == QStringLiteral("vp9")) {
+    codec = ExportCodec::kCodecVP9;
+    format = ExportFormat::kFormatMatroska;
+  } else {
+    qCritical().noquote() << tr("Unknown fixture codec \"%1\" (supported: h264, h265, prores, dnxhd, vp9)").arg(codec_name);
+    return false;
+  }
+
+  QDir dir(output_dir.isEmpty() ? QDir::currentPath() : output_dir);
+  if (!dir.mkpath(QStringLiteral("."))) {
+    qCritical().noquote() << tr("Failed to create output directory \"%1\"").arg(dir.absolutePath());
+    return false;
+  }
+
+  //
+  // Encode the media fixture
+  //
+
+  const rational timebase(1, fps);
+
+  VideoParams media_params(width, height, timebase,
+                           PixelFormat(PixelFormat::U8), VideoParams::kRGBAChannelCount);
+  media_params.set_frame_rate(rational(fps, 1));
+
+  QString media_filename = dir.filePath(QStringLiteral("fixture_%1.%2").arg(codec_name, ExportFormat::GetExtension(format)));
+
+  EncodingParams encode_params;
+  encode_params.SetFilename(media_filename);
+  encode_params.set_format(format);
+  encode_params.EnableVideo(media_params, codec);
+
+  QStringList pix_fmts = ExportFormat::GetPixelFormatsForCodec(format, codec);
+  if (!pix_fmts.isEmpty()) {
+    encode_params.set_video_pix_fmt(pix_fmts.first());
+  }
+
+  if (gop > 0) {
+    encode_params.set_video_option(QStringLiteral("ove_gop"), QString::number(gop));
+  }
+
+  std::unique_ptr<Encoder> encoder(Encoder::CreateFromParams(encode_params));
+  if (!encoder || !encoder->Open()) {
+    qCritical().noquote() << tr("Failed to open encoder for \"%1\"").arg(media_filename);
+    return false;
+  }
+
+  const int frame_count = qRound(duration * fps);
+
+  for (int i=0; i<frame_count; i++) {
+    // A fresh frame per iteration because the encoder wraps the buffer zero-copy and may still
+    // be referencing it after WriteFrame() returns
+    FramePtr frame = Frame::Create();
+    frame->set_video_params(media_params);
+    frame->allocate();
+
+    FillFrame(frame.get(), i);
+
+    if (!encoder->WriteFrame(frame, rational(i, fps))) {
+      qCritical().noquote() << tr("Failed to encode frame %1: %2").arg(QString::number(i), encoder->GetError());
+      encoder->Close();
+      return false;
+    }
+  }
+
+  encoder->Close();
+
+  qInfo().noquote() << tr("Encoded %1 frame(s) to \"%2\"").arg(QString::number(frame_count), media_filename);
+
+  //
+  // Build the synthetic project
+  //
+
+  Project project;
+
+  Footage *footage = new Footage(media_filename);
+  footage->setParent(&project);
+  footage->SetLabel(QFileInfo(media_filename).fileName());
+  FolderAddChild(project.root(), footage).redo_now();
+
+  Sequence *sequence = new Sequence();
+  sequence->setParent(&project);
+  sequence->SetLabel(QStringLiteral("Fixture Sequence"));
+  sequence->set_default_parameters();
+
+  VideoParams sequence_params = sequence->GetVideoParams();
+  sequence_params.set_width(width);
+  sequence_params.set_height(height);
+  sequence_params.set_time_base(timebase);
+  sequence_params.set_frame_rate(rational(fps, 1));
+  sequence->SetVideoParams(sequence_params);
+
+  FolderAddChild(project.root(), sequence).redo_now();
+
+  const rational clip_length = rational::fromDouble(cliplen);
+
+  // Stagger each clip's media in point so playback and scrubbing hit different parts of the
+  // media's GOP structure rather than decoding the same keyframe run repeatedly
+  const int media_in_steps = qMax(1, qRound((duration - cliplen) * fps));
+
+  for (int t=0; t<tracks; t++) {
+    TimelineAddTrackCommand track_command(sequence->track_list(Track::kVideo));
+    track_command.redo_now();
+    Track *track = track_command.track();
+
+    for (int c=0; c<clips; c++) {
+      ClipBlock *clip = new ClipBlock();
+      clip->setParent(&project);
+      clip->SetLabel(QStringLiteral("Clip %1.%2").arg(QString::number(t), QString::number(c)));
+
+      track->AppendBlock(clip);
+
+      clip->set_media_in(rational((t * clips + c) % media_in_steps, fps));
+      clip->set_length_and_media_out(clip_length);
+
+      clip->SetNodePositionInContext(clip, QPointF(0, 0));
+      clip->SetNodePositionInContext(footage, QPointF(-1 - effects, 0));
+
+      Node *upstream = footage;
+
+      for (int e=0; e<effects; e++) {
+        BlurFilterNode *blur = new BlurFilterNode();
+        blur->setParent(&project);
+
+        Node::ConnectEdge(upstream, NodeInput(blur, BlurFilterNode::kTextureInput));
+        clip->SetNodePositionInContext(blur, QPointF(-effects + e, 0));
+
+        upstream = blur;
+      }
+
+      Node::ConnectEdge(upstream, NodeInput(clip, ClipBlock::kBufferIn));
+    }
+  }
+
+  //
+  // Save the project
+  //
+
+  QString project_filename = dir.filePath(QStringLiteral("fixture.ove"));
+
+  ProjectSerializer::SaveData save_data(ProjectSerializer::kProject, &project, project_filename);
+
+  ProjectSerializer::Result result = ProjectSerializer::Save(save_data, true);
+  if (result != ProjectSerializer::kSuccess) {
+    qCritical().noquote() << tr("Failed to save fixture project to \"%1\"").arg(project_filename);
+    return false;
+  }
+
+  qInfo().noquote() << tr("Built fixture project \"%1\" (%2 track(s), %3 clip(s), %4 effect(s) per clip)")
+                       .arg(project_filename,
+                            QString::number(tracks),
+                            QString::number(tracks * clips),
+                            QString::number(effects));
+
+  return true;
+}
+
+void CLIFixtureManager::FillFrame(Frame *frame, int index)
+{
+  // Deterministic pattern with both spatial detail and motion: a scrolling gradient mixed with
+  // hash noise. Flat frames would compress to almost nothing and make every codec look fast,
+  // and anything time-seeded wouldn't reproduce across runs.
+  uint8_t *data = reinterpret_cast<uint8_t*>(frame->data());
+
+  const int width = frame->width();
+  const int height = frame->height();
+  const int linesize = frame->linesize_bytes();
+
+  for (int y=0; y<height; y++) {
+    uint8_t *row = data + y * linesize;
+
+    for (int x=0; x<width; x++) {
+      uint32_t hash = (uint32_t(x) * 73856093u) ^ (uint32_t(y) * 19349663u) ^ (uint32_t(index) * 83492791u);
+      hash ^= hash >> 13;
+      hash *= 2654435761u;
+      hash ^= hash >> 16;
+
+      row[x*4 + 0] = uint8_t((x + index * 4) & 0xFF) ^ uint8_t(hash & 31);
+      row[x*4 + 1] = uint8_t((y + index * 2) & 0xFF) ^ uint8_t((hash >> 8) & 31);
+      row[x*4 + 2] = uint8_t((x + y + index) & 0xFF) ^ uint8_t((hash >> 16) & 31);
+      row[x*4 + 3] = 255;
+    }
+  }
+}
+
+}
@@ -0,0 +1,58 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef CLIFIXTUREMANAGER_H
+#define CLIFIXTUREMANAGER_H
+
+#include <QObject>
+
+namespace olive {
+
+class Frame;
+
+/**
+ * @brief Generates reproducible performance-test fixtures (`--generate-fixture`)
+ *
+ * Procedurally encodes a video-only test clip through the normal encoder path and builds a
+ * synthetic project referencing it, so every performance number reported against this codebase
+ * can be reproduced from a one-line command instead of a media file someone has to copy around.
+ * Frame content is a deterministic function of the frame index, so identical specs produce
+ * byte-identical media across machines and releases.
+ *
+ * The spec is a comma-separated key=value list; unset keys use defaults:
+ * codec (h264/h265/prores/dnxhd/vp9), width, height, fps, gop, duration (media seconds),
+ * tracks, clips (per track), cliplen (seconds), effects (blur nodes chained per clip).
+ */
+class CLIFixtureManager : public QObject
+{
+  Q_OBJECT
+public:
+  CLIFixtureManager();
+
+  bool Run(const QString &output_dir, const QString &spec);
+
+private:
+  static void FillFrame(Frame *frame, int index);
+
+};
+
+}
+
+#endif // CLIFIXTUREMANAGER_H
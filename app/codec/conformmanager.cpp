@@ -2,6 +2,7 @@
 
 #include <QDir>
 
+#include "config/config.h"
 #include "task/taskmanager.h"
 
 namespace olive {
@@ -58,16 +59,40 @@ ConformManager::Conform ConformManager::GetConformState(const QString &decoder_i
 }
 
 QVector<QString> ConformManager::GetConformedFilename(const QString &cache_path, const Decoder::CodecStream &stream, const AudioParams &params)
+{
+  // If both representations exist on disk, prefer whichever matches the current setting, but
+  // toggling the setting never orphans an existing conform of the other representation
+  QString preferred_ext = QStringLiteral("pcm");
+  QString fallback_ext = QStringLiteral("flac");
+  if (OLIVE_CONFIG("ConformCompression").toString() == QStringLiteral("flac")) {
+    std::swap(preferred_ext, fallback_ext);
+  }
+
+  QVector<QString> preferred = GetConformedFilenameWithExtension(cache_path, stream, params, preferred_ext);
+  if (AllConformsExist(preferred)) {
+    return preferred;
+  }
+
+  QVector<QString> fallback = GetConformedFilenameWithExtension(cache_path, stream, params, fallback_ext);
+  if (AllConformsExist(fallback)) {
+    return fallback;
+  }
+
+  return preferred;
+}
+
+QVector<QString> ConformManager::GetConformedFilenameWithExtension(const QString &cache_path, const Decoder::CodecStream &stream, const AudioParams &params, const QString &ext)
 {
   QVector<QString> filenames(params.channel_count());
 
   for (int i=0; i<filenames.size(); i++) {
-    QString index_fn = QStringLiteral("%1-%2.%3.%4.%5.%6.pcm").arg(FileFunctions::GetUniqueFileIdentifier(stream.filename()),
-                                                                   QString::number(stream.stream()),
-                                                                   QString::number(params.sample_rate()),
-                                                                   QString::number(params.format()),
-                                                                   QString::number(params.channel_layout()),
-                                                                   QString::number(i));
+    QString index_fn = QStringLiteral("%1-%2.%3.%4.%5.%6.%7").arg(FileFunctions::GetUniqueFileIdentifier(stream.filename()),
+                                                                  QString::number(stream.stream()),
+                                                                  QString::number(params.sample_rate()),
+                                                                  QString::number(params.format()),
+                                                                  QString::number(params.channel_layout()),
+                                                                  QString::number(i),
+                                                                  ext);
 
     filenames[i] = QDir(cache_path).filePath(index_fn);
   }
@@ -76,6 +76,8 @@ private:
    */
   static QVector<QString> GetConformedFilename(const QString &cache_path, const Decoder::CodecStream &stream, const AudioParams &params);
 
+  static QVector<QString> GetConformedFilenameWithExtension(const QString &cache_path, const Decoder::CodecStream &stream, const AudioParams &params, const QString &ext);
+
   static bool AllConformsExist(const QVector<QString> &filenames);
 
 private slots:
@@ -22,13 +22,17 @@
 
 #include <QCoreApplication>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QHash>
 
 #include "codec/ffmpeg/ffmpegdecoder.h"
+#include "codec/ffmpeg/flacaudiodevice.h"
 #include "codec/planarfiledevice.h"
 #include "codec/oiio/oiiodecoder.h"
 #include "common/ffmpegutils.h"
 #include "common/filefunctions.h"
+#include "common/performancelog.h"
+#include "common/tracerecorder.h"
 #include "conformmanager.h"
 #include "node/project.h"
 #include "task/taskmanager.h"
@@ -37,6 +41,9 @@ namespace olive {
 
 const rational Decoder::kAnyTimecode = RATIONAL_MIN;
 
+QMutex Decoder::statistics_mutex_;
+QHash<QString, Decoder::Statistics> Decoder::statistics_;
+
 Decoder::Decoder() :
   cached_texture_(nullptr)
 {
@@ -112,11 +119,51 @@ TexturePtr Decoder::RetrieveVideo(const RetrieveVideoParams &p)
     return nullptr;
   }
 
+  // If a proxy is attached and this request is at least as downscaled as the proxy was generated
+  // at, decode from the proxy instead of the original file
+  if (!stream_.proxy_filename().isEmpty() && p.divider >= stream_.proxy_divider()) {
+    if (!proxy_decoder_) {
+      // Proxies are always encoded to a format our FFmpeg decoder handles
+      proxy_decoder_ = CreateFromID(QStringLiteral("ffmpeg"));
+    }
+
+    if (proxy_decoder_ && proxy_decoder_->Open(CodecStream(stream_.proxy_filename(), 0, stream_.block()))) {
+      RetrieveVideoParams proxy_params = p;
+
+      // The proxy is already downscaled, so only the remainder of the divider applies to it
+      proxy_params.divider = qMax(1, p.divider / stream_.proxy_divider());
+
+      locker.unlock();
+
+      return proxy_decoder_->RetrieveVideo(proxy_params);
+    }
+  }
+
   if (cached_texture_ && cached_time_ == p.time && cached_divider_ == p.divider) {
     return cached_texture_;
   }
 
+  TraceRecorder *trace = TraceRecorder::instance();
+  if (trace) {
+    trace->BeginEvent("decoder", stream_.filename());
+  }
+
+  PerformanceLog *perf = PerformanceLog::instance();
+  QElapsedTimer decode_timer;
+  if (perf) {
+    decode_timer.start();
+  }
+
   cached_texture_ = RetrieveVideoInternal(p);
+
+  if (perf) {
+    perf->RecordDecodeTime(id(), decode_timer.elapsed());
+  }
+
+  if (trace) {
+    trace->EndEvent("decoder", stream_.filename());
+  }
+
   cached_time_ = p.time;
   cached_divider_ = p.divider;
 
@@ -146,12 +193,29 @@ Decoder::RetrieveAudioStatus Decoder::RetrieveAudio(SampleBuffer &dest, const Ti
     return kWaitingForConform;
   }
 
+  TraceRecorder *trace = TraceRecorder::instance();
+  if (trace) {
+    trace->BeginEvent("decoder", stream_.filename());
+  }
+
+  PerformanceLog *perf = PerformanceLog::instance();
+  QElapsedTimer decode_timer;
+  if (perf) {
+    decode_timer.start();
+  }
+
   // See if we got the conform
-  if (RetrieveAudioFromConform(dest, conform.filenames, range, loop_mode, params)) {
-    return kOK;
-  } else {
-    return kUnknownError;
+  bool got_conform = RetrieveAudioFromConform(dest, conform.filenames, range, loop_mode, params);
+
+  if (perf) {
+    perf->RecordDecodeTime(id(), decode_timer.elapsed());
+  }
+
+  if (trace) {
+    trace->EndEvent("decoder", stream_.filename());
   }
+
+  return got_conform ? kOK : kUnknownError;
 }
 
 qint64 Decoder::GetLastAccessedTime()
@@ -159,6 +223,48 @@ qint64 Decoder::GetLastAccessedTime()
   return last_accessed_;
 }
 
+Decoder::Statistics Decoder::GetStatistics(const QString &filename)
+{
+  QMutexLocker locker(&statistics_mutex_);
+
+  return statistics_.value(filename);
+}
+
+void Decoder::ReportSeek(qint64 time_ms)
+{
+  QMutexLocker locker(&statistics_mutex_);
+
+  Statistics& stats = statistics_[stream_.filename()];
+  stats.seek_count++;
+  stats.seek_time_ms += time_ms;
+}
+
+void Decoder::ReportFrameDecoded()
+{
+  QMutexLocker locker(&statistics_mutex_);
+
+  statistics_[stream_.filename()].frames_decoded++;
+}
+
+void Decoder::ReportFrameCacheResult(bool hit)
+{
+  QMutexLocker locker(&statistics_mutex_);
+
+  Statistics& stats = statistics_[stream_.filename()];
+  if (hit) {
+    stats.frame_cache_hits++;
+  } else {
+    stats.frame_cache_misses++;
+  }
+}
+
+void Decoder::ReportConversionTime(qint64 time_ms)
+{
+  QMutexLocker locker(&statistics_mutex_);
+
+  statistics_[stream_.filename()].conversion_time_ms += time_ms;
+}
+
 void Decoder::Close()
 {
   QMutexLocker locker(&mutex_);
@@ -167,6 +273,11 @@ void Decoder::Close()
 
   cached_texture_ = nullptr;
 
+  if (proxy_decoder_) {
+    proxy_decoder_->Close();
+    proxy_decoder_ = nullptr;
+  }
+
   if (stream_.IsValid()) {
     CloseInternal();
     stream_.Reset();
@@ -280,52 +391,66 @@ bool Decoder::ConformAudioInternal(const QVector<QString> &filenames, const Audi
   return false;
 }
 
-bool Decoder::RetrieveAudioFromConform(SampleBuffer &sample_buffer, const QVector<QString> &conform_filenames, TimeRange range, LoopMode loop_mode, const AudioParams &input_params)
+// Shared between the raw PCM and FLAC conform devices, which expose the same byte-addressed API
+template <typename T>
+void ReadSamplesFromConformDevice(T &input, SampleBuffer &sample_buffer, const TimeRange &range, LoopMode loop_mode, const AudioParams &input_params)
 {
-  PlanarFileDevice input;
-  if (input.open(conform_filenames, QFile::ReadOnly)) {
-    // Offset range by audio start offset
-    range -= GetAudioStartOffset();
-
-    qint64 read_index = input_params.time_to_bytes(range.in()) / input_params.channel_count();
-    qint64 write_index = 0;
-
-    const qint64 buffer_length_in_bytes = sample_buffer.sample_count() * input_params.bytes_per_sample_per_channel();
+  qint64 read_index = input_params.time_to_bytes(range.in()) / input_params.channel_count();
+  qint64 write_index = 0;
 
-    while (write_index < buffer_length_in_bytes) {
-      if (loop_mode == LoopMode::kLoopModeLoop) {
-        while (read_index >= input.size()) {
-          read_index -= input.size();
-        }
+  const qint64 buffer_length_in_bytes = sample_buffer.sample_count() * input_params.bytes_per_sample_per_channel();
 
-        while (read_index < 0) {
-          read_index += input.size();
-        }
+  while (write_index < buffer_length_in_bytes) {
+    if (loop_mode == LoopMode::kLoopModeLoop) {
+      while (read_index >= input.size()) {
+        read_index -= input.size();
       }
 
-      qint64 write_count = 0;
-
-      if (read_index < 0) {
-        // Reading before 0, write silence here until audio data would actually start
-        write_count = qMin(-read_index, buffer_length_in_bytes);
-        sample_buffer.silence_bytes(write_index, write_index + write_count);
-      } else if (read_index >= input.size()) {
-        // Reading after data length, write silence until the end of the buffer
-        write_count = buffer_length_in_bytes - write_index;
-        sample_buffer.silence_bytes(write_index, write_index + write_count);
-      } else {
-        write_count = qMin(input.size() - read_index, buffer_length_in_bytes - write_index);
-        input.seek(read_index);
-        input.read(reinterpret_cast<char**>(sample_buffer.to_raw_ptrs().data()), write_count, write_index);
+      while (read_index < 0) {
+        read_index += input.size();
       }
+    }
+
+    qint64 write_count = 0;
 
-      read_index += write_count;
-      write_index += write_count;
+    if (read_index < 0) {
+      // Reading before 0, write silence here until audio data would actually start
+      write_count = qMin(-read_index, buffer_length_in_bytes);
+      sample_buffer.silence_bytes(write_index, write_index + write_count);
+    } else if (read_index >= input.size()) {
+      // Reading after data length, write silence until the end of the buffer
+      write_count = buffer_length_in_bytes - write_index;
+      sample_buffer.silence_bytes(write_index, write_index + write_count);
+    } else {
+      write_count = qMin(input.size() - read_index, buffer_length_in_bytes - write_index);
+      input.seek(read_index);
+      input.read(reinterpret_cast<char**>(sample_buffer.to_raw_ptrs().data()), write_count, write_index);
     }
 
-    input.close();
+    read_index += write_count;
+    write_index += write_count;
+  }
+}
 
-    return true;
+bool Decoder::RetrieveAudioFromConform(SampleBuffer &sample_buffer, const QVector<QString> &conform_filenames, TimeRange range, LoopMode loop_mode, const AudioParams &input_params)
+{
+  // Offset range by audio start offset
+  range -= GetAudioStartOffset();
+
+  if (conform_filenames.first().endsWith(QStringLiteral(".flac"))) {
+    FlacAudioDevice input;
+    if (input.open(conform_filenames, input_params, QFile::ReadOnly)) {
+      ReadSamplesFromConformDevice(input, sample_buffer, range, loop_mode, input_params);
+      input.close();
+      return true;
+    }
+  } else {
+    PlanarFileDevice input;
+    if (input.open(conform_filenames, QFile::ReadOnly)) {
+      ReadSamplesFromConformDevice(input, sample_buffer, range, loop_mode, input_params);
+      input.close();
+      return true;
+    }
   }
 
   return false;
@@ -338,7 +463,11 @@ void Decoder::UpdateLastAccessed()
 
 uint qHash(Decoder::CodecStream stream, uint seed)
 {
-  return qHash(stream.filename(), seed) ^ ::qHash(stream.stream(), seed) ^ qHash(stream.block(), seed);
+  // Hash exactly the fields operator== compares. Notably the block is excluded: hashing it
+  // made equal keys (the same media referenced by different clips, or by two open projects)
+  // land in different buckets, so every clip warmed up its own decoder instead of sharing the
+  // one already open on the file.
+  return qHash(stream.filename(), seed) ^ ::qHash(stream.stream(), seed) ^ qHash(stream.proxy_filename(), seed);
 }
 
 }
@@ -86,14 +86,16 @@ public:
   public:
     CodecStream() :
       stream_(-1),
-      block_(nullptr)
+      block_(nullptr),
+      proxy_divider_(1)
     {
     }
 
     CodecStream(const QString& filename, int stream, Block *block) :
       filename_(filename),
       stream_(stream),
-      block_(block)
+      block_(block),
+      proxy_divider_(1)
     {
     }
 
@@ -114,7 +116,9 @@ public:
 
     bool operator==(const CodecStream& rhs) const
     {
-      return filename_ == rhs.filename_ && stream_ == rhs.stream_;
+      // Proxy filename is included so that attaching or detaching a proxy resolves a fresh
+      // decoder rather than reusing one opened on the other file
+      return filename_ == rhs.filename_ && stream_ == rhs.stream_ && proxy_filename_ == rhs.proxy_filename_;
     }
 
     const QString& filename() const
@@ -132,6 +136,22 @@ public:
       return block_;
     }
 
+    const QString& proxy_filename() const
+    {
+      return proxy_filename_;
+    }
+
+    int proxy_divider() const
+    {
+      return proxy_divider_;
+    }
+
+    void set_proxy(const QString& filename, int divider)
+    {
+      proxy_filename_ = filename;
+      proxy_divider_ = divider;
+    }
+
   private:
     QString filename_;
 
@@ -139,8 +159,47 @@ public:
 
     Block *block_;
 
+    QString proxy_filename_;
+
+    int proxy_divider_;
+
   };
 
+  /**
+   * @brief Aggregated decoder performance counters for one media file
+   *
+   * Decoder instances are transient - each render thread resolves its own for a stream - so
+   * counters are accumulated into a process-wide registry keyed by filename. That way the
+   * numbers describe the media file regardless of which instances serviced it, which is what's
+   * needed to answer "is this file expensive to decode?".
+   */
+  struct Statistics
+  {
+    Statistics() :
+      seek_count(0),
+      seek_time_ms(0),
+      frames_decoded(0),
+      frame_cache_hits(0),
+      frame_cache_misses(0),
+      conversion_time_ms(0)
+    {
+    }
+
+    qint64 seek_count;
+    qint64 seek_time_ms;
+    qint64 frames_decoded;
+    qint64 frame_cache_hits;
+    qint64 frame_cache_misses;
+    qint64 conversion_time_ms;
+  };
+
+  /**
+   * @brief Retrieve the statistics accumulated for a media file this session
+   *
+   * Returns a zeroed struct if the file has never been decoded. This function is thread safe.
+   */
+  static Statistics GetStatistics(const QString& filename);
+
   /**
    * @brief Open stream for decoding
    *
@@ -212,6 +271,26 @@ public:
    */
   virtual FootageDescription Probe(const QString& filename, CancelAtom *cancelled) const = 0;
 
+  /**
+   * @brief Cheaply re-read the current stream durations of a file
+   *
+   * For files that are still being written to (e.g. a recording that is being ingested while
+   * it's edited), the durations captured by Probe() go stale as the file grows. This fills
+   * `durations` with the latest duration of each stream - keyed by stream index, in the same
+   * time base the stream was probed with - without decoding any frames.
+   *
+   * Like Probe(), this should be effectively static and hold no state.
+   *
+   * The default implementation returns false, signalling that this decoder can't poll
+   * durations and the caller should fall back to a full re-probe.
+   */
+  virtual bool PollDuration(const QString& filename, QHash<int, int64_t>& durations) const
+  {
+    Q_UNUSED(filename)
+    Q_UNUSED(durations)
+    return false;
+  }
+
   /**
    * @brief Closes media/deallocates memory
    *
@@ -288,6 +367,28 @@ protected:
 
   virtual rational GetAudioStartOffset() const { return 0; }
 
+  /**
+   * @brief Counter reporting for sub-classes - see Statistics
+   *
+   * Each call adds into the registry entry for the currently open stream's filename. All are
+   * thread safe and cheap relative to the work they measure.
+   */
+  void ReportSeek(qint64 time_ms);
+  void ReportFrameDecoded();
+  void ReportFrameCacheResult(bool hit);
+  void ReportConversionTime(qint64 time_ms);
+
+  /**
+   * @brief Mutex guarding all decoder state
+   *
+   * Exposed so sub-classes can run background work (e.g. decode-ahead) safely alongside the
+   * already-mutexed public API.
+   */
+  QMutex *mutex()
+  {
+    return &mutex_;
+  }
+
 signals:
   /**
    * @brief While indexing, this signal will provide progress as a percentage (0-100 inclusive) if
@@ -310,6 +411,11 @@ private:
   rational cached_time_;
   int cached_divider_;
 
+  DecoderPtr proxy_decoder_;
+
+  static QMutex statistics_mutex_;
+  static QHash<QString, Statistics> statistics_;
+
 };
 
 uint qHash(Decoder::CodecStream stream, uint seed = 0);
@@ -89,6 +89,8 @@ EncodingParams::EncodingParams() :
   video_max_bit_rate_(0),
   video_buffer_size_(0),
   video_threads_(0),
+  video_hardware_encoding_(false),
+  video_segments_(1),
   video_is_image_sequence_(false),
   audio_enabled_(false),
   audio_bit_rate_(0),
@@ -221,6 +223,8 @@ void EncodingParams::Save(QXmlStreamWriter *writer) const
     writer->writeTextElement(QStringLiteral("maxbitrate"), QString::number(video_max_bit_rate_));
     writer->writeTextElement(QStringLiteral("bufsize"), QString::number(video_buffer_size_));
     writer->writeTextElement(QStringLiteral("threads"), QString::number(video_threads_));
+    writer->writeTextElement(QStringLiteral("hwencode"), QString::number(video_hardware_encoding_));
+    writer->writeTextElement(QStringLiteral("segments"), QString::number(video_segments_));
     writer->writeTextElement(QStringLiteral("pixfmt"), video_pix_fmt_);
     writer->writeTextElement(QStringLiteral("imgseq"), QString::number(video_is_image_sequence_));
 
@@ -415,6 +419,10 @@ bool EncodingParams::LoadV1(QXmlStreamReader *reader)
           video_buffer_size_ = reader->readElementText().toLongLong();
         } else if (reader->name() == QStringLiteral("threads")) {
           video_threads_ = reader->readElementText().toInt();
+        } else if (reader->name() == QStringLiteral("hwencode")) {
+          video_hardware_encoding_ = reader->readElementText().toInt();
+        } else if (reader->name() == QStringLiteral("segments")) {
+          video_segments_ = reader->readElementText().toInt();
         } else if (reader->name() == QStringLiteral("pixfmt")) {
           video_pix_fmt_ = reader->readElementText();
         } else if (reader->name() == QStringLiteral("imgseq")) {
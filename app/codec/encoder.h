@@ -78,6 +78,8 @@ public:
   void set_video_max_bit_rate(const int64_t& rate) { video_max_bit_rate_ = rate; }
   void set_video_buffer_size(const int64_t& sz) { video_buffer_size_ = sz; }
   void set_video_threads(const int& threads) { video_threads_ = threads; }
+  void set_video_hardware_encoding(bool e) { video_hardware_encoding_ = e; }
+  void set_video_segments(const int& segments) { video_segments_ = segments; }
   void set_video_pix_fmt(const QString& s) { video_pix_fmt_ = s; }
   void set_video_is_image_sequence(bool s) { video_is_image_sequence_ = s; }
   void set_color_transform(const ColorTransform& color_transform) { color_transform_ = color_transform; }
@@ -95,6 +97,8 @@ public:
   const int64_t& video_max_bit_rate() const { return video_max_bit_rate_; }
   const int64_t& video_buffer_size() const { return video_buffer_size_; }
   const int& video_threads() const { return video_threads_; }
+  bool video_hardware_encoding() const { return video_hardware_encoding_; }
+  const int& video_segments() const { return video_segments_; }
   const QString& video_pix_fmt() const { return video_pix_fmt_; }
   bool video_is_image_sequence() const { return video_is_image_sequence_; }
   const ColorTransform& color_transform() const { return color_transform_; }
@@ -152,6 +156,8 @@ private:
   int64_t video_max_bit_rate_;
   int64_t video_buffer_size_;
   int video_threads_;
+  bool video_hardware_encoding_;
+  int video_segments_;
   QString video_pix_fmt_;
   bool video_is_image_sequence_;
   ColorTransform color_transform_;
@@ -25,13 +25,19 @@ extern "C" {
 #include <libavfilter/buffersink.h>
 #include <libavfilter/buffersrc.h>
 #include <libavformat/avformat.h>
+#include <libavutil/hwcontext.h>
 #include <libavutil/imgutils.h>
 #include <libavutil/opt.h>
 #include <libavutil/pixdesc.h>
 }
 
+#include <algorithm>
+
 #include <OpenImageIO/imagebuf.h>
+#include <QDataStream>
 #include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QString>
@@ -39,9 +45,12 @@ extern "C" {
 #include <QThread>
 #include <QtConcurrent/QtConcurrent>
 
+#include "codec/ffmpeg/flacaudiodevice.h"
 #include "codec/planarfiledevice.h"
 #include "common/ffmpegutils.h"
 #include "common/filefunctions.h"
+#include "config/config.h"
+#include "render/diskmanager.h"
 #include "render/renderer.h"
 #include "render/subtitleparams.h"
 
@@ -50,11 +59,22 @@ namespace olive {
 QVariant Yuv2RgbShader;
 QVariant DeinterlaceShader;
 
+// Length in seconds of each independently conformed audio chunk. Chunks are conformed in
+// parallel and completed ones persist on disk, so an interrupted conform resumes where it left
+// off instead of restarting.
+const int kConformChunkLength = 60;
+
+const quint32 kKeyframeIndexMagic = 0x4F564B49; // "OVKI"
+const quint32 kKeyframeIndexVersion = 1;
+
 FFmpegDecoder::FFmpegDecoder() :
   sws_ctx_(nullptr),
   working_packet_(nullptr),
   cache_at_zero_(false),
-  cache_at_eof_(false)
+  cache_at_eof_(false),
+  prefetch_cancel_(false),
+  prefetch_target_ts_(AV_NOPTS_VALUE),
+  last_retrieved_ts_(AV_NOPTS_VALUE)
 {
 }
 
@@ -172,6 +192,58 @@ TexturePtr FFmpegDecoder::ProcessFrameIntoTexture(AVFramePtr f, const RetrieveVi
     job.Insert(QStringLiteral("v_channel"), NodeValue(NodeValue::kTexture, QVariant::fromValue(v_plane)));
     job.Insert(QStringLiteral("bits_per_pixel"), NodeValue(NodeValue::kInt, bits_per_pixel));
     job.Insert(QStringLiteral("full_range"), NodeValue(NodeValue::kBoolean, hw_in->color_range == AVCOL_RANGE_JPEG));
+    job.Insert(QStringLiteral("interleaved_uv"), NodeValue(NodeValue::kBoolean, false));
+
+    const int *yuv_coeffs = sws_getCoefficients(FFmpegUtils::GetSwsColorspaceFromAVColorSpace(hw_in->colorspace));
+    job.Insert(QStringLiteral("yuv_crv"), NodeValue(NodeValue::kFloat, yuv_coeffs[0]/65536.0));
+    job.Insert(QStringLiteral("yuv_cgu"), NodeValue(NodeValue::kFloat, yuv_coeffs[2]/65536.0));
+    job.Insert(QStringLiteral("yuv_cgv"), NodeValue(NodeValue::kFloat, yuv_coeffs[3]/65536.0));
+    job.Insert(QStringLiteral("yuv_cbu"), NodeValue(NodeValue::kFloat, yuv_coeffs[1]/65536.0));
+
+    tex = p.renderer->CreateTexture(vp);
+    p.renderer->BlitToTexture(Yuv2RgbShader, job, tex.get(), false);
+    break;
+  }
+  case AV_PIX_FMT_NV12:
+  case AV_PIX_FMT_P010LE:
+  {
+    // Semi-planar YUV, which is what hardware decoders emit. Upload the Y plane and the
+    // interleaved UV plane directly and convert in the same shader as the planar formats,
+    // avoiding a full-frame CPU repack through libswscale
+    if (Yuv2RgbShader.isNull()) {
+      // Compile shader
+      Yuv2RgbShader = p.renderer->CreateNativeShader(ShaderCode(FileFunctions::ReadFileAsString(QStringLiteral(":/shaders/yuv2rgb.frag"))));
+      if (Yuv2RgbShader.isNull()) {
+        return nullptr;
+      }
+    }
+
+    int px_size = (f->format == AV_PIX_FMT_NV12) ? 1 : 2;
+
+    // P010 aligns its 10 bits to the top of each 16-bit sample, so sampled values are already
+    // full scale and the shader needs no bit-depth rescale
+    int bits_per_pixel = (f->format == AV_PIX_FMT_NV12) ? 8 : 16;
+
+    AVFrame *hw_in = f.get();
+
+    VideoParams plane_params = vp;
+    plane_params.set_channel_count(1);
+
+    TexturePtr y_plane = p.renderer->CreateTexture(plane_params, hw_in->data[0], hw_in->linesize[0] / px_size);
+
+    plane_params.set_width(plane_params.width()/2);
+    plane_params.set_height(plane_params.height()/2);
+    plane_params.set_channel_count(2);
+
+    TexturePtr uv_plane = p.renderer->CreateTexture(plane_params, hw_in->data[1], hw_in->linesize[1] / (px_size*2));
+
+    ShaderJob job;
+    job.Insert(QStringLiteral("y_channel"), NodeValue(NodeValue::kTexture, QVariant::fromValue(y_plane)));
+    job.Insert(QStringLiteral("u_channel"), NodeValue(NodeValue::kTexture, QVariant::fromValue(uv_plane)));
+    job.Insert(QStringLiteral("v_channel"), NodeValue(NodeValue::kTexture, QVariant::fromValue(uv_plane)));
+    job.Insert(QStringLiteral("bits_per_pixel"), NodeValue(NodeValue::kInt, bits_per_pixel));
+    job.Insert(QStringLiteral("full_range"), NodeValue(NodeValue::kBoolean, hw_in->color_range == AVCOL_RANGE_JPEG));
+    job.Insert(QStringLiteral("interleaved_uv"), NodeValue(NodeValue::kBoolean, true));
 
     const int *yuv_coeffs = sws_getCoefficients(FFmpegUtils::GetSwsColorspaceFromAVColorSpace(hw_in->colorspace));
     job.Insert(QStringLiteral("yuv_crv"), NodeValue(NodeValue::kFloat, yuv_coeffs[0]/65536.0));
@@ -240,6 +312,17 @@ TexturePtr FFmpegDecoder::RetrieveVideoInternal(const RetrieveVideoParams &p)
 
     AVFramePtr original = f;
 
+    if (p.time != kAnyTimecode) {
+      // Keep decoding ahead of this frame in the background so sequential playback finds its
+      // next frames already in the cache. Skipped when playing in reverse, where decoding
+      // forward would trim the GOP cache we're serving descending frames from
+      if (last_retrieved_ts_ == AV_NOPTS_VALUE || original->pts >= last_retrieved_ts_) {
+        StartPrefetch(original->pts);
+      }
+
+      last_retrieved_ts_ = original->pts;
+    }
+
     // Disregard "JPEG" pixel formats because we allow the user to override that
     f->format = FFmpegUtils::ConvertJPEGSpaceToRegularSpace(static_cast<AVPixelFormat>(f->format));
 
@@ -262,6 +345,11 @@ TexturePtr FFmpegDecoder::RetrieveVideoInternal(const RetrieveVideoParams &p)
 
 void FFmpegDecoder::CloseInternal()
 {
+  // Stop the prefetcher before tearing down anything it may be using. It only ever tryLocks the
+  // decoder mutex, so waiting here while our caller holds it cannot deadlock
+  prefetch_cancel_ = true;
+  prefetch_future_.waitForFinished();
+
   if (working_packet_) {
     av_packet_free(&working_packet_);
     working_packet_ = nullptr;
@@ -528,6 +616,12 @@ FootageDescription FFmpegDecoder::Probe(const QString &filename, CancelAtom *can
       }
     }
 
+    if (video_streams > 0) {
+      // One-time scan of the file's packets so later seeks can land exactly on a keyframe.
+      // Skipped entirely if the sidecars already exist from a previous probe.
+      BuildKeyframeIndex(fmt_ctx, filename, cancelled);
+    }
+
   }
 
   // Free all memory
@@ -536,6 +630,39 @@ FootageDescription FFmpegDecoder::Probe(const QString &filename, CancelAtom *can
   return desc;
 }
 
+bool FFmpegDecoder::PollDuration(const QString &filename, QHash<int, int64_t> &durations) const
+{
+  QByteArray filename_c = filename.toUtf8();
+
+  AVFormatContext* fmt_ctx = nullptr;
+  if (avformat_open_input(&fmt_ctx, filename_c, nullptr, nullptr) != 0) {
+    return false;
+  }
+
+  avformat_find_stream_info(fmt_ctx, nullptr);
+
+  for (unsigned int i=0; i<fmt_ctx->nb_streams; i++) {
+    AVStream* avstream = fmt_ctx->streams[i];
+
+    int64_t duration = avstream->duration;
+
+    if (duration == AV_NOPTS_VALUE && fmt_ctx->duration != AV_NOPTS_VALUE) {
+      // Fall back to the container duration like Probe() does. We deliberately don't do
+      // Probe()'s manual packet scan here - this runs repeatedly against a file that is still
+      // being written, so it has to stay cheap.
+      duration = Timecode::rescale_timestamp_ceil(fmt_ctx->duration, rational(1, AV_TIME_BASE), avstream->time_base);
+    }
+
+    if (duration != AV_NOPTS_VALUE && duration > 0) {
+      durations.insert(i, duration);
+    }
+  }
+
+  avformat_close_input(&fmt_ctx);
+
+  return !durations.isEmpty();
+}
+
 QString FFmpegDecoder::FFmpegError(int error_code)
 {
   char err[1024];
@@ -543,28 +670,251 @@ QString FFmpegDecoder::FFmpegError(int error_code)
   return QStringLiteral("%1 %2").arg(QString::number(error_code), err);
 }
 
+QString FFmpegDecoder::GetKeyframeIndexFilename(const QString &filename, int stream_index)
+{
+  QString index_fn = QStringLiteral("%1-%2.kfidx").arg(FileFunctions::GetUniqueFileIdentifier(filename),
+                                                       QString::number(stream_index));
+
+  return QDir(DiskManager::GetMediaIndexPath()).filePath(index_fn);
+}
+
+bool FFmpegDecoder::BuildKeyframeIndex(AVFormatContext *fmt_ctx, const QString &filename, CancelAtom *cancelled)
+{
+  // Determine which video streams still need an index
+  QHash<int, QString> needed;
+
+  for (unsigned int i=0; i<fmt_ctx->nb_streams; i++) {
+    AVStream *avstream = fmt_ctx->streams[i];
+
+    if (avstream->codecpar->codec_type == AVMEDIA_TYPE_VIDEO
+        && !(avstream->disposition & AV_DISPOSITION_ATTACHED_PIC)
+        && !QFileInfo::exists(GetKeyframeIndexFilename(filename, i))) {
+      needed.insert(i, GetKeyframeIndexFilename(filename, i));
+    }
+  }
+
+  if (needed.isEmpty()) {
+    return true;
+  }
+
+  QHash<int, QVector<QPair<qint64, qint64> > > entries;
+
+  AVPacket *pkt = av_packet_alloc();
+
+  while (av_read_frame(fmt_ctx, pkt) >= 0) {
+    if ((pkt->flags & AV_PKT_FLAG_KEY) && needed.contains(pkt->stream_index)) {
+      qint64 ts = (pkt->pts == AV_NOPTS_VALUE) ? pkt->dts : pkt->pts;
+      entries[pkt->stream_index].append(qMakePair(ts, qint64(pkt->pos)));
+    }
+
+    av_packet_unref(pkt);
+
+    if (cancelled && cancelled->IsCancelled()) {
+      av_packet_free(&pkt);
+      return false;
+    }
+  }
+
+  av_packet_free(&pkt);
+
+  for (auto it=needed.cbegin(); it!=needed.cend(); it++) {
+    QVector<QPair<qint64, qint64> > list = entries.value(it.key());
+
+    // Packets arrive in decode order, the index must be in presentation order
+    std::sort(list.begin(), list.end());
+
+    QFile f(it.value());
+    if (!f.open(QFile::WriteOnly)) {
+      qWarning() << "Failed to write keyframe index" << it.value();
+      continue;
+    }
+
+    QDataStream stream(&f);
+
+    stream << kKeyframeIndexMagic << kKeyframeIndexVersion << quint32(list.size());
+
+    typedef QPair<qint64, qint64> IndexEntry;
+    foreach (const IndexEntry &e, list) {
+      stream << e.first << e.second;
+    }
+  }
+
+  return true;
+}
+
 bool FFmpegDecoder::ConformAudioInternal(const QVector<QString> &filenames, const AudioParams &params, CancelAtom *cancelled)
+{
+  const int in_rate = instance_.avstream()->codecpar->sample_rate;
+
+  if (filenames.first().contains(QStringLiteral(".flac"))) {
+    // FLAC containers can't be byte-concatenated like raw PCM, so compressed conforms always
+    // take the single-pass path
+    return ConformAudioChunk(filenames, params, 0, -1, cancelled);
+  }
+
+  // Determine the length of the stream so it can be split into chunks
+  int64_t duration = instance_.avstream()->duration;
+  if (duration == 0 || duration == AV_NOPTS_VALUE) {
+    duration = instance_.fmt_ctx()->duration;
+    if (!(duration == 0 || duration == AV_NOPTS_VALUE)) {
+      // Rescale from AVFormatContext timebase to AVStream timebase
+      duration = av_rescale_q_rnd(duration, {1, AV_TIME_BASE}, instance_.avstream()->time_base, AV_ROUND_UP);
+    }
+  }
+
+  if (duration == 0 || duration == AV_NOPTS_VALUE) {
+    // Without a known duration we can't chunk, conform serially in a single pass
+    return ConformAudioChunk(filenames, params, 0, -1, cancelled);
+  }
+
+  int64_t total_samples = av_rescale_q(duration, instance_.avstream()->time_base, {1, in_rate});
+  int64_t chunk_samples = int64_t(kConformChunkLength) * in_rate;
+  int chunk_count = int((total_samples + chunk_samples - 1) / chunk_samples);
+
+  if (chunk_count <= 1) {
+    return ConformAudioChunk(filenames, params, 0, -1, cancelled);
+  }
+
+  auto chunk_filenames = [&filenames](int chunk, bool partial) {
+    QVector<QString> c = filenames;
+    for (int i=0; i<c.size(); i++) {
+      c[i].append(QStringLiteral(".chunk%1").arg(chunk));
+      if (partial) {
+        c[i].append(QStringLiteral(".part"));
+      }
+    }
+    return c;
+  };
+
+  // Skip chunks that still exist from an earlier interrupted conform - a chunk file is only
+  // ever renamed to its final name once it has been written completely
+  QVector<int> pending;
+  for (int i=0; i<chunk_count; i++) {
+    bool complete = true;
+
+    foreach (const QString &fn, chunk_filenames(i, false)) {
+      if (!QFileInfo::exists(fn)) {
+        complete = false;
+        break;
+      }
+    }
+
+    if (!complete) {
+      pending.append(i);
+    }
+  }
+
+  std::atomic_bool chunk_failed(false);
+  std::atomic_int chunks_done(chunk_count - pending.size());
+
+  QtConcurrent::blockingMap(pending, [&](int chunk) {
+    if (chunk_failed || (cancelled && cancelled->IsCancelled())) {
+      return;
+    }
+
+    int64_t chunk_start = int64_t(chunk) * chunk_samples;
+    int64_t chunk_end = qMin(total_samples, chunk_start + chunk_samples);
+
+    QVector<QString> part = chunk_filenames(chunk, true);
+
+    if (!ConformAudioChunk(part, params, chunk_start, chunk_end, cancelled)) {
+      foreach (const QString &fn, part) {
+        QFile::remove(fn);
+      }
+      chunk_failed = true;
+      return;
+    }
+
+    // Mark this chunk complete so a resumed conform can skip it
+    QVector<QString> done = chunk_filenames(chunk, false);
+    for (int i=0; i<part.size(); i++) {
+      QFile::remove(done.at(i));
+      QFile::rename(part.at(i), done.at(i));
+    }
+
+    chunks_done++;
+    SignalProcessingProgress(chunks_done.load() * duration / chunk_count, duration);
+  });
+
+  if (chunk_failed || (cancelled && cancelled->IsCancelled())) {
+    // Leave completed chunks in place, they're the resume record for the next attempt
+    return false;
+  }
+
+  // Concatenate the chunks into the conform files
+  for (int i=0; i<filenames.size(); i++) {
+    QFile out(filenames.at(i));
+    if (!out.open(QFile::WriteOnly)) {
+      qWarning() << "Failed to open WAVE output for indexing";
+      return false;
+    }
+
+    for (int chunk=0; chunk<chunk_count; chunk++) {
+      QFile in(chunk_filenames(chunk, false).at(i));
+      if (!in.open(QFile::ReadOnly)) {
+        qWarning() << "Failed to reopen conformed chunk" << in.fileName();
+        out.close();
+        return false;
+      }
+
+      while (!in.atEnd()) {
+        out.write(in.read(1 << 20));
+      }
+
+      in.close();
+    }
+
+    out.close();
+  }
+
+  // Chunks are no longer needed once the conform is assembled
+  for (int chunk=0; chunk<chunk_count; chunk++) {
+    foreach (const QString &fn, chunk_filenames(chunk, false)) {
+      QFile::remove(fn);
+    }
+  }
+
+  return true;
+}
+
+bool FFmpegDecoder::ConformAudioChunk(const QVector<QString> &filenames, const AudioParams &params, int64_t in_start, int64_t in_end, CancelAtom *cancelled)
 {
   // Iterate through each audio frame and extract the PCM data
 
-  // Seek to starting point
-  instance_.Seek(0);
+  // Open our own instance so chunks can run concurrently with each other and the main decoder
+  Instance instance;
+  QByteArray filename_bytes = stream().filename().toUtf8();
+  if (!instance.Open(filename_bytes.constData(), stream().stream())) {
+    qCritical() << "Failed to open audio stream for conform chunk";
+    return false;
+  }
 
   // Handle NULL channel layout
-  uint64_t channel_layout = ValidateChannelLayout(instance_.avstream());
+  uint64_t channel_layout = ValidateChannelLayout(instance.avstream());
   if (!channel_layout) {
     qCritical() << "Failed to determine channel layout of audio file, could not conform";
     return false;
   }
 
+  const AVSampleFormat in_fmt = static_cast<AVSampleFormat>(instance.avstream()->codecpar->format);
+  const int in_rate = instance.avstream()->codecpar->sample_rate;
+  const int in_channels = instance.avstream()->codecpar->channels;
+
+  // Seek to starting point
+  if (in_start > 0) {
+    instance.Seek(av_rescale_q(in_start, {1, in_rate}, instance.avstream()->time_base));
+  } else {
+    instance.Seek(0);
+  }
+
   // Create resampling context
   SwrContext* resampler = swr_alloc_set_opts(nullptr,
                                              params.channel_layout(),
                                              FFmpegUtils::GetFFmpegSampleFormat(params.format()),
                                              params.sample_rate(),
                                              channel_layout,
-                                             static_cast<AVSampleFormat>(instance_.avstream()->codecpar->format),
-                                             instance_.avstream()->codecpar->sample_rate,
+                                             in_fmt,
+                                             in_rate,
                                              0,
                                              nullptr);
 
@@ -576,28 +926,58 @@ bool FFmpegDecoder::ConformAudioInternal(const QVector<QString> &filenames, cons
 
   bool success = false;
 
-  int64_t duration = instance_.avstream()->duration;
+  int64_t duration = instance.avstream()->duration;
   if (duration == 0 || duration == AV_NOPTS_VALUE) {
-    duration = instance_.fmt_ctx()->duration;
+    duration = instance.fmt_ctx()->duration;
     if (!(duration == 0 || duration == AV_NOPTS_VALUE)) {
       // Rescale from AVFormatContext timebase to AVStream timebase
-      duration = av_rescale_q_rnd(duration, {1, AV_TIME_BASE}, instance_.avstream()->time_base, AV_ROUND_UP);
+      duration = av_rescale_q_rnd(duration, {1, AV_TIME_BASE}, instance.avstream()->time_base, AV_ROUND_UP);
     }
   }
 
-  PlanarFileDevice wave_out;
-  if (wave_out.open(filenames, QFile::WriteOnly)) {
-    int nb_channels = params.channel_count();
+  const int nb_channels = params.channel_count();
+
+  // When the range has a fixed end, this chunk must produce exactly this many bytes per channel
+  // so that independently conformed chunks concatenate sample-exactly
+  int64_t max_bytes_per_channel = -1;
+  if (in_end >= 0) {
+    int64_t out_samples = av_rescale(in_end, params.sample_rate(), in_rate)
+        - av_rescale(in_start, params.sample_rate(), in_rate);
+    max_bytes_per_channel = params.samples_to_bytes(out_samples) / nb_channels;
+  }
+  int64_t written_bytes_per_channel = 0;
+
+  const int bytes_per_in_sample = av_get_bytes_per_sample(in_fmt);
+  const bool in_is_planar = av_sample_fmt_is_planar(in_fmt);
+  const int in_plane_count = in_is_planar ? in_channels : 1;
+
+  // Conforms are raw PCM by default, or per-channel FLAC when compressed conforming is enabled
+  const bool compressed = filenames.first().contains(QStringLiteral(".flac"));
+
+  PlanarFileDevice pcm_out;
+  FlacAudioDevice flac_out;
+
+  auto write_planes = [&compressed, &pcm_out, &flac_out](const char **planes, qint64 bytes_per_channel) {
+    if (compressed) {
+      flac_out.write(planes, bytes_per_channel);
+    } else {
+      pcm_out.write(planes, bytes_per_channel);
+    }
+  };
+
+  if (compressed ? flac_out.open(filenames, params, QFile::WriteOnly) : pcm_out.open(filenames, QFile::WriteOnly)) {
     SampleBuffer data;
     data.set_audio_params(params);
 
-    while (true) {
+    bool reached_end = false;
+
+    while (!reached_end) {
       // Check if we have a `cancelled` ptr and its value
       if (cancelled && cancelled->IsCancelled()) {
         break;
       }
 
-      ret = instance_.GetFrame(pkt, frame);
+      ret = instance.GetFrame(pkt, frame);
 
       if (ret < 0) {
 
@@ -612,8 +992,39 @@ bool FFmpegDecoder::ConformAudioInternal(const QVector<QString> &filenames, cons
 
       }
 
+      // Determine where this frame sits in the stream and clip it to the chunk bounds
+      int64_t frame_first_sample = av_rescale_q(frame->best_effort_timestamp, instance.avstream()->time_base, {1, in_rate});
+      int64_t clip_front = 0;
+      int in_samples = frame->nb_samples;
+
+      if (frame_first_sample + in_samples <= in_start) {
+        // Frame is entirely before the chunk (e.g. from keyframe seeking)
+        continue;
+      }
+
+      if (frame_first_sample < in_start) {
+        clip_front = in_start - frame_first_sample;
+        in_samples -= clip_front;
+      }
+
+      if (in_end >= 0 && frame_first_sample + frame->nb_samples >= in_end) {
+        in_samples -= int((frame_first_sample + frame->nb_samples) - in_end);
+        reached_end = true;
+        success = true;
+
+        if (in_samples <= 0) {
+          break;
+        }
+      }
+
+      // Offset the plane pointers past any samples clipped from the front
+      QVector<const uint8_t*> in_planes(in_plane_count);
+      for (int i=0; i<in_plane_count; i++) {
+        in_planes[i] = frame->extended_data[i] + clip_front * bytes_per_in_sample * (in_is_planar ? 1 : in_channels);
+      }
+
       // Allocate buffers
-      int nb_samples = swr_get_out_samples(resampler, frame->nb_samples);
+      int nb_samples = swr_get_out_samples(resampler, in_samples);
       int nb_bytes_per_channel = params.samples_to_bytes(nb_samples) / nb_channels;
       data.set_sample_count(nb_bytes_per_channel);
       data.allocate();
@@ -622,16 +1033,24 @@ bool FFmpegDecoder::ConformAudioInternal(const QVector<QString> &filenames, cons
       nb_samples = swr_convert(resampler,
                                reinterpret_cast<uint8_t**>(data.to_raw_ptrs().data()),
                                nb_samples,
-                               const_cast<const uint8_t**>(frame->data),
-                               frame->nb_samples);
+                               in_planes.data(),
+                               in_samples);
 
       // If no error, write to files
       if (nb_samples > 0) {
         // Update byte count for the number of samples we actually received
         nb_bytes_per_channel = params.samples_to_bytes(nb_samples) / nb_channels;
 
+        // Never write past the chunk's expected size
+        if (max_bytes_per_channel >= 0) {
+          nb_bytes_per_channel = int(qMin(int64_t(nb_bytes_per_channel), max_bytes_per_channel - written_bytes_per_channel));
+        }
+
         // Write to files
-        wave_out.write(const_cast<const char**>(reinterpret_cast<char**>(data.to_raw_ptrs().data())), nb_bytes_per_channel);
+        if (nb_bytes_per_channel > 0) {
+          write_planes(const_cast<const char**>(reinterpret_cast<char**>(data.to_raw_ptrs().data())), nb_bytes_per_channel);
+          written_bytes_per_channel += nb_bytes_per_channel;
+        }
       }
 
       // Free buffer
@@ -642,13 +1061,29 @@ bool FFmpegDecoder::ConformAudioInternal(const QVector<QString> &filenames, cons
         char err_str[512];
         av_strerror(nb_samples, err_str, 512);
         qWarning() << "libswresample failed with error:" << nb_samples << err_str;
+        success = false;
         break;
       }
 
-      SignalProcessingProgress(frame->best_effort_timestamp, duration);
+      if (in_end < 0) {
+        // Whole-file conform, report progress per frame (chunked conforms report per chunk)
+        SignalProcessingProgress(frame->best_effort_timestamp, duration);
+      }
+    }
+
+    // Resampler delay and seek imprecision can leave a bounded chunk a few samples short - pad
+    // with silence so the chunks still concatenate sample-exactly
+    if (success && max_bytes_per_channel >= 0 && written_bytes_per_channel < max_bytes_per_channel) {
+      QByteArray silence(int(max_bytes_per_channel - written_bytes_per_channel), 0);
+      QVector<const char*> silence_planes(nb_channels, silence.constData());
+      write_planes(silence_planes.data(), silence.size());
     }
 
-    wave_out.close();
+    if (compressed) {
+      flac_out.close();
+    } else {
+      pcm_out.close();
+    }
   } else {
     qWarning() << "Failed to open WAVE output for indexing";
   }
@@ -721,6 +1156,8 @@ bool FFmpegDecoder::IsPixelFormatGLSLCompatible(AVPixelFormat f)
   case AV_PIX_FMT_YUV420P12LE:
   case AV_PIX_FMT_YUV422P12LE:
   case AV_PIX_FMT_YUV444P12LE:
+  case AV_PIX_FMT_NV12:
+  case AV_PIX_FMT_P010LE:
   case AV_PIX_FMT_RGBA:
   case AV_PIX_FMT_RGBA64LE:
     return true;
@@ -750,7 +1187,15 @@ AVFramePtr FFmpegDecoder::PreProcessFrame(AVFramePtr f, const RetrieveVideoParam
     return f;
   }
 
+  if (p.cancelled && p.cancelled->IsCancelled()) {
+    // Don't bother allocating and converting a frame nobody wants anymore
+    return nullptr;
+  }
+
   // Some scaling and/or format conversion needs to be done
+  QElapsedTimer conversion_timer;
+  conversion_timer.start();
+
   AVFramePtr dest = CreateAVFramePtr();
 
   dest->width = f->width;
@@ -817,12 +1262,54 @@ AVFramePtr FFmpegDecoder::PreProcessFrame(AVFramePtr f, const RetrieveVideoParam
                              0, 0x10000, 0x10000);
   }
 
-  r = sws_scale(sws_ctx_, f->data, f->linesize, 0, f->height, dest->data, dest->linesize);
-  if (r < 0) {
-    FFmpegError(r);
-    return nullptr;
+  const AVPixFmtDescriptor *pixdesc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(f->format));
+
+  // A full-frame sws_scale run can take a substantial fraction of the frame time at high
+  // resolutions, so when the caller can cancel us, scale in horizontal bands and poll between
+  // them - a cancelled scrub ticket then releases its render thread within a band rather than
+  // finishing the whole conversion. sws_scale supports sequential top-to-bottom slices, and
+  // SWS_POINT samples no rows outside the slice. Paletted formats keep their palette in
+  // data[1], which must not be offset per-band, so they take the single-call path.
+  static const int kScaleBandHeight = 256;
+
+  if (p.cancelled && f->height > kScaleBandHeight && !(pixdesc->flags & AV_PIX_FMT_FLAG_PAL)) {
+    int src_y = 0;
+
+    while (src_y < f->height) {
+      if (p.cancelled->IsCancelled()) {
+        return nullptr;
+      }
+
+      int band = std::min(kScaleBandHeight, f->height - src_y);
+
+      const uint8_t *src_planes[AV_NUM_DATA_POINTERS];
+      for (int i=0; i<AV_NUM_DATA_POINTERS; i++) {
+        if (f->data[i]) {
+          int vshift = (i == 1 || i == 2) ? pixdesc->log2_chroma_h : 0;
+          src_planes[i] = f->data[i] + (src_y >> vshift) * f->linesize[i];
+        } else {
+          src_planes[i] = nullptr;
+        }
+      }
+
+      r = sws_scale(sws_ctx_, src_planes, f->linesize, src_y, band, dest->data, dest->linesize);
+      if (r < 0) {
+        FFmpegError(r);
+        return nullptr;
+      }
+
+      src_y += band;
+    }
+  } else {
+    r = sws_scale(sws_ctx_, f->data, f->linesize, 0, f->height, dest->data, dest->linesize);
+    if (r < 0) {
+      FFmpegError(r);
+      return nullptr;
+    }
   }
 
+  ReportConversionTime(conversion_timer.elapsed());
+
   return dest;
 }
 
@@ -838,13 +1325,30 @@ AVFramePtr FFmpegDecoder::RetrieveFrame(const rational& time, CancelAtom *cancel
   int64_t seek_ts = std::max(min_seek, target_ts - MaximumQueueSize());
   bool still_seeking = false;
 
+  int64_t reverse_stop_ts = AV_NOPTS_VALUE;
+
   if (time != kAnyTimecode) {
+    // Detect reverse playback: the request is just below our cache, so decode the entire GOP
+    // beneath it once and serve the coming requests from cache in descending order instead of
+    // re-seeking and re-decoding for every frame
+    if (!cached_frames_.empty()
+        && !cache_at_zero_
+        && target_ts < cached_frames_.front()->pts
+        && target_ts >= cached_frames_.front()->pts - 2*second_ts_) {
+      reverse_stop_ts = cached_frames_.front()->pts;
+    }
+
     // If the frame wasn't in the frame cache, see if this frame cache is too old to use
     if (cached_frames_.empty()
+        || reverse_stop_ts != AV_NOPTS_VALUE
         || (target_ts < cached_frames_.front()->pts || target_ts > cached_frames_.back()->pts + 2*second_ts_)) {
       ClearFrameCache();
+      ReportFrameCacheResult(false);
 
+      QElapsedTimer seek_timer;
+      seek_timer.start();
       instance_.Seek(seek_ts);
+      ReportSeek(seek_timer.elapsed());
       if (seek_ts == min_seek) {
         cache_at_zero_ = true;
       }
@@ -854,8 +1358,12 @@ AVFramePtr FFmpegDecoder::RetrieveFrame(const rational& time, CancelAtom *cancel
       // Search cache for frame
       AVFramePtr cached_frame = GetFrameFromCache(target_ts);
       if (cached_frame) {
+        ReportFrameCacheResult(true);
         return cached_frame;
       }
+
+      // Close enough to decode forward from the current cache, but still not a hit
+      ReportFrameCacheResult(false);
     }
   }
 
@@ -892,7 +1400,10 @@ AVFramePtr FFmpegDecoder::RetrieveFrame(const rational& time, CancelAtom *cancel
       if (!cache_at_zero_ && (ret == AVERROR_EOF || filtered->best_effort_timestamp > target_ts)) {
 
         seek_ts = qMax(min_seek, seek_ts - second_ts_);
+        QElapsedTimer seek_timer;
+        seek_timer.start();
         instance_.Seek(seek_ts);
+        ReportSeek(seek_timer.elapsed());
         if (seek_ts == min_seek) {
           cache_at_zero_ = true;
         }
@@ -912,6 +1423,8 @@ AVFramePtr FFmpegDecoder::RetrieveFrame(const rational& time, CancelAtom *cancel
 
       if (cached_frames_.empty()) {
         qCritical() << "Unexpected codec EOF - unable to retrieve frame";
+      } else if (reverse_stop_ts != AV_NOPTS_VALUE) {
+        return_frame = GetFrameFromCache(target_ts);
       } else {
         return_frame = cached_frames_.back();
       }
@@ -920,8 +1433,10 @@ AVFramePtr FFmpegDecoder::RetrieveFrame(const rational& time, CancelAtom *cancel
 
     } else {
 
-      // Cut down to thread count - 1 before we acquire a new frame
-      if (cached_frames_.size() > size_t(MaximumQueueSize())) {
+      // Cut down to thread count - 1 before we acquire a new frame. In reverse mode the queue
+      // must be able to hold the whole GOP we're filling
+      size_t queue_limit = (reverse_stop_ts != AV_NOPTS_VALUE) ? size_t(ReverseQueueSize()) : size_t(MaximumQueueSize());
+      if (cached_frames_.size() > queue_limit) {
         RemoveFirstFrame();
       }
 
@@ -935,6 +1450,19 @@ AVFramePtr FFmpegDecoder::RetrieveFrame(const rational& time, CancelAtom *cancel
 
       // Append this frame and signal to other threads that a new frame has arrived
       cached_frames_.push_back(filtered);
+      ReportFrameDecoded();
+
+      if (reverse_stop_ts != AV_NOPTS_VALUE) {
+        // Keep decoding until we've rebuilt the GOP up to where the cache previously began,
+        // then serve the requested frame (and the following reverse requests) from it
+        if (filtered->pts >= reverse_stop_ts) {
+          return_frame = GetFrameFromCache(target_ts);
+          break;
+        }
+
+        filtered = nullptr;
+        continue;
+      }
 
       // If this is a valid frame, see if this or the frame before it are the one we need
       if (filtered->pts == target_ts || time == kAnyTimecode) {
@@ -1017,11 +1545,90 @@ int FFmpegDecoder::MaximumQueueSize()
   return 2;
 }
 
+int FFmpegDecoder::ReverseQueueSize()
+{
+  // Large enough for the GOPs of common long-GOP codecs (H.264/HEVC web and camera files tend
+  // to sit well below this), small enough that a queue of full-size frames stays bounded. GOPs
+  // longer than this degrade to the old seek-per-frame behavior rather than exhausting memory.
+  return 64;
+}
+
+int FFmpegDecoder::PrefetchDepth()
+{
+  // Enough to cover a render tick's worth of decode latency without holding many large frames
+  // in memory per decoder
+  return 4;
+}
+
+void FFmpegDecoder::StartPrefetch(int64_t target_ts)
+{
+  prefetch_target_ts_ = target_ts;
+
+  if (!prefetch_future_.isRunning()) {
+    prefetch_cancel_ = false;
+    prefetch_future_ = QtConcurrent::run([this]{ PrefetchTask(); });
+  }
+}
+
+void FFmpegDecoder::PrefetchTask()
+{
+  while (!prefetch_cancel_) {
+    // Only tryLock here - a blocking lock could deadlock against CloseInternal, which waits for
+    // this task while our caller holds the decoder mutex
+    if (!mutex()->tryLock(10)) {
+      continue;
+    }
+
+    bool done = true;
+
+    if (instance_.IsOpen() && !cache_at_eof_ && !cached_frames_.empty()) {
+      // Count how many frames are already decoded past the last requested timestamp
+      int64_t target = prefetch_target_ts_;
+      int ahead = 0;
+      for (auto it=cached_frames_.crbegin(); it!=cached_frames_.crend() && (*it)->pts > target; it++) {
+        ahead++;
+      }
+
+      if (ahead < PrefetchDepth()) {
+        // Decode exactly one frame per lock acquisition so a render thread arriving with a
+        // request waits at most one decode
+        AVFramePtr f = CreateAVFramePtr();
+        int ret = instance_.GetFrame(working_packet_, f.get());
+        av_packet_unref(working_packet_);
+
+        if (ret == AVERROR_EOF) {
+          cache_at_eof_ = true;
+        } else if (ret >= 0) {
+          cached_frames_.push_back(f);
+          ReportFrameDecoded();
+
+          // Allow the cache to grow by the prefetch depth, but never trim the frames a render
+          // thread may still come back for
+          while (cached_frames_.size() > size_t(MaximumQueueSize() + PrefetchDepth())) {
+            RemoveFirstFrame();
+          }
+
+          done = false;
+        }
+      }
+    }
+
+    mutex()->unlock();
+
+    if (done) {
+      break;
+    }
+  }
+}
+
 FFmpegDecoder::Instance::Instance() :
   fmt_ctx_(nullptr),
   codec_ctx_(nullptr),
   avstream_(nullptr),
-  opts_(nullptr)
+  opts_(nullptr),
+  hw_device_ctx_(nullptr),
+  hw_pix_fmt_(AV_PIX_FMT_NONE),
+  keyframe_index_loaded_(false)
 {
 }
 
@@ -1076,16 +1683,42 @@ bool FFmpegDecoder::Instance::Open(const char *filename, int stream_index)
     return false;
   }
 
-  // Set multithreading setting
-  error_code = av_dict_set(&opts_, "threads", "auto", 0);
+  if (avstream_->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+    keyframe_index_filename_ = GetKeyframeIndexFilename(QString::fromUtf8(filename), stream_index);
+  }
 
-  // Handle failure to set multithreaded decoding
-  if (error_code < 0) {
-    qCritical() << "Failed to set codec options, performance may suffer";
+  // Try to attach a hardware decoder for video streams. Long-GOP camera originals (H.264/H.265)
+  // are by far our most expensive decodes, and failure here simply leaves us on the software path
+  if (avstream_->codecpar->codec_type == AVMEDIA_TYPE_VIDEO
+      && Config::Cached().hardware_decoding) {
+    OpenHardwareContext(codec);
   }
 
+  // Set multithreading settings for this codec
+  SetupThreading(codec, filename);
+
   // Open codec
   error_code = avcodec_open2(codec_ctx_, codec, &opts_);
+
+  if (error_code < 0 && hw_device_ctx_) {
+    // Hardware open failed, rebuild the context and retry in software
+    qWarning() << "Failed to open hardware decoder, falling back to software:" << FFmpegError(error_code);
+
+    avcodec_free_context(&codec_ctx_);
+    av_buffer_unref(&hw_device_ctx_);
+    hw_pix_fmt_ = AV_PIX_FMT_NONE;
+
+    codec_ctx_ = avcodec_alloc_context3(codec);
+    if (codec_ctx_ == nullptr
+        || avcodec_parameters_to_context(codec_ctx_, avstream_->codecpar) < 0) {
+      qCritical() << "Failed to allocate codec context";
+      return false;
+    }
+
+    SetupThreading(codec, filename);
+    error_code = avcodec_open2(codec_ctx_, codec, &opts_);
+  }
+
   if (error_code < 0) {
     char buf[512];
     av_strerror(error_code, buf, 512);
@@ -1096,6 +1729,96 @@ bool FFmpegDecoder::Instance::Open(const char *filename, int stream_index)
   return true;
 }
 
+void FFmpegDecoder::Instance::SetupThreading(const AVCodec *codec, const char *filename)
+{
+  const char *threads = "auto";
+
+  const AVCodecDescriptor *desc = avcodec_descriptor_get(codec->id);
+
+  if (avstream_->codecpar->codec_type == AVMEDIA_TYPE_VIDEO && desc) {
+    if (desc->props & AV_CODEC_PROP_INTRA_ONLY) {
+      // Every frame is independent, so slice threading uses all cores within a single frame
+      // with no pipeline delay - frame threading would only add per-frame latency and memory
+      codec_ctx_->thread_type = FF_THREAD_SLICE;
+    } else if (!hw_device_ctx_) {
+      // Long-GOP software decode: frame threading is needed for playback throughput, but it
+      // delays the first frame after every seek by roughly one frame per thread. If this
+      // file's accumulated counters show scrub-dominated access, cap the pipeline depth to
+      // keep seek-to-frame latency low - the cap only costs throughput on a file that isn't
+      // being played linearly anyway
+      Statistics stats = GetStatistics(QString::fromUtf8(filename));
+
+      const qint64 kMinSeeksForProfile = 16;
+      const qint64 kScrubFramesPerSeek = 8;
+
+      if (stats.seek_count >= kMinSeeksForProfile
+          && stats.frames_decoded / stats.seek_count < kScrubFramesPerSeek) {
+        threads = "2";
+      }
+    }
+  }
+
+  int error_code = av_dict_set(&opts_, "threads", threads, 0);
+
+  // Handle failure to set multithreaded decoding
+  if (error_code < 0) {
+    qCritical() << "Failed to set codec options, performance may suffer";
+  }
+}
+
+bool FFmpegDecoder::Instance::OpenHardwareContext(const AVCodec *codec)
+{
+  for (int i=0; ; i++) {
+    const AVCodecHWConfig *config = avcodec_get_hw_config(codec, i);
+
+    if (!config) {
+      break;
+    }
+
+    if (!(config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX)) {
+      continue;
+    }
+
+    // Attempt to create this device - drivers that aren't present on this machine will simply
+    // fail here and we move on to the next type the codec supports
+    AVBufferRef *device = nullptr;
+    if (av_hwdevice_ctx_create(&device, config->device_type, nullptr, nullptr, 0) < 0) {
+      continue;
+    }
+
+    hw_device_ctx_ = device;
+    hw_pix_fmt_ = config->pix_fmt;
+
+    codec_ctx_->hw_device_ctx = av_buffer_ref(hw_device_ctx_);
+    codec_ctx_->opaque = this;
+    codec_ctx_->get_format = GetHardwareFormat;
+
+    qDebug() << "Using hardware decoder" << av_hwdevice_get_type_name(config->device_type)
+             << "for" << codec->name;
+
+    return true;
+  }
+
+  return false;
+}
+
+AVPixelFormat FFmpegDecoder::Instance::GetHardwareFormat(AVCodecContext *ctx, const AVPixelFormat *pix_fmts)
+{
+  Instance *instance = static_cast<Instance*>(ctx->opaque);
+
+  for (const AVPixelFormat *fmt = pix_fmts; *fmt != AV_PIX_FMT_NONE; fmt++) {
+    if (*fmt == instance->hw_pix_fmt_) {
+      return *fmt;
+    }
+  }
+
+  // Decoder no longer offers our hardware format (e.g. mid-stream parameter change), fall back
+  // to the first offered format which is always decodable in software
+  qWarning() << "Hardware pixel format no longer available, falling back to software decoding";
+  instance->hw_pix_fmt_ = AV_PIX_FMT_NONE;
+  return pix_fmts[0];
+}
+
 void FFmpegDecoder::Instance::Close()
 {
   if (opts_) {
@@ -1108,10 +1831,19 @@ void FFmpegDecoder::Instance::Close()
     codec_ctx_ = nullptr;
   }
 
+  if (hw_device_ctx_) {
+    av_buffer_unref(&hw_device_ctx_);
+    hw_pix_fmt_ = AV_PIX_FMT_NONE;
+  }
+
   if (fmt_ctx_) {
     avformat_close_input(&fmt_ctx_);
     fmt_ctx_ = nullptr;
   }
+
+  keyframe_index_filename_.clear();
+  keyframe_index_.clear();
+  keyframe_index_loaded_ = false;
 }
 
 int FFmpegDecoder::Instance::GetFrame(AVPacket *pkt, AVFrame *frame)
@@ -1150,6 +1882,24 @@ int FFmpegDecoder::Instance::GetFrame(AVPacket *pkt, AVFrame *frame)
     }
   }
 
+  if (ret >= 0 && hw_pix_fmt_ != AV_PIX_FMT_NONE && frame->format == hw_pix_fmt_) {
+    // Frame is in GPU memory, transfer it to system memory so the existing conversion and
+    // upload path can use it
+    AVFrame *sw_frame = av_frame_alloc();
+
+    ret = av_hwframe_transfer_data(sw_frame, frame, 0);
+
+    if (ret >= 0) {
+      av_frame_copy_props(sw_frame, frame);
+      av_frame_unref(frame);
+      av_frame_move_ref(frame, sw_frame);
+    } else {
+      qCritical() << "Failed to transfer hardware frame to system memory:" << FFmpegError(ret);
+    }
+
+    av_frame_free(&sw_frame);
+  }
+
   return ret;
 }
 
@@ -1189,7 +1939,66 @@ int FFmpegDecoder::Instance::GetPacket(AVPacket *pkt)
 void FFmpegDecoder::Instance::Seek(int64_t timestamp)
 {
   avcodec_flush_buffers(codec_ctx_);
+
+  if (!keyframe_index_loaded_ && !keyframe_index_filename_.isEmpty()) {
+    LoadKeyframeIndex();
+  }
+
+  if (!keyframe_index_.empty()) {
+    // Find the last keyframe at or before this timestamp so the demuxer lands exactly on a
+    // decodable frame instead of guessing from the container's (sometimes absent) index
+    auto it = std::upper_bound(keyframe_index_.begin(), keyframe_index_.end(), timestamp,
+                               [](int64_t t, const std::pair<int64_t, int64_t> &e){ return t < e.first; });
+
+    if (it != keyframe_index_.begin()) {
+      it--;
+
+      if (av_seek_frame(fmt_ctx_, avstream_->index, it->first, AVSEEK_FLAG_BACKWARD) >= 0) {
+        return;
+      }
+
+      // PTS seek failed, try the recorded byte offset directly
+      if (av_seek_frame(fmt_ctx_, -1, it->second, AVSEEK_FLAG_BYTE) >= 0) {
+        return;
+      }
+    }
+  }
+
   av_seek_frame(fmt_ctx_, avstream_->index, timestamp, AVSEEK_FLAG_BACKWARD);
 }
 
+void FFmpegDecoder::Instance::LoadKeyframeIndex()
+{
+  keyframe_index_loaded_ = true;
+
+  QFile f(keyframe_index_filename_);
+  if (!f.open(QFile::ReadOnly)) {
+    return;
+  }
+
+  QDataStream stream(&f);
+
+  quint32 magic = 0, version = 0, count = 0;
+  stream >> magic >> version >> count;
+
+  if (magic != kKeyframeIndexMagic || version != kKeyframeIndexVersion) {
+    return;
+  }
+
+  keyframe_index_.reserve(count);
+
+  for (quint32 i=0; i<count; i++) {
+    qint64 pts, pos;
+    stream >> pts >> pos;
+
+    if (stream.status() != QDataStream::Ok) {
+      // Truncated file, don't trust it
+      keyframe_index_.clear();
+      return;
+    }
+
+    keyframe_index_.push_back({pts, pos});
+  }
+}
+
 }
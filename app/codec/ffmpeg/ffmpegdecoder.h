@@ -32,6 +32,7 @@ extern "C" {
 #include <libswresample/swresample.h>
 }
 
+#include <QFuture>
 #include <QTimer>
 #include <QVector>
 #include <QWaitCondition>
@@ -61,6 +62,8 @@ public:
 
   virtual FootageDescription Probe(const QString &filename, CancelAtom *cancelled) const override;
 
+  virtual bool PollDuration(const QString &filename, QHash<int, int64_t> &durations) const override;
+
 protected:
   virtual bool OpenInternal() override;
   virtual TexturePtr RetrieveVideoInternal(const RetrieveVideoParams& p) override;
@@ -117,10 +120,44 @@ private:
     }
 
   private:
+    /**
+     * @brief Try to attach a hardware decoding device (NVDEC, VAAPI, VideoToolbox, etc.)
+     *
+     * Iterates the hardware configurations the codec supports and attaches the first device
+     * that can actually be created on this machine. Returns false if none could, in which
+     * case decoding proceeds in software.
+     */
+    bool OpenHardwareContext(const AVCodec *codec);
+
+    static AVPixelFormat GetHardwareFormat(AVCodecContext *ctx, const AVPixelFormat *pix_fmts);
+
+    /**
+     * @brief Load the keyframe index sidecar built at probe time, if one exists
+     */
+    void LoadKeyframeIndex();
+
+    /**
+     * @brief Choose a threading profile for this codec instead of a blanket "threads auto"
+     *
+     * Intra-only codecs (ProRes, DNxHD, MJPEG, ...) get slice threading, which parallelizes
+     * within each frame with no pipeline delay. Long-GOP codecs need frame threading for
+     * playback throughput, but that delays the first frame after every seek by one frame per
+     * thread - so if this file's accumulated statistics show scrub-dominated access (many
+     * seeks per frame decoded), the thread count is capped to keep seek-to-frame latency low.
+     * Decoder instances are transient, so the profile re-evaluates as usage patterns change.
+     */
+    void SetupThreading(const AVCodec *codec, const char *filename);
+
     AVFormatContext* fmt_ctx_;
     AVCodecContext* codec_ctx_;
     AVStream* avstream_;
     AVDictionary* opts_;
+    AVBufferRef* hw_device_ctx_;
+    AVPixelFormat hw_pix_fmt_;
+
+    QString keyframe_index_filename_;
+    bool keyframe_index_loaded_;
+    std::vector<std::pair<int64_t, int64_t> > keyframe_index_;
 
   };
 
@@ -134,6 +171,29 @@ private:
    */
   static QString FFmpegError(int error_code);
 
+  /**
+   * @brief Sidecar path for a stream's keyframe index (keyframe PTS -> byte offset)
+   */
+  static QString GetKeyframeIndexFilename(const QString &filename, int stream_index);
+
+  /**
+   * @brief Scan a file's packets once and persist a keyframe index per video stream
+   *
+   * Demux-only, so this runs at roughly disk read speed. Streams whose sidecar already exists
+   * are skipped, and nothing is written if the scan is cancelled partway.
+   */
+  static bool BuildKeyframeIndex(AVFormatContext *fmt_ctx, const QString &filename, CancelAtom *cancelled);
+
+  /**
+   * @brief Conform a range of the audio stream to a set of per-channel PCM files
+   *
+   * Decodes source samples [in_start, in_end) (an in_end of -1 means until EOF) using its own
+   * demuxer/decoder instance, so several chunks can be conformed in parallel. When the range has
+   * a fixed end, the output is clipped and padded to exactly the expected number of output
+   * samples so independently written chunks concatenate without drift.
+   */
+  bool ConformAudioChunk(const QVector<QString> &filenames, const AudioParams &params, int64_t in_start, int64_t in_end, CancelAtom *cancelled);
+
   void FreeScaler();
 
   static PixelFormat GetNativePixelFormat(AVPixelFormat pix_fmt);
@@ -159,6 +219,27 @@ private:
 
   static int MaximumQueueSize();
 
+  /**
+   * @brief Queue limit while filling a GOP for reverse playback
+   *
+   * Must be able to hold every frame between two keyframes so reverse playback can serve a
+   * whole GOP from cache. Bounded so pathologically long GOPs don't exhaust memory - beyond
+   * this, reverse playback falls back to re-seeking.
+   */
+  static int ReverseQueueSize();
+
+  /**
+   * @brief Number of frames the background prefetcher decodes ahead of the last request
+   */
+  static int PrefetchDepth();
+
+  /**
+   * @brief (Re)start the decode-ahead prefetcher aiming past this timestamp
+   */
+  void StartPrefetch(int64_t target_ts);
+
+  void PrefetchTask();
+
   SwsContext *sws_ctx_;
   int sws_src_width_;
   int sws_src_height_;
@@ -180,6 +261,11 @@ private:
 
   Instance instance_;
 
+  QFuture<void> prefetch_future_;
+  std::atomic_bool prefetch_cancel_;
+  std::atomic_int64_t prefetch_target_ts_;
+  int64_t last_retrieved_ts_;
+
 };
 
 }
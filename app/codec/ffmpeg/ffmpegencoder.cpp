@@ -40,6 +40,8 @@ FFmpegEncoder::FFmpegEncoder(const EncodingParams &params) :
   video_scale_ctx_(nullptr),
   video_buffersrc_ctx_(nullptr),
   video_buffersink_ctx_(nullptr),
+  video_hw_device_ctx_(nullptr),
+  video_upload_fmt_(AV_PIX_FMT_NONE),
   audio_stream_(nullptr),
   audio_codec_ctx_(nullptr),
   audio_resample_ctx_(nullptr),
@@ -149,6 +151,12 @@ bool FFmpegEncoder::Open()
     // This is the pixel format the encoder wants to encode to
     AVPixelFormat encoder_pix_fmt = video_codec_ctx_->pix_fmt;
 
+    if (video_upload_fmt_ != AV_PIX_FMT_NONE) {
+      // The encoder only takes hardware surfaces - the filter graph should produce the format
+      // we upload to those surfaces instead
+      encoder_pix_fmt = video_upload_fmt_;
+    }
+
     video_scale_ctx_ = avfilter_graph_alloc();
     if (!video_scale_ctx_) {
       return false;
@@ -238,6 +246,14 @@ bool FFmpegEncoder::Open()
   return true;
 }
 
+// Free callback for AVBuffers wrapping a Frame's memory: drops the reference that kept the
+// frame (and its pooled buffer) alive while FFmpeg was using it
+static void ReleaseWrappedFrame(void *opaque, uint8_t *data)
+{
+  Q_UNUSED(data)
+  delete static_cast<FramePtr*>(opaque);
+}
+
 bool FFmpegEncoder::WriteFrame(FramePtr frame, rational time)
 {
   // We may need to convert this frame to a frame that swscale will understand
@@ -253,6 +269,19 @@ bool FFmpegEncoder::WriteFrame(FramePtr frame, rational time)
   input_frame->data[0] = reinterpret_cast<uint8_t*>(frame->data());
   input_frame->linesize[0] = frame->linesize_bytes();
 
+  // Wrap the frame's memory in a refcounted buffer so the filter graph refs it instead of
+  // copying it. The buffer holds a reference to the frame, keeping its pooled memory valid for
+  // as long as FFmpeg needs it.
+  input_frame->buf[0] = av_buffer_create(reinterpret_cast<uint8_t*>(frame->data()),
+                                         frame->allocated_size(),
+                                         ReleaseWrappedFrame,
+                                         new FramePtr(frame),
+                                         AV_BUFFER_FLAG_READONLY);
+  if (!input_frame->buf[0]) {
+    SetError(tr("Failed to wrap frame buffer"));
+    return false;
+  }
+
   input_frame->color_primaries = video_codec_ctx_->color_primaries;
   input_frame->color_trc = video_codec_ctx_->color_trc;
   input_frame->colorspace = video_codec_ctx_->colorspace;
@@ -274,6 +303,27 @@ bool FFmpegEncoder::WriteFrame(FramePtr frame, rational time)
 
   encoded_frame->pts = qRound64(time.toDouble() / av_q2d(video_codec_ctx_->time_base));
 
+  if (video_codec_ctx_->hw_frames_ctx) {
+    // Upload the frame to a hardware surface before sending it to the encoder
+    AVFramePtr hw_frame = CreateAVFramePtr(av_frame_alloc());
+
+    r = av_hwframe_get_buffer(video_codec_ctx_->hw_frames_ctx, hw_frame.get(), 0);
+    if (r < 0) {
+      FFmpegError(tr("Failed to allocate hardware frame"), r);
+      return false;
+    }
+
+    r = av_hwframe_transfer_data(hw_frame.get(), encoded_frame.get(), 0);
+    if (r < 0) {
+      FFmpegError(tr("Failed to upload frame to hardware device"), r);
+      return false;
+    }
+
+    hw_frame->pts = encoded_frame->pts;
+
+    return WriteAVFrame(hw_frame.get(), video_codec_ctx_, video_stream_);
+  }
+
   return WriteAVFrame(encoded_frame.get(), video_codec_ctx_, video_stream_);
 }
 
@@ -527,6 +577,11 @@ void FFmpegEncoder::Close()
     audio_codec_ctx_ = nullptr;
   }
 
+  if (video_hw_device_ctx_) {
+    av_buffer_unref(&video_hw_device_ctx_);
+    video_upload_fmt_ = AV_PIX_FMT_NONE;
+  }
+
   if (fmt_ctx_) {
     // NOTE: This also frees video_stream_ and audio_stream_
     avformat_free_context(fmt_ctx_);
@@ -602,8 +657,17 @@ bool FFmpegEncoder::InitializeStream(AVMediaType type, AVStream** stream_ptr, AV
     return false;
   }
 
-  // Find encoder
-  const AVCodec* encoder = GetEncoder(codec, params().audio_params().format());
+  // Find encoder, preferring a hardware implementation if the user asked for one
+  const AVCodec* encoder = nullptr;
+
+  if (type == AVMEDIA_TYPE_VIDEO && params().video_hardware_encoding()) {
+    encoder = GetHardwareEncoder(codec);
+  }
+
+  if (!encoder) {
+    encoder = GetEncoder(codec, params().audio_params().format());
+  }
+
   if (!encoder) {
     SetError(tr("Failed to find codec for 0x%1").arg(codec, 16));
     return false;
@@ -631,6 +695,10 @@ bool FFmpegEncoder::InitializeStream(AVMediaType type, AVStream** stream_ptr, AV
     codec_ctx->pix_fmt = av_get_pix_fmt(params().video_pix_fmt().toUtf8());
     codec_ctx->color_range = params().video_params().color_range() == VideoParams::kColorRangeFull ? AVCOL_RANGE_JPEG : AVCOL_RANGE_MPEG;
 
+    if (video_hw_device_ctx_ && !SetupHardwareContext(codec_ctx, encoder)) {
+      return false;
+    }
+
     if (params().video_params().interlacing() != VideoParams::kInterlaceNone) {
       // FIXME: I actually don't know what these flags do, the documentation helpfully doesn't
       //        explain them at all. I hope using both of them is the right thing to do.
@@ -673,6 +741,11 @@ bool FFmpegEncoder::InitializeStream(AVMediaType type, AVStream** stream_ptr, AV
         codec_ctx->rc_buffer_size = static_cast<int>(params().video_buffer_size());
       }
 
+      // GOP size is a generic AVCodecContext option, so the priv_data loop above can't reach it
+      if (params().has_video_opt(QStringLiteral("ove_gop"))) {
+        codec_ctx->gop_size = params().video_option(QStringLiteral("ove_gop")).toInt();
+      }
+
       // nclc tags. See https://ffmpeg.org/doxygen/4.0/pixfmt_8h.html#ad384ee5a840bafd73daef08e6d9cafe7
       // ffprobe -v error -show_format -show_streams "C:\Users\Tom\Documents\srgb correct tags.mov"
       if (params().color_transform().output().contains(QStringLiteral("sRGB"), Qt::CaseInsensitive)) {
@@ -881,6 +954,607 @@ bool FFmpegEncoder::InitializeResampleContext(const AudioParams &audio)
   return true;
 }
 
+const AVCodec *FFmpegEncoder::GetHardwareEncoder(ExportCodec::Codec c)
+{
+  // Candidate implementations in rough order of expected quality/availability
+  QVector<const char*> candidates;
+
+  switch (c) {
+  case ExportCodec::kCodecH264:
+    candidates = {"h264_nvenc", "h264_qsv", "h264_vaapi", "h264_videotoolbox"};
+    break;
+  case ExportCodec::kCodecH265:
+    candidates = {"hevc_nvenc", "hevc_qsv", "hevc_vaapi", "hevc_videotoolbox"};
+    break;
+  default:
+    // Other codecs have no widely available encode ASICs
+    break;
+  }
+
+  foreach (const char *name, candidates) {
+    const AVCodec *encoder = avcodec_find_encoder_by_name(name);
+    if (!encoder) {
+      continue;
+    }
+
+    // Only pick an implementation whose device can actually be created on this machine
+    AVHWDeviceType type = GetHardwareDeviceType(encoder);
+    AVBufferRef *device = nullptr;
+    if (type != AV_HWDEVICE_TYPE_NONE && av_hwdevice_ctx_create(&device, type, nullptr, nullptr, 0) >= 0) {
+      video_hw_device_ctx_ = device;
+      qDebug() << "Using hardware encoder" << name;
+      return encoder;
+    }
+  }
+
+  return nullptr;
+}
+
+AVHWDeviceType FFmpegEncoder::GetHardwareDeviceType(const AVCodec *encoder)
+{
+  QString name = encoder->name;
+
+  if (name.endsWith(QStringLiteral("_nvenc"))) {
+    return AV_HWDEVICE_TYPE_CUDA;
+  } else if (name.endsWith(QStringLiteral("_qsv"))) {
+    return AV_HWDEVICE_TYPE_QSV;
+  } else if (name.endsWith(QStringLiteral("_vaapi"))) {
+    return AV_HWDEVICE_TYPE_VAAPI;
+  } else if (name.endsWith(QStringLiteral("_videotoolbox"))) {
+    return AV_HWDEVICE_TYPE_VIDEOTOOLBOX;
+  }
+
+  return AV_HWDEVICE_TYPE_NONE;
+}
+
+bool FFmpegEncoder::SetupHardwareContext(AVCodecContext *codec_ctx, const AVCodec *encoder)
+{
+  // Survey the formats the encoder takes: hardware surface formats, the first format it accepts
+  // from system memory, and whether the format the user picked is among them
+  AVPixelFormat requested = codec_ctx->pix_fmt;
+  AVPixelFormat hw_fmt = AV_PIX_FMT_NONE;
+  AVPixelFormat first_sw = AV_PIX_FMT_NONE;
+  bool requested_supported = false;
+
+  for (int i=0; encoder->pix_fmts && encoder->pix_fmts[i] != -1; i++) {
+    AVPixelFormat f = encoder->pix_fmts[i];
+
+    if (av_pix_fmt_desc_get(f)->flags & AV_PIX_FMT_FLAG_HWACCEL) {
+      if (hw_fmt == AV_PIX_FMT_NONE) {
+        hw_fmt = f;
+      }
+    } else {
+      if (first_sw == AV_PIX_FMT_NONE) {
+        first_sw = f;
+      }
+      if (f == requested) {
+        requested_supported = true;
+      }
+    }
+  }
+
+  if (first_sw != AV_PIX_FMT_NONE) {
+    // Encoder accepts frames in system memory (NVENC, QSV, VideoToolbox) - no upload needed
+    codec_ctx->pix_fmt = requested_supported ? requested : first_sw;
+    video_upload_fmt_ = AV_PIX_FMT_NONE;
+    return true;
+  }
+
+  // Encoder only takes hardware surfaces (VAAPI) - create a frame context to upload into
+  AVBufferRef *frames_ref = av_hwframe_ctx_alloc(video_hw_device_ctx_);
+  if (!frames_ref) {
+    SetError(tr("Failed to allocate hardware frame context"));
+    return false;
+  }
+
+  const AVPixFmtDescriptor *requested_desc = av_pix_fmt_desc_get(requested);
+
+  AVHWFramesContext *frames = reinterpret_cast<AVHWFramesContext*>(frames_ref->data);
+  frames->format = hw_fmt;
+  frames->sw_format = (requested_desc && requested_desc->comp[0].depth > 8) ? AV_PIX_FMT_P010 : AV_PIX_FMT_NV12;
+  frames->width = codec_ctx->width;
+  frames->height = codec_ctx->height;
+  frames->initial_pool_size = 32;
+
+  int error_code = av_hwframe_ctx_init(frames_ref);
+  if (error_code < 0) {
+    av_buffer_unref(&frames_ref);
+    FFmpegError(tr("Failed to initialize hardware frame context"), error_code);
+    return false;
+  }
+
+  codec_ctx->hw_frames_ctx = av_buffer_ref(frames_ref);
+  codec_ctx->pix_fmt = hw_fmt;
+  video_upload_fmt_ = frames->sw_format;
+
+  av_buffer_unref(&frames_ref);
+
+  return true;
+}
+
+namespace {
+
+// One elementary stream pulled from a sequence of files, with timestamps offset so the files
+// play back-to-back
+struct ConcatSource {
+  QVector<QString> files;
+  AVMediaType type = AVMEDIA_TYPE_UNKNOWN;
+
+  AVFormatContext* fmt_ctx = nullptr;
+  int stream_index = -1;
+  int out_stream_index = -1;
+  AVRational time_base = {0, 1};
+  int file_number = 0;
+  int64_t ts_offset = 0;
+  int64_t next_ts_offset = 0;
+  AVPacket* pkt = nullptr;
+  bool eof = false;
+};
+
+QString ConcatError(const QString& context, int error_code)
+{
+  char err[1024];
+  av_strerror(error_code, err, 1024);
+
+  return QStringLiteral("%1: %2 %3").arg(context, err, QString::number(error_code));
+}
+
+bool OpenConcatFile(ConcatSource* src, QString* error)
+{
+  const QString& filename = src->files.at(src->file_number);
+
+  int error_code = avformat_open_input(&src->fmt_ctx, filename.toUtf8(), nullptr, nullptr);
+  if (error_code < 0) {
+    *error = ConcatError(QStringLiteral("Failed to open segment %1").arg(filename), error_code);
+    return false;
+  }
+
+  error_code = avformat_find_stream_info(src->fmt_ctx, nullptr);
+  if (error_code < 0) {
+    *error = ConcatError(QStringLiteral("Failed to find stream info in segment %1").arg(filename), error_code);
+    return false;
+  }
+
+  src->stream_index = av_find_best_stream(src->fmt_ctx, src->type, -1, -1, nullptr, 0);
+  if (src->stream_index < 0) {
+    *error = QStringLiteral("Failed to find stream in segment %1").arg(filename);
+    return false;
+  }
+
+  AVRational tb = src->fmt_ctx->streams[src->stream_index]->time_base;
+  if (src->file_number == 0) {
+    src->time_base = tb;
+  } else if (tb.num != src->time_base.num || tb.den != src->time_base.den) {
+    // Identically configured encoders always produce identical timebases
+    *error = QStringLiteral("Segment %1 has a mismatched timebase").arg(filename);
+    return false;
+  }
+
+  // Packets from this file start where the previous file ended
+  src->ts_offset = src->next_ts_offset;
+
+  return true;
+}
+
+bool AdvanceConcatSource(ConcatSource* src, QString* error)
+{
+  av_packet_unref(src->pkt);
+
+  forever {
+    int error_code = av_read_frame(src->fmt_ctx, src->pkt);
+
+    if (error_code == AVERROR_EOF) {
+      avformat_close_input(&src->fmt_ctx);
+
+      src->file_number++;
+      if (src->file_number == src->files.size()) {
+        src->eof = true;
+        return true;
+      }
+
+      if (!OpenConcatFile(src, error)) {
+        return false;
+      }
+      continue;
+    } else if (error_code < 0) {
+      *error = ConcatError(QStringLiteral("Failed to read packet from segment %1").arg(src->files.at(src->file_number)), error_code);
+      return false;
+    }
+
+    if (src->pkt->stream_index != src->stream_index) {
+      av_packet_unref(src->pkt);
+      continue;
+    }
+
+    if (src->pkt->pts != AV_NOPTS_VALUE) {
+      src->pkt->pts += src->ts_offset;
+    }
+    if (src->pkt->dts != AV_NOPTS_VALUE) {
+      src->pkt->dts += src->ts_offset;
+    }
+
+    int64_t end = (src->pkt->dts == AV_NOPTS_VALUE ? src->pkt->pts : src->pkt->dts) + src->pkt->duration;
+    src->next_ts_offset = qMax(src->next_ts_offset, end);
+
+    return true;
+  }
+}
+
+}
+
+bool FFmpegEncoder::ConcatenateSegments(const QVector<QString> &video_segments, const QString &audio_file, const QString &output, QString *error)
+{
+  QVector<ConcatSource> sources;
+
+  {
+    ConcatSource video;
+    video.files = video_segments;
+    video.type = AVMEDIA_TYPE_VIDEO;
+    sources.append(video);
+  }
+
+  if (!audio_file.isEmpty()) {
+    ConcatSource audio;
+    audio.files = {audio_file};
+    audio.type = AVMEDIA_TYPE_AUDIO;
+    sources.append(audio);
+  }
+
+  AVFormatContext* out_ctx = nullptr;
+  bool succeeded = false;
+
+  auto cleanup = [&sources, &out_ctx]() {
+    for (int i=0; i<sources.size(); i++) {
+      av_packet_free(&sources[i].pkt);
+      if (sources[i].fmt_ctx) {
+        avformat_close_input(&sources[i].fmt_ctx);
+      }
+    }
+    if (out_ctx) {
+      if (out_ctx->pb) {
+        avio_closep(&out_ctx->pb);
+      }
+      avformat_free_context(out_ctx);
+    }
+  };
+
+  int error_code = avformat_alloc_output_context2(&out_ctx, nullptr, nullptr, output.toUtf8());
+  if (error_code < 0 || !out_ctx) {
+    *error = ConcatError(tr("Failed to allocate output context for %1").arg(output), error_code);
+    cleanup();
+    return false;
+  }
+
+  // Open each source's first file and mirror its stream in the output
+  for (int i=0; i<sources.size(); i++) {
+    ConcatSource& src = sources[i];
+
+    src.pkt = av_packet_alloc();
+
+    if (!OpenConcatFile(&src, error)) {
+      cleanup();
+      return false;
+    }
+
+    AVStream* in_stream = src.fmt_ctx->streams[src.stream_index];
+    AVStream* out_stream = avformat_new_stream(out_ctx, nullptr);
+    if (!out_stream) {
+      *error = tr("Failed to allocate output stream");
+      cleanup();
+      return false;
+    }
+
+    error_code = avcodec_parameters_copy(out_stream->codecpar, in_stream->codecpar);
+    if (error_code < 0) {
+      *error = ConcatError(tr("Failed to copy codec parameters"), error_code);
+      cleanup();
+      return false;
+    }
+
+    out_stream->codecpar->codec_tag = 0;
+    out_stream->time_base = in_stream->time_base;
+    src.out_stream_index = out_stream->index;
+  }
+
+  error_code = avio_open(&out_ctx->pb, output.toUtf8(), AVIO_FLAG_WRITE);
+  if (error_code < 0) {
+    *error = ConcatError(tr("Failed to open output file %1").arg(output), error_code);
+    cleanup();
+    return false;
+  }
+
+  error_code = avformat_write_header(out_ctx, nullptr);
+  if (error_code < 0) {
+    *error = ConcatError(tr("Failed to write header"), error_code);
+    cleanup();
+    return false;
+  }
+
+  // Prime each source with its first packet
+  for (int i=0; i<sources.size(); i++) {
+    if (!AdvanceConcatSource(&sources[i], error)) {
+      cleanup();
+      return false;
+    }
+  }
+
+  // Stream-copy packets in decode order across sources until every source is exhausted
+  forever {
+    ConcatSource* next = nullptr;
+
+    for (int i=0; i<sources.size(); i++) {
+      ConcatSource& src = sources[i];
+      if (src.eof) {
+        continue;
+      }
+
+      if (!next
+          || av_compare_ts(src.pkt->dts == AV_NOPTS_VALUE ? src.pkt->pts : src.pkt->dts, src.time_base,
+                           next->pkt->dts == AV_NOPTS_VALUE ? next->pkt->pts : next->pkt->dts, next->time_base) < 0) {
+        next = &src;
+      }
+    }
+
+    if (!next) {
+      break;
+    }
+
+    AVStream* out_stream = out_ctx->streams[next->out_stream_index];
+    av_packet_rescale_ts(next->pkt, next->time_base, out_stream->time_base);
+    next->pkt->stream_index = next->out_stream_index;
+    next->pkt->pos = -1;
+
+    error_code = av_interleaved_write_frame(out_ctx, next->pkt);
+    if (error_code < 0) {
+      *error = ConcatError(tr("Failed to write interleaved packet"), error_code);
+      cleanup();
+      return false;
+    }
+
+    if (!AdvanceConcatSource(next, error)) {
+      cleanup();
+      return false;
+    }
+  }
+
+  error_code = av_write_trailer(out_ctx);
+  if (error_code < 0) {
+    *error = ConcatError(tr("Failed to write trailer"), error_code);
+  } else {
+    succeeded = true;
+  }
+
+  cleanup();
+
+  return succeeded;
+}
+
+bool FFmpegEncoder::CopyVideoPackets(const QString &source, const TimeRange &range, const VideoParams &video_params, ExportCodec::Codec codec, const QString &output, QString *error)
+{
+  // Determine the codec ID the source must have to match what the export would produce
+  AVCodecID expected_codec = AV_CODEC_ID_NONE;
+
+  switch (codec) {
+  case ExportCodec::kCodecH264:
+    expected_codec = AV_CODEC_ID_H264;
+    break;
+  case ExportCodec::kCodecH265:
+    expected_codec = AV_CODEC_ID_HEVC;
+    break;
+  case ExportCodec::kCodecVP9:
+    expected_codec = AV_CODEC_ID_VP9;
+    break;
+  case ExportCodec::kCodecAV1:
+    expected_codec = AV_CODEC_ID_AV1;
+    break;
+  case ExportCodec::kCodecProRes:
+    expected_codec = AV_CODEC_ID_PRORES;
+    break;
+  case ExportCodec::kCodecDNxHD:
+    expected_codec = AV_CODEC_ID_DNXHD;
+    break;
+  case ExportCodec::kCodecCineform:
+    expected_codec = AV_CODEC_ID_CFHD;
+    break;
+  default:
+    break;
+  }
+
+  if (expected_codec == AV_CODEC_ID_NONE) {
+    *error = QStringLiteral("Export codec does not support stream copying");
+    return false;
+  }
+
+  AVFormatContext* in_ctx = nullptr;
+  AVFormatContext* out_ctx = nullptr;
+  AVPacket* pkt = nullptr;
+  bool succeeded = false;
+
+  auto cleanup = [&in_ctx, &out_ctx, &pkt]() {
+    av_packet_free(&pkt);
+    if (in_ctx) {
+      avformat_close_input(&in_ctx);
+    }
+    if (out_ctx) {
+      if (out_ctx->pb) {
+        avio_closep(&out_ctx->pb);
+      }
+      avformat_free_context(out_ctx);
+    }
+  };
+
+  int error_code = avformat_open_input(&in_ctx, source.toUtf8(), nullptr, nullptr);
+  if (error_code < 0) {
+    *error = ConcatError(QStringLiteral("Failed to open source %1").arg(source), error_code);
+    cleanup();
+    return false;
+  }
+
+  error_code = avformat_find_stream_info(in_ctx, nullptr);
+  if (error_code < 0) {
+    *error = ConcatError(QStringLiteral("Failed to find stream info in %1").arg(source), error_code);
+    cleanup();
+    return false;
+  }
+
+  int stream_index = av_find_best_stream(in_ctx, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+  if (stream_index < 0) {
+    *error = QStringLiteral("No video stream in %1").arg(source);
+    cleanup();
+    return false;
+  }
+
+  AVStream* in_stream = in_ctx->streams[stream_index];
+
+  if (in_stream->codecpar->codec_id != expected_codec
+      || in_stream->codecpar->width != video_params.width()
+      || in_stream->codecpar->height != video_params.height()) {
+    *error = QStringLiteral("Source stream does not match export parameters");
+    cleanup();
+    return false;
+  }
+
+  AVRational export_rate = video_params.frame_rate().toAVRational();
+  if (in_stream->avg_frame_rate.num > 0 && av_cmp_q(in_stream->avg_frame_rate, export_rate) != 0) {
+    *error = QStringLiteral("Source frame rate does not match export frame rate");
+    cleanup();
+    return false;
+  }
+
+  int64_t stream_start = (in_stream->start_time == AV_NOPTS_VALUE) ? 0 : in_stream->start_time;
+  int64_t target_in = stream_start + Timecode::time_to_timestamp(range.in(), in_stream->time_base);
+  int64_t target_out = stream_start + Timecode::time_to_timestamp(range.out(), in_stream->time_base);
+  int64_t frame_duration = av_rescale_q(1, av_inv_q(export_rate), in_stream->time_base);
+
+  error_code = av_seek_frame(in_ctx, stream_index, target_in, AVSEEK_FLAG_BACKWARD);
+  if (error_code < 0) {
+    *error = ConcatError(QStringLiteral("Failed to seek in %1").arg(source), error_code);
+    cleanup();
+    return false;
+  }
+
+  // Mirror the source's stream in the output file
+  error_code = avformat_alloc_output_context2(&out_ctx, nullptr, nullptr, output.toUtf8());
+  if (error_code < 0 || !out_ctx) {
+    *error = ConcatError(tr("Failed to allocate output context for %1").arg(output), error_code);
+    cleanup();
+    return false;
+  }
+
+  AVStream* out_stream = avformat_new_stream(out_ctx, nullptr);
+  if (!out_stream) {
+    *error = tr("Failed to allocate output stream");
+    cleanup();
+    return false;
+  }
+
+  error_code = avcodec_parameters_copy(out_stream->codecpar, in_stream->codecpar);
+  if (error_code < 0) {
+    *error = ConcatError(tr("Failed to copy codec parameters"), error_code);
+    cleanup();
+    return false;
+  }
+
+  out_stream->codecpar->codec_tag = 0;
+  out_stream->time_base = in_stream->time_base;
+
+  error_code = avio_open(&out_ctx->pb, output.toUtf8(), AVIO_FLAG_WRITE);
+  if (error_code < 0) {
+    *error = ConcatError(tr("Failed to open output file %1").arg(output), error_code);
+    cleanup();
+    return false;
+  }
+
+  error_code = avformat_write_header(out_ctx, nullptr);
+  if (error_code < 0) {
+    *error = ConcatError(tr("Failed to write header"), error_code);
+    cleanup();
+    return false;
+  }
+
+  pkt = av_packet_alloc();
+
+  bool first = true;
+  int64_t ts_offset = AV_NOPTS_VALUE;
+
+  forever {
+    error_code = av_read_frame(in_ctx, pkt);
+
+    if (error_code == AVERROR_EOF) {
+      break;
+    } else if (error_code < 0) {
+      *error = ConcatError(QStringLiteral("Failed to read packet from %1").arg(source), error_code);
+      cleanup();
+      return false;
+    }
+
+    if (pkt->stream_index != stream_index) {
+      av_packet_unref(pkt);
+      continue;
+    }
+
+    int64_t pts = (pkt->pts == AV_NOPTS_VALUE) ? pkt->dts : pkt->pts;
+
+    if (first) {
+      // The copy must start exactly on the keyframe the seek found, otherwise the start of the
+      // range would reference frames we aren't copying
+      if (!(pkt->flags & AV_PKT_FLAG_KEY) || llabs(pts - target_in) > frame_duration/2) {
+        *error = QStringLiteral("Range does not start on a keyframe");
+        cleanup();
+        return false;
+      }
+      first = false;
+    }
+
+    if (pts >= target_out) {
+      if (pkt->flags & AV_PKT_FLAG_KEY) {
+        // A keyframe at or past the range end means nothing we need can follow
+        av_packet_unref(pkt);
+        break;
+      }
+
+      // Reordered packet past the range end, frames before it may still be coming
+      av_packet_unref(pkt);
+      continue;
+    }
+
+    // Offset timestamps by the first packet's decode timestamp so the output starts at zero
+    if (ts_offset == AV_NOPTS_VALUE) {
+      ts_offset = (pkt->dts == AV_NOPTS_VALUE) ? pts : pkt->dts;
+    }
+
+    if (pkt->pts != AV_NOPTS_VALUE) {
+      pkt->pts -= ts_offset;
+    }
+    if (pkt->dts != AV_NOPTS_VALUE) {
+      pkt->dts -= ts_offset;
+    }
+
+    pkt->stream_index = out_stream->index;
+    pkt->pos = -1;
+
+    error_code = av_interleaved_write_frame(out_ctx, pkt);
+    if (error_code < 0) {
+      *error = ConcatError(tr("Failed to write interleaved packet"), error_code);
+      cleanup();
+      return false;
+    }
+
+    av_packet_unref(pkt);
+  }
+
+  error_code = av_write_trailer(out_ctx);
+  if (error_code < 0) {
+    *error = ConcatError(tr("Failed to write trailer"), error_code);
+  } else {
+    succeeded = true;
+  }
+
+  cleanup();
+
+  return succeeded;
+}
+
 const AVCodec *FFmpegEncoder::GetEncoder(ExportCodec::Codec c, SampleFormat aformat)
 {
   switch (c) {
@@ -26,6 +26,7 @@ extern "C" {
 #include <libavfilter/avfilter.h>
 #include <libavformat/avformat.h>
 #include <libswresample/swresample.h>
+#include <libavutil/hwcontext.h>
 #include <libavutil/opt.h>
 }
 
@@ -60,6 +61,26 @@ public:
     return video_conversion_fmt_;
   }
 
+  /**
+   * @brief Losslessly stitch independently encoded segment files into one output file
+   *
+   * Copies packets (no re-encode) from each video segment in order, offsetting timestamps so
+   * they play back-to-back, interleaving them with the packets of an optional audio-only file.
+   * All segments must share the video codec parameters of the first, which is the case when
+   * they were produced by identically configured encoders.
+   */
+  static bool ConcatenateSegments(const QVector<QString> &video_segments, const QString &audio_file, const QString &output, QString *error);
+
+  /**
+   * @brief Stream-copy a range of a source file's video into a new file without re-encoding
+   *
+   * Used by the export smart-render path for clips that pass through the pipeline untouched. The
+   * copy only proceeds if the source's codec, dimensions and frame rate match what the export
+   * would have produced and the requested range starts on a keyframe; otherwise this returns
+   * false with a description in `error` and the caller falls back to a full render.
+   */
+  static bool CopyVideoPackets(const QString &source, const TimeRange &range, const VideoParams &video_params, ExportCodec::Codec codec, const QString &output, QString *error);
+
 private:
   /**
    * @brief Handle an FFmpeg error code
@@ -84,6 +105,23 @@ private:
 
   static const AVCodec *GetEncoder(ExportCodec::Codec c, SampleFormat aformat);
 
+  /**
+   * @brief Find a hardware implementation of this codec whose device exists on this machine
+   *
+   * Tries NVENC/QSV/VAAPI/VideoToolbox in order and creates the device context for the first
+   * one that initializes, storing it in video_hw_device_ctx_. Returns null if none do, in
+   * which case encoding proceeds in software.
+   */
+  const AVCodec *GetHardwareEncoder(ExportCodec::Codec c);
+
+  static AVHWDeviceType GetHardwareDeviceType(const AVCodec *encoder);
+
+  /**
+   * @brief Choose the hardware encoder's input format, creating a frame context if it only
+   * accepts hardware surfaces
+   */
+  bool SetupHardwareContext(AVCodecContext *codec_ctx, const AVCodec *encoder);
+
   AVFormatContext* fmt_ctx_;
 
   AVStream* video_stream_;
@@ -93,6 +131,11 @@ private:
   AVFilterContext *video_buffersink_ctx_;
   PixelFormat video_conversion_fmt_;
 
+  // Hardware encoding state: device context, and the format frames are uploaded in when the
+  // encoder only takes hardware surfaces (AV_PIX_FMT_NONE when it accepts system memory)
+  AVBufferRef *video_hw_device_ctx_;
+  AVPixelFormat video_upload_fmt_;
+
   AVStream* audio_stream_;
   AVCodecContext* audio_codec_ctx_;
   SwrContext* audio_resample_ctx_;
@@ -0,0 +1,442 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "flacaudiodevice.h"
+
+#include <QDebug>
+
+#include "common/ffmpegutils.h"
+
+namespace olive {
+
+// Fallback frame size if the encoder doesn't report one
+const int kDefaultFlacFrameSize = 4096;
+
+FlacAudioDevice::FlacAudioDevice(QObject *parent) :
+  QObject(parent),
+  bytes_per_sample_(0),
+  size_(0),
+  pos_(0)
+{
+}
+
+FlacAudioDevice::~FlacAudioDevice()
+{
+  close();
+}
+
+bool FlacAudioDevice::open(const QVector<QString> &filenames, const AudioParams &params, QIODevice::OpenMode mode)
+{
+  if (isOpen()) {
+    qWarning() << "Tried to open a FlacAudioDevice that was already open";
+    return false;
+  }
+
+  params_ = params;
+  mode_ = mode;
+  bytes_per_sample_ = params.bytes_per_sample_per_channel();
+  size_ = 0;
+  pos_ = 0;
+
+  channels_.resize(filenames.size());
+
+  for (int i=0; i<channels_.size(); i++) {
+    Channel &ch = channels_[i];
+    ch = Channel();
+
+    bool ok;
+    if (mode & QIODevice::WriteOnly) {
+      ok = OpenChannelForWriting(ch, filenames.at(i));
+    } else {
+      ok = OpenChannelForReading(ch, filenames.at(i));
+    }
+
+    if (!ok) {
+      close();
+      return false;
+    }
+  }
+
+  if (!(mode & QIODevice::WriteOnly) && !channels_.isEmpty()) {
+    // Determine decoded PCM size per channel from the stream duration
+    const Channel &ch = channels_.first();
+    int64_t duration = ch.avstream->duration;
+    if (duration == AV_NOPTS_VALUE) {
+      duration = av_rescale_q(ch.fmt_ctx->duration, {1, AV_TIME_BASE}, ch.avstream->time_base);
+    }
+    int64_t nb_samples = av_rescale_q(duration, ch.avstream->time_base, {1, params_.sample_rate()});
+    size_ = nb_samples * bytes_per_sample_;
+  }
+
+  return true;
+}
+
+bool FlacAudioDevice::OpenChannelForWriting(Channel &ch, const QString &filename)
+{
+  QByteArray fn_bytes = filename.toUtf8();
+
+  if (avformat_alloc_output_context2(&ch.fmt_ctx, nullptr, "flac", fn_bytes.constData()) < 0) {
+    qCritical() << "Failed to allocate FLAC output context for" << filename;
+    return false;
+  }
+
+  const AVCodec *encoder = avcodec_find_encoder(AV_CODEC_ID_FLAC);
+  if (!encoder) {
+    qCritical() << "Failed to find FLAC encoder";
+    return false;
+  }
+
+  ch.codec_ctx = avcodec_alloc_context3(encoder);
+
+  // FLAC only stores integers - use the deepest integer format the encoder offers
+  AVSampleFormat encode_fmt = encoder->sample_fmts[0];
+  for (const AVSampleFormat *f = encoder->sample_fmts; *f != AV_SAMPLE_FMT_NONE; f++) {
+    if (*f == AV_SAMPLE_FMT_S32) {
+      encode_fmt = *f;
+      break;
+    }
+  }
+
+  ch.codec_ctx->sample_fmt = encode_fmt;
+  ch.codec_ctx->sample_rate = params_.sample_rate();
+  ch.codec_ctx->channels = 1;
+  ch.codec_ctx->channel_layout = AV_CH_LAYOUT_MONO;
+  ch.codec_ctx->time_base = {1, params_.sample_rate()};
+
+  if (ch.fmt_ctx->oformat->flags & AVFMT_GLOBALHEADER) {
+    ch.codec_ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+  }
+
+  if (avcodec_open2(ch.codec_ctx, encoder, nullptr) < 0) {
+    qCritical() << "Failed to open FLAC encoder";
+    return false;
+  }
+
+  ch.avstream = avformat_new_stream(ch.fmt_ctx, nullptr);
+  avcodec_parameters_from_context(ch.avstream->codecpar, ch.codec_ctx);
+  ch.avstream->time_base = ch.codec_ctx->time_base;
+
+  if (avio_open(&ch.fmt_ctx->pb, fn_bytes.constData(), AVIO_FLAG_WRITE) < 0) {
+    qCritical() << "Failed to open FLAC file for writing:" << filename;
+    return false;
+  }
+
+  if (avformat_write_header(ch.fmt_ctx, nullptr) < 0) {
+    qCritical() << "Failed to write FLAC header for" << filename;
+    return false;
+  }
+
+  // Mono input in the conform's sample format to mono in the encoder's
+  ch.swr = swr_alloc_set_opts(nullptr,
+                              AV_CH_LAYOUT_MONO,
+                              encode_fmt,
+                              params_.sample_rate(),
+                              AV_CH_LAYOUT_MONO,
+                              av_get_packed_sample_fmt(FFmpegUtils::GetFFmpegSampleFormat(params_.format())),
+                              params_.sample_rate(),
+                              0,
+                              nullptr);
+  swr_init(ch.swr);
+
+  ch.write_pos = 0;
+
+  return true;
+}
+
+bool FlacAudioDevice::OpenChannelForReading(Channel &ch, const QString &filename)
+{
+  QByteArray fn_bytes = filename.toUtf8();
+
+  if (avformat_open_input(&ch.fmt_ctx, fn_bytes.constData(), nullptr, nullptr) < 0) {
+    qCritical() << "Failed to open FLAC file for reading:" << filename;
+    return false;
+  }
+
+  if (avformat_find_stream_info(ch.fmt_ctx, nullptr) < 0) {
+    qCritical() << "Failed to find stream info in" << filename;
+    return false;
+  }
+
+  int stream_index = av_find_best_stream(ch.fmt_ctx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+  if (stream_index < 0) {
+    qCritical() << "No audio stream in" << filename;
+    return false;
+  }
+
+  ch.avstream = ch.fmt_ctx->streams[stream_index];
+
+  const AVCodec *decoder = avcodec_find_decoder(ch.avstream->codecpar->codec_id);
+  ch.codec_ctx = avcodec_alloc_context3(decoder);
+  avcodec_parameters_to_context(ch.codec_ctx, ch.avstream->codecpar);
+
+  if (avcodec_open2(ch.codec_ctx, decoder, nullptr) < 0) {
+    qCritical() << "Failed to open FLAC decoder for" << filename;
+    return false;
+  }
+
+  // Mono decoded samples back to the conform's sample format
+  ch.swr = swr_alloc_set_opts(nullptr,
+                              AV_CH_LAYOUT_MONO,
+                              av_get_packed_sample_fmt(FFmpegUtils::GetFFmpegSampleFormat(params_.format())),
+                              params_.sample_rate(),
+                              AV_CH_LAYOUT_MONO,
+                              ch.codec_ctx->sample_fmt,
+                              ch.codec_ctx->sample_rate,
+                              0,
+                              nullptr);
+  swr_init(ch.swr);
+
+  ch.cache_start = 0;
+  ch.next_sample = 0;
+
+  return true;
+}
+
+qint64 FlacAudioDevice::write(const char **data, qint64 bytes_per_channel)
+{
+  if (!(mode_ & QIODevice::WriteOnly)) {
+    return -1;
+  }
+
+  for (int i=0; i<channels_.size(); i++) {
+    Channel &ch = channels_[i];
+
+    ch.stage.append(data[i], bytes_per_channel);
+
+    if (!EncodeStaged(ch, false)) {
+      return -1;
+    }
+  }
+
+  return bytes_per_channel;
+}
+
+bool FlacAudioDevice::EncodeStaged(Channel &ch, bool final)
+{
+  int frame_size = ch.codec_ctx->frame_size > 0 ? ch.codec_ctx->frame_size : kDefaultFlacFrameSize;
+
+  while (true) {
+    int stage_samples = ch.stage.size() / bytes_per_sample_;
+    int frame_samples = qMin(stage_samples, frame_size);
+
+    if (frame_samples == 0 || (frame_samples < frame_size && !final)) {
+      break;
+    }
+
+    AVFrame *frame = av_frame_alloc();
+    frame->format = ch.codec_ctx->sample_fmt;
+    frame->channels = 1;
+    frame->channel_layout = AV_CH_LAYOUT_MONO;
+    frame->sample_rate = params_.sample_rate();
+    frame->nb_samples = frame_samples;
+    frame->pts = ch.write_pos;
+
+    if (av_frame_get_buffer(frame, 0) < 0) {
+      av_frame_free(&frame);
+      return false;
+    }
+
+    const uint8_t *in = reinterpret_cast<const uint8_t*>(ch.stage.constData());
+    int converted = swr_convert(ch.swr, frame->data, frame_samples, &in, frame_samples);
+
+    bool ok = (converted == frame_samples) && (avcodec_send_frame(ch.codec_ctx, frame) >= 0);
+
+    av_frame_free(&frame);
+
+    if (!ok || !WritePackets(ch)) {
+      return false;
+    }
+
+    ch.write_pos += frame_samples;
+    ch.stage.remove(0, frame_samples * bytes_per_sample_);
+  }
+
+  return true;
+}
+
+bool FlacAudioDevice::WritePackets(Channel &ch)
+{
+  AVPacket *pkt = av_packet_alloc();
+
+  int ret;
+  while ((ret = avcodec_receive_packet(ch.codec_ctx, pkt)) >= 0) {
+    pkt->stream_index = ch.avstream->index;
+    av_packet_rescale_q(pkt, ch.codec_ctx->time_base, ch.avstream->time_base);
+
+    if (av_interleaved_write_frame(ch.fmt_ctx, pkt) < 0) {
+      av_packet_free(&pkt);
+      return false;
+    }
+  }
+
+  av_packet_free(&pkt);
+
+  return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF;
+}
+
+qint64 FlacAudioDevice::read(char **data, qint64 bytes_per_channel, qint64 offset)
+{
+  if (mode_ & QIODevice::WriteOnly) {
+    return -1;
+  }
+
+  qint64 read_bytes = 0;
+
+  for (int i=0; i<channels_.size(); i++) {
+    read_bytes = ReadChannel(channels_[i], data[i] + offset, bytes_per_channel, pos_);
+  }
+
+  pos_ += read_bytes;
+
+  return read_bytes;
+}
+
+qint64 FlacAudioDevice::ReadChannel(Channel &ch, char *dest, qint64 bytes, qint64 start)
+{
+  qint64 filled = 0;
+
+  // Never read past the end of the stream - the caller pads with silence
+  bytes = qMin(bytes, size_ - start);
+  if (bytes <= 0) {
+    return 0;
+  }
+
+  while (filled < bytes) {
+    qint64 want = start + filled;
+
+    // Serve from the last decoded frame if it covers this position
+    qint64 cache_end = ch.cache_start + ch.cache.size();
+    if (want >= ch.cache_start && want < cache_end) {
+      qint64 copy = qMin(bytes - filled, cache_end - want);
+      memcpy(dest + filled, ch.cache.constData() + (want - ch.cache_start), copy);
+      filled += copy;
+      continue;
+    }
+
+    int64_t want_sample = want / bytes_per_sample_;
+
+    if (ch.next_sample < 0 || want_sample < ch.next_sample || want_sample >= ch.next_sample + ch.codec_ctx->sample_rate) {
+      // Position is behind us or far ahead, seek instead of decoding up to it
+      av_seek_frame(ch.fmt_ctx, ch.avstream->index,
+                    av_rescale_q(want_sample, {1, params_.sample_rate()}, ch.avstream->time_base),
+                    AVSEEK_FLAG_BACKWARD);
+      avcodec_flush_buffers(ch.codec_ctx);
+      ch.next_sample = -1;
+    }
+
+    // Decode the next frame
+    AVFrame *frame = av_frame_alloc();
+    AVPacket *pkt = av_packet_alloc();
+
+    int ret;
+    while ((ret = avcodec_receive_frame(ch.codec_ctx, frame)) == AVERROR(EAGAIN)) {
+      ret = av_read_frame(ch.fmt_ctx, pkt);
+      if (ret < 0) {
+        avcodec_send_packet(ch.codec_ctx, nullptr);
+      } else {
+        avcodec_send_packet(ch.codec_ctx, pkt);
+        av_packet_unref(pkt);
+      }
+    }
+
+    av_packet_free(&pkt);
+
+    if (ret < 0) {
+      // EOF or error, let the caller pad the remainder
+      av_frame_free(&frame);
+      break;
+    }
+
+    // Determine which samples this frame holds
+    int64_t first_sample;
+    if (frame->best_effort_timestamp != AV_NOPTS_VALUE) {
+      first_sample = av_rescale_q(frame->best_effort_timestamp, ch.avstream->time_base, {1, params_.sample_rate()});
+    } else {
+      first_sample = qMax<int64_t>(ch.next_sample, 0);
+    }
+
+    // Convert into the frame cache
+    ch.cache.resize(frame->nb_samples * bytes_per_sample_);
+    ch.cache_start = first_sample * bytes_per_sample_;
+    uint8_t *out = reinterpret_cast<uint8_t*>(ch.cache.data());
+    swr_convert(ch.swr, &out, frame->nb_samples,
+                const_cast<const uint8_t**>(frame->extended_data), frame->nb_samples);
+
+    ch.next_sample = first_sample + frame->nb_samples;
+
+    av_frame_free(&frame);
+
+    if (ch.cache_start + ch.cache.size() <= start + filled) {
+      // Still before the position we want, keep decoding
+      continue;
+    }
+  }
+
+  return filled;
+}
+
+void FlacAudioDevice::close()
+{
+  for (int i=0; i<channels_.size(); i++) {
+    CloseChannel(channels_[i]);
+  }
+
+  channels_.clear();
+}
+
+void FlacAudioDevice::CloseChannel(Channel &ch)
+{
+  if (mode_ & QIODevice::WriteOnly) {
+    if (ch.codec_ctx && ch.fmt_ctx && ch.fmt_ctx->pb) {
+      // Encode any trailing partial frame and drain the encoder
+      EncodeStaged(ch, true);
+      avcodec_send_frame(ch.codec_ctx, nullptr);
+      WritePackets(ch);
+      av_write_trailer(ch.fmt_ctx);
+    }
+
+    if (ch.fmt_ctx && ch.fmt_ctx->pb) {
+      avio_closep(&ch.fmt_ctx->pb);
+    }
+    if (ch.codec_ctx) {
+      avcodec_free_context(&ch.codec_ctx);
+    }
+    if (ch.fmt_ctx) {
+      avformat_free_context(ch.fmt_ctx);
+      ch.fmt_ctx = nullptr;
+    }
+  } else {
+    if (ch.codec_ctx) {
+      avcodec_free_context(&ch.codec_ctx);
+    }
+    if (ch.fmt_ctx) {
+      avformat_close_input(&ch.fmt_ctx);
+    }
+  }
+
+  if (ch.swr) {
+    swr_free(&ch.swr);
+  }
+
+  ch.stage.clear();
+  ch.cache.clear();
+}
+
+}
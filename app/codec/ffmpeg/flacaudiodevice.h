@@ -0,0 +1,133 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef FLACAUDIODEVICE_H
+#define FLACAUDIODEVICE_H
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include <libswresample/swresample.h>
+}
+
+#include <olive/core/core.h>
+#include <QObject>
+#include <QVector>
+
+namespace olive {
+
+using namespace core;
+
+/**
+ * @brief FLAC-compressed drop-in for PlanarFileDevice
+ *
+ * Stores each channel of a conform as a mono FLAC file, roughly halving the disk footprint and
+ * read bandwidth of raw PCM at the cost of a little CPU. Writing is sequential only; reading
+ * exposes the same byte-addressed PCM interface as PlanarFileDevice, seeking and decoding the
+ * FLAC on the fly (with a small per-channel cache of the last decoded frame so sequential reads
+ * don't re-seek).
+ *
+ * FLAC only stores integers, so float conforms are quantized to the deepest integer format the
+ * encoder offers and converted back on read.
+ */
+class FlacAudioDevice : public QObject
+{
+  Q_OBJECT
+public:
+  FlacAudioDevice(QObject *parent = nullptr);
+
+  virtual ~FlacAudioDevice() override;
+
+  bool isOpen() const
+  {
+    return !channels_.isEmpty();
+  }
+
+  bool open(const QVector<QString> &filenames, const AudioParams &params, QIODevice::OpenMode mode);
+
+  qint64 read(char **data, qint64 bytes_per_channel, qint64 offset = 0);
+
+  qint64 write(const char **data, qint64 bytes_per_channel);
+
+  /**
+   * @brief Decoded PCM size per channel in bytes
+   */
+  qint64 size() const
+  {
+    return size_;
+  }
+
+  bool seek(qint64 pos)
+  {
+    pos_ = pos;
+    return true;
+  }
+
+  void close();
+
+private:
+  struct Channel {
+    AVFormatContext *fmt_ctx;
+    AVCodecContext *codec_ctx;
+    AVStream *avstream;
+    SwrContext *swr;
+
+    // Write state: input bytes not yet forming a whole encoder frame, and samples sent so far
+    QByteArray stage;
+    int64_t write_pos;
+
+    // Read state: the last decoded+converted frame and the next sample sequential decoding yields
+    QByteArray cache;
+    int64_t cache_start;
+    int64_t next_sample;
+  };
+
+  bool OpenChannelForWriting(Channel &ch, const QString &filename);
+
+  bool OpenChannelForReading(Channel &ch, const QString &filename);
+
+  /**
+   * @brief Encode and mux whole frames from the stage, including a trailing partial one if final
+   */
+  bool EncodeStaged(Channel &ch, bool final);
+
+  bool WritePackets(Channel &ch);
+
+  qint64 ReadChannel(Channel &ch, char *dest, qint64 bytes, qint64 start);
+
+  void CloseChannel(Channel &ch);
+
+  QVector<Channel> channels_;
+
+  AudioParams params_;
+
+  QIODevice::OpenMode mode_;
+
+  int bytes_per_sample_;
+
+  qint64 size_;
+
+  qint64 pos_;
+
+};
+
+}
+
+#endif // FLACAUDIODEVICE_H
@@ -24,6 +24,8 @@
 #include <QDir>
 #include <QFileInfo>
 #include <QMessageBox>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
 
 #include "common/define.h"
 #include "common/oiioutils.h"
@@ -116,7 +118,15 @@ FootageDescription OIIODecoder::Probe(const QString &filename, CancelAtom *cance
 bool OIIODecoder::OpenInternal()
 {
   // If we can open the filename provided, assume everything is working
-  return OpenImageHandler(stream().filename(), stream().stream());
+  if (!OpenImageHandler(stream().filename(), stream().stream())) {
+    return false;
+  }
+
+  // Image sequences open a fresh decoder for every frame, so start pulling the next frame off
+  // disk now - by the time that decoder opens, the file should already be in the OS cache
+  PrefetchNextImage(stream().filename());
+
+  return true;
 }
 
 TexturePtr OIIODecoder::RetrieveVideoInternal(const RetrieveVideoParams &p)
@@ -134,21 +144,68 @@ TexturePtr OIIODecoder::RetrieveVideoInternal(const RetrieveVideoParams &p)
 
     if (p.divider == 1) {
       // Just upload straight to the buffer
-      image_->read_image(oiio_pix_fmt_, buffer_.data(), OIIO::AutoStride, buffer_.linesize_bytes());
+      if (!ReadImageParallel()) {
+        image_->read_image(oiio_pix_fmt_, buffer_.data(), OIIO::AutoStride, buffer_.linesize_bytes());
+      }
     } else {
-      OIIO::ImageBuf buf(image_->spec());
-      image_->read_image(image_->spec().format, buf.localpixels(), buf.pixel_stride(), buf.scanline_stride(), buf.z_stride());
-
-      // Roughly downsample image for divider (for some reason OIIO::ImageBufAlgo::resample failed here)
+      // Roughly downsample image for divider by point sampling (for some reason
+      // OIIO::ImageBufAlgo::resample failed here). Rather than decoding the entire still at
+      // full resolution first - which for a 12K plate is a gigabyte-scale allocation - stream
+      // it through a band buffer holding a single tile row (or scanline), so only the parts of
+      // the file a sampled row actually lands in are decoded.
+      const OIIO::ImageSpec &spec = image_->spec();
       int px_sz = vp.GetBytesPerPixel();
-      for (int dst_y=0; dst_y<buffer_.height(); dst_y++) {
-        int src_y = dst_y * buf.spec().height / buffer_.height();
-
-        for (int dst_x=0; dst_x<buffer_.width(); dst_x++) {
-          int src_x = dst_x * buf.spec().width / buffer_.width();
-          memcpy(buffer_.data() + buffer_.linesize_bytes() * dst_y + px_sz * dst_x,
-                 static_cast<uint8_t*>(buf.localpixels()) + buf.scanline_stride() * src_y + px_sz * src_x,
-                 px_sz);
+
+      if (spec.tile_height > 0) {
+        // Tiled format: read one row of tiles at a time. Tile rows that no sampled row lands
+        // in are never read at all.
+        int tile_h = spec.tile_height;
+        qint64 band_stride = qint64(spec.width) * px_sz;
+        QByteArray band(band_stride * tile_h, Qt::Uninitialized);
+
+        // Y origin of the tile row currently held in `band`
+        int band_y = -1;
+
+        for (int dst_y=0; dst_y<buffer_.height(); dst_y++) {
+          int src_y = dst_y * spec.height / buffer_.height();
+          int tile_y = src_y / tile_h * tile_h;
+
+          if (tile_y != band_y) {
+            if (!image_->read_tiles(spec.x, spec.x + spec.width,
+                                    spec.y + tile_y, spec.y + std::min(tile_y + tile_h, spec.height),
+                                    0, 1, oiio_pix_fmt_, band.data(),
+                                    OIIO::AutoStride, band_stride)) {
+              break;
+            }
+            band_y = tile_y;
+          }
+
+          const char *src_row = band.constData() + band_stride * (src_y - band_y);
+          for (int dst_x=0; dst_x<buffer_.width(); dst_x++) {
+            int src_x = dst_x * spec.width / buffer_.width();
+            memcpy(buffer_.data() + buffer_.linesize_bytes() * dst_y + px_sz * dst_x,
+                   src_row + qint64(px_sz) * src_x,
+                   px_sz);
+          }
+        }
+      } else {
+        // Scanline format: only the sampled scanlines are read, i.e. 1/divider of the image
+        QByteArray row(qint64(spec.width) * px_sz, Qt::Uninitialized);
+
+        for (int dst_y=0; dst_y<buffer_.height(); dst_y++) {
+          int src_y = dst_y * spec.height / buffer_.height();
+
+          if (!image_->read_scanlines(spec.y + src_y, spec.y + src_y + 1, 0,
+                                      oiio_pix_fmt_, row.data())) {
+            break;
+          }
+
+          for (int dst_x=0; dst_x<buffer_.width(); dst_x++) {
+            int src_x = dst_x * spec.width / buffer_.width();
+            memcpy(buffer_.data() + buffer_.linesize_bytes() * dst_y + px_sz * dst_x,
+                   row.constData() + qint64(px_sz) * src_x,
+                   px_sz);
+          }
         }
       }
     }
@@ -189,6 +246,15 @@ bool OIIODecoder::FileTypeIsSupported(const QString& fn)
 
 bool OIIODecoder::OpenImageHandler(const QString &fn, int subimage)
 {
+  // Size OIIO's internal thread pools (including OpenEXR's) to the machine so formats that can
+  // decompress in parallel actually do
+  static bool oiio_pools_configured = false;
+  if (!oiio_pools_configured) {
+    OIIO::attribute("threads", QThread::idealThreadCount());
+    OIIO::attribute("exr_threads", QThread::idealThreadCount());
+    oiio_pools_configured = true;
+  }
+
   image_ = OIIO::ImageInput::open(fn.toStdString());
 
   if (!image_) {
@@ -220,6 +286,82 @@ bool OIIODecoder::OpenImageHandler(const QString &fn, int subimage)
   return true;
 }
 
+bool OIIODecoder::ReadImageParallel()
+{
+  const OIIO::ImageSpec &spec = image_->spec();
+
+  int threads = QThread::idealThreadCount();
+
+  // Don't bother spinning up threads for small stills
+  const int kMinParallelHeight = 1024;
+  if (threads < 2 || spec.height < kMinParallelHeight) {
+    return false;
+  }
+
+  // Split into one band per thread, keeping band boundaries on tile edges for tiled formats
+  int band_height = (spec.height + threads - 1) / threads;
+  if (spec.tile_height > 0) {
+    band_height = (band_height + spec.tile_height - 1) / spec.tile_height * spec.tile_height;
+  }
+
+  QVector<int> bands;
+  for (int y = 0; y < spec.height; y += band_height) {
+    bands.append(y);
+  }
+
+  if (bands.size() < 2) {
+    return false;
+  }
+
+  std::string fn = stream().filename().toStdString();
+  int subimage = stream().stream();
+  uint8_t *dst = buffer_.data();
+  int linesize = buffer_.linesize_bytes();
+
+  std::atomic_bool ok(true);
+
+  // ImageInput handles aren't safe to read from concurrently, so each band opens its own
+  QtConcurrent::blockingMap(bands, [this, &spec, &fn, subimage, dst, linesize, band_height, &ok](int y) {
+    auto in = OIIO::ImageInput::open(fn);
+    if (!in || !in->seek_subimage(subimage, 0)) {
+      ok = false;
+      return;
+    }
+
+    int yend = std::min(y + band_height, spec.height);
+    if (!in->read_scanlines(spec.y + y, spec.y + yend, 0, oiio_pix_fmt_,
+                            dst + int64_t(linesize) * y, OIIO::AutoStride, linesize)) {
+      ok = false;
+    }
+
+    in->close();
+  });
+
+  return ok;
+}
+
+void OIIODecoder::PrefetchNextImage(const QString &filename)
+{
+  if (!GetImageSequenceDigitCount(filename)) {
+    return;
+  }
+
+  QString next_fn = TransformImageSequenceFileName(filename, GetImageSequenceIndex(filename) + 1);
+
+  if (!QFileInfo::exists(next_fn)) {
+    return;
+  }
+
+  QtConcurrent::run([next_fn]{
+    // A sequential read is all it takes to land the file in the OS page cache
+    QFile f(next_fn);
+    if (f.open(QFile::ReadOnly)) {
+      char chunk[65536];
+      while (f.read(chunk, sizeof(chunk)) > 0) {}
+    }
+  });
+}
+
 void OIIODecoder::CloseImageHandle()
 {
   if (image_) {
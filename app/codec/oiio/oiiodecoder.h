@@ -56,6 +56,21 @@ private:
 
   void CloseImageHandle();
 
+  /**
+   * @brief Read the current image into buffer_ using several threads
+   *
+   * Splits the image into horizontal bands (aligned to tile boundaries for tiled formats like
+   * EXR) and reads them concurrently. Returns false if the image is too small to be worth
+   * parallelizing or a band read failed, in which case the caller should fall back to a single
+   * threaded read.
+   */
+  bool ReadImageParallel();
+
+  /**
+   * @brief If this file is part of an image sequence, warm the OS cache with the next frame
+   */
+  static void PrefetchNextImage(const QString& filename);
+
   static VideoParams GetVideoParamsFromImageSpec(const OIIO::ImageSpec &spec);
 
   PixelFormat pix_fmt_;
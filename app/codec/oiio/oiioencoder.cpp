@@ -20,12 +20,16 @@
 
 #include "oiioencoder.h"
 
+#include <QtConcurrent/QtConcurrent>
+
 #include "common/oiioutils.h"
 
 namespace olive {
 
 OIIOEncoder::OIIOEncoder(const EncodingParams &params) :
-  Encoder(params)
+  Encoder(params),
+  write_budget_(QThread::idealThreadCount() * 2),
+  write_failed_(false)
 {
 
 }
@@ -37,29 +41,50 @@ bool OIIOEncoder::Open()
 
 bool OIIOEncoder::WriteFrame(FramePtr frame, rational time)
 {
-  std::string filename = GetFilenameForFrame(time).toStdString();
-
-  auto output = OIIO::ImageOutput::create(filename);
-  if (!output) {
+  if (write_failed_) {
+    // A pooled write already failed and set the error, stop accepting frames
     return false;
   }
 
-  OIIO::TypeDesc type = OIIOUtils::GetOIIOBaseTypeFromFormat(frame->format());
-  OIIO::ImageSpec spec(frame->width(), frame->height(), frame->channel_count(), type);
+  QString filename = GetFilenameForFrame(time);
 
-  if (!output->open(filename, spec)) {
-    return false;
-  }
+  // Block here if too many frames are already queued so memory use stays bounded by the
+  // budget rather than growing with disk latency
+  write_budget_.acquire();
 
-  if (!output->write_image(type, frame->data(), OIIO::AutoStride, frame->linesize_bytes())) {
-    return false;
+#if QT_VERSION_MAJOR >= 6
+  QtConcurrent::run(&write_pool_, &OIIOEncoder::WriteImage, this, frame, filename);
+#else
+  QtConcurrent::run(&write_pool_, this, &OIIOEncoder::WriteImage, frame, filename);
+#endif
+
+  return true;
+}
+
+void OIIOEncoder::WriteImage(FramePtr frame, const QString &filename)
+{
+  bool success = false;
+  std::string std_filename = filename.toStdString();
+
+  auto output = OIIO::ImageOutput::create(std_filename);
+  if (output) {
+    OIIO::TypeDesc type = OIIOUtils::GetOIIOBaseTypeFromFormat(frame->format());
+    OIIO::ImageSpec spec(frame->width(), frame->height(), frame->channel_count(), type);
+
+    if (output->open(std_filename, spec)
+        && output->write_image(type, frame->data(), OIIO::AutoStride, frame->linesize_bytes())
+        && output->close()) {
+      success = true;
+    }
   }
 
-  if (!output->close()) {
-    return false;
+  if (!success) {
+    QMutexLocker locker(&write_error_mutex_);
+    SetError(tr("Failed to write image: %1").arg(filename));
+    write_failed_ = true;
   }
 
-  return true;
+  write_budget_.release();
 }
 
 bool OIIOEncoder::WriteAudio(const SampleBuffer &audio)
@@ -75,7 +100,8 @@ bool OIIOEncoder::WriteSubtitle(const SubtitleBlock *sub_block)
 
 void OIIOEncoder::Close()
 {
-  // Do nothing
+  // Wait for any in-flight image writes; failures are reported through GetError()
+  write_pool_.waitForDone();
 }
 
 }
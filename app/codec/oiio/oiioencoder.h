@@ -21,6 +21,11 @@
 #ifndef OIIOENCODER_H
 #define OIIOENCODER_H
 
+#include <atomic>
+#include <QMutex>
+#include <QSemaphore>
+#include <QThreadPool>
+
 #include "codec/encoder.h"
 
 namespace olive {
@@ -40,6 +45,22 @@ public slots:
 
   virtual void Close() override;
 
+private:
+  /**
+   * @brief Write one image file, used as the body of a pooled writer task
+   */
+  void WriteImage(FramePtr frame, const QString &filename);
+
+  // Since each frame of an image sequence is an independent file, writes are spread across a
+  // thread pool with a semaphore bounding how many frames can be in flight at once
+  QThreadPool write_pool_;
+
+  QSemaphore write_budget_;
+
+  QMutex write_error_mutex_;
+
+  std::atomic_bool write_failed_;
+
 };
 
 }
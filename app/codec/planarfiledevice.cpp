@@ -20,10 +20,54 @@
 
 #include "planarfiledevice.h"
 
+#include <cstdlib>
+
+#include <QDataStream>
+#include <QDebug>
+#include <QtEndian>
+
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "config/config.h"
+
 namespace olive {
 
+// File layout when compressed:
+//
+//   [magic][version][codec][block size]            <- header, see WriteCompressedHeader
+//   [u32 size][compressed bytes] ...               <- one entry per block
+//   [u32 count][u64 offset] ...                    <- block index, see WriteCompressedIndex
+//   [u64 raw size][u64 index offset][magic]        <- trailer
+//
+// Blocks that didn't shrink are stored raw with kStoredRawFlag set in their size prefix.
+static const quint32 kPlanarCompressedMagic = 0x4F565043; // "OVPC"
+static const quint32 kPlanarCompressedVersion = 1;
+static const quint32 kStoredRawFlag = 0x80000000;
+static const qint64 kDefaultBlockSize = 1 << 18; // 256 KiB of raw samples per block
+
+// O_DIRECT transfers must be multiples of the device sector size and aligned in memory
+static const qint64 kDirectAlignment = 4096;
+
 PlanarFileDevice::PlanarFileDevice(QObject *parent) :
-  QObject(parent)
+  QObject(parent),
+  codec_(kCodecRaw),
+  block_size_(kDefaultBlockSize),
+  raw_size_(0),
+  pos_(0),
+  cached_block_index_(-1),
+  direct_(false),
+  direct_bounce_(nullptr)
 {
 
 }
@@ -33,6 +77,58 @@ PlanarFileDevice::~PlanarFileDevice()
   close();
 }
 
+PlanarFileDevice::Codec PlanarFileDevice::GetConfiguredCodec()
+{
+  QString mode = OLIVE_CONFIG("ConformCompression").toString();
+
+#ifdef USE_ZSTD
+  if (mode == QStringLiteral("zstd")) {
+    return kCodecZstd;
+  }
+#endif
+
+#ifdef USE_LZ4
+  if (mode == QStringLiteral("lz4") || mode == QStringLiteral("zstd")) {
+    // Also the fallback if zstd was requested but not compiled in
+    return kCodecLZ4;
+  }
+#endif
+
+  return kCodecRaw;
+}
+
+bool PlanarFileDevice::UseDirectIO()
+{
+#ifdef Q_OS_LINUX
+  return Config::Cached().cache_direct_io;
+#else
+  return false;
+#endif
+}
+
+bool PlanarFileDevice::SetDirectFlag(int file, bool on)
+{
+#ifdef Q_OS_LINUX
+  int fd = files_[file]->handle();
+  int flags = fcntl(fd, F_GETFL);
+
+  if (flags == -1) {
+    return false;
+  }
+
+  if (on) {
+    flags |= O_DIRECT;
+  } else {
+    flags &= ~O_DIRECT;
+  }
+
+  return fcntl(fd, F_SETFL, flags) != -1;
+#else
+  Q_UNUSED(file)
+  return !on;
+#endif
+}
+
 bool PlanarFileDevice::open(const QVector<QString> &filenames, QIODevice::OpenMode mode)
 {
   if (isOpen()) {
@@ -40,12 +136,56 @@ bool PlanarFileDevice::open(const QVector<QString> &filenames, QIODevice::OpenMo
     return false;
   }
 
+  mode_ = mode;
+  codec_ = kCodecRaw;
+  raw_size_ = 0;
+  pos_ = 0;
+  cached_block_index_ = -1;
+  direct_ = false;
+
+  if (mode & QIODevice::WriteOnly) {
+    codec_ = GetConfiguredCodec();
+
+    // Direct I/O only applies to raw writes - compressed blocks go through the buffered path
+    direct_ = (codec_ == kCodecRaw) && UseDirectIO();
+  }
+
+  QIODevice::OpenMode open_mode = mode;
+  if (direct_) {
+    // Qt's internal write buffer would break the sector alignment O_DIRECT requires
+    open_mode |= QIODevice::Unbuffered;
+  }
+
   files_.resize(filenames.size());
   files_.fill(nullptr);
 
   for (int i=0; i<files_.size(); i++) {
     files_[i] = new QFile(filenames.at(i));
-    if (!files_[i]->open(mode)) {
+    if (!files_[i]->open(open_mode)) {
+      close();
+      return false;
+    }
+
+    if (direct_ && !SetDirectFlag(i, true)) {
+      // Filesystem doesn't support O_DIRECT, fall back to page-cached writes
+      for (int j=0; j<i; j++) {
+        SetDirectFlag(j, false);
+      }
+      direct_ = false;
+    }
+  }
+
+  if (mode & QIODevice::WriteOnly) {
+    if (codec_ != kCodecRaw) {
+      block_size_ = kDefaultBlockSize;
+      stage_.resize(files_.size());
+      block_offsets_.resize(files_.size());
+      WriteCompressedHeader();
+    } else if (direct_) {
+      direct_stage_.resize(files_.size());
+    }
+  } else {
+    if (!ReadCompressedHeader()) {
       close();
       return false;
     }
@@ -54,14 +194,129 @@ bool PlanarFileDevice::open(const QVector<QString> &filenames, QIODevice::OpenMo
   return true;
 }
 
+void PlanarFileDevice::WriteCompressedHeader()
+{
+  for (int i=0; i<files_.size(); i++) {
+    QDataStream s(files_[i]);
+    s << kPlanarCompressedMagic << kPlanarCompressedVersion << quint32(codec_) << quint64(block_size_);
+  }
+}
+
+bool PlanarFileDevice::ReadCompressedHeader()
+{
+  QFile *first = files_.first();
+
+  quint32 magic = 0;
+  {
+    QDataStream s(first);
+    s >> magic;
+  }
+
+  if (magic != kPlanarCompressedMagic) {
+    // Raw planar file written by an older version, read as-is
+    for (int i=0; i<files_.size(); i++) {
+      files_[i]->seek(0);
+    }
+    codec_ = kCodecRaw;
+    return true;
+  }
+
+  block_offsets_.resize(files_.size());
+  index_offsets_.resize(files_.size());
+  cached_blocks_.resize(files_.size());
+
+  for (int i=0; i<files_.size(); i++) {
+    QFile *f = files_[i];
+    f->seek(0);
+
+    QDataStream s(f);
+    quint32 version, codec;
+    quint64 block_size;
+    s >> magic >> version >> codec >> block_size;
+
+    if (magic != kPlanarCompressedMagic || version != kPlanarCompressedVersion) {
+      qWarning() << "Invalid compressed conform header in" << f->fileName();
+      return false;
+    }
+
+    // Trailer: raw size, index offset, magic
+    f->seek(f->size() - 20);
+    quint64 raw_size, index_offset;
+    quint32 trailer_magic;
+    QDataStream t(f);
+    t >> raw_size >> index_offset >> trailer_magic;
+
+    if (trailer_magic != kPlanarCompressedMagic) {
+      qWarning() << "Compressed conform" << f->fileName() << "has no trailer (interrupted write?)";
+      return false;
+    }
+
+    index_offsets_[i] = index_offset;
+
+    f->seek(index_offset);
+    QDataStream idx(f);
+    quint32 count;
+    idx >> count;
+    block_offsets_[i].resize(count);
+    for (quint32 j=0; j<count; j++) {
+      quint64 off;
+      idx >> off;
+      block_offsets_[i][j] = off;
+    }
+
+    codec_ = static_cast<Codec>(codec);
+    block_size_ = block_size;
+    raw_size_ = raw_size;
+  }
+
+#if !defined(USE_LZ4)
+  if (codec_ == kCodecLZ4) {
+    qWarning() << "Conform is LZ4-compressed but this build lacks LZ4 support";
+    return false;
+  }
+#endif
+#if !defined(USE_ZSTD)
+  if (codec_ == kCodecZstd) {
+    qWarning() << "Conform is Zstandard-compressed but this build lacks zstd support";
+    return false;
+  }
+#endif
+
+  return true;
+}
+
 qint64 PlanarFileDevice::read(char **data, qint64 bytes_per_channel, qint64 offset)
 {
   qint64 ret = -1;
 
   if (isOpen()) {
-    for (int i=0; i<files_.size(); i++) {
-      // Kind of clunky but should be largely fine
-      ret = files_[i]->read(data[i] + offset, bytes_per_channel);
+    if (codec_ == kCodecRaw) {
+      for (int i=0; i<files_.size(); i++) {
+        // Kind of clunky but should be largely fine
+        ret = files_[i]->read(data[i] + offset, bytes_per_channel);
+      }
+    } else {
+      qint64 to_read = qBound(qint64(0), bytes_per_channel, raw_size_ - pos_);
+
+      for (int i=0; i<files_.size(); i++) {
+        qint64 copied = 0;
+
+        while (copied < to_read) {
+          qint64 block = (pos_ + copied) / block_size_;
+          qint64 block_offset = (pos_ + copied) % block_size_;
+
+          if (!CacheBlock(i, block)) {
+            return -1;
+          }
+
+          qint64 chunk = qMin(to_read - copied, RawBlockSize(block) - block_offset);
+          memcpy(data[i] + offset + copied, cached_blocks_[i].constData() + block_offset, chunk);
+          copied += chunk;
+        }
+      }
+
+      pos_ += to_read;
+      ret = to_read;
     }
   }
 
@@ -73,18 +328,242 @@ qint64 PlanarFileDevice::write(const char **data, qint64 bytes_per_channel, qint
   qint64 ret = -1;
 
   if (isOpen()) {
-    for (int i=0; i<files_.size(); i++) {
-      // Kind of clunky but should be largely fine
-      ret = files_[i]->write(data[i] + offset, bytes_per_channel);
+    if (codec_ == kCodecRaw) {
+      if (direct_) {
+        for (int i=0; i<files_.size(); i++) {
+          direct_stage_[i].append(data[i] + offset, bytes_per_channel);
+          if (!FlushDirectStage(i, false)) {
+            return -1;
+          }
+        }
+        ret = bytes_per_channel;
+      } else {
+        for (int i=0; i<files_.size(); i++) {
+          // Kind of clunky but should be largely fine
+          ret = files_[i]->write(data[i] + offset, bytes_per_channel);
+        }
+      }
+    } else {
+      for (int i=0; i<files_.size(); i++) {
+        stage_[i].append(data[i] + offset, bytes_per_channel);
+      }
+
+      raw_size_ += bytes_per_channel;
+
+      if (!FlushStagedBlocks(false)) {
+        return -1;
+      }
+
+      ret = bytes_per_channel;
     }
   }
 
   return ret;
 }
 
+bool PlanarFileDevice::FlushDirectStage(int file, bool final)
+{
+#ifdef Q_OS_LINUX
+  QByteArray &stage = direct_stage_[file];
+
+  qint64 aligned = (stage.size() / kDirectAlignment) * kDirectAlignment;
+
+  if (aligned > 0) {
+    if (!direct_bounce_) {
+      direct_bounce_ = static_cast<char*>(aligned_alloc(kDirectAlignment, kDefaultBlockSize));
+    }
+
+    qint64 written = 0;
+    while (written < aligned) {
+      // Bounce through an aligned buffer since QByteArray makes no alignment guarantees
+      qint64 chunk = qMin(aligned - written, kDefaultBlockSize);
+      memcpy(direct_bounce_, stage.constData() + written, chunk);
+
+      if (files_[file]->write(direct_bounce_, chunk) != chunk) {
+        return false;
+      }
+
+      written += chunk;
+    }
+
+    stage.remove(0, aligned);
+  }
+
+  if (final && !stage.isEmpty()) {
+    // O_DIRECT can't write a partial sector - drop back to buffered for the unaligned tail
+    if (!SetDirectFlag(file, false)) {
+      return false;
+    }
+
+    if (files_[file]->write(stage) != stage.size()) {
+      return false;
+    }
+
+    stage.clear();
+  }
+
+  return true;
+#else
+  Q_UNUSED(file)
+  Q_UNUSED(final)
+  return false;
+#endif
+}
+
+bool PlanarFileDevice::FlushStagedBlocks(bool final)
+{
+  while (!stage_.first().isEmpty()
+         && (final || stage_.first().size() >= block_size_)) {
+    qint64 raw_len = qMin(qint64(stage_.first().size()), block_size_);
+
+    for (int i=0; i<files_.size(); i++) {
+      QByteArray compressed;
+
+#if defined(USE_LZ4)
+      if (codec_ == kCodecLZ4) {
+        compressed.resize(LZ4_compressBound(raw_len));
+        int len = LZ4_compress_default(stage_[i].constData(), compressed.data(), raw_len, compressed.size());
+        if (len <= 0) {
+          return false;
+        }
+        compressed.resize(len);
+      }
+#endif
+
+#if defined(USE_ZSTD)
+      if (codec_ == kCodecZstd) {
+        compressed.resize(ZSTD_compressBound(raw_len));
+        size_t len = ZSTD_compress(compressed.data(), compressed.size(), stage_[i].constData(), raw_len, ZSTD_CLEVEL_DEFAULT);
+        if (ZSTD_isError(len)) {
+          return false;
+        }
+        compressed.resize(len);
+      }
+#endif
+
+      block_offsets_[i].append(files_[i]->pos());
+
+      // Assemble the size prefix and payload into one transfer instead of two separate writes
+      const char *payload;
+      quint32 prefix;
+      qint64 payload_len;
+
+      if (compressed.isEmpty() || compressed.size() >= raw_len) {
+        // Compression didn't help, store the block raw
+        prefix = quint32(raw_len) | kStoredRawFlag;
+        payload = stage_[i].constData();
+        payload_len = raw_len;
+      } else {
+        prefix = quint32(compressed.size());
+        payload = compressed.constData();
+        payload_len = compressed.size();
+      }
+
+      QByteArray entry(sizeof(prefix) + payload_len, Qt::Uninitialized);
+      qToBigEndian(prefix, entry.data());
+      memcpy(entry.data() + sizeof(prefix), payload, payload_len);
+      files_[i]->write(entry);
+
+      stage_[i].remove(0, raw_len);
+    }
+  }
+
+  return true;
+}
+
+bool PlanarFileDevice::CacheBlock(int file, qint64 block)
+{
+  if (cached_block_index_ == block && !cached_blocks_[file].isEmpty()) {
+    return true;
+  }
+
+  if (block >= block_offsets_[file].size()) {
+    return false;
+  }
+
+  QFile *f = files_[file];
+  f->seek(block_offsets_[file][block]);
+
+  // The index tells us where the next entry starts, so the size prefix and payload can be
+  // fetched in a single transfer instead of two separate reads
+  qint64 next_offset = (block + 1 < block_offsets_[file].size()) ? block_offsets_[file][block + 1] : index_offsets_[file];
+  qint64 entry_size = next_offset - block_offsets_[file][block];
+
+  QByteArray entry = f->read(entry_size);
+  if (entry.size() != entry_size) {
+    return false;
+  }
+
+  quint32 stored_size = qFromBigEndian<quint32>(entry.constData());
+  const char *payload = entry.constData() + sizeof(stored_size);
+  qint64 payload_size = entry.size() - sizeof(stored_size);
+
+  qint64 raw_len = RawBlockSize(block);
+  cached_blocks_[file].resize(raw_len);
+
+  if (stored_size & kStoredRawFlag) {
+    if (payload_size < raw_len) {
+      return false;
+    }
+    memcpy(cached_blocks_[file].data(), payload, raw_len);
+  } else {
+    if (payload_size < qint64(stored_size)) {
+      return false;
+    }
+
+    bool ok = false;
+
+#if defined(USE_LZ4)
+    if (codec_ == kCodecLZ4) {
+      ok = LZ4_decompress_safe(payload, cached_blocks_[file].data(), stored_size, raw_len) == raw_len;
+    }
+#endif
+
+#if defined(USE_ZSTD)
+    if (codec_ == kCodecZstd) {
+      ok = ZSTD_decompress(cached_blocks_[file].data(), raw_len, payload, stored_size) == size_t(raw_len);
+    }
+#endif
+
+    if (!ok) {
+      qWarning() << "Failed to decompress conform block" << block << "of" << f->fileName();
+      return false;
+    }
+  }
+
+  if (file == files_.size() - 1) {
+    cached_block_index_ = block;
+  }
+
+  return true;
+}
+
+qint64 PlanarFileDevice::RawBlockSize(qint64 block) const
+{
+  return qMin(block_size_, raw_size_ - block * block_size_);
+}
+
+void PlanarFileDevice::WriteCompressedIndex()
+{
+  for (int i=0; i<files_.size(); i++) {
+    qint64 index_offset = files_[i]->pos();
+
+    QDataStream s(files_[i]);
+    s << quint32(block_offsets_[i].size());
+    foreach (qint64 off, block_offsets_[i]) {
+      s << quint64(off);
+    }
+
+    s << quint64(raw_size_) << quint64(index_offset) << kPlanarCompressedMagic;
+  }
+}
+
 qint64 PlanarFileDevice::size() const
 {
   if (isOpen()) {
+    if (codec_ != kCodecRaw) {
+      return raw_size_;
+    }
     return files_.first()->size();
   } else {
     return 0;
@@ -93,6 +572,11 @@ qint64 PlanarFileDevice::size() const
 
 bool PlanarFileDevice::seek(qint64 pos)
 {
+  if (codec_ != kCodecRaw) {
+    pos_ = pos;
+    return true;
+  }
+
   bool ret = true;
 
   for (int i=0; i<files_.size(); i++) {
@@ -104,6 +588,17 @@ bool PlanarFileDevice::seek(qint64 pos)
 
 void PlanarFileDevice::close()
 {
+  if (!files_.isEmpty() && codec_ != kCodecRaw && (mode_ & QIODevice::WriteOnly)) {
+    FlushStagedBlocks(true);
+    WriteCompressedIndex();
+  }
+
+  if (!files_.isEmpty() && direct_ && (mode_ & QIODevice::WriteOnly)) {
+    for (int i=0; i<files_.size(); i++) {
+      FlushDirectStage(i, true);
+    }
+  }
+
   for (int i=0; i<files_.size(); i++) {
     QFile *f = files_.at(i);
     if (f) {
@@ -114,6 +609,21 @@ void PlanarFileDevice::close()
     }
   }
   files_.clear();
+  block_offsets_.clear();
+  index_offsets_.clear();
+  stage_.clear();
+  cached_blocks_.clear();
+  codec_ = kCodecRaw;
+  raw_size_ = 0;
+  pos_ = 0;
+  cached_block_index_ = -1;
+
+  direct_ = false;
+  direct_stage_.clear();
+  if (direct_bounce_) {
+    free(direct_bounce_);
+    direct_bounce_ = nullptr;
+  }
 }
 
 }
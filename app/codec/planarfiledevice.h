@@ -33,6 +33,18 @@ class PlanarFileDevice : public QObject
 {
   Q_OBJECT
 public:
+  /**
+   * @brief Compression codec used for the on-disk planar data
+   *
+   * Files written compressed carry a small header/index so readers detect the codec
+   * automatically. Raw files written by older versions remain readable.
+   */
+  enum Codec {
+    kCodecRaw = 0,
+    kCodecLZ4 = 1,
+    kCodecZstd = 2
+  };
+
   PlanarFileDevice(QObject *parent = nullptr);
 
   virtual ~PlanarFileDevice() override;
@@ -55,8 +67,72 @@ public:
   void close();
 
 private:
+  /**
+   * @brief Determine the codec to use for newly written files from config/build options
+   */
+  static Codec GetConfiguredCodec();
+
+  /**
+   * @brief Whether newly written raw files should bypass the OS page cache (Linux O_DIRECT)
+   *
+   * Intended for dedicated cache drives, so large cache writes stop evicting the source media
+   * pages our decoders depend on.
+   */
+  static bool UseDirectIO();
+
+  bool SetDirectFlag(int file, bool on);
+
+  /**
+   * @brief Write all complete sectors of a channel's direct-mode stage, and the tail if final
+   */
+  bool FlushDirectStage(int file, bool final);
+
+  bool ReadCompressedHeader();
+
+  void WriteCompressedHeader();
+
+  void WriteCompressedIndex();
+
+  /**
+   * @brief Compress and append all complete (or, if final, partial) staged blocks
+   */
+  bool FlushStagedBlocks(bool final);
+
+  /**
+   * @brief Ensure cached_blocks_[file] holds the decompressed contents of `block`
+   */
+  bool CacheBlock(int file, qint64 block);
+
+  qint64 RawBlockSize(qint64 block) const;
+
   QVector<QFile*> files_;
 
+  Codec codec_;
+
+  qint64 block_size_;
+
+  // Logical (uncompressed) bytes per channel and read cursor, only used when compressed
+  qint64 raw_size_;
+  qint64 pos_;
+
+  QIODevice::OpenMode mode_;
+
+  // Per-file offsets of each compressed block's size prefix, and where the block data ends
+  QVector<QVector<qint64> > block_offsets_;
+  QVector<qint64> index_offsets_;
+
+  // Write-side staging buffers, one block's worth per channel
+  QVector<QByteArray> stage_;
+
+  // Read-side cache of the most recently decompressed block per channel
+  QVector<QByteArray> cached_blocks_;
+  qint64 cached_block_index_;
+
+  // O_DIRECT write state: per-channel staging to sector multiples and an aligned bounce buffer
+  bool direct_;
+  QVector<QByteArray> direct_stage_;
+  char *direct_bounce_;
+
 };
 
 }
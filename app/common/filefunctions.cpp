@@ -27,6 +27,13 @@
 #include <QFileInfo>
 #include <QStandardPaths>
 
+#ifdef Q_OS_WINDOWS
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include "config/config.h"
 
 namespace olive {
@@ -45,6 +52,10 @@ QString FileFunctions::GetUniqueFileIdentifier(const QString &filename)
 
   hash.addData(QString::number(info.lastModified().toMSecsSinceEpoch()).toUtf8());
 
+  // Include the size so an overwrite that preserves the timestamp (common over NFS, where
+  // attribute caching can also delay mtime updates) still produces a new identifier
+  hash.addData(QString::number(info.size()).toUtf8());
+
   QByteArray result = hash.result();
 
   return QString(result.toHex());
@@ -226,6 +237,48 @@ bool FileFunctions::RenameFileAllowOverwrite(const QString &from, const QString
   return true;
 }
 
+bool FileFunctions::HardLinkFileAllowOverwrite(const QString &source, const QString &dest)
+{
+  if (QFileInfo::exists(dest) && !QFile::remove(dest)) {
+    return false;
+  }
+
+#ifdef Q_OS_WINDOWS
+  return CreateHardLinkW(reinterpret_cast<const wchar_t*>(dest.utf16()),
+                         reinterpret_cast<const wchar_t*>(source.utf16()),
+                         nullptr);
+#else
+  return link(QFile::encodeName(source).constData(), QFile::encodeName(dest).constData()) == 0;
+#endif
+}
+
+QString FileFunctions::GetHardLinkIdentity(const QString &filename)
+{
+#ifdef Q_OS_WINDOWS
+  HANDLE file = CreateFileW(reinterpret_cast<const wchar_t*>(filename.utf16()), 0,
+                            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file != INVALID_HANDLE_VALUE) {
+    BY_HANDLE_FILE_INFORMATION info;
+    BOOL ok = GetFileInformationByHandle(file, &info);
+    CloseHandle(file);
+    if (ok) {
+      return QStringLiteral("%1:%2:%3").arg(QString::number(info.dwVolumeSerialNumber, 16),
+                                            QString::number(info.nFileIndexHigh, 16),
+                                            QString::number(info.nFileIndexLow, 16));
+    }
+  }
+#else
+  struct stat st;
+  if (stat(QFile::encodeName(filename).constData(), &st) == 0) {
+    return QStringLiteral("%1:%2").arg(QString::number(static_cast<qulonglong>(st.st_dev), 16),
+                                       QString::number(static_cast<qulonglong>(st.st_ino), 16));
+  }
+#endif
+
+  return filename;
+}
+
 QString FileFunctions::GetAutoRecoveryRoot()
 {
   return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath(QStringLiteral("autorecovery"));
@@ -85,6 +85,22 @@ public:
    */
   static bool RenameFileAllowOverwrite(const QString& from, const QString& to);
 
+  /**
+   * @brief Create a hard link at `dest` pointing to `source`'s data, overwriting `dest`
+   *
+   * Not all filesystems support hard links, so callers should treat failure as non-fatal and
+   * fall back to writing a full copy.
+   */
+  static bool HardLinkFileAllowOverwrite(const QString& source, const QString& dest);
+
+  /**
+   * @brief Identify the physical payload a path refers to, so hard links compare equal
+   *
+   * Returns the filename itself if the identity can't be determined (e.g. the file is gone),
+   * which degrades to path-based comparison.
+   */
+  static QString GetHardLinkIdentity(const QString& filename);
+
   inline static QString GetFormattedExecutableForPlatform(QString unformatted)
   {
 #ifdef Q_OS_WINDOWS
@@ -0,0 +1,86 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "interactiontracker.h"
+
+#include <algorithm>
+
+namespace olive {
+
+const int InteractionTracker::kMaxSamplesPerOperation;
+
+InteractionTracker *InteractionTracker::instance_ = nullptr;
+
+InteractionTracker::InteractionTracker(QObject *parent) :
+  QObject(parent)
+{
+}
+
+InteractionTracker *InteractionTracker::instance()
+{
+  if (!instance_) {
+    instance_ = new InteractionTracker();
+  }
+
+  return instance_;
+}
+
+void InteractionTracker::AddSample(const QString &operation, qint64 ms)
+{
+  QVector<qint64> &samples = samples_[operation];
+
+  samples.append(ms);
+  while (samples.size() > kMaxSamplesPerOperation) {
+    samples.removeFirst();
+  }
+}
+
+QMap<QString, InteractionTracker::Stats> InteractionTracker::GetStats()
+{
+  QMap<QString, Stats> stats;
+
+  for (auto it=samples_.constBegin(); it!=samples_.constEnd(); it++) {
+    QVector<qint64> sorted = it.value();
+    std::sort(sorted.begin(), sorted.end());
+
+    int n = sorted.size();
+    auto percentile = [&sorted, n](int p) {
+      return sorted.at(qMin(n - 1, n * p / 100));
+    };
+
+    Stats s;
+    s.count = n;
+    s.p50 = percentile(50);
+    s.p90 = percentile(90);
+    s.p99 = percentile(99);
+    s.max = sorted.last();
+
+    stats.insert(it.key(), s);
+  }
+
+  return stats;
+}
+
+void InteractionTracker::Clear()
+{
+  samples_.clear();
+}
+
+}
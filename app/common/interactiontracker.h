@@ -0,0 +1,83 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef INTERACTIONTRACKER_H
+#define INTERACTIONTRACKER_H
+
+#include <QHash>
+#include <QMap>
+#include <QObject>
+#include <QVector>
+
+namespace olive {
+
+/**
+ * @brief Records input-to-paint latency of editing interactions, grouped by operation type
+ *
+ * TimelineWidget times each committed interaction (block drag, ripple edit, razor cut, etc.)
+ * from the input event to the repaint that shows its result - the path through undo command
+ * construction, cache invalidation fan-out and compositing that the user actually perceives.
+ * GetStats() reports percentiles per operation so a regression can be filed as "ripple edit
+ * p99 went from 40 ms to 300 ms on this project" rather than "dragging feels slow".
+ *
+ * Samples are only ever added and read on the main thread.
+ */
+class InteractionTracker : public QObject
+{
+  Q_OBJECT
+public:
+  struct Stats {
+    qint64 count;
+    qint64 p50;
+    qint64 p90;
+    qint64 p99;
+    qint64 max;
+  };
+
+  static InteractionTracker *instance();
+
+  /**
+   * @brief Record one interaction of type `operation` that took `ms` from input to paint
+   */
+  void AddSample(const QString &operation, qint64 ms);
+
+  /**
+   * @brief Return latency percentiles per operation type
+   */
+  QMap<QString, Stats> GetStats();
+
+  void Clear();
+
+private:
+  explicit InteractionTracker(QObject *parent = nullptr);
+
+  static InteractionTracker *instance_;
+
+  // Percentiles are computed over the most recent samples so the numbers track the current
+  // project rather than everything since the application started
+  static const int kMaxSamplesPerOperation = 1024;
+
+  QHash<QString, QVector<qint64> > samples_;
+
+};
+
+}
+
+#endif // INTERACTIONTRACKER_H
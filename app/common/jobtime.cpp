@@ -1,11 +1,13 @@
 #include "jobtime.h"
 
-#include <QMutex>
+#include <atomic>
 
 namespace olive {
 
-uint64_t job_time_index = 0;
-QMutex job_time_mutex;
+// Process-wide generation counter. fetch_add hands every Acquire() a unique, monotonically
+// increasing value without a lock, so render threads stamping job times during graph
+// evaluation and copying never serialize on each other.
+std::atomic<uint64_t> job_time_index{0};
 
 JobTime::JobTime()
 {
@@ -14,12 +16,7 @@ JobTime::JobTime()
 
 void JobTime::Acquire()
 {
-  job_time_mutex.lock();
-
-  value_ = job_time_index;
-  job_time_index++;
-
-  job_time_mutex.unlock();
+  value_ = job_time_index.fetch_add(1, std::memory_order_relaxed);
 }
 
 }
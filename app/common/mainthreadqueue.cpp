@@ -0,0 +1,119 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "mainthreadqueue.h"
+
+#include <QDateTime>
+#include <QElapsedTimer>
+
+namespace olive {
+
+MainThreadQueue *MainThreadQueue::instance_ = nullptr;
+
+// Roughly a third of a 60fps frame, leaving the rest for event handling and painting
+const int MainThreadQueue::kFrameBudgetMs = 5;
+
+MainThreadQueue::MainThreadQueue() :
+  process_scheduled_(false),
+  stats_()
+{
+}
+
+void MainThreadQueue::CreateInstance()
+{
+  instance_ = new MainThreadQueue();
+}
+
+void MainThreadQueue::DestroyInstance()
+{
+  delete instance_;
+  instance_ = nullptr;
+}
+
+MainThreadQueue *MainThreadQueue::instance()
+{
+  return instance_;
+}
+
+void MainThreadQueue::Add(Job job)
+{
+  QMutexLocker locker(&mutex_);
+
+  queue_.push_back({std::move(job), QDateTime::currentMSecsSinceEpoch()});
+
+  if (!process_scheduled_) {
+    process_scheduled_ = true;
+
+    // Queued so that jobs added from the main thread still wait for the event loop rather than
+    // running reentrantly inside the caller
+    QMetaObject::invokeMethod(this, &MainThreadQueue::Process, Qt::QueuedConnection);
+  }
+}
+
+MainThreadQueue::LatencyStats MainThreadQueue::GetLatencyStats()
+{
+  QMutexLocker locker(&mutex_);
+
+  return stats_;
+}
+
+void MainThreadQueue::Process()
+{
+  QElapsedTimer budget;
+  budget.start();
+
+  QMutexLocker locker(&mutex_);
+
+  while (!queue_.empty()) {
+    QueuedJob j = std::move(queue_.front());
+    queue_.pop_front();
+
+    qint64 latency = QDateTime::currentMSecsSinceEpoch() - j.added;
+
+    static const qint64 kBucketLimits[kLatencyBucketCount - 1] = {1, 4, 16, 64, 256};
+    int bucket = 0;
+    while (bucket < kLatencyBucketCount - 1 && latency >= kBucketLimits[bucket]) {
+      bucket++;
+    }
+
+    stats_.total_jobs++;
+    stats_.histogram[bucket]++;
+    stats_.max_latency_ms = qMax(stats_.max_latency_ms, latency);
+
+    locker.unlock();
+
+    j.job();
+
+    locker.relock();
+
+    if (budget.elapsed() >= kFrameBudgetMs) {
+      break;
+    }
+  }
+
+  if (queue_.empty()) {
+    process_scheduled_ = false;
+  } else {
+    // Budget spent - yield to the event loop and resume on its next iteration
+    QMetaObject::invokeMethod(this, &MainThreadQueue::Process, Qt::QueuedConnection);
+  }
+}
+
+}
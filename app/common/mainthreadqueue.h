@@ -0,0 +1,106 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef MAINTHREADQUEUE_H
+#define MAINTHREADQUEUE_H
+
+#include <functional>
+#include <list>
+
+#include <QMutex>
+#include <QObject>
+
+namespace olive {
+
+/**
+ * @brief Runs deferred jobs on the main thread within a per-frame time budget
+ *
+ * Miscellaneous deferred work (cache writes, model updates, waveform merges) traditionally
+ * lands on the main thread through queued signals, where an arbitrary amount of it can run
+ * back-to-back and stall input handling. Jobs added here instead drain in budgeted slices:
+ * once kFrameBudgetMs of work has run, the queue yields to the event loop and resumes on the
+ * next iteration, so input events interleave with heavy bursts.
+ *
+ * Each job's queue latency (add to run) is recorded in a histogram retrievable with
+ * GetLatencyStats(), making main-thread responsiveness measurable - the profiler panel
+ * displays it.
+ *
+ * Add() is thread-safe; jobs always run on the main thread in the order they were added.
+ */
+class MainThreadQueue : public QObject
+{
+  Q_OBJECT
+public:
+  using Job = std::function<void()>;
+
+  static void CreateInstance();
+
+  static void DestroyInstance();
+
+  static MainThreadQueue *instance();
+
+  void Add(Job job);
+
+  static const int kLatencyBucketCount = 6;
+
+  struct LatencyStats {
+    /// Jobs that have finished running since startup
+    qint64 total_jobs;
+
+    /// Job count by queue latency: <1ms, <4ms, <16ms, <64ms, <256ms, >=256ms
+    qint64 histogram[kLatencyBucketCount];
+
+    /// Largest queue latency seen so far in milliseconds
+    qint64 max_latency_ms;
+  };
+
+  LatencyStats GetLatencyStats();
+
+private:
+  MainThreadQueue();
+
+  static const int kFrameBudgetMs;
+
+  struct QueuedJob {
+    Job job;
+    qint64 added;
+  };
+
+  static MainThreadQueue *instance_;
+
+  QMutex mutex_;
+
+  std::list<QueuedJob> queue_;
+
+  bool process_scheduled_;
+
+  LatencyStats stats_;
+
+private slots:
+  /**
+   * @brief Run queued jobs until the queue is empty or the frame budget is spent
+   */
+  void Process();
+
+};
+
+}
+
+#endif // MAINTHREADQUEUE_H
@@ -21,7 +21,9 @@
 #ifndef MEMORYPOOL_H
 #define MEMORYPOOL_H
 
+#include <atomic>
 #include <memory>
+#include <vector>
 #include <QApplication>
 #include <QDateTime>
 #include <QDebug>
@@ -210,6 +212,11 @@ public:
    * The pool itself does not store memory, it stores "arenas". This is so that the pool can handle the situation of
    * an arena becoming full with no more memory to lend. A pool can automatically allocate another arena and continue
    * providing memory (and freeing arenas when they're no longer in use).
+   *
+   * Get() and Release() are lock-free. Free slots are kept in an atomic stack of element indices,
+   * tagged with a generation counter so that a slot being released and re-acquired between another
+   * thread's read and compare-exchange can't corrupt the list (the classic ABA problem). Render
+   * threads acquiring and releasing buffers therefore never serialize against each other.
    */
   class Arena {
   public:
@@ -218,14 +225,18 @@ public:
       parent_ = parent;
       data_ = nullptr;
       allocated_sz_ = 0;
+      element_count_ = 0;
+      free_head_ = kFreeListEnd;
+      lent_count_ = 0;
       empty_time_ = QDateTime::currentMSecsSinceEpoch();
     }
 
     ~Arena()
     {
-      std::list<Element*> copy = lent_elements_;
-      foreach (Element* e, copy) {
-        e->release();
+      for (size_t i=0; i<lent_elements_.size(); i++) {
+        if (Element* e = lent_elements_[i].load(std::memory_order_acquire)) {
+          e->release();
+        }
       }
 
       delete [] data_;
@@ -238,22 +249,30 @@ public:
      */
     ElementPtr Get()
     {
-      QMutexLocker locker(&lock_);
+      uint64_t head = free_head_.load(std::memory_order_acquire);
+      uint32_t index;
 
-      for (int i=0;i<available_.size();i++) {
-        if (available_.at(i)) {
-          // This buffer is available
-          available_.replace(i, false);
+      do {
+        index = GetFreeListIndex(head);
 
-          ElementPtr e = std::make_shared<Element>(this,
-                                                   reinterpret_cast<uint8_t*>(data_ + i * element_sz_));
-          lent_elements_.push_back(e.get());
-
-          return e;
+        if (index == kFreeListEnd) {
+          // Arena is full
+          return nullptr;
         }
-      }
 
-      return nullptr;
+        // If another thread pops this slot before our compare-exchange, the exchange fails (the
+        // generation tag changed) and we retry with the fresh head
+      } while (!free_head_.compare_exchange_weak(head,
+                                                 MakeFreeListHead(next_free_[index].load(std::memory_order_relaxed), head),
+                                                 std::memory_order_acquire,
+                                                 std::memory_order_acquire));
+
+      ElementPtr e = std::make_shared<Element>(this,
+                                               reinterpret_cast<uint8_t*>(data_ + index * element_sz_));
+      lent_elements_[index].store(e.get(), std::memory_order_release);
+      lent_count_.fetch_add(1, std::memory_order_relaxed);
+
+      return e;
     }
 
     /**
@@ -261,24 +280,28 @@ public:
      */
     void Release(Element* e)
     {
-      QMutexLocker locker(&lock_);
       quintptr diff = reinterpret_cast<quintptr>(e->data()) - reinterpret_cast<quintptr>(data_);
 
-      int index = diff / element_sz_;
+      uint32_t index = diff / element_sz_;
 
-      available_.replace(index, true);
+      lent_elements_[index].store(nullptr, std::memory_order_relaxed);
 
-      lent_elements_.remove(e);
+      uint64_t head = free_head_.load(std::memory_order_relaxed);
+      do {
+        next_free_[index].store(GetFreeListIndex(head), std::memory_order_relaxed);
+      } while (!free_head_.compare_exchange_weak(head,
+                                                 MakeFreeListHead(index, head),
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed));
 
-      if (lent_elements_.empty()) {
-        empty_time_ = QDateTime::currentMSecsSinceEpoch();
+      if (lent_count_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        empty_time_.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_relaxed);
       }
     }
 
     int GetUsageCount()
     {
-      QMutexLocker locker(&lock_);
-      return lent_elements_.size();
+      return lent_count_.load(std::memory_order_relaxed);
     }
 
     bool Allocate(size_t ele_sz, size_t nb_elements)
@@ -292,12 +315,20 @@ public:
       allocated_sz_ = element_sz_ * nb_elements;
 
       if ((data_ = new uint8_t[allocated_sz_])) {
-        available_.resize(nb_elements);
-        available_.fill(true);
+        element_count_ = nb_elements;
+
+        // Chain every slot into the free stack, starting from index 0
+        next_free_ = std::vector< std::atomic<uint32_t> >(nb_elements);
+        lent_elements_ = std::vector< std::atomic<Element*> >(nb_elements);
+        for (size_t i=0; i<nb_elements; i++) {
+          next_free_[i].store((i + 1 == nb_elements) ? kFreeListEnd : uint32_t(i + 1), std::memory_order_relaxed);
+          lent_elements_[i].store(nullptr, std::memory_order_relaxed);
+        }
+        free_head_.store(nb_elements ? 0 : uint64_t(kFreeListEnd), std::memory_order_release);
 
         return true;
       } else {
-        available_.clear();
+        element_count_ = 0;
 
         return false;
       }
@@ -305,7 +336,7 @@ public:
 
     inline int GetElementCount() const
     {
-      return available_.size();
+      return element_count_;
     }
 
     inline bool IsAllocated() const
@@ -315,26 +346,56 @@ public:
 
     inline qint64 GetTimeArenaWasMadeEmpty()
     {
-      QMutexLocker locker(&lock_);
-      return empty_time_;
+      return empty_time_.load(std::memory_order_relaxed);
     }
 
   private:
+    static const uint32_t kFreeListEnd = 0xFFFFFFFF;
+
+    /**
+     * @brief Extracts the slot index from a tagged free list head
+     */
+    static inline uint32_t GetFreeListIndex(uint64_t head)
+    {
+      return uint32_t(head);
+    }
+
+    /**
+     * @brief Builds a new head from a slot index, incrementing the previous head's generation tag
+     */
+    static inline uint64_t MakeFreeListHead(uint32_t index, uint64_t prev_head)
+    {
+      return uint64_t(index) | (((prev_head >> 32) + 1) << 32);
+    }
+
     MemoryPool* parent_;
 
     uint8_t* data_;
 
     size_t allocated_sz_;
 
-    QVector<bool> available_;
-
-    QMutex lock_;
+    size_t element_count_;
 
     size_t element_sz_;
 
-    std::list<Element*> lent_elements_;
+    /**
+     * @brief Tagged head of the free slot stack - low 32 bits index, high 32 bits generation
+     */
+    std::atomic<uint64_t> free_head_;
+
+    /**
+     * @brief Per-slot link to the next free slot, only traversed through free_head_
+     */
+    std::vector< std::atomic<uint32_t> > next_free_;
+
+    /**
+     * @brief Per-slot pointer to the element currently lent out, null while the slot is free
+     */
+    std::vector< std::atomic<Element*> > lent_elements_;
+
+    std::atomic<int> lent_count_;
 
-    qint64 empty_time_;
+    std::atomic<qint64> empty_time_;
 
   };
 
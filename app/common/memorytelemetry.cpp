@@ -0,0 +1,102 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "memorytelemetry.h"
+
+namespace olive {
+
+MemoryTelemetry *MemoryTelemetry::instance_ = nullptr;
+
+MemoryTelemetry::MemoryTelemetry(QObject *parent) :
+  QObject(parent)
+{
+}
+
+MemoryTelemetry *MemoryTelemetry::instance()
+{
+  static QMutex instance_mutex;
+  QMutexLocker locker(&instance_mutex);
+
+  if (!instance_) {
+    // Created lazily because sources register from whichever subsystem initializes first
+    instance_ = new MemoryTelemetry();
+  }
+
+  return instance_;
+}
+
+void MemoryTelemetry::RegisterSource(const QString &name, std::function<qint64()> getter)
+{
+  QMutexLocker locker(&mutex_);
+
+  for (int i=0; i<sources_.size(); i++) {
+    if (sources_.at(i).name == name) {
+      sources_[i].getter = std::move(getter);
+      return;
+    }
+  }
+
+  sources_.append({name, std::move(getter), 0});
+}
+
+void MemoryTelemetry::UnregisterSource(const QString &name)
+{
+  QMutexLocker locker(&mutex_);
+
+  for (int i=0; i<sources_.size(); i++) {
+    if (sources_.at(i).name == name) {
+      sources_.removeAt(i);
+      return;
+    }
+  }
+}
+
+QVector<MemoryTelemetry::Snapshot> MemoryTelemetry::Poll()
+{
+  QMutexLocker locker(&mutex_);
+
+  QVector<Snapshot> snapshots;
+  snapshots.reserve(sources_.size());
+
+  for (int i=0; i<sources_.size(); i++) {
+    Source &s = sources_[i];
+
+    qint64 current = s.getter();
+
+    if (current > s.peak) {
+      s.peak = current;
+    }
+
+    snapshots.append({s.name, current, s.peak});
+  }
+
+  return snapshots;
+}
+
+void MemoryTelemetry::ResetPeaks()
+{
+  QMutexLocker locker(&mutex_);
+
+  for (int i=0; i<sources_.size(); i++) {
+    sources_[i].peak = 0;
+  }
+}
+
+}
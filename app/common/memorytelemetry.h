@@ -0,0 +1,98 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef MEMORYTELEMETRY_H
+#define MEMORYTELEMETRY_H
+
+#include <functional>
+#include <QMutex>
+#include <QObject>
+#include <QVector>
+
+namespace olive {
+
+/**
+ * @brief Central registry of how much memory each pool/cache subsystem is holding
+ *
+ * The frame buffer pool, frame memory cache, renderer texture pools and disk cache folders
+ * each track their own usage but there was previously no single place to see them together,
+ * which made "why is RSS 30GB" questions a debugger exercise. Subsystems register a named
+ * byte-count getter here when they initialize; the memory panel polls the registry to show
+ * live totals and high-water marks.
+ *
+ * This is a pull model: getters must be cheap (an atomic load or a short mutex-guarded sum)
+ * and safe to call from the main thread at any time. High-water marks are observed at polling
+ * resolution, so short spikes between polls can be missed - they're meant to show sustained
+ * peaks, not exact maxima.
+ */
+class MemoryTelemetry : public QObject
+{
+  Q_OBJECT
+public:
+  struct Snapshot {
+    QString name;
+    qint64 current;
+    qint64 peak;
+  };
+
+  static MemoryTelemetry *instance();
+
+  /**
+   * @brief Register a named source whose getter returns its current usage in bytes
+   *
+   * Names must be unique; registering an existing name replaces its getter but keeps the
+   * recorded peak.
+   */
+  void RegisterSource(const QString &name, std::function<qint64()> getter);
+
+  /**
+   * @brief Remove a source, e.g. when the subsystem that owns the getter is destroyed
+   */
+  void UnregisterSource(const QString &name);
+
+  /**
+   * @brief Sample every source, update high-water marks and return the results
+   *
+   * Sources are returned in registration order.
+   */
+  QVector<Snapshot> Poll();
+
+  void ResetPeaks();
+
+private:
+  explicit MemoryTelemetry(QObject *parent = nullptr);
+
+  struct Source {
+    QString name;
+    std::function<qint64()> getter;
+    qint64 peak;
+  };
+
+  static MemoryTelemetry *instance_;
+
+  QMutex mutex_;
+
+  QVector<Source> sources_;
+
+};
+
+}
+
+#endif // MEMORYTELEMETRY_H
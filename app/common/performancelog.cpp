@@ -0,0 +1,250 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "performancelog.h"
+
+#include <algorithm>
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace olive {
+
+PerformanceLog *PerformanceLog::instance_ = nullptr;
+
+static const quint32 kPerfLogMagic = 0x4F56504C; // "OVPL"
+static const quint32 kPerfLogVersion = 1;
+static const int kFlushIntervalMs = 60000;
+
+PerformanceLog::PerformanceLog() :
+  cache_hits_(0),
+  cache_misses_(0),
+  dropped_frames_(0)
+{
+}
+
+bool PerformanceLog::Open(const QString &filename)
+{
+  Close();
+
+  PerformanceLog *pl = new PerformanceLog();
+
+  pl->file_.setFileName(filename);
+  if (!pl->file_.open(QFile::WriteOnly)) {
+    delete pl;
+    return false;
+  }
+
+  QDataStream ds(&pl->file_);
+  ds << kPerfLogMagic << kPerfLogVersion;
+
+  pl->flush_timer_.setInterval(kFlushIntervalMs);
+  connect(&pl->flush_timer_, &QTimer::timeout, pl, &PerformanceLog::Flush);
+  pl->flush_timer_.start();
+
+  instance_ = pl;
+
+  return true;
+}
+
+void PerformanceLog::Close()
+{
+  if (instance_) {
+    PerformanceLog *pl = instance_;
+
+    // Clear the instance first so no new events arrive during the final flush
+    instance_ = nullptr;
+
+    pl->Flush();
+    pl->file_.close();
+    delete pl;
+  }
+}
+
+void PerformanceLog::RecordTicketLatency(qint64 ms)
+{
+  QMutexLocker locker(&mutex_);
+
+  ticket_latencies_.append(qint32(ms));
+}
+
+void PerformanceLog::RecordDecodeTime(const QString &decoder, qint64 ms)
+{
+  QMutexLocker locker(&mutex_);
+
+  DecodeStats &stats = decode_stats_[decoder];
+  stats.count++;
+  stats.total_ms += ms;
+  stats.max_ms = qMax(stats.max_ms, qint32(ms));
+}
+
+void PerformanceLog::RecordCacheQuery(bool hit)
+{
+  QMutexLocker locker(&mutex_);
+
+  if (hit) {
+    cache_hits_++;
+  } else {
+    cache_misses_++;
+  }
+}
+
+void PerformanceLog::RecordDroppedFrame()
+{
+  QMutexLocker locker(&mutex_);
+
+  dropped_frames_++;
+}
+
+void PerformanceLog::Flush()
+{
+  QMutexLocker locker(&mutex_);
+
+  if (ticket_latencies_.isEmpty() && decode_stats_.isEmpty()
+      && cache_hits_ == 0 && cache_misses_ == 0 && dropped_frames_ == 0) {
+    // Nothing happened this minute - idle sessions don't need records
+    return;
+  }
+
+  QDataStream ds(&file_);
+
+  ds << qint64(QDateTime::currentMSecsSinceEpoch());
+
+  // Ticket latency percentiles
+  std::sort(ticket_latencies_.begin(), ticket_latencies_.end());
+  int n = ticket_latencies_.size();
+  auto percentile = [this, n](int p) {
+    return n ? ticket_latencies_.at(qMin(n - 1, n * p / 100)) : qint32(0);
+  };
+  ds << quint32(n) << percentile(50) << percentile(90) << percentile(99)
+     << (n ? ticket_latencies_.last() : qint32(0));
+
+  // Decode stats per decoder
+  ds << quint32(decode_stats_.size());
+  for (auto it=decode_stats_.cbegin(); it!=decode_stats_.cend(); it++) {
+    ds << it.key() << it->count << it->total_ms << it->max_ms;
+  }
+
+  ds << cache_hits_ << cache_misses_ << dropped_frames_;
+
+  file_.flush();
+
+  ticket_latencies_.clear();
+  decode_stats_.clear();
+  cache_hits_ = 0;
+  cache_misses_ = 0;
+  dropped_frames_ = 0;
+}
+
+bool PerformanceLog::ExportJson(const QString &log_filename, const QString &json_filename)
+{
+  QFile log_file(log_filename);
+  if (!log_file.open(QFile::ReadOnly)) {
+    qWarning() << "Failed to open performance log:" << log_filename;
+    return false;
+  }
+
+  QDataStream ds(&log_file);
+
+  quint32 magic, version;
+  ds >> magic >> version;
+
+  if (magic != kPerfLogMagic || version != kPerfLogVersion) {
+    qWarning() << "Unrecognized performance log:" << log_filename;
+    return false;
+  }
+
+  QJsonArray records;
+
+  while (!log_file.atEnd()) {
+    qint64 timestamp;
+    quint32 ticket_count;
+    qint32 p50, p90, p99, max;
+
+    ds >> timestamp >> ticket_count >> p50 >> p90 >> p99 >> max;
+
+    QJsonObject record;
+    record.insert(QStringLiteral("time"), QDateTime::fromMSecsSinceEpoch(timestamp).toString(Qt::ISODate));
+
+    QJsonObject tickets;
+    tickets.insert(QStringLiteral("count"), qint64(ticket_count));
+    tickets.insert(QStringLiteral("p50_ms"), p50);
+    tickets.insert(QStringLiteral("p90_ms"), p90);
+    tickets.insert(QStringLiteral("p99_ms"), p99);
+    tickets.insert(QStringLiteral("max_ms"), max);
+    record.insert(QStringLiteral("tickets"), tickets);
+
+    quint32 decoder_count;
+    ds >> decoder_count;
+
+    QJsonObject decoders;
+    for (quint32 i=0; i<decoder_count; i++) {
+      QString decoder;
+      quint32 count;
+      qint64 total_ms;
+      qint32 max_ms;
+
+      ds >> decoder >> count >> total_ms >> max_ms;
+
+      QJsonObject d;
+      d.insert(QStringLiteral("count"), qint64(count));
+      d.insert(QStringLiteral("avg_ms"), count ? double(total_ms) / double(count) : 0.0);
+      d.insert(QStringLiteral("max_ms"), max_ms);
+      decoders.insert(decoder, d);
+    }
+    record.insert(QStringLiteral("decoders"), decoders);
+
+    quint32 hits, misses, dropped;
+    ds >> hits >> misses >> dropped;
+
+    QJsonObject cache;
+    cache.insert(QStringLiteral("hits"), qint64(hits));
+    cache.insert(QStringLiteral("misses"), qint64(misses));
+    record.insert(QStringLiteral("cache"), cache);
+
+    record.insert(QStringLiteral("dropped_frames"), qint64(dropped));
+
+    if (ds.status() != QDataStream::Ok) {
+      qWarning() << "Performance log ended mid-record, exporting what was read";
+      break;
+    }
+
+    records.append(record);
+  }
+
+  QJsonObject root;
+  root.insert(QStringLiteral("records"), records);
+
+  QFile json_file(json_filename);
+  if (!json_file.open(QFile::WriteOnly)) {
+    qWarning() << "Failed to write JSON:" << json_filename;
+    return false;
+  }
+
+  json_file.write(QJsonDocument(root).toJson());
+
+  return true;
+}
+
+}
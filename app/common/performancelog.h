@@ -0,0 +1,119 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef PERFORMANCELOG_H
+#define PERFORMANCELOG_H
+
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+namespace olive {
+
+/**
+ * @brief Opt-in rolling log of per-minute render performance aggregates
+ *
+ * When an editor reports slowness we can't reproduce, a session recorded with --perf-log gives
+ * the escalation actual numbers: interactive ticket latency percentiles, decode time per
+ * decoder, the playback cache hit rate and dropped frame counts, aggregated per minute.
+ *
+ * Records are written as compact binary (a few hundred bytes per minute, so a full day's
+ * session stays small) and converted to JSON with --export-perf-log for reading.
+ *
+ * Recording costs one mutex-guarded append per event, and like TraceRecorder the instance is
+ * null unless recording was requested, so the hooks are a single pointer check when disabled.
+ */
+class PerformanceLog : public QObject
+{
+  Q_OBJECT
+public:
+  /**
+   * @brief Start recording to the given file, returns false if it couldn't be created
+   */
+  static bool Open(const QString &filename);
+
+  static void Close();
+
+  static PerformanceLog *instance()
+  {
+    return instance_;
+  }
+
+  /**
+   * @brief Record the request-to-completion latency of an interactive render ticket
+   *
+   * Thread-safe, as are the other Record functions.
+   */
+  void RecordTicketLatency(qint64 ms);
+
+  /**
+   * @brief Record one decode call against the decoder that served it
+   */
+  void RecordDecodeTime(const QString &decoder, qint64 ms);
+
+  /**
+   * @brief Record whether a playback frame request was served from the disk cache
+   */
+  void RecordCacheQuery(bool hit);
+
+  void RecordDroppedFrame();
+
+  /**
+   * @brief Convert a binary performance log to JSON
+   */
+  static bool ExportJson(const QString &log_filename, const QString &json_filename);
+
+private:
+  PerformanceLog();
+
+  /**
+   * @brief Aggregate the current bucket into one binary record and reset it
+   */
+  void Flush();
+
+  struct DecodeStats {
+    quint32 count;
+    qint64 total_ms;
+    qint32 max_ms;
+  };
+
+  static PerformanceLog *instance_;
+
+  QFile file_;
+
+  QMutex mutex_;
+
+  QTimer flush_timer_;
+
+  // Current minute's bucket, all guarded by mutex_
+  QVector<qint32> ticket_latencies_;
+  QHash<QString, DecodeStats> decode_stats_;
+  quint32 cache_hits_;
+  quint32 cache_misses_;
+  quint32 dropped_frames_;
+
+};
+
+}
+
+#endif // PERFORMANCELOG_H
@@ -0,0 +1,101 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "tracerecorder.h"
+
+#include <QCoreApplication>
+#include <QThread>
+
+namespace olive {
+
+TraceRecorder *TraceRecorder::instance_ = nullptr;
+
+bool TraceRecorder::Open(const QString &filename)
+{
+  Q_ASSERT(!instance_);
+
+  TraceRecorder *recorder = new TraceRecorder();
+
+  recorder->file_.setFileName(filename);
+  if (!recorder->file_.open(QFile::WriteOnly | QFile::Truncate)) {
+    qWarning() << "Failed to open trace file" << filename;
+    delete recorder;
+    return false;
+  }
+
+  recorder->file_.write("[\n");
+  recorder->first_event_ = true;
+  recorder->timer_.start();
+
+  instance_ = recorder;
+
+  return true;
+}
+
+void TraceRecorder::Close()
+{
+  if (!instance_) {
+    return;
+  }
+
+  instance_->file_.write("\n]\n");
+  instance_->file_.close();
+
+  delete instance_;
+  instance_ = nullptr;
+}
+
+void TraceRecorder::BeginEvent(const char *category, const QString &name)
+{
+  WriteEvent('B', category, name);
+}
+
+void TraceRecorder::EndEvent(const char *category, const QString &name)
+{
+  WriteEvent('E', category, name);
+}
+
+void TraceRecorder::WriteEvent(char phase, const char *category, const QString &name)
+{
+  // Minimal JSON string escaping - names here are node labels, task titles and filenames
+  QString escaped = name;
+  escaped.replace(QLatin1Char('\\'), QStringLiteral("\\\\"));
+  escaped.replace(QLatin1Char('"'), QStringLiteral("\\\""));
+
+  QString event = QStringLiteral("{\"ph\":\"%1\",\"cat\":\"%2\",\"name\":\"%3\",\"pid\":%4,\"tid\":%5,\"ts\":%6}")
+      .arg(QChar::fromLatin1(phase),
+           QString::fromLatin1(category),
+           escaped,
+           QString::number(QCoreApplication::applicationPid()),
+           QString::number(reinterpret_cast<quintptr>(QThread::currentThreadId())),
+           QString::number(timer_.nsecsElapsed() / 1000));
+
+  QMutexLocker locker(&mutex_);
+
+  if (first_event_) {
+    first_event_ = false;
+  } else {
+    file_.write(",\n");
+  }
+
+  file_.write(event.toUtf8());
+}
+
+}
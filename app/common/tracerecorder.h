@@ -0,0 +1,92 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+
+namespace olive {
+
+/**
+ * @brief Optional recorder writing Chrome trace-event JSON for pipeline profiling
+ *
+ * When enabled with --trace <file> on the command line, tasks, render tickets and decoder
+ * calls log begin/end spans here. The resulting file loads into about:tracing or Perfetto,
+ * showing how decode, render and encode work overlaps across threads - the quickest way to
+ * see what a pipeline stall is actually waiting on.
+ *
+ * Spans pair up by thread, so BeginEvent() and EndEvent() must be called from the same thread.
+ * instance() is null when tracing is disabled; call sites check it so disabled runs cost one
+ * pointer load. Open() and Close() are only called during application startup and shutdown,
+ * after worker threads have been joined, so call sites don't need to guard against the
+ * instance disappearing mid-span.
+ */
+class TraceRecorder
+{
+public:
+  /**
+   * @brief Start recording to the given file, returns false if it couldn't be created
+   */
+  static bool Open(const QString &filename);
+
+  static void Close();
+
+  static TraceRecorder *instance()
+  {
+    return instance_;
+  }
+
+  /**
+   * @brief Record the start of a span on the calling thread
+   *
+   * This function is thread-safe.
+   */
+  void BeginEvent(const char *category, const QString &name);
+
+  /**
+   * @brief Record the end of the calling thread's most recent open span
+   *
+   * This function is thread-safe.
+   */
+  void EndEvent(const char *category, const QString &name);
+
+private:
+  TraceRecorder() = default;
+
+  void WriteEvent(char phase, const char *category, const QString &name);
+
+  static TraceRecorder *instance_;
+
+  QFile file_;
+
+  QMutex mutex_;
+
+  QElapsedTimer timer_;
+
+  bool first_event_;
+
+};
+
+}
+
+#endif // TRACERECORDER_H
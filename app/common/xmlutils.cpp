@@ -20,6 +20,8 @@
 
 #include "xmlutils.h"
 
+#include <QSet>
+
 #include "node/block/block.h"
 #include "node/factory.h"
 
@@ -42,4 +44,19 @@ bool XMLReadNextStartElement(QXmlStreamReader *reader, CancelAtom *cancel_atom)
   return false;
 }
 
+QString XMLInternString(const QString &str)
+{
+  // Serializers run on the main thread (paste) as well as load threads, so keep a pool per
+  // thread rather than sharing one behind a lock
+  static thread_local QSet<QString> pool;
+
+  auto it = pool.find(str);
+
+  if (it == pool.end()) {
+    it = pool.insert(str);
+  }
+
+  return *it;
+}
+
 }
@@ -48,6 +48,20 @@ class NodeGroup;
  */
 bool XMLReadNextStartElement(QXmlStreamReader* reader, CancelAtom *cancel_atom = nullptr);
 
+/**
+ * @brief Return a shared copy of an identifier that recurs throughout a project file
+ *
+ * Node IDs, input names and the like appear once per node/keyframe in a project file, so naively
+ * calling toString() on each one allocates a fresh heap string per occurrence even though only a
+ * handful of distinct values exist. Passing them through this function instead makes every
+ * repeated identifier share one storage, cutting both load-time allocations and the steady-state
+ * memory of string-heavy projects.
+ *
+ * Only use this for strings drawn from a small fixed vocabulary - the pool holds a reference to
+ * every distinct string it's ever seen on this thread.
+ */
+QString XMLInternString(const QString &str);
+
 }
 
 #endif // XMLREADLOOP_H
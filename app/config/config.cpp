@@ -40,6 +40,7 @@
 namespace olive {
 
 Config Config::current_config_;
+Config::CachedEntries Config::cached_;
 
 Config::Config()
 {
@@ -72,7 +73,11 @@ void Config::SetDefaults()
   SetEntryInternal(QStringLiteral("AutorecoveryEnabled"), NodeValue::kBoolean, true);
   SetEntryInternal(QStringLiteral("AutorecoveryInterval"), NodeValue::kInt, 1);
   SetEntryInternal(QStringLiteral("AutorecoveryMaximum"), NodeValue::kInt, 20);
+  SetEntryInternal(QStringLiteral("UndoLimit"), NodeValue::kInt, 200);
   SetEntryInternal(QStringLiteral("DiskCacheSaveInterval"), NodeValue::kInt, 10000);
+
+  // Base URL of a shared HTTP render cache (see RemoteCache); empty disables it
+  SetEntryInternal(QStringLiteral("SharedCacheUrl"), NodeValue::kText, QString());
   SetEntryInternal(QStringLiteral("Language"), NodeValue::kText, QString());
   SetEntryInternal(QStringLiteral("ScrollZooms"), NodeValue::kBoolean, false);
   SetEntryInternal(QStringLiteral("EnableSeekToImport"), NodeValue::kBoolean, false);
@@ -105,6 +110,16 @@ void Config::SetDefaults()
   SetEntryInternal(QStringLiteral("ReassocLinToNonLin"), NodeValue::kBoolean, false);
   SetEntryInternal(QStringLiteral("PreviewNonFloatDontAskAgain"), NodeValue::kBoolean, false);
   SetEntryInternal(QStringLiteral("UseGLFinish"), NodeValue::kBoolean, false);
+  SetEntryInternal(QStringLiteral("RenderBackend"), NodeValue::kText, QStringLiteral("opengl"));
+  SetEntryInternal(QStringLiteral("RenderProfiler"), NodeValue::kBoolean, false);
+  SetEntryInternal(QStringLiteral("SeparateCacheContext"), NodeValue::kBoolean, false);
+  SetEntryInternal(QStringLiteral("AdaptivePlaybackQuality"), NodeValue::kBoolean, true);
+  SetEntryInternal(QStringLiteral("BakedColorTransforms"), NodeValue::kBoolean, false);
+  SetEntryInternal(QStringLiteral("ConformCompression"), NodeValue::kText, QStringLiteral("lz4"));
+  SetEntryInternal(QStringLiteral("CacheDirectIO"), NodeValue::kBoolean, false);
+  SetEntryInternal(QStringLiteral("HardwareDecoding"), NodeValue::kBoolean, true);
+  SetEntryInternal(QStringLiteral("MemoryCacheLimit"), NodeValue::kInt, 1073741824); // 1 GB
+  SetEntryInternal(QStringLiteral("GpuMemoryBudget"), NodeValue::kInt, 2147483648LL); // 2 GB, 0 = unlimited
 
   SetEntryInternal(QStringLiteral("TimelineThumbnailMode"), NodeValue::kInt, Timeline::kThumbnailInOut);
   SetEntryInternal(QStringLiteral("TimelineWaveformMode"), NodeValue::kInt, Timeline::kWaveformsEnabled);
@@ -164,6 +179,21 @@ void Config::SetDefaults()
   SetEntryInternal(QStringLiteral("OfflinePixelFormat"), NodeValue::kInt, PixelFormat::F16);
 
   SetEntryInternal(QStringLiteral("MarkerColor"), NodeValue::kInt, ColorCoding::kLime);
+
+  RefreshCache();
+}
+
+void Config::RefreshCache()
+{
+  cached_.use_gl_finish = current_config_[QStringLiteral("UseGLFinish")].toBool();
+  cached_.reassoc_lin_to_nonlin = current_config_[QStringLiteral("ReassocLinToNonLin")].toBool();
+  cached_.render_profiler = current_config_[QStringLiteral("RenderProfiler")].toBool();
+  cached_.rectified_waveforms = current_config_[QStringLiteral("RectifiedWaveforms")].toBool();
+  cached_.baked_color_transforms = current_config_[QStringLiteral("BakedColorTransforms")].toBool();
+  cached_.cache_direct_io = current_config_[QStringLiteral("CacheDirectIO")].toBool();
+  cached_.hardware_decoding = current_config_[QStringLiteral("HardwareDecoding")].toBool();
+  cached_.memory_cache_limit = current_config_[QStringLiteral("MemoryCacheLimit")].toLongLong();
+  cached_.gpu_memory_budget = current_config_[QStringLiteral("GpuMemoryBudget")].toLongLong();
 }
 
 void Config::Load()
@@ -243,6 +273,8 @@ void Config::Load()
   }
 
   config_file.close();
+
+  RefreshCache();
 }
 
 void Config::Save()
@@ -48,6 +48,41 @@ public:
 
   NodeValue::Type GetConfigEntryType(const QString& key) const;
 
+  /**
+   * @brief Typed snapshot of the settings hot paths consult per frame or per buffer
+   *
+   * operator[] costs a QString-keyed map lookup plus a QVariant conversion, which is fine for
+   * UI code but not for settings read on every frame, buffer or texture allocation. These
+   * fields are plain loads. They're refreshed from the map by RefreshCache(), so the map
+   * itself only needs to be touched by the settings UI.
+   */
+  struct CachedEntries {
+    bool use_gl_finish;
+    bool reassoc_lin_to_nonlin;
+    bool render_profiler;
+    bool rectified_waveforms;
+    bool baked_color_transforms;
+    bool cache_direct_io;
+    bool hardware_decoding;
+    qint64 memory_cache_limit;
+    qint64 gpu_memory_budget;
+  };
+
+  static const CachedEntries& Cached()
+  {
+    return cached_;
+  }
+
+  /**
+   * @brief Re-read the cached entries from the map
+   *
+   * Called after defaults are set, after the config file loads and after the settings UI
+   * applies changes (ConfigDialogBase::accept). The fields are trivially-copyable scalars, so
+   * a render thread reading concurrently sees either the old or the new value of a setting,
+   * which is fine for everything cached here.
+   */
+  static void RefreshCache();
+
 private:
   Config();
 
@@ -62,6 +97,8 @@ private:
 
   static Config current_config_;
 
+  static CachedEntries cached_;
+
   static QString GetConfigFilePath();
 };
 
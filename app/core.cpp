@@ -23,21 +23,27 @@
 #include <QApplication>
 #include <QClipboard>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QHBoxLayout>
 #include <QInputDialog>
 #include <QMessageBox>
 #include <QStyleFactory>
+#include <QtConcurrent/QtConcurrent>
 #include "window/mainwindow/mainwindowundo.h"
 #ifdef Q_OS_WINDOWS
 #include <QtPlatformHeaders/QWindowsWindowFunctions>
 #endif
 
 #include "audio/audiomanager.h"
-#include "cli/clitask/clitaskdialog.h"
+#include "cli/clibenchmark/clibenchmarkmanager.h"
+#include "cli/cliexport/cliexportmanager.h"
+#include "cli/clifixture/clifixturemanager.h"
 #include "codec/conformmanager.h"
 #include "common/filefunctions.h"
+#include "common/mainthreadqueue.h"
+#include "common/memorytelemetry.h"
 #include "common/xmlutils.h"
 #include "config/config.h"
 #include "dialog/about/about.h"
@@ -59,7 +65,13 @@
 #include "panel/project/project.h"
 #include "panel/viewer/viewer.h"
 #include "render/diskmanager.h"
+#include "render/framehashcache.h"
 #include "render/framemanager.h"
+#include "render/framememorycache.h"
+#include "render/projectcopier.h"
+#ifdef USE_QT_NETWORK
+#include "render/remotecache.h"
+#endif
 #include "render/rendermanager.h"
 #ifdef USE_OTIO
 #include "task/project/loadotio/loadotio.h"
@@ -85,6 +97,10 @@ Core* Core::instance_ = nullptr;
 Core::Core(const CoreParams& params) :
   main_window_(nullptr),
   open_project_(nullptr),
+  save_copier_(nullptr),
+  active_autorecovery_task_(nullptr),
+  active_save_task_(nullptr),
+  active_save_task_source_(nullptr),
   tool_(Tool::kPointer),
   addable_object_(Tool::kAddableEmpty),
   snapping_(true),
@@ -125,37 +141,99 @@ void Core::DeclareTypesForQt()
   qRegisterMetaType<olive::RenderTicketPtr>();
 }
 
+namespace {
+
+// Wall clock since Core::Start began, shared with StartGUI for the time-to-window figure
+QElapsedTimer startup_timer;
+
+/**
+ * @brief Run a startup phase, logging its duration so cold-start regressions show up in the log
+ *
+ * Spans also go to TraceRecorder when tracing is on, so startup can be inspected on the same
+ * timeline as render work.
+ */
+template <typename Func>
+void TimeStartupPhase(const QString &name, Func f)
+{
+  if (TraceRecorder *trace = TraceRecorder::instance()) {
+    trace->BeginEvent("startup", name);
+  }
+
+  qint64 start = startup_timer.elapsed();
+
+  f();
+
+  qInfo().noquote() << QStringLiteral("Startup: %1 took %2 ms").arg(name).arg(startup_timer.elapsed() - start);
+
+  if (TraceRecorder *trace = TraceRecorder::instance()) {
+    trace->EndEvent("startup", name);
+  }
+}
+
+}
+
 void Core::Start()
 {
-  // Load application config
-  Config::Load();
+  startup_timer.start();
 
-  // Set locale based on either startup arg, config, or auto-detect
-  SetStartupLocale();
+  TimeStartupPhase(QStringLiteral("config and locale"), [this]{
+    // Load application config
+    Config::Load();
 
-  // Declare custom types for Qt signal/slot system
-  DeclareTypesForQt();
+    // Set locale based on either startup arg, config, or auto-detect
+    SetStartupLocale();
 
-  // Set up node factory/library
-  NodeFactory::Initialize();
+    // Declare custom types for Qt signal/slot system
+    DeclareTypesForQt();
+  });
 
-  // Set up color manager's default config
+  TimeStartupPhase(QStringLiteral("node factory"), []{
+    // Set up node factory/library
+    NodeFactory::Initialize();
+  });
+
+  // Start loading the color manager's default config on a worker - anything color-managed
+  // blocks on the result in ColorManager::GetDefaultConfig() if it's not ready yet
   ColorManager::SetUpDefaultConfig();
 
-  // Initialize task manager
-  TaskManager::CreateInstance();
+  // The throughput benchmark isolates scheduler/traversal cost from GPU and codec variance, so
+  // force the no-op render backend before RenderManager reads the config below. The previous
+  // value is restored afterwards so it isn't written back to the user's config on exit. The
+  // interactive workload benchmark deliberately keeps the real backend - its whole point is to
+  // measure the end-to-end path including codec and upload cost.
+  QString saved_render_backend;
+  if (core_params_.run_mode() == CoreParams::kHeadlessBenchmark && core_params_.benchmark_workload().isEmpty()) {
+    saved_render_backend = OLIVE_CONFIG("RenderBackend").toString();
+    OLIVE_CONFIG("RenderBackend") = QStringLiteral("dummy");
+  }
+
+  TimeStartupPhase(QStringLiteral("managers"), []{
+    // Initialize main thread job queue
+    MainThreadQueue::CreateInstance();
+
+    // Initialize task manager
+    TaskManager::CreateInstance();
 
-  // Initialize ConformManager
-  ConformManager::CreateInstance();
+    // Initialize ConformManager
+    ConformManager::CreateInstance();
 
-  // Initialize RenderManager
-  RenderManager::CreateInstance();
+    // Initialize RenderManager
+    RenderManager::CreateInstance();
 
-  // Initialize FrameManager
-  FrameManager::CreateInstance();
+    // Initialize FrameManager
+    FrameManager::CreateInstance();
 
-  // Initialize project serializers
-  ProjectSerializer::Initialize();
+    // FrameMemoryCache is all-static, so its telemetry source is registered here
+    MemoryTelemetry::instance()->RegisterSource(QStringLiteral("Frame memory cache"),
+                                                &FrameMemoryCache::GetConsumption);
+
+    // Initialize project serializers
+    ProjectSerializer::Initialize();
+  });
+
+  if (core_params_.run_mode() == CoreParams::kHeadlessBenchmark && core_params_.benchmark_workload().isEmpty()) {
+    OLIVE_CONFIG("RenderBackend") = saved_render_backend;
+  }
 
   //
   // Start application
@@ -172,11 +250,32 @@ void Core::Start()
     QMetaObject::invokeMethod(this, "OpenStartupProject", Qt::QueuedConnection);
     break;
   case CoreParams::kHeadlessExport:
-    qInfo() << "Headless export is not fully implemented yet";
+  {
+    bool ret = StartHeadlessExport();
+
+    // Quit once the export (or farm job) is done
+    QMetaObject::invokeMethod(qApp, "exit", Qt::QueuedConnection, Q_ARG(int, ret ? 0 : 1));
     break;
+  }
   case CoreParams::kHeadlessPreCache:
     qInfo() << "Headless pre-cache is not fully implemented yet";
     break;
+  case CoreParams::kHeadlessBenchmark:
+  {
+    bool ret = StartHeadlessBenchmark();
+
+    // Quit once the benchmark is done
+    QMetaObject::invokeMethod(qApp, "exit", Qt::QueuedConnection, Q_ARG(int, ret ? 0 : 1));
+    break;
+  }
+  case CoreParams::kHeadlessFixture:
+  {
+    bool ret = StartHeadlessFixtureGenerator();
+
+    // Quit once the fixtures are generated
+    QMetaObject::invokeMethod(qApp, "exit", Qt::QueuedConnection, Q_ARG(int, ret ? 0 : 1));
+    break;
+  }
   }
 
   // Manual crash triggering
@@ -213,10 +312,16 @@ void Core::Stop()
 
   TaskManager::DestroyInstance();
 
+  MainThreadQueue::DestroyInstance();
+
   PanelManager::DestroyInstance();
 
   AudioManager::DestroyInstance();
 
+#ifdef USE_QT_NETWORK
+  RemoteCache::DestroyInstance();
+#endif
+
   DiskManager::DestroyInstance();
 
   NodeFactory::Destroy();
@@ -496,6 +601,8 @@ bool Core::AddOpenProjectFromTask(Task *task, bool add_to_recents)
       AddOpenProject(project, add_to_recents);
       main_window_->LoadLayout(load_task->GetLoadedLayout());
 
+      PrefetchProjectCaches(project);
+
       return true;
     } else {
       delete project;
@@ -512,6 +619,18 @@ void Core::SetActiveProject(Project *p)
     disconnect(open_project_, &Project::ModifiedChanged, this, &Core::ProjectWasModified);
   }
 
+  // Re-point the save copier at the new project. If a worker thread is still serializing the
+  // old copy, that copier must not be touched - orphan it for the task to finish with and
+  // start a fresh one.
+  if (save_copier_ && (active_autorecovery_task_ || active_save_task_)) {
+    stale_save_copiers_.append(save_copier_);
+    save_copier_ = nullptr;
+  }
+  if (!save_copier_) {
+    save_copier_ = new ProjectCopier(this);
+  }
+  save_copier_->SetProject(p);
+
   open_project_ = p;
   RenderManager::instance()->SetProject(p);
   main_window_->SetProject(p);
@@ -521,6 +640,65 @@ void Core::SetActiveProject(Project *p)
   }
 }
 
+void Core::PrefetchProjectCaches(Project *project)
+{
+  // Replay the disk cache catalog now rather than on the first frame access
+  DiskManager::instance()->GetOpenFolder(project->cache_path());
+
+  // Collect the files the first playback is likely to need
+  QStringList frames_to_preload;
+  QStringList segments_to_touch;
+
+  foreach (Node *node, project->nodes()) {
+    if (Sequence *sequence = dynamic_cast<Sequence*>(node)) {
+      FrameHashCache *frame_cache = sequence->video_frame_cache();
+      const rational &timebase = frame_cache->GetTimebase();
+
+      if (!timebase.isNull()) {
+        // Preload a couple of seconds of cached frames from the playhead
+        static const int kPrefetchFrameCount = 48;
+
+        rational t = sequence->GetPlayhead();
+        for (int i = 0; i < kPrefetchFrameCount; i++, t += timebase) {
+          QString fn = frame_cache->GetValidCacheFilename(t);
+          if (!fn.isEmpty()) {
+            frames_to_preload.append(fn);
+          }
+        }
+      }
+
+      // Touch the PCM segments so the audio thread's first reads come from the OS page cache
+      QDir audio_dir = sequence->audio_playback_cache()->GetThisCacheDirectory();
+      foreach (const QFileInfo &segment, audio_dir.entryInfoList(QDir::Files)) {
+        segments_to_touch.append(segment.absoluteFilePath());
+      }
+    }
+  }
+
+  if (frames_to_preload.isEmpty() && segments_to_touch.isEmpty()) {
+    return;
+  }
+
+  // Do the actual reads off the main thread - playback will find the frames already decoded in
+  // the memory cache and the audio segments already paged in
+  QtConcurrent::run([frames_to_preload, segments_to_touch]{
+    foreach (const QString &fn, frames_to_preload) {
+      if (FramePtr frame = FrameHashCache::LoadCacheFrame(fn)) {
+        FrameMemoryCache::Push(fn, frame);
+      }
+    }
+
+    foreach (const QString &fn, segments_to_touch) {
+      QFile f(fn);
+      if (f.open(QFile::ReadOnly)) {
+        static const qint64 kSegmentTouchSize = 1 << 20;
+        f.read(kSegmentTouchSize);
+        f.close();
+      }
+    }
+  });
+}
+
 void Core::ImportTaskComplete(Task* task)
 {
   ProjectImportTask* import_task = static_cast<ProjectImportTask*>(task);
@@ -602,90 +780,35 @@ void Core::ProjectWasModified(bool e)
 
 bool Core::StartHeadlessExport()
 {
-  const QString& startup_project = core_params_.startup_project();
-
-  if (startup_project.isEmpty()) {
-    qCritical().noquote() << tr("You must specify a project file to export");
-    return false;
-  }
+  CLIExportManager manager;
 
-  if (!QFileInfo::exists(startup_project)) {
-    qCritical().noquote() << tr("Specified project does not exist");
-    return false;
+  if (!core_params_.export_queue().isEmpty()) {
+    return manager.RunQueue(core_params_.export_queue());
   }
 
-  // Start a load task and try running it
-  ProjectLoadTask plm(startup_project);
-  CLITaskDialog task_dialog(&plm);
-
-  /*
-  if (task_dialog.Run()) {
-    std::unique_ptr<Project> p = std::unique_ptr<Project>(plm.GetLoadedProject());
-    QVector<Item*> items = p->get_items_of_type(Item::kSequence);
+  manager.SetPreset(core_params_.export_preset());
 
-    // Check if this project contains sequences
-    if (items.isEmpty()) {
-      qCritical().noquote() << tr("Project contains no sequences, nothing to export");
-      return false;
-    }
-
-    Sequence* sequence = nullptr;
-
-    // Check if this project contains multiple sequences
-    if (items.size() > 1) {
-      qInfo().noquote() << tr("This project has multiple sequences. Which do you wish to export?");
-      for (int i=0;i<items.size();i++) {
-        std::cout << "[" << i << "] " << items.at(i)->GetLabel().toStdString();
-      }
-
-      QTextStream stream(stdin);
-      QString sequence_read;
-      int sequence_index = -1;
-      QString quit_code = QStringLiteral("q");
-      std::string prompt = tr("Enter number (or %1 to cancel): ").arg(quit_code).toStdString();
-      forever {
-        std::cout << prompt;
-
-        stream.readLineInto(&sequence_read);
-
-        if (!QString::compare(sequence_read, quit_code, Qt::CaseInsensitive)) {
-          return false;
-        }
-
-        bool ok;
-        sequence_index = sequence_read.toInt(&ok);
-
-        if (ok && sequence_index >= 0 && sequence_index < items.size()) {
-          break;
-        } else {
-          qCritical().noquote() << tr("Invalid sequence number");
-        }
-      }
+  if (core_params_.farm_join()) {
+    manager.SetJoin(core_params_.farm_count());
+  } else if (core_params_.farm_count() > 1) {
+    manager.SetWorker(core_params_.farm_worker(), core_params_.farm_count());
+  }
 
-      sequence = static_cast<Sequence*>(items.at(sequence_index));
-    } else {
-      sequence = static_cast<Sequence*>(items.first());
-    }
+  return manager.Run(core_params_.startup_project());
+}
 
-    ExportParams params;
-    ExportTask export_task(sequence->viewer_output(), p->color_manager(), params);
-    CLITaskDialog export_dialog(&export_task);
-    if (export_dialog.Run()) {
-      qInfo().noquote() << tr("Export succeeded");
-      return true;
-    } else {
-      qInfo().noquote() << tr("Export failed: %1").arg(export_task.GetError());
-      return false;
-    }
-  } else {
-    qCritical().noquote() << tr("Project failed to load: %1").arg(plm.GetError());
-    return false;
-  }
-  */
+bool Core::StartHeadlessBenchmark()
+{
+  CLIBenchmarkManager manager;
 
+  return manager.Run(core_params_.startup_project(), core_params_.benchmark_workload());
+}
 
+bool Core::StartHeadlessFixtureGenerator()
+{
+  CLIFixtureManager manager;
 
-  return false;
+  return manager.Run(core_params_.fixture_output(), core_params_.fixture_spec());
 }
 
 void Core::OpenStartupProject()
@@ -733,20 +856,27 @@ void Core::AddRecoveryProjectFromTask(Task *task)
 
 void Core::StartGUI(bool full_screen)
 {
-  // Set UI style
-  StyleManager::Init();
+  TimeStartupPhase(QStringLiteral("ui style and services"), []{
+    // Set UI style
+    StyleManager::Init();
 
-  // Set up shared menus
-  MenuShared::CreateInstance();
+    // Set up shared menus
+    MenuShared::CreateInstance();
 
-  // Since we're starting GUI mode, create a PanelFocusManager (auto-deletes with QObject)
-  PanelManager::CreateInstance();
+    // Since we're starting GUI mode, create a PanelFocusManager (auto-deletes with QObject)
+    PanelManager::CreateInstance();
 
-  // Initialize audio service
-  AudioManager::CreateInstance();
+    // Initialize audio service
+    AudioManager::CreateInstance();
 
-  // Initialize disk service
-  DiskManager::CreateInstance();
+    // Initialize disk service (cache indexes load in the background, see DiskCacheFolder)
+    DiskManager::CreateInstance();
+
+#ifdef USE_QT_NETWORK
+    // Initialize shared render cache tier (no-op unless a URL is configured)
+    RemoteCache::CreateInstance();
+#endif
+  });
 
   // Connect the PanelFocusManager to the application's focus change signal
   connect(qApp,
@@ -765,13 +895,17 @@ void Core::StartGUI(bool full_screen)
   config.setAbsoluteWidgetMinSize(QSize(1, 1));
 
   // Create main window and open it
-  main_window_ = new MainWindow();
+  TimeStartupPhase(QStringLiteral("main window"), [this, full_screen]{
+    main_window_ = new MainWindow();
 
-  if (full_screen) {
-    main_window_->showFullScreen();
-  } else {
-    main_window_->showMaximized();
-  }
+    if (full_screen) {
+      main_window_->showFullScreen();
+    } else {
+      main_window_->showMaximized();
+    }
+  });
+
+  qInfo().noquote() << QStringLiteral("Startup: time to window %1 ms").arg(startup_timer.elapsed());
 
 #ifdef Q_OS_WINDOWS
   // Workaround for Qt bug where menus don't appear in full screen mode
@@ -816,6 +950,27 @@ void Core::SaveProjectInternal(const QString& override_filename)
 #endif
   } else {
     bool use_compression = !open_project_->filename().endsWith(QStringLiteral(".ovexml"), Qt::CaseInsensitive);
+
+    // Standard saves serialize the background copy on a worker thread like autorecovery does,
+    // so large projects don't stall the GUI for the whole save. Syncing the copy is
+    // proportional to how much the user edited since the last sync, not to project size. Only
+    // one task may read the copy at a time, so if a save is already in flight we fall back to
+    // the synchronous path below rather than touching the copy under it.
+    if (override_filename.isEmpty() && save_copier_ && !active_autorecovery_task_ && !active_save_task_) {
+      save_copier_->ProcessUpdateQueue();
+
+      ProjectSaveTask *task = new ProjectSaveTask(save_copier_->GetCopiedProject(), use_compression);
+      task->SetOverrideFilename(open_project_->filename());
+      task->SetLayout(main_window_->SaveLayout());
+
+      active_save_task_ = task;
+      active_save_task_source_ = open_project_;
+      connect(task, &Task::Finished, this, &Core::BackgroundProjectSaveFinished);
+      TaskManager::instance()->AddTask(task);
+
+      return;
+    }
+
     psm = new ProjectSaveTask(open_project_, use_compression);
     static_cast<ProjectSaveTask*>(psm)->SetLayout(main_window_->SaveLayout());
 
@@ -825,15 +980,12 @@ void Core::SaveProjectInternal(const QString& override_filename)
     }
   }
 
-  // We don't use a TaskDialog here because a model save dialog is annoying, particularly when
-  // saving auto-recoveries that the user can't anticipate. Doing this in the main thread will
-  // cause a brief (but often unnoticeable) pause in the GUI, which, while not ideal, is not that
-  // different from what already happened (modal dialog preventing use of the GUI) and in many ways
-  // less annoying (doesn't disrupt any current actions or pull focus from elsewhere).
-  //
-  // Ideally we could do this in a background thread and show progress in the status bar like
-  // Microsoft Word, but that would be far more complex. If it becomes necessary in the future,
-  // we will look into an approach like that.
+  // Synchronous fallback (OTIO saves, override filenames and saves racing another save task).
+  // We don't use a TaskDialog here because a modal save dialog is annoying. Doing this in the
+  // main thread will cause a brief (but often unnoticeable) pause in the GUI, which, while not
+  // ideal, is not that different from what already happened (modal dialog preventing use of the
+  // GUI) and in many ways less annoying (doesn't disrupt any current actions or pull focus from
+  // elsewhere).
   if (psm->Start()) {
     if (override_filename.isEmpty()) {
       ProjectSaveSucceeded(psm);
@@ -955,12 +1107,24 @@ void Core::SaveRecentProjectsList()
 void Core::SaveAutorecovery()
 {
   if (OLIVE_CONFIG("AutorecoveryEnabled").toBool()) {
-    if (open_project_ && !open_project_->has_autorecovery_been_saved()) {
+    if (open_project_ && !open_project_->has_autorecovery_been_saved() && !active_autorecovery_task_ && !active_save_task_) {
       QDir project_autorecovery_dir(QDir(FileFunctions::GetAutoRecoveryRoot()).filePath(open_project_->GetUuid().toString()));
       if (FileFunctions::DirectoryIsValid(project_autorecovery_dir)) {
         QString this_autorecovery_path = project_autorecovery_dir.filePath(QStringLiteral("%1.ove").arg(QString::number(QDateTime::currentSecsSinceEpoch())));
 
-        SaveProjectInternal(this_autorecovery_path);
+        // Apply whatever changed since the last sync to our background copy. This is
+        // proportional to how much the user edited, not to project size, and is the main
+        // thread's only contribution - serialization and disk I/O happen on a worker thread
+        // reading the copy. Edits made during the save queue up in the copier for next time.
+        save_copier_->ProcessUpdateQueue();
+
+        ProjectSaveTask *task = new ProjectSaveTask(save_copier_->GetCopiedProject(), true);
+        task->SetOverrideFilename(this_autorecovery_path);
+        task->SetLayout(main_window_->SaveLayout());
+
+        active_autorecovery_task_ = task;
+        connect(task, &Task::Finished, this, &Core::AutorecoverySaveFinished);
+        TaskManager::instance()->AddTask(task);
 
         open_project_->set_autorecovery_saved(true);
 
@@ -969,7 +1133,7 @@ void Core::SaveAutorecovery()
           autorecovered_projects_.append(open_project_->GetUuid());
         }
 
-        qDebug() << "Saved auto-recovery to:" << this_autorecovery_path;
+        qDebug() << "Saving auto-recovery to:" << this_autorecovery_path;
 
         // Write human-readable real name so it's not just a UUID
         {
@@ -1020,6 +1184,63 @@ void Core::SaveAutorecovery()
   }
 }
 
+void Core::AutorecoverySaveFinished(Task *task, bool succeeded)
+{
+  if (task == active_autorecovery_task_) {
+    active_autorecovery_task_ = nullptr;
+
+    // Any copiers orphaned by a project switch during the save can be freed once nothing is
+    // reading their copies anymore
+    if (!active_save_task_) {
+      qDeleteAll(stale_save_copiers_);
+      stale_save_copiers_.clear();
+    }
+  }
+
+  if (!succeeded) {
+    qWarning() << "Failed to save auto-recovery:" << task->GetError();
+  }
+}
+
+void Core::BackgroundProjectSaveFinished(Task *task, bool succeeded)
+{
+  if (task == active_save_task_) {
+    active_save_task_ = nullptr;
+
+    if (!active_autorecovery_task_) {
+      qDeleteAll(stale_save_copiers_);
+      stale_save_copiers_.clear();
+    }
+  }
+
+  if (succeeded) {
+    // Only mutate the source project if it's still the one that's open. The pointer is never
+    // dereferenced otherwise - the project may have been closed during the save, which is safe
+    // because the task was reading an independent copy.
+    if (open_project_ && open_project_ == active_save_task_source_) {
+      PushRecentlyOpenedProject(open_project_->filename());
+
+      // Edits made during the save are still unsaved - they queued up in the copier and will
+      // go out with the next save
+      if (!save_copier_->HasUpdatesInQueue()) {
+        open_project_->set_modified(false);
+      }
+
+      autorecovered_projects_.removeOne(open_project_->GetUuid());
+      SaveUnrecoveredList();
+
+      ShowStatusBarMessage(tr("Saved to \"%1\" successfully").arg(open_project_->filename()));
+    }
+  } else {
+    QMessageBox::critical(main_window_,
+                          tr("Error"),
+                          tr("Failed to save project: %1").arg(task->GetError()),
+                          QMessageBox::Ok);
+  }
+
+  active_save_task_source_ = nullptr;
+}
+
 void Core::ProjectSaveSucceeded(Task* task)
 {
   Project* p = static_cast<ProjectSaveTask*>(task)->GetProject();
@@ -1635,7 +1856,10 @@ void Core::OpenProject()
 Core::CoreParams::CoreParams() :
   mode_(kRunNormal),
   run_fullscreen_(false),
-  crash_(false)
+  crash_(false),
+  farm_worker_(-1),
+  farm_count_(0),
+  farm_join_(false)
 {
 }
 
@@ -38,6 +38,7 @@
 namespace olive {
 
 class MainWindow;
+class ProjectCopier;
 
 /**
  * @brief The main central Olive application instance
@@ -60,7 +61,9 @@ public:
     enum RunMode {
       kRunNormal,
       kHeadlessExport,
-      kHeadlessPreCache
+      kHeadlessPreCache,
+      kHeadlessBenchmark,
+      kHeadlessFixture
     };
 
     bool fullscreen() const
@@ -113,6 +116,86 @@ public:
       crash_ = true;
     }
 
+    const QString& export_preset() const
+    {
+      return export_preset_;
+    }
+
+    void set_export_preset(const QString& p)
+    {
+      export_preset_ = p;
+    }
+
+    const QString& export_queue() const
+    {
+      return export_queue_;
+    }
+
+    void set_export_queue(const QString& p)
+    {
+      export_queue_ = p;
+    }
+
+    int farm_worker() const
+    {
+      return farm_worker_;
+    }
+
+    void set_farm_worker(int index)
+    {
+      farm_worker_ = index;
+    }
+
+    int farm_count() const
+    {
+      return farm_count_;
+    }
+
+    void set_farm_count(int count)
+    {
+      farm_count_ = count;
+    }
+
+    bool farm_join() const
+    {
+      return farm_join_;
+    }
+
+    void set_farm_join(bool e)
+    {
+      farm_join_ = e;
+    }
+
+    const QString& fixture_output() const
+    {
+      return fixture_output_;
+    }
+
+    void set_fixture_output(const QString& p)
+    {
+      fixture_output_ = p;
+    }
+
+    const QString& fixture_spec() const
+    {
+      return fixture_spec_;
+    }
+
+    void set_fixture_spec(const QString& s)
+    {
+      fixture_spec_ = s;
+    }
+
+    const QString& benchmark_workload() const
+    {
+      return benchmark_workload_;
+    }
+
+    void set_benchmark_workload(const QString& w)
+    {
+      benchmark_workload_ = w;
+    }
+
   private:
     RunMode mode_;
 
@@ -124,6 +207,22 @@ public:
 
     bool crash_;
 
+    QString export_preset_;
+
+    QString export_queue_;
+
+    int farm_worker_;
+
+    int farm_count_;
+
+    bool farm_join_;
+
+    QString fixture_output_;
+
+    QString fixture_spec_;
+
+    QString benchmark_workload_;
+
   };
 
   /**
@@ -508,6 +607,15 @@ private:
 
   void SetActiveProject(Project *p);
 
+  /**
+   * @brief Warm up a freshly opened project's caches in the background
+   *
+   * Replays the disk cache catalog and reads the cache frames and PCM segments the first
+   * playback is likely to need, so the first spacebar press after opening plays immediately
+   * instead of stuttering while everything trickles in from disk.
+   */
+  void PrefetchProjectCaches(Project *project);
+
   /**
    * @brief Internal main window object
    */
@@ -543,6 +651,35 @@ private:
    */
   QTimer autorecovery_timer_;
 
+  /**
+   * @brief Continuously synced background copy of the open project
+   *
+   * Both autorecovery saves and explicit user saves serialize this copy on a worker thread
+   * instead of stalling the main thread for the whole save. Only one save may read the copy at
+   * a time - see active_autorecovery_task_ and active_save_task_.
+   */
+  ProjectCopier *save_copier_;
+
+  /**
+   * @brief Copiers orphaned by a project switch while a save task was still reading their copy
+   */
+  QVector<ProjectCopier*> stale_save_copiers_;
+
+  /**
+   * @brief Autorecovery save task currently running on a worker thread, if any
+   */
+  Task *active_autorecovery_task_;
+
+  /**
+   * @brief Explicit project save task currently running on a worker thread, if any
+   */
+  Task *active_save_task_;
+
+  /**
+   * @brief The project active_save_task_ is saving, compared (never dereferenced) on completion
+   */
+  Project *active_save_task_source_;
+
   /**
    * @brief Application-wide undo stack instance
    */
@@ -588,6 +725,10 @@ private:
 private slots:
   void SaveAutorecovery();
 
+  void AutorecoverySaveFinished(Task *task, bool succeeded);
+
+  void BackgroundProjectSaveFinished(Task *task, bool succeeded);
+
   void ProjectSaveSucceeded(Task *task);
 
   bool AddOpenProjectFromTaskAndAddToRecents(Task* task)
@@ -603,6 +744,10 @@ private slots:
 
   bool StartHeadlessExport();
 
+  bool StartHeadlessBenchmark();
+
+  bool StartHeadlessFixtureGenerator();
+
   void OpenStartupProject();
 
   void AddRecoveryProjectFromTask(Task* task);
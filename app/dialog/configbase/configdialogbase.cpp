@@ -24,6 +24,7 @@
 #include <QSplitter>
 #include <QVBoxLayout>
 
+#include "config/config.h"
 #include "core.h"
 
 namespace olive {
@@ -75,6 +76,9 @@ void ConfigDialogBase::accept()
 
   Core::instance()->undo_stack()->push(command, tr("Set Configuration"));
 
+  // Push the new values into the typed cache that hot paths read from
+  Config::RefreshCache();
+
   AcceptEvent();
 
   QDialog::accept();
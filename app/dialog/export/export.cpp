@@ -376,7 +376,10 @@ void ExportDialog::StartExport()
   ExportTask* task = new ExportTask(viewer_node_, color_manager_, GenerateParams());
 
   if (export_bkg_box_->isChecked()) {
-    // Send to TaskManager to export in background
+    // Send to TaskManager to export in background. The task renders from the ProjectCopier
+    // snapshot it took just now, so the editor is free to keep working - background QoS keeps
+    // the export's tickets queued behind any interactive requests the editing session makes
+    task->SetBackgroundRenderQoS(true);
     TaskManager::instance()->AddTask(task);
     this->accept();
   } else {
@@ -677,6 +680,10 @@ EncodingParams ExportDialog::GenerateParams() const
 
     params.set_video_threads(video_tab_->threads());
 
+    params.set_video_hardware_encoding(video_tab_->hardware_encoding());
+
+    params.set_video_segments(video_tab_->segments());
+
     if (video_tab_->isVisible()) {
       video_tab_->GetCodecSection()->AddOpts(&params);
     }
@@ -735,6 +742,10 @@ void ExportDialog::SetParams(const EncodingParams &e)
 
     video_tab_->SetThreads(e.video_threads());
 
+    video_tab_->SetHardwareEncoding(e.video_hardware_encoding());
+
+    video_tab_->SetSegments(e.video_segments());
+
     if (video_tab_->isVisible()) {
       video_tab_->GetCodecSection()->SetOpts(&e);
     }
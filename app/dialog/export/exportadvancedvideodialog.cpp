@@ -58,6 +58,16 @@ ExportAdvancedVideoDialog::ExportAdvancedVideoDialog(const QList<QString> &pix_f
     performance_layout->addWidget(thread_slider_, row, 1);
 
     row++;
+
+    performance_layout->addWidget(new QLabel(tr("Parallel Segments:")), row, 0);
+
+    segment_slider_ = new IntegerSlider();
+    segment_slider_->SetMinimum(1);
+    segment_slider_->SetDefaultValue(1);
+    segment_slider_->InsertLabelSubstitution(1, tr("Off"));
+    performance_layout->addWidget(segment_slider_, row, 1);
+
+    row++;
   }
 
   QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
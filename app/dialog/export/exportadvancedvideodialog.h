@@ -26,6 +26,16 @@ public:
     thread_slider_->SetValue(t);
   }
 
+  int segments() const
+  {
+    return static_cast<int>(segment_slider_->GetValue());
+  }
+
+  void set_segments(int s)
+  {
+    segment_slider_->SetValue(s);
+  }
+
   QString pix_fmt() const
   {
     return pixel_format_combobox_->currentText();
@@ -49,6 +59,8 @@ public:
 private:
   IntegerSlider* thread_slider_;
 
+  IntegerSlider* segment_slider_;
+
   QComboBox* pixel_format_combobox_;
 
   QComboBox* yuv_color_range_combobox_;
@@ -36,6 +36,7 @@ ExportVideoTab::ExportVideoTab(ColorManager* color_manager, QWidget *parent) :
   QWidget(parent),
   color_manager_(color_manager),
   threads_(0),
+  segments_(1),
   color_range_(VideoParams::kColorRangeDefault)
 {
   QVBoxLayout* outer_layout = new QVBoxLayout(this);
@@ -180,6 +181,14 @@ QWidget *ExportVideoTab::SetupCodecSection()
 
   row++;
 
+  hardware_label_ = new QLabel(tr("Hardware Encoding:"));
+  codec_layout->addWidget(hardware_label_, row, 0);
+
+  hardware_checkbox_ = new QCheckBox(tr("Use hardware encoder if available"));
+  codec_layout->addWidget(hardware_checkbox_, row, 1);
+
+  row++;
+
   codec_stack_ = new CodecStack();
   codec_layout->addWidget(codec_stack_, row, 0, 1, 2);
 
@@ -221,11 +230,13 @@ void ExportVideoTab::OpenAdvancedDialog()
   ExportAdvancedVideoDialog d(pixel_formats, this);
 
   d.set_threads(threads_);
+  d.set_segments(segments_);
   d.set_pix_fmt(pix_fmt_);
   d.set_yuv_range(color_range_);
 
   if (d.exec() == QDialog::Accepted) {
     threads_ = d.threads();
+    segments_ = d.segments();
     pix_fmt_ = d.pix_fmt();
     color_range_ = d.yuv_range();
   }
@@ -266,6 +277,11 @@ void ExportVideoTab::VideoCodecChanged()
       SetCodecSection(ExportCodec::IsCodecAStillImage(codec) ? image_section_ : nullptr);
   }
 
+  // Hardware encode ASICs only exist for these codecs
+  bool hardware_available = (codec == ExportCodec::kCodecH264 || codec == ExportCodec::kCodecH265);
+  hardware_label_->setVisible(hardware_available);
+  hardware_checkbox_->setVisible(hardware_available);
+
   // Set default pixel format
   QStringList pix_fmts = ExportFormat::GetPixelFormatsForCodec(format_, codec);
   if (!pix_fmts.isEmpty()) {
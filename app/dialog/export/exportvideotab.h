@@ -23,6 +23,7 @@
 
 #include <QCheckBox>
 #include <QComboBox>
+#include <QLabel>
 #include <QWidget>
 
 #include "common/qtutils.h"
@@ -150,6 +151,26 @@ public:
     threads_ = t;
   }
 
+  const int& segments() const
+  {
+    return segments_;
+  }
+
+  void SetSegments(int s)
+  {
+    segments_ = s;
+  }
+
+  bool hardware_encoding() const
+  {
+    return hardware_checkbox_->isVisibleTo(hardware_checkbox_->parentWidget()) && hardware_checkbox_->isChecked();
+  }
+
+  void SetHardwareEncoding(bool e)
+  {
+    hardware_checkbox_->setChecked(e);
+  }
+
   const QString& pix_fmt() const { return pix_fmt_; }
   void SetPixFmt(const QString &s) { pix_fmt_ = s; }
 
@@ -174,6 +195,8 @@ private:
   QWidget* SetupCodecSection();
 
   QComboBox* codec_combobox_;
+  QCheckBox* hardware_checkbox_;
+  QLabel* hardware_label_;
   FrameRateComboBox* frame_rate_combobox_;
   QCheckBox* maintain_aspect_checkbox_;
   QComboBox* scaling_method_combobox_;
@@ -198,6 +221,8 @@ private:
 
   int threads_;
 
+  int segments_;
+
   QString pix_fmt_;
   VideoParams::ColorRange color_range_;
 
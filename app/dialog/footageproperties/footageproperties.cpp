@@ -31,6 +31,7 @@
 #include <QCheckBox>
 #include <QSpinBox>
 
+#include "codec/decoder.h"
 #include "core.h"
 #include "node/nodeundo.h"
 #include "streamproperties/audiostreamproperties.h"
@@ -123,6 +124,44 @@ FootagePropertiesDialog::FootagePropertiesDialog(QWidget *parent, Footage *foota
 
   row++;
 
+  // Per-file decoder counters - these identify media that's disproportionately expensive to
+  // decode (frequent slow seeks, constant cache misses, heavy pixel format conversion) and is
+  // therefore a good candidate for transcoding or proxies
+  Decoder::Statistics stats = Decoder::GetStatistics(footage_->filename());
+
+  QGroupBox* stats_box = new QGroupBox(tr("Decoder Statistics"));
+  QGridLayout* stats_layout = new QGridLayout(stats_box);
+
+  if (!stats.frames_decoded && !stats.seek_count && !stats.frame_cache_hits && !stats.frame_cache_misses) {
+    stats_layout->addWidget(new QLabel(tr("This file has not been decoded this session.")), 0, 0, 1, 2);
+  } else {
+    int stats_row = 0;
+
+    stats_layout->addWidget(new QLabel(tr("Frames decoded:")), stats_row, 0);
+    stats_layout->addWidget(new QLabel(QString::number(stats.frames_decoded)), stats_row, 1);
+    stats_row++;
+
+    qint64 average_seek = stats.seek_count ? stats.seek_time_ms / stats.seek_count : 0;
+    stats_layout->addWidget(new QLabel(tr("Seeks:")), stats_row, 0);
+    stats_layout->addWidget(new QLabel(tr("%1 (avg %2 ms)").arg(QString::number(stats.seek_count),
+                                                                QString::number(average_seek))), stats_row, 1);
+    stats_row++;
+
+    qint64 lookups = stats.frame_cache_hits + stats.frame_cache_misses;
+    stats_layout->addWidget(new QLabel(tr("Frame cache hit rate:")), stats_row, 0);
+    stats_layout->addWidget(new QLabel(tr("%1% (%2 of %3)").arg(QString::number(lookups ? stats.frame_cache_hits * 100 / lookups : 0),
+                                                                QString::number(stats.frame_cache_hits),
+                                                                QString::number(lookups))), stats_row, 1);
+    stats_row++;
+
+    stats_layout->addWidget(new QLabel(tr("Pixel format conversion:")), stats_row, 0);
+    stats_layout->addWidget(new QLabel(tr("%1 ms").arg(stats.conversion_time_ms)), stats_row, 1);
+  }
+
+  layout->addWidget(stats_box, row, 0, 1, 2);
+
+  row++;
+
   QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
   buttons->setCenterButtons(true);
   layout->addWidget(buttons, row, 0, 1, 2);
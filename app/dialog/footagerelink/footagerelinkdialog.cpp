@@ -21,16 +21,66 @@
 #include "footagerelinkdialog.h"
 
 #include <QDialogButtonBox>
+#include <QDirIterator>
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QFutureWatcher>
 #include <QHeaderView>
 #include <QLabel>
+#include <QProgressDialog>
 #include <QPushButton>
 #include <QScrollBar>
+#include <QtConcurrent/QtConcurrent>
 #include <QVBoxLayout>
 
 namespace olive {
 
+namespace {
+
+// Filename -> all paths in the scanned tree with that filename
+using FileIndex = QHash<QString, QStringList>;
+
+FileIndex ScanDirectory(const QString& path)
+{
+  FileIndex index;
+
+  QDirIterator it(path, QDir::Files, QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    it.next();
+    index[it.fileName()].append(it.filePath());
+  }
+
+  return index;
+}
+
+void MergeFileIndex(FileIndex& dst, const FileIndex& src)
+{
+  for (auto it=src.cbegin(); it!=src.cend(); it++) {
+    dst[it.key()].append(it.value());
+  }
+}
+
+/**
+ * Number of trailing path components (after the filename) that `candidate` shares with
+ * `original`, used to pick between candidates with identical filenames - the copy that kept
+ * the most of its old directory structure is most likely the same file.
+ */
+int CommonPathSuffixLength(const QString& original, const QString& candidate)
+{
+  QStringList a = original.split('/');
+  QStringList b = candidate.split('/');
+
+  int common = 0;
+  while (common < a.size() && common < b.size()
+         && a.at(a.size()-1-common) == b.at(b.size()-1-common)) {
+    common++;
+  }
+
+  return common;
+}
+
+}
+
 FootageRelinkDialog::FootageRelinkDialog(const QVector<Footage *> &footage, QWidget* parent) :
   QDialog(parent),
   footage_(footage)
@@ -76,6 +126,8 @@ FootageRelinkDialog::FootageRelinkDialog(const QVector<Footage *> &footage, QWid
   layout->addWidget(table_);
 
   QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+  QPushButton* search_btn = buttons->addButton(tr("Search in Folder..."), QDialogButtonBox::ActionRole);
+  connect(search_btn, &QPushButton::clicked, this, &FootageRelinkDialog::SearchForFootage);
   connect(buttons, &QDialogButtonBox::accepted, this, &FootageRelinkDialog::accept);
   connect(buttons, &QDialogButtonBox::rejected, this, &FootageRelinkDialog::reject);
   layout->addWidget(buttons);
@@ -157,6 +209,97 @@ void FootageRelinkDialog::BrowseForFootage()
     }
   }
 
+  JumpToNextInvalid();
+}
+
+void FootageRelinkDialog::SearchForFootage()
+{
+  // Default the search to where the first offline file used to live
+  QString start_dir;
+  for (int i=0; i<footage_.size(); i++) {
+    if (!footage_.at(i)->IsValid()) {
+      start_dir = QFileInfo(footage_.at(i)->filename()).absolutePath();
+      break;
+    }
+  }
+
+  QString search_path = QFileDialog::getExistingDirectory(this, tr("Search for Footage"), start_dir);
+
+  if (search_path.isEmpty()) {
+    return;
+  }
+
+  // Index the whole tree once, scanning first-level subdirectories in parallel - on network
+  // storage the walk is latency-bound, so concurrent iterators overlap the roundtrips
+  QStringList subdirs;
+  {
+    QDirIterator it(search_path, QDir::Dirs | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+      subdirs.append(it.next());
+    }
+  }
+
+  QFuture<FileIndex> future = QtConcurrent::mappedReduced<FileIndex>(subdirs, ScanDirectory, MergeFileIndex);
+
+  // Files sitting directly in the chosen folder aren't covered by any subdirectory scan
+  FileIndex index;
+  {
+    QDirIterator it(search_path, QDir::Files);
+    while (it.hasNext()) {
+      it.next();
+      index[it.fileName()].append(it.filePath());
+    }
+  }
+
+  // Keep the UI responsive while the scan runs
+  QProgressDialog progress(tr("Scanning \"%1\"...").arg(search_path), QString(), 0, 0, this);
+  progress.setWindowModality(Qt::WindowModal);
+
+  QFutureWatcher<FileIndex> watcher;
+  connect(&watcher, &QFutureWatcher<FileIndex>::finished, &progress, &QProgressDialog::accept);
+  watcher.setFuture(future);
+
+  if (!future.isFinished()) {
+    progress.exec();
+  }
+
+  watcher.waitForFinished();
+  MergeFileIndex(index, future.result());
+
+  // Match every offline item against the index in one pass
+  for (int i=0; i<footage_.size(); i++) {
+    Footage* f = footage_.at(i);
+
+    if (f->IsValid()) {
+      continue;
+    }
+
+    const QStringList& candidates = index.value(QFileInfo(f->filename()).fileName());
+
+    // If several files share the name, take the one that kept the most of its old directory
+    // structure around it
+    QString best;
+    int best_score = -1;
+    foreach (const QString& candidate, candidates) {
+      int score = CommonPathSuffixLength(f->filename(), candidate);
+      if (score > best_score) {
+        best_score = score;
+        best = candidate;
+      }
+    }
+
+    if (!best.isEmpty()) {
+      f->set_filename(best);
+      f->SetValid();
+      UpdateFootageItem(i);
+    }
+  }
+
+  JumpToNextInvalid();
+}
+
+void FootageRelinkDialog::JumpToNextInvalid()
+{
   // Check where the next invalid footage is. If there is none, accept automatically. Otherwise,
   // jump to that footage so the user knows where it is.
   int next_invalid = -1;
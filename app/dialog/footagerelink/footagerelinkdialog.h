@@ -37,6 +37,11 @@ public:
 private:
   void UpdateFootageItem(int index);
 
+  /**
+   * @brief Select and scroll to the next offline item, or accept if everything is relinked
+   */
+  void JumpToNextInvalid();
+
   QTreeWidget* table_;
 
   QVector<Footage*> footage_;
@@ -44,6 +49,15 @@ private:
 private slots:
   void BrowseForFootage();
 
+  /**
+   * @brief Relink all offline footage against one directory tree in a single pass
+   *
+   * Scans the chosen tree once (subdirectories in parallel) into an in-memory filename index
+   * and matches every offline item against it, rather than the user browsing per file - the
+   * usual "project moved to restructured NAS" case relinks in one shot.
+   */
+  void SearchForFootage();
+
 };
 
 }
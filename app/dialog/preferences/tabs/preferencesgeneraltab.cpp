@@ -109,6 +109,20 @@ PreferencesGeneralTab::PreferencesGeneralTab()
     timeline_layout->addWidget(default_still_length_);
   }
 
+  {
+    QGroupBox* history_groupbox = new QGroupBox(tr("History"));
+    QGridLayout* history_layout = new QGridLayout(history_groupbox);
+    layout->addWidget(history_groupbox);
+
+    history_layout->addWidget(new QLabel(tr("Maximum Undo History:")), 0, 0);
+
+    undo_limit_ = new IntegerSlider();
+    undo_limit_->SetMinimum(1);
+    undo_limit_->SetMaximum(10000);
+    undo_limit_->SetValue(OLIVE_CONFIG("UndoLimit").toLongLong());
+    history_layout->addWidget(undo_limit_, 0, 1);
+  }
+
   {
     QGroupBox* autorecovery_groupbox = new QGroupBox(tr("Auto-Recovery"));
     QGridLayout* autorecovery_layout = new QGridLayout(autorecovery_groupbox);
@@ -175,6 +189,8 @@ void PreferencesGeneralTab::Accept(MultiUndoCommand *command)
     Core::instance()->SetLanguage(set_language.isEmpty() ? QLocale::system().name() : set_language);
   }
 
+  OLIVE_CONFIG("UndoLimit") = QVariant::fromValue(undo_limit_->GetValue());
+
   OLIVE_CONFIG("AutorecoveryEnabled") = autorecovery_enabled_->isChecked();
   OLIVE_CONFIG("AutorecoveryInterval") = QVariant::fromValue(autorecovery_interval_->GetValue());
   OLIVE_CONFIG("AutorecoveryMaximum") = QVariant::fromValue(autorecovery_maximum_->GetValue());
@@ -51,6 +51,8 @@ private:
 
   RationalSlider* default_still_length_;
 
+  IntegerSlider* undo_limit_;
+
   QCheckBox* autorecovery_enabled_;
 
   IntegerSlider* autorecovery_interval_;
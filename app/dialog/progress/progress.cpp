@@ -50,6 +50,11 @@ ProgressDialog::ProgressDialog(const QString& message, const QString& title, QWi
   bar_->setMaximum(100);
   layout->addWidget(bar_);
 
+  // Optional status line, only shown if the task provides one
+  status_lbl_ = new QLabel();
+  status_lbl_->setVisible(false);
+  layout->addWidget(status_lbl_);
+
   elapsed_timer_lbl_ = new ElapsedCounterWidget();
   layout->addWidget(elapsed_timer_lbl_);
 
@@ -116,6 +121,16 @@ void ProgressDialog::SetProgress(double value)
   Core::instance()->main_window()->SetApplicationProgressValue(percent);
 }
 
+void ProgressDialog::SetStatus(const QString &status)
+{
+  if (!show_progress_) {
+    return;
+  }
+
+  status_lbl_->setText(status);
+  status_lbl_->setVisible(true);
+}
+
 void ProgressDialog::ShowErrorMessage(const QString &title, const QString &message)
 {
   Core::instance()->main_window()->SetApplicationProgressStatus(MainWindow::kProgressError);
@@ -22,6 +22,7 @@
 #define PROGRESSDIALOG_H
 
 #include <QDialog>
+#include <QLabel>
 #include <QProgressBar>
 
 #include "common/debug.h"
@@ -43,6 +44,8 @@ protected:
 public slots:
   void SetProgress(double value);
 
+  void SetStatus(const QString& status);
+
 signals:
   void Cancelled();
 
@@ -52,6 +55,8 @@ protected:
 private:
   QProgressBar* bar_;
 
+  QLabel* status_lbl_;
+
   ElapsedCounterWidget* elapsed_timer_lbl_;
 
   bool show_progress_;
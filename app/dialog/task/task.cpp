@@ -38,6 +38,9 @@ TaskDialog::TaskDialog(Task* task, const QString& title, QWidget *parent) :
   // Connect the save manager progress signal to the progress bar update on the dialog
   connect(task_, &Task::ProgressChanged, this, &TaskDialog::SetProgress, Qt::QueuedConnection);
 
+  // Show any status detail the task provides underneath the progress bar
+  connect(task_, &Task::StatusChanged, this, &TaskDialog::SetStatus, Qt::QueuedConnection);
+
   // Connect cancel signal (must be a direct connection or it'll be queued after the task has
   // already finished)
   connect(this, &TaskDialog::Cancelled, task_, &Task::Cancel, Qt::DirectConnection);
@@ -41,6 +41,8 @@ extern "C" {
 #include "core.h"
 #include "common/commandlineparser.h"
 #include "common/debug.h"
+#include "common/performancelog.h"
+#include "common/tracerecorder.h"
 #include "node/project/serializer/serializer.h"
 #include "version.h"
 
@@ -166,12 +168,80 @@ int main(int argc, char *argv[])
       parser.AddOption({QStringLiteral("x"), QStringLiteral("-export")},
                        QCoreApplication::translate("main", "Export only (No GUI)"));
 
+  auto benchmark_option =
+      parser.AddOption({QStringLiteral("-benchmark")},
+                       QCoreApplication::translate("main", "Replay the project's first sequence through the no-op render backend and report frames/sec (No GUI)"));
+
+  auto benchmark_workload_option =
+      parser.AddOption({QStringLiteral("-benchmark-workload")},
+                       QCoreApplication::translate("main", "Replay scripted interactive workloads (seek, scrub, play) against the project and report latency percentiles and cache hit rates (No GUI)"),
+                       true,
+                       QCoreApplication::translate("main", "workloads"));
+
+  auto generate_fixture_option =
+      parser.AddOption({QStringLiteral("-generate-fixture")},
+                       QCoreApplication::translate("main", "Generate reproducible performance-test media and a synthetic project into a directory (No GUI)"),
+                       true,
+                       QCoreApplication::translate("main", "output-dir"));
+
+  auto fixture_spec_option =
+      parser.AddOption({QStringLiteral("-fixture-spec")},
+                       QCoreApplication::translate("main", "Fixture parameters for --generate-fixture as key=value pairs (codec, width, height, fps, gop, duration, tracks, clips, cliplen, effects)"),
+                       true,
+                       QCoreApplication::translate("main", "spec"));
+
+  auto export_preset_option =
+      parser.AddOption({QStringLiteral("-export-preset")},
+                       QCoreApplication::translate("main", "Export preset file to use with --export"),
+                       true,
+                       QCoreApplication::translate("main", "preset-file"));
+
+  auto export_queue_option =
+      parser.AddOption({QStringLiteral("-export-queue")},
+                       QCoreApplication::translate("main", "Run a batch of exports back-to-back from a queue file where each line is \"project-file<TAB>preset-file\" (No GUI)"),
+                       true,
+                       QCoreApplication::translate("main", "queue-file"));
+
+  auto farm_worker_option =
+      parser.AddOption({QStringLiteral("-farm-worker")},
+                       QCoreApplication::translate("main", "Render only this worker's slice of the export (requires --farm-count)"),
+                       true,
+                       QCoreApplication::translate("main", "index"));
+
+  auto farm_count_option =
+      parser.AddOption({QStringLiteral("-farm-count")},
+                       QCoreApplication::translate("main", "Total number of render farm workers"),
+                       true,
+                       QCoreApplication::translate("main", "count"));
+
+  auto farm_join_option =
+      parser.AddOption({QStringLiteral("-farm-join")},
+                       QCoreApplication::translate("main", "Join rendered worker segments into the final output"));
+
   auto ts_option =
       parser.AddOption({QStringLiteral("-ts")},
                        QCoreApplication::translate("main", "Override language with file"),
                        true,
                        QCoreApplication::translate("main", "qm-file"));
 
+  auto trace_option =
+      parser.AddOption({QStringLiteral("-trace")},
+                       QCoreApplication::translate("main", "Record a Chrome trace-event file of tasks, render tickets and decoder calls (view in about:tracing or Perfetto)"),
+                       true,
+                       QCoreApplication::translate("main", "json-file"));
+
+  auto perf_log_option =
+      parser.AddOption({QStringLiteral("-perf-log")},
+                       QCoreApplication::translate("main", "Record per-minute render performance aggregates (ticket latency, decode times, cache hit rate, dropped frames) to a compact binary log"),
+                       true,
+                       QCoreApplication::translate("main", "log-file"));
+
+  auto perf_log_export_option =
+      parser.AddOption({QStringLiteral("-export-perf-log")},
+                       QCoreApplication::translate("main", "Convert a performance log to JSON (written alongside with a .json extension) and exit"),
+                       true,
+                       QCoreApplication::translate("main", "log-file"));
+
   auto decompress_option =
       parser.AddOption({QStringLiteral("d"), QStringLiteral("-decompress")},
                        QCoreApplication::translate("main", "Decompress project file (No GUI)"));
@@ -182,6 +252,10 @@ int main(int argc, char *argv[])
                        QCoreApplication::translate("main", "Launch with debug console"));
 #endif // _WIN32
 
+  auto no_vsync_option =
+      parser.AddOption({QStringLiteral("-no-vsync")},
+                       QCoreApplication::translate("main", "Present viewer frames without waiting for vertical sync (lower scrubbing latency, may tear)"));
+
   auto project_argument =
       parser.AddPositionalArgument(QStringLiteral("project"),
                                    QCoreApplication::translate("main", "Project to open on startup"));
@@ -226,10 +300,52 @@ int main(int argc, char *argv[])
     return decompress_project(project_argument->GetSetting());
   }
 
+  if (perf_log_export_option->IsSet()) {
+    QString log_fn = perf_log_export_option->GetSetting();
+    return olive::PerformanceLog::ExportJson(log_fn, log_fn + QStringLiteral(".json")) ? 0 : 1;
+  }
+
   if (export_option->IsSet()) {
     startup_params.set_run_mode(olive::Core::CoreParams::kHeadlessExport);
   }
 
+  if (benchmark_option->IsSet()) {
+    startup_params.set_run_mode(olive::Core::CoreParams::kHeadlessBenchmark);
+  }
+
+  if (benchmark_workload_option->IsSet()) {
+    startup_params.set_run_mode(olive::Core::CoreParams::kHeadlessBenchmark);
+    startup_params.set_benchmark_workload(benchmark_workload_option->GetSetting());
+  }
+
+  if (generate_fixture_option->IsSet()) {
+    startup_params.set_run_mode(olive::Core::CoreParams::kHeadlessFixture);
+    startup_params.set_fixture_output(generate_fixture_option->GetSetting());
+  }
+
+  if (fixture_spec_option->IsSet()) {
+    startup_params.set_fixture_spec(fixture_spec_option->GetSetting());
+  }
+
+  if (export_preset_option->IsSet()) {
+    startup_params.set_export_preset(export_preset_option->GetSetting());
+  }
+
+  if (export_queue_option->IsSet()) {
+    startup_params.set_run_mode(olive::Core::CoreParams::kHeadlessExport);
+    startup_params.set_export_queue(export_queue_option->GetSetting());
+  }
+
+  if (farm_worker_option->IsSet()) {
+    startup_params.set_farm_worker(farm_worker_option->GetSetting().toInt());
+  }
+
+  if (farm_count_option->IsSet()) {
+    startup_params.set_farm_count(farm_count_option->GetSetting().toInt());
+  }
+
+  startup_params.set_farm_join(farm_join_option->IsSet());
+
   if (ts_option->IsSet()) {
     if (ts_option->GetSetting().isEmpty()) {
       qWarning() << "--ts was set but no translation file was provided";
@@ -260,6 +376,13 @@ int main(int argc, char *argv[])
   format.setProfile(QSurfaceFormat::CoreProfile);
 
   format.setDepthBufferSize(24);
+
+  // Make presentation explicit rather than whatever the driver default happens to be: triple
+  // buffering so playback never blocks on an in-flight swap, and vsync on so frames are paced
+  // by the display. --no-vsync trades tearing for lower scrub-to-screen latency.
+  format.setSwapBehavior(QSurfaceFormat::TripleBuffer);
+  format.setSwapInterval(no_vsync_option->IsSet() ? 0 : 1);
+
   QSurfaceFormat::setDefaultFormat(format);
 
   // Enable application automatically using higher resolution images from icons
@@ -334,6 +457,18 @@ int main(int argc, char *argv[])
   }
 #endif // USE_CRASHPAD
 
+  // Start tracing if requested. Opened before Core so startup work is captured too.
+  if (trace_option->IsSet()) {
+    olive::TraceRecorder::Open(trace_option->GetSetting());
+  }
+
+  // Start performance logging if requested
+  if (perf_log_option->IsSet()) {
+    if (!olive::PerformanceLog::Open(perf_log_option->GetSetting())) {
+      qWarning() << "Failed to open performance log file:" << perf_log_option->GetSetting();
+    }
+  }
+
   // Start core
   olive::Core c(startup_params);
 
@@ -344,5 +479,9 @@ int main(int argc, char *argv[])
   // Clear core memory
   c.Stop();
 
+  // All worker threads have been joined by Core::Stop(), so no more spans can arrive
+  olive::TraceRecorder::Close();
+  olive::PerformanceLog::Close();
+
   return ret;
 }
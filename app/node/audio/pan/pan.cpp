@@ -20,6 +20,7 @@
 
 #include "pan.h"
 
+#include "audio/samplekernels.h"
 #include "widget/slider/floatslider.h"
 
 namespace olive {
@@ -73,10 +74,11 @@ void PanNode::Value(const NodeValueRow &value, const NodeGlobals &globals, NodeV
       if (IsInputStatic(kPanningInput)) {
         float pan_volume = value[kPanningInput].toDouble();
         if (!qIsNull(pan_volume)) {
+          // Attenuate the opposing channel with the runtime-dispatched SIMD kernel
           if (pan_volume > 0) {
-            samples.transform_volume_for_channel(0, 1.0f - pan_volume);
+            SampleKernels::Gain(samples.data(0), 1.0f - pan_volume, samples.sample_count());
           } else {
-            samples.transform_volume_for_channel(1, 1.0f + pan_volume);
+            SampleKernels::Gain(samples.data(1), 1.0f + pan_volume, samples.sample_count());
           }
         }
 
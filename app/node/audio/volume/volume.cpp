@@ -20,6 +20,7 @@
 
 #include "volume.h"
 
+#include "audio/samplekernels.h"
 #include "widget/slider/floatslider.h"
 
 namespace olive {
@@ -72,7 +73,10 @@ void VolumeNode::Value(const NodeValueRow &value, const NodeGlobals &globals, No
       auto volume = value[kVolumeInput].toDouble();
 
       if (!qFuzzyCompare(volume, 1.0)) {
-        buffer.transform_volume(volume);
+        // Scale each channel plane with the runtime-dispatched SIMD kernel
+        for (int i=0; i<buffer.audio_params().channel_count(); i++) {
+          SampleKernels::Gain(buffer.data(i), volume, buffer.sample_count());
+        }
       }
 
       table->Push(NodeValue::kSamples, QVariant::fromValue(buffer), this);
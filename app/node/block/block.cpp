@@ -123,6 +123,11 @@ void Block::InvalidateCache(const TimeRange& range, const QString& from, int ele
     r = TimeRange(qMin(length(), last_length_), RATIONAL_MAX);
 
     if (!NodeInputDragger::IsInputBeingDragged()) {
+      if (length() != last_length_) {
+        // Pass the delta along so the track can turn this into a waveform shift hint (see
+        // Track::InvalidateCache())
+        options.insert(QStringLiteral("lengthdelta"), QVariant::fromValue(length() - last_length_));
+      }
       last_length_ = length();
     }
 
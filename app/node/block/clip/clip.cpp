@@ -241,7 +241,7 @@ void ClipBlock::RequestRangeFromConnected(const TimeRange &range)
         }
 
         // Handle video cache
-        RequestRangeForCache(connected->video_frame_cache(), max_range, range, true, IsAutocaching());
+        RequestRangeForCache(connected->video_frame_cache(), max_range, range, true, IsAutocaching() || IsRetimed());
       } else if (type == Track::kAudio) {
         // Handle waveforms
         RequestRangeForCache(connected->waveform_cache(), max_range, range, true, (OLIVE_CONFIG("TimelineWaveformMode").toInt() == Timeline::kWaveformsEnabled));
@@ -273,7 +273,7 @@ void ClipBlock::RequestInvalidatedFromConnected(bool force_all, const TimeRange
         }
 
         // Handle video cache
-        if (IsAutocaching() || force_all) {
+        if (IsAutocaching() || IsRetimed() || force_all) {
           RequestInvalidatedForCache(connected->video_frame_cache(), max_range);
         }
       } else if (type == Track::kAudio) {
@@ -351,6 +351,9 @@ void ClipBlock::InvalidateCache(const TimeRange& range, const QString& from, int
 
   // If signal is from texture input, transform all times from media time to sequence time
   if (from == kBufferIn) {
+    // Any retimed audio we derived from the old samples is now stale
+    ClearRetimedAudioCache();
+
     // Render caches where necessary
     if (AreCachesEnabled()) {
       RequestRangeFromConnected(range);
@@ -387,6 +390,14 @@ void ClipBlock::InvalidateCache(const TimeRange& range, const QString& from, int
       }
     }
 
+    // Waveform shift hints are in our input's time base and can't be transformed across this
+    // boundary, so anything downstream of a nested sequence falls back to plain invalidation
+    options.remove(QStringLiteral("waveshiftfrom"));
+    options.remove(QStringLiteral("waveshiftto"));
+    options.remove(QStringLiteral("waveshiftid"));
+    options.remove(QStringLiteral("waveshiftgapin"));
+    options.remove(QStringLiteral("waveshiftgapout"));
+
     super::InvalidateCache(adj, from, element, options);
   } else {
     // Otherwise, pass signal along normally
@@ -459,6 +470,21 @@ void ClipBlock::InputValueChangedEvent(const QString &input, int element)
     }
   } else if (input == kLoopModeInput) {
     emit PreviewChanged();
+  } else if (input == kSpeedInput || input == kReverseInput || input == kMaintainAudioPitchInput) {
+    // Retimed audio was derived with the old parameters
+    ClearRetimedAudioCache();
+
+    if (input != kMaintainAudioPitchInput && GetTrackType() == Track::kVideo) {
+      if (IsRetimed()) {
+        // The connected cache is keyed in media time, so frames rendered for one speed are
+        // served as-is at any other - only the not-yet-rendered remainder gets requested here
+        RequestInvalidatedFromConnected();
+      } else if (!IsAutocaching()) {
+        if (Node *connected = GetConnectedOutput(kBufferIn)) {
+          emit connected->video_frame_cache()->CancelAll();
+        }
+      }
+    }
   }
 }
 
@@ -547,6 +573,40 @@ TimeRange ClipBlock::media_range() const
   return InputTimeAdjustment(kBufferIn, -1, TimeRange(0, length()), false);
 }
 
+bool ClipBlock::GetCachedRetimedAudio(const TimeRange &range, const AudioParams &params, SampleBuffer *out)
+{
+  QMutexLocker locker(&retimed_audio_lock_);
+
+  auto it = retimed_audio_cache_.constFind(range);
+  if (it == retimed_audio_cache_.constEnd() || it.value().audio_params() != params) {
+    return false;
+  }
+
+  *out = it.value();
+  return true;
+}
+
+void ClipBlock::CacheRetimedAudio(const TimeRange &range, const SampleBuffer &samples)
+{
+  QMutexLocker locker(&retimed_audio_lock_);
+
+  // Playback requests the same chunk ranges each pass, so the working set stays small. Rather
+  // than track entry ages, just start over if it somehow fills up.
+  static const int kMaxRetimedAudioChunks = 64;
+  if (retimed_audio_cache_.size() >= kMaxRetimedAudioChunks) {
+    retimed_audio_cache_.clear();
+  }
+
+  retimed_audio_cache_.insert(range, samples);
+}
+
+void ClipBlock::ClearRetimedAudioCache()
+{
+  QMutexLocker locker(&retimed_audio_lock_);
+
+  retimed_audio_cache_.clear();
+}
+
 MultiCamNode *ClipBlock::FindMulticam()
 {
   auto v = FindInputNodesConnectedToInput<MultiCamNode>(NodeInput(this, kBufferIn), 1);
@@ -21,6 +21,8 @@
 #ifndef CLIPBLOCK_H
 #define CLIPBLOCK_H
 
+#include <QMutex>
+
 #include "audio/audiovisualwaveform.h"
 #include "codec/decoder.h"
 #include "node/block/block.h"
@@ -88,6 +90,17 @@ public:
     return GetStandardValue(kReverseInput).toBool();
   }
 
+  /**
+   * @brief Whether this clip plays its media at anything other than 1.0 forward speed
+   *
+   * Retimed video decodes non-sequentially (skipping or rewinding source frames), which is too
+   * slow to sustain in real time, so retimed clips cache implicitly as if autocaching were on.
+   */
+  bool IsRetimed() const
+  {
+    return reverse() || !qFuzzyCompare(speed(), 1.0);
+  }
+
   void set_reverse(bool e)
   {
     SetStandardValue(kReverseInput, e);
@@ -200,6 +213,22 @@ public:
 
   MultiCamNode *FindMulticam();
 
+  /**
+   * @brief Retrieve retimed audio previously stored with CacheRetimedAudio
+   *
+   * Returns FALSE if nothing is cached for this range or it was rendered with different
+   * audio parameters.
+   */
+  bool GetCachedRetimedAudio(const TimeRange &range, const AudioParams &params, SampleBuffer *out);
+
+  /**
+   * @brief Store retimed audio for a range so later passes can skip the resample
+   *
+   * The cache is cleared whenever the speed/reverse/pitch parameters change or the connected
+   * audio is invalidated, so entries are always safe to replay.
+   */
+  void CacheRetimedAudio(const TimeRange &range, const SampleBuffer &samples);
+
   static const QString kBufferIn;
   static const QString kMediaInInput;
   static const QString kSpeedInput;
@@ -238,6 +267,8 @@ private:
 
   bool GetAdjustedThumbnailRange(TimeRange *r) const;
 
+  void ClearRetimedAudioCache();
+
   QVector<Block*> block_links_;
 
   TransitionBlock* in_transition_;
@@ -248,6 +279,9 @@ private:
 private:
   rational last_media_in_;
 
+  QMutex retimed_audio_lock_;
+  QHash<TimeRange, SampleBuffer> retimed_audio_cache_;
+
 };
 
 }
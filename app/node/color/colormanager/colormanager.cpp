@@ -22,6 +22,7 @@
 
 #include <QDir>
 #include <QStandardPaths>
+#include <QtConcurrent/QtConcurrent>
 
 #include "common/define.h"
 #include "common/filefunctions.h"
@@ -32,7 +33,7 @@ namespace olive {
 
 #define super Node
 
-OCIO::ConstConfigRcPtr ColorManager::default_config_ = nullptr;
+QFuture<OCIO::ConstConfigRcPtr> ColorManager::default_config_future_;
 
 ColorManager::ColorManager(Project *project) :
   QObject(project),
@@ -65,32 +66,36 @@ QString ColorManager::GetConfigFilename() const
 
 OCIO::ConstConfigRcPtr ColorManager::GetDefaultConfig()
 {
-  return default_config_;
+  // Blocks if the worker started by SetUpDefaultConfig hasn't finished yet; by the time
+  // anything color-managed needs the config it usually has
+  return default_config_future_.result();
 }
 
 void ColorManager::SetUpDefaultConfig()
 {
-  if (!qEnvironmentVariableIsEmpty("OCIO")) {
-    // Attempt to set config from "OCIO" environment variable
-    try {
-      default_config_ = OCIO::Config::CreateFromEnv();
-
-      return;
-    } catch (OCIO::Exception& e) {
-      qWarning() << "Failed to load config from OCIO environment variable config:" << e.what();
+  // Extracting and parsing the bundled OCIO config is a sizable chunk of cold start, so it
+  // runs on a worker while the rest of the application initializes
+  default_config_future_ = QtConcurrent::run([]() -> OCIO::ConstConfigRcPtr {
+    if (!qEnvironmentVariableIsEmpty("OCIO")) {
+      // Attempt to set config from "OCIO" environment variable
+      try {
+        return OCIO::Config::CreateFromEnv();
+      } catch (OCIO::Exception& e) {
+        qWarning() << "Failed to load config from OCIO environment variable config:" << e.what();
+      }
     }
-  }
 
-  // Extract OCIO config - kind of hacky, but it'll work
-  QString dir = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath(QStringLiteral("ocioconf"));
+    // Extract OCIO config - kind of hacky, but it'll work
+    QString dir = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath(QStringLiteral("ocioconf"));
 
-  FileFunctions::CopyDirectory(QStringLiteral(":/ocioconf"),
-                               dir,
-                               true);
+    FileFunctions::CopyDirectory(QStringLiteral(":/ocioconf"),
+                                 dir,
+                                 true);
 
-  qDebug() << "Extracting default OCIO config to" << dir;
+    qDebug() << "Extracting default OCIO config to" << dir;
 
-  default_config_ = CreateConfigFromFile(QDir(dir).filePath(QStringLiteral("config.ocio")));
+    return CreateConfigFromFile(QDir(dir).filePath(QStringLiteral("config.ocio")));
+  });
 }
 
 void ColorManager::SetConfigFilename(const QString &filename)
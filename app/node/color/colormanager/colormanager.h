@@ -22,6 +22,7 @@
 #define COLORSERVICE_H
 
 #include <memory>
+#include <QFuture>
 #include <QMutex>
 
 #include "codec/frame.h"
@@ -90,7 +91,8 @@ signals:
 private:
   OCIO::ConstConfigRcPtr config_;
 
-  static OCIO::ConstConfigRcPtr default_config_;
+  // Loaded asynchronously by SetUpDefaultConfig(); GetDefaultConfig() waits on the result
+  static QFuture<OCIO::ConstConfigRcPtr> default_config_future_;
 
 };
 
@@ -36,6 +36,7 @@ OCIOBaseNode::OCIOBaseNode() :
   SetEffectInput(kTextureInput);
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
 }
 
 void OCIOBaseNode::AddedToGraphEvent(Project *p)
@@ -52,6 +52,7 @@ CornerPinDistortNode::CornerPinDistortNode()
   gizmo_resize_handle_[3] = AddDraggableGizmo<PointGizmo>({NodeKeyframeTrackReference(NodeInput(this, kBottomLeftInput), 0), NodeKeyframeTrackReference(NodeInput(this, kBottomLeftInput), 1)});
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
   SetEffectInput(kTextureInput);
 }
 
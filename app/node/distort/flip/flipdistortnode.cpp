@@ -37,6 +37,7 @@ FlipDistortNode::FlipDistortNode()
   AddInput(kVerticalInput, NodeValue::kBoolean, false);
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
   SetEffectInput(kTextureInput);
 }
 
@@ -81,7 +82,9 @@ void FlipDistortNode::Value(const NodeValueRow &value, const NodeGlobals &global
   if (TexturePtr tex = value[kTextureInput].toTexture()) {
     // Only run shader if at least one of flip or flop are selected
     if (value[kHorizontalInput].toBool() || value[kVerticalInput].toBool()) {
-      table->Push(NodeValue::kTexture, tex->toJob(ShaderJob(value)), this);
+      ShaderJob job(value);
+      job.SetFusableInput(kTextureInput);
+      table->Push(NodeValue::kTexture, tex->toJob(job), this);
     } else {
       // If we're not flipping or flopping just push the texture
       table->Push(value[kTextureInput]);
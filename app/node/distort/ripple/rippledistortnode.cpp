@@ -45,6 +45,7 @@ RippleDistortNode::RippleDistortNode()
   AddInput(kStretchInput, NodeValue::kBoolean, false);
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
   SetEffectInput(kTextureInput);
 
   gizmo_ = AddDraggableGizmo<PointGizmo>({
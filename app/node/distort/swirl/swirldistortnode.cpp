@@ -42,6 +42,7 @@ SwirlDistortNode::SwirlDistortNode()
   AddInput(kPositionInput, NodeValue::kVec2, QVector2D(0, 0));
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
   SetEffectInput(kTextureInput);
 
   gizmo_ = AddDraggableGizmo<PointGizmo>({
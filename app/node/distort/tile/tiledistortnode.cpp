@@ -49,6 +49,7 @@ TileDistortNode::TileDistortNode()
   AddInput(kMirrorYInput, NodeValue::kBoolean, false);
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
   SetEffectInput(kTextureInput);
 
   gizmo_ = AddDraggableGizmo<PointGizmo>({
@@ -31,6 +31,26 @@ const QString TransformDistortNode::kInterpolationInput = QStringLiteral("interp
 
 #define super MatrixGenerator
 
+namespace {
+
+/**
+ * @brief Returns true if a job is exactly a default-shader matrix blit
+ *
+ * Such a job can be folded into a downstream transform by concatenating the matrices - it's a
+ * single pass over a single texture with no custom shader, geometry or iteration.
+ */
+bool IsConcatenatableMatrixBlit(ShaderJob *job)
+{
+  return job->GetShaderID().isEmpty()
+      && job->GetIterationCount() == 1
+      && job->GetVertexCoordinates().isEmpty()
+      && job->GetValues().size() == 2
+      && job->Get(QStringLiteral("ove_mvpmat")).type() == NodeValue::kMatrix
+      && job->Get(QStringLiteral("ove_maintex")).type() == NodeValue::kTexture;
+}
+
+}
+
 TransformDistortNode::TransformDistortNode()
 {
   AddInput(kParentInput, NodeValue::kMatrix);
@@ -65,6 +85,7 @@ TransformDistortNode::TransformDistortNode()
   }
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
   SetEffectInput(kTextureInput);
 }
 
@@ -96,6 +117,24 @@ void TransformDistortNode::Value(const NodeValueRow &value, const NodeGlobals &g
     // Adjust our matrix by the resolutions involved
     QMatrix4x4 real_matrix = GenerateAutoScaledMatrix(generated_matrix, value, globals, texture->params());
 
+    if (!real_matrix.isIdentity()) {
+      // Stacked transforms each resample the image with their own filtering pass, compounding
+      // both cost and softness. If the incoming texture is itself an unrendered matrix blit,
+      // concatenate its matrix into ours and resample its source directly so the whole stack
+      // becomes a single pass with this node's filter
+      while (TexturePtr unrendered = texture_meta.toTexture()) {
+        ShaderJob *inner = unrendered->IsJob() ? dynamic_cast<ShaderJob*>(unrendered->job()) : nullptr;
+
+        if (!inner || !IsConcatenatableMatrixBlit(inner)) {
+          break;
+        }
+
+        real_matrix *= inner->Get(QStringLiteral("ove_mvpmat")).toMatrix();
+        texture_meta = inner->Get(QStringLiteral("ove_maintex"));
+      }
+    }
+
+    // The concatenated stack may cancel itself out, in which case no blit is necessary at all
     if (!real_matrix.isIdentity()) {
       // The matrix will transform things
       ShaderJob job;
@@ -41,6 +41,7 @@ WaveDistortNode::WaveDistortNode()
   AddInput(kVerticalInput, NodeValue::kCombo, false);
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
   SetEffectInput(kTextureInput);
 }
 
@@ -74,6 +74,7 @@
 namespace olive {
 
 QList<Node*> NodeFactory::library_;
+QHash<QString, Node*> NodeFactory::id_map_;
 
 void NodeFactory::Initialize()
 {
@@ -84,6 +85,7 @@ void NodeFactory::Initialize()
     Node* created_node = CreateFromFactoryIndex(static_cast<InternalID>(i));
 
     library_.append(created_node);
+    id_map_.insert(created_node->id(), created_node);
   }
 }
 
@@ -91,6 +93,7 @@ void NodeFactory::Destroy()
 {
   qDeleteAll(library_);
   library_.clear();
+  id_map_.clear();
 }
 
 Menu *NodeFactory::CreateMenu(QWidget* parent, bool create_none_item, Node::CategoryID restrict_to, uint64_t restrict_flags)
@@ -186,12 +189,8 @@ QString NodeFactory::GetIDFromMenuAction(QAction *action)
 
 QString NodeFactory::GetNameFromID(const QString &id)
 {
-  if (!id.isEmpty()) {
-    foreach (Node* n, library_) {
-      if (n->id() == id) {
-        return n->Name();
-      }
-    }
+  if (Node *n = id_map_.value(id)) {
+    return n->Name();
   }
 
   return QString();
@@ -199,10 +198,8 @@ QString NodeFactory::GetNameFromID(const QString &id)
 
 Node *NodeFactory::CreateFromID(const QString &id)
 {
-  foreach (Node* n, library_) {
-    if (n->id() == id) {
-      return n->copy();
-    }
+  if (Node *n = id_map_.value(id)) {
+    return n->copy();
   }
 
   return nullptr;
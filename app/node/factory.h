@@ -21,6 +21,7 @@
 #ifndef NODEFACTORY_H
 #define NODEFACTORY_H
 
+#include <QHash>
 #include <QList>
 
 #include "node.h"
@@ -107,6 +108,11 @@ public:
 private:
   static QList<Node*> library_;
 
+  // ID -> library entry, built once in Initialize() so that CreateFromID is a hash lookup
+  // rather than a linear scan. Project load resolves an ID per node, which made the scan a
+  // measurable cost on large projects.
+  static QHash<QString, Node*> id_map_;
+
 };
 
 }
@@ -67,6 +67,7 @@ BlurFilterNode::BlurFilterNode()
   AddInput(kRepeatEdgePixelsInput, NodeValue::kBoolean, true);
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
   SetEffectInput(kTextureInput);
 
   radial_center_gizmo_ = AddDraggableGizmo<PointGizmo>();
@@ -113,7 +114,11 @@ void BlurFilterNode::Retranslate()
 
 ShaderCode BlurFilterNode::GetShaderCode(const ShaderRequest &request) const
 {
-  Q_UNUSED(request)
+  if (request.id == QStringLiteral("resample")) {
+    // Plain textured blit used to upsample the preview pyramid back to full resolution
+    return ShaderCode(FileFunctions::ReadFileAsString(":/shaders/default.frag"));
+  }
+
   return ShaderCode(FileFunctions::ReadFileAsString(":/shaders/blur.frag"));
 }
 
@@ -154,10 +159,47 @@ void BlurFilterNode::Value(const NodeValueRow &value, const NodeGlobals &globals
     }
 
     if (can_push_job) {
-      ShaderJob job(value);
-      job.Insert(QStringLiteral("resolution_in"), NodeValue(NodeValue::kVec2, tex->virtual_resolution(), this));
-      job.SetIterations(iterations, kTextureInput);
-      table->Push(NodeValue::kTexture, tex->toJob(job), this);
+      double radius = value[kRadiusInput].toDouble();
+
+      // Wide box/gaussian blurs discard nearly all high-frequency detail anyway, so previews
+      // blur a downsampled copy with a proportionally smaller radius and linearly upsample
+      // the result. Tap count stays roughly constant regardless of radius. Exports always
+      // take the full-resolution path.
+      const double kMinPyramidRadius = 16.0;
+
+      if ((method == kBox || method == kGaussian)
+          && globals.render_mode() == RenderMode::kOffline
+          && radius >= kMinPyramidRadius * 2) {
+        // Halve resolution until the scaled radius approaches the threshold, capped so
+        // extreme radii don't visibly posterize
+        int shrink = 2;
+        while (shrink < 8 && radius / (shrink * 2) >= kMinPyramidRadius) {
+          shrink *= 2;
+        }
+
+        VideoParams low_params = tex->params();
+        low_params.set_divider(low_params.divider() * shrink);
+
+        // The first pass samples the full-resolution input into the smaller target, so the
+        // downsample comes free with linear filtering
+        ShaderJob blur_job(value);
+        blur_job.Insert(kRadiusInput, NodeValue(NodeValue::kFloat, radius / shrink, this));
+        blur_job.Insert(QStringLiteral("resolution_in"), NodeValue(NodeValue::kVec2, tex->virtual_resolution() / shrink, this));
+        blur_job.SetIterations(iterations, kTextureInput);
+        blur_job.SetInterpolation(kTextureInput, Texture::kLinear);
+        NodeValue low_blurred(NodeValue::kTexture, Texture::Job(low_params, blur_job), this);
+
+        ShaderJob upsample;
+        upsample.SetShaderID(QStringLiteral("resample"));
+        upsample.Insert(QStringLiteral("ove_maintex"), low_blurred);
+        upsample.SetInterpolation(QStringLiteral("ove_maintex"), Texture::kLinear);
+        table->Push(NodeValue::kTexture, Texture::Job(tex->params(), upsample), this);
+      } else {
+        ShaderJob job(value);
+        job.Insert(QStringLiteral("resolution_in"), NodeValue(NodeValue::kVec2, tex->virtual_resolution(), this));
+        job.SetIterations(iterations, kTextureInput);
+        table->Push(NodeValue::kTexture, tex->toJob(job), this);
+      }
     } else {
       // If we're not performing the blur job, just push the texture
       table->Push(value[kTextureInput]);
@@ -55,6 +55,7 @@ DropShadowFilter::DropShadowFilter()
 
   SetEffectInput(kTextureInput);
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
 }
 
 void DropShadowFilter::Retranslate()
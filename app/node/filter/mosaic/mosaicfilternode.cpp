@@ -39,6 +39,7 @@ MosaicFilterNode::MosaicFilterNode()
   SetInputProperty(kVertInput, QStringLiteral("min"), 1.0);
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
   SetEffectInput(kTextureInput);
 }
 
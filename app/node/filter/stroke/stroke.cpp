@@ -49,6 +49,7 @@ StrokeFilterNode::StrokeFilterNode()
   AddInput(kInnerInput, NodeValue::kBoolean, false);
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
   SetEffectInput(kTextureInput);
 }
 
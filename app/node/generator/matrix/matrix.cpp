@@ -49,6 +49,8 @@ MatrixGenerator::MatrixGenerator()
   AddInput(kUniformScaleInput, NodeValue::kBoolean, true, InputFlags(kInputFlagNotConnectable | kInputFlagNotKeyframable));
 
   AddInput(kAnchorInput, NodeValue::kVec2, QVector2D(0.0, 0.0));
+
+  SetFlag(kTimeAgnostic);
 }
 
 QString MatrixGenerator::Name() const
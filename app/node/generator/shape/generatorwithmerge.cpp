@@ -33,6 +33,7 @@ GeneratorWithMerge::GeneratorWithMerge()
   AddInput(kBaseInput, NodeValue::kTexture, InputFlags(kInputFlagNotKeyframable));
   SetEffectInput(kBaseInput);
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
 }
 
 void GeneratorWithMerge::Retranslate()
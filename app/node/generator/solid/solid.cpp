@@ -30,6 +30,8 @@ SolidGenerator::SolidGenerator()
 {
   // Default to a color that isn't black
   AddInput(kColorInput, NodeValue::kColor, QVariant::fromValue(Color(1.0f, 0.0f, 0.0f, 1.0f)));
+
+  SetFlag(kTimeAgnostic);
 }
 
 QString SolidGenerator::Name() const
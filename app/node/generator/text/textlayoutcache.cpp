@@ -0,0 +1,55 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "textlayoutcache.h"
+
+namespace olive {
+
+TextLayoutCache::TextLayoutCache() :
+  doc_height_(0)
+{
+}
+
+bool TextLayoutCache::Get(const QString &key, QImage *image, int *doc_height)
+{
+  QMutexLocker locker(&mutex_);
+
+  if (image_.isNull() || key_ != key) {
+    return false;
+  }
+
+  // QImage is implicitly shared and the cached copy is never painted on again, so this is a
+  // cheap read-only handout
+  *image = image_;
+  *doc_height = doc_height_;
+
+  return true;
+}
+
+void TextLayoutCache::Insert(const QString &key, const QImage &image, int doc_height)
+{
+  QMutexLocker locker(&mutex_);
+
+  key_ = key;
+  image_ = image;
+  doc_height_ = doc_height;
+}
+
+}
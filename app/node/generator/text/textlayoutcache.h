@@ -0,0 +1,68 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef TEXTLAYOUTCACHE_H
+#define TEXTLAYOUTCACHE_H
+
+#include <QImage>
+#include <QMutex>
+#include <QString>
+
+namespace olive {
+
+/**
+ * @brief Remembers the rasterized layout of a text generator between frames
+ *
+ * The text generators parse, shape and rasterize their entire rich text document from
+ * scratch for every frame they appear in, even though the document only changes when the
+ * user edits it. Each generator owns one of these and keys it by the inputs that affect
+ * layout, so a static title under an animated transform costs one image draw per frame
+ * instead of a full text pipeline run.
+ *
+ * Only the most recent raster is kept - a generator renders one document, and once its text
+ * or style changes the old raster is useless. Thread-safe, since frames may be generated on
+ * several render threads at once.
+ */
+class TextLayoutCache
+{
+public:
+  TextLayoutCache();
+
+  /**
+   * @brief Retrieve the raster generated for `key`, if it was the last one rendered
+   */
+  bool Get(const QString &key, QImage *image, int *doc_height);
+
+  void Insert(const QString &key, const QImage &image, int doc_height);
+
+private:
+  QMutex mutex_;
+
+  QString key_;
+
+  QImage image_;
+
+  int doc_height_;
+
+};
+
+}
+
+#endif // TEXTLAYOUTCACHE_H
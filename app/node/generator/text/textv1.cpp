@@ -22,6 +22,7 @@
 
 #include <QAbstractTextDocumentLayout>
 #include <QTextDocument>
+#include <QtMath>
 
 namespace olive {
 
@@ -106,38 +107,67 @@ void TextGeneratorV1::GenerateFrame(FramePtr frame, const GenerateJob& job) cons
   QImage img(frame->width(), frame->height(), QImage::Format_Grayscale8);
   img.fill(0);
 
-  QTextDocument text_doc;
+  // Align to 80% width because that's considered the "title safe" area
+  int tenth_of_width = frame->video_params().width() / 10;
+  int text_width = tenth_of_width * 8;
 
-  // Set default font
-  QFont default_font;
-  default_font.setFamily(job.Get(kFontInput).toString());
-  default_font.setPointSizeF(job.Get(kFontSizeInput).toDouble());
-  text_doc.setDefaultFont(default_font);
+  QString html = job.Get(kTextInput).toString();
 
-  // Center by default
-  text_doc.setDefaultTextOption(QTextOption(Qt::AlignCenter));
+  // Everything below the layout is a painter transform, so an unchanged document is replayed
+  // from its last rasterization rather than shaped and rasterized again
+  QString layout_key = QStringLiteral("%1:%2:%3:%4:%5").arg(job.Get(kFontInput).toString(),
+                                                            QString::number(job.Get(kFontSizeInput).toDouble()),
+                                                            QString::number(job.Get(kHtmlInput).toBool()),
+                                                            QString::number(text_width),
+                                                            html);
+
+  QImage text_img;
+  int doc_height;
+  if (!layout_cache_.Get(layout_key, &text_img, &doc_height)) {
+    QTextDocument text_doc;
+
+    // Set default font
+    QFont default_font;
+    default_font.setFamily(job.Get(kFontInput).toString());
+    default_font.setPointSizeF(job.Get(kFontSizeInput).toDouble());
+    text_doc.setDefaultFont(default_font);
+
+    // Center by default
+    text_doc.setDefaultTextOption(QTextOption(Qt::AlignCenter));
+
+    if (job.Get(kHtmlInput).toBool()) {
+      html.replace('\n', QStringLiteral("<br>"));
+      text_doc.setHtml(html);
+    } else {
+      text_doc.setPlainText(html);
+    }
 
-  QString html = job.Get(kTextInput).toString();
-  if (job.Get(kHtmlInput).toBool()) {
-    html.replace('\n', QStringLiteral("<br>"));
-    text_doc.setHtml(html);
-  } else {
-    text_doc.setPlainText(html);
-  }
+    text_doc.setTextWidth(text_width);
 
-  // Align to 80% width because that's considered the "title safe" area
-  int tenth_of_width = frame->video_params().width() / 10;
-  text_doc.setTextWidth(tenth_of_width * 8);
+    doc_height = text_doc.size().height();
+
+    // Rasterize the laid out document at 1:1 for replay on later frames
+    text_img = QImage(qMax(1, text_width), qMax(1, qCeil(text_doc.size().height())), QImage::Format_Grayscale8);
+    text_img.fill(0);
+
+    QAbstractTextDocumentLayout::PaintContext ctx;
+    ctx.palette.setColor(QPalette::Text, Qt::white);
+
+    QPainter doc_painter(&text_img);
+    text_doc.documentLayout()->draw(&doc_painter, ctx);
+
+    layout_cache_.Insert(layout_key, text_img, doc_height);
+  }
 
   // Draw rich text onto image
   QPainter p(&img);
+  p.setRenderHint(QPainter::SmoothPixmapTransform);
   p.scale(1.0 / frame->video_params().divider(), 1.0 / frame->video_params().divider());
 
   // Push 10% inwards to compensate for title safe area
   p.translate(tenth_of_width, 0);
 
   TextVerticalAlign valign = static_cast<TextVerticalAlign>(job.Get(kVAlignInput).toInt());
-  int doc_height = text_doc.size().height();
 
   switch (valign) {
   case kVerticalAlignTop:
@@ -154,9 +184,7 @@ void TextGeneratorV1::GenerateFrame(FramePtr frame, const GenerateJob& job) cons
     break;
   }
 
-  QAbstractTextDocumentLayout::PaintContext ctx;
-  ctx.palette.setColor(QPalette::Text, Qt::white);
-  text_doc.documentLayout()->draw(&p, ctx);
+  p.drawImage(0, 0, text_img);
 
   // Transplant alpha channel to frame
   Color rgb = job.Get(kColorInput).toColor();
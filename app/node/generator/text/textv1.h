@@ -22,6 +22,7 @@
 #define TEXTGENERATORV1_H
 
 #include "node/node.h"
+#include "node/generator/text/textlayoutcache.h"
 
 namespace olive {
 
@@ -51,6 +52,10 @@ public:
   static const QString kFontInput;
   static const QString kFontSizeInput;
 
+private:
+  // Mutable because GenerateFrame is const and the cache is only an optimization
+  mutable TextLayoutCache layout_cache_;
+
 };
 
 }
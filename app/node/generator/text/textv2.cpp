@@ -24,6 +24,7 @@
 #include <QAbstractTextDocumentLayout>
 #include <QDateTime>
 #include <QTextDocument>
+#include <QtMath>
 
 namespace olive {
 
@@ -115,28 +116,58 @@ void TextGeneratorV2::GenerateFrame(FramePtr frame, const GenerateJob& job) cons
   img.setDotsPerMeterX(dpm);
   img.setDotsPerMeterY(dpm);
 
-  QTextDocument text_doc;
-  text_doc.documentLayout()->setPaintDevice(&img);
+  QString html = job.Get(kTextInput).toString();
+  QVector2D size = job.Get(kSizeInput).toVec2();
 
-  // Set default font
-  QFont default_font;
-  default_font.setFamily(job.Get(kFontInput).toString());
-  default_font.setPointSizeF(job.Get(kFontSizeInput).toDouble());
-  text_doc.setDefaultFont(default_font);
+  // Everything below the layout is a painter transform, so an unchanged document is replayed
+  // from its last rasterization rather than shaped and rasterized again
+  QString layout_key = QStringLiteral("%1:%2:%3:%4:%5").arg(job.Get(kFontInput).toString(),
+                                                            QString::number(job.Get(kFontSizeInput).toDouble()),
+                                                            QString::number(job.Get(kHtmlInput).toBool()),
+                                                            QString::number(size.x()),
+                                                            html);
+
+  QImage text_img;
+  int doc_height;
+  if (!layout_cache_.Get(layout_key, &text_img, &doc_height)) {
+    QTextDocument text_doc;
+    text_doc.documentLayout()->setPaintDevice(&img);
+
+    // Set default font
+    QFont default_font;
+    default_font.setFamily(job.Get(kFontInput).toString());
+    default_font.setPointSizeF(job.Get(kFontSizeInput).toDouble());
+    text_doc.setDefaultFont(default_font);
+
+    if (job.Get(kHtmlInput).toBool()) {
+      html.replace('\n', QStringLiteral("<br>"));
+      text_doc.setHtml(html);
+    } else {
+      text_doc.setPlainText(html);
+    }
 
-  QString html = job.Get(kTextInput).toString();
-  if (job.Get(kHtmlInput).toBool()) {
-    html.replace('\n', QStringLiteral("<br>"));
-    text_doc.setHtml(html);
-  } else {
-    text_doc.setPlainText(html);
-  }
+    text_doc.setTextWidth(size.x());
 
-  QVector2D size = job.Get(kSizeInput).toVec2();
-  text_doc.setTextWidth(size.x());
+    doc_height = text_doc.size().height();
+
+    // Rasterize the laid out document at 1:1 for replay on later frames
+    text_img = QImage(qMax(1, qCeil(size.x())), qMax(1, qCeil(text_doc.size().height())), QImage::Format_Grayscale8);
+    text_img.setDotsPerMeterX(dpm);
+    text_img.setDotsPerMeterY(dpm);
+    text_img.fill(Qt::transparent);
+
+    QAbstractTextDocumentLayout::PaintContext ctx;
+    ctx.palette.setColor(QPalette::Text, Qt::white);
+
+    QPainter doc_painter(&text_img);
+    text_doc.documentLayout()->draw(&doc_painter, ctx);
+
+    layout_cache_.Insert(layout_key, text_img, doc_height);
+  }
 
   // Draw rich text onto image
   QPainter p(&img);
+  p.setRenderHint(QPainter::SmoothPixmapTransform);
   p.scale(1.0 / frame->video_params().divider(), 1.0 / frame->video_params().divider());
 
 
@@ -146,7 +177,6 @@ void TextGeneratorV2::GenerateFrame(FramePtr frame, const GenerateJob& job) cons
   p.setClipRect(0, 0, size.x(), size.y());
 
   TextVerticalAlign valign = static_cast<TextVerticalAlign>(job.Get(kVAlignInput).toInt());
-  int doc_height = text_doc.size().height();
 
   switch (valign) {
   case kVerticalAlignTop:
@@ -161,10 +191,7 @@ void TextGeneratorV2::GenerateFrame(FramePtr frame, const GenerateJob& job) cons
     break;
   }
 
-  QAbstractTextDocumentLayout::PaintContext ctx;
-  ctx.palette.setColor(QPalette::Text, Qt::white);
-
-  text_doc.documentLayout()->draw(&p, ctx);
+  p.drawImage(0, 0, text_img);
 
   // Transplant alpha channel to frame
   Color rgba = job.Get(kColorInput).toColor();
@@ -22,6 +22,7 @@
 #define TEXTGENERATORV2_H
 
 #include "node/generator/shape/shapenodebase.h"
+#include "node/generator/text/textlayoutcache.h"
 
 namespace olive {
 
@@ -50,6 +51,10 @@ public:
   static const QString kFontInput;
   static const QString kFontSizeInput;
 
+private:
+  // Mutable because GenerateFrame is const and the cache is only an optimization
+  mutable TextLayoutCache layout_cache_;
+
 };
 
 }
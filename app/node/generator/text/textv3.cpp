@@ -23,6 +23,7 @@
 #include <QAbstractTextDocumentLayout>
 #include <QDateTime>
 #include <QTextDocument>
+#include <QtMath>
 
 #include "common/html.h"
 #include "core.h"
@@ -139,17 +140,45 @@ void TextGeneratorV3::GenerateFrame(FramePtr frame, const GenerateJob& job) cons
   img.setDotsPerMeterX(dpm);
   img.setDotsPerMeterY(dpm);
 
-  QTextDocument text_doc;
-  text_doc.documentLayout()->setPaintDevice(&img);
-
   QString html = job.Get(kTextInput).toString();
-  Html::HtmlToDoc(&text_doc, html);
-
   QVector2D size = job.Get(kSizeInput).toVec2();
-  text_doc.setTextWidth(size.x());
+
+  // Only the text and the wrap width affect the document layout - everything below here is a
+  // painter transform - so static text under an animated transform replays the last raster
+  // instead of re-running the HTML parse, shaping and glyph rasterization every frame
+  QString layout_key = QStringLiteral("%1:%2").arg(QString::number(size.x()), html);
+
+  QImage text_img;
+  int doc_height;
+  if (!layout_cache_.Get(layout_key, &text_img, &doc_height)) {
+    QTextDocument text_doc;
+    text_doc.documentLayout()->setPaintDevice(&img);
+
+    Html::HtmlToDoc(&text_doc, html);
+
+    text_doc.setTextWidth(size.x());
+
+    doc_height = text_doc.size().height();
+
+    // Rasterize the laid out document at 1:1 for replay on later frames
+    text_img = QImage(qMax(1, qCeil(size.x())), qMax(1, qCeil(text_doc.size().height())), QImage::Format_ARGB32_Premultiplied);
+    text_img.setDotsPerMeterX(dpm);
+    text_img.setDotsPerMeterY(dpm);
+    text_img.fill(Qt::transparent);
+
+    // Ensure default text color is white
+    QAbstractTextDocumentLayout::PaintContext ctx;
+    ctx.palette.setColor(QPalette::Text, Qt::white);
+
+    QPainter doc_painter(&text_img);
+    text_doc.documentLayout()->draw(&doc_painter, ctx);
+
+    layout_cache_.Insert(layout_key, text_img, doc_height);
+  }
 
   // Draw rich text onto image
   QPainter p(&img);
+  p.setRenderHint(QPainter::SmoothPixmapTransform);
   p.scale(1.0 / frame->video_params().divider(), 1.0 / frame->video_params().divider());
 
   QVector2D pos = job.Get(kPositionInput).toVec2();
@@ -162,18 +191,14 @@ void TextGeneratorV3::GenerateFrame(FramePtr frame, const GenerateJob& job) cons
     // Do nothing
     break;
   case kVAlignMiddle:
-    p.translate(0, size.y()/2-text_doc.size().height()/2);
+    p.translate(0, size.y()/2-doc_height/2);
     break;
   case kVAlignBottom:
-    p.translate(0, size.y()-text_doc.size().height());
+    p.translate(0, size.y()-doc_height);
     break;
   }
 
-  // Ensure default text color is white
-  QAbstractTextDocumentLayout::PaintContext ctx;
-  ctx.palette.setColor(QPalette::Text, Qt::white);
-
-  text_doc.documentLayout()->draw(&p, ctx);
+  p.drawImage(0, 0, text_img);
 }
 
 void TextGeneratorV3::UpdateGizmoPositions(const NodeValueRow &row, const NodeGlobals &globals)
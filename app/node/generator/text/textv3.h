@@ -22,6 +22,7 @@
 #define TEXTGENERATORV3_H
 
 #include "node/generator/shape/shapenodebase.h"
+#include "node/generator/text/textlayoutcache.h"
 #include "node/gizmo/text.h"
 
 namespace olive {
@@ -77,6 +78,9 @@ private:
 
   bool dont_emit_valign_;
 
+  // Mutable because GenerateFrame is const and the cache is only an optimization
+  mutable TextLayoutCache layout_cache_;
+
 private slots:
   void GizmoActivated();
   void GizmoDeactivated();
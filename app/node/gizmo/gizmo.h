@@ -37,6 +37,20 @@ public:
 
   virtual void Draw(QPainter *p) const {}
 
+  /**
+   * @brief Whether a point in scene coordinates hits this gizmo
+   *
+   * `t` is the scene-to-screen transform the gizmo was last drawn with, for gizmos whose hit
+   * area has a fixed on-screen size. Subclasses keep whatever cached geometry they need for
+   * this to be cheap (see PathGizmo); the base implementation hits nothing.
+   */
+  virtual bool HitTest(const QPointF &p, const QTransform &t) const
+  {
+    Q_UNUSED(p)
+    Q_UNUSED(t)
+    return false;
+  }
+
   const NodeGlobals &GetGlobals() const { return globals_; }
   void SetGlobals(const NodeGlobals &globals) { globals_ = globals; }
 
@@ -28,6 +28,25 @@ PathGizmo::PathGizmo(QObject *parent) :
 
 }
 
+void PathGizmo::SetPath(const QPainterPath &path)
+{
+  if (path_ != path) {
+    path_ = path;
+
+    // Tessellate once per actual change rather than per hit test
+    hit_polygon_ = path_.toFillPolygon();
+    bounding_rect_ = hit_polygon_.boundingRect();
+  }
+}
+
+bool PathGizmo::HitTest(const QPointF &p, const QTransform &t) const
+{
+  Q_UNUSED(t)
+
+  // Cheap cached-rect rejection before the per-edge polygon scan
+  return bounding_rect_.contains(p) && hit_polygon_.containsPoint(p, Qt::OddEvenFill);
+}
+
 void PathGizmo::Draw(QPainter *p) const
 {
   // Draw transposed black
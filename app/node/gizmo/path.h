@@ -34,13 +34,27 @@ public:
   explicit PathGizmo(QObject *parent = nullptr);
 
   const QPainterPath &GetPath() const { return path_; }
-  void SetPath(const QPainterPath &path) { path_ = path; }
+
+  void SetPath(const QPainterPath &path);
 
   virtual void Draw(QPainter *p) const override;
 
+  virtual bool HitTest(const QPointF &p, const QTransform &t) const override;
+
 private:
   QPainterPath path_;
 
+  /**
+   * @brief Flattened copy of path_ for hit-testing
+   *
+   * QPainterPath::contains() re-tessellates the curves on every call, which made clicking and
+   * dragging over complex masks stutter. The flattening happens once in SetPath() when the path
+   * actually changes and hit tests reduce to a rect check plus a point-in-polygon scan.
+   */
+  QPolygonF hit_polygon_;
+
+  QRectF bounding_rect_;
+
 };
 
 }
@@ -70,6 +70,11 @@ void PointGizmo::Draw(QPainter *p) const
   }
 }
 
+bool PointGizmo::HitTest(const QPointF &p, const QTransform &t) const
+{
+  return GetClickingRect(t).contains(p);
+}
+
 QRectF PointGizmo::GetClickingRect(const QTransform &t) const
 {
   return GetDrawingRect(t, GetStandardRadius());
@@ -52,6 +52,8 @@ public:
 
   virtual void Draw(QPainter *p) const override;
 
+  virtual bool HitTest(const QPointF &p, const QTransform &t) const override;
+
   QRectF GetClickingRect(const QTransform &t) const;
 
 private:
@@ -42,4 +42,12 @@ void PolygonGizmo::Draw(QPainter *p) const
   p->drawPolyline(polygon_);
 }
 
+bool PolygonGizmo::HitTest(const QPointF &p, const QTransform &t) const
+{
+  Q_UNUSED(t)
+
+  // Cheap cached-rect rejection before the per-edge polygon scan
+  return bounding_rect_.contains(p) && polygon_.containsPoint(p, Qt::OddEvenFill);
+}
+
 }
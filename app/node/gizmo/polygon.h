@@ -34,13 +34,25 @@ public:
   explicit PolygonGizmo(QObject *parent = nullptr);
 
   const QPolygonF &GetPolygon() const { return polygon_; }
-  void SetPolygon(const QPolygonF &polygon) { polygon_ = polygon; }
+
+  void SetPolygon(const QPolygonF &polygon)
+  {
+    if (polygon_ != polygon) {
+      polygon_ = polygon;
+      bounding_rect_ = polygon_.boundingRect();
+    }
+  }
 
   virtual void Draw(QPainter *p) const override;
 
+  virtual bool HitTest(const QPointF &p, const QTransform &t) const override;
+
 private:
   QPolygonF polygon_;
 
+  // Cached with the polygon for cheap hit rejection
+  QRectF bounding_rect_;
+
 };
 
 }
@@ -31,6 +31,14 @@ class ScreenGizmo : public DraggableGizmo
 public:
   explicit ScreenGizmo(QObject *parent = nullptr);
 
+  // NOTE: Perhaps this should limit to the actual visible screen space? We'll see.
+  virtual bool HitTest(const QPointF &p, const QTransform &t) const override
+  {
+    Q_UNUSED(p)
+    Q_UNUSED(t)
+    return true;
+  }
+
 };
 
 }
@@ -24,6 +24,7 @@
 #include <QVector2D>
 
 #include "render/loopmode.h"
+#include "render/rendermodes.h"
 #include "render/videoparams.h"
 
 namespace olive {
@@ -31,18 +32,21 @@ namespace olive {
 class NodeGlobals
 {
 public:
-  NodeGlobals(){}
+  NodeGlobals() :
+    render_mode_(RenderMode::kOnline)
+  {}
 
-  NodeGlobals(const VideoParams &vparam, const AudioParams &aparam, const TimeRange &time, LoopMode loop_mode) :
+  NodeGlobals(const VideoParams &vparam, const AudioParams &aparam, const TimeRange &time, LoopMode loop_mode, RenderMode::Mode render_mode = RenderMode::kOnline) :
     video_params_(vparam),
     audio_params_(aparam),
     time_(time),
-    loop_mode_(loop_mode)
+    loop_mode_(loop_mode),
+    render_mode_(render_mode)
   {
   }
 
-  NodeGlobals(const VideoParams &vparam, const AudioParams &aparam, const rational &time, LoopMode loop_mode) :
-    NodeGlobals(vparam, aparam, TimeRange(time, time + vparam.frame_rate_as_time_base()), loop_mode)
+  NodeGlobals(const VideoParams &vparam, const AudioParams &aparam, const rational &time, LoopMode loop_mode, RenderMode::Mode render_mode = RenderMode::kOnline) :
+    NodeGlobals(vparam, aparam, TimeRange(time, time + vparam.frame_rate_as_time_base()), loop_mode, render_mode)
   {
   }
 
@@ -53,11 +57,20 @@ public:
   const TimeRange &time() const { return time_; }
   LoopMode loop_mode() const { return loop_mode_; }
 
+  /**
+   * @brief Whether this render is a realtime preview (kOffline) or an export (kOnline)
+   *
+   * Nodes may trade accuracy for speed when previewing, but the table they push must not
+   * otherwise depend on anything outside their inputs.
+   */
+  RenderMode::Mode render_mode() const { return render_mode_; }
+
 private:
   VideoParams video_params_;
   AudioParams audio_params_;
   TimeRange time_;
   LoopMode loop_mode_;
+  RenderMode::Mode render_mode_;
 
 };
 
@@ -20,6 +20,8 @@
 
 #include "inputimmediate.h"
 
+#include <algorithm>
+
 #include "common/lerp.h"
 #include "common/tohex.h"
 
@@ -62,10 +64,14 @@ QVector<NodeKeyframe*> NodeInputImmediate::get_keyframe_at_time(const rational &
 NodeKeyframe* NodeInputImmediate::get_keyframe_at_time_on_track(const rational &time, int track) const
 {
   if (!is_using_standard_value(track)) {
-    foreach (NodeKeyframe* key, keyframe_tracks_.at(track)) {
-      if (key->time() == time) {
-        return key;
-      }
+    // Tracks are sorted by time, so we can binary search
+    const NodeKeyframeTrack& key_track = keyframe_tracks_.at(track);
+
+    auto it = std::lower_bound(key_track.cbegin(), key_track.cend(), time,
+                               [](NodeKeyframe *key, const rational &t) { return key->time() < t; });
+
+    if (it != key_track.cend() && (*it)->time() == time) {
+      return *it;
     }
   }
 
@@ -88,24 +94,22 @@ NodeKeyframe* NodeInputImmediate::get_closest_keyframe_to_time_on_track(const ra
     return key_track.last();
   }
 
-  for (int i=1;i<key_track.size();i++) {
-    NodeKeyframe* prev_key = key_track.at(i-1);
-    NodeKeyframe* next_key = key_track.at(i);
+  // Binary search for the keyframes bracketing this time
+  auto next = std::lower_bound(key_track.cbegin(), key_track.cend(), time,
+                               [](NodeKeyframe *key, const rational &t) { return key->time() < t; });
 
-    if (prev_key->time() <= time && next_key->time() >= time) {
-      // Return whichever is closer
-      rational prev_diff = time - prev_key->time();
-      rational next_diff = next_key->time() - time;
+  NodeKeyframe* prev_key = *(next - 1);
+  NodeKeyframe* next_key = *next;
 
-      if (next_diff < prev_diff) {
-        return next_key;
-      } else {
-        return prev_key;
-      }
-    }
-  }
+  // Return whichever is closer
+  rational prev_diff = time - prev_key->time();
+  rational next_diff = next_key->time() - time;
 
-  return nullptr;
+  if (next_diff < prev_diff) {
+    return next_key;
+  } else {
+    return prev_key;
+  }
 }
 
 NodeKeyframe *NodeInputImmediate::get_closest_keyframe_before_time(const rational &time) const
@@ -113,10 +117,14 @@ NodeKeyframe *NodeInputImmediate::get_closest_keyframe_before_time(const rationa
   NodeKeyframe* key = nullptr;
 
   foreach (const NodeKeyframeTrack& track, keyframe_tracks_) {
-    foreach (NodeKeyframe* k, track) {
-      if (k->time() >= time) {
-        break;
-      } else if (!key || k->time() > key->time()) {
+    // The last keyframe before the time is the one just under the first at/after it
+    auto it = std::lower_bound(track.cbegin(), track.cend(), time,
+                               [](NodeKeyframe *k, const rational &t) { return k->time() < t; });
+
+    if (it != track.cbegin()) {
+      NodeKeyframe* k = *(it - 1);
+
+      if (!key || k->time() > key->time()) {
         key = k;
       }
     }
@@ -130,12 +138,13 @@ NodeKeyframe* NodeInputImmediate::get_closest_keyframe_after_time(const rational
   NodeKeyframe* key = nullptr;
 
   foreach (const NodeKeyframeTrack& track, keyframe_tracks_) {
-    for (int i=track.size()-1;i>=0;i--) {
-      NodeKeyframe* k = track.at(i);
+    auto it = std::upper_bound(track.cbegin(), track.cend(), time,
+                               [](const rational &t, NodeKeyframe *k) { return t < k->time(); });
+
+    if (it != track.cend()) {
+      NodeKeyframe* k = *it;
 
-      if (k->time() <= time) {
-        break;
-      } else if (!key || k->time() < key->time()) {
+      if (!key || k->time() < key->time()) {
         key = k;
       }
     }
@@ -161,12 +170,13 @@ bool NodeInputImmediate::has_keyframe_at_time(const rational &time) const
     return false;
   }
 
-  // Loop through keyframes to see if any match
+  // Binary search each track to see if any match
   foreach (const NodeKeyframeTrack& track, keyframe_tracks_) {
-    foreach (NodeKeyframe* key, track) {
-      if (key->time() == time) {
-        return true;
-      }
+    auto it = std::lower_bound(track.cbegin(), track.cend(), time,
+                               [](NodeKeyframe *key, const rational &t) { return key->time() < t; });
+
+    if (it != track.cend() && (*it)->time() == time) {
+      return true;
     }
   }
 
@@ -181,6 +191,9 @@ void NodeInputImmediate::set_data_type(NodeValue::Type type)
   keyframe_tracks_.resize(track_size);
   standard_value_.resize(track_size);
 
+  keyframe_cursors_.clear();
+  keyframe_cursors_.fill(-1, track_size);
+
   set_split_standard_value(default_value_);
 }
 
@@ -224,19 +237,14 @@ void NodeInputImmediate::insert_keyframe(NodeKeyframe* key)
 {
   NodeKeyframeTrack& key_track = keyframe_tracks_[key->track()];
 
-  int insert_index = key_track.size();
-
-  for (int i=0;i<key_track.size();i++) {
-    NodeKeyframe* compare = key_track.at(i);
+  // Track is sorted by time, so binary search for the insertion point
+  auto it = std::upper_bound(key_track.cbegin(), key_track.cend(), key->time(),
+                             [](const rational &t, NodeKeyframe *k) { return t < k->time(); });
 
-    // Ensure we aren't trying to insert two keyframes at the same time
-    Q_ASSERT(compare->time() != key->time());
+  // Ensure we aren't trying to insert two keyframes at the same time
+  Q_ASSERT(it == key_track.cbegin() || (*(it - 1))->time() != key->time());
 
-    if (compare->time() > key->time()) {
-      insert_index = i;
-      break;
-    }
-  }
+  int insert_index = it - key_track.cbegin();
 
   key_track.insert(insert_index, key);
 
@@ -152,6 +152,25 @@ public:
 
   void set_data_type(NodeValue::Type type);
 
+  /**
+   * @brief Retrieve the index of the keyframe that bracketed the last evaluation on a track
+   *
+   * This is purely a lookup hint for sequential playback - the caller must validate it against
+   * the current track contents before using it, so a stale cursor is never incorrect, only
+   * slower. Returns -1 if no hint is available.
+   */
+  int keyframe_cursor(int track) const
+  {
+    return track < keyframe_cursors_.size() ? keyframe_cursors_.at(track) : -1;
+  }
+
+  void set_keyframe_cursor(int track, int index) const
+  {
+    if (track < keyframe_cursors_.size()) {
+      keyframe_cursors_[track] = index;
+    }
+  }
+
 private:
   /**
    * @brief Non-keyframed value
@@ -175,6 +194,11 @@ private:
    */
   bool keyframing_;
 
+  /**
+   * @brief Last bracketing keyframe index per track, see keyframe_cursor()
+   */
+  mutable QVector<int> keyframe_cursors_;
+
 };
 
 }
@@ -20,12 +20,40 @@
 
 #include "keyframe.h"
 
+#include <atomic>
+#include <QHash>
+
 #include "node.h"
 
 namespace olive {
 
 const NodeKeyframe::Type NodeKeyframe::kDefaultType = kLinear;
 
+namespace {
+
+struct BezierSegmentCache {
+  const NodeKeyframe *before = nullptr;
+  const NodeKeyframe *after = nullptr;
+  quint64 before_serial = 0;
+  quint64 after_serial = 0;
+
+  // Power-form coefficients of the segment's X(t) and Y(t) for t in [0, 1],
+  // i.e. X(t) = x[0] + x[1]*t + x[2]*t^2 + x[3]*t^3
+  double x[4];
+  double y[4];
+};
+
+// Evaluation runs concurrently on several render threads, so the segment caches are
+// thread-local - no locking, and each thread tends to re-evaluate the same few segments
+// across consecutive samples anyway. Bounded since keyframes come and go with edits.
+thread_local QHash<const NodeKeyframe*, BezierSegmentCache> bezier_segment_cache;
+const int kBezierSegmentCacheMaxEntries = 1024;
+
+// Global serial source so every keyframe change gets a process-wide unique number
+std::atomic<quint64> next_change_serial{0};
+
+}
+
 NodeKeyframe::NodeKeyframe(const rational &time, const QVariant &value, Type type, int track, int element, const QString &input, QObject *parent) :
   time_(time),
   value_(value),
@@ -36,7 +64,8 @@ NodeKeyframe::NodeKeyframe(const rational &time, const QVariant &value, Type typ
   track_(track),
   element_(element),
   previous_(nullptr),
-  next_(nullptr)
+  next_(nullptr),
+  change_serial_(++next_change_serial)
 {
   setParent(parent);
 }
@@ -44,6 +73,7 @@ NodeKeyframe::NodeKeyframe(const rational &time, const QVariant &value, Type typ
 NodeKeyframe::NodeKeyframe()
 {
   type_ = NodeKeyframe::kLinear;
+  change_serial_ = ++next_change_serial;
 }
 
 NodeKeyframe::~NodeKeyframe()
@@ -77,6 +107,7 @@ const rational &NodeKeyframe::time() const
 void NodeKeyframe::set_time(const rational &time)
 {
   time_ = time;
+  BumpChangeSerial();
   emit TimeChanged(time_);
 }
 
@@ -88,6 +119,7 @@ const QVariant &NodeKeyframe::value() const
 void NodeKeyframe::set_value(const QVariant &value)
 {
   value_ = value;
+  BumpChangeSerial();
   emit ValueChanged(value_);
 }
 
@@ -126,6 +158,7 @@ void NodeKeyframe::set_type(const NodeKeyframe::Type &type)
 void NodeKeyframe::set_type_no_bezier_adj(const Type &type)
 {
   type_ = type;
+  BumpChangeSerial();
   emit TypeChanged(type_);
 }
 
@@ -137,6 +170,7 @@ const QPointF &NodeKeyframe::bezier_control_in() const
 void NodeKeyframe::set_bezier_control_in(const QPointF &control)
 {
   bezier_control_in_ = control;
+  BumpChangeSerial();
   emit BezierControlInChanged(bezier_control_in_);
 }
 
@@ -148,6 +182,7 @@ const QPointF &NodeKeyframe::bezier_control_out() const
 void NodeKeyframe::set_bezier_control_out(const QPointF &control)
 {
   bezier_control_out_ = control;
+  BumpChangeSerial();
   emit BezierControlOutChanged(bezier_control_out_);
 }
 
@@ -204,6 +239,108 @@ NodeKeyframe::BezierType NodeKeyframe::get_opposing_bezier_type(NodeKeyframe::Be
   }
 }
 
+double NodeKeyframe::EvaluateBezierAt(const NodeKeyframe *before, const NodeKeyframe *after, double before_val, double after_val, double time)
+{
+  if (bezier_segment_cache.size() >= kBezierSegmentCacheMaxEntries && !bezier_segment_cache.contains(before)) {
+    bezier_segment_cache.clear();
+  }
+
+  BezierSegmentCache &seg = bezier_segment_cache[before];
+
+  if (seg.before != before || seg.after != after
+      || seg.before_serial != before->change_serial() || seg.after_serial != after->change_serial()) {
+    // (Re)compute the segment's polynomial coefficients
+    double t0 = before->time().toDouble();
+    double t1 = after->time().toDouble();
+
+    double cx1, cy1, cx2, cy2;
+
+    if (before->type() == kBezier && after->type() == kBezier) {
+      // Cubic bezier with two control points
+      QPointF out_handle = before->valid_bezier_control_out();
+      QPointF in_handle = after->valid_bezier_control_in();
+
+      cx1 = t0 + out_handle.x();
+      cy1 = before_val + out_handle.y();
+      cx2 = t1 + in_handle.x();
+      cy2 = after_val + in_handle.y();
+    } else {
+      // Quadratic bezier with one control point, degree-elevated to an exact cubic so both
+      // forms share the same evaluation path
+      double qx, qy;
+
+      if (before->type() == kBezier) {
+        qx = t0 + before->valid_bezier_control_out().x();
+        qy = before_val + before->valid_bezier_control_out().y();
+      } else {
+        qx = t1 + after->valid_bezier_control_in().x();
+        qy = after_val + after->valid_bezier_control_in().y();
+      }
+
+      cx1 = t0 + (qx - t0) * (2.0 / 3.0);
+      cy1 = before_val + (qy - before_val) * (2.0 / 3.0);
+      cx2 = t1 + (qx - t1) * (2.0 / 3.0);
+      cy2 = after_val + (qy - after_val) * (2.0 / 3.0);
+    }
+
+    seg.x[0] = t0;
+    seg.x[1] = 3.0 * (cx1 - t0);
+    seg.x[2] = 3.0 * (cx2 - 2.0*cx1 + t0);
+    seg.x[3] = t1 - 3.0*cx2 + 3.0*cx1 - t0;
+
+    seg.y[0] = before_val;
+    seg.y[1] = 3.0 * (cy1 - before_val);
+    seg.y[2] = 3.0 * (cy2 - 2.0*cy1 + before_val);
+    seg.y[3] = after_val - 3.0*cy2 + 3.0*cy1 - before_val;
+
+    seg.before = before;
+    seg.after = after;
+    seg.before_serial = before->change_serial();
+    seg.after_serial = after->change_serial();
+  }
+
+  // Solve X(t) = time. The valid handles keep X(t) monotonic over the segment, so Newton from a
+  // linear initial guess converges in a couple of steps; a shrinking bisection bracket guards
+  // against a flat derivative near the endpoints.
+  double span = seg.x[1] + seg.x[2] + seg.x[3];
+  double t = (span > 0.0) ? (time - seg.x[0]) / span : 0.0;
+  t = qBound(0.0, t, 1.0);
+
+  double lo = 0.0;
+  double hi = 1.0;
+
+  for (int i=0; i<8; i++) {
+    double xt = seg.x[0] + t*(seg.x[1] + t*(seg.x[2] + t*seg.x[3]));
+    double err = xt - time;
+
+    if (qAbs(err) < 1e-9) {
+      break;
+    }
+
+    if (err > 0.0) {
+      hi = t;
+    } else {
+      lo = t;
+    }
+
+    double dx = seg.x[1] + t*(2.0*seg.x[2] + 3.0*t*seg.x[3]);
+    double next_t = (dx > 1e-12) ? (t - err/dx) : t;
+
+    if (next_t <= lo || next_t >= hi) {
+      next_t = 0.5 * (lo + hi);
+    }
+
+    t = next_t;
+  }
+
+  return seg.y[0] + t*(seg.y[1] + t*(seg.y[2] + t*seg.y[3]));
+}
+
+void NodeKeyframe::BumpChangeSerial()
+{
+  change_serial_ = ++next_change_serial;
+}
+
 bool NodeKeyframe::has_sibling_at_time(const rational &t) const
 {
   NodeKeyframe *k = parent()->GetKeyframeAtTimeOnTrack(input(), t, track(), element());
@@ -218,7 +355,7 @@ bool NodeKeyframe::load(QXmlStreamReader *reader, NodeValue::Type data_type)
 
   XMLAttributeLoop(reader, attr) {
     if (attr.name() == QStringLiteral("input")) {
-      key_input = attr.value().toString();
+      key_input = XMLInternString(attr.value().toString());
     } else if (attr.name() == QStringLiteral("time")) {
       this->set_time(rational::fromString(attr.value().toString().toStdString()));
     } else if (attr.name() == QStringLiteral("type")) {
@@ -143,6 +143,25 @@ public:
    */
   static BezierType get_opposing_bezier_type(BezierType type);
 
+  /**
+   * @brief Serial number incremented whenever this keyframe changes in a way that affects interpolation
+   *
+   * Used to validate cached bezier segment coefficients. Serials are unique process-wide, so a
+   * stale cache entry can never falsely match a different keyframe allocated at the same address.
+   */
+  quint64 change_serial() const { return change_serial_; }
+
+  /**
+   * @brief Interpolate the bezier segment between two keyframes at a given time
+   *
+   * At least one of the keyframes must be of kBezier type (the segment is cubic when both have
+   * handles and quadratic when only one does). The segment's polynomial coefficients are cached
+   * and revalidated against the keyframes' change serials, so repeated evaluations - of which an
+   * animated parameter performs one per track per frame - cost a handful of multiplies rather
+   * than a full iterative solve from scratch.
+   */
+  static double EvaluateBezierAt(const NodeKeyframe *before, const NodeKeyframe *after, double before_val, double after_val, double time);
+
   NodeKeyframe* previous() const
   {
     return previous_;
@@ -195,6 +214,8 @@ signals:
   void BezierControlOutChanged(const QPointF& d);
 
 private:
+  void BumpChangeSerial();
+
   rational time_;
 
   QVariant value_;
@@ -215,6 +236,8 @@ private:
 
   NodeKeyframe* next_;
 
+  quint64 change_serial_;
+
 };
 
 using NodeKeyframeTrack = QVector<NodeKeyframe*>;
@@ -48,6 +48,7 @@ ColorDifferenceKeyNode::ColorDifferenceKeyNode()
   AddInput(kMaskOnlyInput, NodeValue::kBoolean, false);
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
   SetEffectInput(kTextureInput);
 }
 
@@ -97,6 +98,10 @@ void ColorDifferenceKeyNode::Value(const NodeValueRow &value, const NodeGlobals
   if (TexturePtr tex = value[kTextureInput].toTexture()) {
     ShaderJob job;
     job.Insert(value);
+
+    // Per-pixel on its main input - the matte samplers are passed through as-is
+    job.SetFusableInput(kTextureInput);
+
     table->Push(NodeValue::kTexture, tex->toJob(job), this);
   }
 }
@@ -37,6 +37,7 @@ DespillNode::DespillNode()
   AddInput(kPreserveLuminanceInput, NodeValue::kBoolean, false);
 
   SetFlag(kVideoEffect);
+  SetFlag(kTimeAgnostic);
   SetEffectInput(kTextureInput);
 }
 
@@ -84,6 +85,9 @@ void DespillNode::Value(const NodeValueRow &value, const NodeGlobals &globals, N
   ShaderJob job;
   job.Insert(value);
 
+  // Pure per-pixel channel operation, safe to fuse into an adjacent pass
+  job.SetFusableInput(kTextureInput);
+
   // Set luma coefficients
   double luma_coeffs[3] = {0.0f, 0.0f, 0.0f};
   project()->color_manager()->GetDefaultLumaCoefs(luma_coeffs);
@@ -40,6 +40,8 @@ MathNode::MathNode()
   AddInput(kParamBIn, NodeValue::kFloat, 0.0);
   SetInputProperty(kParamBIn, QStringLiteral("decimalplaces"), 8);
   SetInputProperty(kParamBIn, QStringLiteral("autotrim"), true);
+
+  SetFlag(kTimeAgnostic);
 }
 
 QString MathNode::Name() const
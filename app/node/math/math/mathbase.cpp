@@ -23,6 +23,7 @@
 #include <QMatrix4x4>
 #include <QVector2D>
 
+#include "audio/samplekernels.h"
 #include "common/tohex.h"
 #include "node/distort/transform/transformdistortnode.h"
 
@@ -185,48 +186,6 @@ void MathNodeBase::PerformAllOnFloatBuffer(Operation operation, float *a, float
   }
 }
 
-#if defined(Q_PROCESSOR_X86) || defined(Q_PROCESSOR_ARM)
-void MathNodeBase::PerformAllOnFloatBufferSSE(Operation operation, float *a, float b, int start, int end)
-{
-  int end_divisible_4 = (end / 4) * 4;
-
-  // Load number to multiply by into buffer
-  __m128 mult = _mm_load1_ps(&b);
-
-  switch (operation) {
-  case kOpAdd:
-    // Loop all values
-    for(int j = 0; j < end_divisible_4; j+=4) {
-      _mm_storeu_ps(a + start + j, _mm_add_ps(_mm_loadu_ps(a + start + j), mult));
-    }
-    break;
-  case kOpSubtract:
-    for(int j = 0; j < end_divisible_4; j+=4) {
-      _mm_storeu_ps(a + start + j, _mm_sub_ps(_mm_loadu_ps(a + start + j), mult));
-    }
-    break;
-  case kOpMultiply:
-    for(int j = 0; j < end_divisible_4; j+=4) {
-      _mm_storeu_ps(a + start + j, _mm_mul_ps(_mm_loadu_ps(a + start + j), mult));
-    }
-    break;
-  case kOpDivide:
-    for(int j = 0; j < end_divisible_4; j+=4) {
-      _mm_storeu_ps(a + start + j, _mm_div_ps(_mm_loadu_ps(a + start + j), mult));
-    }
-    break;
-  case kOpPower:
-    // Fallback for operations we can't support here
-    end_divisible_4 = 0;
-    break;
-  }
-
-  // Handle last 1-3 bytes if necessary, or all bytes if we couldn't
-  // support this op on SSE
-  PerformAllOnFloatBuffer(operation, a, b, end_divisible_4, end);
-}
-#endif
-
 void MathNodeBase::ValueInternal(Operation operation, Pairing pairing, const QString& param_a_in, const NodeValue& val_a, const QString& param_b_in, const NodeValue& val_b, const NodeGlobals &globals, NodeValueTable *output) const
 {
   switch (pairing) {
@@ -318,9 +277,14 @@ void MathNodeBase::ValueInternal(Operation operation, Pairing pairing, const QSt
     SampleBuffer mixed_samples = SampleBuffer(samples_a.audio_params(), max_samples);
 
     for (int i=0;i<mixed_samples.audio_params().channel_count();i++) {
-      // Mix samples that are in both buffers
-      for (size_t j=0;j<min_samples;j++) {
-        mixed_samples.data(i)[j] = PerformAll<float, float>(operation, samples_a.data(i)[j], samples_b.data(i)[j]);
+      if (operation == kOpAdd) {
+        // Track mixing is a straight sum, which has a runtime-dispatched SIMD kernel
+        SampleKernels::Sum(samples_a.data(i), samples_b.data(i), mixed_samples.data(i), min_samples);
+      } else {
+        // Mix samples that are in both buffers
+        for (size_t j=0;j<min_samples;j++) {
+          mixed_samples.data(i)[j] = PerformAll<float, float>(operation, samples_a.data(i)[j], samples_b.data(i)[j]);
+        }
       }
     }
 
@@ -410,12 +374,25 @@ void MathNodeBase::ValueInternal(Operation operation, Pairing pairing, const QSt
       if (IsInputStatic(number_param)) {
         if (!NumberIsNoOp(operation, number)) {
           for (int i=0;i<buffer.audio_params().channel_count();i++) {
-#if defined(Q_PROCESSOR_X86) || defined(Q_PROCESSOR_ARM)
-            // Use SSE instructions for optimization
-            PerformAllOnFloatBufferSSE(operation, buffer.data(i), number, 0, buffer.sample_count());
-#else
-            PerformAllOnFloatBuffer(operation, buffer.data(i), number, 0, buffer.sample_count());
-#endif
+            // Each op gets the widest runtime-dispatched kernel the CPU supports
+            switch (operation) {
+            case kOpAdd:
+              SampleKernels::Offset(buffer.data(i), number, buffer.sample_count());
+              break;
+            case kOpSubtract:
+              SampleKernels::Offset(buffer.data(i), -number, buffer.sample_count());
+              break;
+            case kOpMultiply:
+              SampleKernels::Gain(buffer.data(i), number, buffer.sample_count());
+              break;
+            case kOpDivide:
+              SampleKernels::Divide(buffer.data(i), number, buffer.sample_count());
+              break;
+            case kOpPower:
+              // No vector kernel for pow, stay scalar
+              PerformAllOnFloatBuffer(operation, buffer.data(i), number, 0, buffer.sample_count());
+              break;
+            }
           }
         }
 
@@ -103,10 +103,6 @@ protected:
 
   static void PerformAllOnFloatBuffer(Operation operation, float *a, float b, int start, int end);
 
-#if defined(Q_PROCESSOR_X86) || defined(Q_PROCESSOR_ARM)
-  static void PerformAllOnFloatBufferSSE(Operation operation, float *a, float b, int start, int end);
-#endif
-
   static QString GetShaderUniformType(const NodeValue::Type& type);
 
   static QString GetShaderVariableCall(const QString& input_id, const NodeValue::Type& type, const QString &coord_op = QString());
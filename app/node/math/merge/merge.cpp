@@ -36,6 +36,7 @@ MergeNode::MergeNode()
   AddInput(kBlendIn, NodeValue::kTexture, InputFlags(kInputFlagNotKeyframable));
 
   SetFlag(kDontShowInParamView);
+  SetFlag(kTimeAgnostic);
 }
 
 QString MergeNode::Name() const
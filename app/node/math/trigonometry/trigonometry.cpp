@@ -32,6 +32,8 @@ TrigonometryNode::TrigonometryNode()
   AddInput(kMethodIn, NodeValue::kCombo, InputFlags(kInputFlagNotConnectable | kInputFlagNotKeyframable));
 
   AddInput(kXIn, NodeValue::kFloat, 0.0);
+
+  SetFlag(kTimeAgnostic);
 }
 
 QString TrigonometryNode::Name() const
@@ -204,8 +204,12 @@ void Node::ConnectEdge(Node *output, const NodeInput &input)
   emit input.node()->InputConnected(output, input);
   emit output->OutputConnected(output, input);
 
-  // Invalidate all if this node isn't ignoring this input
-  if (!(input.node()->GetInputFlags(input.input()) & kInputFlagIgnoreInvalidations)) {
+  // Invalidate all if this node isn't ignoring this input. While the project graph is being
+  // deserialized this cascade is skipped - it walks every downstream path of the partially
+  // built graph per edge - and Project runs one consolidated pass when construction ends.
+  Project *graph = input.node()->parent();
+  if ((!graph || !graph->IsUnderGraphConstruction())
+      && !(input.node()->GetInputFlags(input.input()) & kInputFlagIgnoreInvalidations)) {
     input.node()->InvalidateAll(input.input(), input.element());
   }
 }
@@ -425,7 +429,8 @@ SplitValue Node::GetSplitValueAtTime(const QString &input, const rational &time,
 QVariant Node::GetSplitValueAtTimeOnTrack(const QString &input, const rational &time, int track, int element) const
 {
   if (!IsUsingStandardValue(input, track, element)) {
-    const NodeKeyframeTrack& key_track = GetKeyframeTracks(input, element).at(track);
+    NodeInputImmediate *immediate = GetImmediate(input, element);
+    const NodeKeyframeTrack& key_track = immediate->keyframe_tracks().at(track);
 
     if (key_track.first()->time() >= time) {
       // This time precedes any keyframe, so we just return the first value
@@ -441,25 +446,55 @@ QVariant Node::GetSplitValueAtTimeOnTrack(const QString &input, const rational &
 
     // If we're here, the time must be somewhere in between the keyframes
     NodeKeyframe *before = nullptr, *after = nullptr;
+    int before_index = -1;
 
     int low = 0;
     int high = key_track.size()-1;
-    while (low <= high) {
-      int mid = low + (high - low) / 2;
-      NodeKeyframe *mid_key = key_track.at(mid);
-      NodeKeyframe *next_key = key_track.at(mid + 1);
-
-      if (mid_key->time() <= time && next_key->time() > time) {
-        before = mid_key;
-        after = next_key;
-        break;
-      } else if (mid_key->time() < time) {
-        low = mid + 1;
+
+    // During sequential playback, the pair that bracketed the previous evaluation (or its
+    // immediate neighbor) almost always brackets this one too, so try the cursor left by the
+    // last lookup before paying for a full binary search. On a seek it merely narrows the
+    // search to one side.
+    int cursor = immediate->keyframe_cursor(track);
+    if (cursor >= 0 && cursor < key_track.size()-1) {
+      if (key_track.at(cursor)->time() <= time) {
+        if (key_track.at(cursor+1)->time() > time) {
+          before_index = cursor;
+        } else if (cursor+2 < key_track.size()
+                   && key_track.at(cursor+1)->time() <= time
+                   && key_track.at(cursor+2)->time() > time) {
+          before_index = cursor+1;
+        } else {
+          low = cursor+1;
+        }
       } else {
-        high = mid - 1;
+        high = cursor;
       }
     }
 
+    if (before_index == -1) {
+      while (low <= high) {
+        int mid = low + (high - low) / 2;
+        NodeKeyframe *mid_key = key_track.at(mid);
+        NodeKeyframe *next_key = key_track.at(mid + 1);
+
+        if (mid_key->time() <= time && next_key->time() > time) {
+          before_index = mid;
+          break;
+        } else if (mid_key->time() < time) {
+          low = mid + 1;
+        } else {
+          high = mid - 1;
+        }
+      }
+    }
+
+    if (before_index != -1) {
+      before = key_track.at(before_index);
+      after = key_track.at(before_index + 1);
+      immediate->set_keyframe_cursor(track, before_index);
+    }
+
     if (before) {
       if (before->time() == time
           || ((!NodeValue::type_can_be_interpolated(type) || before->type() == NodeKeyframe::kHold) && after->time() > time)) {
@@ -484,33 +519,11 @@ QVariant Node::GetSplitValueAtTimeOnTrack(const QString &input, const rational &
           after_val = after->value().toDouble();
         }
 
-        if (before->type() == NodeKeyframe::kBezier && after->type() == NodeKeyframe::kBezier) {
-
-          // Perform a cubic bezier with two control points
-          interpolated = Bezier::CubicXtoY(time.toDouble(),
-                                           Imath::V2d(before->time().toDouble(), before_val),
-                                           Imath::V2d(before->time().toDouble() + before->valid_bezier_control_out().x(), before_val + before->valid_bezier_control_out().y()),
-                                           Imath::V2d(after->time().toDouble() + after->valid_bezier_control_in().x(), after_val + after->valid_bezier_control_in().y()),
-                                           Imath::V2d(after->time().toDouble(), after_val));
+        if (before->type() == NodeKeyframe::kBezier || after->type() == NodeKeyframe::kBezier) {
 
-        } else if (before->type() == NodeKeyframe::kBezier || after->type() == NodeKeyframe::kBezier) {
-          // Perform a quadratic bezier with only one control point
-
-          Imath::V2d control_point;
-
-          if (before->type() == NodeKeyframe::kBezier) {
-            control_point.x = (before->valid_bezier_control_out().x() + before->time().toDouble());
-            control_point.y = (before->valid_bezier_control_out().y() + before_val);
-          } else {
-            control_point.x = (after->valid_bezier_control_in().x() + after->time().toDouble());
-            control_point.y = (after->valid_bezier_control_in().y() + after_val);
-          }
-
-          // Interpolate value using quadratic beziers
-          interpolated = Bezier::QuadraticXtoY(time.toDouble(),
-                                               Imath::V2d(before->time().toDouble(), before_val),
-                                               control_point,
-                                               Imath::V2d(after->time().toDouble(), after_val));
+          // Bezier interpolation - cubic when both keyframes have handles, quadratic when only
+          // one does. The segment's polynomial coefficients are cached between evaluations.
+          interpolated = NodeKeyframe::EvaluateBezierAt(before, after, before_val, after_val, time.toDouble());
 
         } else {
           // To have arrived here, the keyframes must both be linear
@@ -944,7 +957,26 @@ void Node::InvalidateCache(const TimeRange &range, const QString &from, int elem
       TimeRange ar = range.Intersected(GetAudioCacheRange());
       if (ar.length() != 0) {
         audio_playback_cache()->Invalidate(ar);
-        waveform_cache()->Invalidate(ar);
+
+        if (options.contains(QStringLiteral("waveshiftfrom"))) {
+          // A timeline edit slid otherwise unchanged audio in time - move the existing waveform
+          // summaries into place and only re-render the region with no usable data (see
+          // Track::AddWaveformShiftHint())
+          waveform_cache()->Shift(options.value(QStringLiteral("waveshiftfrom")).value<rational>(),
+                                  options.value(QStringLiteral("waveshiftto")).value<rational>(),
+                                  options.value(QStringLiteral("waveshiftid")).toLongLong());
+
+          if (options.contains(QStringLiteral("waveshiftgapin"))) {
+            TimeRange gap(options.value(QStringLiteral("waveshiftgapin")).value<rational>(),
+                          options.value(QStringLiteral("waveshiftgapout")).value<rational>());
+            gap = gap.Intersected(GetAudioCacheRange());
+            if (gap.length() != 0) {
+              waveform_cache()->Invalidate(gap);
+            }
+          }
+        } else {
+          waveform_cache()->Invalidate(ar);
+        }
       }
     }
   }
@@ -1228,7 +1260,7 @@ bool Node::Load(QXmlStreamReader *reader, SerializedData *data)
             if (attr.name() == QStringLiteral("element")) {
               ele = attr.value().toInt();
             } else if (attr.name() == QStringLiteral("input")) {
-              param_id = attr.value().toString();
+              param_id = XMLInternString(attr.value().toString());
             }
           }
 
@@ -1255,7 +1287,7 @@ bool Node::Load(QXmlStreamReader *reader, SerializedData *data)
 
           XMLAttributeLoop(reader, attr) {
             if (attr.name() == QStringLiteral("input")) {
-              input = attr.value().toString();
+              input = XMLInternString(attr.value().toString());
             } else if (attr.name() == QStringLiteral("element")) {
               element = attr.value().toInt();
             }
@@ -1440,7 +1472,7 @@ bool Node::LoadInput(QXmlStreamReader *reader, SerializedData *data)
 
   XMLAttributeLoop(reader, attr) {
     if (attr.name() == QStringLiteral("id")) {
-      param_id = attr.value().toString();
+      param_id = XMLInternString(attr.value().toString());
 
       break;
     }
@@ -2282,6 +2314,8 @@ void Node::InvalidateFromKeyframeBezierInChange()
   }
 
   ParameterValueChanged(key->key_track_ref().input(), TimeRange(start, end));
+
+  emit KeyframeBezierChanged(key);
 }
 
 void Node::InvalidateFromKeyframeBezierOutChange()
@@ -2298,6 +2332,8 @@ void Node::InvalidateFromKeyframeBezierOutChange()
   }
 
   ParameterValueChanged(key->key_track_ref().input(), TimeRange(start, end));
+
+  emit KeyframeBezierChanged(key);
 }
 
 void Node::InvalidateFromKeyframeTimeChange()
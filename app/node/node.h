@@ -23,6 +23,7 @@
 
 #include <map>
 #include <QMutex>
+#include <QVarLengthArray>
 #include <QObject>
 #include <QPainter>
 #include <QPointF>
@@ -57,9 +58,88 @@ namespace olive {
   virtual Node *copy() const override {return new x();}
 
 class Folder;
+class Node;
 class Project;
 struct SerializedData;
 
+/**
+ * @brief Flat map of a node's input connections
+ *
+ * Inputs can only have one connection each and most nodes have fewer than eight inputs, so
+ * connections are kept in a small inline vector - graph traversal, the hottest consumer,
+ * walks contiguous memory instead of chasing the heap-allocated tree nodes of the
+ * associative container this replaces, and lookups are a short linear scan. Iteration order
+ * is insertion order rather than key order.
+ */
+class NodeInputConnections
+{
+public:
+  using value_type = std::pair<NodeInput, Node*>;
+  using storage_type = QVarLengthArray<value_type, 8>;
+  using iterator = storage_type::iterator;
+  using const_iterator = storage_type::const_iterator;
+
+  iterator begin() { return entries_.begin(); }
+  iterator end() { return entries_.end(); }
+  const_iterator begin() const { return entries_.begin(); }
+  const_iterator end() const { return entries_.end(); }
+  const_iterator cbegin() const { return entries_.begin(); }
+  const_iterator cend() const { return entries_.end(); }
+
+  bool empty() const { return entries_.isEmpty(); }
+  size_t size() const { return entries_.size(); }
+
+  iterator find(const NodeInput &input)
+  {
+    for (iterator it = entries_.begin(); it != entries_.end(); it++) {
+      if (it->first == input) {
+        return it;
+      }
+    }
+
+    return entries_.end();
+  }
+
+  const_iterator find(const NodeInput &input) const
+  {
+    for (const_iterator it = entries_.begin(); it != entries_.end(); it++) {
+      if (it->first == input) {
+        return it;
+      }
+    }
+
+    return entries_.end();
+  }
+
+  Node *at(const NodeInput &input) const
+  {
+    const_iterator it = find(input);
+    Q_ASSERT(it != cend());
+    return (it == cend()) ? nullptr : it->second;
+  }
+
+  Node *&operator[](const NodeInput &input)
+  {
+    iterator it = find(input);
+
+    if (it == end()) {
+      entries_.append(value_type(input, nullptr));
+      return entries_.back().second;
+    }
+
+    return it->second;
+  }
+
+  void erase(iterator it)
+  {
+    entries_.erase(it);
+  }
+
+private:
+  storage_type entries_;
+
+};
+
 /**
  * @brief A single processing unit that can be connected with others to create intricate processing systems
  *
@@ -102,7 +182,15 @@ public:
     kVideoEffect = 0x2,
     kAudioEffect = 0x4,
     kDontShowInCreateMenu = 0x8,
-    kIsItem = 0x10
+    kIsItem = 0x10,
+
+    /**
+     * Node's Value() depends only on its inputs, never on the evaluation time. Opting in allows
+     * NodeValueMemoCache to replay the node's output across frames when none of its inputs are
+     * keyframed. Nodes that read NodeGlobals::time() (or push jobs that bake the time in) must
+     * not set this.
+     */
+    kTimeAgnostic = 0x20
   };
 
   struct ContextPair {
@@ -469,7 +557,17 @@ public:
   {
     NodeValue::Type type = GetInputDataType(input);
 
-    return NodeValue::combine_track_values_into_normal_value(type, GetSplitValueAtTime(input, time, element));
+    // Split into fixed-capacity inline storage and recombine in place - this runs for every
+    // keyframed read during rendering, so it shouldn't heap-allocate a vector each time
+    InlineSplitValue vals;
+
+    int nb_tracks = GetNumberOfKeyframeTracks(input);
+
+    for (int i=0; i<nb_tracks; i++) {
+      vals.append(GetSplitValueAtTimeOnTrack(input, time, i, element));
+    }
+
+    return NodeValue::combine_track_values_into_normal_value(type, vals.constData(), vals.size());
   }
 
   QVariant GetValueAtTime(const NodeInput& input, const rational& time)
@@ -706,7 +804,7 @@ public:
 
   const NodeKeyframeTrack& GetTrackFromKeyframe(NodeKeyframe* key) const;
 
-  using InputConnections = std::map<NodeInput, Node*>;
+  using InputConnections = NodeInputConnections;
 
   /**
    * @brief Return map of input connections
@@ -1121,6 +1219,8 @@ signals:
 
   void KeyframeValueChanged(NodeKeyframe* key);
 
+  void KeyframeBezierChanged(NodeKeyframe* key);
+
   void KeyframeEnableChanged(const NodeInput& input, bool enabled);
 
   void InputAdded(const QString& id);
@@ -345,6 +345,52 @@ private:
   Node* node_;
 };
 
+/**
+ * @brief Brackets a bulk change with Project::BeginBatchOperation()/EndBatchOperation()
+ *
+ * Add one of these with begin = true as the first child of a large MultiUndoCommand and one
+ * with begin = false as the last, and the change stays bracketed as a batch in both the redo
+ * and the undo direction.
+ */
+class ProjectBatchOperationCommand : public UndoCommand {
+public:
+  ProjectBatchOperationCommand(Project* project, bool begin) :
+    project_(project),
+    begin_(begin)
+  {
+  }
+
+  virtual Project* GetRelevantProject() const override
+  {
+    return project_;
+  }
+
+protected:
+  virtual void redo() override
+  {
+    if (begin_) {
+      project_->BeginBatchOperation();
+    } else {
+      project_->EndBatchOperation();
+    }
+  }
+
+  virtual void undo() override
+  {
+    if (begin_) {
+      project_->EndBatchOperation();
+    } else {
+      project_->BeginBatchOperation();
+    }
+  }
+
+private:
+  Project* project_;
+
+  bool begin_;
+
+};
+
 class NodeRemoveAndDisconnectCommand : public UndoCommand {
 public:
   NodeRemoveAndDisconnectCommand(Node* node) :
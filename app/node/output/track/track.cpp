@@ -20,6 +20,8 @@
 
 #include "track.h"
 
+#include <algorithm>
+
 #include <QApplication>
 #include <QDebug>
 #include <QFontMetrics>
@@ -138,6 +140,19 @@ Node::ActiveElements Track::GetActiveElementsAtTime(const QString &input, const
   }
 }
 
+QVector<QString> Track::IgnoreInputsForRendering() const
+{
+  // Value() only reads the block array - the mute flag and array map are bookkeeping, so there's
+  // no reason for the traverser to resolve them every frame. A muted track contributes nothing
+  // at all, so its block array is excluded from the compiled plan too; the plan cache rebuilds
+  // the plan when the mute state changes.
+  if (IsMuted()) {
+    return {kMutedInput, kArrayMapInput, kBlockInput};
+  }
+
+  return {kMutedInput, kArrayMapInput};
+}
+
 void Track::Value(const NodeValueRow &value, const NodeGlobals &globals, NodeValueTable *table) const
 {
   if (this->type() == Track::kVideo) {
@@ -256,12 +271,15 @@ void Track::SetIndex(const int &index)
 
 Block *Track::BlockContainingTime(const rational &time) const
 {
-  foreach (Block* block, blocks_) {
-    if (block->in() < time && block->out() > time) {
-      return block;
-    } else if (block->out() == time) {
-      break;
-    }
+  // Blocks are contiguous and sorted by time (UpdateInOutFrom maintains this on every insert,
+  // removal and length change), so the block array doubles as an interval index and all of
+  // these time lookups can binary search it.
+  auto it = std::lower_bound(blocks_.cbegin(), blocks_.cend(), time, [](Block *b, const rational &t){
+    return b->out() <= t;
+  });
+
+  if (it != blocks_.cend() && (*it)->in() < time) {
+    return *it;
   }
 
   return nullptr;
@@ -269,15 +287,14 @@ Block *Track::BlockContainingTime(const rational &time) const
 
 Block *Track::NearestBlockBefore(const rational &time) const
 {
-  foreach (Block* block, blocks_) {
-    // Blocks are sorted by time, so the first Block who's out point is at/after this time is the correct Block
-    if (block->in() == time) {
-      break;
-    }
+  // First block whose out point is at/after this time. A block starting precisely at this time
+  // means there is nothing before it to return.
+  auto it = std::lower_bound(blocks_.cbegin(), blocks_.cend(), time, [](Block *b, const rational &t){
+    return b->out() < t;
+  });
 
-    if (block->out() >= time) {
-      return block;
-    }
+  if (it != blocks_.cend() && (*it)->in() != time) {
+    return *it;
   }
 
   return nullptr;
@@ -285,11 +302,13 @@ Block *Track::NearestBlockBefore(const rational &time) const
 
 Block *Track::NearestBlockBeforeOrAt(const rational &time) const
 {
-  foreach (Block* block, blocks_) {
-    // Blocks are sorted by time, so the first Block who's out point is at/after this time is the correct Block
-    if (block->out() > time) {
-      return block;
-    }
+  // First block whose out point is after this time
+  auto it = std::lower_bound(blocks_.cbegin(), blocks_.cend(), time, [](Block *b, const rational &t){
+    return b->out() <= t;
+  });
+
+  if (it != blocks_.cend()) {
+    return *it;
   }
 
   return nullptr;
@@ -297,11 +316,13 @@ Block *Track::NearestBlockBeforeOrAt(const rational &time) const
 
 Block *Track::NearestBlockAfterOrAt(const rational &time) const
 {
-  foreach (Block* block, blocks_) {
-    // Blocks are sorted by time, so the first Block after this time is the correct Block
-    if (block->in() >= time) {
-      return block;
-    }
+  // First block whose in point is at/after this time
+  auto it = std::lower_bound(blocks_.cbegin(), blocks_.cend(), time, [](Block *b, const rational &t){
+    return b->in() < t;
+  });
+
+  if (it != blocks_.cend()) {
+    return *it;
   }
 
   return nullptr;
@@ -309,11 +330,13 @@ Block *Track::NearestBlockAfterOrAt(const rational &time) const
 
 Block *Track::NearestBlockAfter(const rational &time) const
 {
-  foreach (Block* block, blocks_) {
-    // Blocks are sorted by time, so the first Block after this time is the correct Block
-    if (block->in() > time) {
-      return block;
-    }
+  // First block whose in point is after this time
+  auto it = std::lower_bound(blocks_.cbegin(), blocks_.cend(), time, [](Block *b, const rational &t){
+    return b->in() <= t;
+  });
+
+  if (it != blocks_.cend()) {
+    return *it;
   }
 
   return nullptr;
@@ -350,12 +373,13 @@ void Track::InvalidateCache(const TimeRange& range, const QString& from, int ele
 {
   TimeRange limited;
 
-  const Block* b;
+  const Block* b = nullptr;
+
+  if (from == kBlockInput && element >= 0) {
+    b = dynamic_cast<const Block*>(GetConnectedOutput(from, element));
+  }
 
-  if (from == kBlockInput
-      && element >= 0
-      && (b = dynamic_cast<const Block*>(GetConnectedOutput(from, element)))
-      && !options.value(QStringLiteral("lengthevent")).toBool()) {
+  if (b && !options.value(QStringLiteral("lengthevent")).toBool()) {
     // Limit the range signal to the corresponding block
     TimeRange transformed = TransformRangeFromBlock(b, range);
 
@@ -365,12 +389,26 @@ void Track::InvalidateCache(const TimeRange& range, const QString& from, int ele
 
     limited = TimeRange(qMax(transformed.in(), b->in()), qMin(transformed.out(), b->out()));
   } else {
+    if (b && options.contains(QStringLiteral("lengthdelta"))) {
+      // A block's length changed, sliding everything after it in track time. The range starts at
+      // the shorter of the old/new lengths in block time, so the slide boundary in track time is
+      // that plus the block's in point
+      rational delta = options.value(QStringLiteral("lengthdelta")).value<rational>();
+      rational boundary = b->in() + range.in();
+
+      AddWaveformShiftHint(&options,
+                           boundary + qMax(-delta, rational(0)),
+                           boundary + qMax(delta, rational(0)),
+                           TimeRange(boundary, boundary + qMax(delta, rational(0))));
+    }
+
     limited = range;
   }
 
   // NOTE: For now, I figure we drop this key, but we may find in the future that it's advantageous
   //       to keep it
   options.remove(QStringLiteral("lengthevent"));
+  options.remove(QStringLiteral("lengthdelta"));
 
   Node::InvalidateCache(limited, from, element, options);
 }
@@ -424,7 +462,11 @@ void Track::InsertBlockAtIndex(Block *block, int index)
 
   connect(block, &Block::LengthChanged, this, &Track::BlockLengthChanged);
 
-  Node::InvalidateCache(TimeRange(block->in(), track_length()), kBlockInput);
+  // Content after the insertion point is unchanged, it just slid later by the block's length
+  InvalidateCacheOptions insert_options;
+  AddWaveformShiftHint(&insert_options, block->in(), block->out(), TimeRange(block->in(), block->out()));
+
+  Node::InvalidateCache(TimeRange(block->in(), track_length()), kBlockInput, -1, insert_options);
 
   emit BlockAdded(block);
 
@@ -472,7 +514,11 @@ void Track::RippleRemoveBlock(Block *block)
   // Update in/outs
   UpdateInOutFrom(index);
 
-  Node::InvalidateCache(TimeRange(remove_in, qMax(track_length(), remove_out)), kBlockInput);
+  // Content after the removed block is unchanged, it just slid earlier into its place
+  InvalidateCacheOptions remove_options;
+  AddWaveformShiftHint(&remove_options, remove_out, remove_in, TimeRange(remove_in, remove_in));
+
+  Node::InvalidateCache(TimeRange(remove_in, qMax(track_length(), remove_out)), kBlockInput, -1, remove_options);
 
   UpdateArrayMap();
 }
@@ -519,7 +565,11 @@ void Track::ReplaceBlock(Block *old, Block *replace)
     // Update in/outs
     UpdateInOutFrom(cache_index);
 
-    Node::InvalidateCache(TimeRange(replace->in(), track_length()), kBlockInput);
+    // Only the replaced block itself has new content, the tail slid by the length difference
+    InvalidateCacheOptions replace_options;
+    AddWaveformShiftHint(&replace_options, replace->in() + old->length(), replace->out(), TimeRange(replace->in(), replace->out()));
+
+    Node::InvalidateCache(TimeRange(replace->in(), track_length()), kBlockInput, -1, replace_options);
   }
 
   emit BlockAdded(replace);
@@ -658,50 +708,63 @@ void Track::ProcessAudioTrack(const NodeValueRow &value, const NodeGlobals &glob
         if (qIsNull(speed_value)) {
           // Just silence, don't think there's any other practical application of 0 speed audio
           samples_from_this_block.silence();
-        } else if (!qFuzzyCompare(speed_value, 1.0)) {
-          if (clip_cast->maintain_audio_pitch()) {
-            AudioProcessor processor;
-
-            if (processor.Open(samples_from_this_block.audio_params(), samples_from_this_block.audio_params(), speed_value)) {
-              AudioProcessor::Buffer out;
-
-              // FIXME: This is not the best way to do this, the TempoProcessor works best
-              //        when it's given a continuous stream of audio, which is challenging
-              //        in our current "modular" audio system. This should still work reasonably
-              //        well on export (assuming audio is all generated at once on export), but
-              //        users may hear clicks and pops in the audio during preview due to this
-              //        approach.
-              int r = processor.Convert(samples_from_this_block.to_raw_ptrs().data(), samples_from_this_block.sample_count(), nullptr);
-
-              if (r < 0) {
-                qCritical() << "Failed to change tempo of audio:" << r;
-              } else {
-                processor.Flush();
-
-                processor.Convert(nullptr, 0, &out);
-
-                if (!out.empty()) {
-                  int nb_samples = out.front().size() * samples_from_this_block.audio_params().bytes_per_sample_per_channel();
 
-                  if (nb_samples) {
-                    SampleBuffer new_samples(samples_from_this_block.audio_params(), nb_samples);
-
-                    for (int i=0; i<out.size(); i++) {
-                      memcpy(new_samples.data(i), out[i].data(), out[i].size());
+          if (reversed) {
+            samples_from_this_block.reverse();
+          }
+        } else if (!qFuzzyCompare(speed_value, 1.0)) {
+          // Retiming is expensive (particularly pitch-maintained tempo processing) and would
+          // otherwise run again on every playback pass, so derived audio is cached on the clip
+          // keyed by range. Parameter changes and upstream invalidations clear the cache.
+          if (!clip_cast->GetCachedRetimedAudio(range_for_block, globals.aparams(), &samples_from_this_block)) {
+            if (clip_cast->maintain_audio_pitch()) {
+              AudioProcessor processor;
+
+              if (processor.Open(samples_from_this_block.audio_params(), samples_from_this_block.audio_params(), speed_value)) {
+                AudioProcessor::Buffer out;
+
+                // FIXME: This is not the best way to do this, the TempoProcessor works best
+                //        when it's given a continuous stream of audio, which is challenging
+                //        in our current "modular" audio system. This should still work reasonably
+                //        well on export (assuming audio is all generated at once on export), but
+                //        users may hear clicks and pops in the audio during preview due to this
+                //        approach.
+                int r = processor.Convert(samples_from_this_block.to_raw_ptrs().data(), samples_from_this_block.sample_count(), nullptr);
+
+                if (r < 0) {
+                  qCritical() << "Failed to change tempo of audio:" << r;
+                } else {
+                  processor.Flush();
+
+                  processor.Convert(nullptr, 0, &out);
+
+                  if (!out.empty()) {
+                    int nb_samples = out.front().size() * samples_from_this_block.audio_params().bytes_per_sample_per_channel();
+
+                    if (nb_samples) {
+                      SampleBuffer new_samples(samples_from_this_block.audio_params(), nb_samples);
+
+                      for (int i=0; i<out.size(); i++) {
+                        memcpy(new_samples.data(i), out[i].data(), out[i].size());
+                      }
+
+                      samples_from_this_block = new_samples;
                     }
-
-                    samples_from_this_block = new_samples;
                   }
                 }
               }
+            } else {
+              // Multiply time
+              samples_from_this_block.speed(speed_value);
             }
-          } else {
-            // Multiply time
-            samples_from_this_block.speed(speed_value);
-          }
-        }
 
-        if (reversed) {
+            if (reversed) {
+              samples_from_this_block.reverse();
+            }
+
+            clip_cast->CacheRetimedAudio(range_for_block, samples_from_this_block);
+          }
+        } else if (reversed) {
           samples_from_this_block.reverse();
         }
       }
@@ -792,6 +855,27 @@ void Track::RefreshBlockCacheFromArrayMap()
   UpdateInOutFrom(0);
 }
 
+void Track::AddWaveformShiftHint(InvalidateCacheOptions *options, const rational &from, const rational &to, const TimeRange &gap)
+{
+  if (from == to && gap.length() == 0) {
+    return;
+  }
+
+  // IDs let caches that receive the same cascade through multiple graph paths apply the shift
+  // only once
+  static qint64 shift_id = 0;
+  shift_id++;
+
+  options->insert(QStringLiteral("waveshiftfrom"), QVariant::fromValue(from));
+  options->insert(QStringLiteral("waveshiftto"), QVariant::fromValue(to));
+  options->insert(QStringLiteral("waveshiftid"), shift_id);
+
+  if (gap.length() != 0) {
+    options->insert(QStringLiteral("waveshiftgapin"), QVariant::fromValue(gap.in()));
+    options->insert(QStringLiteral("waveshiftgapout"), QVariant::fromValue(gap.out()));
+  }
+}
+
 void Track::BlockLengthChanged()
 {
   // Assumes sender is a Block
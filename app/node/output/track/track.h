@@ -55,6 +55,7 @@ public:
   virtual QString Description() const override;
 
   virtual ActiveElements GetActiveElementsAtTime(const QString &input, const TimeRange &r) const override;
+  virtual QVector<QString> IgnoreInputsForRendering() const override;
   virtual void Value(const NodeValueRow& value, const NodeGlobals &globals, NodeValueTable *table) const override;
 
   virtual TimeRange InputTimeAdjustment(const QString& input, int element, const TimeRange& input_time, bool clamp) const override;
@@ -466,6 +467,15 @@ private:
 
   void UpdateArrayMap();
 
+  /**
+   * @brief Mark an invalidation as an edit that slid content in time
+   *
+   * Waveform caches receiving the cascade move their existing summaries from `from` to `to` and
+   * re-render only `gap` - the region with genuinely new content - instead of regenerating
+   * everything after the edit point. See Node::InvalidateCache().
+   */
+  static void AddWaveformShiftHint(InvalidateCacheOptions *options, const rational &from, const rational &to, const TimeRange &gap);
+
   TimeRangeList block_length_pending_invalidations_;
 
   QVector<Block*> blocks_;
@@ -40,6 +40,9 @@ ViewerOutput::ViewerOutput(bool create_buffer_inputs, bool create_default_stream
   last_length_(0),
   video_length_(0),
   audio_length_(0),
+  length_verify_queued_(false),
+  video_params_changed_content_(true),
+  video_params_changed_timing_(true),
   autocache_input_video_(false),
   autocache_input_audio_(false),
   waveform_requests_enabled_(false)
@@ -230,6 +233,35 @@ void ViewerOutput::InvalidateCache(const TimeRange& range, const QString& from,
 {
   Q_UNUSED(element)
 
+  if (from == kVideoParamsInput && element == 0) {
+    // Parameter changes arrive as a full-range invalidation, but only some fields actually
+    // alter rendered pixels. Take the classification InputValueChangedEvent() made and reset it
+    // so any other invalidation path stays fully conservative
+    bool content_changed = video_params_changed_content_;
+    bool timing_changed = video_params_changed_timing_;
+    video_params_changed_content_ = true;
+    video_params_changed_timing_ = true;
+
+    if (!content_changed) {
+      if (timing_changed) {
+        // The frame grid changed - frame caches are keyed by timestamp in the timebase, so they
+        // must re-render, but the audio and waveform caches are unaffected
+        if (AreCachesEnabled()) {
+          TimeRange vr = range.Intersected(GetVideoCacheRange());
+          if (vr.length() != 0) {
+            video_frame_cache()->Invalidate(vr);
+            thumbnail_cache()->Invalidate(vr);
+          }
+        }
+
+        SendInvalidateCache(range, options);
+      }
+
+      QueueVerifyLength();
+      return;
+    }
+  }
+
   if (Node *connected = GetConnectedOutput(from, element)) {
     if (from == kTextureInput) {
       //connected->thumbnail_cache()->Request(range.Intersected(max_range), PlaybackCache::kPreviewsOnly);
@@ -240,7 +272,11 @@ void ViewerOutput::InvalidateCache(const TimeRange& range, const QString& from,
     } else if (from == kSamplesInput) {
       TimeRange max_range = InputTimeAdjustment(from, element, TimeRange(0, GetAudioLength()), false);
       if (waveform_requests_enabled_) {
-        connected->waveform_cache()->Request(this, range.Intersected(max_range));
+        // Only re-render summaries the cache actually lost - a shift-aware edit (see
+        // PlaybackCache::Shift()) keeps most of the post-edit tail valid
+        foreach (const TimeRange &r, connected->waveform_cache()->GetInvalidatedRanges(range.Intersected(max_range))) {
+          connected->waveform_cache()->Request(this, r);
+        }
       }
       if (autocache_input_audio_) {
         connected->audio_playback_cache()->Request(this, range.Intersected(max_range));
@@ -248,7 +284,7 @@ void ViewerOutput::InvalidateCache(const TimeRange& range, const QString& from,
     }
   }
 
-  VerifyLength();
+  QueueVerifyLength();
 
   super::InvalidateCache(range, from, element, options);
 }
@@ -307,8 +343,18 @@ void ViewerOutput::Retranslate()
   }
 }
 
+void ViewerOutput::QueueVerifyLength()
+{
+  if (!length_verify_queued_) {
+    length_verify_queued_ = true;
+    QMetaObject::invokeMethod(this, &ViewerOutput::VerifyLength, Qt::QueuedConnection);
+  }
+}
+
 void ViewerOutput::VerifyLength()
 {
+  length_verify_queued_ = false;
+
   video_length_ = VerifyLengthInternal(Track::kVideo);
 
   audio_length_ = VerifyLengthInternal(Track::kAudio);
@@ -488,6 +534,12 @@ void ViewerOutput::InputValueChangedEvent(const QString &input, int element)
         emit FrameRateChanged(new_video_params.frame_rate());
       }
 
+      // Classify this change for the InvalidateCache() call that follows - metadata-only
+      // changes (e.g. pixel aspect) shouldn't throw away rendered frames
+      video_params_changed_content_ = !VideoParams::ContentsEqual(cached_video_params_, new_video_params);
+      video_params_changed_timing_ = frame_rate_changed
+          || cached_video_params_.time_base() != new_video_params.time_base();
+
       emit VideoParamsChanged();
 
       cached_video_params_ = new_video_params;
@@ -148,9 +148,9 @@ public:
   AudioParams GetFirstEnabledAudioStream() const;
   SubtitleParams GetFirstEnabledSubtitleStream() const;
 
-  const rational &GetLength() const { return last_length_; }
-  const rational &GetVideoLength() const { return video_length_; }
-  const rational &GetAudioLength() const { return audio_length_; }
+  const rational &GetLength() const { EnsureLengthIsValid(); return last_length_; }
+  const rational &GetVideoLength() const { EnsureLengthIsValid(); return video_length_; }
+  const rational &GetAudioLength() const { EnsureLengthIsValid(); return audio_length_; }
 
   TimelineWorkArea *GetWorkArea() const { return workarea_; }
   TimelineMarkerList *GetMarkers() const { return markers_; }
@@ -228,6 +228,16 @@ signals:
 public slots:
   void VerifyLength();
 
+  /**
+   * @brief Request a length recompute on the next event loop tick
+   *
+   * Block edits can change track lengths hundreds of times in one operation (e.g. a large
+   * ripple delete). Queuing coalesces all of those into a single VerifyLength() per tick, and
+   * the length getters run any pending recompute on first query so callers never see a stale
+   * value.
+   */
+  void QueueVerifyLength();
+
   void SetPlayhead(const rational &t);
 
 protected:
@@ -243,14 +253,33 @@ protected:
   int SetStream(Track::Type type, const QVariant &value, int index);
 
 private:
+  void EnsureLengthIsValid() const
+  {
+    if (length_verify_queued_) {
+      const_cast<ViewerOutput*>(this)->VerifyLength();
+    }
+  }
+
   rational last_length_;
   rational video_length_;
   rational audio_length_;
 
+  bool length_verify_queued_;
+
   VideoParams cached_video_params_;
 
   AudioParams cached_audio_params_;
 
+  /**
+   * @brief Classification of the most recent video parameter change
+   *
+   * Set by InputValueChangedEvent() from a field diff and consumed (then reset to the
+   * conservative default) by the matching InvalidateCache() call, so invalidations that don't
+   * come from a diffed value change still discard everything.
+   */
+  bool video_params_changed_content_;
+  bool video_params_changed_timing_;
+
   TimelineWorkArea *workarea_;
   TimelineMarkerList *markers_;
 
@@ -49,7 +49,9 @@ const QString Project::kItemMimeType = QStringLiteral("application/x-oliveprojec
 Project::Project() :
   root_(nullptr),
   is_modified_(false),
-  autorecovery_saved_(true)
+  autorecovery_saved_(true),
+  batch_operation_depth_(0),
+  graph_construction_depth_(0)
 {
   // Generate UUID for this project
   RegenerateUuid();
@@ -395,4 +397,37 @@ void Project::SetSetting(const QString &key, const QString &value)
   }
 }
 
+void Project::BeginBatchOperation()
+{
+  if (batch_operation_depth_++ == 0) {
+    emit BatchOperationStarted();
+  }
+}
+
+void Project::EndBatchOperation()
+{
+  if (--batch_operation_depth_ == 0) {
+    emit BatchOperationEnded();
+  }
+}
+
+void Project::BeginGraphConstruction()
+{
+  graph_construction_depth_++;
+}
+
+void Project::EndGraphConstruction()
+{
+  if (--graph_construction_depth_ == 0) {
+    // Consolidated "graph ready" pass. The only load-relevant work the suppressed per-edge
+    // cascade did was queueing length verification on viewer nodes, so queue that once per
+    // viewer here - it's coalesced to a single VerifyLength() per node anyway
+    foreach (Node *n, node_children_) {
+      if (ViewerOutput *viewer = dynamic_cast<ViewerOutput*>(n)) {
+        viewer->QueueVerifyLength();
+      }
+    }
+  }
+}
+
 }
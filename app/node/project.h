@@ -161,6 +161,32 @@ public:
   QString GetColorReferenceSpace() const { return GetSetting(kColorReferenceSpace); }
   void SetColorReferenceSpace(const QString& s) { SetSetting(kColorReferenceSpace, s); }
 
+  /**
+   * @brief Mark the start of a bulk change, e.g. importing thousands of files
+   *
+   * View models listening to this project can suspend per-item updates between
+   * BatchOperationStarted() and BatchOperationEnded() and rebuild once at the end, so a mass
+   * import is bounded by probing the files rather than by model churn. Nestable; only the
+   * outermost pair emits the signals.
+   */
+  void BeginBatchOperation();
+
+  void EndBatchOperation();
+
+  /**
+   * @brief Mark the start of graph deserialization
+   *
+   * While active, Node::ConnectEdge() skips the per-edge invalidation cascade, which would
+   * otherwise walk every downstream path of the partially built graph and make load time scale
+   * with edge count times graph depth. EndGraphConstruction() runs one consolidated pass in its
+   * place. Nestable like the batch operation markers.
+   */
+  void BeginGraphConstruction();
+
+  void EndGraphConstruction();
+
+  bool IsUnderGraphConstruction() const { return graph_construction_depth_ > 0; }
+
 signals:
   void NameChanged();
 
@@ -192,6 +218,10 @@ signals:
 
   void SettingChanged(const QString &key, const QString &value);
 
+  void BatchOperationStarted();
+
+  void BatchOperationEnded();
+
 protected:
   virtual void childEvent(QChildEvent* event) override;
 
@@ -214,6 +244,10 @@ private:
 
   QMap<QString, QString> settings_;
 
+  int batch_operation_depth_;
+
+  int graph_construction_depth_;
+
 };
 
 }
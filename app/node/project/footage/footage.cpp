@@ -30,6 +30,7 @@
 #include "common/xmlutils.h"
 #include "config/config.h"
 #include "core.h"
+#include "render/diskmanager.h"
 #include "render/job/footagejob.h"
 #include "ui/icons/icons.h"
 
@@ -42,9 +43,14 @@ const QString Footage::kFilenameInput = QStringLiteral("file_in");
 Footage::Footage(const QString &filename) :
   ViewerOutput(false, false),
   timestamp_(0),
+  created_time_(0),
+  mod_time_(0),
+  file_size_(0),
+  growing_poll_start_(RATIONAL_MIN),
   valid_(false),
   cancelled_(nullptr),
-  total_stream_count_(0)
+  total_stream_count_(0),
+  proxy_divider_(1)
 {
   SetFlag(kIsItem);
 
@@ -71,13 +77,24 @@ void Footage::Retranslate()
   SetInputName(kFilenameInput, tr("Filename"));
 }
 
+// Per-thread so the project loader's deferral can't affect filename changes made by the user
+// on the main thread in the meantime
+thread_local bool probing_deferred_for_thread = false;
+
+void Footage::SetProbingDeferredForThisThread(bool e)
+{
+  probing_deferred_for_thread = e;
+}
+
 void Footage::InputValueChangedEvent(const QString &input, int element)
 {
   if (input == kFilenameInput) {
     // Reset internal stream cache
     Clear();
 
-    Reprobe();
+    if (!probing_deferred_for_thread) {
+      Reprobe();
+    }
   } else {
     super::InputValueChangedEvent(input, element);
   }
@@ -149,6 +166,16 @@ void Footage::set_filename(const QString &s)
   SetStandardValue(kFilenameInput, s);
 }
 
+void Footage::set_proxy(const QString &filename, int divider)
+{
+  proxy_filename_ = filename;
+  proxy_divider_ = qMax(1, divider);
+
+  // Ensure any frames rendered from the original file are re-rendered from the proxy (and
+  // vice versa on detach)
+  InvalidateAll(kFilenameInput);
+}
+
 const qint64 &Footage::timestamp() const
 {
   return timestamp_;
@@ -266,6 +293,10 @@ void Footage::Value(const NodeValueRow &value, const NodeGlobals &globals, NodeV
 
         job.set_video_params(vp);
 
+        if (!proxy_filename_.isEmpty() && vp.video_type() == VideoParams::kVideoTypeVideo) {
+          job.set_proxy(proxy_filename_, proxy_divider_);
+        }
+
         table->Push(NodeValue::kTexture, Texture::Job(vp, job), this, ref.ToString());
       } else if (ref.type() == Track::kAudio) {
         AudioParams ap = GetAudioParams(ref.index());
@@ -354,23 +385,17 @@ QVariant Footage::data(const DataType &d) const
 {
   switch (d) {
   case CREATED_TIME:
-  {
-    QFileInfo info(filename());
-
-    if (info.exists()) {
-      return QtUtils::GetCreationDate(info).toSecsSinceEpoch();
+    // Cached by Reprobe() - this is queried on every repaint/sort in the ProjectExplorer, so
+    // we can't afford to stat the file here
+    if (created_time_) {
+      return created_time_;
     }
     break;
-  }
   case MODIFIED_TIME:
-  {
-    QFileInfo info(filename());
-
-    if (info.exists()) {
-      return info.lastModified().toSecsSinceEpoch();
+    if (mod_time_) {
+      return mod_time_;
     }
     break;
-  }
   case ICON:
   {
     if (valid_ && GetTotalStreamCount()) {
@@ -442,6 +467,9 @@ bool Footage::LoadCustom(QXmlStreamReader *reader, SerializedData *data)
   while (XMLReadNextStartElement(reader)) {
     if (reader->name() == QStringLiteral("timestamp")) {
       this->set_timestamp(reader->readElementText().toLongLong());
+    } else if (reader->name() == QStringLiteral("proxy")) {
+      proxy_divider_ = qMax(1, reader->attributes().value(QStringLiteral("divider")).toInt());
+      proxy_filename_ = reader->readElementText();
     } else if (reader->name() == QStringLiteral("viewer")) {
       if (!ViewerOutput::LoadCustom(reader, data)) {
         return false;
@@ -458,6 +486,13 @@ void Footage::SaveCustom(QXmlStreamWriter *writer) const
 {
   writer->writeTextElement(QStringLiteral("timestamp"), QString::number(this->timestamp()));
 
+  if (!proxy_filename_.isEmpty()) {
+    writer->writeStartElement(QStringLiteral("proxy"));
+    writer->writeAttribute(QStringLiteral("divider"), QString::number(proxy_divider_));
+    writer->writeCharacters(proxy_filename_);
+    writer->writeEndElement(); // proxy
+  }
+
   writer->writeStartElement(QStringLiteral("viewer"));
 
   ViewerOutput::SaveCustom(writer);
@@ -475,6 +510,39 @@ void Footage::RemovedFromGraphEvent(Project *p)
   disconnect(p->color_manager(), &ColorManager::DefaultInputChanged, this, &Footage::DefaultColorSpaceChanged);
 }
 
+FootageDescription Footage::GetFootageDescription(const QString &filename, CancelAtom *cancelled)
+{
+  // Determine if we've already cached the metadata of this file. The identifier hashes
+  // path, mtime and size, so a stale entry for a changed file is simply never read again.
+  QString meta_cache_file = QDir(DiskManager::GetFootageMetaPath()).filePath(FileFunctions::GetUniqueFileIdentifier(filename));
+
+  FootageDescription footage_info;
+
+  // Try to load footage info from cache
+  if (!QFileInfo::exists(meta_cache_file) || !footage_info.Load(meta_cache_file)) {
+
+    // Probe and create cache
+    QVector<DecoderPtr> decoder_list = Decoder::ReceiveListOfAllDecoders();
+
+    foreach (DecoderPtr decoder, decoder_list) {
+      footage_info = decoder->Probe(filename, cancelled);
+
+      if (footage_info.IsValid()) {
+        break;
+      }
+    }
+
+    if (!cancelled || !cancelled->HeardCancel()) {
+      if (!footage_info.Save(meta_cache_file)) {
+        qWarning() << "Failed to save stream cache, footage will have to be re-probed";
+      }
+    }
+
+  }
+
+  return footage_info;
+}
+
 void Footage::Reprobe()
 {
   // Determine if file still exists
@@ -483,40 +551,21 @@ void Footage::Reprobe()
   // In case of failure to load file, set timestamp to a value that will always be invalid so we
   // continuously reprobe
   set_timestamp(0);
+  created_time_ = 0;
+  mod_time_ = 0;
+  file_size_ = 0;
 
   if (!filename.isEmpty()) {
     QFileInfo info(filename);
 
     if (info.exists()) {
-      // Grab timestamp
+      // Grab timestamp, and cache the times the explorer sorts/displays by while we have the stat
       set_timestamp(info.lastModified().toMSecsSinceEpoch());
+      created_time_ = QtUtils::GetCreationDate(info).toSecsSinceEpoch();
+      mod_time_ = info.lastModified().toSecsSinceEpoch();
+      file_size_ = info.size();
 
-      // Determine if we've already cached the metadata of this file
-      QString meta_cache_file = QDir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation)).filePath(FileFunctions::GetUniqueFileIdentifier(filename));
-
-      FootageDescription footage_info;
-
-      // Try to load footage info from cache
-      if (!QFileInfo::exists(meta_cache_file) || !footage_info.Load(meta_cache_file)) {
-
-        // Probe and create cache
-        QVector<DecoderPtr> decoder_list = Decoder::ReceiveListOfAllDecoders();
-
-        foreach (DecoderPtr decoder, decoder_list) {
-          footage_info = decoder->Probe(filename, cancelled_);
-
-          if (footage_info.IsValid()) {
-            break;
-          }
-        }
-
-        if (!cancelled_ || !cancelled_->HeardCancel()) {
-          if (!footage_info.Save(meta_cache_file)) {
-            qWarning() << "Failed to save stream cache, footage will have to be re-probed";
-          }
-        }
-
-      }
+      FootageDescription footage_info = GetFootageDescription(filename, cancelled_);
 
       if (footage_info.IsValid()) {
         decoder_ = footage_info.decoder();
@@ -592,13 +641,82 @@ void Footage::CheckFootage()
 
       if (current_file_timestamp != timestamp()) {
         // File has changed!
-        Reprobe();
-        InvalidateAll(kFilenameInput);
+        qint64 current_file_size = info.size();
+
+        if (IsValid() && file_size_ > 0 && current_file_size > file_size_ && PollGrowingFile()) {
+          // File is still being written to (e.g. a recording being ingested while it's edited).
+          // PollGrowingFile() extended the stream durations in place, so just take note of the
+          // new timestamp/size and keep watching for further growth.
+          set_timestamp(current_file_timestamp);
+          mod_time_ = info.lastModified().toSecsSinceEpoch();
+          file_size_ = current_file_size;
+        } else {
+          Reprobe();
+          InvalidateAll(kFilenameInput);
+        }
       }
     }
   }
 }
 
+bool Footage::PollGrowingFile()
+{
+  DecoderPtr decoder = Decoder::CreateFromID(decoder_);
+  if (!decoder) {
+    return false;
+  }
+
+  QHash<int, int64_t> durations;
+  if (!decoder->PollDuration(filename(), durations)) {
+    return false;
+  }
+
+  // Nothing before the old end of the streams changed, so clamp the invalidations the stream
+  // updates will trigger to the newly appended region
+  rational video_length = GetVideoLength();
+  rational audio_length = GetAudioLength();
+  if (video_length.isNull()) {
+    growing_poll_start_ = audio_length;
+  } else if (audio_length.isNull()) {
+    growing_poll_start_ = video_length;
+  } else {
+    growing_poll_start_ = qMin(video_length, audio_length);
+  }
+
+  for (int i=0; i<GetVideoStreamCount(); i++) {
+    VideoParams vp = GetVideoParams(i);
+    auto it = durations.constFind(vp.stream_index());
+    if (it != durations.constEnd() && it.value() > vp.duration()) {
+      vp.set_duration(it.value());
+      SetStream(Track::kVideo, QVariant::fromValue(vp), i);
+    }
+  }
+
+  for (int i=0; i<GetAudioStreamCount(); i++) {
+    AudioParams ap = GetAudioParams(i);
+    auto it = durations.constFind(ap.stream_index());
+    if (it != durations.constEnd() && it.value() > ap.duration()) {
+      ap.set_duration(it.value());
+      SetStream(Track::kAudio, QVariant::fromValue(ap), i);
+    }
+  }
+
+  growing_poll_start_ = RATIONAL_MIN;
+
+  return true;
+}
+
+void Footage::InvalidateCache(const TimeRange &range, const QString &from, int element, InvalidateCacheOptions options)
+{
+  TimeRange r = range;
+
+  if (growing_poll_start_ != RATIONAL_MIN && r.in() < growing_poll_start_) {
+    r.set_in(growing_poll_start_);
+  }
+
+  super::InvalidateCache(r, from, element, options);
+}
+
 void Footage::DefaultColorSpaceChanged()
 {
   bool inv = false;
@@ -95,6 +95,28 @@ public:
    */
   void SetValid();
 
+  /**
+   * @brief Probe `filename`, or load its cached probe result if one exists
+   *
+   * Pure file I/O - no node state is touched - so this is safe to run for many files across
+   * threads at once to warm the probe cache.
+   */
+  static FootageDescription GetFootageDescription(const QString &filename, CancelAtom *cancelled = nullptr);
+
+  /**
+   * @brief Set whether filename changes on the calling thread skip the automatic re-probe
+   *
+   * The project loader defers the probe that setting each footage's filename would otherwise
+   * trigger, warms the probe cache for every file in parallel, and then runs Reprobe() on each
+   * node against the warm cache.
+   */
+  static void SetProbingDeferredForThisThread(bool e);
+
+  /**
+   * @brief Synchronize streams with the file on disk, probing it or reading the probe cache
+   */
+  void Reprobe();
+
   /**
    * @brief Return the current filename of this Footage object
    */
@@ -131,6 +153,27 @@ public:
    */
   void set_timestamp(const qint64 &t);
 
+  /**
+   * @brief Filename of the proxy generated for this footage's video, or empty if none is attached
+   */
+  const QString &proxy_filename() const
+  {
+    return proxy_filename_;
+  }
+
+  /**
+   * @brief Divider the attached proxy was generated at (2 = half resolution, 4 = quarter)
+   */
+  int proxy_divider() const
+  {
+    return proxy_divider_;
+  }
+
+  /**
+   * @brief Attach a proxy to this footage's video, or detach it with an empty filename
+   */
+  void set_proxy(const QString &filename, int divider);
+
   void SetCancelPointer(CancelAtom *c)
   {
     cancelled_ = c;
@@ -159,6 +202,8 @@ public:
 
   virtual void Value(const NodeValueRow& value, const NodeGlobals &globals, NodeValueTable *table) const override;
 
+  virtual void InvalidateCache(const TimeRange& range, const QString& from, int element, InvalidateCacheOptions options) override;
+
   static QString GetStreamTypeName(Track::Type type);
 
   virtual Node *GetConnectedTextureOutput() override;
@@ -187,15 +232,48 @@ protected:
 private:
   QString GetColorspaceToUse(const VideoParams& params) const;
 
-  void Reprobe();
-
   VideoParams MergeVideoStream(const VideoParams &base, const VideoParams &over);
 
+  /**
+   * @brief Extend stream durations from a file that is still being written
+   *
+   * Used instead of Reprobe() when CheckFootage() sees the file grow. Re-polls just the
+   * durations through the decoder and extends the streams in place, so the existing frame and
+   * audio caches stay valid and only the newly appended region is invalidated.
+   *
+   * Returns false if the decoder can't poll durations, in which case the caller should fall
+   * back to a full Reprobe().
+   */
+  bool PollGrowingFile();
+
   /**
    * @brief Internal timestamp object
    */
   qint64 timestamp_;
 
+  /**
+   * @brief File creation/modification times cached by Reprobe()
+   *
+   * The ProjectExplorer model queries these on every repaint and sort, so they're cached here
+   * rather than stat'ing the file on each access (which stutters badly on network volumes).
+   * 0 means unknown. CheckFootage() already polls the file, so changes still get picked up.
+   */
+  qint64 created_time_;
+  qint64 mod_time_;
+
+  /**
+   * @brief File size cached by Reprobe(), used by CheckFootage() to detect a growing file
+   */
+  qint64 file_size_;
+
+  /**
+   * @brief Start of the range a growing-file duration poll is extending, or RATIONAL_MIN
+   *
+   * While PollGrowingFile() updates streams, the invalidations its value changes trigger are
+   * clamped to begin no earlier than this, since nothing before the old end of file changed.
+   */
+  rational growing_poll_start_;
+
   /**
    * @brief Internal attached decoder ID
    */
@@ -207,6 +285,10 @@ private:
 
   int total_stream_count_;
 
+  QString proxy_filename_;
+
+  int proxy_divider_;
+
 private slots:
   void CheckFootage();
 
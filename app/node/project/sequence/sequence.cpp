@@ -48,7 +48,7 @@ Sequence::Sequence()
     TrackList* list = new TrackList(this, static_cast<Track::Type>(i), track_input_id);
     track_lists_.replace(i, list);
     connect(list, &TrackList::TrackListChanged, this, &Sequence::UpdateTrackCache);
-    connect(list, &TrackList::LengthChanged, this, &Sequence::VerifyLength);
+    connect(list, &TrackList::LengthChanged, this, &Sequence::QueueVerifyLength);
     connect(list, &TrackList::TrackAdded, this, &Sequence::TrackAdded);
     connect(list, &TrackList::TrackRemoved, this, &Sequence::TrackRemoved);
   }
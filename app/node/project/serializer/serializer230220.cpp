@@ -79,7 +79,7 @@ ProjectSerializer230220::LoadData ProjectSerializer230220::Load(Project *project
           QString node_id;
           XMLAttributeLoop(reader, attr) {
             if (attr.name() == QStringLiteral("id")) {
-              node_id = attr.value().toString();
+              node_id = XMLInternString(attr.value().toString());
               break;
             }
           }
@@ -97,7 +97,7 @@ ProjectSerializer230220::LoadData ProjectSerializer230220::Load(Project *project
                 QString input_id;
                 XMLAttributeLoop(reader, attr) {
                   if (attr.name() == QStringLiteral("id")) {
-                    input_id = attr.value().toString();
+                    input_id = XMLInternString(attr.value().toString());
                     break;
                   }
                 }
@@ -186,7 +186,7 @@ ProjectSerializer230220::LoadData ProjectSerializer230220::Load(Project *project
 
           XMLAttributeLoop(reader, attr) {
             if (attr.name() == QStringLiteral("id")) {
-              id = attr.value().toString();
+              id = XMLInternString(attr.value().toString());
             } else if (attr.name() == QStringLiteral("ptr")) {
               ptr = attr.value().toULongLong();
             } else if (attr.name() == QStringLiteral("items")) {
@@ -22,12 +22,28 @@
 #define SPLITVALUE_H
 
 #include <QVariant>
+#include <QVarLengthArray>
 #include <QVector>
 
 namespace olive {
 
 using SplitValue = QVector<QVariant>;
 
+/**
+ * @brief The most keyframe tracks any value type splits into (kBezier's six)
+ */
+constexpr int kSplitValueMaxTracks = 6;
+
+/**
+ * @brief Fixed-capacity variant of SplitValue for hot evaluation paths
+ *
+ * Splitting a vector parameter into per-channel values happens for every keyframed read, so
+ * paths that split and immediately recombine use this inline storage to avoid heap-allocating
+ * a QVector each time. SplitValue remains the type for storage and UI code that keeps the
+ * split form around.
+ */
+using InlineSplitValue = QVarLengthArray<QVariant, kSplitValueMaxTracks>;
+
 }
 
 #endif // SPLITVALUE_H
@@ -0,0 +1,128 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "traversalplancache.h"
+
+#include "node.h"
+#include "node/output/track/track.h"
+
+namespace olive {
+
+NodeTraversalPlanCache *NodeTraversalPlanCache::instance_ = nullptr;
+
+NodeTraversalPlanCache::NodeTraversalPlanCache(QObject *parent) :
+  QObject(parent)
+{
+}
+
+NodeTraversalPlanCache *NodeTraversalPlanCache::instance()
+{
+  static QMutex instance_mutex;
+  QMutexLocker locker(&instance_mutex);
+
+  if (!instance_) {
+    instance_ = new NodeTraversalPlanCache();
+  }
+
+  return instance_;
+}
+
+NodeTraversalPlanCache::Plan NodeTraversalPlanCache::GetPlan(const Node *node)
+{
+  QMutexLocker locker(&mutex_);
+
+  auto it = plans_.find(node);
+  if (it != plans_.end()) {
+    return it.value();
+  }
+
+  Plan plan = BuildPlan(node);
+  plans_.insert(node, plan);
+
+  if (!watched_.contains(node)) {
+    watched_.insert(node);
+
+    // Direct connections so invalidation happens synchronously with the edit,
+    // not whenever this object's thread spins its event loop
+    connect(node, &Node::InputConnected, this, &NodeTraversalPlanCache::NodeChanged, Qt::DirectConnection);
+    connect(node, &Node::InputDisconnected, this, &NodeTraversalPlanCache::NodeChanged, Qt::DirectConnection);
+    connect(node, &Node::InputAdded, this, &NodeTraversalPlanCache::NodeChanged, Qt::DirectConnection);
+    connect(node, &Node::InputRemoved, this, &NodeTraversalPlanCache::NodeChanged, Qt::DirectConnection);
+    connect(node, &Node::InputArraySizeChanged, this, &NodeTraversalPlanCache::NodeChanged, Qt::DirectConnection);
+    connect(node, &QObject::destroyed, this, &NodeTraversalPlanCache::NodeDestroyed, Qt::DirectConnection);
+
+    // Tracks prune their block array from the plan while muted, so a mute toggle changes the
+    // plan even though no wiring did
+    if (const Track *track = dynamic_cast<const Track*>(node)) {
+      connect(track, &Track::MutedChanged, this, &NodeTraversalPlanCache::NodeChanged, Qt::DirectConnection);
+    }
+  }
+
+  return plan;
+}
+
+NodeTraversalPlanCache::Plan NodeTraversalPlanCache::BuildPlan(const Node *node)
+{
+  Plan plan;
+
+  auto ignore = node->IgnoreInputsForRendering();
+
+  foreach (const QString &input, node->inputs()) {
+    if (ignore.contains(input)) {
+      continue;
+    }
+
+    PlannedInput planned;
+    planned.input = input;
+    planned.array = node->InputIsArray(input);
+    planned.connected = node->IsInputConnectedForRender(input);
+    planned.output = planned.connected ? node->GetConnectedRenderOutput(input) : nullptr;
+
+    plan.append(planned);
+  }
+
+  return plan;
+}
+
+void NodeTraversalPlanCache::Invalidate(const Node *node)
+{
+  QMutexLocker locker(&mutex_);
+
+  plans_.remove(node);
+  plan_change_time_.Acquire();
+}
+
+void NodeTraversalPlanCache::NodeChanged()
+{
+  Invalidate(static_cast<const Node*>(sender()));
+}
+
+void NodeTraversalPlanCache::NodeDestroyed(QObject *obj)
+{
+  QMutexLocker locker(&mutex_);
+
+  const Node *node = reinterpret_cast<const Node*>(obj);
+
+  plans_.remove(node);
+  watched_.remove(node);
+  plan_change_time_.Acquire();
+}
+
+}
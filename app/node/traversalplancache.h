@@ -0,0 +1,98 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef TRAVERSALPLANCACHE_H
+#define TRAVERSALPLANCACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QVector>
+
+#include "common/jobtime.h"
+
+namespace olive {
+
+class Node;
+
+/**
+ * @brief Caches per-node input wiring for NodeTraverser across frames
+ *
+ * NodeTraverser used to re-query each node's input list and connection state
+ * through several hash lookups for every input of every node of every frame,
+ * even though the wiring only changes when the graph is edited. This cache
+ * compiles the renderable inputs of a node - minus ignored inputs, with the
+ * connected output pre-resolved - once, and serves the flat list to all
+ * render threads until a signal indicates the node's wiring changed.
+ *
+ * Thread-safe; plans are returned by value (implicitly shared) so render
+ * threads can keep iterating a plan that is invalidated mid-frame.
+ */
+class NodeTraversalPlanCache : public QObject
+{
+  Q_OBJECT
+public:
+  struct PlannedInput {
+    QString input;
+    bool array;
+    bool connected;
+    Node *output;
+  };
+
+  using Plan = QVector<PlannedInput>;
+
+  static NodeTraversalPlanCache *instance();
+
+  Plan GetPlan(const Node *node);
+
+  const JobTime &GetPlanChangeTime() const
+  {
+    return plan_change_time_;
+  }
+
+private:
+  explicit NodeTraversalPlanCache(QObject *parent = nullptr);
+
+  Plan BuildPlan(const Node *node);
+
+  void Invalidate(const Node *node);
+
+  static NodeTraversalPlanCache *instance_;
+
+  QMutex mutex_;
+
+  QHash<const Node*, Plan> plans_;
+
+  // Nodes whose change signals we are already watching
+  QSet<const Node*> watched_;
+
+  JobTime plan_change_time_;
+
+private slots:
+  void NodeChanged();
+
+  void NodeDestroyed(QObject *obj);
+
+};
+
+}
+
+#endif // TRAVERSALPLANCACHE_H
@@ -20,9 +20,14 @@
 
 #include "traverser.h"
 
+#include <QtConcurrent/QtConcurrent>
+
 #include "node.h"
 #include "node/block/clip/clip.h"
+#include "node/output/viewer/viewer.h"
+#include "node/valuememocache.h"
 #include "render/job/footagejob.h"
+#include "render/nodeprofiler.h"
 #include "render/rendermanager.h"
 
 namespace olive {
@@ -37,18 +42,56 @@ NodeValueDatabase NodeTraverser::GenerateDatabase(const Node* node, const TimeRa
     loop_mode_ = clip->loop_mode();
   }
 
-  // We need to insert tables into the database for each input
-  auto ignore = node->IgnoreInputsForRendering();
-  foreach (const QString& input, node->inputs()) {
+  // We need to insert tables into the database for each input. The plan
+  // cache gives us the renderable inputs with their connections already
+  // resolved so we don't re-query the node's hashes every frame.
+  NodeTraversalPlanCache::Plan plan = NodeTraversalPlanCache::instance()->GetPlan(node);
+
+  // When branch parallelism is enabled, independent subtrees (e.g. the two sides of a merge)
+  // are handed to the thread pool while the worker budget lasts, so wide composites use more
+  // than one core per frame. The first connected branch always stays on this thread. Branches
+  // that share upstream nodes are re-evaluated per worker since each worker keeps its own
+  // table cache - the win on disjoint branches outweighs that. Disabled while calculating
+  // gizmo transforms, which track the traversal path through a single traverser.
+  QVector< QPair<QString, QFuture<NodeValueTable> > > branch_futures;
+  bool kept_branch_inline = false;
+
+  for (const NodeTraversalPlanCache::PlannedInput &input : qAsConst(plan)) {
     if (IsCancelled()) {
       return NodeValueDatabase();
     }
 
-    if (ignore.contains(input)) {
-      continue;
+    if (branch_budget_ && !transform_ && input.connected && !input.array) {
+      if (!kept_branch_inline) {
+        kept_branch_inline = true;
+      } else if (branch_budget_->fetch_sub(1) > 0) {
+        if (NodeTraverser *worker = CreateBranchWorker()) {
+          worker->SetLoopMode(loop_mode_);
+
+          std::atomic_int *budget = branch_budget_;
+          branch_futures.append(qMakePair(input.input, QtConcurrent::run([worker, budget, node, input, range]{
+            NodeValueTable table = worker->ProcessInput(node, input, range);
+            delete worker;
+            budget->fetch_add(1);
+            return table;
+          })));
+
+          continue;
+        } else {
+          branch_budget_->fetch_add(1);
+        }
+      } else {
+        branch_budget_->fetch_add(1);
+      }
     }
 
-    database.Insert(input, ProcessInput(node, input, range));
+    database.Insert(input.input, ProcessInput(node, input, range));
+  }
+
+  // Join spawned branches at this node. If the pool is saturated, result() runs the task on
+  // this thread rather than deadlocking.
+  for (auto it=branch_futures.begin(); it!=branch_futures.end(); it++) {
+    database.Insert(it->first, it->second.result());
   }
 
   loop_mode_ = old_loop_mode;
@@ -184,6 +227,18 @@ void NodeTraverser::Transform(QTransform *transform, const Node *start, const No
   transform_ = nullptr;
 }
 
+NodeValueTable NodeTraverser::ProcessInput(const Node *node, const NodeTraversalPlanCache::PlannedInput &input, const TimeRange &range)
+{
+  if (input.connected) {
+    // Connection was pre-resolved when the plan was compiled
+    TimeRange adjusted_range = node->InputTimeAdjustment(input.input, -1, range, true);
+
+    return GenerateTable(input.output, adjusted_range, node);
+  }
+
+  return ProcessInput(node, input.input, range);
+}
+
 NodeValueTable NodeTraverser::ProcessInput(const Node* node, const QString& input, const TimeRange& range)
 {
   // If input is connected, retrieve value directly
@@ -254,8 +309,24 @@ void NodeTraverser::ProcessInputElement(NodeValueTableArray &array_tbl, const No
 NodeTraverser::NodeTraverser() :
   cancel_(nullptr),
   transform_(nullptr),
-  loop_mode_(LoopMode::kLoopModeOff)
+  loop_mode_(LoopMode::kLoopModeOff),
+  render_mode_(RenderMode::kOnline),
+  branch_budget_(nullptr),
+  branch_budget_storage_(0),
+  serve_viewer_cache_(false)
+{
+}
+
+void NodeTraverser::SetBranchParallelismEnabled(bool enabled)
 {
+  if (enabled) {
+    // Budget of extra workers shared by this traverser and any workers it spawns, so a wide
+    // graph can't fan out into more threads than there are cores
+    branch_budget_storage_ = qMax(0, QThread::idealThreadCount() - 1);
+    branch_budget_ = &branch_budget_storage_;
+  } else {
+    branch_budget_ = nullptr;
+  }
 }
 
 class GTTTime
@@ -283,6 +354,48 @@ NodeValueTable NodeTraverser::GenerateTable(const Node *n, const TimeRange& rang
     }
   }
 
+  // A nested sequence is usually a finished cut, but it still costs a full traversal of its
+  // internal graph every time the parent renders. If its own frame cache already holds this
+  // frame, push a CacheJob for the cached file and skip the traversal entirely. Skipped while
+  // calculating gizmo transforms, which need the traversal itself.
+  if (serve_viewer_cache_ && !transform_) {
+    if (const ViewerOutput *viewer = dynamic_cast<const ViewerOutput*>(n)) {
+      FrameHashCache *viewer_cache = viewer->video_frame_cache();
+
+      QMutexLocker locker(viewer_cache->mutex());
+
+      viewer_cache->LoadState();
+
+      QString cache_fn = viewer_cache->GetValidCacheFilename(range.in());
+      if (!cache_fn.isEmpty()) {
+        // Match the params a traversed render would have produced so downstream sizing is
+        // unaffected - ProcessVideoCacheJob sizes the real texture from the loaded frame
+        VideoParams vp = viewer->GetVideoParams();
+        vp.set_divider(GetCacheVideoParams().divider());
+
+        NodeValueTable table;
+        table.Push(NodeValue(NodeValue::kTexture,
+                             QVariant::fromValue(Texture::Job(vp, CacheJob(cache_fn))),
+                             n, false, Track::Reference(Track::kVideo, 0).ToString()));
+
+        value_cache_[n][range] = table;
+        return table;
+      }
+    }
+  }
+
+  // Static branches produce the same table regardless of time, so replay the output memoized by
+  // an earlier ticket instead of re-traversing. Skipped while calculating gizmo transforms,
+  // which need the traversal itself.
+  bool memoize = !transform_ && NodeValueMemoCache::instance()->IsStatic(n);
+  if (memoize) {
+    NodeValueTable memoized;
+    if (NodeValueMemoCache::instance()->Get(n, video_params_, audio_params_, render_mode_, &memoized)) {
+      value_cache_[n][range] = memoized;
+      return memoized;
+    }
+  }
+
   // Generate row for node
   NodeValueDatabase database = GenerateDatabase(n, range);
 
@@ -304,7 +417,7 @@ NodeValueTable NodeTraverser::GenerateTable(const Node *n, const TimeRange& rang
     table = database.Merge();
 
     // By this point, the node should have all the inputs it needs to render correctly
-    NodeGlobals globals(video_params_, audio_params_, range, loop_mode_);
+    NodeGlobals globals(video_params_, audio_params_, range, loop_mode_, render_mode_);
     n->Value(row, globals, &table);
 
     // `transform_now_` is the next node in the path that needs to be traversed. It only ever goes
@@ -335,6 +448,10 @@ NodeValueTable NodeTraverser::GenerateTable(const Node *n, const TimeRange& rang
 
   value_cache_[n][range] = table;
 
+  if (memoize) {
+    NodeValueMemoCache::instance()->Insert(n, video_params_, audio_params_, render_mode_, table);
+  }
+
   return table;
 }
 
@@ -343,6 +460,79 @@ TexturePtr NodeTraverser::ProcessVideoCacheJob(const CacheJob *val)
   return nullptr;
 }
 
+QVector<NodeTraverser::ShaderPass> NodeTraverser::CollectShaderChain(const Node *node, ShaderJob *job)
+{
+  // Maximum number of passes we'll try to merge into one blit. Chains longer
+  // than this are simply split into multiple fused blits.
+  static const int kMaxChainLength = 8;
+
+  auto is_fusion_safe = [](ShaderJob *j) {
+    return !j->GetFusableInput().isEmpty()
+        && j->GetIterationCount() <= 1
+        && j->GetVertexCoordinates().isEmpty();
+  };
+
+  QVector<ShaderPass> chain;
+
+  if (!is_fusion_safe(job)) {
+    chain.append({node, job});
+    return chain;
+  }
+
+  chain.append({node, job});
+
+  // Walk upstream through each pass's texture input as long as it's an
+  // unresolved fusable shader job
+  while (chain.size() < kMaxChainLength) {
+    ShaderJob *cur = chain.first().job;
+
+    NodeValue input = cur->Get(cur->GetFusableInput());
+    if (input.type() != NodeValue::kTexture) {
+      break;
+    }
+
+    TexturePtr input_tex = input.toTexture();
+    if (!input_tex || resolved_texture_cache_.contains(input_tex.get())) {
+      break;
+    }
+
+    ShaderJob *upstream = dynamic_cast<ShaderJob*>(input_tex->job());
+    if (!upstream || !is_fusion_safe(upstream)) {
+      break;
+    }
+
+    chain.prepend({input.source(), upstream});
+  }
+
+  return chain;
+}
+
+void NodeTraverser::ProcessShaderChain(TexturePtr destination, const QVector<ShaderPass> &chain)
+{
+  // Default implementation: render each pass separately through intermediate
+  // textures. Backends that can merge passes override this.
+  TexturePtr input;
+
+  for (int i=0; i<chain.size(); i++) {
+    // Stop queueing passes once the ticket is cancelled so the thread frees up immediately
+    if (IsCancelled()) {
+      return;
+    }
+
+    const ShaderPass &pass = chain.at(i);
+
+    if (input) {
+      pass.job->Insert(pass.job->GetFusableInput(), NodeValue(NodeValue::kTexture, QVariant::fromValue(input), pass.node));
+    }
+
+    TexturePtr output = (i == chain.size()-1) ? destination : CreateTexture(destination->params());
+
+    ProcessShader(output, pass.node, pass.job);
+
+    input = output;
+  }
+}
+
 QVector2D NodeTraverser::GenerateResolution() const
 {
   return QVector2D(video_params_.square_pixel_width(), video_params_.height());
@@ -358,6 +548,39 @@ void NodeTraverser::ResolveJobs(NodeValue &val)
         if (resolved_texture_cache_.contains(job_tex.get())) {
           val.set_value(resolved_texture_cache_.value(job_tex.get()));
         } else {
+          // See if this job caps a run of fusable shader passes that can be
+          // rendered as one blit
+          QVector<ShaderPass> shader_chain;
+          if (ShaderJob *sj = dynamic_cast<ShaderJob*>(base_job)) {
+            shader_chain = CollectShaderChain(val.source(), sj);
+          }
+
+          if (shader_chain.size() > 1) {
+            // Resolve each pass's sub-jobs except the links between passes,
+            // which are rendered inline by the chain
+            for (int i=0; i<shader_chain.size(); i++) {
+              ShaderJob *pass = shader_chain.at(i).job;
+              for (auto it=pass->GetValues().begin(); it!=pass->GetValues().end(); it++) {
+                if (i > 0 && it.key() == pass->GetFusableInput()) {
+                  continue;
+                }
+                ResolveJobs(it.value());
+              }
+            }
+
+            TexturePtr tex = CreateTexture(job_tex->params());
+
+            {
+              NodeProfilerTimer profile(val.source(), NodeProfiler::kShader);
+              ProcessShaderChain(tex, shader_chain);
+            }
+
+            val.set_value(tex);
+
+            resolved_texture_cache_.insert(job_tex.get(), val.toTexture());
+            return;
+          }
+
           // Resolve any sub-jobs
           for (auto it=base_job->GetValues().begin(); it!=base_job->GetValues().end(); it++) {
             // Jobs will almost always be submitted with one of these types
@@ -386,7 +609,10 @@ void NodeTraverser::ResolveJobs(NodeValue &val)
             ResolveJobs(v);
             ctj->SetInputTexture(v);
 
-            ProcessColorTransform(dest, val.source(), ctj);
+            {
+              NodeProfilerTimer profile(val.source(), NodeProfiler::kShader);
+              ProcessColorTransform(dest, val.source(), ctj);
+            }
 
             val.set_value(dest);
 
@@ -396,7 +622,10 @@ void NodeTraverser::ResolveJobs(NodeValue &val)
 
             TexturePtr tex = CreateTexture(tex_params);
 
-            ProcessShader(tex, val.source(), sj);
+            {
+              NodeProfilerTimer profile(val.source(), NodeProfiler::kShader);
+              ProcessShader(tex, val.source(), sj);
+            }
 
             val.set_value(tex);
 
@@ -406,7 +635,10 @@ void NodeTraverser::ResolveJobs(NodeValue &val)
 
             TexturePtr tex = CreateTexture(tex_params);
 
-            ProcessFrameGeneration(tex, val.source(), gj);
+            {
+              NodeProfilerTimer profile(val.source(), NodeProfiler::kShader);
+              ProcessFrameGeneration(tex, val.source(), gj);
+            }
 
             // Convert to reference space
             const QString &colorspace = tex_params.colorspace();
@@ -437,7 +669,10 @@ void NodeTraverser::ResolveJobs(NodeValue &val)
               managed_params.set_format(GetCacheVideoParams().format());
 
               tex = CreateTexture(managed_params);
-              ProcessVideoFootage(tex, fj, footage_time);
+              {
+                NodeProfilerTimer profile(val.source(), NodeProfiler::kFootage);
+                ProcessVideoFootage(tex, fj, footage_time);
+              }
             }
 
             val.set_value(tex);
@@ -456,14 +691,20 @@ void NodeTraverser::ResolveJobs(NodeValue &val)
 
       SampleJob job = val.value<SampleJob>();
       SampleBuffer output_buffer = CreateSampleBuffer(job.samples().audio_params(), job.samples().sample_count());
-      ProcessSamples(output_buffer, val.source(), job.time(), job);
+      {
+        NodeProfilerTimer profile(val.source(), NodeProfiler::kSamples);
+        ProcessSamples(output_buffer, val.source(), job.time(), job);
+      }
       val.set_value(QVariant::fromValue(output_buffer));
 
     } else if (val.canConvert<FootageJob>()) {
 
       FootageJob job = val.value<FootageJob>();
       SampleBuffer buffer = CreateSampleBuffer(GetCacheAudioParams(), job.time().length());
-      ProcessAudioFootage(buffer, &job, job.time());
+      {
+        NodeProfilerTimer profile(val.source(), NodeProfiler::kFootage);
+        ProcessAudioFootage(buffer, &job, job.time());
+      }
       val.set_value(buffer);
 
     }
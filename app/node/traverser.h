@@ -21,13 +21,17 @@
 #ifndef NODETRAVERSER_H
 #define NODETRAVERSER_H
 
+#include <atomic>
+
 #include <QVector2D>
 
 #include "codec/decoder.h"
 #include "common/cancelableobject.h"
 #include "node/output/track/track.h"
+#include "node/traversalplancache.h"
 #include "render/job/cachejob.h"
 #include "render/cancelatom.h"
+#include "render/rendermodes.h"
 #include "render/job/footagejob.h"
 #include "render/job/colortransformjob.h"
 #include "render/job/footagejob.h"
@@ -74,9 +78,33 @@ public:
     audio_params_ = params;
   }
 
+  /**
+   * @brief Enable evaluating independent graph branches on the thread pool
+   *
+   * Requires a subclass that implements CreateBranchWorker(). Should only be enabled on the
+   * traverser at the root of a job - workers it spawns share its budget.
+   */
+  void SetBranchParallelismEnabled(bool enabled);
+
+  /**
+   * @brief Serve nested ViewerOutputs from their own frame cache where valid
+   *
+   * A sequence nested in another is usually a finished cut, but it still costs a full
+   * traversal of its internal graph every time the parent renders. With this enabled,
+   * GenerateTable() short-circuits a ViewerOutput whose disk cache already holds the
+   * requested frame and pushes a CacheJob instead.
+   *
+   * Only safe for video traversals - a cached frame can't stand in for the sequence's
+   * samples - so the video render path enables this per-ticket.
+   */
+  void SetServeViewerCacheEnabled(bool enabled) { serve_viewer_cache_ = enabled; }
+  bool GetServeViewerCacheEnabled() const { return serve_viewer_cache_; }
+
 protected:
   NodeValueTable ProcessInput(const Node *node, const QString &input, const TimeRange &range);
 
+  NodeValueTable ProcessInput(const Node *node, const NodeTraversalPlanCache::PlannedInput &input, const TimeRange &range);
+
   void ProcessInputElement(NodeValueTableArray &array_tbl, const Node *node, const QString &input, int element, const TimeRange &range);
 
   virtual void ProcessVideoFootage(TexturePtr destination, const FootageJob *stream, const rational &input_time){}
@@ -85,6 +113,20 @@ protected:
 
   virtual void ProcessShader(TexturePtr destination, const Node *node, const ShaderJob *job){}
 
+  /**
+   * @brief A run of fusable shader jobs, ordered upstream first
+   *
+   * Each pass samples the previous pass's output through its fusable input.
+   * Backends may render these as a single blit; the default implementation
+   * renders each pass separately through intermediate textures.
+   */
+  struct ShaderPass {
+    const Node *node;
+    ShaderJob *job;
+  };
+
+  virtual void ProcessShaderChain(TexturePtr destination, const QVector<ShaderPass> &chain);
+
   virtual void ProcessColorTransform(TexturePtr destination, const Node *node, const ColorTransformJob *job){}
 
   virtual void ProcessSamples(SampleBuffer &destination, const Node *node, const TimeRange &range, const SampleJob &job){}
@@ -115,6 +157,18 @@ protected:
     }
   }
 
+  /**
+   * @brief Create an independent traverser for evaluating a branch on another thread
+   *
+   * When branch parallelism is enabled, GenerateDatabase hands independent subtrees to the
+   * thread pool, each running through its own traverser since the table cache isn't safe to
+   * share across threads. Returns null by default, which keeps branch evaluation serial.
+   */
+  virtual NodeTraverser *CreateBranchWorker() { return nullptr; }
+
+  void SetBranchBudget(std::atomic_int *budget) { branch_budget_ = budget; }
+  std::atomic_int *GetBranchBudget() const { return branch_budget_; }
+
   QVector2D GenerateResolution() const;
 
   bool IsCancelled()
@@ -139,12 +193,18 @@ protected:
   }
 
   LoopMode loop_mode() const { return loop_mode_; }
+  void SetLoopMode(LoopMode mode) { loop_mode_ = mode; }
+
+  RenderMode::Mode render_mode() const { return render_mode_; }
+  void SetRenderMode(RenderMode::Mode mode) { render_mode_ = mode; }
 
   virtual bool UseCache() const { return false; }
 
 private:
   TexturePtr CreateDummyTexture(const VideoParams &p);
 
+  QVector<ShaderPass> CollectShaderChain(const Node *node, ShaderJob *job);
+
   VideoParams video_params_;
 
   AudioParams audio_params_;
@@ -159,9 +219,18 @@ private:
 
   LoopMode loop_mode_;
 
+  RenderMode::Mode render_mode_;
+
   QHash<const Node*, QHash<TimeRange, NodeValueTable> > value_cache_;
   QHash<Texture*, TexturePtr> resolved_texture_cache_;
 
+  // Remaining branch workers this traverser (and its workers) may spawn, or null if branch
+  // parallelism is disabled. Points to the storage of the traverser at the root of the job.
+  std::atomic_int *branch_budget_;
+  std::atomic_int branch_budget_storage_;
+
+  bool serve_viewer_cache_;
+
 };
 
 }
@@ -150,45 +150,50 @@ QVector<QVariant> NodeValue::split_normal_value_into_track_values(Type type, con
 
 QVariant NodeValue::combine_track_values_into_normal_value(Type type, const QVector<QVariant> &split)
 {
-  if (split.isEmpty()) {
+  return combine_track_values_into_normal_value(type, split.constData(), split.size());
+}
+
+QVariant NodeValue::combine_track_values_into_normal_value(Type type, const QVariant *split, int count)
+{
+  if (!count) {
     return QVariant();
   }
 
   switch (type) {
   case kVec2:
   {
-    return QVector2D(split.at(0).toFloat(),
-                     split.at(1).toFloat());
+    return QVector2D(split[0].toFloat(),
+                     split[1].toFloat());
   }
   case kVec3:
   {
-    return QVector3D(split.at(0).toFloat(),
-                     split.at(1).toFloat(),
-                     split.at(2).toFloat());
+    return QVector3D(split[0].toFloat(),
+                     split[1].toFloat(),
+                     split[2].toFloat());
   }
   case kVec4:
   {
-    return QVector4D(split.at(0).toFloat(),
-                     split.at(1).toFloat(),
-                     split.at(2).toFloat(),
-                     split.at(3).toFloat());
+    return QVector4D(split[0].toFloat(),
+                     split[1].toFloat(),
+                     split[2].toFloat(),
+                     split[3].toFloat());
   }
   case kColor:
   {
-    return QVariant::fromValue(Color(split.at(0).toFloat(),
-                                     split.at(1).toFloat(),
-                                     split.at(2).toFloat(),
-                                     split.at(3).toFloat()));
+    return QVariant::fromValue(Color(split[0].toFloat(),
+                                     split[1].toFloat(),
+                                     split[2].toFloat(),
+                                     split[3].toFloat()));
   }
   case kBezier:
-    return QVariant::fromValue(Bezier(split.at(0).toDouble(),
-                                      split.at(1).toDouble(),
-                                      split.at(2).toDouble(),
-                                      split.at(3).toDouble(),
-                                      split.at(4).toDouble(),
-                                      split.at(5).toDouble()));
+    return QVariant::fromValue(Bezier(split[0].toDouble(),
+                                      split[1].toDouble(),
+                                      split[2].toDouble(),
+                                      split[3].toDouble(),
+                                      split[4].toDouble(),
+                                      split[5].toDouble()));
   default:
-    return split.first();
+    return split[0];
   }
 }
 
@@ -423,10 +428,10 @@ void NodeValueTable::Remove(const NodeValue &v)
   }
 }
 
-NodeValueTable NodeValueTable::Merge(QList<NodeValueTable> tables)
+NodeValueTable NodeValueTable::Merge(const QVector<const NodeValueTable*> &tables)
 {
   if (tables.size() == 1) {
-    return tables.first();
+    return *tables.first();
   }
 
   int row = 0;
@@ -437,16 +442,16 @@ NodeValueTable NodeValueTable::Merge(QList<NodeValueTable> tables)
   while (true) {
     bool all_merged = true;
 
-    foreach (const NodeValueTable& t, tables) {
-      if (row < t.Count()) {
+    foreach (const NodeValueTable *t, tables) {
+      if (row < t->Count()) {
         all_merged = false;
       } else {
         continue;
       }
 
-      int row_index = t.Count() - 1 - row;
+      int row_index = t->Count() - 1 - row;
 
-      merged_table.Prepend(t.at(row_index));
+      merged_table.Prepend(t->at(row_index));
     }
 
     row++;
@@ -25,6 +25,9 @@
 #include <QString>
 #include <QVariant>
 #include <QVector>
+#include <QVector2D>
+#include <QVector3D>
+#include <QVector4D>
 
 #include "common/qtutils.h"
 #include "node/splitvalue.h"
@@ -201,7 +204,8 @@ public:
   NodeValue() :
     type_(kNone),
     from_(nullptr),
-    array_(false)
+    array_(false),
+    mode_(kStorageVariant)
   {
   }
 
@@ -213,6 +217,7 @@ public:
     array_(array)
   {
     set_value(data);
+    CollapseVariant();
   }
 
   template <typename T>
@@ -229,21 +234,52 @@ public:
   template <typename T>
   T value() const
   {
-    return data_.value<T>();
+    return data().value<T>();
   }
 
   template <typename T>
   void set_value(const T &v)
   {
+    mode_ = kStorageVariant;
     data_ = QVariant::fromValue(v);
   }
 
-  const QVariant &data() const { return data_; }
+  /**
+   * @brief Retrieve this value as a QVariant
+   *
+   * The common small types are stored inline rather than type-erased, so this may have to
+   * construct a QVariant on demand. Prefer the typed accessors in performance-sensitive code.
+   */
+  QVariant data() const
+  {
+    switch (mode_) {
+    case kStorageFloat:
+      return QVariant(small_.f);
+    case kStorageInt:
+      return QVariant::fromValue(small_.i);
+    case kStorageBool:
+      return QVariant(small_.b);
+    case kStorageRational:
+      return QVariant::fromValue(rational(small_.r.num, small_.r.den));
+    case kStorageVec2:
+      return QVariant::fromValue(QVector2D(small_.vec[0], small_.vec[1]));
+    case kStorageVec3:
+      return QVariant::fromValue(QVector3D(small_.vec[0], small_.vec[1], small_.vec[2]));
+    case kStorageVec4:
+      return QVariant::fromValue(QVector4D(small_.vec[0], small_.vec[1], small_.vec[2], small_.vec[3]));
+    case kStorageColor:
+      return QVariant::fromValue(Color(small_.color[0], small_.color[1], small_.color[2], small_.color[3]));
+    case kStorageVariant:
+      break;
+    }
+
+    return data_;
+  }
 
   template <typename T>
   bool canConvert() const
   {
-    return data_.canConvert<T>();
+    return data().canConvert<T>();
   }
 
   const QString& tag() const
@@ -268,12 +304,45 @@ public:
 
   bool operator==(const NodeValue& rhs) const
   {
-    return type_ == rhs.type_ && tag_ == rhs.tag_ && data_ == rhs.data_;
+    if (type_ != rhs.type_ || tag_ != rhs.tag_) {
+      return false;
+    }
+
+    if (mode_ != rhs.mode_) {
+      // Differing representations of the same value still compare equal
+      return data() == rhs.data();
+    }
+
+    switch (mode_) {
+    case kStorageFloat:
+      return small_.f == rhs.small_.f;
+    case kStorageInt:
+      return small_.i == rhs.small_.i;
+    case kStorageBool:
+      return small_.b == rhs.small_.b;
+    case kStorageRational:
+      return small_.r.num == rhs.small_.r.num && small_.r.den == rhs.small_.r.den;
+    case kStorageVec2:
+      return small_.vec[0] == rhs.small_.vec[0] && small_.vec[1] == rhs.small_.vec[1];
+    case kStorageVec3:
+      return small_.vec[0] == rhs.small_.vec[0] && small_.vec[1] == rhs.small_.vec[1]
+          && small_.vec[2] == rhs.small_.vec[2];
+    case kStorageVec4:
+      return small_.vec[0] == rhs.small_.vec[0] && small_.vec[1] == rhs.small_.vec[1]
+          && small_.vec[2] == rhs.small_.vec[2] && small_.vec[3] == rhs.small_.vec[3];
+    case kStorageColor:
+      return small_.color[0] == rhs.small_.color[0] && small_.color[1] == rhs.small_.color[1]
+          && small_.color[2] == rhs.small_.color[2] && small_.color[3] == rhs.small_.color[3];
+    case kStorageVariant:
+      break;
+    }
+
+    return data_ == rhs.data_;
   }
 
   operator bool() const
   {
-    return !data_.isNull();
+    return mode_ != kStorageVariant || !data_.isNull();
   }
 
   static QString GetPrettyDataTypeName(Type type);
@@ -284,7 +353,7 @@ public:
   static QString ValueToString(Type data_type, const QVariant& value, bool value_is_a_key_track);
   static QString ValueToString(const NodeValue &v, bool value_is_a_key_track)
   {
-    return ValueToString(v.type_, v.data_, value_is_a_key_track);
+    return ValueToString(v.type_, v.data(), value_is_a_key_track);
   }
 
   static QVariant StringToValue(Type data_type, const QString &string, bool value_is_a_key_track);
@@ -293,9 +362,14 @@ public:
 
   static QVariant combine_track_values_into_normal_value(Type type, const QVector<QVariant>& split);
 
+  /**
+   * @brief Overload for recombining channels from any contiguous storage without building a QVector
+   */
+  static QVariant combine_track_values_into_normal_value(Type type, const QVariant *split, int count);
+
   SplitValue to_split_value() const
   {
-    return split_normal_value_into_track_values(type_, data_);
+    return split_normal_value_into_track_values(type_, data());
   }
 
   /**
@@ -354,14 +428,346 @@ public:
   NodeValueArray toArray() const { return value<NodeValueArray>(); }
 
 private:
+  /**
+   * @brief Identifies which representation currently holds the value
+   *
+   * The small types that dominate graph evaluation (numbers, vectors, colors) are stored inline
+   * in `small_` to avoid heap-allocating a QVariant for every parameter of every node evaluated.
+   * Everything else is type-erased into `data_` as before.
+   */
+  enum StorageMode {
+    kStorageVariant,
+    kStorageFloat,
+    kStorageInt,
+    kStorageBool,
+    kStorageRational,
+    kStorageVec2,
+    kStorageVec3,
+    kStorageVec4,
+    kStorageColor
+  };
+
+  union SmallData {
+    double f;
+    int64_t i;
+    bool b;
+    struct { int64_t num; int64_t den; } r;
+    float vec[4];
+    double color[4];
+  };
+
+  /**
+   * @brief Unwrap a QVariant that holds one of the inline-storable types
+   *
+   * Values pulled from the keyframe system arrive as QVariants even when their data type is a
+   * simple number. Unwrapping them once at construction lets repeated reads (e.g. per-sample
+   * parameter lookups in audio processing) skip the metatype dispatch.
+   */
+  void CollapseVariant()
+  {
+    if (mode_ != kStorageVariant) {
+      return;
+    }
+
+    const int vt = data_.userType();
+
+    switch (type_) {
+    case kFloat:
+      if (vt == QMetaType::Double) {
+        mode_ = kStorageFloat;
+        small_.f = data_.toDouble();
+        break;
+      }
+      return;
+    case kInt:
+    case kCombo:
+      if (vt == QMetaType::LongLong || vt == QMetaType::Int) {
+        mode_ = kStorageInt;
+        small_.i = data_.toLongLong();
+        break;
+      }
+      return;
+    case kBoolean:
+      if (vt == QMetaType::Bool) {
+        mode_ = kStorageBool;
+        small_.b = data_.toBool();
+        break;
+      }
+      return;
+    case kRational:
+      if (vt == qMetaTypeId<rational>()) {
+        rational r = data_.value<rational>();
+        mode_ = kStorageRational;
+        small_.r.num = r.numerator();
+        small_.r.den = r.denominator();
+        break;
+      }
+      return;
+    case kVec2:
+      if (vt == QMetaType::QVector2D) {
+        QVector2D v = data_.value<QVector2D>();
+        mode_ = kStorageVec2;
+        small_.vec[0] = v.x();
+        small_.vec[1] = v.y();
+        break;
+      }
+      return;
+    case kVec3:
+      if (vt == QMetaType::QVector3D) {
+        QVector3D v = data_.value<QVector3D>();
+        mode_ = kStorageVec3;
+        small_.vec[0] = v.x();
+        small_.vec[1] = v.y();
+        small_.vec[2] = v.z();
+        break;
+      }
+      return;
+    case kVec4:
+      if (vt == QMetaType::QVector4D) {
+        QVector4D v = data_.value<QVector4D>();
+        mode_ = kStorageVec4;
+        small_.vec[0] = v.x();
+        small_.vec[1] = v.y();
+        small_.vec[2] = v.z();
+        small_.vec[3] = v.w();
+        break;
+      }
+      return;
+    case kColor:
+      if (vt == qMetaTypeId<Color>()) {
+        Color c = data_.value<Color>();
+        mode_ = kStorageColor;
+        small_.color[0] = c.red();
+        small_.color[1] = c.green();
+        small_.color[2] = c.blue();
+        small_.color[3] = c.alpha();
+        break;
+      }
+      return;
+    default:
+      return;
+    }
+
+    data_.clear();
+  }
+
   Type type_;
   QVariant data_;
   const Node* from_;
   QString tag_;
   bool array_;
+  StorageMode mode_;
+  SmallData small_;
 
 };
 
+// Inline storage specializations for the types that dominate NodeTraverser profiles. Reads that
+// don't match the stored representation fall through to QVariant's conversion rules via data().
+
+template <>
+inline void NodeValue::set_value(const double &v)
+{
+  mode_ = kStorageFloat;
+  small_.f = v;
+  data_.clear();
+}
+
+template <>
+inline void NodeValue::set_value(const float &v)
+{
+  mode_ = kStorageFloat;
+  small_.f = v;
+  data_.clear();
+}
+
+template <>
+inline void NodeValue::set_value(const int64_t &v)
+{
+  mode_ = kStorageInt;
+  small_.i = v;
+  data_.clear();
+}
+
+template <>
+inline void NodeValue::set_value(const int &v)
+{
+  mode_ = kStorageInt;
+  small_.i = v;
+  data_.clear();
+}
+
+template <>
+inline void NodeValue::set_value(const bool &v)
+{
+  mode_ = kStorageBool;
+  small_.b = v;
+  data_.clear();
+}
+
+template <>
+inline void NodeValue::set_value(const rational &v)
+{
+  mode_ = kStorageRational;
+  small_.r.num = v.numerator();
+  small_.r.den = v.denominator();
+  data_.clear();
+}
+
+template <>
+inline void NodeValue::set_value(const QVector2D &v)
+{
+  mode_ = kStorageVec2;
+  small_.vec[0] = v.x();
+  small_.vec[1] = v.y();
+  data_.clear();
+}
+
+template <>
+inline void NodeValue::set_value(const QVector3D &v)
+{
+  mode_ = kStorageVec3;
+  small_.vec[0] = v.x();
+  small_.vec[1] = v.y();
+  small_.vec[2] = v.z();
+  data_.clear();
+}
+
+template <>
+inline void NodeValue::set_value(const QVector4D &v)
+{
+  mode_ = kStorageVec4;
+  small_.vec[0] = v.x();
+  small_.vec[1] = v.y();
+  small_.vec[2] = v.z();
+  small_.vec[3] = v.w();
+  data_.clear();
+}
+
+template <>
+inline void NodeValue::set_value(const Color &v)
+{
+  mode_ = kStorageColor;
+  small_.color[0] = v.red();
+  small_.color[1] = v.green();
+  small_.color[2] = v.blue();
+  small_.color[3] = v.alpha();
+  data_.clear();
+}
+
+template <>
+inline double NodeValue::value<double>() const
+{
+  switch (mode_) {
+  case kStorageFloat:
+    return small_.f;
+  case kStorageInt:
+    return double(small_.i);
+  case kStorageBool:
+    return small_.b;
+  default:
+    return data().value<double>();
+  }
+}
+
+template <>
+inline float NodeValue::value<float>() const
+{
+  if (mode_ == kStorageFloat) {
+    return float(small_.f);
+  }
+  return data().value<float>();
+}
+
+template <>
+inline int64_t NodeValue::value<int64_t>() const
+{
+  switch (mode_) {
+  case kStorageInt:
+    return small_.i;
+  case kStorageFloat:
+    return qRound64(small_.f);
+  case kStorageBool:
+    return small_.b;
+  default:
+    return data().value<int64_t>();
+  }
+}
+
+template <>
+inline int NodeValue::value<int>() const
+{
+  switch (mode_) {
+  case kStorageInt:
+    return int(small_.i);
+  case kStorageFloat:
+    return qRound(small_.f);
+  case kStorageBool:
+    return small_.b;
+  default:
+    return data().value<int>();
+  }
+}
+
+template <>
+inline bool NodeValue::value<bool>() const
+{
+  switch (mode_) {
+  case kStorageBool:
+    return small_.b;
+  case kStorageInt:
+    return small_.i != 0;
+  case kStorageFloat:
+    return small_.f != 0.0;
+  default:
+    return data().value<bool>();
+  }
+}
+
+template <>
+inline rational NodeValue::value<rational>() const
+{
+  if (mode_ == kStorageRational) {
+    return rational(small_.r.num, small_.r.den);
+  }
+  return data().value<rational>();
+}
+
+template <>
+inline QVector2D NodeValue::value<QVector2D>() const
+{
+  if (mode_ == kStorageVec2) {
+    return QVector2D(small_.vec[0], small_.vec[1]);
+  }
+  return data().value<QVector2D>();
+}
+
+template <>
+inline QVector3D NodeValue::value<QVector3D>() const
+{
+  if (mode_ == kStorageVec3) {
+    return QVector3D(small_.vec[0], small_.vec[1], small_.vec[2]);
+  }
+  return data().value<QVector3D>();
+}
+
+template <>
+inline QVector4D NodeValue::value<QVector4D>() const
+{
+  if (mode_ == kStorageVec4) {
+    return QVector4D(small_.vec[0], small_.vec[1], small_.vec[2], small_.vec[3]);
+  }
+  return data().value<QVector4D>();
+}
+
+template <>
+inline Color NodeValue::value<Color>() const
+{
+  if (mode_ == kStorageColor) {
+    return Color(small_.color[0], small_.color[1], small_.color[2], small_.color[3]);
+  }
+  return data().value<Color>();
+}
+
 class NodeValueTable
 {
 public:
@@ -388,6 +794,11 @@ public:
     values_.append(value);
   }
 
+  void Push(NodeValue&& value)
+  {
+    values_.append(std::move(value));
+  }
+
   void Push(const NodeValueTable& value)
   {
     values_.append(value.values_);
@@ -410,6 +821,11 @@ public:
     values_.prepend(value);
   }
 
+  void Prepend(NodeValue&& value)
+  {
+    values_.prepend(std::move(value));
+  }
+
   template <typename T>
   void Prepend(NodeValue::Type type, const T& data, const Node *from, bool array = false, const QString& tag = QString())
   {
@@ -451,7 +867,7 @@ public:
 
   int GetValueIndex(const QVector<NodeValue::Type> &type, const QString& tag) const;
 
-  static NodeValueTable Merge(QList<NodeValueTable> tables);
+  static NodeValueTable Merge(const QVector<const NodeValueTable*> &tables);
 
 private:
   QVector<NodeValue> values_;
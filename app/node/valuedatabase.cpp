@@ -24,12 +24,18 @@ namespace olive {
 
 NodeValueTable NodeValueDatabase::Merge() const
 {
-  QHash<QString, NodeValueTable> copy = tables_;
-
-  // Kinda hacky, but we don't need this table to slipstream
-  copy.remove(QStringLiteral("global"));
-
-  return NodeValueTable::Merge(copy.values());
+  // Collect pointers to the tables to slipstream rather than copying them all - this runs for
+  // every node on every frame. The "global" table doesn't participate.
+  QVector<const NodeValueTable*> tables;
+  tables.reserve(tables_.size());
+
+  for (auto it=tables_.cbegin(); it!=tables_.cend(); it++) {
+    if (it.key() != QStringLiteral("global")) {
+      tables.append(&it.value());
+    }
+  }
+
+  return NodeValueTable::Merge(tables);
 }
 
 }
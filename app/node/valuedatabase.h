@@ -41,6 +41,11 @@ public:
     tables_.insert(key, value);
   }
 
+  void Insert(const QString& key, NodeValueTable &&value)
+  {
+    tables_[key] = std::move(value);
+  }
+
   NodeValueTable Take(const QString &key)
   {
     return tables_.take(key);
@@ -0,0 +1,174 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "valuememocache.h"
+
+#include "node.h"
+#include "traversalplancache.h"
+
+namespace olive {
+
+NodeValueMemoCache *NodeValueMemoCache::instance_ = nullptr;
+
+NodeValueMemoCache::NodeValueMemoCache(QObject *parent) :
+  QObject(parent)
+{
+}
+
+NodeValueMemoCache *NodeValueMemoCache::instance()
+{
+  static QMutex instance_mutex;
+  QMutexLocker locker(&instance_mutex);
+
+  if (!instance_) {
+    instance_ = new NodeValueMemoCache();
+  }
+
+  return instance_;
+}
+
+bool NodeValueMemoCache::IsStatic(const Node *node)
+{
+  QMutexLocker locker(&mutex_);
+
+  return IsStaticInternal(node);
+}
+
+bool NodeValueMemoCache::IsStaticInternal(const Node *node)
+{
+  auto it = static_.find(node);
+  if (it != static_.end()) {
+    return it.value();
+  }
+
+  // Insert false up front so cyclic graphs terminate (and resolve to non-static)
+  static_.insert(node, false);
+  Watch(node);
+
+  bool is_static = node->GetFlags() & Node::kTimeAgnostic;
+
+  if (is_static) {
+    NodeTraversalPlanCache::Plan plan = NodeTraversalPlanCache::instance()->GetPlan(node);
+
+    for (const NodeTraversalPlanCache::PlannedInput &input : qAsConst(plan)) {
+      if (input.array) {
+        // Array inputs have per-element connections and keyframes that the plan doesn't
+        // enumerate, so treat them conservatively
+        is_static = false;
+      } else if (input.connected) {
+        is_static = IsStaticInternal(input.output);
+      } else if (NodeInputImmediate *imm = node->GetImmediate(input.input, -1)) {
+        if (imm->is_keyframing()) {
+          foreach (const NodeKeyframeTrack &track, imm->keyframe_tracks()) {
+            if (!track.isEmpty()) {
+              is_static = false;
+              break;
+            }
+          }
+        }
+      }
+
+      if (!is_static) {
+        break;
+      }
+    }
+  }
+
+  static_.insert(node, is_static);
+
+  return is_static;
+}
+
+bool NodeValueMemoCache::Get(const Node *node, const VideoParams &vparams, const AudioParams &aparams, RenderMode::Mode mode, NodeValueTable *table)
+{
+  QMutexLocker locker(&mutex_);
+
+  auto it = memo_.find(node);
+  if (it == memo_.end()) {
+    return false;
+  }
+
+  if (it.value().vparams != vparams || it.value().aparams != aparams || it.value().mode != mode) {
+    return false;
+  }
+
+  *table = it.value().table;
+  return true;
+}
+
+void NodeValueMemoCache::Insert(const Node *node, const VideoParams &vparams, const AudioParams &aparams, RenderMode::Mode mode, const NodeValueTable &table)
+{
+  QMutexLocker locker(&mutex_);
+
+  Entry e;
+  e.vparams = vparams;
+  e.aparams = aparams;
+  e.mode = mode;
+  e.table = table;
+
+  memo_.insert(node, e);
+  Watch(node);
+}
+
+void NodeValueMemoCache::Watch(const Node *node)
+{
+  if (watched_.contains(node)) {
+    return;
+  }
+
+  watched_.insert(node);
+
+  // Direct connections so invalidation happens synchronously with the edit,
+  // not whenever this object's thread spins its event loop
+  connect(node, &Node::ValueChanged, this, &NodeValueMemoCache::NodeChanged, Qt::DirectConnection);
+  connect(node, &Node::InputConnected, this, &NodeValueMemoCache::NodeChanged, Qt::DirectConnection);
+  connect(node, &Node::InputDisconnected, this, &NodeValueMemoCache::NodeChanged, Qt::DirectConnection);
+  connect(node, &Node::InputAdded, this, &NodeValueMemoCache::NodeChanged, Qt::DirectConnection);
+  connect(node, &Node::InputRemoved, this, &NodeValueMemoCache::NodeChanged, Qt::DirectConnection);
+  connect(node, &Node::InputArraySizeChanged, this, &NodeValueMemoCache::NodeChanged, Qt::DirectConnection);
+  connect(node, &Node::KeyframeEnableChanged, this, &NodeValueMemoCache::NodeChanged, Qt::DirectConnection);
+  connect(node, &Node::InputValueHintChanged, this, &NodeValueMemoCache::NodeChanged, Qt::DirectConnection);
+  connect(node, &QObject::destroyed, this, &NodeValueMemoCache::NodeDestroyed, Qt::DirectConnection);
+}
+
+void NodeValueMemoCache::Clear()
+{
+  memo_.clear();
+  static_.clear();
+}
+
+void NodeValueMemoCache::NodeChanged()
+{
+  QMutexLocker locker(&mutex_);
+
+  // Dependencies are transitive, so any change invalidates downstream memos we can't cheaply
+  // enumerate - just drop everything, edits are rare next to frames
+  Clear();
+}
+
+void NodeValueMemoCache::NodeDestroyed(QObject *obj)
+{
+  QMutexLocker locker(&mutex_);
+
+  watched_.remove(reinterpret_cast<const Node*>(obj));
+  Clear();
+}
+
+}
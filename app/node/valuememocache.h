@@ -0,0 +1,113 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef NODEVALUEMEMOCACHE_H
+#define NODEVALUEMEMOCACHE_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+
+#include "node/value.h"
+#include "render/rendermodes.h"
+#include "render/videoparams.h"
+
+namespace olive {
+
+class Node;
+
+/**
+ * @brief Memoizes the output of static node branches across frames
+ *
+ * Branches of the graph whose nodes are all time-agnostic and whose inputs
+ * have no keyframes produce an identical table for every frame, yet
+ * NodeTraverser re-evaluated them from scratch each time. This cache replays
+ * the table generated on the first frame for subsequent tickets - titles,
+ * LUT chains and constant generators on mostly-static sequences become a
+ * single hash lookup per frame.
+ *
+ * A branch qualifies when every node in it carries Node::kTimeAgnostic and
+ * no input anywhere in it is keyframed. Memoized tables still contain
+ * unresolved jobs, so GPU work is unaffected - only the CPU graph traversal
+ * is skipped. Any edit to a watched node drops the whole cache, since
+ * dependencies are transitive and edits are rare next to frames.
+ *
+ * Thread-safe; tables are returned by value (implicitly shared).
+ */
+class NodeValueMemoCache : public QObject
+{
+  Q_OBJECT
+public:
+  static NodeValueMemoCache *instance();
+
+  /**
+   * @brief Return whether this node's entire upstream is static
+   */
+  bool IsStatic(const Node *node);
+
+  /**
+   * @brief Retrieve the memoized table for a node, if any
+   *
+   * Entries are only valid for the cache parameters and render mode they were generated
+   * with, since generated jobs bake in the resolution and nodes may push cheaper preview
+   * jobs when rendering offline.
+   */
+  bool Get(const Node *node, const VideoParams &vparams, const AudioParams &aparams, RenderMode::Mode mode, NodeValueTable *table);
+
+  void Insert(const Node *node, const VideoParams &vparams, const AudioParams &aparams, RenderMode::Mode mode, const NodeValueTable &table);
+
+private:
+  explicit NodeValueMemoCache(QObject *parent = nullptr);
+
+  bool IsStaticInternal(const Node *node);
+
+  void Watch(const Node *node);
+
+  void Clear();
+
+  static NodeValueMemoCache *instance_;
+
+  struct Entry {
+    VideoParams vparams;
+    AudioParams aparams;
+    RenderMode::Mode mode;
+    NodeValueTable table;
+  };
+
+  QMutex mutex_;
+
+  QHash<const Node*, Entry> memo_;
+
+  QHash<const Node*, bool> static_;
+
+  // Nodes whose change signals we are already watching
+  QSet<const Node*> watched_;
+
+private slots:
+  void NodeChanged();
+
+  void NodeDestroyed(QObject *obj);
+
+};
+
+}
+
+#endif // NODEVALUEMEMOCACHE_H
@@ -20,18 +20,38 @@
 
 #include "audiomonitor.h"
 
+#include <QVBoxLayout>
+
+#include "audio/audiomanager.h"
 #include "panel/panelmanager.h"
 
 namespace olive {
 
 #define super PanelWidget
 
+// The readout only needs to keep up with a human reading it, not the audio
+const int kLoudnessRefreshIntervalMs = 250;
+
 AudioMonitorPanel::AudioMonitorPanel() :
   super(QStringLiteral("AudioMonitor"))
 {
-  audio_monitor_ = new AudioMonitor(this);
+  QWidget *container = new QWidget(this);
+  QVBoxLayout *layout = new QVBoxLayout(container);
+  layout->setContentsMargins(0, 0, 0, 0);
+
+  audio_monitor_ = new AudioMonitor();
+  layout->addWidget(audio_monitor_);
+
+  loudness_label_ = new QLabel();
+  loudness_label_->setAlignment(Qt::AlignCenter);
+  layout->addWidget(loudness_label_);
 
-  SetWidgetWithPadding(audio_monitor_);
+  SetWidgetWithPadding(container);
+
+  loudness_update_timer_ = new QTimer(this);
+  loudness_update_timer_->setInterval(kLoudnessRefreshIntervalMs);
+  connect(loudness_update_timer_, &QTimer::timeout, this, &AudioMonitorPanel::UpdateLoudnessReadout);
+  loudness_update_timer_->start();
 
   Retranslate();
 }
@@ -39,6 +59,28 @@ AudioMonitorPanel::AudioMonitorPanel() :
 void AudioMonitorPanel::Retranslate()
 {
   SetTitle(tr("Audio Monitor"));
+
+  loudness_label_->setToolTip(tr("Momentary and integrated loudness (EBU R128). Integrated "
+                                 "loudness restarts with each playback."));
+
+  UpdateLoudnessReadout();
+}
+
+QString AudioMonitorPanel::FormatLoudness(double lufs)
+{
+  if (qIsInf(lufs)) {
+    return QStringLiteral("-∞");
+  }
+
+  return QString::number(lufs, 'f', 1);
+}
+
+void AudioMonitorPanel::UpdateLoudnessReadout()
+{
+  LoudnessAnalyzer *meter = AudioManager::instance()->loudness_meter();
+
+  loudness_label_->setText(tr("M %1  I %2 LUFS").arg(FormatLoudness(meter->GetMomentaryLoudness()),
+                                                     FormatLoudness(meter->GetIntegratedLoudness())));
 }
 
 }
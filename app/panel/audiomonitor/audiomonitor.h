@@ -21,6 +21,9 @@
 #ifndef AUDIOMONITORPANEL_H
 #define AUDIOMONITORPANEL_H
 
+#include <QLabel>
+#include <QTimer>
+
 #include "panel/panel.h"
 #include "widget/audiomonitor/audiomonitor.h"
 
@@ -28,6 +31,8 @@ namespace olive {
 
 /**
  * @brief PanelWidget wrapper around an AudioMonitor
+ *
+ * Also shows a loudness readout fed by the meter in AudioManager.
  */
 class AudioMonitorPanel : public PanelWidget
 {
@@ -48,8 +53,17 @@ public:
 private:
   virtual void Retranslate() override;
 
+  static QString FormatLoudness(double lufs);
+
   AudioMonitor* audio_monitor_;
 
+  QLabel* loudness_label_;
+
+  QTimer* loudness_update_timer_;
+
+private slots:
+  void UpdateLoudnessReadout();
+
 };
 
 }
@@ -0,0 +1,39 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "memory.h"
+
+namespace olive {
+
+MemoryPanel::MemoryPanel() :
+  PanelWidget(QStringLiteral("MemoryPanel"))
+{
+  monitor_widget_ = new MemoryMonitorWidget(this);
+  SetWidgetWithPadding(monitor_widget_);
+
+  Retranslate();
+}
+
+void MemoryPanel::Retranslate()
+{
+  SetTitle(tr("Memory"));
+}
+
+}
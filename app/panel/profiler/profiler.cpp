@@ -0,0 +1,45 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "profiler.h"
+
+#include "render/nodeprofiler.h"
+
+namespace olive {
+
+ProfilerPanel::ProfilerPanel() :
+  PanelWidget(QStringLiteral("ProfilerPanel"))
+{
+  profiler_widget_ = new NodeProfilerWidget(this);
+  SetWidgetWithPadding(profiler_widget_);
+
+  // Only collect while someone is actually looking at the numbers
+  connect(this, &ProfilerPanel::shown, this, []{NodeProfiler::instance()->SetEnabled(true);});
+  connect(this, &ProfilerPanel::hidden, this, []{NodeProfiler::instance()->SetEnabled(false);});
+
+  Retranslate();
+}
+
+void ProfilerPanel::Retranslate()
+{
+  SetTitle(tr("Render Profiler"));
+}
+
+}
@@ -0,0 +1,44 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef PROFILERPANEL_H
+#define PROFILERPANEL_H
+
+#include "panel/panel.h"
+#include "widget/nodeprofiler/nodeprofilerwidget.h"
+
+namespace olive {
+
+class ProfilerPanel : public PanelWidget
+{
+  Q_OBJECT
+public:
+  ProfilerPanel();
+
+private:
+  virtual void Retranslate() override;
+
+  NodeProfilerWidget *profiler_widget_;
+
+};
+
+}
+
+#endif // PROFILERPANEL_H
@@ -20,26 +20,52 @@
 
 #include "audiowaveformcache.h"
 
+#include <QDateTime>
+
+#include "common/filefunctions.h"
+#include "render/diskmanager.h"
+
 namespace olive {
 
 #define super PlaybackCache
 
+// The waveform file is rewritten in full, which for a long project is many megabytes, so saves
+// are throttled rather than triggered by every validated range. The destructor writes whatever
+// is still pending, so at worst a crash loses this much summarization.
+const qint64 kWaveformSaveIntervalMs = 10000;
+
 AudioWaveformCache::AudioWaveformCache(QObject *parent) :
-  super{parent}
+  super{parent},
+  waveform_dirty_(false),
+  last_waveform_save_(0)
 {
   waveforms_ = std::make_shared<AudioVisualWaveform>();
 }
 
+AudioWaveformCache::~AudioWaveformCache()
+{
+  if (waveform_dirty_ && IsSavingEnabled() && DiskManager::instance()) {
+    SaveWaveformFile();
+  }
+}
+
 void AudioWaveformCache::WriteWaveform(const TimeRange &range, const TimeRangeList &valid_ranges, const AudioVisualWaveform *waveform)
 {
   // Write each valid range to the segments
   foreach (const TimeRange& r, valid_ranges) {
     if (waveform) {
       waveforms_->OverwriteSums(*waveform, r.in(), r.in() - range.in(), r.length());
+      waveform_dirty_ = true;
     }
 
     Validate(r);
   }
+
+  if (waveform_dirty_ && IsSavingEnabled()) {
+    if (QDateTime::currentMSecsSinceEpoch() - last_waveform_save_ >= kWaveformSaveIntervalMs) {
+      SaveWaveformFile();
+    }
+  }
 }
 
 void DrawSubRect(QPainter *painter, const QRect &rect, const double &scale, const TimeRange &wave_range, const AudioVisualWaveform &waveform, const TimeRange &subrange)
@@ -112,4 +138,54 @@ void AudioWaveformCache::InvalidateEvent(const TimeRange& range)
   super::InvalidateEvent(range);
 }
 
+void AudioWaveformCache::ShiftEvent(const rational &from, const rational &to)
+{
+  if (waveforms_->length() > qMin(from, to)) {
+    // Mid() takes a copy, so reading the tail before overwriting in place is safe even though
+    // source and destination overlap
+    AudioVisualWaveform tail = waveforms_->Mid(from);
+    waveforms_->OverwriteSums(tail, to);
+
+    if (to > from) {
+      // Content moved later, silence the gap it left behind
+      waveforms_->OverwriteSilence(from, to - from);
+    } else {
+      // Content moved earlier, drop the now-dangling end
+      waveforms_->Resize(to + tail.length());
+    }
+
+    waveform_dirty_ = true;
+  }
+
+  ShiftRangeVector(&passthroughs_, from, to);
+}
+
+void AudioWaveformCache::LoadStateEvent(QDataStream &stream)
+{
+  Q_UNUSED(stream)
+
+  if (!waveforms_->Load(GetWaveformFilename())) {
+    // Without the summaries, any ranges the state claims are valid would draw blank forever, so
+    // make everything recompute once the state finishes loading
+    QMetaObject::invokeMethod(this, "InvalidateAll", Qt::QueuedConnection);
+  }
+}
+
+QString AudioWaveformCache::GetWaveformFilename() const
+{
+  return GetThisCacheDirectory().filePath(QStringLiteral("waveform"));
+}
+
+void AudioWaveformCache::SaveWaveformFile()
+{
+  QDir cache_dir = GetThisCacheDirectory();
+
+  if (FileFunctions::DirectoryIsValid(cache_dir)) {
+    if (waveforms_->Save(GetWaveformFilename())) {
+      waveform_dirty_ = false;
+      last_waveform_save_ = QDateTime::currentMSecsSinceEpoch();
+    }
+  }
+}
+
 }
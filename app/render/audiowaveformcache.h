@@ -32,6 +32,8 @@ class AudioWaveformCache : public PlaybackCache
 public:
   AudioWaveformCache(QObject *parent = nullptr);
 
+  virtual ~AudioWaveformCache() override;
+
   void WriteWaveform(const TimeRange &range, const TimeRangeList &valid_ranges, const AudioVisualWaveform *waveform);
 
   const AudioParams &GetParameters() const { return params_; }
@@ -52,13 +54,28 @@ public:
 protected:
   virtual void InvalidateEvent(const TimeRange& range) override;
 
+  virtual void ShiftEvent(const rational &from, const rational &to) override;
+
+  virtual void LoadStateEvent(QDataStream &stream) override;
+
 private:
   using WaveformPtr = std::shared_ptr<AudioVisualWaveform>;
 
+  QString GetWaveformFilename() const;
+
+  /**
+   * @brief Write the summarized mipmaps to a binary file in this cache's directory
+   */
+  void SaveWaveformFile();
+
   WaveformPtr waveforms_;
 
   AudioParams params_;
 
+  bool waveform_dirty_;
+
+  qint64 last_waveform_save_;
+
   class WaveformPassthrough : public TimeRange
   {
   public:
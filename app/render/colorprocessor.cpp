@@ -20,6 +20,10 @@
 
 #include "colorprocessor.h"
 
+#include <numeric>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+
 #include "common/define.h"
 #include "common/ocioutils.h"
 #include "node/color/colormanager/colormanager.h"
@@ -95,16 +99,65 @@ void ColorProcessor::ConvertFrame(Frame *f)
     return;
   }
 
-  OCIO::PackedImageDesc img(f->data(),
-                            f->width(),
-                            f->height(),
-                            f->channel_count(),
-                            ocio_bit_depth,
-                            OCIO::AutoStride,
-                            OCIO::AutoStride,
-                            f->linesize_bytes());
+  OCIO::ConstCPUProcessorRcPtr processor = GetCPUProcessorForDepth(ocio_bit_depth);
+
+  // Full frames (scope sources, thumbnail stills) are worth fanning out across threads.
+  // Small frames aren't - the band setup would cost more than the conversion.
+  static const int kMinRowsPerBand = 64;
+  int band_count = qMin(QThread::idealThreadCount(), f->height() / kMinRowsPerBand);
+
+  if (band_count > 1) {
+    QVector<int> bands(band_count);
+    std::iota(bands.begin(), bands.end(), 0);
+
+    int rows_per_band = (f->height() + band_count - 1) / band_count;
+
+    QtConcurrent::blockingMap(bands, [f, &processor, ocio_bit_depth, rows_per_band](int band){
+      int start_row = band * rows_per_band;
+      int band_height = qMin(rows_per_band, f->height() - start_row);
+
+      OCIO::PackedImageDesc img(f->data() + qint64(start_row) * f->linesize_bytes(),
+                                f->width(),
+                                band_height,
+                                f->channel_count(),
+                                ocio_bit_depth,
+                                OCIO::AutoStride,
+                                OCIO::AutoStride,
+                                f->linesize_bytes());
+
+      processor->apply(img);
+    });
+  } else {
+    OCIO::PackedImageDesc img(f->data(),
+                              f->width(),
+                              f->height(),
+                              f->channel_count(),
+                              ocio_bit_depth,
+                              OCIO::AutoStride,
+                              OCIO::AutoStride,
+                              f->linesize_bytes());
+
+    processor->apply(img);
+  }
+}
+
+OCIO::ConstCPUProcessorRcPtr ColorProcessor::GetCPUProcessorForDepth(OCIO::BitDepth depth)
+{
+  // The default processor is already built for F32
+  if (depth == OCIO::BIT_DEPTH_F32) {
+    return cpu_processor_;
+  }
+
+  QMutexLocker locker(&depth_processor_lock_);
+
+  auto it = depth_processors_.find(depth);
+  if (it == depth_processors_.end()) {
+    // A processor built for the actual bit depth lets OCIO use its vectorized integer/half
+    // kernels instead of converting through scalar F32
+    it = depth_processors_.insert(depth, processor_->getOptimizedCPUProcessor(depth, depth, OCIO::OPTIMIZATION_DEFAULT));
+  }
 
-  cpu_processor_->apply(img);
+  return it.value();
 }
 
 Color ColorProcessor::ConvertColor(const Color& in)
@@ -21,6 +21,8 @@
 #ifndef COLORPROCESSOR_H
 #define COLORPROCESSOR_H
 
+#include <QMutex>
+
 #include "codec/frame.h"
 #include "common/ocioutils.h"
 #include "render/colortransform.h"
@@ -50,6 +52,12 @@ public:
 
   OCIO::ConstProcessorRcPtr GetProcessor();
 
+  /**
+   * @brief Convert a whole frame in place on the CPU
+   *
+   * Uses a CPU processor optimized for the frame's bit depth so OCIO's vectorized kernels
+   * apply, and splits large frames into row bands converted in parallel. Thread-safe.
+   */
   void ConvertFrame(FramePtr f);
   void ConvertFrame(Frame* f);
 
@@ -61,10 +69,18 @@ public:
   }
 
 private:
+  /**
+   * @brief Get a CPU processor built for this bit depth, creating and caching it on first use
+   */
+  OCIO::ConstCPUProcessorRcPtr GetCPUProcessorForDepth(OCIO::BitDepth depth);
+
   OCIO::ConstProcessorRcPtr processor_;
 
   OCIO::ConstCPUProcessorRcPtr cpu_processor_;
 
+  QHash<int, OCIO::ConstCPUProcessorRcPtr> depth_processors_;
+  QMutex depth_processor_lock_;
+
 };
 
 using ColorProcessorChain = QVector<ColorProcessorPtr>;
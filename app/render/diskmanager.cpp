@@ -26,14 +26,29 @@
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QStandardPaths>
+#include <QtConcurrent/QtConcurrent>
 
 #include "common/filefunctions.h"
+#include "common/memorytelemetry.h"
 #include "config/config.h"
 #include "core.h"
 #include "dialog/diskcache/diskcachedialog.h"
+#include "render/framememorycache.h"
 
 namespace olive {
 
+// Journal format: [magic][version][limit][clear on close] followed by variable-length records.
+// Accessed()/CreatedFile()/deletes each append one record; the whole file is only rewritten
+// when it grows well past the number of live entries (see CompactJournal).
+static const quint32 kJournalMagic = 0x4F56434A; // "OVCJ"
+static const quint32 kJournalVersion = 1;
+
+enum JournalOp {
+  kJournalCreate = 1,
+  kJournalAccess = 2,
+  kJournalDelete = 3
+};
+
 DiskManager* DiskManager::instance_ = nullptr;
 
 DiskManager::DiskManager()
@@ -73,10 +88,22 @@ DiskManager::DiskManager()
 
     disk_cache_index.close();
   }
+
+  // Disk bytes rather than RAM, but shown in the same panel so cache pressure is visible in
+  // one place. Safe to capture `this` - the getter is unregistered in the destructor.
+  MemoryTelemetry::instance()->RegisterSource(QStringLiteral("Disk cache folders"), [this]{
+    qint64 total = 0;
+    foreach (DiskCacheFolder *folder, open_folders_) {
+      total += folder->GetConsumption();
+    }
+    return total;
+  });
 }
 
 DiskManager::~DiskManager()
 {
+  MemoryTelemetry::instance()->UnregisterSource(QStringLiteral("Disk cache folders"));
+
   QFile default_disk_cache_file(GetDefaultDiskCacheConfigFile());
   if (default_disk_cache_file.open(QFile::WriteOnly)) {
     if (GetDefaultDiskCachePath() != GetDefaultCachePath()) {
@@ -124,6 +151,13 @@ void DiskManager::DeleteSpecificFile(const QString &filename)
   }
 }
 
+QMap<QString, qint64> DiskManager::GetOwnerConsumption(const QString &cache_folder)
+{
+  DiskCacheFolder* f = GetOpenFolder(cache_folder);
+
+  return f->GetOwnerConsumption();
+}
+
 bool DiskManager::ClearDiskCache(const QString &cache_folder)
 {
   DiskCacheFolder* f = GetOpenFolder(cache_folder);
@@ -172,6 +206,34 @@ QString DiskManager::GetDefaultDiskCachePath()
   return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("mediacache");
 }
 
+QString DiskManager::GetShaderCachePath()
+{
+  QDir d(QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("shadercache"));
+  d.mkpath(QStringLiteral("."));
+  return d.path();
+}
+
+QString DiskManager::GetMediaIndexPath()
+{
+  QDir d(QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("mediaindex"));
+  d.mkpath(QStringLiteral("."));
+  return d.path();
+}
+
+QString DiskManager::GetFootageMetaPath()
+{
+  QDir d(QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("footagemeta"));
+  d.mkpath(QStringLiteral("."));
+  return d.path();
+}
+
+QString DiskManager::GetProxyPath()
+{
+  QDir d(QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)).filePath("proxies"));
+  d.mkpath(QStringLiteral("."));
+  return d.path();
+}
+
 void DiskManager::ShowDiskCacheSettingsDialog(DiskCacheFolder *folder, QWidget *parent)
 {
   DiskCacheDialog d(folder, parent);
@@ -192,7 +254,9 @@ void DiskManager::ShowDiskCacheSettingsDialog(const QString &path, QWidget *pare
 }
 
 DiskCacheFolder::DiskCacheFolder(const QString &path, QObject *parent) :
-  QObject(parent)
+  QObject(parent),
+  journal_record_count_(0),
+  index_loaded_(true)
 {
   SetPath(path);
 
@@ -208,6 +272,8 @@ DiskCacheFolder::~DiskCacheFolder()
 
 bool DiskCacheFolder::ClearCache()
 {
+  EnsureIndexLoaded();
+
   bool deleted_files = true;
 
   auto i = disk_data_.begin();
@@ -218,6 +284,11 @@ bool DiskCacheFolder::ClearCache()
 
     if (QFile::remove(filename) || !QFileInfo::exists(filename)) {
       emit DeletedFrame(path_, filename);
+      FrameMemoryCache::Remove(filename);
+      OwnerData &owner = owners_[i->owner];
+      owner.age_index.erase(i->age_it);
+      owner.consumption -= i->file_size;
+      consumption_ -= i->file_size;
       i = disk_data_.erase(i);
     } else {
       qWarning() << "Failed to delete" << filename;
@@ -226,31 +297,130 @@ bool DiskCacheFolder::ClearCache()
     }
   }
 
+  // Drop owner buckets that no longer have any entries
+  for (auto it=owners_.begin(); it!=owners_.end(); ) {
+    if (it->age_index.empty()) {
+      it = owners_.erase(it);
+    } else {
+      it++;
+    }
+  }
+
+  CompactJournal();
+
   return deleted_files;
 }
 
 void DiskCacheFolder::Accessed(const QString &filename)
 {
-  if (!disk_data_.contains(filename)) {
+  EnsureIndexLoaded();
+
+  auto it = disk_data_.find(filename);
+  if (it == disk_data_.end()) {
     return;
   }
 
-  disk_data_[filename].access_time = QDateTime::currentMSecsSinceEpoch();
+  TouchEntry(it, QDateTime::currentMSecsSinceEpoch());
+
+  AppendJournalRecord(kJournalAccess, filename, it.value());
 }
 
 void DiskCacheFolder::CreatedFile(const QString &filename)
 {
+  EnsureIndexLoaded();
+
   qint64 file_size = QFile(filename).size();
 
-  disk_data_.insert(filename, {file_size, QDateTime::currentMSecsSinceEpoch()});
+  // If this frame was re-rendered, any RAM copy of the old file is now stale
+  FrameMemoryCache::Remove(filename);
+
+  InsertEntry(filename, file_size, QDateTime::currentMSecsSinceEpoch());
 
-  consumption_ += file_size;
+  AppendJournalRecord(kJournalCreate, filename, disk_data_.value(filename));
 
   while (consumption_ > limit_) {
     DeleteLeastRecent();
   }
 }
 
+void DiskCacheFolder::InsertEntry(const QString &filename, qint64 size, qint64 time)
+{
+  auto it = disk_data_.find(filename);
+
+  if (it != disk_data_.end()) {
+    // Refreshing an existing entry
+    OwnerData &old_owner = owners_[it->owner];
+    old_owner.consumption -= it->file_size;
+    old_owner.age_index.erase(it->age_it);
+    consumption_ -= it->file_size;
+  } else {
+    it = disk_data_.insert(filename, HashTime());
+    it->owner = GetOwnerKey(filename);
+  }
+
+  OwnerData &owner = owners_[it->owner];
+
+  it->file_size = size;
+  it->access_time = time;
+  it->age_it = owner.age_index.insert({time, filename});
+
+  owner.consumption += size;
+  consumption_ += size;
+}
+
+void DiskCacheFolder::TouchEntry(DiskDataMap::iterator it, qint64 time)
+{
+  OwnerData &owner = owners_[it->owner];
+
+  owner.age_index.erase(it->age_it);
+  it->access_time = time;
+  it->age_it = owner.age_index.insert({time, it.key()});
+}
+
+void DiskCacheFolder::RemoveEntry(DiskDataMap::iterator it)
+{
+  auto owner_it = owners_.find(it->owner);
+
+  owner_it->age_index.erase(it->age_it);
+  owner_it->consumption -= it->file_size;
+
+  if (owner_it->age_index.empty()) {
+    owners_.erase(owner_it);
+  }
+
+  consumption_ -= it->file_size;
+  disk_data_.erase(it);
+}
+
+QString DiskCacheFolder::GetOwnerKey(const QString &filename) const
+{
+  // Each cache owner (sequence or clip cache) keeps its files in a UUID-named subdirectory
+  // directly under the cache folder
+  QString relative = QDir(path_).relativeFilePath(filename);
+
+  int slash = relative.indexOf('/');
+
+  if (slash == -1) {
+    // Loose file directly in the cache folder
+    return QString();
+  }
+
+  return relative.left(slash);
+}
+
+QMap<QString, qint64> DiskCacheFolder::GetOwnerConsumption()
+{
+  EnsureIndexLoaded();
+
+  QMap<QString, qint64> usage;
+
+  for (auto it=owners_.cbegin(); it!=owners_.cend(); it++) {
+    usage.insert(it.key(), it->consumption);
+  }
+
+  return usage;
+}
+
 void DiskCacheFolder::SetPath(const QString &path)
 {
   // If this is currently set to a folder, close it out now
@@ -262,6 +432,7 @@ void DiskCacheFolder::SetPath(const QString &path)
       emit DeletedFrame(path_, it.key());
     }
     disk_data_.clear();
+    owners_.clear();
   }
 
   // Set defaults
@@ -277,8 +448,95 @@ void DiskCacheFolder::SetPath(const QString &path)
   FileFunctions::DirectoryIsValid(path_dir);
 
   index_path_ = path_dir.filePath(QStringLiteral("index"));
+  journal_path_ = path_dir.filePath(QStringLiteral("journal"));
+
+  // Replaying the journal stats every cached file, which on a well-used cache is thousands of
+  // filesystem accesses, so it runs on a worker instead of stalling startup. Every entry point
+  // that touches the index calls EnsureIndexLoaded() first, which joins this future, so nothing
+  // else reads or writes these members until the load is done.
+  index_loaded_ = false;
+  index_load_future_ = QtConcurrent::run([this]{
+    QFile journal(journal_path_);
+    if (journal.open(QFile::ReadOnly)) {
+      ReplayJournal(&journal);
+      journal.close();
+    } else {
+      // Migrate from the old whole-map index format if one exists
+      LoadLegacyIndex();
+    }
 
-  // Try to load any current cache index from file
+    // Compacting on load drops replayed churn and entries whose files have vanished, and leaves
+    // the journal open for appending
+    CompactJournal();
+  });
+}
+
+void DiskCacheFolder::EnsureIndexLoaded()
+{
+  if (!index_loaded_) {
+    index_load_future_.waitForFinished();
+    index_loaded_ = true;
+  }
+}
+
+void DiskCacheFolder::ReplayJournal(QFile *file)
+{
+  QDataStream ds(file);
+
+  quint32 magic, version;
+  ds >> magic >> version;
+
+  if (magic != kJournalMagic || version != kJournalVersion) {
+    qWarning() << "Unrecognized cache journal, starting empty:" << file->fileName();
+    return;
+  }
+
+  ds >> limit_;
+  ds >> clear_on_close_;
+
+  while (!file->atEnd()) {
+    quint8 op;
+    QString filename;
+
+    ds >> op >> filename;
+
+    switch (op) {
+    case kJournalCreate:
+    {
+      qint64 size, time;
+      ds >> size >> time;
+      if (QFileInfo::exists(filename)) {
+        InsertEntry(filename, size, time);
+      }
+      break;
+    }
+    case kJournalAccess:
+    {
+      qint64 time;
+      ds >> time;
+      auto it = disk_data_.find(filename);
+      if (it != disk_data_.end()) {
+        TouchEntry(it, time);
+      }
+      break;
+    }
+    case kJournalDelete:
+    {
+      auto it = disk_data_.find(filename);
+      if (it != disk_data_.end()) {
+        RemoveEntry(it);
+      }
+      break;
+    }
+    default:
+      qWarning() << "Invalid record in cache journal, ignoring remainder:" << file->fileName();
+      return;
+    }
+  }
+}
+
+void DiskCacheFolder::LoadLegacyIndex()
+{
   QFile cache_index_file(index_path_);
 
   if (cache_index_file.open(QFile::ReadOnly)) {
@@ -289,15 +547,14 @@ void DiskCacheFolder::SetPath(const QString &path)
 
     while (!cache_index_file.atEnd()) {
       QString filename;
-      HashTime h;
+      qint64 size, time;
 
       ds >> filename;
-      ds >> h.file_size;
-      ds >> h.access_time;
+      ds >> size;
+      ds >> time;
 
       if (QFileInfo::exists(filename)) {
-        consumption_ += h.file_size;
-        disk_data_.insert(filename, h);
+        InsertEntry(filename, size, time);
       }
     }
 
@@ -305,21 +562,83 @@ void DiskCacheFolder::SetPath(const QString &path)
   }
 }
 
-bool DiskCacheFolder::DeleteFileInternal(QMap<QString, HashTime>::iterator hash_to_delete)
+void DiskCacheFolder::AppendJournalRecord(quint8 op, const QString &filename, const HashTime &ht)
+{
+  if (!journal_file_.isOpen()) {
+    return;
+  }
+
+  QDataStream ds(&journal_file_);
+
+  ds << op << filename;
+
+  switch (op) {
+  case kJournalCreate:
+    ds << ht.file_size << ht.access_time;
+    break;
+  case kJournalAccess:
+    ds << ht.access_time;
+    break;
+  case kJournalDelete:
+    break;
+  }
+
+  journal_record_count_++;
+}
+
+void DiskCacheFolder::CompactJournal()
+{
+  if (journal_file_.isOpen()) {
+    journal_file_.close();
+  }
+
+  QString temp_filename = FileFunctions::GetSafeTemporaryFilename(journal_path_);
+  QFile temp(temp_filename);
+
+  if (temp.open(QFile::WriteOnly)) {
+    QDataStream ds(&temp);
+
+    ds << kJournalMagic << kJournalVersion;
+    ds << limit_;
+    ds << clear_on_close_;
+
+    for (auto it=disk_data_.cbegin(); it!=disk_data_.cend(); it++) {
+      ds << quint8(kJournalCreate) << it.key() << it->file_size << it->access_time;
+    }
+
+    temp.close();
+
+    if (FileFunctions::RenameFileAllowOverwrite(temp_filename, journal_path_)) {
+      // The journal supersedes the old whole-map index format
+      QFile::remove(index_path_);
+    } else {
+      qWarning() << "Failed to replace cache journal:" << journal_path_;
+    }
+  } else {
+    qWarning() << "Failed to write cache journal:" << journal_path_;
+  }
+
+  journal_record_count_ = disk_data_.size();
+
+  journal_file_.setFileName(journal_path_);
+  if (!journal_file_.open(QFile::WriteOnly | QFile::Append)) {
+    qWarning() << "Failed to open cache journal for appending:" << journal_path_;
+  }
+}
+
+bool DiskCacheFolder::DeleteFileInternal(DiskDataMap::iterator hash_to_delete)
 {
-  // Cache HashTime object
   QString filename = hash_to_delete.key();
-  HashTime ht = hash_to_delete.value();
 
   // Remove from disk
   QFile f(filename);
 
   if (!f.exists() || f.remove()) {
-    // Remove from internal map
-    disk_data_.erase(hash_to_delete);
+    AppendJournalRecord(kJournalDelete, filename, hash_to_delete.value());
 
-    // Reduce consumption
-    consumption_ -= ht.file_size;
+    FrameMemoryCache::Remove(filename);
+
+    RemoveEntry(hash_to_delete);
 
     emit DeletedFrame(path_, filename);
     return true;
@@ -330,11 +649,12 @@ bool DiskCacheFolder::DeleteFileInternal(QMap<QString, HashTime>::iterator hash_
 
 bool DiskCacheFolder::DeleteSpecificFile(const QString &f)
 {
-  for (auto it=disk_data_.begin(); it!=disk_data_.end(); it++) {
-    if (it.key() == f) {
-      // Break out of this loop, assuming we'll only have one instance of each filename
-      return DeleteFileInternal(it);
-    }
+  EnsureIndexLoaded();
+
+  auto it = disk_data_.find(f);
+
+  if (it != disk_data_.end()) {
+    return DeleteFileInternal(it);
   }
 
   return false;
@@ -342,25 +662,29 @@ bool DiskCacheFolder::DeleteSpecificFile(const QString &f)
 
 bool DiskCacheFolder::DeleteLeastRecent()
 {
-  auto hash_to_delete = disk_data_.begin();
-
-  if (disk_data_.begin() != disk_data_.end()) {
-    for (auto it=disk_data_.begin()+1; it!=disk_data_.end(); it++) {
-      if (it->access_time < hash_to_delete->access_time) {
-        hash_to_delete = it;
-      }
-    }
+  if (owners_.empty()) {
+    return false;
+  }
 
-    bool e = DeleteFileInternal(hash_to_delete);
+  // Every owner gets an equal share of the folder limit and we evict from whichever owner is
+  // furthest over its share - with equal shares that's simply the biggest consumer. Owners
+  // within their share are never evicted by someone else's overflow.
+  auto victim = owners_.begin();
 
-    if (e) {
-      Core::instance()->WarnCacheFull();
+  for (auto it=owners_.begin(); it!=owners_.end(); it++) {
+    if (it->consumption > victim->consumption) {
+      victim = it;
     }
+  }
 
-    return e;
-  } else {
-    return false;
+  // Oldest entry is always at the front of the owner's age index
+  bool e = DeleteFileInternal(disk_data_.find(victim->age_index.begin()->second));
+
+  if (e) {
+    Core::instance()->WarnCacheFull();
   }
+
+  return e;
 }
 
 void DiskCacheFolder::CloseCacheFolder()
@@ -369,37 +693,29 @@ void DiskCacheFolder::CloseCacheFolder()
     return;
   }
 
+  EnsureIndexLoaded();
+
   if (clear_on_close_) {
     // If we're not moving to new and we're set to clear on close, clear now or else it'll never
     // get cleared later
     ClearCache();
   }
 
-  // Save current cache index
-  SaveDiskCacheIndex();
+  // Write a compact snapshot (also persists limit/clear-on-close changes)
+  CompactJournal();
+  journal_file_.close();
 }
 
 void DiskCacheFolder::SaveDiskCacheIndex()
 {
-  QFile cache_index_file(index_path_);
-
-  if (cache_index_file.open(QFile::WriteOnly)) {
-    QDataStream ds(&cache_index_file);
-
-    ds << limit_;
-    ds << clear_on_close_;
-
-    for (auto it=disk_data_.cbegin(); it!=disk_data_.cend(); it++) {
-      const HashTime& ht = it.value();
-
-      ds << it.key();
-      ds << ht.file_size;
-      ds << ht.access_time;
-    }
-
-    cache_index_file.close();
-  } else {
-    qWarning() << "Failed to write cache index:" << index_path_;
+  EnsureIndexLoaded();
+
+  // Records are appended as they happen, so the periodic save only needs to push them to disk -
+  // unless the journal has grown well past the number of live entries, in which case rewrite it
+  if (journal_record_count_ > qMax(qint64(10000), qint64(disk_data_.size()) * 4)) {
+    CompactJournal();
+  } else if (journal_file_.isOpen()) {
+    journal_file_.flush();
   }
 }
 
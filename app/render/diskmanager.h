@@ -21,6 +21,10 @@
 #ifndef DISKMANAGER_H
 #define DISKMANAGER_H
 
+#include <map>
+#include <QFile>
+#include <QFuture>
+#include <QHash>
 #include <QMap>
 #include <QMutex>
 #include <QObject>
@@ -52,28 +56,47 @@ public:
 
   void SetPath(const QString& path);
 
-  qint64 GetLimit() const
+  qint64 GetLimit()
   {
+    EnsureIndexLoaded();
     return limit_;
   }
 
-  bool GetClearOnClose() const
+  qint64 GetConsumption()
   {
+    EnsureIndexLoaded();
+    return consumption_;
+  }
+
+  bool GetClearOnClose()
+  {
+    EnsureIndexLoaded();
     return clear_on_close_;
   }
 
   void SetLimit(qint64 l)
   {
+    EnsureIndexLoaded();
     limit_ = l;
   }
 
   void SetClearOnClose(bool e)
   {
+    EnsureIndexLoaded();
     clear_on_close_ = e;
   }
 
   bool DeleteSpecificFile(const QString &f);
 
+  /**
+   * @brief Get disk consumption grouped by cache owner
+   *
+   * Each sequence or clip cache stores its files in a UUID-named subdirectory directly under
+   * the cache folder, so this reports how much of the folder each of them is using - e.g. for
+   * spotting which project is dominating a shared cache volume.
+   */
+  QMap<QString, qint64> GetOwnerConsumption();
+
 signals:
   void DeletedFrame(const QString& path, const QString& filename);
 
@@ -81,19 +104,86 @@ private:
   struct HashTime {
     qint64 file_size;
     qint64 access_time;
+
+    // Which owner bucket this entry belongs to (first-level subdirectory of the cache folder)
+    QString owner;
+
+    // Position in the owner's age index so LRU updates don't have to search
+    std::multimap<qint64, QString>::iterator age_it;
   };
 
-  bool DeleteFileInternal(QMap<QString, HashTime>::iterator hash_to_delete);
+  using DiskDataMap = QHash<QString, HashTime>;
+
+  bool DeleteFileInternal(DiskDataMap::iterator hash_to_delete);
 
   bool DeleteLeastRecent();
 
   void CloseCacheFolder();
 
+  /**
+   * @brief Insert or refresh an entry in both the filename map and the age index
+   */
+  void InsertEntry(const QString &filename, qint64 size, qint64 time);
+
+  void TouchEntry(DiskDataMap::iterator it, qint64 time);
+
+  void RemoveEntry(DiskDataMap::iterator it);
+
+  /**
+   * @brief Get the owner bucket a filename belongs to
+   */
+  QString GetOwnerKey(const QString &filename) const;
+
+  void ReplayJournal(QFile *file);
+
+  void LoadLegacyIndex();
+
+  /**
+   * @brief Block until the background index load started by SetPath has finished
+   *
+   * Every entry point that touches the index or the journal calls this first, so the load can
+   * run on a worker without the rest of the class needing any locking.
+   */
+  void EnsureIndexLoaded();
+
+  void AppendJournalRecord(quint8 op, const QString &filename, const HashTime &ht);
+
+  /**
+   * @brief Rewrite the journal as one create-record per live entry and reopen it for appending
+   */
+  void CompactJournal();
+
   QString path_;
 
   QString index_path_;
 
-  QMap<QString, HashTime> disk_data_;
+  QString journal_path_;
+
+  QFile journal_file_;
+
+  qint64 journal_record_count_;
+
+  QFuture<void> index_load_future_;
+
+  bool index_loaded_;
+
+  DiskDataMap disk_data_;
+
+  /**
+   * @brief Per-owner accounting and LRU state
+   *
+   * Eviction gives every owner an equal share of the folder limit and deletes the least recent
+   * file of whichever owner is furthest over its share, so one huge project filling the cache
+   * can't evict everyone else's still-warm frames.
+   */
+  struct OwnerData {
+    qint64 consumption = 0;
+
+    // Entries ordered by access time, oldest first, for O(1) LRU eviction within the owner
+    std::multimap<qint64, QString> age_index;
+  };
+
+  QHash<QString, OwnerData> owners_;
 
   qint64 consumption_;
 
@@ -144,9 +234,46 @@ public:
 
   static QString GetDefaultDiskCachePath();
 
+  /**
+   * @brief Returns the folder where compiled shader binaries are persisted between sessions
+   *
+   * Created on demand. Entries are keyed by shader source hash and driver string, so stale
+   * binaries are simply never read again and can be cleared at any time.
+   */
+  static QString GetShaderCachePath();
+
+  /**
+   * @brief Returns the folder where per-footage index sidecars (e.g. keyframe indexes) live
+   *
+   * Created on demand. Entries are keyed by unique file identifier, so indexes for deleted or
+   * modified footage are simply never read again and can be cleared at any time.
+   */
+  static QString GetMediaIndexPath();
+
+  /**
+   * @brief Returns the folder where footage probe results (stream layouts, durations, etc.) live
+   *
+   * Created on demand. Entries are keyed by unique file identifier, so metadata for deleted or
+   * modified footage is simply never read again and can be cleared at any time.
+   */
+  static QString GetFootageMetaPath();
+
+  /**
+   * @brief Returns the folder where generated proxy media lives
+   *
+   * Created on demand. Entries are keyed by unique file identifier, so proxies for deleted or
+   * modified footage are simply never read again and can be cleared at any time.
+   */
+  static QString GetProxyPath();
+
   void ShowDiskCacheSettingsDialog(DiskCacheFolder* folder, QWidget* parent);
   void ShowDiskCacheSettingsDialog(const QString& path, QWidget* parent);
 
+  /**
+   * @brief Per-owner usage report for a cache folder (see DiskCacheFolder::GetOwnerConsumption)
+   */
+  QMap<QString, qint64> GetOwnerConsumption(const QString& cache_folder);
+
 public slots:
   void Accessed(const QString& cache_folder, const QString& filename);
 
@@ -0,0 +1,128 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "dummyrenderer.h"
+
+#include <cstring>
+
+namespace olive {
+
+DummyRenderer::DummyRenderer(QObject *parent) :
+  Renderer(parent)
+{
+}
+
+bool DummyRenderer::Init()
+{
+  return true;
+}
+
+void DummyRenderer::PostDestroy()
+{
+}
+
+void DummyRenderer::PostInit()
+{
+}
+
+void DummyRenderer::ClearDestination(Texture *texture, double r, double g, double b, double a)
+{
+  Q_UNUSED(texture)
+  Q_UNUSED(r)
+  Q_UNUSED(g)
+  Q_UNUSED(b)
+  Q_UNUSED(a)
+}
+
+QVariant DummyRenderer::CreateNativeShader(ShaderCode code)
+{
+  Q_UNUSED(code)
+
+  // Any non-null value will do, callers only check that shader creation didn't fail
+  return 1;
+}
+
+void DummyRenderer::DestroyNativeShader(QVariant shader)
+{
+  Q_UNUSED(shader)
+}
+
+void DummyRenderer::UploadToTexture(const QVariant &handle, const VideoParams &params, const void *data, int linesize)
+{
+  Q_UNUSED(handle)
+  Q_UNUSED(params)
+  Q_UNUSED(data)
+  Q_UNUSED(linesize)
+}
+
+void DummyRenderer::DownloadFromTexture(const QVariant &handle, const VideoParams &params, void *data, int linesize)
+{
+  Q_UNUSED(handle)
+
+  // Nothing was ever rendered, so downloads produce black frames. Still write every byte so
+  // downstream consumers (e.g. encoders) read defined memory at full-frame bandwidth.
+  memset(data, 0, size_t(linesize) * params.effective_height());
+}
+
+void DummyRenderer::Flush()
+{
+}
+
+Color DummyRenderer::GetPixelFromTexture(Texture *texture, const QPointF &pt)
+{
+  Q_UNUSED(texture)
+  Q_UNUSED(pt)
+
+  return Color();
+}
+
+void DummyRenderer::Blit(QVariant shader, ShaderJob job, Texture *destination, VideoParams destination_params, bool clear_destination)
+{
+  Q_UNUSED(shader)
+  Q_UNUSED(job)
+  Q_UNUSED(destination)
+  Q_UNUSED(destination_params)
+  Q_UNUSED(clear_destination)
+}
+
+QVariant DummyRenderer::CreateNativeTexture(int width, int height, int depth, PixelFormat format, int channel_count, const void *data, int linesize)
+{
+  Q_UNUSED(width)
+  Q_UNUSED(height)
+  Q_UNUSED(depth)
+  Q_UNUSED(format)
+  Q_UNUSED(channel_count)
+  Q_UNUSED(data)
+  Q_UNUSED(linesize)
+
+  // Any non-null value will do, callers only check that texture creation didn't fail
+  return 1;
+}
+
+void DummyRenderer::DestroyNativeTexture(QVariant texture)
+{
+  Q_UNUSED(texture)
+}
+
+void DummyRenderer::DestroyInternal()
+{
+}
+
+}
@@ -0,0 +1,79 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef DUMMYRENDERER_H
+#define DUMMYRENDERER_H
+
+#include "render/renderer.h"
+
+namespace olive {
+
+/**
+ * @brief A graphics backend that does no actual rendering
+ *
+ * Every blit is a no-op and downloaded textures come back as black frames. This exists to
+ * exercise and benchmark the threading, scheduling and codec parts of the pipeline in isolation
+ * from any GPU, e.g. on headless CI machines. Selected with the "dummy" value of the
+ * RenderBackend config entry.
+ */
+class DummyRenderer : public Renderer
+{
+  Q_OBJECT
+public:
+  DummyRenderer(QObject* parent = nullptr);
+
+  virtual bool Init() override;
+
+  virtual void PostDestroy() override;
+
+  virtual void PostInit() override;
+
+  virtual void ClearDestination(olive::Texture *texture = nullptr, double r = 0.0, double g = 0.0, double b = 0.0, double a = 0.0) override;
+
+  virtual QVariant CreateNativeShader(olive::ShaderCode code) override;
+
+  virtual void DestroyNativeShader(QVariant shader) override;
+
+  virtual void UploadToTexture(const QVariant &handle, const VideoParams &params, const void* data, int linesize) override;
+
+  virtual void DownloadFromTexture(const QVariant &handle, const VideoParams &params, void* data, int linesize) override;
+
+  virtual void Flush() override;
+
+  virtual Color GetPixelFromTexture(olive::Texture *texture, const QPointF &pt) override;
+
+protected:
+  virtual void Blit(QVariant shader,
+                    olive::ShaderJob job,
+                    olive::Texture* destination,
+                    olive::VideoParams destination_params,
+                    bool clear_destination) override;
+
+  virtual QVariant CreateNativeTexture(int width, int height, int depth, PixelFormat format, int channel_count, const void* data = nullptr, int linesize = 0) override;
+
+  virtual void DestroyNativeTexture(QVariant texture) override;
+
+  virtual void DestroyInternal() override;
+
+};
+
+}
+
+#endif // DUMMYRENDERER_H
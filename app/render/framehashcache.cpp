@@ -20,23 +20,156 @@
 
 #include "framehashcache.h"
 
+#include <memory>
+#include <OpenEXR/Iex.h>
 #include <OpenEXR/ImfFloatAttribute.h>
 #include <OpenEXR/ImfFrameBuffer.h>
 #include <OpenEXR/ImfHeader.h>
+#include <OpenEXR/ImfIO.h>
 #include <OpenEXR/ImfInputFile.h>
 #include <OpenEXR/ImfIntAttribute.h>
 #include <OpenEXR/ImfOutputFile.h>
 #include <OpenEXR/ImfChannelList.h>
+#include <QCryptographicHash>
 #include <QDir>
+#include <QFile>
 #include <QFileInfo>
+#include <QMutex>
 
 #include "codec/frame.h"
 #include "common/filefunctions.h"
 #include "common/oiioutils.h"
 #include "render/diskmanager.h"
+#ifdef USE_QT_NETWORK
+#include "render/remotecache.h"
+#endif
 
 namespace olive {
 
+namespace {
+
+/**
+ * @brief Imf::IStream backed by a memory-mapped file
+ *
+ * Lets OpenEXR read scanlines straight out of the OS page cache rather than through buffered
+ * read() calls that copy the whole file an extra time. Falls back gracefully - check IsValid()
+ * before handing this to an InputFile.
+ */
+class MemoryMappedIStream : public Imf::IStream
+{
+public:
+  explicit MemoryMappedIStream(const QString &fn) :
+    Imf::IStream(fn.toUtf8()),
+    file_(fn),
+    data_(nullptr),
+    size_(0),
+    pos_(0)
+  {
+    if (file_.open(QFile::ReadOnly)) {
+      size_ = file_.size();
+      data_ = reinterpret_cast<char*>(file_.map(0, size_));
+    }
+  }
+
+  bool IsValid() const
+  {
+    return data_;
+  }
+
+  virtual bool isMemoryMapped() const override
+  {
+    return true;
+  }
+
+  virtual char *readMemoryMapped(int n) override
+  {
+    if (pos_ + n > size_) {
+      throw Iex::InputExc("Unexpected end of file");
+    }
+
+    char *ret = data_ + pos_;
+    pos_ += n;
+    return ret;
+  }
+
+  virtual bool read(char c[], int n) override
+  {
+    if (pos_ + n > size_) {
+      throw Iex::InputExc("Unexpected end of file");
+    }
+
+    memcpy(c, data_ + pos_, n);
+    pos_ += n;
+    return pos_ < size_;
+  }
+
+  virtual uint64_t tellg() override
+  {
+    return pos_;
+  }
+
+  virtual void seekg(uint64_t pos) override
+  {
+    pos_ = pos;
+  }
+
+private:
+  QFile file_;
+
+  char *data_;
+
+  qint64 size_;
+
+  qint64 pos_;
+
+};
+
+// Content-addressed dedup state - maps the hash of a frame's parameters and pixel data to a
+// filename that already holds that exact payload. Shared by every cache since identical
+// content is identical regardless of which sequence produced it.
+QMutex dedup_mutex;
+QHash<QByteArray, QString> dedup_index;
+
+// The index is an opportunistic accelerator - dropping it only costs one full write per unique
+// frame - so it's kept bounded rather than growing for the whole session
+const int kDedupIndexMaxEntries = 4096;
+
+/**
+ * @brief Hash a frame's parameters and pixel data into a content identity
+ */
+QByteArray HashFrameContent(const FramePtr &frame)
+{
+  QCryptographicHash hasher(QCryptographicHash::Sha1);
+
+  // Parameters that change how the payload is interpreted are part of the identity
+  const VideoParams &vp = frame->video_params();
+  const int desc[] = {frame->width(),
+                      frame->height(),
+                      static_cast<int>(frame->format()),
+                      frame->channel_count(),
+                      vp.divider(),
+                      vp.pixel_aspect_ratio().numerator(),
+                      vp.pixel_aspect_ratio().denominator()};
+  hasher.addData(reinterpret_cast<const char*>(desc), sizeof(desc));
+
+  hasher.addData(frame->const_data(), frame->allocated_size());
+
+  return hasher.result();
+}
+
+void RememberSavedFrame(const QByteArray &content_hash, const QString &filename)
+{
+  QMutexLocker locker(&dedup_mutex);
+
+  if (dedup_index.size() >= kDedupIndexMaxEntries) {
+    dedup_index.clear();
+  }
+
+  dedup_index.insert(content_hash, filename);
+}
+
+}
+
 #define super PlaybackCache
 
 FrameHashCache::FrameHashCache(QObject *parent) :
@@ -98,6 +231,13 @@ bool FrameHashCache::SaveCacheFrame(const QString &cache_path, const QUuid &uuid
   // Register frame with the disk manager
   if (ret) {
     QMetaObject::invokeMethod(DiskManager::instance(), "CreatedFile", Q_ARG(QString, cache_path), Q_ARG(QString, fn));
+
+#ifdef USE_QT_NETWORK
+    // Share the frame with other workstations caching this sequence
+    if (RemoteCache::instance()) {
+      RemoteCache::instance()->StoreFrame(cache_path, fn);
+    }
+#endif
   }
 
   return ret;
@@ -117,6 +257,13 @@ bool FrameHashCache::SaveCacheFrame(const QString &cache_path, const QUuid &uuid
   // Register frame with the disk manager
   if (ret) {
     QMetaObject::invokeMethod(DiskManager::instance(), "CreatedFile", Q_ARG(QString, cache_path), Q_ARG(QString, fn));
+
+#ifdef USE_QT_NETWORK
+    // Share the frame with other workstations caching this sequence
+    if (RemoteCache::instance()) {
+      RemoteCache::instance()->StoreFrame(cache_path, fn);
+    }
+#endif
   }
 
   return ret;
@@ -134,6 +281,16 @@ FramePtr FrameHashCache::LoadCacheFrame(const QString &cache_path, const QUuid &
     return nullptr;
   }
 
+#ifdef USE_QT_NETWORK
+  // On a local miss, another workstation caching this sequence may have rendered this frame
+  // already - the cache UUID is stored in the project, so the key is the same on every machine
+  if (!QFileInfo::exists(filename) && RemoteCache::instance() &&
+      RemoteCache::instance()->FetchFrame(cache_path, filename)) {
+    // Register the fetched file so the disk manager accounts for and can evict it
+    QMetaObject::invokeMethod(DiskManager::instance(), "CreatedFile", Q_ARG(QString, cache_path), Q_ARG(QString, filename));
+  }
+#endif
+
   return LoadCacheFrame(filename);
 }
 
@@ -148,15 +305,23 @@ FramePtr FrameHashCache::LoadCacheFrame(const QString &fn)
 
   if (!fn.isEmpty() && QFileInfo::exists(fn)) {
     try {
-      Imf::InputFile file(fn.toUtf8(), 0);
+      // Prefer reading through a memory map so scanlines decompress straight from the page
+      // cache, but fall back to buffered reads if mapping fails (e.g. network filesystems)
+      MemoryMappedIStream stream(fn);
+      std::unique_ptr<Imf::InputFile> file;
+      if (stream.IsValid()) {
+        file.reset(new Imf::InputFile(stream, 0));
+      } else {
+        file.reset(new Imf::InputFile(fn.toUtf8(), 0));
+      }
 
-      Imath::Box2i dw = file.header().dataWindow();
-      Imf::PixelType pix_type = file.header().channels().begin().channel().type;
+      Imath::Box2i dw = file->header().dataWindow();
+      Imf::PixelType pix_type = file->header().channels().begin().channel().type;
       int width = dw.max.x - dw.min.x + 1;
       int height = dw.max.y - dw.min.y + 1;
-      bool has_alpha = file.header().channels().findChannel("A");
+      bool has_alpha = file->header().channels().findChannel("A");
 
-      int div = qMax(1, static_cast<const Imf::IntAttribute&>(file.header()["oliveDivider"]).value());
+      int div = qMax(1, static_cast<const Imf::IntAttribute&>(file->header()["oliveDivider"]).value());
 
       PixelFormat image_format;
       if (pix_type == Imf::HALF) {
@@ -172,7 +337,7 @@ FramePtr FrameHashCache::LoadCacheFrame(const QString &fn)
                                           height * div,
                                           image_format,
                                           channel_count,
-                                          rational::fromDouble(file.header().pixelAspectRatio()),
+                                          rational::fromDouble(file->header().pixelAspectRatio()),
                                           VideoParams::kInterlaceNone,
                                           div));
 
@@ -191,9 +356,9 @@ FramePtr FrameHashCache::LoadCacheFrame(const QString &fn)
         framebuffer.insert("A", Imf::Slice(pix_type, frame->data() + 3*bpc, xs, ys));
       }
 
-      file.setFrameBuffer(framebuffer);
+      file->setFrameBuffer(framebuffer);
 
-      file.readPixels(dw.min.y, dw.max.y);
+      file->readPixels(dw.min.y, dw.max.y);
     } catch (const std::exception &e) {
       // Not an EXR, maybe it's a JPEG?
       QImage img;
@@ -342,6 +507,39 @@ bool FrameHashCache::SaveCacheFrame(const QString &filename, const FramePtr fram
     return false;
   }
 
+  // Freeze frames, held titles and other static sections produce long runs of byte-identical
+  // frames. If this exact content has already been written this session, hard-link the new
+  // timestamp to the existing payload instead of re-encoding and re-writing it. Every
+  // timestamp still has its own directory entry, so loading and per-frame deletion behave
+  // exactly as before - the payload is only reclaimed when its last link goes.
+  QByteArray content_hash = HashFrameContent(frame);
+
+  {
+    QMutexLocker locker(&dedup_mutex);
+
+    // Whatever happens below, this filename's content is about to change (by link or rewrite),
+    // so any index entry still pointing at it describes its old payload - a later frame
+    // matching that stale hash must not be linked here
+    for (auto it = dedup_index.begin(); it != dedup_index.end(); ) {
+      if (it.value() == filename) {
+        it = dedup_index.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
+    QString existing = dedup_index.value(content_hash);
+    if (!existing.isEmpty() && existing != filename) {
+      // The payload may have been evicted by the disk manager since it was indexed, and not
+      // every filesystem supports hard links - fall through to a full write in either case
+      if (QFileInfo::exists(existing) && FileFunctions::HardLinkFileAllowOverwrite(existing, filename)) {
+        return true;
+      }
+
+      dedup_index.remove(content_hash);
+    }
+  }
+
   if (VideoParams::FormatIsFloat(frame->format())) {
     // Floating point types are stored in EXR
     Imf::PixelType pix_type;
@@ -366,29 +564,46 @@ bool FrameHashCache::SaveCacheFrame(const QString &filename, const FramePtr fram
 
     header.insert("oliveDivider", Imf::IntAttribute(frame->video_params().divider()));
 
+    // Write to a temporary file and swap it in. Invalidation never unlinks frame files, so
+    // writing in place would rewrite the payload behind any still-validated timestamps
+    // hard-linked to this one - replacing the directory entry gives this timestamp a fresh
+    // inode while link siblings keep the old content.
+    QString temp_filename = FileFunctions::GetSafeTemporaryFilename(filename);
+
     try {
-      Imf::OutputFile out(filename.toUtf8(), header, 0);
+      {
+        Imf::OutputFile out(temp_filename.toUtf8(), header, 0);
 
-      int bpc = VideoParams::GetBytesPerChannel(frame->format());
+        int bpc = VideoParams::GetBytesPerChannel(frame->format());
 
-      size_t xs = frame->channel_count() * bpc;
-      size_t ys = frame->linesize_bytes();
+        size_t xs = frame->channel_count() * bpc;
+        size_t ys = frame->linesize_bytes();
 
-      Imf::FrameBuffer framebuffer;
-      framebuffer.insert("R", Imf::Slice(pix_type, frame->data(), xs, ys));
-      framebuffer.insert("G", Imf::Slice(pix_type, frame->data() + bpc, xs, ys));
-      framebuffer.insert("B", Imf::Slice(pix_type, frame->data() + 2*bpc, xs, ys));
-      if (frame->channel_count() == VideoParams::kRGBAChannelCount) {
-        framebuffer.insert("A", Imf::Slice(pix_type, frame->data() + 3*bpc, xs, ys));
+        Imf::FrameBuffer framebuffer;
+        framebuffer.insert("R", Imf::Slice(pix_type, frame->data(), xs, ys));
+        framebuffer.insert("G", Imf::Slice(pix_type, frame->data() + bpc, xs, ys));
+        framebuffer.insert("B", Imf::Slice(pix_type, frame->data() + 2*bpc, xs, ys));
+        if (frame->channel_count() == VideoParams::kRGBAChannelCount) {
+          framebuffer.insert("A", Imf::Slice(pix_type, frame->data() + 3*bpc, xs, ys));
+        }
+        out.setFrameBuffer(framebuffer);
+
+        out.writePixels(frame->height());
+      }
+
+      if (!FileFunctions::RenameFileAllowOverwrite(temp_filename, filename)) {
+        QFile::remove(temp_filename);
+        return false;
       }
-      out.setFrameBuffer(framebuffer);
 
-      out.writePixels(frame->height());
+      RememberSavedFrame(content_hash, filename);
 
       return true;
     } catch (const std::exception &e) {
       qCritical() << "Failed to write cache frame:" << e.what();
 
+      QFile::remove(temp_filename);
+
       return false;
     }
   } else {
@@ -420,7 +635,22 @@ bool FrameHashCache::SaveCacheFrame(const QString &filename, const FramePtr fram
 
     QImage img(reinterpret_cast<const uchar*>(frame->data()), frame->width(), frame->height(), frame->linesize_bytes(), fmt);
 
-    return img.save(filename, "jpg");
+    // Same temp-and-swap as the EXR branch so hard-link siblings keep the old payload
+    QString temp_filename = FileFunctions::GetSafeTemporaryFilename(filename);
+
+    if (!img.save(temp_filename, "jpg")) {
+      QFile::remove(temp_filename);
+      return false;
+    }
+
+    if (!FileFunctions::RenameFileAllowOverwrite(temp_filename, filename)) {
+      QFile::remove(temp_filename);
+      return false;
+    }
+
+    RememberSavedFrame(content_hash, filename);
+
+    return true;
   }
 }
 
@@ -20,21 +20,39 @@
 
 #include "framemanager.h"
 
+#include <new>
+
 #include <QDateTime>
 #include <QDebug>
+#include <QThread>
+
+#ifdef Q_OS_LINUX
+#include <sys/mman.h>
+#endif
+
+#include "common/memorytelemetry.h"
 
 namespace olive {
 
 FrameManager* FrameManager::instance_ = nullptr;
 const int FrameManager::kFrameLifetime = 5000;
 
+// Buffers at least this large are given their own 2MB-page-aligned mapping - see AllocateBuffer()
+static const int kHugePageSize = 2 * 1024 * 1024;
+
 void FrameManager::CreateInstance()
 {
   instance_ = new FrameManager();
+
+  MemoryTelemetry::instance()->RegisterSource(QStringLiteral("Frame buffer pool"), []{
+    return instance_ ? instance_->GetPooledMemory() : 0;
+  });
 }
 
 void FrameManager::DestroyInstance()
 {
+  MemoryTelemetry::instance()->UnregisterSource(QStringLiteral("Frame buffer pool"));
+
   delete instance_;
   instance_ = nullptr;
 }
@@ -49,7 +67,7 @@ char *FrameManager::Allocate(int size)
   if (instance()) {
     return instance()->AllocateFromPool(size);
   } else {
-    return new char[size];
+    return AllocateBuffer(size);
   }
 }
 
@@ -58,10 +76,46 @@ void FrameManager::Deallocate(int size, char *buffer)
   if (instance()) {
     instance()->DeallocateToPool(size, buffer);
   } else {
-    delete [] buffer;
+    FreeBuffer(size, buffer);
   }
 }
 
+char *FrameManager::AllocateBuffer(int size)
+{
+#ifdef Q_OS_LINUX
+  if (size >= kHugePageSize) {
+    // Round up so the mapping can be fully backed by 2MB pages
+    size_t mapped_size = (size_t(size) + kHugePageSize - 1) & ~size_t(kHugePageSize - 1);
+
+    void *buf = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED) {
+      // Match what operator new[] would have done so callers see one failure mode
+      throw std::bad_alloc();
+    }
+
+    // Advisory only - if transparent huge pages are unavailable this is just a normal mapping
+    madvise(buf, mapped_size, MADV_HUGEPAGE);
+
+    return static_cast<char*>(buf);
+  }
+#endif
+
+  return new char[size];
+}
+
+void FrameManager::FreeBuffer(int size, char *buffer)
+{
+#ifdef Q_OS_LINUX
+  if (size >= kHugePageSize) {
+    size_t mapped_size = (size_t(size) + kHugePageSize - 1) & ~size_t(kHugePageSize - 1);
+    munmap(buffer, mapped_size);
+    return;
+  }
+#endif
+
+  delete [] buffer;
+}
+
 FrameManager::FrameManager()
 {
   clear_timer_.setInterval(kFrameLifetime);
@@ -77,11 +131,23 @@ char *FrameManager::AllocateFromPool(int size)
   char* buf = nullptr;
 
   if (buffer_list.empty()) {
-    buf = new char[size];
+    buf = AllocateBuffer(size);
   } else {
-    // Take this buffer from the list
-    buf = buffer_list.front().data;
-    buffer_list.pop_front();
+    // Prefer a buffer this thread freed itself - under first-touch allocation it lives on this
+    // thread's own NUMA node and is more likely to still be warm in its caches than one another
+    // thread has been writing to
+    Qt::HANDLE this_thread = QThread::currentThreadId();
+
+    auto it = buffer_list.begin();
+    for (auto jt=buffer_list.begin(); jt!=buffer_list.end(); jt++) {
+      if (jt->thread == this_thread) {
+        it = jt;
+        break;
+      }
+    }
+
+    buf = it->data;
+    buffer_list.erase(it);
   }
 
   return buf;
@@ -93,7 +159,20 @@ void FrameManager::DeallocateToPool(int size, char *buffer)
 
   std::list<Buffer>& buffer_list = pool_[size];
 
-  buffer_list.push_back({QDateTime::currentMSecsSinceEpoch(), buffer});
+  buffer_list.push_back({QDateTime::currentMSecsSinceEpoch(), buffer, QThread::currentThreadId()});
+}
+
+qint64 FrameManager::GetPooledMemory()
+{
+  QMutexLocker locker(&mutex_);
+
+  qint64 total = 0;
+
+  for (auto it=pool_.cbegin(); it!=pool_.cend(); it++) {
+    total += qint64(it->first) * qint64(it->second.size());
+  }
+
+  return total;
 }
 
 void FrameManager::GarbageCollection()
@@ -106,7 +185,7 @@ void FrameManager::GarbageCollection()
     std::list<Buffer>& list = it->second;
 
     while (list.size() > 0 && list.front().time < min_life) {
-      delete [] list.front().data;
+      FreeBuffer(it->first, list.front().data);
       list.pop_front();
     }
   }
@@ -119,7 +198,7 @@ FrameManager::~FrameManager()
   for (auto it=pool_.begin(); it!=pool_.end(); it++) {
     std::list<Buffer>& list = it->second;
     for (auto jt=list.begin(); jt!=list.end(); jt++) {
-      delete [] (*jt).data;
+      FreeBuffer(it->first, (*jt).data);
     }
   }
 
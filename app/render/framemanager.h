@@ -41,6 +41,13 @@ public:
 
   static void Deallocate(int size, char* buffer);
 
+  /**
+   * @brief Total bytes currently held by the reuse pool
+   *
+   * Thread-safe; polled by memory telemetry.
+   */
+  qint64 GetPooledMemory();
+
 private:
   FrameManager();
 
@@ -66,6 +73,18 @@ private:
    */
   void DeallocateToPool(int size, char* buffer);
 
+  /**
+   * @brief Allocate/free the backing memory for a buffer of `size` bytes
+   *
+   * On Linux, multi-megabyte buffers get their own anonymous mapping with transparent huge
+   * pages requested, which measurably cuts TLB pressure when video frames are copied around.
+   * The choice of backing is purely size-based so a buffer can always be freed correctly
+   * without tracking where it came from.
+   */
+  static char* AllocateBuffer(int size);
+
+  static void FreeBuffer(int size, char* buffer);
+
   static FrameManager* instance_;
 
   static const int kFrameLifetime;
@@ -74,6 +93,7 @@ private:
   {
     qint64 time;
     char* data;
+    Qt::HANDLE thread;
   };
 
   std::map< int, std::list<Buffer> > pool_;
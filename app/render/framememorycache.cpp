@@ -0,0 +1,159 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "framememorycache.h"
+
+#include "common/filefunctions.h"
+#include "config/config.h"
+
+namespace olive {
+
+QMutex FrameMemoryCache::mutex_;
+QHash<QString, FrameMemoryCache::Entry> FrameMemoryCache::map_;
+QHash<QString, QString> FrameMemoryCache::aliases_;
+std::list<QString> FrameMemoryCache::lru_;
+qint64 FrameMemoryCache::consumption_ = 0;
+
+qint64 FrameMemoryCache::GetLimit()
+{
+  return Config::Cached().memory_cache_limit;
+}
+
+FramePtr FrameMemoryCache::Get(const QString &filename)
+{
+  QMutexLocker locker(&mutex_);
+
+  // Resolve the path to the payload it refers to. Paths seen before skip the filesystem query.
+  QString identity = aliases_.value(filename);
+  bool new_alias = identity.isEmpty();
+  if (new_alias) {
+    identity = FileFunctions::GetHardLinkIdentity(filename);
+  }
+
+  auto it = map_.find(identity);
+  if (it == map_.end()) {
+    return nullptr;
+  }
+
+  if (new_alias) {
+    // A hard link of a payload another cache already loaded - serve the existing entry
+    aliases_.insert(filename, identity);
+    it->aliases.append(filename);
+  }
+
+  // Move to the back of the LRU
+  lru_.erase(it->lru_it);
+  it->lru_it = lru_.insert(lru_.end(), identity);
+
+  return it->frame;
+}
+
+void FrameMemoryCache::Push(const QString &filename, FramePtr frame)
+{
+  qint64 limit = GetLimit();
+
+  if (!frame || limit <= 0 || frame->allocated_size() > limit) {
+    return;
+  }
+
+  QMutexLocker locker(&mutex_);
+
+  QString identity = aliases_.value(filename);
+  if (identity.isEmpty()) {
+    identity = FileFunctions::GetHardLinkIdentity(filename);
+  }
+
+  auto it = map_.find(identity);
+  if (it != map_.end()) {
+    // The payload is already cached under another hard link - identical pixels by definition,
+    // so just record the new alias rather than holding them twice
+    if (!it->aliases.contains(filename)) {
+      it->aliases.append(filename);
+      aliases_.insert(filename, identity);
+    }
+
+    lru_.erase(it->lru_it);
+    it->lru_it = lru_.insert(lru_.end(), identity);
+
+    return;
+  }
+
+  consumption_ += frame->allocated_size();
+
+  while (consumption_ > limit && !lru_.empty()) {
+    auto oldest = map_.find(lru_.front());
+    consumption_ -= oldest->frame->allocated_size();
+    foreach (const QString &alias, oldest->aliases) {
+      aliases_.remove(alias);
+    }
+    map_.erase(oldest);
+    lru_.pop_front();
+  }
+
+  Entry e;
+  e.frame = frame;
+  e.lru_it = lru_.insert(lru_.end(), identity);
+  e.aliases.append(filename);
+  map_.insert(identity, e);
+  aliases_.insert(filename, identity);
+}
+
+void FrameMemoryCache::Remove(const QString &filename)
+{
+  QMutexLocker locker(&mutex_);
+
+  // The file may already be deleted by the time this is called, so the identity has to come
+  // from the alias table rather than the filesystem
+  QString identity = aliases_.take(filename);
+  if (identity.isEmpty()) {
+    return;
+  }
+
+  auto it = map_.find(identity);
+  if (it != map_.end()) {
+    it->aliases.removeOne(filename);
+
+    // Other hard links to the payload are still readable, so the entry only goes with its last
+    if (it->aliases.isEmpty()) {
+      consumption_ -= it->frame->allocated_size();
+      lru_.erase(it->lru_it);
+      map_.erase(it);
+    }
+  }
+}
+
+void FrameMemoryCache::Clear()
+{
+  QMutexLocker locker(&mutex_);
+
+  map_.clear();
+  aliases_.clear();
+  lru_.clear();
+  consumption_ = 0;
+}
+
+qint64 FrameMemoryCache::GetConsumption()
+{
+  QMutexLocker locker(&mutex_);
+
+  return consumption_;
+}
+
+}
@@ -0,0 +1,99 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef FRAMEMEMORYCACHE_H
+#define FRAMEMEMORYCACHE_H
+
+#include <list>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
+#include "codec/frame.h"
+
+namespace olive {
+
+/**
+ * @brief RAM-budgeted LRU of decoded cache frames, layered above the disk cache
+ *
+ * Scrubbing back and forth over the same range would otherwise re-read and re-decompress the
+ * same cache files from disk on every pass. Callers address frames by their cache filename
+ * (which encodes the cache UUID and timestamp), so the disk manager can invalidate entries
+ * whenever a cache file is rewritten or deleted.
+ *
+ * Internally, entries are stored per physical payload with the filenames as aliases, because
+ * identical frames are content-deduplicated into hard links on disk (see
+ * FrameHashCache::SaveCacheFrame). Two caches referencing the same payload - e.g. two open
+ * cuts of the same show - share one entry rather than holding the pixels twice.
+ *
+ * All methods are thread-safe - renders push/fetch from render threads while invalidation
+ * arrives from the main thread.
+ */
+class FrameMemoryCache
+{
+public:
+  /**
+   * @brief Retrieve a frame if cached, refreshing its position in the LRU
+   */
+  static FramePtr Get(const QString &filename);
+
+  /**
+   * @brief Insert a frame, evicting least-recently-used entries to stay within budget
+   */
+  static void Push(const QString &filename, FramePtr frame);
+
+  static void Remove(const QString &filename);
+
+  static void Clear();
+
+  /**
+   * @brief Bytes of frame data currently held by the cache
+   */
+  static qint64 GetConsumption();
+
+private:
+  struct Entry {
+    FramePtr frame;
+    std::list<QString>::iterator lru_it;
+
+    // Every filename known to refer to this payload
+    QVector<QString> aliases;
+  };
+
+  static qint64 GetLimit();
+
+  static QMutex mutex_;
+
+  // Keyed by payload identity (see FileFunctions::GetHardLinkIdentity)
+  static QHash<QString, Entry> map_;
+
+  // Filename -> payload identity, so invalidation works after the file is already gone
+  static QHash<QString, QString> aliases_;
+
+  // Most recently used at the back
+  static std::list<QString> lru_;
+
+  static qint64 consumption_;
+
+};
+
+}
+
+#endif // FRAMEMEMORYCACHE_H
@@ -43,6 +43,8 @@ public:
     input_alpha_association_ = kAlphaNone;
     clear_destination_ = true;
     force_opaque_ = false;
+    baked_lut_allowed_ = true;
+    shader_stub_ = QStringLiteral(":shaders/colormanage.frag");
   }
 
   ColorTransformJob(const NodeValueRow &row) :
@@ -99,6 +101,18 @@ public:
   bool GetForceOpaque() const { return force_opaque_; }
   void SetForceOpaque(bool e) { force_opaque_ = e; }
 
+  // Resource path of the wrapper shader the OCIO-generated code is pasted into. Alternate
+  // stubs let a caller fuse extra per-pixel work (e.g. the viewer's deinterlace) into the same
+  // pass; they must declare the same inputs as colormanage.frag plus their own.
+  const QString &GetShaderStub() const { return shader_stub_; }
+  void SetShaderStub(const QString &stub) { shader_stub_ = stub; }
+
+  // Whether this transform may be collapsed into a single baked 3D LUT (see config
+  // "BakedColorTransforms"). Cleared for final-quality renders so exports always run the full
+  // shader chain.
+  bool IsBakedLutAllowed() const { return baked_lut_allowed_; }
+  void SetBakedLutAllowed(bool e) { baked_lut_allowed_ = e; }
+
 private:
   ColorProcessorPtr processor_;
   QString id_;
@@ -120,6 +134,10 @@ private:
 
   bool force_opaque_;
 
+  bool baked_lut_allowed_;
+
+  QString shader_stub_;
+
 };
 
 }
@@ -29,7 +29,8 @@ class FootageJob : public AcceleratedJob
 {
 public:
   FootageJob() :
-    type_(Track::kNone)
+    type_(Track::kNone),
+    proxy_divider_(1)
   {
   }
 
@@ -39,7 +40,8 @@ public:
     filename_(filename),
     type_(type),
     length_(length),
-    loop_mode_(loop_mode)
+    loop_mode_(loop_mode),
+    proxy_divider_(1)
   {
   }
 
@@ -103,6 +105,22 @@ public:
   LoopMode loop_mode() const { return loop_mode_; }
   void set_loop_mode(LoopMode m) { loop_mode_ = m; }
 
+  const QString& proxy_filename() const
+  {
+    return proxy_filename_;
+  }
+
+  int proxy_divider() const
+  {
+    return proxy_divider_;
+  }
+
+  void set_proxy(const QString& filename, int divider)
+  {
+    proxy_filename_ = filename;
+    proxy_divider_ = divider;
+  }
+
 private:
   TimeRange time_;
 
@@ -122,6 +140,10 @@ private:
 
   LoopMode loop_mode_;
 
+  QString proxy_filename_;
+
+  int proxy_divider_;
+
 };
 
 }
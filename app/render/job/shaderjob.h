@@ -105,9 +105,29 @@ public:
     return vertex_overrides_;
   }
 
+  /**
+   * @brief Declare that this job is a simple per-pixel pass over one texture input
+   *
+   * `input` is the value key of the texture this shader samples. Jobs that set
+   * this may be fused with adjacent fusable jobs into a single blit by the
+   * renderer, so it should only be set by shaders that read their input
+   * texture with texture() calls and have no other side effects.
+   */
+  void SetFusableInput(const QString &input)
+  {
+    fusable_input_ = input;
+  }
+
+  const QString &GetFusableInput() const
+  {
+    return fusable_input_;
+  }
+
 private:
   QString shader_id_;
 
+  QString fusable_input_;
+
   int iterations_;
 
   QString iterative_input_;
@@ -0,0 +1,104 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "nodeprofiler.h"
+
+#include "node/node.h"
+
+namespace olive {
+
+NodeProfiler *NodeProfiler::instance_ = nullptr;
+
+NodeProfiler::NodeProfiler(QObject *parent) :
+  QObject(parent),
+  enabled_(false)
+{
+}
+
+NodeProfiler *NodeProfiler::instance()
+{
+  static QMutex instance_mutex;
+  QMutexLocker locker(&instance_mutex);
+
+  if (!instance_) {
+    instance_ = new NodeProfiler();
+  }
+
+  return instance_;
+}
+
+void NodeProfiler::SetEnabled(bool enabled)
+{
+  enabled_.storeRelaxed(enabled);
+}
+
+void NodeProfiler::AddTime(const Node *node, Category category, qint64 ns)
+{
+  if (!node) {
+    return;
+  }
+
+  QMutexLocker locker(&mutex_);
+
+  Stats &s = stats_[node];
+
+  if (s.label.isEmpty()) {
+    s.label = node->Name();
+
+    memset(s.time_ns, 0, sizeof(s.time_ns));
+    s.calls = 0;
+  }
+
+  s.time_ns[category] += ns;
+  s.calls++;
+
+  if (!watched_.contains(node)) {
+    watched_.insert(node);
+
+    // Direct connection so the entry is gone before the pointer can be reused
+    connect(node, &QObject::destroyed, this, &NodeProfiler::NodeDestroyed, Qt::DirectConnection);
+  }
+}
+
+QHash<const Node*, NodeProfiler::Stats> NodeProfiler::GetStats()
+{
+  QMutexLocker locker(&mutex_);
+
+  return stats_;
+}
+
+void NodeProfiler::Clear()
+{
+  QMutexLocker locker(&mutex_);
+
+  stats_.clear();
+}
+
+void NodeProfiler::NodeDestroyed(QObject *obj)
+{
+  QMutexLocker locker(&mutex_);
+
+  const Node *node = reinterpret_cast<const Node*>(obj);
+
+  stats_.remove(node);
+  watched_.remove(node);
+}
+
+}
@@ -0,0 +1,135 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef NODEPROFILER_H
+#define NODEPROFILER_H
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+
+namespace olive {
+
+class Node;
+
+/**
+ * @brief Aggregates per-node render cost so slow nodes can be found without bisecting
+ *
+ * When enabled (the profiler panel does this while it's open), NodeTraverser records the wall
+ * time of every shader blit, sample job and footage decode against the node that produced the
+ * job. Totals are cumulative; consumers poll GetStats() and diff against their previous
+ * snapshot to build a cost-over-time history.
+ *
+ * Collection is designed to be negligible when disabled - a single relaxed atomic load per
+ * job - so the hooks can stay in the hot path unconditionally.
+ */
+class NodeProfiler : public QObject
+{
+  Q_OBJECT
+public:
+  enum Category {
+    kShader,
+    kSamples,
+    kFootage,
+
+    kCategoryCount
+  };
+
+  struct Stats {
+    QString label;
+    qint64 time_ns[kCategoryCount];
+    qint64 calls;
+  };
+
+  static NodeProfiler *instance();
+
+  bool IsEnabled() const
+  {
+    return enabled_.loadRelaxed();
+  }
+
+  void SetEnabled(bool enabled);
+
+  /**
+   * @brief Record `ns` nanoseconds of work in `category` against `node`
+   */
+  void AddTime(const Node *node, Category category, qint64 ns);
+
+  /**
+   * @brief Return a snapshot of the cumulative stats per node
+   */
+  QHash<const Node*, Stats> GetStats();
+
+  void Clear();
+
+private:
+  explicit NodeProfiler(QObject *parent = nullptr);
+
+  static NodeProfiler *instance_;
+
+  QAtomicInt enabled_;
+
+  QMutex mutex_;
+
+  QHash<const Node*, Stats> stats_;
+
+  // Nodes whose destroyed signal we are already watching
+  QSet<const Node*> watched_;
+
+private slots:
+  void NodeDestroyed(QObject *obj);
+
+};
+
+/**
+ * @brief Times a scope and records it against a node when the profiler is enabled
+ */
+class NodeProfilerTimer
+{
+public:
+  NodeProfilerTimer(const Node *node, NodeProfiler::Category category) :
+    node_(node),
+    category_(category)
+  {
+    if (NodeProfiler::instance()->IsEnabled()) {
+      timer_.start();
+    }
+  }
+
+  ~NodeProfilerTimer()
+  {
+    if (timer_.isValid()) {
+      NodeProfiler::instance()->AddTime(node_, category_, timer_.nsecsElapsed());
+    }
+  }
+
+private:
+  const Node *node_;
+  NodeProfiler::Category category_;
+  QElapsedTimer timer_;
+
+};
+
+}
+
+#endif // NODEPROFILER_H
@@ -21,11 +21,16 @@
 #include "openglrenderer.h"
 
 #include <iostream>
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QDateTime>
 #include <QDebug>
+#include <QDir>
+#include <QFile>
 #include <QOpenGLExtraFunctions>
 
 #include "config/config.h"
+#include "render/diskmanager.h"
 
 namespace olive {
 
@@ -87,8 +92,19 @@ private:
 OpenGLRenderer::OpenGLRenderer(QObject* parent) :
   Renderer(parent),
   context_(nullptr),
-  framebuffer_(0)
+  framebuffer_(0),
+  next_download_pbo_(0),
+  next_pick_pbo_(0),
+  blit_timer_query_(nullptr)
 {
+  memset(download_pbos_, 0, sizeof(download_pbos_));
+
+  for (int i=0; i<kPickPBOCount; i++) {
+    pick_pbos_[i].buffer = 0;
+    pick_pbos_[i].format = PixelFormat::INVALID;
+    pick_pbos_[i].channel_count = 0;
+    pick_pbos_[i].pending = false;
+  }
 }
 
 OpenGLRenderer::~OpenGLRenderer()
@@ -162,6 +178,28 @@ void OpenGLRenderer::DestroyInternal()
   if (context_) {
     GL_PREAMBLE;
 
+    // Delete profiler timer query
+    delete blit_timer_query_;
+    blit_timer_query_ = nullptr;
+
+    // Delete download PBO ring
+    for (int i=0; i<kDownloadPBOCount; i++) {
+      if (download_pbos_[i].buffer) {
+        functions_->glDeleteBuffers(1, &download_pbos_[i].buffer);
+        download_pbos_[i].buffer = 0;
+        download_pbos_[i].size = 0;
+      }
+    }
+
+    // Delete pick PBO pair
+    for (int i=0; i<kPickPBOCount; i++) {
+      if (pick_pbos_[i].buffer) {
+        functions_->glDeleteBuffers(1, &pick_pbos_[i].buffer);
+        pick_pbos_[i].buffer = 0;
+        pick_pbos_[i].pending = false;
+      }
+    }
+
     // Delete framebuffer
     functions_->glDeleteFramebuffers(1, &framebuffer_);
     framebuffer_ = 0;
@@ -259,11 +297,17 @@ QVariant OpenGLRenderer::CreateNativeShader(ShaderCode code)
 
   PRINT_GL_ERRORS;
 
+  // Try restoring a binary persisted by a previous session before compiling from source
+  QString binary_filename = GetShaderBinaryFilename(code);
+
+  GLuint program = LoadShaderBinary(binary_filename);
+  if (program) {
+    return program;
+  }
+
   GLuint vert = CompileShader(GL_VERTEX_SHADER, code.vert_code());
   GLuint frag = CompileShader(GL_FRAGMENT_SHADER, code.frag_code());
 
-  GLuint program = 0;
-
   if (frag && vert) {
     program = functions_->glCreateProgram();
     functions_->glAttachShader(program, frag);
@@ -282,9 +326,93 @@ QVariant OpenGLRenderer::CreateNativeShader(ShaderCode code)
   functions_->glDeleteShader(frag);
   functions_->glDeleteShader(vert);
 
+  if (program) {
+    SaveShaderBinary(program, binary_filename);
+  }
+
   return program;
 }
 
+QString OpenGLRenderer::GetShaderBinaryFilename(const ShaderCode &code) const
+{
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(code.vert_code().toUtf8());
+  hash.addData(code.frag_code().toUtf8());
+
+  // Program binaries are driver-specific, so bind the key to the driver that produced them
+  hash.addData(QByteArray(reinterpret_cast<const char*>(functions_->glGetString(GL_VENDOR))));
+  hash.addData(QByteArray(reinterpret_cast<const char*>(functions_->glGetString(GL_RENDERER))));
+  hash.addData(QByteArray(reinterpret_cast<const char*>(functions_->glGetString(GL_VERSION))));
+
+  return QDir(DiskManager::GetShaderCachePath()).filePath(QString::fromLatin1(hash.result().toHex()).append(QStringLiteral(".bin")));
+}
+
+GLuint OpenGLRenderer::LoadShaderBinary(const QString &filename)
+{
+  GLint format_count = 0;
+  functions_->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+  if (format_count <= 0) {
+    // Driver doesn't support retrievable program binaries
+    return 0;
+  }
+
+  QFile f(filename);
+  if (!f.open(QFile::ReadOnly)) {
+    return 0;
+  }
+
+  QDataStream stream(&f);
+  quint32 binary_format = 0;
+  QByteArray binary;
+  stream >> binary_format >> binary;
+  if (stream.status() != QDataStream::Ok || binary.isEmpty()) {
+    return 0;
+  }
+
+  GLuint program = functions_->glCreateProgram();
+  context_->extraFunctions()->glProgramBinary(program, binary_format, binary.constData(), binary.size());
+
+  GLint success = 0;
+  functions_->glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if (!success) {
+    // Likely a driver update changed the binary format - recompile from source
+    functions_->glDeleteProgram(program);
+    return 0;
+  }
+
+  return program;
+}
+
+void OpenGLRenderer::SaveShaderBinary(GLuint program, const QString &filename)
+{
+  GLint format_count = 0;
+  functions_->glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &format_count);
+  if (format_count <= 0) {
+    return;
+  }
+
+  GLint length = 0;
+  functions_->glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) {
+    return;
+  }
+
+  QByteArray binary(length, 0);
+  GLenum binary_format = 0;
+  GLsizei written = 0;
+  context_->extraFunctions()->glGetProgramBinary(program, length, &written, &binary_format, binary.data());
+  if (written <= 0) {
+    return;
+  }
+  binary.resize(written);
+
+  QFile f(filename);
+  if (f.open(QFile::WriteOnly)) {
+    QDataStream stream(&f);
+    stream << quint32(binary_format) << binary;
+  }
+}
+
 void OpenGLRenderer::DestroyNativeShader(QVariant shader)
 {
   GL_PREAMBLE;
@@ -344,7 +472,61 @@ void OpenGLRenderer::DownloadFromTexture(const QVariant &id, const VideoParams &
 
   functions_->glPixelStorei(GL_PACK_ROW_LENGTH, linesize);
 
-  {
+  // Read back through a ring of PBOs so the driver DMAs into the buffer and
+  // we only wait on a fence for the transfer rather than a full pipeline
+  // flush. Consecutive downloads land in different buffers so back-to-back
+  // frames can pipeline.
+  QOpenGLExtraFunctions *xf = context_->extraFunctions();
+
+  int row_pixels = linesize > 0 ? linesize : p.effective_width();
+  int buffer_size = VideoParams::GetBytesPerPixel(p.format(), p.channel_count())
+      * row_pixels * p.effective_height();
+
+  DownloadPBO &pbo = download_pbos_[next_download_pbo_];
+  next_download_pbo_ = (next_download_pbo_ + 1) % kDownloadPBOCount;
+
+  if (!pbo.buffer) {
+    functions_->glGenBuffers(1, &pbo.buffer);
+  }
+
+  bool downloaded = false;
+
+  if (pbo.buffer) {
+    functions_->glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo.buffer);
+
+    if (pbo.size < buffer_size) {
+      functions_->glBufferData(GL_PIXEL_PACK_BUFFER, buffer_size, nullptr, GL_STREAM_READ);
+      pbo.size = buffer_size;
+    }
+
+    {
+      PRINT_GL_ERRORS;
+      functions_->glReadPixels(0,
+                               0,
+                               p.effective_width(),
+                               p.effective_height(),
+                               GetPixelFormat(p.channel_count()),
+                               GetPixelType(p.format()),
+                               nullptr);
+    }
+
+    // Wait only for the transfer to complete
+    static const GLuint64 kDownloadTimeout = 10000000000ULL; // 10s in ns
+    GLsync fence = xf->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    xf->glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kDownloadTimeout);
+    xf->glDeleteSync(fence);
+
+    if (void *mapped = xf->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, buffer_size, GL_MAP_READ_BIT)) {
+      memcpy(data, mapped, buffer_size);
+      xf->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+      downloaded = true;
+    }
+
+    functions_->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  }
+
+  if (!downloaded) {
+    // PBO path unavailable, fall back to a synchronous read
     PRINT_GL_ERRORS;
     functions_->glReadPixels(0,
                              0,
@@ -366,7 +548,7 @@ void OpenGLRenderer::Flush()
 {
   GL_PREAMBLE;
 
-  if (OLIVE_CONFIG("UseGLFinish").toBool()) {
+  if (Config::Cached().use_gl_finish) {
     functions_->glFinish();
   } else {
     functions_->glFlush();
@@ -375,22 +557,74 @@ void OpenGLRenderer::Flush()
 
 Color OpenGLRenderer::GetPixelFromTexture(Texture *texture, const QPointF &pt)
 {
-  AttachTextureAsDestination(texture->id());
+  QOpenGLExtraFunctions *xf = context_->extraFunctions();
+
+  // Issue this sample's readback into a PBO, which returns without draining the pipeline, and
+  // map the oldest in-flight sample, which has had time to complete. The picked color therefore
+  // trails the cursor by a couple of samples, which inspection tools don't notice, but sampling
+  // no longer costs a pipeline flush per mouse move during playback.
+  PickPBO &pbo = pick_pbos_[next_pick_pbo_];
+  next_pick_pbo_ = (next_pick_pbo_ + 1) % kPickPBOCount;
+
+  if (!pbo.buffer) {
+    functions_->glGenBuffers(1, &pbo.buffer);
+  }
+
+  if (!pbo.buffer) {
+    // PBO path unavailable, fall back to a synchronous read
+    AttachTextureAsDestination(texture->id());
+
+    QByteArray data(VideoParams::GetBytesPerPixel(texture->format(), texture->channel_count()), Qt::Uninitialized);
 
-  QByteArray data(VideoParams::GetBytesPerPixel(texture->format(), texture->channel_count()), Qt::Uninitialized);
+    functions_->glReadPixels(pt.x(), pt.y(), 1, 1, GetPixelFormat(texture->channel_count()), GetPixelType(texture->format()), data.data());
 
-  functions_->glReadPixels(pt.x(), pt.y(), 1, 1, GetPixelFormat(texture->channel_count()), GetPixelType(texture->format()), data.data());
+    Color c = Color::fromData(data.data(), texture->format(), texture->channel_count());
 
-  Color c = Color::fromData(data.data(), texture->format(), texture->channel_count());
+    if (texture->channel_count() == VideoParams::kRGBChannelCount) {
+      // No alpha channel, set to 1.0
+      c.set_alpha(1.0);
+    }
+
+    DetachTextureAsDestination();
+
+    return c;
+  }
+
+  // Decode the sample this buffer was last used for before overwriting it
+  if (pbo.pending) {
+    functions_->glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo.buffer);
 
-  if (texture->channel_count() == VideoParams::kRGBChannelCount) {
-    // No alpha channel, set to 1.0
-    c.set_alpha(1.0);
+    int size = VideoParams::GetBytesPerPixel(pbo.format, pbo.channel_count);
+    if (void *mapped = xf->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT)) {
+      last_picked_color_ = Color::fromData(reinterpret_cast<char*>(mapped), pbo.format, pbo.channel_count);
+
+      if (pbo.channel_count == VideoParams::kRGBChannelCount) {
+        // No alpha channel, set to 1.0
+        last_picked_color_.set_alpha(1.0);
+      }
+
+      xf->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+
+    functions_->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    pbo.pending = false;
   }
 
+  // Issue the readback for this sample without waiting on it
+  AttachTextureAsDestination(texture->id());
+
+  pbo.format = texture->format();
+  pbo.channel_count = texture->channel_count();
+
+  functions_->glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo.buffer);
+  functions_->glBufferData(GL_PIXEL_PACK_BUFFER, VideoParams::GetBytesPerPixel(pbo.format, pbo.channel_count), nullptr, GL_STREAM_READ);
+  functions_->glReadPixels(pt.x(), pt.y(), 1, 1, GetPixelFormat(pbo.channel_count), GetPixelType(pbo.format), nullptr);
+  functions_->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  pbo.pending = true;
+
   DetachTextureAsDestination();
 
-  return c;
+  return last_picked_color_;
 }
 
 struct TextureToBind {
@@ -402,6 +636,25 @@ void OpenGLRenderer::Blit(QVariant s, ShaderJob job, Texture *destination, Video
 {
   GL_PREAMBLE;
 
+  // Time the GPU work of this blit if the profiler is running
+  bool profiling = IsProfilerEnabled();
+  if (profiling) {
+    if (!blit_timer_query_) {
+      blit_timer_query_ = new QOpenGLTimerQuery(this);
+      if (!blit_timer_query_->create()) {
+        // Timer queries unsupported on this context
+        delete blit_timer_query_;
+        blit_timer_query_ = nullptr;
+      }
+    }
+
+    if (blit_timer_query_) {
+      blit_timer_query_->begin();
+    } else {
+      profiling = false;
+    }
+  }
+
   // If this node is iterative, we'll pick up which input here
   QMap<QString, GLuint> texture_index_map;
   QVector<TextureToBind> textures_to_bind;
@@ -672,6 +925,11 @@ void OpenGLRenderer::Blit(QVariant s, ShaderJob job, Texture *destination, Video
   vert_vbo_.destroy();
   vao_.release();
   vao_.destroy();
+
+  if (profiling) {
+    blit_timer_query_->end();
+    AddProfilerBlitTime(blit_timer_query_->waitForResult());
+  }
 }
 
 GLint OpenGLRenderer::GetInternalFormat(PixelFormat format, int channel_layout)
@@ -758,6 +1016,8 @@ GLenum OpenGLRenderer::GetPixelFormat(int channel_count)
   switch (channel_count) {
   case 1:
     return GL_RED;
+  case 2:
+    return GL_RG;
   case 3:
     return GL_RGB;
   case 4:
@@ -25,6 +25,7 @@
 #include <QOpenGLBuffer>
 #include <QOpenGLFunctions>
 #include <QOpenGLShader>
+#include <QOpenGLTimerQuery>
 #include <QOpenGLVertexArrayObject>
 #include <QThread>
 #include <QTimer>
@@ -93,6 +94,12 @@ private:
 
   GLuint CompileShader(GLenum type, const QString &code);
 
+  QString GetShaderBinaryFilename(const ShaderCode &code) const;
+
+  GLuint LoadShaderBinary(const QString &filename);
+
+  void SaveShaderBinary(GLuint program, const QString &filename);
+
   QOpenGLContext* context_;
 
   QOpenGLFunctions* functions_;
@@ -119,6 +126,39 @@ private:
 
   static const int kTextureCacheMaxSize;
 
+  // Ring of pixel buffer objects used for texture downloads so consecutive
+  // readbacks DMA into different buffers and can pipeline
+  static const int kDownloadPBOCount = 3;
+
+  struct DownloadPBO {
+    GLuint buffer;
+    int size;
+  };
+
+  DownloadPBO download_pbos_[kDownloadPBOCount];
+
+  int next_download_pbo_;
+
+  // Pair of single-pixel PBOs for cursor sampling, so the color picker reads back the previous
+  // sample while the current one is still in flight - see GetPixelFromTexture()
+  static const int kPickPBOCount = 2;
+
+  struct PickPBO {
+    GLuint buffer;
+    PixelFormat format;
+    int channel_count;
+    bool pending;
+  };
+
+  PickPBO pick_pbos_[kPickPBOCount];
+
+  int next_pick_pbo_;
+
+  Color last_picked_color_;
+
+  // Timer query used to measure GPU time per blit when the profiler is on
+  QOpenGLTimerQuery *blit_timer_query_;
+
 };
 
 }
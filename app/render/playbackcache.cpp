@@ -20,6 +20,12 @@
 
 #include "playbackcache.h"
 
+#include <algorithm>
+#include <map>
+
+#include <QtConcurrent/QtConcurrent>
+
+#include "common/filefunctions.h"
 #include "node/output/viewer/viewer.h"
 #include "node/project.h"
 #include "node/project/sequence/sequence.h"
@@ -27,6 +33,59 @@
 
 namespace olive {
 
+namespace {
+
+// Cache state files store many near-contiguous ranges, so rationals are written as zig-zag
+// varints of deltas from the previous position - a fully contiguous cache encodes each range
+// boundary in a couple of bytes instead of four fixed-size ints
+
+void WriteVarInt(QDataStream &s, qint64 value)
+{
+  quint64 u = (quint64(value) << 1) ^ quint64(value >> 63);
+
+  do {
+    quint8 b = u & 0x7F;
+    u >>= 7;
+
+    if (u) {
+      b |= 0x80;
+    }
+
+    s << b;
+  } while (u);
+}
+
+qint64 ReadVarInt(QDataStream &s)
+{
+  quint64 u = 0;
+  int shift = 0;
+  quint8 b;
+
+  do {
+    s >> b;
+    u |= quint64(b & 0x7F) << shift;
+    shift += 7;
+  } while ((b & 0x80) && shift < 64);
+
+  return qint64(u >> 1) ^ -qint64(u & 1);
+}
+
+void WriteRational(QDataStream &s, const rational &r)
+{
+  WriteVarInt(s, r.numerator());
+  WriteVarInt(s, r.denominator());
+}
+
+rational ReadRational(QDataStream &s)
+{
+  qint64 num = ReadVarInt(s);
+  qint64 den = ReadVarInt(s);
+
+  return rational(num, den);
+}
+
+}
+
 void PlaybackCache::Invalidate(const TimeRange &r)
 {
   if (r.in() == r.out()) {
@@ -42,7 +101,79 @@ void PlaybackCache::Invalidate(const TimeRange &r)
 
   InvalidateEvent(r);
 
-  emit Invalidated(r);
+  // Interactive edits (e.g. dragging a clip) invalidate many small overlapping ranges in one
+  // event-loop tick, and signalling each one separately churns redundant PreviewAutoCacher
+  // tickets and state saves. Our own state is updated synchronously above so queries stay
+  // correct; only the signal fan-out is coalesced. TimeRangeList merges overlapping ranges on
+  // insert, so one flush at the end of the tick emits the minimal set.
+  bool flush_scheduled = !pending_invalidated_.isEmpty();
+
+  pending_invalidated_.insert(r);
+
+  if (!flush_scheduled) {
+    QMetaObject::invokeMethod(this, &PlaybackCache::FlushInvalidated, Qt::QueuedConnection);
+  }
+}
+
+void PlaybackCache::Shift(const rational &from, const rational &to, qint64 shift_id)
+{
+  if (from == to) {
+    return;
+  }
+
+  if (shift_id >= 0 && shift_id == last_shift_id_) {
+    // Invalidation cascades can reach the same node through multiple graph paths, but the data
+    // must only move once per edit
+    return;
+  }
+  last_shift_id_ = shift_id;
+
+  ShiftTimeRangeList(&validated_, from, to);
+  ShiftTimeRangeList(&requested_, from, to);
+  ShiftTimeRangeList(&pending_invalidated_, from, to);
+  ShiftRangeVector(&passthroughs_, from, to);
+
+  ShiftEvent(from, to);
+
+  if (saving_enabled_) {
+    SaveState();
+  }
+}
+
+void PlaybackCache::ShiftTimeRangeList(TimeRangeList *list, const rational &from, const rational &to)
+{
+  const rational split = qMin(from, to);
+  const rational diff = to - from;
+
+  TimeRangeList shifted;
+
+  foreach (const TimeRange &r, *list) {
+    if (r.in() < split) {
+      shifted.insert(TimeRange(r.in(), qMin(r.out(), split)));
+    }
+
+    if (r.out() > from) {
+      shifted.insert(TimeRange(qMax(r.in(), from) + diff, r.out() + diff));
+    }
+  }
+
+  *list = shifted;
+}
+
+void PlaybackCache::ShiftEvent(const rational &from, const rational &to)
+{
+  Q_UNUSED(from)
+  Q_UNUSED(to)
+}
+
+void PlaybackCache::FlushInvalidated()
+{
+  TimeRangeList pending = pending_invalidated_;
+  pending_invalidated_.clear();
+
+  foreach (const TimeRange &r, pending) {
+    emit Invalidated(r);
+  }
 
   if (saving_enabled_) {
     SaveState();
@@ -66,6 +197,9 @@ QDir PlaybackCache::GetThisCacheDirectory(const QString &cache_path, const QUuid
 
 void PlaybackCache::LoadState()
 {
+  // Make sure we don't read a state file mid-write
+  state_write_future_.waitForFinished();
+
   QDir cache_dir = GetThisCacheDirectory();
   QFile f(cache_dir.filePath(QStringLiteral("state")));
 
@@ -120,6 +254,41 @@ void PlaybackCache::LoadState()
 
       break;
     }
+    case 2:
+    {
+      int valid_count, pass_count;
+
+      s >> valid_count;
+
+      rational prev;
+      for (int i=0; i<valid_count; i++) {
+        rational in = prev + ReadRational(s);
+        rational out = in + ReadRational(s);
+
+        validated_.insert(TimeRange(in, out));
+
+        prev = out;
+      }
+
+      s >> pass_count;
+
+      prev = rational();
+      for (int i=0; i<pass_count; i++) {
+        rational in = prev + ReadRational(s);
+        rational out = in + ReadRational(s);
+
+        QUuid id;
+        s >> id;
+
+        Passthrough p = TimeRange(in, out);
+        p.cache = id;
+        passthroughs_.push_back(p);
+
+        prev = out;
+      }
+
+      break;
+    }
     }
 
     f.close();
@@ -134,43 +303,89 @@ void PlaybackCache::SaveState()
     return;
   }
 
-  QDir cache_dir = GetThisCacheDirectory();
-  QFile f(cache_dir.filePath(QStringLiteral("state")));
-  if (validated_.isEmpty() && passthroughs_.empty()) {
-    if (f.exists()) {
-      f.remove();
+  // Serialize in memory only - the disk write happens on a worker so that validating frames
+  // during heavy caching never stalls the main thread on I/O
+  QByteArray state;
+
+  if (!validated_.isEmpty() || !passthroughs_.empty()) {
+    QDataStream s(&state, QIODevice::WriteOnly);
+
+    uint32_t version = 2;
+    s << version;
+
+    SaveStateEvent(s);
+
+    // Sort ranges so the delta encoding sees small, mostly-contiguous steps
+    std::vector<TimeRange> sorted(validated_.begin(), validated_.end());
+    std::sort(sorted.begin(), sorted.end(), [](const TimeRange &a, const TimeRange &b){
+      return a.in() < b.in();
+    });
+
+    // Using "int" for backwards compatibility with when we used QVector, could potentially overflow
+    s << int(sorted.size());
+
+    rational prev;
+    for (const TimeRange &r : sorted) {
+      WriteRational(s, r.in() - prev);
+      WriteRational(s, r.out() - r.in());
+      prev = r.out();
     }
-  } else {
-    if (FileFunctions::DirectoryIsValid(cache_dir)) {
-      if (f.open(QFile::WriteOnly)) {
-        QDataStream s(&f);
 
-        uint32_t version = 1;
-        s << version;
+    // Using "int" for backwards compatibility with when we used QVector, could potentially overflow
+    s << int(passthroughs_.size());
+
+    prev = rational();
+    for (const Passthrough &p : passthroughs_) {
+      WriteRational(s, p.in() - prev);
+      WriteRational(s, p.out() - p.in());
+      s << p.cache;
+      prev = p.out();
+    }
+  }
+
+  // Queue the snapshot for the background writer, replacing any snapshot still waiting - only
+  // the latest state needs to reach disk
+  QMutexLocker locker(&state_write_mutex_);
+
+  pending_state_ = state;
+  pending_state_dir_ = GetThisCacheDirectory().absolutePath();
+  has_pending_state_ = true;
+
+  if (!state_write_active_) {
+    state_write_active_ = true;
+    state_write_future_ = QtConcurrent::run([this]{ WriteStateLoop(); });
+  }
+}
 
-        SaveStateEvent(s);
+void PlaybackCache::WriteStateLoop()
+{
+  while (true) {
+    QByteArray state;
+    QString dir;
 
-        // Using "int" for backwards compatibility with when we used QVector, could potentially overflow
-        s << int(validated_.size());
+    {
+      QMutexLocker locker(&state_write_mutex_);
 
-        for (const TimeRange &r : validated_) {
-          s << r.in().numerator();
-          s << r.in().denominator();
-          s << r.out().numerator();
-          s << r.out().denominator();
-        }
+      if (!has_pending_state_) {
+        state_write_active_ = false;
+        return;
+      }
 
-        // Using "int" for backwards compatibility with when we used QVector, could potentially overflow
-        s << int(passthroughs_.size());
+      state = pending_state_;
+      dir = pending_state_dir_;
+      has_pending_state_ = false;
+    }
 
-        for (const Passthrough &p : passthroughs_) {
-          s << p.in().numerator();
-          s << p.in().denominator();
-          s << p.out().numerator();
-          s << p.out().denominator();
-          s << p.cache;
-        }
+    QDir cache_dir(dir);
+    QFile f(cache_dir.filePath(QStringLiteral("state")));
 
+    if (state.isEmpty()) {
+      if (f.exists()) {
+        f.remove();
+      }
+    } else if (FileFunctions::DirectoryIsValid(cache_dir)) {
+      if (f.open(QFile::WriteOnly)) {
+        f.write(state);
         f.close();
 
         last_loaded_state_ = f.fileTime(QFileDevice::FileModificationTime).toMSecsSinceEpoch();
@@ -258,11 +473,20 @@ Project *PlaybackCache::GetProject() const
 PlaybackCache::PlaybackCache(QObject *parent) :
   QObject(parent),
   saving_enabled_(true),
+  last_shift_id_(-1),
+  has_pending_state_(false),
+  state_write_active_(false),
   last_loaded_state_(0)
 {
   uuid_ = QUuid::createUuid();
 }
 
+PlaybackCache::~PlaybackCache()
+{
+  // Let any in-flight state write finish before our members disappear under it
+  state_write_future_.waitForFinished();
+}
+
 void PlaybackCache::SetUuid(const QUuid &u)
 {
   uuid_ = u;
@@ -279,14 +503,46 @@ TimeRangeList PlaybackCache::GetInvalidatedRanges(TimeRange intersecting) const
   intersecting.set_out(qMax(rational(0), intersecting.out()));
   intersecting.set_in(qMax(rational(0), intersecting.in()));
 
-  invalidated.insert(intersecting);
+  // Sweep an ordered boundary map of everything covering this range rather than calling
+  // remove() once per covered range, which is quadratic in the number of cache fragments
+  std::map<rational, int> boundaries;
+
+  auto cover = [&boundaries, &intersecting](const TimeRange &range) {
+    rational in = qMax(range.in(), intersecting.in());
+    rational out = qMin(range.out(), intersecting.out());
+
+    if (in < out) {
+      boundaries[in]++;
+      boundaries[out]--;
+    }
+  };
 
   foreach (const TimeRange &range, validated_) {
-    invalidated.remove(range);
+    cover(range);
   }
 
   foreach (const TimeRange &range, passthroughs_) {
-    invalidated.remove(range);
+    cover(range);
+  }
+
+  // Everything between covered spans is invalidated
+  rational pos = intersecting.in();
+  int depth = 0;
+
+  for (auto it=boundaries.cbegin(); it!=boundaries.cend(); it++) {
+    if (depth == 0 && it->first > pos) {
+      invalidated.insert(TimeRange(pos, it->first));
+    }
+
+    depth += it->second;
+
+    if (depth == 0) {
+      pos = it->first;
+    }
+  }
+
+  if (pos < intersecting.out()) {
+    invalidated.insert(TimeRange(pos, intersecting.out()));
   }
 
   return invalidated;
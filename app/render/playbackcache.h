@@ -21,8 +21,11 @@
 #ifndef PLAYBACKCACHE_H
 #define PLAYBACKCACHE_H
 
+#include <atomic>
+
 #include <olive/core/core.h>
 #include <QDir>
+#include <QFuture>
 #include <QMutex>
 #include <QObject>
 #include <QPainter>
@@ -44,6 +47,8 @@ class PlaybackCache : public QObject
 public:
   PlaybackCache(QObject* parent = nullptr);
 
+  virtual ~PlaybackCache() override;
+
   const QUuid &GetUuid() const { return uuid_; }
   void SetUuid(const QUuid &u);
 
@@ -63,6 +68,16 @@ public:
 
   void Invalidate(const TimeRange& r);
 
+  /**
+   * @brief Move all cached data at or after `from` so that it begins at `to` instead
+   *
+   * Timeline edits that slide otherwise unchanged content in time (ripple deletes, trims,
+   * slides) use this so existing validated state survives the edit instead of being discarded
+   * and re-rendered. `shift_id` deduplicates a shift arriving through multiple graph paths -
+   * each ID is applied at most once per cache.
+   */
+  void Shift(const rational &from, const rational &to, qint64 shift_id = -1);
+
   bool HasValidatedRanges() const { return !validated_.isEmpty(); }
   const TimeRangeList &GetValidatedRanges() const { return validated_; }
 
@@ -117,6 +132,9 @@ public slots:
 
   void Request(ViewerOutput *context, const TimeRange &r);
 
+private slots:
+  void FlushInvalidated();
+
 signals:
   void Invalidated(const TimeRange& r);
 
@@ -131,6 +149,48 @@ protected:
 
   virtual void InvalidateEvent(const TimeRange& range);
 
+  /**
+   * @brief Subclasses with actual data storage apply Shift()'s transform to it here
+   */
+  virtual void ShiftEvent(const rational &from, const rational &to);
+
+  /**
+   * @brief Apply Shift()'s time transform to a list of ranges
+   */
+  static void ShiftTimeRangeList(TimeRangeList *list, const rational &from, const rational &to);
+
+  /**
+   * @brief Apply Shift()'s time transform to a vector of TimeRange-derived entries
+   *
+   * Entries straddling the edit point are split so any extra data they carry (e.g. passthrough
+   * handles) is preserved on both sides.
+   */
+  template <typename T>
+  static void ShiftRangeVector(std::vector<T> *vec, const rational &from, const rational &to)
+  {
+    const rational split = qMin(from, to);
+    const rational diff = to - from;
+
+    std::vector<T> shifted;
+    shifted.reserve(vec->size());
+
+    for (const T &r : *vec) {
+      if (r.in() < split) {
+        T pre = r;
+        pre.set_range(r.in(), qMin(r.out(), split));
+        shifted.push_back(pre);
+      }
+
+      if (r.out() > from) {
+        T post = r;
+        post.set_range(qMax(r.in(), from) + diff, r.out() + diff);
+        shifted.push_back(post);
+      }
+    }
+
+    *vec = std::move(shifted);
+  }
+
   virtual void LoadStateEvent(QDataStream &stream){}
 
   virtual void SaveStateEvent(QDataStream &stream){}
@@ -138,8 +198,19 @@ protected:
   Project* GetProject() const;
 
 private:
+  /**
+   * @brief Write queued state snapshots to disk until none are pending
+   *
+   * Runs on a worker thread; at most one instance is active per cache, and only the most recent
+   * snapshot is kept while a write is in flight.
+   */
+  void WriteStateLoop();
+
   TimeRangeList validated_;
 
+  // Invalidations waiting to be signalled in one merged batch at the end of the tick
+  TimeRangeList pending_invalidated_;
+
   TimeRangeList requested_;
   ViewerOutput *request_context_;
 
@@ -147,11 +218,22 @@ private:
 
   bool saving_enabled_;
 
+  qint64 last_shift_id_;
+
   QMutex mutex_;
 
   std::vector<Passthrough> passthroughs_;
 
-  qint64 last_loaded_state_;
+  // State persistence happens on a worker thread - SaveState() only serializes in memory and
+  // queues the snapshot here, so validating frames during heavy caching never stalls on disk
+  QMutex state_write_mutex_;
+  QByteArray pending_state_;
+  QString pending_state_dir_;
+  bool has_pending_state_;
+  bool state_write_active_;
+  QFuture<void> state_write_future_;
+
+  std::atomic<qint64> last_loaded_state_;
 
 };
 
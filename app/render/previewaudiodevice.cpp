@@ -22,10 +22,19 @@
 
 namespace olive {
 
+// Several seconds of audio at any common parameters, so the producer only overflows if it gets
+// drastically ahead of realtime. Must be a power of two for the index masking below.
+const qint64 kRingSize = 4 * 1024 * 1024;
+
 PreviewAudioDevice::PreviewAudioDevice(QObject *parent) :
+  write_pos_(0),
+  read_pos_(0),
+  clear_pos_(0),
+  underruns_(0),
   notify_interval_(0),
   bytes_read_(0)
 {
+  ring_.resize(kRingSize);
 }
 
 PreviewAudioDevice::~PreviewAudioDevice()
@@ -40,23 +49,48 @@ bool PreviewAudioDevice::isSequential() const
 
 qint64 PreviewAudioDevice::readData(char *data, qint64 maxSize)
 {
-  QMutexLocker locker(&lock_);
+  // Runs on the audio callback thread, so this must never block or allocate
+
+  quint64 read_pos = read_pos_.load(std::memory_order_relaxed);
+
+  // Apply any clear() the UI thread published by discarding everything queued before it
+  quint64 clear_pos = clear_pos_.load(std::memory_order_acquire);
+  if (read_pos < clear_pos) {
+    read_pos = clear_pos;
+    bytes_read_ = 0;
+  }
+
+  quint64 write_pos = write_pos_.load(std::memory_order_acquire);
 
-  qint64 copy_length = qMin(maxSize, qint64(buffer_.size()));
+  qint64 copy_length = qMin(maxSize, qint64(write_pos - read_pos));
 
   if (copy_length) {
+    // Copy out, wrapping around the end of the ring if necessary
+    qint64 ring_index = read_pos & (kRingSize - 1);
+    qint64 first_chunk = qMin(copy_length, kRingSize - ring_index);
+    memcpy(data, ring_.constData() + ring_index, first_chunk);
+    if (first_chunk < copy_length) {
+      memcpy(data + first_chunk, ring_.constData(), copy_length - first_chunk);
+    }
+
     qint64 new_bytes_read = bytes_read_ + copy_length;
 
-    if (notify_interval_ > 0) {
-      if ((bytes_read_ / notify_interval_) != (new_bytes_read / notify_interval_)) {
+    qint64 notify_interval = notify_interval_.load(std::memory_order_relaxed);
+    if (notify_interval > 0) {
+      if ((bytes_read_ / notify_interval) != (new_bytes_read / notify_interval)) {
         emit Notify();
       }
     }
 
     bytes_read_ = new_bytes_read;
 
-    memcpy(data, buffer_.constData(), copy_length);
-    buffer_ = buffer_.mid(copy_length);
+    read_pos_.store(read_pos + copy_length, std::memory_order_release);
+
+    if (copy_length < maxSize) {
+      // We had audio queued but not as much as the device needed, i.e. playback starved. An
+      // empty queue isn't counted because that's the normal state when nothing is playing.
+      underruns_.fetch_add(1, std::memory_order_relaxed);
+    }
   }
 
   return copy_length;
@@ -64,19 +98,36 @@ qint64 PreviewAudioDevice::readData(char *data, qint64 maxSize)
 
 qint64 PreviewAudioDevice::writeData(const char *data, qint64 length)
 {
-  QMutexLocker locker(&lock_);
+  quint64 write_pos = write_pos_.load(std::memory_order_relaxed);
+  quint64 read_pos = read_pos_.load(std::memory_order_acquire);
+
+  qint64 space = kRingSize - qint64(write_pos - read_pos);
 
-  buffer_.append(data, length);
+  qint64 copy_length = qMin(length, space);
 
-  return length;
+  if (copy_length) {
+    qint64 ring_index = write_pos & (kRingSize - 1);
+    qint64 first_chunk = qMin(copy_length, kRingSize - ring_index);
+    memcpy(ring_.data() + ring_index, data, first_chunk);
+    if (first_chunk < copy_length) {
+      memcpy(ring_.data(), data + first_chunk, copy_length - first_chunk);
+    }
+
+    write_pos_.store(write_pos + copy_length, std::memory_order_release);
+  }
+
+  if (copy_length < length) {
+    qWarning() << "Preview audio ring buffer overflowed, dropped" << (length - copy_length) << "bytes";
+  }
+
+  return copy_length;
 }
 
 void PreviewAudioDevice::clear()
 {
-  QMutexLocker locker(&lock_);
-
-  buffer_.clear();
-  bytes_read_ = 0;
+  // The read position belongs to the consumer, so rather than touching it we publish a
+  // position the callback should skip ahead to the next time it runs
+  clear_pos_.store(write_pos_.load(std::memory_order_relaxed), std::memory_order_release);
 }
 
 }
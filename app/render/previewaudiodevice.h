@@ -21,10 +21,19 @@
 #ifndef PREVIEWAUDIODEVICE_H
 #define PREVIEWAUDIODEVICE_H
 
+#include <atomic>
+
 #include "previewautocacher.h"
 
 namespace olive {
 
+/**
+ * @brief Queue of PCM data between the render/UI thread and the audio output callback
+ *
+ * Internally this is a single-producer single-consumer lock-free ring buffer. The consumer is
+ * PortAudio's realtime callback, which must never wait on a mutex the UI thread might be
+ * holding through a paint event, so the two sides coordinate purely through atomic positions.
+ */
 class PreviewAudioDevice : public QIODevice
 {
   Q_OBJECT
@@ -53,7 +62,15 @@ public:
 
   void set_notify_interval(qint64 i)
   {
-    notify_interval_ = i;
+    notify_interval_.store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Number of times the audio callback found less data queued than it needed
+   */
+  qint64 underrun_count() const
+  {
+    return underruns_.load(std::memory_order_relaxed);
   }
 
   void clear();
@@ -62,13 +79,31 @@ signals:
   void Notify();
 
 private:
-  QMutex lock_;
+  /**
+   * @brief Ring storage, allocated once in the constructor (size must be a power of two)
+   */
+  QByteArray ring_;
 
-  QByteArray buffer_;
+  /**
+   * @brief Total bytes ever written, advanced only by the producer
+   */
+  std::atomic<quint64> write_pos_;
 
-  int bytes_per_frame_;
+  /**
+   * @brief Total bytes ever read, advanced only by the consumer
+   */
+  std::atomic<quint64> read_pos_;
 
-  qint64 notify_interval_;
+  /**
+   * @brief Position up to which the consumer should discard, published by clear()
+   */
+  std::atomic<quint64> clear_pos_;
+
+  std::atomic<qint64> underruns_;
+
+  std::atomic<qint64> notify_interval_;
+
+  int bytes_per_frame_;
 
   qint64 bytes_read_;
 
@@ -21,12 +21,18 @@
 #include "previewautocacher.h"
 
 #include <QApplication>
+#include <QDateTime>
+#include <QPointer>
 #include <QtConcurrent/QtConcurrent>
 
 #include "codec/conformmanager.h"
+#include "common/mainthreadqueue.h"
+#include "node/block/gap/gap.h"
+#include "node/block/transition/transition.h"
 #include "node/input/multicam/multicamnode.h"
 #include "node/inputdragger.h"
 #include "node/project.h"
+#include "node/project/sequence/sequence.h"
 #include "render/diskmanager.h"
 #include "render/rendermanager.h"
 
@@ -35,13 +41,17 @@ namespace olive {
 PreviewAutoCacher::PreviewAutoCacher(QObject *parent) :
   QObject(parent),
   project_(nullptr),
+  has_visible_range_(false),
   use_custom_range_(false),
   pause_renders_(false),
   pause_thumbnails_(false),
   single_frame_render_(nullptr),
   display_color_processor_(nullptr),
   multicam_(nullptr),
-  ignore_cache_requests_(false)
+  ignore_cache_requests_(false),
+  divider_override_(0),
+  sweep_context_(nullptr),
+  last_interactive_render_(0)
 {
   copier_ = new ProjectCopier(this);
   connect(copier_, &ProjectCopier::AddedNode, this, &PreviewAutoCacher::ConnectToNodeCache);
@@ -57,6 +67,8 @@ PreviewAutoCacher::PreviewAutoCacher(QObject *parent) :
 
   // Catch when a conform is ready
   connect(ConformManager::instance(), &ConformManager::ConformReady, this, &PreviewAutoCacher::ConformFinished);
+
+  connect(&sweep_timer_, &QTimer::timeout, this, &PreviewAutoCacher::SweepTick);
 }
 
 PreviewAutoCacher::~PreviewAutoCacher()
@@ -85,15 +97,19 @@ RenderTicketPtr PreviewAutoCacher::GetSingleFrame(Node *n, ViewerOutput *viewer,
 
   // Queue it and try to render
   single_frame_render_ = sfr;
+
+  // Mark interactive activity so the sequence sweep backs off
+  last_interactive_render_ = QDateTime::currentMSecsSinceEpoch();
+
   TryRender();
 
   return sfr;
 }
 
-RenderTicketPtr PreviewAutoCacher::GetRangeOfAudio(ViewerOutput *viewer, TimeRange range)
+RenderTicketPtr PreviewAutoCacher::GetRangeOfAudio(ViewerOutput *viewer, TimeRange range, bool prioritize)
 {
   Node *copy = copier_->GetCopy(viewer->GetConnectedSampleOutput());
-  return RenderAudio(copy, viewer, range, nullptr);
+  return RenderAudio(copy, viewer, range, nullptr, prioritize);
 }
 
 void PreviewAutoCacher::ClearSingleFrameRenders()
@@ -187,17 +203,31 @@ void PreviewAutoCacher::AudioRendered()
 
         bool incomplete = watcher->GetTicket()->property("incomplete").toBool();
 
-        if (AudioPlaybackCache *pcm = dynamic_cast<AudioPlaybackCache*>(cache)) {
-          // WritePCM is tolerant to its buffer being null, it will just write silence instead
-          pcm->SetParameters(buf.audio_params());
-          pcm->WritePCM(range,
-                        valid_ranges,
-                        watcher->Get().value<SampleBuffer>());
-        } else if (AudioWaveformCache *wave = dynamic_cast<AudioWaveformCache*>(cache)) {
-          wave->SetParameters(buf.audio_params());
-          if (!incomplete) {
-            wave->WriteWaveform(range, valid_ranges, &waveform);
+        if (incomplete) {
+          // Keep incomplete results synchronous so the Invalidate()/conform handling below
+          // can't race a deferred write
+          if (AudioPlaybackCache *pcm = dynamic_cast<AudioPlaybackCache*>(cache)) {
+            // WritePCM is tolerant to its buffer being null, it will just write silence instead
+            pcm->SetParameters(buf.audio_params());
+            pcm->WritePCM(range, valid_ranges, buf);
+          } else if (AudioWaveformCache *wave = dynamic_cast<AudioWaveformCache*>(cache)) {
+            wave->SetParameters(buf.audio_params());
           }
+        } else {
+          // Defer the merge into the cache - when many results arrive at once (e.g. after a
+          // conform finishes), running every write back-to-back is exactly the kind of
+          // unbounded main-thread burst MainThreadQueue exists to slice up
+          QPointer<PlaybackCache> cache_guard(cache);
+          MainThreadQueue::instance()->Add([cache_guard, range, valid_ranges, waveform, buf]() mutable {
+            if (AudioPlaybackCache *pcm = dynamic_cast<AudioPlaybackCache*>(cache_guard.data())) {
+              // WritePCM is tolerant to its buffer being null, it will just write silence instead
+              pcm->SetParameters(buf.audio_params());
+              pcm->WritePCM(range, valid_ranges, buf);
+            } else if (AudioWaveformCache *wave = dynamic_cast<AudioWaveformCache*>(cache_guard.data())) {
+              wave->SetParameters(buf.audio_params());
+              wave->WriteWaveform(range, valid_ranges, &waveform);
+            }
+          });
         }
 
         if (incomplete) {
@@ -368,12 +398,61 @@ void PreviewAutoCacher::StartCachingVideoRange(ViewerOutput *context, PlaybackCa
 
   cache->ClearRequestRange(range);
 
-  TimeRangeListFrameIterator iterator({range}, using_tb);
-  pending_video_jobs_.push_back({node, context, cache, range, iterator});
-  video_cache_data_[cache].job_tracker.insert(TimeRange(iterator.Snap(range.in()), range.out()), copier_->GetGraphChangeTime());
+  auto queue_job = [this, node, context, cache, &using_tb](const TimeRange &r, bool transition) {
+    TimeRangeListFrameIterator iterator({r}, using_tb);
+    pending_video_jobs_.push_back({node, context, cache, r, iterator, transition});
+    video_cache_data_[cache].job_tracker.insert(TimeRange(iterator.Snap(r.in()), r.out()), copier_->GetGraphChangeTime());
+  };
+
+  // Transition spans are queued as their own jobs so GetClosestVideoJobToPlayhead() can schedule
+  // them ahead of the surrounding clip interiors - they're where playback stutters show first
+  TimeRangeList transition_spans = GetTransitionSpans(context, range);
+
+  if (transition_spans.isEmpty()) {
+    queue_job(range, false);
+  } else {
+    TimeRangeList remainder;
+    remainder.insert(range);
+
+    for (const TimeRange &span : transition_spans) {
+      remainder.remove(span);
+      queue_job(span, true);
+    }
+
+    for (const TimeRange &r : remainder) {
+      queue_job(r, false);
+    }
+  }
+
   TryRender();
 }
 
+TimeRangeList PreviewAutoCacher::GetTransitionSpans(ViewerOutput *context, const TimeRange &range)
+{
+  TimeRangeList spans;
+
+  if (Sequence *sequence = dynamic_cast<Sequence*>(context)) {
+    foreach (Track *track, sequence->track_list(Track::kVideo)->GetTracks()) {
+      foreach (Block *block, track->Blocks()) {
+        if (block->out() <= range.in()) {
+          continue;
+        }
+
+        if (block->in() >= range.out()) {
+          // Blocks are in time order, nothing beyond this one can overlap
+          break;
+        }
+
+        if (block->is_enabled() && dynamic_cast<TransitionBlock*>(block)) {
+          spans.insert(TimeRange(qMax(block->in(), range.in()), qMin(block->out(), range.out())));
+        }
+      }
+    }
+  }
+
+  return spans;
+}
+
 void PreviewAutoCacher::StartCachingAudioRange(ViewerOutput *context, PlaybackCache *cache, const TimeRange &range)
 {
   Node *node = cache->parent();
@@ -423,12 +502,72 @@ void PreviewAutoCacher::AudioInvalidatedFromNode(ViewerOutput *context, Playback
 
 void PreviewAutoCacher::SetPlayhead(const rational &playhead)
 {
+  playhead_ = playhead;
+
   cache_range_ = TimeRange(playhead - OLIVE_CONFIG("DiskCacheBehind").value<rational>(),
                            playhead + OLIVE_CONFIG("DiskCacheAhead").value<rational>());
 
   TryRender();
 }
 
+std::list<PreviewAutoCacher::VideoJob>::iterator PreviewAutoCacher::GetClosestVideoJobToPlayhead()
+{
+  auto best = pending_video_jobs_.begin();
+  rational best_distance;
+  bool first = true;
+
+  for (auto it=pending_video_jobs_.begin(); it!=pending_video_jobs_.end(); it++) {
+    rational distance;
+
+    if (it->range.Contains(playhead_)) {
+      distance = rational(0);
+    } else if (playhead_ < it->range.in()) {
+      distance = it->range.in() - playhead_;
+    } else {
+      distance = playhead_ - it->range.out();
+    }
+
+    if (has_visible_range_ && dynamic_cast<ThumbnailCache*>(it->cache)) {
+      // Thumbnails are judged against the on-screen portion of the timeline rather than just the
+      // playhead, so the clips the user is looking at fill in first
+      rational visible_distance;
+
+      if (it->range.OverlapsWith(visible_range_)) {
+        visible_distance = rational(0);
+      } else if (it->range.out() < visible_range_.in()) {
+        visible_distance = visible_range_.in() - it->range.out();
+      } else {
+        visible_distance = it->range.in() - visible_range_.out();
+      }
+
+      distance = qMin(distance, visible_distance);
+    }
+
+    if (!IsContextVisible(it->context)) {
+      // Deprioritize sequences hidden behind tabs so interactive horsepower stays on what the
+      // user is editing. If no widget has registered visibility at all, every job carries the
+      // same penalty and the ordering is unchanged.
+      static const rational kHiddenContextPenalty(3600);
+      distance += kHiddenContextPenalty;
+    }
+
+    if (!it->transition_priority) {
+      // Transition spans fill in ahead of clip interiors within the working area - they're
+      // invalidated by a touch of either adjoining clip and stutter most visibly uncached
+      static const rational kNonTransitionPenalty(120);
+      distance += kNonTransitionPenalty;
+    }
+
+    if (first || distance < best_distance) {
+      best = it;
+      best_distance = distance;
+      first = false;
+    }
+  }
+
+  return best;
+}
+
 template<typename T>
 void CancelTasks(const T &task_list, bool and_wait)
 {
@@ -478,6 +617,22 @@ void PreviewAutoCacher::SetThumbnailsPaused(bool e)
   }
 }
 
+void PreviewAutoCacher::SetContextVisibility(ViewerOutput *context, bool visible)
+{
+  if (visible) {
+    visible_context_counts_[context]++;
+
+    // This context's jobs may have been waiting behind visible ones, kick the queue
+    TryRender();
+  } else {
+    int &count = visible_context_counts_[context];
+    count--;
+    if (count <= 0) {
+      visible_context_counts_.remove(context);
+    }
+  }
+}
+
 void PreviewAutoCacher::TryRender()
 {
   delayed_requeue_timer_.stop();
@@ -519,13 +674,17 @@ void PreviewAutoCacher::TryRender()
   }
 
   if (!pause_renders_) {
-    // Completely arbitrary number. I don't know what's optimal for this yet.
-    const int max_tasks = 4;
+    // Background concurrency backs off while interactive renders are slow so scrubbing stays
+    // responsive - see RenderManager::GetBackgroundTicketLimit()
+    const int max_tasks = RenderManager::instance()->GetBackgroundTicketLimit();
 
     // Handle video tasks
     if (!pause_thumbnails_) {
       while (!pending_video_jobs_.empty()) {
-        VideoJob &d = pending_video_jobs_.front();
+        // Always work on the job nearest the playhead so the frames we're about to watch are
+        // cached first
+        auto job = GetClosestVideoJobToPlayhead();
+        VideoJob &d = *job;
 
         if (Node *copy = copier_->GetCopy(d.node)) {
           // Queue next frames
@@ -546,14 +705,23 @@ void PreviewAutoCacher::TryRender()
         if (d.iterator.HasNext()) {
           break;
         } else {
-          pending_video_jobs_.pop_front();
+          pending_video_jobs_.erase(job);
         }
       }
     }
 
     // Handle audio tasks
     while (!pending_audio_jobs_.empty() && running_audio_tasks_.size() < max_tasks) {
-      AudioJob &d = pending_audio_jobs_.front();
+      // Prefer audio work for contexts that are actually on screen
+      auto job_it = pending_audio_jobs_.begin();
+      for (auto it=pending_audio_jobs_.begin(); it!=pending_audio_jobs_.end(); it++) {
+        if (IsContextVisible(it->context)) {
+          job_it = it;
+          break;
+        }
+      }
+
+      AudioJob &d = *job_it;
 
       bool pop = true;
 
@@ -614,6 +782,11 @@ RenderTicketWatcher* PreviewAutoCacher::RenderFrame(Node *node, ViewerOutput *co
     rvp.AddCache(frame_cache);
   }
 
+  if (!cache && divider_override_ > 0) {
+    // The viewer has requested a temporary quality reduction for interactive frames
+    rvp.video_params.set_divider(divider_override_);
+  }
+
   rvp.return_type = dry ? RenderManager::kNull : RenderManager::kTexture;
 
   // Allow using cached images for this render job
@@ -627,7 +800,7 @@ RenderTicketWatcher* PreviewAutoCacher::RenderFrame(Node *node, ViewerOutput *co
   return watcher;
 }
 
-RenderTicketPtr PreviewAutoCacher::RenderAudio(Node *node, ViewerOutput *context, const TimeRange &r, PlaybackCache *cache)
+RenderTicketPtr PreviewAutoCacher::RenderAudio(Node *node, ViewerOutput *context, const TimeRange &r, PlaybackCache *cache, bool prioritize)
 {
   RenderTicketWatcher* watcher = new RenderTicketWatcher();
   watcher->setProperty("job", QVariant::fromValue(copier_->GetLastUpdateTime()));
@@ -647,6 +820,7 @@ RenderTicketPtr PreviewAutoCacher::RenderAudio(Node *node, ViewerOutput *context
 
   rap.generate_waveforms = dynamic_cast<AudioWaveformCache*>(cache);
   rap.clamp = false;
+  rap.prioritize = prioritize;
 
   RenderTicketPtr ticket = RenderManager::instance()->RenderAudio(rap);
   watcher->SetTicket(ticket);
@@ -674,6 +848,125 @@ void PreviewAutoCacher::CacheProxyTaskCancelled()
   TryRender();
 }
 
+void PreviewAutoCacher::SetSequenceSweep(ViewerOutput *context, bool enabled)
+{
+  if (enabled && context) {
+    sweep_context_ = context;
+    sweep_position_ = rational(0);
+
+    BuildSweepCutWindows();
+
+    // Relatively long tick so the sweep stays unobtrusive
+    static const int kSweepTickInterval = 2000;
+    sweep_timer_.start(kSweepTickInterval);
+
+    // Kick off immediately in case we're already idle
+    SweepTick();
+  } else {
+    sweep_context_ = nullptr;
+    sweep_cut_windows_.clear();
+    sweep_timer_.stop();
+  }
+}
+
+void PreviewAutoCacher::SweepTick()
+{
+  // Consider the user active if an interactive frame was requested this recently
+  static const qint64 kSweepIdleThreshold = 10000;
+
+  // Length of sequence queued per tick
+  static const rational kSweepChunkLength(10);
+
+  if (!sweep_context_) {
+    return;
+  }
+
+  rational length = sweep_context_->GetVideoLength();
+
+  if (sweep_position_ >= length && sweep_cut_windows_.isEmpty()) {
+    // Sweep complete
+    SetSequenceSweep(nullptr, false);
+    return;
+  }
+
+  // Back off while the user is working or other cache work is queued
+  if (QDateTime::currentMSecsSinceEpoch() - last_interactive_render_ < kSweepIdleThreshold
+      || !pending_video_jobs_.empty()
+      || !running_video_tasks_.isEmpty()) {
+    return;
+  }
+
+  // Only render frames that aren't already valid - this is also what makes the sweep resumable,
+  // since cache validity is persisted with the project
+  FrameHashCache *cache = sweep_context_->video_frame_cache();
+
+  // Serve the windows around cuts first - stutters are most noticeable at edits, so this
+  // maximizes perceived smoothness per cached frame
+  if (!sweep_cut_windows_.isEmpty()) {
+    rational queued;
+
+    while (!sweep_cut_windows_.isEmpty() && queued < kSweepChunkLength) {
+      TimeRange window = *sweep_cut_windows_.begin();
+      sweep_cut_windows_.remove(window);
+      queued += window.length();
+
+      foreach (const TimeRange &invalid, cache->GetInvalidatedRanges(window)) {
+        StartCachingVideoRange(sweep_context_, cache, invalid);
+      }
+    }
+
+    return;
+  }
+
+  TimeRange chunk(sweep_position_, qMin(sweep_position_ + kSweepChunkLength, length));
+  sweep_position_ = chunk.out();
+
+  foreach (const TimeRange &invalid, cache->GetInvalidatedRanges(chunk)) {
+    StartCachingVideoRange(sweep_context_, cache, invalid);
+  }
+}
+
+void PreviewAutoCacher::BuildSweepCutWindows()
+{
+  // How much to cache either side of a cut
+  static const rational kCutWindowRadius(1);
+
+  sweep_cut_windows_.clear();
+
+  Sequence *sequence = dynamic_cast<Sequence*>(sweep_context_);
+  if (!sequence) {
+    return;
+  }
+
+  rational length = sequence->GetVideoLength();
+
+  foreach (Track *track, sequence->GetTracks()) {
+    if (track->type() != Track::kVideo) {
+      continue;
+    }
+
+    foreach (Block *block, track->Blocks()) {
+      if (dynamic_cast<GapBlock*>(block)) {
+        // A gap's boundaries belong to whatever clips neighbor it, which we enumerate anyway
+        continue;
+      }
+
+      // TimeRangeList merges overlapping windows, so adjacent cuts don't queue twice
+      TimeRange in_window(qMax(rational(0), block->in() - kCutWindowRadius),
+                          qMin(length, block->in() + kCutWindowRadius));
+      if (in_window.length() != 0) {
+        sweep_cut_windows_.insert(in_window);
+      }
+
+      TimeRange out_window(qMax(rational(0), block->out() - kCutWindowRadius),
+                           qMin(length, block->out() + kCutWindowRadius));
+      if (out_window.length() != 0) {
+        sweep_cut_windows_.insert(out_window);
+      }
+    }
+  }
+}
+
 void PreviewAutoCacher::ForceCacheRange(ViewerOutput *context, const TimeRange &range)
 {
   use_custom_range_ = true;
@@ -693,6 +986,9 @@ void PreviewAutoCacher::SetProject(Project *project)
     // We must wait for any jobs to finish because they'll be using our copied graph and we're
     // about to destroy it
 
+    // Stop any sequence sweep, its context is about to go away
+    SetSequenceSweep(nullptr, false);
+
     // Stop requeue timer if it's running
     delayed_requeue_timer_.stop();
 
@@ -51,7 +51,7 @@ public:
   RenderTicketPtr GetSingleFrame(ViewerOutput *viewer, const rational& t, bool dry = false);
   RenderTicketPtr GetSingleFrame(Node *n, ViewerOutput *viewer, const rational& t, bool dry = false);
 
-  RenderTicketPtr GetRangeOfAudio(ViewerOutput *viewer, TimeRange range);
+  RenderTicketPtr GetRangeOfAudio(ViewerOutput *viewer, TimeRange range, bool prioritize = false);
 
   void ClearSingleFrameRenders();
   void ClearSingleFrameRendersThatArentRunning();
@@ -61,6 +61,21 @@ public:
    */
   void SetProject(Project *project);
 
+  /**
+   * @brief Enable or disable an idle-aware sweep that caches the entire sequence
+   *
+   * Unlike ForceCacheRange, the sweep trickles through the sequence in small chunks and backs
+   * off whenever interactive renders or queued cache work are detected, so it can be left
+   * running overnight without fighting the user. Already-valid frames are skipped, and since
+   * cache validity is persisted with the project, a restarted sweep resumes where it left off.
+   */
+  void SetSequenceSweep(ViewerOutput *context, bool enabled);
+
+  bool IsSequenceSweepEnabled() const
+  {
+    return sweep_context_;
+  }
+
   /**
    * @brief Force a certain range to be cached
    *
@@ -95,6 +110,41 @@ public:
 
   void SetIgnoreCacheRequests(bool e) { ignore_cache_requests_ = e; }
 
+  /**
+   * @brief Temporarily render interactive (single-frame) requests at a different divider
+   *
+   * Used by the viewer to trade resolution for smooth playback when frames are being dropped.
+   * Set to 0 to return to the sequence's own parameters. Background cache renders are
+   * unaffected so the cache is always filled at full quality.
+   */
+  void SetDividerOverride(int divider) { divider_override_ = divider; }
+
+  /**
+   * @brief Inform the cacher which time range is currently visible in the timeline
+   *
+   * Thumbnail jobs intersecting or near this range are rendered before offscreen ones, so the
+   * clips the user is actually looking at fill in first.
+   */
+  void SetVisibleRange(const TimeRange &range)
+  {
+    visible_range_ = range;
+    has_visible_range_ = true;
+  }
+
+  /**
+   * @brief Adjust the visibility refcount of a context
+   *
+   * Widgets viewing a sequence report when they're shown and hidden, so background work
+   * (autocache, thumbnails, waveforms) for sequences hidden behind tabs can wait for work on
+   * the sequences the user can actually see.
+   */
+  void SetContextVisibility(ViewerOutput *context, bool visible);
+
+  bool IsContextVisible(ViewerOutput *context) const
+  {
+    return visible_context_counts_.value(context) > 0;
+  }
+
 public slots:
   void SetDisplayColorProcessor(ColorProcessorPtr processor)
   {
@@ -111,7 +161,7 @@ private:
 
   RenderTicketWatcher *RenderFrame(Node *node, ViewerOutput *context, const rational &time, PlaybackCache *cache, bool dry);
 
-  RenderTicketPtr RenderAudio(Node *node, ViewerOutput *context, const TimeRange &range, PlaybackCache *cache);
+  RenderTicketPtr RenderAudio(Node *node, ViewerOutput *context, const TimeRange &range, PlaybackCache *cache, bool prioritize = false);
 
   void ConnectToNodeCache(Node *node);
   void DisconnectFromNodeCache(Node *node);
@@ -131,6 +181,16 @@ private:
 
   TimeRange cache_range_;
 
+  rational playhead_;
+
+  TimeRange visible_range_;
+  bool has_visible_range_;
+
+  /**
+   * @brief Number of visible widgets viewing each context - see SetContextVisibility()
+   */
+  QHash<ViewerOutput*, int> visible_context_counts_;
+
   bool use_custom_range_;
   TimeRange custom_autocache_range_;
 
@@ -142,6 +202,18 @@ private:
 
   QTimer delayed_requeue_timer_;
 
+  // Sequence sweep state - see SetSequenceSweep()
+  ViewerOutput *sweep_context_;
+  QTimer sweep_timer_;
+  rational sweep_position_;
+  TimeRangeList sweep_cut_windows_;
+  qint64 last_interactive_render_;
+
+  /**
+   * @brief Collect windows around every block boundary for the sweep to serve first
+   */
+  void BuildSweepCutWindows();
+
   JobTime last_conform_task_;
 
   QVector<RenderTicketWatcher*> running_video_tasks_;
@@ -155,6 +227,9 @@ private:
     PlaybackCache *cache;
     TimeRange range;
     TimeRangeListFrameIterator iterator;
+
+    // True if this job covers a transition span - these schedule ahead of clip interiors
+    bool transition_priority;
   };
 
   struct VideoCacheData {
@@ -176,6 +251,22 @@ private:
   std::list<VideoJob> pending_video_jobs_;
   std::list<AudioJob> pending_audio_jobs_;
 
+  /**
+   * @brief Pick the pending video job temporally closest to the playhead
+   *
+   * Called each time a job is (re)selected, so moving the playhead cheaply reprioritizes the
+   * queue without shuffling any queued tickets around.
+   */
+  std::list<VideoJob>::iterator GetClosestVideoJobToPlayhead();
+
+  /**
+   * @brief Collect the parts of `range` covered by enabled transitions in `context`'s video tracks
+   *
+   * Transitions re-render whenever either adjoining clip is touched and are where playback
+   * stutters are most visible, so their spans are queued as separate, higher-priority jobs.
+   */
+  static TimeRangeList GetTransitionSpans(ViewerOutput *context, const TimeRange &range);
+
   QHash<PlaybackCache*, VideoCacheData> video_cache_data_;
   QHash<PlaybackCache*, AudioCacheData> audio_cache_data_;
 
@@ -185,7 +276,14 @@ private:
 
   bool ignore_cache_requests_;
 
+  int divider_override_;
+
 private slots:
+  /**
+   * @brief Queue the next chunk of the sequence sweep if the system is idle
+   */
+  void SweepTick();
+
   /**
    * @brief Handler for when the NodeGraph reports a video change over a certain time range
    */
@@ -39,7 +39,9 @@ void ProjectCopier::SetProject(Project *project)
     qDeleteAll(created_nodes_);
     created_nodes_.clear();
     copy_map_.clear();
+    original_map_.clear();
     graph_update_queue_.clear();
+    queued_value_changes_.clear();
 
     disconnect(original_, &Project::NodeAdded, this, &ProjectCopier::QueueNodeAdd);
     disconnect(original_, &Project::NodeRemoved, this, &ProjectCopier::QueueNodeRemove);
@@ -108,6 +110,7 @@ void ProjectCopier::ProcessUpdateQueue()
       DoEdgeRemove(job.output, job.input);
       break;
     case QueuedJob::kValueChanged:
+      queued_value_changes_.remove(job.input);
       DoValueChange(job.input);
       break;
     case QueuedJob::kValueHintChanged:
@@ -154,6 +157,7 @@ void ProjectCopier::DoNodeRemove(Node *node)
 {
   // Find our copy and remove it
   Node* copy = copy_map_.take(node);
+  original_map_.remove(copy);
 
   // Disconnect from node's caches
   emit RemovedNode(node);
@@ -217,6 +221,7 @@ void ProjectCopier::InsertIntoCopyMap(Node *node, Node *copy)
 {
   // Insert into map
   copy_map_.insert(node, copy);
+  original_map_.insert(copy, node);
 
   // Copy parameters
   Node::CopyInputs(node, copy, false);
@@ -251,13 +256,13 @@ void ProjectCopier::QueueEdgeRemove(Node *output, const NodeInput &input)
 
 void ProjectCopier::QueueValueChange(const NodeInput &input)
 {
-  /*for (auto it = graph_update_queue_.begin(); it != graph_update_queue_.end(); ) {
-    if (it->type == QueuedJob::kValueChanged && it->input == input) {
-      it = graph_update_queue_.erase(it);
-    } else {
-      it++;
-    }
-  }*/
+  // If a job for this input is already queued, it'll copy the input's latest value when it's
+  // applied anyway, so there's nothing to add
+  if (queued_value_changes_.contains(input)) {
+    return;
+  }
+
+  queued_value_changes_.insert(input);
 
   graph_update_queue_.push_back({QueuedJob::kValueChanged, nullptr, input, nullptr, QString(), QString()});
   UpdateGraphChangeValue();
@@ -21,6 +21,8 @@
 #ifndef PROJECTCOPIER_H
 #define PROJECTCOPIER_H
 
+#include <QSet>
+
 #include "node/project.h"
 
 namespace olive {
@@ -42,7 +44,7 @@ public:
   template <typename T>
   T *GetOriginal(T *copy)
   {
-    return static_cast<T*>(copy_map_.key(copy));
+    return static_cast<T*>(original_map_.value(copy));
   }
 
   Project *GetCopiedProject() const { return copy_; }
@@ -105,7 +107,21 @@ private:
   };
 
   std::list<QueuedJob> graph_update_queue_;
+
+  /**
+   * @brief Inputs that already have a kValueChanged job in the queue
+   *
+   * DoValueChange copies whatever the input's value is at apply time, so queuing a second job for
+   * the same input would just repeat the same copy. This set lets QueueValueChange drop such
+   * duplicates, which keeps rapid repeated changes to one input (e.g. dragging a slider) from
+   * growing the queue by one entry per change.
+   */
+  QSet<NodeInput> queued_value_changes_;
+
   QHash<Node*, Node*> copy_map_;
+
+  // Reverse of copy_map_ so GetOriginal() is a hash lookup rather than a key search
+  QHash<Node*, Node*> original_map_;
   QHash<Project*, Project*> graph_map_;
   QVector<Node*> created_nodes_;
 
@@ -0,0 +1,212 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifdef USE_QT_NETWORK
+
+#include "remotecache.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrent>
+#include <QTimer>
+
+#include "config/config.h"
+
+namespace olive {
+
+RemoteCache* RemoteCache::instance_ = nullptr;
+
+const int RemoteCache::kTransferTimeoutMs = 5000;
+
+const qint64 RemoteCache::kBackoffMs = 30000;
+
+namespace {
+
+/**
+ * Runs one HTTP request to completion with a timeout, using a local event loop so this works
+ * from any thread. Returns the finished (or aborted) reply, which the caller still owns.
+ */
+QNetworkReply* RunRequestBlocking(QNetworkReply* reply, int timeout_ms)
+{
+  QEventLoop loop;
+
+  QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+
+  QTimer timeout;
+  timeout.setSingleShot(true);
+  QObject::connect(&timeout, &QTimer::timeout, reply, &QNetworkReply::abort);
+  timeout.start(timeout_ms);
+
+  if (!reply->isFinished()) {
+    loop.exec();
+  }
+
+  return reply;
+}
+
+}
+
+RemoteCache::RemoteCache() :
+  backoff_until_(0)
+{
+  // Picked up once at startup - pointing five bays at the same URL is a config-file deployment
+  base_url_ = OLIVE_CONFIG("SharedCacheUrl").toString();
+
+  while (base_url_.endsWith('/')) {
+    base_url_.chop(1);
+  }
+
+  // Keep uploads from competing with the render pool for threads
+  upload_pool_.setMaxThreadCount(2);
+
+  if (IsEnabled()) {
+    qInfo() << "Shared render cache enabled at" << base_url_;
+  }
+}
+
+RemoteCache::~RemoteCache()
+{
+  upload_pool_.waitForDone();
+}
+
+void RemoteCache::CreateInstance()
+{
+  instance_ = new RemoteCache();
+}
+
+void RemoteCache::DestroyInstance()
+{
+  delete instance_;
+  instance_ = nullptr;
+}
+
+RemoteCache* RemoteCache::instance()
+{
+  return instance_;
+}
+
+bool RemoteCache::FetchFrame(const QString& cache_path, const QString& filename)
+{
+  if (!IsEnabled() || !TransferAllowed()) {
+    return false;
+  }
+
+  QUrl url = GetUrlForFile(cache_path, filename);
+  if (!url.isValid()) {
+    return false;
+  }
+
+  QNetworkAccessManager nam;
+  QNetworkReply* reply = RunRequestBlocking(nam.get(QNetworkRequest(url)), kTransferTimeoutMs);
+
+  bool got_frame = false;
+
+  if (reply->error() == QNetworkReply::NoError) {
+    ReportTransferResult(true);
+
+    // Write through QSaveFile so a concurrent LoadCacheFrame never sees a half-fetched file
+    QFileInfo(filename).dir().mkpath(QStringLiteral("."));
+
+    QSaveFile file(filename);
+    if (file.open(QFile::WriteOnly)) {
+      file.write(reply->readAll());
+      got_frame = file.commit();
+    }
+  } else if (reply->error() == QNetworkReply::ContentNotFoundError) {
+    // A clean 404 is just a miss - the server is healthy, so don't back off
+    ReportTransferResult(true);
+  } else {
+    ReportTransferResult(false);
+  }
+
+  delete reply;
+
+  return got_frame;
+}
+
+void RemoteCache::StoreFrame(const QString& cache_path, const QString& filename)
+{
+  if (!IsEnabled() || !TransferAllowed()) {
+    return;
+  }
+
+  QUrl url = GetUrlForFile(cache_path, filename);
+  if (!url.isValid()) {
+    return;
+  }
+
+  QtConcurrent::run(&upload_pool_, [this, url, filename]{
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly)) {
+      return;
+    }
+
+    QByteArray data = file.readAll();
+    file.close();
+
+    QNetworkAccessManager nam;
+    QNetworkReply* reply = RunRequestBlocking(nam.put(QNetworkRequest(url), data), kTransferTimeoutMs);
+
+    ReportTransferResult(reply->error() == QNetworkReply::NoError);
+
+    delete reply;
+  });
+}
+
+QUrl RemoteCache::GetUrlForFile(const QString& cache_path, const QString& filename) const
+{
+  // The path relative to the cache folder is "<uuid>/<timestamp>", which is already stable
+  // across machines, so it doubles as the remote object key
+  QString key = QDir(cache_path).relativeFilePath(filename);
+
+  if (key.isEmpty() || key.startsWith(QStringLiteral(".."))) {
+    return QUrl();
+  }
+
+  return QUrl(QStringLiteral("%1/%2").arg(base_url_, key));
+}
+
+bool RemoteCache::TransferAllowed()
+{
+  QMutexLocker locker(&backoff_mutex_);
+
+  return QDateTime::currentMSecsSinceEpoch() >= backoff_until_;
+}
+
+void RemoteCache::ReportTransferResult(bool connection_ok)
+{
+  QMutexLocker locker(&backoff_mutex_);
+
+  if (connection_ok) {
+    backoff_until_ = 0;
+  } else {
+    backoff_until_ = QDateTime::currentMSecsSinceEpoch() + kBackoffMs;
+  }
+}
+
+}
+
+#endif // USE_QT_NETWORK
@@ -0,0 +1,119 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef REMOTECACHE_H
+#define REMOTECACHE_H
+
+#ifdef USE_QT_NETWORK
+
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+#include <QUrl>
+
+#include "common/define.h"
+
+namespace olive {
+
+/**
+ * @brief Shared second-tier frame cache consulted over HTTP when the disk cache misses
+ *
+ * Machines working on the same project produce identical cache frames: every FrameHashCache
+ * keys its files by a UUID that is stored in the project file plus the frame's timestamp, so
+ * the keys are stable across workstations. When "SharedCacheUrl" is configured, frames are
+ * uploaded after being rendered and fetched into the local disk cache when a frame is needed
+ * that only exists remotely - several edit bays caching the same sequence collectively render
+ * each frame once.
+ *
+ * Any HTTP server that maps GET and PUT onto object reads/writes works as a backend (nginx
+ * with dav_methods, MinIO, etc. - keys are simply "<uuid>/<timestamp>"). The tier is strictly
+ * best effort: a network error only means the frame gets rendered locally like it would have
+ * anyway, and after a connection failure transfers back off for a while so an unreachable
+ * server doesn't add a timeout to every frame.
+ *
+ * Note that the remote tier carries frame payloads, not validation state - whether a frame
+ * needs rendering is still decided by each cache's local validated ranges, so bays must be
+ * working from the same version of the project for fetched frames to be correct.
+ */
+class RemoteCache : public QObject
+{
+  Q_OBJECT
+public:
+  static void CreateInstance();
+
+  static void DestroyInstance();
+
+  static RemoteCache* instance();
+
+  bool IsEnabled() const
+  {
+    return !base_url_.isEmpty();
+  }
+
+  /**
+   * @brief Try to fetch a cache frame from the shared tier into the local disk cache
+   *
+   * Blocks the calling thread for at most the transfer timeout; intended for render/load
+   * threads, not the main thread. Returns true if `filename` exists locally on return.
+   */
+  bool FetchFrame(const QString& cache_path, const QString& filename);
+
+  /**
+   * @brief Queue a newly rendered cache frame for upload to the shared tier
+   *
+   * Fire and forget - uploads run on a small worker pool and failures are silently dropped.
+   */
+  void StoreFrame(const QString& cache_path, const QString& filename);
+
+private:
+  RemoteCache();
+
+  virtual ~RemoteCache() override;
+
+  /**
+   * @brief Build the remote URL for a cache file ("<base>/<uuid>/<timestamp>")
+   */
+  QUrl GetUrlForFile(const QString& cache_path, const QString& filename) const;
+
+  bool TransferAllowed();
+
+  void ReportTransferResult(bool connection_ok);
+
+  static const int kTransferTimeoutMs;
+
+  static const qint64 kBackoffMs;
+
+  static RemoteCache* instance_;
+
+  QString base_url_;
+
+  QThreadPool upload_pool_;
+
+  QMutex backoff_mutex_;
+
+  qint64 backoff_until_;
+
+};
+
+}
+
+#endif // USE_QT_NETWORK
+
+#endif // REMOTECACHE_H
@@ -21,21 +21,59 @@
 #ifndef RENDERCACHE_H
 #define RENDERCACHE_H
 
+#include <QHash>
+#include <QMutex>
+
 #include "codec/decoder.h"
 
 namespace olive {
 
+/**
+ * @brief Thread-safe hash map sharded by key
+ *
+ * Entries are distributed across independently locked shards so a pool of render threads
+ * looking up different keys (e.g. decoders for different footage files) almost never contend
+ * on the same mutex. Callers acquire the shard for their key, lock it, and can then perform
+ * an atomic check-then-insert on the shard's map.
+ */
 template <typename K, typename V>
-class RenderCache : public QHash<K, V>
+class RenderCache
 {
 public:
-  QMutex *mutex()
+  static const int kShardCount = 16;
+
+  class Shard
+  {
+  public:
+    QMutex *mutex()
+    {
+      return &mutex_;
+    }
+
+    QHash<K, V> &map()
+    {
+      return map_;
+    }
+
+  private:
+    QMutex mutex_;
+
+    QHash<K, V> map_;
+
+  };
+
+  Shard &shard(const K &key)
+  {
+    return shards_[qHash(key) % kShardCount];
+  }
+
+  Shard &shard(int index)
   {
-    return &mutex_;
+    return shards_[index];
   }
 
 private:
-  QMutex mutex_;
+  Shard shards_[kShardCount];
 
 };
 
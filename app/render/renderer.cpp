@@ -20,16 +20,31 @@
 
 #include "renderer.h"
 
+#include <QCryptographicHash>
+#include <QDataStream>
 #include <QDateTime>
+#include <QDir>
+#include <QFile>
 #include <QThread>
 #include <QTimer>
 #include <QVector2D>
 
+#include "config/config.h"
+#include "render/diskmanager.h"
+
 namespace olive {
 
 Renderer::Renderer(QObject *parent) :
-  QObject(parent)
+  QObject(parent),
+  profiler_enabled_(false),
+  profiler_blit_time_ns_(0),
+  texture_memory_usage_(0)
+{
+}
+
+qint64 Renderer::GetTextureMemoryBudget()
 {
+  return Config::Cached().gpu_memory_budget;
 }
 
 TexturePtr Renderer::CreateTexture(const VideoParams &params, const void *data, int linesize)
@@ -38,22 +53,29 @@ TexturePtr Renderer::CreateTexture(const VideoParams &params, const void *data,
 
   if (USE_TEXTURE_CACHE) {
     QMutexLocker locker(&texture_cache_lock_);
-    for (auto it=texture_cache_.begin(); it!=texture_cache_.end(); it++) {
-      if (it->width == params.effective_width()
-          && it->height == params.effective_height()
-          && it->depth == params.effective_depth()
-          && it->format == params.format()
-          && it->channel_count == params.channel_count()) {
-        v = it->handle;
-        texture_cache_.erase(it);
-        break;
-      }
+    auto pool = texture_pool_.find(GetTexturePoolKey(params));
+    if (pool != texture_pool_.end() && !pool->empty()) {
+      // Prefer the most recently returned texture, which is most likely to
+      // still be resident in VRAM
+      v = pool->back().handle;
+      pool->pop_back();
     }
   }
 
   if (v.isNull()) {
+    qint64 new_size = GetTextureSize(GetTexturePoolKey(params));
+
+    // If this allocation would take us over the texture memory budget, free least-recently-used
+    // pooled textures first so the driver doesn't start paging
+    qint64 budget = GetTextureMemoryBudget();
+    if (budget > 0 && GetTextureMemoryUsage() + new_size > budget) {
+      EvictPooledTextures(GetTextureMemoryUsage() + new_size - budget);
+    }
+
     v = CreateNativeTexture(params.effective_width(), params.effective_height(), params.effective_depth(),
                             params.format(), params.channel_count(), data, linesize);
+
+    texture_memory_usage_.fetchAndAddRelaxed(new_size);
   } else if (data) {
     UploadToTexture(v, params, data, linesize);
   } else {
@@ -82,13 +104,8 @@ void Renderer::DestroyTexture(Texture *texture)
     //       Presumably Vulkan would not have this issue because it allows for application-wide
     //       instances and multithreading.
     texture_cache_lock_.lock();
-    texture_cache_.push_back({texture->params().effective_width(),
-                              texture->params().effective_height(),
-                              texture->params().effective_depth(),
-                              texture->params().format(),
-                              texture->params().channel_count(),
-                              texture->id(),
-                              QDateTime::currentMSecsSinceEpoch()});
+    texture_pool_[GetTexturePoolKey(texture->params())].push_back({texture->id(),
+                                                                   QDateTime::currentMSecsSinceEpoch()});
     texture_cache_lock_.unlock();
 
     if (QThread::currentThread() == this->thread()) {
@@ -96,6 +113,7 @@ void Renderer::DestroyTexture(Texture *texture)
     }
   } else {
     DestroyNativeTexture(texture->id());
+    texture_memory_usage_.fetchAndSubRelaxed(GetTextureSize(GetTexturePoolKey(texture->params())));
   }
 }
 
@@ -144,10 +162,13 @@ void Renderer::Destroy()
     interlace_texture_.clear();
   }
 
-  for (auto it=texture_cache_.begin(); it!=texture_cache_.end(); it++) {
-    DestroyNativeTexture(it->handle);
+  for (auto pool=texture_pool_.begin(); pool!=texture_pool_.end(); pool++) {
+    for (auto it=pool->begin(); it!=pool->end(); it++) {
+      DestroyNativeTexture(it->handle);
+      texture_memory_usage_.fetchAndSubRelaxed(GetTextureSize(pool.key()));
+    }
   }
-  texture_cache_.clear();
+  texture_pool_.clear();
 
   DestroyInternal();
 }
@@ -167,8 +188,23 @@ bool Renderer::GetColorContext(const ColorTransformJob &color_job, Renderer::Col
 
   ColorContext& color_ctx = *ctx;
 
+  // Baking collapses the entire OCIO chain into a single 3D LUT sample per pixel, which is much
+  // cheaper for deep view transforms at a small precision cost. Final-quality renders clear the
+  // allowance upstream so exports always run the full chain.
+  const bool bake_lut = color_job.IsBakedLutAllowed()
+      && !color_job.CustomShaderSource()
+      && Config::Cached().baked_color_transforms;
+
   QString proc_id = color_job.id();
 
+  if (bake_lut) {
+    // Baked and full-chain contexts for the same transform must not collide
+    proc_id.append(QStringLiteral(":baked"));
+  }
+
+  // Different wrapper stubs compile to different programs
+  proc_id.append(QLatin1Char(':')).append(color_job.GetShaderStub());
+
   if (color_cache_.contains(proc_id)) {
     color_ctx = color_cache_.value(proc_id);
     return true;
@@ -180,22 +216,101 @@ bool Renderer::GetColorContext(const ColorTransformJob &color_job, Renderer::Col
     } else {
       ocio_func_name = color_job.GetFunctionName();
     }
-    auto shader_desc = OCIO::GpuShaderDesc::CreateShaderDesc();
-    shader_desc->setLanguage(OCIO::GPU_LANGUAGE_GLSL_ES_3_0);
-    shader_desc->setFunctionName(ocio_func_name.toUtf8());
-    shader_desc->setResourcePrefix("ocio_");
 
-    // Generate shader
-    color_job.GetColorProcessor()->GetProcessor()->getDefaultGPUProcessor()->extractGpuShaderInfo(shader_desc);
+    // Try restoring the generated shader text and LUT data persisted by a previous session
+    // before asking OCIO to regenerate them
+    QString disk_filename = GetColorContextCacheFilename(color_job, ocio_func_name, bake_lut);
+
+    QString shader_text;
+
+    if (!LoadColorContextFromDisk(disk_filename, &color_ctx, &shader_text)) {
+      auto shader_desc = OCIO::GpuShaderDesc::CreateShaderDesc();
+      shader_desc->setLanguage(OCIO::GPU_LANGUAGE_GLSL_ES_3_0);
+      shader_desc->setFunctionName(ocio_func_name.toUtf8());
+      shader_desc->setResourcePrefix("ocio_");
+
+      // Generate shader
+      OCIO::ConstGPUProcessorRcPtr gpu_processor;
+      if (bake_lut) {
+        // The legacy GPU path bakes the whole processor into one lattice of this edge length
+        gpu_processor = color_job.GetColorProcessor()->GetProcessor()->getOptimizedLegacyGPUProcessor(OCIO::OPTIMIZATION_DEFAULT, kBakedLutEdgeLength);
+      } else {
+        gpu_processor = color_job.GetColorProcessor()->GetProcessor()->getDefaultGPUProcessor();
+      }
+      gpu_processor->extractGpuShaderInfo(shader_desc);
+
+      shader_text = QString::fromUtf8(shader_desc->getShaderText());
+
+      color_ctx.lut3d_textures.resize(shader_desc->getNum3DTextures());
+      for (unsigned int i=0; i<shader_desc->getNum3DTextures(); i++) {
+        const char* tex_name = nullptr;
+        const char* sampler_name = nullptr;
+        unsigned int edge_len = 0;
+        OCIO::Interpolation interpolation = OCIO::INTERP_LINEAR;
+
+        shader_desc->get3DTexture(i, tex_name, sampler_name, edge_len, interpolation);
+
+        if (!tex_name || !*tex_name
+            || !sampler_name || !*sampler_name
+            || !edge_len) {
+          qCritical() << "3D LUT texture data is corrupted";
+          return false;
+        }
+
+        const float* values = nullptr;
+        shader_desc->get3DTextureValues(i, values);
+        if (!values) {
+          qCritical() << "3D LUT texture values are missing";
+          return false;
+        }
+
+        // Allocate 3D LUT
+        color_ctx.lut3d_textures[i].texture = CreateTexture(VideoParams(edge_len, edge_len, edge_len, PixelFormat::F32, VideoParams::kRGBChannelCount), values);
+        color_ctx.lut3d_textures[i].name = sampler_name;
+        color_ctx.lut3d_textures[i].interpolation = (interpolation == OCIO::INTERP_NEAREST) ? Texture::kNearest : Texture::kLinear;
+      }
+
+      color_ctx.lut1d_textures.resize(shader_desc->getNumTextures());
+      for (unsigned int i=0; i<shader_desc->getNumTextures(); i++) {
+        const char* tex_name = nullptr;
+        const char* sampler_name = nullptr;
+        unsigned int width = 0, height = 0;
+        OCIO::GpuShaderDesc::TextureType channel = OCIO::GpuShaderDesc::TEXTURE_RGB_CHANNEL;
+        OCIO::Interpolation interpolation = OCIO::INTERP_LINEAR;
+
+        shader_desc->getTexture(i, tex_name, sampler_name, width, height, channel, interpolation);
+
+        if (!tex_name || !*tex_name
+            || !sampler_name || !*sampler_name
+            || !width) {
+          qCritical() << "1D LUT texture data is corrupted";
+          return false;
+        }
+
+        const float* values = nullptr;
+        shader_desc->getTextureValues(i, values);
+        if (!values) {
+          qCritical() << "1D LUT texture values are missing";
+          return false;
+        }
+
+        // Allocate 1D LUT
+        color_ctx.lut1d_textures[i].texture = CreateTexture(VideoParams(width, height, PixelFormat::F32, (channel == OCIO::GpuShaderDesc::TEXTURE_RED_CHANNEL) ? 1 : VideoParams::kRGBChannelCount), values);
+        color_ctx.lut1d_textures[i].name = sampler_name;
+        color_ctx.lut1d_textures[i].interpolation = (interpolation == OCIO::INTERP_NEAREST) ? Texture::kNearest : Texture::kLinear;
+      }
+
+      SaveColorContextToDisk(disk_filename, shader_desc);
+    }
 
     ShaderCode code;
     if (const Node *shader_src = color_job.CustomShaderSource()) {
       // Use shader code from associated node
-      code = shader_src->GetShaderCode({color_job.CustomShaderID(), shader_desc->getShaderText()});
+      code = shader_src->GetShaderCode({color_job.CustomShaderID(), shader_text});
     } else {
-      // Generate shader code using OCIO stub and our auto-generated name
-      code = FileFunctions::ReadFileAsString(QStringLiteral(":shaders/colormanage.frag"));
-      code.set_frag_code(code.frag_code().arg(shader_desc->getShaderText()));
+      // Generate shader code using the job's wrapper stub and our auto-generated name
+      code = FileFunctions::ReadFileAsString(color_job.GetShaderStub());
+      code.set_frag_code(code.frag_code().arg(shader_text));
     }
 
     // Try to compile shader
@@ -205,68 +320,140 @@ bool Renderer::GetColorContext(const ColorTransformJob &color_job, Renderer::Col
       return false;
     }
 
-    color_ctx.lut3d_textures.resize(shader_desc->getNum3DTextures());
-    for (unsigned int i=0; i<shader_desc->getNum3DTextures(); i++) {
-      const char* tex_name = nullptr;
-      const char* sampler_name = nullptr;
-      unsigned int edge_len = 0;
-      OCIO::Interpolation interpolation = OCIO::INTERP_LINEAR;
+    color_cache_.insert(proc_id, color_ctx);
 
-      shader_desc->get3DTexture(i, tex_name, sampler_name, edge_len, interpolation);
+    return true;
+  }
+}
 
-      if (!tex_name || !*tex_name
-          || !sampler_name || !*sampler_name
-          || !edge_len) {
-        qCritical() << "3D LUT texture data is corrupted";
-        return false;
-      }
+QString Renderer::GetColorContextCacheFilename(const ColorTransformJob &color_job, const QString &function_name, bool baked)
+{
+  QCryptographicHash hash(QCryptographicHash::Sha1);
 
-      const float* values = nullptr;
-      shader_desc->get3DTextureValues(i, values);
-      if (!values) {
-        qCritical() << "3D LUT texture values are missing";
-        return false;
-      }
+  // The OCIO cache ID uniquely identifies the transform chain, and the function name is baked
+  // into the generated text
+  hash.addData(QByteArray(color_job.GetColorProcessor()->id()));
+  hash.addData(function_name.toUtf8());
+
+  if (baked) {
+    // A baked LUT and the full chain generate entirely different artifacts
+    hash.addData("baked", 5);
+  }
+
+  return QDir(DiskManager::GetShaderCachePath()).filePath(QString::fromLatin1(hash.result().toHex()).append(QStringLiteral(".ocio")));
+}
+
+bool Renderer::LoadColorContextFromDisk(const QString &filename, ColorContext *ctx, QString *shader_text)
+{
+  QFile file(filename);
+  if (!file.open(QFile::ReadOnly)) {
+    return false;
+  }
+
+  QDataStream stream(&file);
+
+  quint32 version;
+  stream >> version;
+  if (version != kColorContextCacheVersion) {
+    return false;
+  }
+
+  stream >> *shader_text;
+
+  quint32 lut3d_count;
+  stream >> lut3d_count;
+  ctx->lut3d_textures.resize(lut3d_count);
+  for (quint32 i=0; i<lut3d_count; i++) {
+    QString name;
+    quint8 nearest;
+    quint32 edge_len;
+    QByteArray values;
+
+    stream >> name >> nearest >> edge_len >> values;
 
-      // Allocate 3D LUT
-      color_ctx.lut3d_textures[i].texture = CreateTexture(VideoParams(edge_len, edge_len, edge_len, PixelFormat::F32, VideoParams::kRGBChannelCount), values);
-      color_ctx.lut3d_textures[i].name = sampler_name;
-      color_ctx.lut3d_textures[i].interpolation = (interpolation == OCIO::INTERP_NEAREST) ? Texture::kNearest : Texture::kLinear;
+    if (stream.status() != QDataStream::Ok
+        || values.size() != int(edge_len * edge_len * edge_len * VideoParams::kRGBChannelCount * sizeof(float))) {
+      return false;
     }
 
-    color_ctx.lut1d_textures.resize(shader_desc->getNumTextures());
-    for (unsigned int i=0; i<shader_desc->getNumTextures(); i++) {
-      const char* tex_name = nullptr;
-      const char* sampler_name = nullptr;
-      unsigned int width = 0, height = 0;
-      OCIO::GpuShaderDesc::TextureType channel = OCIO::GpuShaderDesc::TEXTURE_RGB_CHANNEL;
-      OCIO::Interpolation interpolation = OCIO::INTERP_LINEAR;
-
-      shader_desc->getTexture(i, tex_name, sampler_name, width, height, channel, interpolation);
-
-      if (!tex_name || !*tex_name
-          || !sampler_name || !*sampler_name
-          || !width) {
-        qCritical() << "1D LUT texture data is corrupted";
-        return false;
-      }
+    ctx->lut3d_textures[i].texture = CreateTexture(VideoParams(edge_len, edge_len, edge_len, PixelFormat::F32, VideoParams::kRGBChannelCount), values.constData());
+    ctx->lut3d_textures[i].name = name;
+    ctx->lut3d_textures[i].interpolation = nearest ? Texture::kNearest : Texture::kLinear;
+  }
 
-      const float* values = nullptr;
-      shader_desc->getTextureValues(i, values);
-      if (!values) {
-        qCritical() << "1D LUT texture values are missing";
-        return false;
-      }
+  quint32 lut1d_count;
+  stream >> lut1d_count;
+  ctx->lut1d_textures.resize(lut1d_count);
+  for (quint32 i=0; i<lut1d_count; i++) {
+    QString name;
+    quint8 nearest;
+    quint32 width, height, channels;
+    QByteArray values;
+
+    stream >> name >> nearest >> width >> height >> channels >> values;
 
-      // Allocate 1D LUT
-      color_ctx.lut1d_textures[i].texture = CreateTexture(VideoParams(width, height, PixelFormat::F32, (channel == OCIO::GpuShaderDesc::TEXTURE_RED_CHANNEL) ? 1 : VideoParams::kRGBChannelCount), values);
-      color_ctx.lut1d_textures[i].name = sampler_name;
-      color_ctx.lut1d_textures[i].interpolation = (interpolation == OCIO::INTERP_NEAREST) ? Texture::kNearest : Texture::kLinear;
+    if (stream.status() != QDataStream::Ok
+        || values.size() != int(width * height * channels * sizeof(float))) {
+      return false;
     }
 
-    color_cache_.insert(proc_id, color_ctx);
+    ctx->lut1d_textures[i].texture = CreateTexture(VideoParams(width, height, PixelFormat::F32, channels), values.constData());
+    ctx->lut1d_textures[i].name = name;
+    ctx->lut1d_textures[i].interpolation = nearest ? Texture::kNearest : Texture::kLinear;
+  }
 
-    return true;
+  return stream.status() == QDataStream::Ok;
+}
+
+void Renderer::SaveColorContextToDisk(const QString &filename, const OCIO::GpuShaderDescRcPtr &shader_desc)
+{
+  QFile file(filename);
+  if (!file.open(QFile::WriteOnly | QFile::Truncate)) {
+    return;
+  }
+
+  QDataStream stream(&file);
+
+  stream << kColorContextCacheVersion;
+  stream << QString::fromUtf8(shader_desc->getShaderText());
+
+  stream << quint32(shader_desc->getNum3DTextures());
+  for (unsigned int i=0; i<shader_desc->getNum3DTextures(); i++) {
+    const char* tex_name = nullptr;
+    const char* sampler_name = nullptr;
+    unsigned int edge_len = 0;
+    OCIO::Interpolation interpolation = OCIO::INTERP_LINEAR;
+    shader_desc->get3DTexture(i, tex_name, sampler_name, edge_len, interpolation);
+
+    const float* values = nullptr;
+    shader_desc->get3DTextureValues(i, values);
+
+    stream << QString::fromUtf8(sampler_name);
+    stream << quint8(interpolation == OCIO::INTERP_NEAREST);
+    stream << quint32(edge_len);
+    stream << QByteArray(reinterpret_cast<const char*>(values), edge_len * edge_len * edge_len * VideoParams::kRGBChannelCount * sizeof(float));
+  }
+
+  stream << quint32(shader_desc->getNumTextures());
+  for (unsigned int i=0; i<shader_desc->getNumTextures(); i++) {
+    const char* tex_name = nullptr;
+    const char* sampler_name = nullptr;
+    unsigned int width = 0, height = 0;
+    OCIO::GpuShaderDesc::TextureType channel = OCIO::GpuShaderDesc::TEXTURE_RGB_CHANNEL;
+    OCIO::Interpolation interpolation = OCIO::INTERP_LINEAR;
+    shader_desc->getTexture(i, tex_name, sampler_name, width, height, channel, interpolation);
+
+    const float* values = nullptr;
+    shader_desc->getTextureValues(i, values);
+
+    quint32 channels = (channel == OCIO::GpuShaderDesc::TEXTURE_RED_CHANNEL) ? 1 : VideoParams::kRGBChannelCount;
+
+    stream << QString::fromUtf8(sampler_name);
+    stream << quint8(interpolation == OCIO::INTERP_NEAREST);
+    stream << quint32(width);
+    stream << quint32(height);
+    stream << channels;
+    stream << QByteArray(reinterpret_cast<const char*>(values), width * height * channels * sizeof(float));
   }
 }
 
@@ -274,12 +461,53 @@ void Renderer::ClearOldTextures()
 {
   QMutexLocker locker(&texture_cache_lock_);
 
-  for (auto it=texture_cache_.begin(); it!=texture_cache_.end(); ) {
-    if (it->accessed < QDateTime::currentMSecsSinceEpoch() - MAX_TEXTURE_LIFE) {
-      DestroyNativeTexture(it->handle);
-      it = texture_cache_.erase(it);
+  qint64 min_age = QDateTime::currentMSecsSinceEpoch() - MAX_TEXTURE_LIFE;
+
+  for (auto pool=texture_pool_.begin(); pool!=texture_pool_.end(); ) {
+    // Free lists are in return order, so expired textures are at the front
+    while (!pool->empty() && pool->front().accessed < min_age) {
+      DestroyNativeTexture(pool->front().handle);
+      texture_memory_usage_.fetchAndSubRelaxed(GetTextureSize(pool.key()));
+      pool->pop_front();
+    }
+
+    if (pool->empty()) {
+      pool = texture_pool_.erase(pool);
     } else {
-      it++;
+      pool++;
+    }
+  }
+}
+
+void Renderer::EvictPooledTextures(qint64 bytes)
+{
+  QMutexLocker locker(&texture_cache_lock_);
+
+  qint64 freed = 0;
+
+  while (freed < bytes) {
+    // Find the least-recently-returned texture across all free lists
+    auto oldest = texture_pool_.end();
+
+    for (auto pool=texture_pool_.begin(); pool!=texture_pool_.end(); pool++) {
+      if (!pool->empty()
+          && (oldest == texture_pool_.end() || pool->front().accessed < oldest->front().accessed)) {
+        oldest = pool;
+      }
+    }
+
+    if (oldest == texture_pool_.end()) {
+      // Pool is empty, nothing left to evict
+      break;
+    }
+
+    DestroyNativeTexture(oldest->front().handle);
+    freed += GetTextureSize(oldest.key());
+    texture_memory_usage_.fetchAndSubRelaxed(GetTextureSize(oldest.key()));
+    oldest->pop_front();
+
+    if (oldest->empty()) {
+      texture_pool_.erase(oldest);
     }
   }
 }
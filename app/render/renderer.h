@@ -21,6 +21,7 @@
 #ifndef RENDERCONTEXT_H
 #define RENDERCONTEXT_H
 
+#include <QAtomicInteger>
 #include <QMutex>
 #include <QObject>
 #include <QVariant>
@@ -78,6 +79,42 @@ public:
 
   QVariant GetDefaultShader();
 
+  /**
+   * @brief Enable or disable GPU timing of blits for the profiling HUD
+   */
+  void SetProfilerEnabled(bool enabled)
+  {
+    profiler_enabled_ = enabled;
+  }
+
+  bool IsProfilerEnabled() const
+  {
+    return profiler_enabled_;
+  }
+
+  /**
+   * @brief Return the GPU nanoseconds spent blitting since the last call and reset the counter
+   */
+  qint64 TakeProfilerBlitTime()
+  {
+    return profiler_blit_time_ns_.fetchAndStoreRelaxed(0);
+  }
+
+  /**
+   * @brief Number of bytes of texture memory currently allocated by this renderer
+   *
+   * Includes both textures in use and textures sitting in the reuse pool.
+   */
+  qint64 GetTextureMemoryUsage() const
+  {
+    return texture_memory_usage_.loadRelaxed();
+  }
+
+  /**
+   * @brief The configured texture memory budget in bytes, or 0 for unlimited
+   */
+  static qint64 GetTextureMemoryBudget();
+
   void Destroy();
 
   virtual void PostDestroy() = 0;
@@ -96,9 +133,21 @@ public:
 
   virtual void Flush() = 0;
 
+  /**
+   * @brief Sample a single pixel from a texture
+   *
+   * Implementations may pipeline the readback, in which case the returned color is from a
+   * sample issued a call or two earlier. Callers are inspection tools (pixel sampler, scopes)
+   * where that latency is imperceptible.
+   */
   virtual Color GetPixelFromTexture(olive::Texture *texture, const QPointF &pt) = 0;
 
 protected:
+  void AddProfilerBlitTime(qint64 ns)
+  {
+    profiler_blit_time_ns_.fetchAndAddRelaxed(ns);
+  }
+
   virtual void Blit(QVariant shader,
                     olive::ShaderJob job,
                     olive::Texture* destination,
@@ -129,29 +178,97 @@ private:
 
   bool GetColorContext(const ColorTransformJob &color_job, ColorContext* ctx);
 
+  /**
+   * @brief Filename for the disk-persisted OCIO shader text and LUT data of this transform
+   *
+   * OCIO shader generation is deterministic for a processor cache ID, so the generated text and
+   * LUT arrays are valid across sessions - unlike program binaries, they aren't driver-specific.
+   */
+  static QString GetColorContextCacheFilename(const ColorTransformJob &color_job, const QString &function_name, bool baked);
+
+  /**
+   * @brief Restore persisted shader text and LUT textures, returns false on miss or corruption
+   */
+  bool LoadColorContextFromDisk(const QString &filename, ColorContext *ctx, QString *shader_text);
+
+  void SaveColorContextToDisk(const QString &filename, const OCIO::GpuShaderDescRcPtr &shader_desc);
+
+  static const quint32 kColorContextCacheVersion = 1;
+
+  // Lattice resolution for baked transforms - 65^3 is the conventional grading LUT size,
+  // enough for smooth view transforms without a large texture upload
+  static const unsigned int kBakedLutEdgeLength = 65;
+
   void ClearOldTextures();
 
   QHash<QString, ColorContext> color_cache_;
 
-  struct CachedTexture
+  struct TexturePoolKey
   {
     int width;
     int height;
     int depth;
     PixelFormat format;
     int channel_count;
+
+    bool operator==(const TexturePoolKey &rhs) const
+    {
+      return width == rhs.width && height == rhs.height && depth == rhs.depth
+          && format == rhs.format && channel_count == rhs.channel_count;
+    }
+  };
+
+  friend uint qHash(const TexturePoolKey &key, uint seed)
+  {
+    return qHash(key.width, seed) ^ qHash(key.height, seed) ^ qHash(key.depth, seed)
+        ^ qHash(static_cast<int>(static_cast<PixelFormat::Format>(key.format)), seed)
+        ^ qHash(key.channel_count, seed);
+  }
+
+  struct PooledTexture
+  {
     QVariant handle;
     qint64 accessed;
   };
 
+  static TexturePoolKey GetTexturePoolKey(const VideoParams &params)
+  {
+    return {params.effective_width(), params.effective_height(), params.effective_depth(),
+            params.format(), params.channel_count()};
+  }
+
+  static qint64 GetTextureSize(const TexturePoolKey &key)
+  {
+    return qint64(key.width) * key.height * qMax(key.depth, 1)
+        * VideoParams::GetBytesPerPixel(key.format, key.channel_count);
+  }
+
+  /**
+   * @brief Destroy least-recently-used pooled textures until `bytes` have been freed
+   *
+   * Called when an allocation would exceed the texture memory budget. Only the reuse pool is
+   * evicted - textures currently in use are untouched, so going over budget with live textures
+   * degrades into pool misses rather than failures.
+   */
+  void EvictPooledTextures(qint64 bytes);
+
   static const int MAX_TEXTURE_LIFE = 5000;
   static const bool USE_TEXTURE_CACHE = true;
-  std::list<CachedTexture> texture_cache_;
+
+  // Free lists of destroyed-but-reusable textures keyed by size/format so
+  // CreateTexture can reuse without scanning every pooled texture
+  QHash<TexturePoolKey, std::list<PooledTexture> > texture_pool_;
 
   QMutex color_cache_mutex_;
 
   QVariant default_shader_;
 
+  bool profiler_enabled_;
+
+  QAtomicInteger<qint64> profiler_blit_time_ns_;
+
+  QAtomicInteger<qint64> texture_memory_usage_;
+
   QVariant interlace_texture_;
 
   QMutex texture_cache_lock_;
@@ -24,12 +24,30 @@ namespace olive {
 
 void RenderJobTracker::insert(const TimeRange &range, JobTime job_time)
 {
-  // First remove any ranges with this (code copied
-  TimeRangeList::util_remove(&jobs_, range);
+  if (range.in() >= range.out()) {
+    return;
+  }
+
+  // Remember what resumes after this range before its boundaries are overwritten
+  Segment resume = GetSegmentAt(range.out());
+
+  // Drop all boundaries inside the range, including one exactly at its out point since `resume`
+  // already carries that state
+  boundaries_.erase(boundaries_.lower_bound(range.in()), boundaries_.upper_bound(range.out()));
+
+  boundaries_[range.out()] = resume;
+  boundaries_[range.in()] = {job_time, true};
+
+  // Coalesce identical adjacent segments so the map stays proportional to distinct regions
+  auto in_it = boundaries_.find(range.in());
+
+  if (resume == in_it->second) {
+    boundaries_.erase(boundaries_.find(range.out()));
+  }
 
-  // Now append the job
-  TimeRangeWithJob job(range, job_time);
-  jobs_.push_back(job);
+  if (in_it != boundaries_.begin() && std::prev(in_it)->second == in_it->second) {
+    boundaries_.erase(in_it);
+  }
 }
 
 void RenderJobTracker::insert(const TimeRangeList &ranges, JobTime job_time)
@@ -41,31 +59,58 @@ void RenderJobTracker::insert(const TimeRangeList &ranges, JobTime job_time)
 
 void RenderJobTracker::clear()
 {
-  jobs_.clear();
+  boundaries_.clear();
 }
 
 bool RenderJobTracker::isCurrent(const rational &time, JobTime job_time) const
 {
-  for (auto it=jobs_.crbegin(); it!=jobs_.crend(); it++) {
-    if (it->Contains(time)) {
-      return job_time >= it->GetJobTime();
-    }
-  }
+  Segment s = GetSegmentAt(time);
 
-  return false;
+  return s.valid && job_time >= s.job_time;
 }
 
 TimeRangeList RenderJobTracker::getCurrentSubRanges(const TimeRange &range, const JobTime &job_time) const
 {
   TimeRangeList current_ranges;
 
-  for (auto it=jobs_.crbegin(); it!=jobs_.crend(); it++) {
-    if (job_time >= it->GetJobTime() && it->OverlapsWith(range)) {
-      current_ranges.insert(it->Intersected(range));
+  if (boundaries_.empty() || range.in() >= range.out()) {
+    return current_ranges;
+  }
+
+  // Start at the segment containing the range's in point
+  auto it = boundaries_.upper_bound(range.in());
+  if (it != boundaries_.begin()) {
+    it--;
+  }
+
+  for (; it!=boundaries_.end() && it->first < range.out(); it++) {
+    if (!it->second.valid || job_time < it->second.job_time) {
+      continue;
+    }
+
+    auto next = std::next(it);
+
+    rational sub_in = qMax(it->first, range.in());
+    rational sub_out = (next == boundaries_.end()) ? range.out() : qMin(next->first, range.out());
+
+    if (sub_out > sub_in) {
+      current_ranges.insert(TimeRange(sub_in, sub_out));
     }
   }
 
   return current_ranges;
 }
 
+RenderJobTracker::Segment RenderJobTracker::GetSegmentAt(const rational &time) const
+{
+  auto it = boundaries_.upper_bound(time);
+
+  if (it == boundaries_.begin()) {
+    // Nothing has ever been tracked at or before this time
+    return Segment();
+  }
+
+  return std::prev(it)->second;
+}
+
 }
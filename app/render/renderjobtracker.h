@@ -21,6 +21,8 @@
 #ifndef RENDERJOBTRACKER_H
 #define RENDERJOBTRACKER_H
 
+#include <map>
+
 #include <olive/core/core.h>
 
 #include "common/jobtime.h"
@@ -44,25 +46,38 @@ public:
   TimeRangeList getCurrentSubRanges(const TimeRange &range, const JobTime &job_time) const;
 
 private:
-  class TimeRangeWithJob : public TimeRange
+  /**
+   * @brief State of the timeline between one boundary and the next
+   */
+  struct Segment
   {
-  public:
-    TimeRangeWithJob() = default;
-    TimeRangeWithJob(const TimeRange &range, const JobTime &job_time)
+    JobTime job_time;
+    bool valid = false;
+
+    bool operator==(const Segment &rhs) const
     {
-      set_range(range.in(), range.out());
-      job_time_ = job_time;
+      return valid == rhs.valid && (!valid || job_time == rhs.job_time);
     }
 
-    JobTime GetJobTime() const {return job_time_;}
-    void SetJobTime(JobTime jt) {job_time_ = jt;}
-
-  private:
-    JobTime job_time_;
-
+    bool operator!=(const Segment &rhs) const
+    {
+      return !(*this == rhs);
+    }
   };
 
-  std::vector<TimeRangeWithJob> jobs_;
+  /**
+   * @brief Get the segment containing `time`, or an invalid segment if nothing covers it
+   */
+  Segment GetSegmentAt(const rational &time) const;
+
+  /**
+   * @brief Ordered boundary map: each entry describes the span from its key to the next key
+   *
+   * Adjacent identical segments are coalesced on insert and the final entry is always invalid,
+   * so the map stays proportional to the number of distinct rendered regions rather than the
+   * number of inserts, and lookups are O(log n) however fragmented the timeline gets.
+   */
+  std::map<rational, Segment> boundaries_;
 
 };
 
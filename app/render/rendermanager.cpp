@@ -21,12 +21,19 @@
 #include "rendermanager.h"
 
 #include <QApplication>
+#include <QDateTime>
 #include <QMatrix4x4>
 #include <QThread>
 
+#include "common/memorytelemetry.h"
+#include "common/performancelog.h"
+#include "common/tracerecorder.h"
 #include "config/config.h"
 #include "core.h"
+#include "node/project/footage/footage.h"
+#include "render/dummy/dummyrenderer.h"
 #include "render/opengl/openglrenderer.h"
+#include "render/vulkan/vulkanrenderer.h"
 #include "renderprocessor.h"
 #include "task/conform/conform.h"
 #include "task/taskmanager.h"
@@ -39,29 +46,93 @@ const rational RenderManager::kDryRunInterval = rational(10);
 
 RenderManager::RenderManager(QObject *parent) :
   backend_(kOpenGL),
-  aggressive_gc_(0)
+  aggressive_gc_(0),
+  project_(nullptr),
+  interactive_latency_ms_(0),
+  last_interactive_report_(0)
 {
+  if (OLIVE_CONFIG("RenderBackend").toString() == QStringLiteral("dummy")) {
+    // No-op backend for exercising the threading/codec pipeline without a GPU
+    backend_ = kDummy;
+    context_ = new DummyRenderer();
+    decoder_cache_ = new DecoderCache();
+    shader_cache_ = new ShaderCache();
+  }
+
+#ifdef USE_VULKAN
+  if (backend_ == kOpenGL && OLIVE_CONFIG("RenderBackend").toString() == QStringLiteral("vulkan")) {
+    VulkanRenderer *vulkan = new VulkanRenderer();
+    if (vulkan->Init()) {
+      backend_ = kVulkan;
+      context_ = vulkan;
+      decoder_cache_ = new DecoderCache();
+      shader_cache_ = new ShaderCache();
+    } else {
+      // Fall through to the OpenGL path below
+      qWarning() << "Failed to initialize Vulkan backend, falling back to OpenGL";
+      delete vulkan;
+    }
+  }
+#endif
+
   if (backend_ == kOpenGL) {
     context_ = new OpenGLRenderer();
     decoder_cache_ = new DecoderCache();
     shader_cache_ = new ShaderCache();
-  } else {
+  } else if (backend_ != kVulkan && backend_ != kDummy) {
     qCritical() << "Tried to initialize unknown graphics backend";
     context_ = nullptr;
     decoder_cache_ = nullptr;
   }
 
+  cache_context_ = nullptr;
+  cache_video_thread_ = nullptr;
+  cache_shader_cache_ = nullptr;
+
   if (context_) {
     video_thread_ = CreateThread(context_);
     dry_run_thread_ = CreateThread();
     audio_thread_ = CreateThread();
 
+    if (OLIVE_CONFIG("SeparateCacheContext").toBool() && backend_ != kDummy) {
+      // Give background cache renders their own context. On multi-GPU systems the driver's
+      // device selection controls can place this context on the second card, letting cache
+      // fills run in parallel with interactive playback.
+#ifdef USE_VULKAN
+      if (backend_ == kVulkan) {
+        cache_context_ = new VulkanRenderer();
+      } else
+#endif
+      {
+        cache_context_ = new OpenGLRenderer();
+      }
+
+      cache_shader_cache_ = new ShaderCache();
+      cache_video_thread_ = CreateThread(cache_context_, cache_shader_cache_);
+    }
+
+    // All waveform threads drain one shared queue, so tickets go to whichever thread frees up
+    // first rather than being assigned round-robin where one slow waveform can back others up
+    // behind it while sibling threads idle
+    waveform_queue_ = CreateTicketQueue();
     waveform_threads_.resize(QThread::idealThreadCount());
     for (size_t i=0; i<waveform_threads_.size(); i++) {
-      waveform_threads_[i] = CreateThread();
+      waveform_threads_[i] = CreateThread(nullptr, nullptr, waveform_queue_);
     }
 
     auto_cacher_ = new PreviewAutoCacher(this);
+
+    Renderer *main_ctx = context_;
+    MemoryTelemetry::instance()->RegisterSource(QStringLiteral("Texture memory (main context)"), [main_ctx]{
+      return main_ctx->GetTextureMemoryUsage();
+    });
+
+    if (cache_context_) {
+      Renderer *cache_ctx = cache_context_;
+      MemoryTelemetry::instance()->RegisterSource(QStringLiteral("Texture memory (cache context)"), [cache_ctx]{
+        return cache_ctx->GetTextureMemoryUsage();
+      });
+    }
   }
 
   decoder_clear_timer_ = new QTimer(this);
@@ -73,6 +144,10 @@ RenderManager::RenderManager(QObject *parent) :
 RenderManager::~RenderManager()
 {
   if (context_) {
+    // The telemetry getters capture the renderer pointers, so they must go before the renderers
+    MemoryTelemetry::instance()->UnregisterSource(QStringLiteral("Texture memory (main context)"));
+    MemoryTelemetry::instance()->UnregisterSource(QStringLiteral("Texture memory (cache context)"));
+
     delete shader_cache_;
     delete decoder_cache_;
 
@@ -81,21 +156,57 @@ RenderManager::~RenderManager()
       rt->wait();
     }
 
+    for (RenderTicketQueue *q : ticket_queues_) {
+      delete q;
+    }
+
     context_->PostDestroy();
     delete context_;
+
+    if (cache_context_) {
+      cache_context_->PostDestroy();
+      delete cache_context_;
+      delete cache_shader_cache_;
+    }
   }
 }
 
-RenderThread *RenderManager::CreateThread(Renderer *renderer)
+RenderThread *RenderManager::CreateThread(Renderer *renderer, ShaderCache *shader_cache, RenderTicketQueue *queue)
 {
-  auto t = new RenderThread(renderer, decoder_cache_, shader_cache_, this);
+  if (!queue) {
+    queue = CreateTicketQueue();
+  }
+
+  auto t = new RenderThread(queue, renderer, decoder_cache_, shader_cache ? shader_cache : shader_cache_, this);
   render_threads_.push_back(t);
   t->start(QThread::IdlePriority);
   return t;
 }
 
+RenderTicketQueue *RenderManager::CreateTicketQueue()
+{
+  auto q = new RenderTicketQueue();
+  ticket_queues_.push_back(q);
+  return q;
+}
+
 RenderTicketPtr RenderManager::RenderFrame(const RenderVideoParams &params)
 {
+  // When several systems (autocache, thumbnails, the viewer) want the same frame with the same
+  // parameters, hand them all the same in-flight ticket instead of rendering it several times.
+  // Requests with a custom matrix are rare and awkward to key, so they always render fresh.
+  QString dedup_key;
+  if (params.force_matrix.isIdentity()) {
+    dedup_key = GetVideoTicketKey(params);
+
+    QMutexLocker locker(&video_ticket_dedup_lock_);
+
+    RenderTicketPtr existing = video_ticket_dedup_.value(dedup_key).lock();
+    if (existing && existing->GetFinishCount() == 0 && !existing->IsCancelled()) {
+      return existing;
+    }
+  }
+
   // Create ticket
   RenderTicketPtr ticket = std::make_shared<RenderTicket>();
 
@@ -103,6 +214,7 @@ RenderTicketPtr RenderManager::RenderFrame(const RenderVideoParams &params)
   ticket->setProperty("time", QVariant::fromValue(params.time));
   ticket->setProperty("size", params.force_size);
   ticket->setProperty("matrix", params.force_matrix);
+  ticket->setProperty("roi", params.force_roi);
   ticket->setProperty("format", static_cast<PixelFormat::Format>(params.force_format));
   ticket->setProperty("usecache", params.use_cache);
   ticket->setProperty("channelcount", params.force_channel_count);
@@ -119,8 +231,47 @@ RenderTicketPtr RenderManager::RenderFrame(const RenderVideoParams &params)
   ticket->setProperty("cacheid", QVariant::fromValue(params.cache_id));
   ticket->setProperty("multicam", QtUtils::PtrToValue(params.multicam));
 
+  // QoS class: cache fills (the tickets that carry a cache directory) and anything explicitly
+  // flagged (background exports) are background work, everything else is an interactive
+  // request whose latency we track
+  const bool is_background = params.background || !params.cache_dir.isEmpty();
+  ticket->setProperty("background", is_background);
+  if (!is_background) {
+    ticket->setProperty("enqueued", QDateTime::currentMSecsSinceEpoch());
+  }
+
+  if (!dedup_key.isEmpty()) {
+    QMutexLocker locker(&video_ticket_dedup_lock_);
+
+    video_ticket_dedup_.insert(dedup_key, ticket);
+
+    // Entries are also dropped when the ticket finishes. Finished is emitted from a render
+    // thread and this connection is queued, so a just-finished ticket can briefly linger in the
+    // table - the GetFinishCount() check above keeps it from being handed out again.
+    connect(ticket.get(), &RenderTicket::Finished, this, [this, dedup_key]{
+      QMutexLocker locker(&video_ticket_dedup_lock_);
+      video_ticket_dedup_.remove(dedup_key);
+    });
+
+    // Tickets cancelled before running never emit Finished, so sweep expired entries
+    // occasionally to keep the table from growing over a long session
+    if (video_ticket_dedup_.size() > 1000) {
+      for (auto it=video_ticket_dedup_.begin(); it!=video_ticket_dedup_.end(); ) {
+        if (it.value().expired()) {
+          it = video_ticket_dedup_.erase(it);
+        } else {
+          it++;
+        }
+      }
+    }
+  }
+
   if (params.return_type == ReturnType::kNull) {
     dry_run_thread_->AddTicket(ticket);
+  } else if (cache_video_thread_ && !params.cache_dir.isEmpty()) {
+    // Background cache fills (they're the only tickets that carry a cache directory) go to the
+    // dedicated cache context
+    cache_video_thread_->AddTicket(ticket);
   } else {
     video_thread_->AddTicket(ticket);
   }
@@ -128,6 +279,38 @@ RenderTicketPtr RenderManager::RenderFrame(const RenderVideoParams &params)
   return ticket;
 }
 
+QString RenderManager::GetVideoTicketKey(const RenderVideoParams &params)
+{
+  // Every parameter that affects the rendered output must be part of the key. Graph edits are
+  // covered too: the autocacher cancels its in-flight tickets when the graph changes, and
+  // cancelled tickets are never handed out again.
+  QStringList parts;
+
+  parts << QString::number(reinterpret_cast<quintptr>(params.node), 16);
+  parts << QString::fromStdString(params.time.toString());
+  parts << QString::number(params.video_params.width());
+  parts << QString::number(params.video_params.height());
+  parts << QString::number(params.video_params.divider());
+  parts << QString::number(static_cast<PixelFormat::Format>(params.video_params.format()));
+  parts << QString::number(params.mode);
+  parts << QString::number(params.return_type);
+  parts << QString::number(params.use_cache);
+  parts << params.cache_id;
+  parts << QString::number(params.force_size.width());
+  parts << QString::number(params.force_size.height());
+  parts << QString::number(params.force_roi.x());
+  parts << QString::number(params.force_roi.y());
+  parts << QString::number(params.force_roi.width());
+  parts << QString::number(params.force_roi.height());
+  parts << QString::number(params.force_channel_count);
+  parts << QString::number(static_cast<PixelFormat::Format>(params.force_format));
+  parts << QString::number(reinterpret_cast<quintptr>(params.color_manager), 16);
+  parts << QString::number(reinterpret_cast<quintptr>(params.force_color_output.get()), 16);
+  parts << QString::number(reinterpret_cast<quintptr>(params.multicam), 16);
+
+  return parts.join(QLatin1Char(':'));
+}
+
 RenderTicketPtr RenderManager::RenderAudio(const RenderAudioParams &params)
 {
   // Create ticket
@@ -140,14 +323,12 @@ RenderTicketPtr RenderManager::RenderAudio(const RenderAudioParams &params)
   ticket->setProperty("clamp", params.clamp);
   ticket->setProperty("aparam", QVariant::fromValue(params.audio_params));
   ticket->setProperty("mode", params.mode);
+  ticket->setProperty("background", params.background);
 
   if (params.generate_waveforms) {
-    size_t thread_index = last_waveform_thread_%waveform_threads_.size();
-    RenderThread *thread = waveform_threads_[thread_index];
-    thread->AddTicket(ticket);
-    last_waveform_thread_++;
+    waveform_queue_->AddTicket(ticket);
   } else {
-    audio_thread_->AddTicket(ticket);
+    audio_thread_->AddTicket(ticket, params.prioritize);
   }
 
   return ticket;
@@ -155,8 +336,8 @@ RenderTicketPtr RenderManager::RenderAudio(const RenderAudioParams &params)
 
 bool RenderManager::RemoveTicket(RenderTicketPtr ticket)
 {
-  for (RenderThread *rt : render_threads_) {
-    if (rt->RemoveTicket(ticket)) {
+  for (RenderTicketQueue *q : ticket_queues_) {
+    if (q->RemoveTicket(ticket)) {
       return true;
     }
   }
@@ -164,6 +345,43 @@ bool RenderManager::RemoveTicket(RenderTicketPtr ticket)
   return false;
 }
 
+void RenderManager::ReportInteractiveTicketLatency(qint64 ms)
+{
+  // Keep a short exponential moving average so one slow frame doesn't throttle caching for
+  // long, but a sustained slowdown shows up within a few tickets. The load/store pair can race
+  // between render threads - that only smudges the average slightly, which is fine for a
+  // throttling heuristic.
+  int avg = interactive_latency_ms_.load(std::memory_order_relaxed);
+  interactive_latency_ms_.store((avg * 3 + int(ms)) / 4, std::memory_order_relaxed);
+  last_interactive_report_.store(QDateTime::currentMSecsSinceEpoch(), std::memory_order_relaxed);
+
+  if (PerformanceLog *perf = PerformanceLog::instance()) {
+    perf->RecordTicketLatency(ms);
+  }
+}
+
+int RenderManager::GetBackgroundTicketLimit() const
+{
+  // If nothing interactive has rendered recently, the user isn't scrubbing or playing back and
+  // caching can use full concurrency regardless of what the last measurement said
+  static const qint64 kInteractiveIdleMs = 2000;
+  static const int kFullLimit = 4;
+
+  if (QDateTime::currentMSecsSinceEpoch() - last_interactive_report_.load(std::memory_order_relaxed) > kInteractiveIdleMs) {
+    return kFullLimit;
+  }
+
+  int latency = interactive_latency_ms_.load(std::memory_order_relaxed);
+
+  if (latency > 250) {
+    return 1;
+  } else if (latency > 100) {
+    return 2;
+  }
+
+  return kFullLimit;
+}
+
 void RenderManager::SetAggressiveGarbageCollection(bool enabled)
 {
   aggressive_gc_ += enabled ? 1 : -1;
@@ -177,44 +395,121 @@ void RenderManager::SetAggressiveGarbageCollection(bool enabled)
 
 void RenderManager::ClearOldDecoders()
 {
-  QMutexLocker locker(decoder_cache_->mutex());
-
   qint64 min_age = QDateTime::currentMSecsSinceEpoch() - kDecoderMaximumInactivity;
 
-  for (auto it=decoder_cache_->begin(); it!=decoder_cache_->end(); ) {
-    DecoderPair decoder = it.value();
+  struct IdleDecoder {
+    int shard;
+    Decoder::CodecStream stream;
+    qint64 last_accessed;
+  };
+
+  // Still-image footage referenced by the open project keeps its decoder - and with it the
+  // decoded texture the decoder holds - resident regardless of inactivity. A logo that sits on
+  // screen for an hour is only touched on invalidations, and re-reading and re-uploading it
+  // every time it idles out is a visible decode spike for motionless pixels. The pin lapses
+  // when the file stops being referenced or the project closes.
+  QSet<QString> pinned_stills;
+  if (project_) {
+    foreach (Node *node, project_->nodes()) {
+      if (Footage *footage = dynamic_cast<Footage*>(node)) {
+        for (int i=0; i<footage->GetVideoStreamCount(); i++) {
+          if (footage->GetVideoParams(i).video_type() == VideoParams::kVideoTypeStill) {
+            pinned_stills.insert(footage->filename());
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  // Survey all shards first so retention can be decided across the whole cache
+  std::vector<IdleDecoder> idle;
+  int active_count = 0;
 
-    if (decoder.decoder->GetLastAccessedTime() < min_age) {
-      decoder.decoder->Close();
-      it = decoder_cache_->erase(it);
-    } else {
-      it++;
+  for (int i=0; i<DecoderCache::kShardCount; i++) {
+    DecoderCache::Shard &shard = decoder_cache_->shard(i);
+    QMutexLocker locker(shard.mutex());
+
+    for (auto it=shard.map().begin(); it!=shard.map().end(); it++) {
+      if (pinned_stills.contains(it.key().filename())) {
+        // Neither idle nor counted against the retention cap
+        continue;
+      }
+
+      qint64 t = it.value().decoder->GetLastAccessedTime();
+
+      if (t < min_age) {
+        idle.push_back({i, it.key(), t});
+      } else {
+        active_count++;
+      }
+    }
+  }
+
+  // Retain the most recently used idle decoders up to the cap. Aggressive collection mode
+  // (enabled during playback to keep memory available) skips retention entirely, matching the
+  // old behavior of closing everything inactive.
+  size_t retain = aggressive_gc_ > 0 ? 0 : qMax(0, kDecoderRetentionCap - active_count);
+
+  if (idle.size() <= retain) {
+    return;
+  }
+
+  std::sort(idle.begin(), idle.end(), [](const IdleDecoder &a, const IdleDecoder &b) {
+    return a.last_accessed > b.last_accessed;
+  });
+
+  for (size_t i=retain; i<idle.size(); i++) {
+    DecoderCache::Shard &shard = decoder_cache_->shard(idle[i].shard);
+    QMutexLocker locker(shard.mutex());
+
+    auto it = shard.map().find(idle[i].stream);
+    if (it == shard.map().end()) {
+      continue;
+    }
+
+    // Re-check under the lock in case the decoder was accessed since the survey
+    if (it.value().decoder->GetLastAccessedTime() >= min_age) {
+      continue;
     }
+
+    it.value().decoder->Close();
+    shard.map().erase(it);
   }
 }
 
-RenderThread::RenderThread(Renderer *renderer, DecoderCache *decoder_cache, ShaderCache *shader_cache, QObject *parent) :
-  QThread(parent),
-  cancelled_(false),
-  context_(renderer),
-  decoder_cache_(decoder_cache),
-  shader_cache_(shader_cache)
+RenderTicketQueue::RenderTicketQueue() :
+  cancelled_(false)
 {
-  if (context_) {
-    context_->Init();
-    context_->moveToThread(this);
-  }
 }
 
-void RenderThread::AddTicket(RenderTicketPtr ticket)
+void RenderTicketQueue::AddTicket(RenderTicketPtr ticket, bool prioritize)
 {
   QMutexLocker locker(&mutex_);
-  ticket->moveToThread(this);
-  queue_.push_back(ticket);
+
+  // The consuming thread isn't known until a consumer takes the ticket, so clear its thread
+  // affinity here - an object with no thread affinity can be "pulled" by any thread, which
+  // TakeTicket() does
+  ticket->moveToThread(nullptr);
+
+  if (prioritize) {
+    queue_.push_front(ticket);
+  } else if (!ticket->property("background").toBool()) {
+    // Interactive tickets queue ahead of background ones (but behind other interactive
+    // tickets, which stay FIFO among themselves)
+    auto it = queue_.begin();
+    while (it != queue_.end() && !(*it)->property("background").toBool()) {
+      it++;
+    }
+    queue_.insert(it, ticket);
+  } else {
+    queue_.push_back(ticket);
+  }
+
   wait_.wakeOne();
 }
 
-bool RenderThread::RemoveTicket(RenderTicketPtr ticket)
+bool RenderTicketQueue::RemoveTicket(RenderTicketPtr ticket)
 {
   QMutexLocker locker(&mutex_);
 
@@ -227,46 +522,87 @@ bool RenderThread::RemoveTicket(RenderTicketPtr ticket)
   return true;
 }
 
-void RenderThread::quit()
+RenderTicketPtr RenderTicketQueue::TakeTicket()
+{
+  QMutexLocker locker(&mutex_);
+
+  while (!cancelled_) {
+    if (!queue_.empty()) {
+      RenderTicketPtr ticket = queue_.front();
+      queue_.pop_front();
+      ticket->moveToThread(QThread::currentThread());
+      return ticket;
+    }
+
+    wait_.wait(&mutex_);
+  }
+
+  return nullptr;
+}
+
+void RenderTicketQueue::Shutdown()
 {
   QMutexLocker locker(&mutex_);
   cancelled_ = true;
-  wait_.wakeOne();
+  wait_.wakeAll();
 }
 
-void RenderThread::run()
+RenderThread::RenderThread(RenderTicketQueue *queue, Renderer *renderer, DecoderCache *decoder_cache, ShaderCache *shader_cache, QObject *parent) :
+  QThread(parent),
+  queue_(queue),
+  context_(renderer),
+  decoder_cache_(decoder_cache),
+  shader_cache_(shader_cache)
 {
   if (context_) {
-    context_->PostInit();
+    context_->Init();
+    context_->moveToThread(this);
   }
+}
 
-  QMutexLocker locker(&mutex_);
-
-  while (!cancelled_) {
-    if (queue_.empty()) {
-      wait_.wait(&mutex_);
-    }
+void RenderThread::quit()
+{
+  // Queues may be shared between threads, so this stops every thread consuming this queue, not
+  // just this one
+  queue_->Shutdown();
+}
 
-    if (cancelled_) {
-      break;
-    }
+void RenderThread::run()
+{
+  if (context_) {
+    context_->PostInit();
+  }
 
-    if (!queue_.empty()) {
-      RenderTicketPtr ticket = queue_.front();
-      queue_.pop_front();
+  while (RenderTicketPtr ticket = queue_->TakeTicket()) {
+    // Setup the ticket for ::Process
+    ticket->Start();
 
-      locker.unlock();
+    if (ticket->IsCancelled()) {
+      ticket->Finish();
+    } else {
+      TraceRecorder *trace = TraceRecorder::instance();
+      QString trace_name;
+      if (trace) {
+        if (ticket->property("type").value<RenderManager::TicketType>() == RenderManager::kTypeVideo) {
+          trace_name = QStringLiteral("Video %1").arg(QString::fromStdString(ticket->property("time").value<rational>().toString()));
+        } else {
+          trace_name = QStringLiteral("Audio");
+        }
+        trace->BeginEvent("ticket", trace_name);
+      }
 
-      // Setup the ticket for ::Process
-      ticket->Start();
+      RenderProcessor::Process(ticket, context_, decoder_cache_, shader_cache_);
 
-      if (ticket->IsCancelled()) {
-        ticket->Finish();
-      } else {
-        RenderProcessor::Process(ticket, context_, decoder_cache_, shader_cache_);
+      if (trace) {
+        trace->EndEvent("ticket", trace_name);
       }
 
-      locker.relock();
+      // Interactive tickets are stamped at request time so we can throttle background caching
+      // off their request-to-completion latency
+      qint64 enqueued = ticket->property("enqueued").toLongLong();
+      if (enqueued > 0) {
+        RenderManager::instance()->ReportInteractiveTicketLatency(QDateTime::currentMSecsSinceEpoch() - enqueued);
+      }
     }
   }
 
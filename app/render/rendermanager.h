@@ -21,6 +21,7 @@
 #ifndef RENDERBACKEND_H
 #define RENDERBACKEND_H
 
+#include <atomic>
 #include <QtConcurrent/QtConcurrent>
 
 #include "config/config.h"
@@ -36,20 +37,38 @@
 
 namespace olive {
 
-class RenderThread : public QThread
+/**
+ * @brief Thread-safe ticket queue consumed by one or more RenderThreads
+ *
+ * When a homogeneous group of threads (e.g. the waveform threads) shares one queue, each thread
+ * simply takes the next ticket as it becomes free, so distribution self-balances without any
+ * assignment policy and no thread idles while a sibling's backlog is deep. Cancelling a queued
+ * ticket is likewise a single scan of one queue rather than one per thread.
+ *
+ * Tickets carry a QoS class in their "background" property. Interactive tickets are inserted
+ * ahead of any queued background tickets so a viewer request never waits behind a burst of
+ * cache fills when both classes share a thread.
+ */
+class RenderTicketQueue
 {
-  Q_OBJECT
 public:
-  RenderThread(Renderer *renderer, DecoderCache *decoder_cache, ShaderCache *shader_cache, QObject *parent = nullptr);
+  RenderTicketQueue();
 
-  void AddTicket(RenderTicketPtr ticket);
+  void AddTicket(RenderTicketPtr ticket, bool prioritize = false);
 
   bool RemoveTicket(RenderTicketPtr ticket);
 
-  void quit();
+  /**
+   * @brief Block until a ticket is available and take it
+   *
+   * Returns nullptr if Shutdown() has been called.
+   */
+  RenderTicketPtr TakeTicket();
 
-protected:
-  virtual void run() override;
+  /**
+   * @brief Permanently wake all consumers so their threads can exit
+   */
+  void Shutdown();
 
 private:
   QMutex mutex_;
@@ -60,6 +79,27 @@ private:
 
   bool cancelled_;
 
+};
+
+class RenderThread : public QThread
+{
+  Q_OBJECT
+public:
+  RenderThread(RenderTicketQueue *queue, Renderer *renderer, DecoderCache *decoder_cache, ShaderCache *shader_cache, QObject *parent = nullptr);
+
+  void AddTicket(RenderTicketPtr ticket, bool prioritize = false)
+  {
+    queue_->AddTicket(ticket, prioritize);
+  }
+
+  void quit();
+
+protected:
+  virtual void run() override;
+
+private:
+  RenderTicketQueue *queue_;
+
   Renderer *context_;
 
   DecoderCache *decoder_cache_;
@@ -76,6 +116,10 @@ public:
     /// Graphics acceleration provided by OpenGL
     kOpenGL,
 
+    /// Experimental graphics acceleration provided by Vulkan compute queues,
+    /// only available when compiled with USE_VULKAN
+    kVulkan,
+
     /// No graphics rendering - used to test core threading logic
     kDummy
   };
@@ -119,6 +163,7 @@ public:
       force_channel_count = 0;
       mode = m;
       multicam = nullptr;
+      background = false;
     }
 
     void AddCache(FrameHashCache *cache)
@@ -138,6 +183,10 @@ public:
     RenderMode::Mode mode;
     MultiCamNode *multicam;
 
+    /// Force background QoS even without a cache dir - used by background exports so their
+    /// frames never queue ahead of the editor's interactive requests
+    bool background;
+
     QString cache_dir;
     rational cache_timebase;
     QString cache_id;
@@ -145,6 +194,10 @@ public:
     QSize force_size;
     int force_channel_count;
     QMatrix4x4 force_matrix;
+
+    /// Optional region of interest in output pixels (top-left origin). When
+    /// set, only this region is blitted and downloaded into the final frame.
+    QRect force_roi;
     PixelFormat force_format;
     ColorProcessorPtr force_color_output;
   };
@@ -157,6 +210,10 @@ public:
    * The ticket from this function will return a FramePtr - the rendered frame in reference color
    * space.
    *
+   * If an identical request (same node, time and parameters) is already in flight, the existing
+   * ticket is returned rather than rendering the frame twice - RenderTicket supports any number
+   * of watchers, so callers don't need to know they're sharing one.
+   *
    * This function is thread-safe.
    */
   RenderTicketPtr RenderFrame(const RenderVideoParams &params);
@@ -169,6 +226,8 @@ public:
       audio_params = aparam;
       generate_waveforms = false;
       clamp = true;
+      prioritize = false;
+      background = false;
       mode = m;
     }
 
@@ -177,6 +236,13 @@ public:
     AudioParams audio_params;
     bool generate_waveforms;
     bool clamp;
+
+    /// Jump ahead of any queued audio tickets - used for latency-sensitive jobs like scrubbing
+    bool prioritize;
+
+    /// Queue behind any interactive audio tickets - used by background exports
+    bool background;
+
     RenderMode::Mode mode;
   };
 
@@ -191,6 +257,23 @@ public:
 
   bool RemoveTicket(RenderTicketPtr ticket);
 
+  /**
+   * @brief Record how long an interactive video ticket took from request to completion
+   *
+   * Called by render threads. Feeds the moving average that GetBackgroundTicketLimit() uses to
+   * throttle background caching while the user is scrubbing.
+   */
+  void ReportInteractiveTicketLatency(qint64 ms);
+
+  /**
+   * @brief How many background (cache fill) tickets may be in flight at once
+   *
+   * Shrinks as measured interactive ticket latency climbs so caching backs off while the user
+   * is actively scrubbing, and returns to full concurrency once interactive requests stop or
+   * get fast again.
+   */
+  int GetBackgroundTicketLimit() const;
+
   enum TicketType {
     kTypeVideo,
     kTypeAudio
@@ -208,6 +291,7 @@ public:
 
   void SetProject(Project *p)
   {
+    project_ = p;
     auto_cacher_->SetProject(p);
   }
 
@@ -221,7 +305,14 @@ private:
 
   virtual ~RenderManager() override;
 
-  RenderThread *CreateThread(Renderer *renderer = nullptr);
+  RenderThread *CreateThread(Renderer *renderer = nullptr, ShaderCache *shader_cache = nullptr, RenderTicketQueue *queue = nullptr);
+
+  RenderTicketQueue *CreateTicketQueue();
+
+  /**
+   * @brief Build the dedup key identifying a video render request - see RenderFrame()
+   */
+  static QString GetVideoTicketKey(const RenderVideoParams &params);
 
   static RenderManager* instance_;
 
@@ -236,19 +327,51 @@ private:
   static constexpr auto kDecoderMaximumInactivityAggressive = 1000;
   static constexpr auto kDecoderMaximumInactivity = 5000;
 
+  // Idle decoders are retained up to this many total rather than closed as soon as they go
+  // inactive, since reopening a stream (e.g. switching multicam angles) is far more expensive
+  // than keeping an idle demuxer around
+  static constexpr auto kDecoderRetentionCap = 32;
+
   int aggressive_gc_;
 
+  // Current project, used to pin still-image decoders - see ClearOldDecoders()
+  Project *project_;
+
   QTimer *decoder_clear_timer_;
 
   RenderThread *video_thread_;
   RenderThread *dry_run_thread_;
   RenderThread *audio_thread_;
 
+  // Optional second graphics context used exclusively for background cache fills so they don't
+  // contend with interactive playback. Native shader handles are context-specific, so this
+  // thread carries its own shader cache.
+  Renderer *cache_context_;
+  RenderThread *cache_video_thread_;
+  ShaderCache *cache_shader_cache_;
+
+  // Waveform generation is CPU-only, so these threads are interchangeable and drain one shared
+  // queue - see RenderTicketQueue
   std::vector<RenderThread *> waveform_threads_;
-  size_t last_waveform_thread_;
+  RenderTicketQueue *waveform_queue_;
 
   std::list<RenderThread *> render_threads_;
 
+  std::list<RenderTicketQueue *> ticket_queues_;
+
+  // Moving average of interactive video ticket latency and when it was last updated, written
+  // by render threads - see GetBackgroundTicketLimit()
+  std::atomic<int> interactive_latency_ms_;
+  std::atomic<qint64> last_interactive_report_;
+
+  /**
+   * @brief In-flight video tickets by dedup key - see RenderFrame()
+   *
+   * Weak pointers so an abandoned ticket can never be kept alive by this table.
+   */
+  QHash<QString, std::weak_ptr<RenderTicket> > video_ticket_dedup_;
+  QMutex video_ticket_dedup_lock_;
+
   PreviewAutoCacher *auto_cacher_;
 
 private slots:
@@ -20,15 +20,21 @@
 
 #include "renderprocessor.h"
 
+#include <QElapsedTimer>
 #include <QOpenGLContext>
+#include <QRegularExpression>
 #include <QVector2D>
 #include <QVector3D>
 #include <QVector4D>
+#include <QtConcurrent/QtConcurrent>
 
 #include "audio/audioprocessor.h"
+#include "audio/samplekernels.h"
+#include "config/config.h"
 #include "node/block/clip/clip.h"
 #include "node/block/transition/transition.h"
 #include "node/project.h"
+#include "render/framememorycache.h"
 #include "rendermanager.h"
 
 namespace olive {
@@ -39,7 +45,9 @@ RenderProcessor::RenderProcessor(RenderTicketPtr ticket, Renderer *render_ctx, D
   ticket_(ticket),
   render_ctx_(render_ctx),
   decoder_cache_(decoder_cache),
-  shader_cache_(shader_cache)
+  shader_cache_(shader_cache),
+  profiler_decode_ns_(0),
+  profiler_download_ns_(0)
 {
 }
 
@@ -70,6 +78,14 @@ FramePtr RenderProcessor::GenerateFrame(TexturePtr texture, const rational& time
     frame_params.set_height(frame_size.height());
   }
 
+  // A region of interest limits the final blit and download to the visible
+  // pixels, e.g. when the viewer is zoomed far in
+  QRect roi = ticket_->property("roi").toRect();
+  if (!roi.isEmpty()) {
+    frame_params.set_width(roi.width());
+    frame_params.set_height(roi.height());
+  }
+
   PixelFormat frame_format = static_cast<PixelFormat::Format>(ticket_->property("format").toInt());
   if (frame_format != PixelFormat::INVALID) {
     frame_params.set_format(frame_format);
@@ -101,7 +117,8 @@ FramePtr RenderProcessor::GenerateFrame(TexturePtr texture, const rational& time
 
       job.SetColorProcessor(output_color_transform);
       job.SetInputTexture(texture);
-      job.SetInputAlphaAssociation(OLIVE_CONFIG("ReassocLinToNonLin").toBool() ? kAlphaAssociated : kAlphaNone);
+      job.SetInputAlphaAssociation(Config::Cached().reassoc_lin_to_nonlin ? kAlphaAssociated : kAlphaNone);
+      job.SetBakedLutAllowed(render_mode() != RenderMode::kOnline);
 
       render_ctx_->BlitColorManaged(job, transform_tex.get());
 
@@ -115,6 +132,21 @@ FramePtr RenderProcessor::GenerateFrame(TexturePtr texture, const rational& time
 
       QMatrix4x4 matrix = ticket_->property("matrix").value<QMatrix4x4>();
 
+      if (!roi.isEmpty()) {
+        // Map the requested region to the full viewport so only its pixels
+        // are shaded and downloaded. ROI uses a top-left origin, so flip Y
+        // when converting to NDC.
+        double full_width = tex_params.effective_width();
+        double full_height = tex_params.effective_height();
+
+        QMatrix4x4 crop;
+        crop.scale(full_width / roi.width(), full_height / roi.height());
+        crop.translate(-((roi.x() + roi.width() * 0.5) / full_width * 2.0 - 1.0),
+                       -(1.0 - (roi.y() + roi.height() * 0.5) / full_height * 2.0));
+
+        matrix = crop * matrix;
+      }
+
       // No color transform, just blit
       ShaderJob job;
       job.Insert(QStringLiteral("ove_maintex"), NodeValue(NodeValue::kTexture, QVariant::fromValue(texture)));
@@ -128,7 +160,12 @@ FramePtr RenderProcessor::GenerateFrame(TexturePtr texture, const rational& time
 
     render_ctx_->Flush();
 
+    QElapsedTimer download_timer;
+    download_timer.start();
+
     render_ctx_->DownloadFromTexture(texture->id(), texture->params(), frame->data(), frame->linesize_pixels());
+
+    profiler_download_ns_ += download_timer.nsecsElapsed();
   }
 
   return frame;
@@ -143,6 +180,7 @@ void RenderProcessor::Run()
 
   SetCacheVideoParams(ticket_->property("vparam").value<VideoParams>());
   SetCacheAudioParams(ticket_->property("aparam").value<AudioParams>());
+  SetRenderMode(static_cast<RenderMode::Mode>(ticket_->property("mode").toInt()));
 
   if (IsCancelled()) {
     ticket_->Finish();
@@ -154,11 +192,30 @@ void RenderProcessor::Run()
   {
     rational time = ticket_->property("time").value<rational>();
 
+    bool profiling = Config::Cached().render_profiler;
+    if (render_ctx_ && profiling) {
+      render_ctx_->SetProfilerEnabled(true);
+      render_ctx_->TakeProfilerBlitTime();
+    }
+
     rational frame_length = GetCacheVideoParams().frame_rate_as_time_base();
     if (GetCacheVideoParams().interlacing() != VideoParams::kInterlaceNone) {
       frame_length /= 2;
     }
 
+    // Video traversal is otherwise single-threaded, so let independent branches fan out onto
+    // the pool. Audio gets its parallelism from the sample chunking in ProcessSamples.
+    //
+    // Multicam tickets are the exception: the side-render in GenerateDatabase fires wherever
+    // the traversal reaches the panel's MultiCamNode, and it calls ResolveJobs/BlitColorManaged
+    // (which need the GL context current on this thread) and writes ticket properties (QObject
+    // dynamic properties aren't thread-safe), so the whole traversal must stay on this thread.
+    SetBranchParallelismEnabled(!QtUtils::ValueToPtr<MultiCamNode>(ticket_->property("multicam")));
+
+    // Nested sequences with a valid cached frame are served from their cache instead of
+    // traversed. Video tickets only - a cached frame can't stand in for samples.
+    SetServeViewerCacheEnabled(UseCache());
+
     TexturePtr texture = GenerateTexture(time, frame_length);
 
     if (!render_ctx_) {
@@ -198,6 +255,13 @@ void RenderProcessor::Run()
           }
         }
 
+        if (profiling && render_ctx_) {
+          ticket_->setProperty("profiler_shader_ms", render_ctx_->TakeProfilerBlitTime() / 1e6);
+          ticket_->setProperty("profiler_decode_ms", profiler_decode_ns_ / 1e6);
+          ticket_->setProperty("profiler_download_ms", profiler_download_ns_ / 1e6);
+          ticket_->setProperty("profiler_vram_mb", render_ctx_->GetTextureMemoryUsage() / 1048576.0);
+        }
+
         if (return_type == RenderManager::kTexture) {
           // Return GPU texture
           if (!texture) {
@@ -231,7 +295,9 @@ void RenderProcessor::Run()
     SampleBuffer samples = sample_val.toSamples();
     if (samples.is_allocated()) {
       if (ticket_->property("clamp").toBool() && !IsCancelled()) {
-        samples.clamp();
+        for (int i=0; i<samples.audio_params().channel_count(); i++) {
+          SampleKernels::Clamp(samples.data(i), samples.sample_count());
+        }
       }
 
       if (ticket_->property("enablewaveforms").toBool() && !IsCancelled()) {
@@ -262,9 +328,10 @@ DecoderPtr RenderProcessor::ResolveDecoderFromInput(const QString& decoder_id, c
     return nullptr;
   }
 
-  QMutexLocker locker(decoder_cache_->mutex());
+  DecoderCache::Shard &shard = decoder_cache_->shard(stream);
+  QMutexLocker locker(shard.mutex());
 
-  DecoderPair decoder = decoder_cache_->value(stream);
+  DecoderPair decoder = shard.map().value(stream);
 
   qint64 file_last_modified = QFileInfo(stream.filename()).lastModified().toMSecsSinceEpoch();
 
@@ -276,7 +343,7 @@ DecoderPtr RenderProcessor::ResolveDecoderFromInput(const QString& decoder_id, c
     // No decoder
     decoder.decoder = dec = Decoder::CreateFromID(decoder_id);
     decoder.last_modified = file_last_modified;
-    decoder_cache_->insert(stream, decoder);
+    shard.map().insert(stream, decoder);
     locker.unlock();
 
     if (!dec->Open(stream)) {
@@ -302,6 +369,28 @@ NodeValueDatabase RenderProcessor::GenerateDatabase(const Node *node, const Time
     if (QtUtils::ValueToPtr<MultiCamNode>(ticket_->property("multicam")) == multicam) {
       int sz = multicam->GetSourceCount();
       QVector<TexturePtr> multicam_tex(sz);
+
+      // Each angle only occupies a 1/max(rows,cols) cell of the grid the display tiles these
+      // into, so render the sources at a proportionally larger divider. This threads through
+      // texture allocation, footage decoding and the globals each branch sees, making the
+      // whole grid cost roughly one frame's work instead of one full pipeline per angle.
+      int rows, cols;
+      MultiCamNode::GetRowsAndColumns(sz, &rows, &cols);
+
+      int desired_divider = GetCacheVideoParams().divider() * qMax(rows, cols);
+      int angle_divider = VideoParams::kSupportedDividers.last();
+      for (int d : VideoParams::kSupportedDividers) {
+        if (d >= desired_divider) {
+          angle_divider = d;
+          break;
+        }
+      }
+
+      const VideoParams ticket_params = GetCacheVideoParams();
+      VideoParams angle_params = ticket_params;
+      angle_params.set_divider(angle_divider);
+      SetCacheVideoParams(angle_params);
+
       for (int i=0; i<sz; i++) {
         NodeValueTable t = GenerateTable(multicam->GetConnectedRenderOutput(multicam->kSourcesInput, i), range, multicam);
         NodeValue val = GenerateRowValueElement(multicam, multicam->kSourcesInput, i, &t, range);
@@ -309,6 +398,8 @@ NodeValueDatabase RenderProcessor::GenerateDatabase(const Node *node, const Time
 
         multicam_tex[i] = val.toTexture();
       }
+
+      SetCacheVideoParams(ticket_params);
       ticket_->setProperty("multicam_output", QVariant::fromValue(multicam_tex));
     }
   }
@@ -316,6 +407,20 @@ NodeValueDatabase RenderProcessor::GenerateDatabase(const Node *node, const Time
   return db;
 }
 
+NodeTraverser *RenderProcessor::CreateBranchWorker()
+{
+  // Branch workers share the thread-safe decoder/shader caches but keep their own table
+  // cache, mirroring the chunk processors in ProcessSamples
+  RenderProcessor *worker = new RenderProcessor(ticket_, render_ctx_, decoder_cache_, shader_cache_);
+  worker->SetCancelPointer(GetCancelPointer());
+  worker->SetCacheVideoParams(GetCacheVideoParams());
+  worker->SetCacheAudioParams(GetCacheAudioParams());
+  worker->SetRenderMode(render_mode());
+  worker->SetBranchBudget(GetBranchBudget());
+  worker->SetServeViewerCacheEnabled(GetServeViewerCacheEnabled());
+  return worker;
+}
+
 void RenderProcessor::Process(RenderTicketPtr ticket, Renderer *render_ctx, DecoderCache *decoder_cache, ShaderCache *shader_cache)
 {
   RenderProcessor p(ticket, render_ctx, decoder_cache, shader_cache);
@@ -345,6 +450,10 @@ void RenderProcessor::ProcessVideoFootage(TexturePtr destination, const FootageJ
 
   Decoder::CodecStream default_codec_stream(stream->filename(), stream_data.stream_index(), GetCurrentBlock());
 
+  if (!stream->proxy_filename().isEmpty()) {
+    default_codec_stream.set_proxy(stream->proxy_filename(), stream->proxy_divider());
+  }
+
   QString decoder_id = stream->decoder();
 
   DecoderPtr decoder = nullptr;
@@ -389,8 +498,13 @@ void RenderProcessor::ProcessVideoFootage(TexturePtr destination, const FootageJ
         p.force_range = stream_data.color_range();
         p.src_interlacing = stream_data.interlacing();
 
+        QElapsedTimer decode_timer;
+        decode_timer.start();
+
         unmanaged_texture = decoder->RetrieveVideo(p);
 
+        profiler_decode_ns_ += decode_timer.nsecsElapsed();
+
         if (!IsCancelled() && unmanaged_texture) {
           // We convert to our rendering pixel format, since that will always be float-based which
           // is necessary for correct color conversion
@@ -412,6 +526,8 @@ void RenderProcessor::ProcessVideoFootage(TexturePtr destination, const FootageJ
             job.SetInputAlphaAssociation(kAlphaUnassociated);
           }
 
+          job.SetBakedLutAllowed(render_mode() != RenderMode::kOnline);
+
           render_ctx_->BlitColorManaged(job, destination.get());
         }
       }
@@ -446,9 +562,10 @@ void RenderProcessor::ProcessShader(TexturePtr destination, const Node *node, co
 
   QString full_shader_id = QStringLiteral("%1:%2").arg(node->id(), job->GetShaderID());
 
-  QMutexLocker locker(shader_cache_->mutex());
+  ShaderCache::Shard &shard_cache = shader_cache_->shard(full_shader_id);
+  QMutexLocker locker(shard_cache.mutex());
 
-  QVariant shader = shader_cache_->value(full_shader_id);
+  QVariant shader = shard_cache.map().value(full_shader_id);
 
   if (shader.isNull()) {
     // Since we have shader code, compile it now
@@ -459,7 +576,7 @@ void RenderProcessor::ProcessShader(TexturePtr destination, const Node *node, co
       return;
     }
 
-    shader_cache_->insert(full_shader_id, shader);
+    shard_cache.map().insert(full_shader_id, shader);
   }
 
   locker.unlock();
@@ -468,17 +585,201 @@ void RenderProcessor::ProcessShader(TexturePtr destination, const Node *node, co
   render_ctx_->BlitToTexture(shader, *job, destination.get());
 }
 
+QString RenderProcessor::GenerateFusedShaderCode(const QVector<ShaderPass> &chain)
+{
+  QString fused;
+
+  for (int i=0; i<chain.size(); i++) {
+    const ShaderPass &pass = chain.at(i);
+
+    QString src = pass.node->GetShaderCode(pass.job->GetShaderID()).frag_code();
+
+    if (src.isEmpty() || src.contains(QStringLiteral("#version"))) {
+      // Can't merge shaders with default code or their own version directive
+      return QString();
+    }
+
+    QString prefix = QStringLiteral("fuse%1_").arg(i);
+    const QString &input_key = pass.job->GetFusableInput();
+
+    // These are declared once by the fused main() below
+    src.remove(QRegularExpression(QStringLiteral("^\\s*in\\s+vec2\\s+ove_texcoord\\s*;"), QRegularExpression::MultilineOption));
+    src.remove(QRegularExpression(QStringLiteral("^\\s*out\\s+vec4\\s+frag_color\\s*;"), QRegularExpression::MultilineOption));
+
+    if (i > 0) {
+      // This pass's input is the previous pass, not a real texture, so drop
+      // the sampler declaration
+      src.remove(QRegularExpression(QStringLiteral("^\\s*uniform\\s+sampler2D\\s+%1\\s*;").arg(QRegularExpression::escape(input_key)), QRegularExpression::MultilineOption));
+    }
+
+    // Turn this pass's main() into a callable function. The input coordinate
+    // becomes a parameter with the same name the body already uses.
+    QRegularExpression main_regex(QStringLiteral("void\\s+main\\s*\\(\\s*(?:void)?\\s*\\)"));
+    if (!src.contains(main_regex)) {
+      return QString();
+    }
+    src.replace(main_regex, QStringLiteral("void %1main(vec2 ove_texcoord)").arg(prefix));
+    src.replace(QRegularExpression(QStringLiteral("\\bfrag_color\\b")), QStringLiteral("%1frag_color").arg(prefix));
+
+    // Namespace every job parameter (and any matching "_enabled" flag) so
+    // multiple instances of the same shader can coexist
+    for (auto it=pass.job->GetValues().constBegin(); it!=pass.job->GetValues().constEnd(); it++) {
+      src.replace(QRegularExpression(QStringLiteral("\\b%1(_enabled)?\\b").arg(QRegularExpression::escape(it.key()))),
+                  QStringLiteral("%1%2\\1").arg(prefix, it.key()));
+    }
+
+    QString pass_header = QStringLiteral("vec4 %1frag_color;\n").arg(prefix);
+
+    if (i > 0) {
+      // Reads of this pass's input become evaluations of the previous pass
+      QString prev_prefix = QStringLiteral("fuse%1_").arg(i-1);
+
+      pass_header.append(QStringLiteral("vec4 %1input(vec2 coord) {\n"
+                                        "  %2main(coord);\n"
+                                        "  return %2frag_color;\n"
+                                        "}\n").arg(prefix, prev_prefix));
+
+      QString prefixed_input = prefix + input_key;
+
+      src.replace(QRegularExpression(QStringLiteral("texture\\s*\\(\\s*%1\\s*,").arg(QRegularExpression::escape(prefixed_input))),
+                  QStringLiteral("%1input(").arg(prefix));
+
+      if (src.contains(QRegularExpression(QStringLiteral("\\b%1\\b").arg(QRegularExpression::escape(prefixed_input))))) {
+        // The pass reads its input in a way we don't know how to redirect
+        return QString();
+      }
+    }
+
+    fused.append(pass_header);
+    fused.append(src);
+    fused.append('\n');
+  }
+
+  fused.append(QStringLiteral("in vec2 ove_texcoord;\n"
+                              "out vec4 frag_color;\n\n"
+                              "void main() {\n"
+                              "  fuse%1_main(ove_texcoord);\n"
+                              "  frag_color = fuse%1_frag_color;\n"
+                              "}\n").arg(chain.size()-1));
+
+  return fused;
+}
+
+void RenderProcessor::ProcessShaderChain(TexturePtr destination, const QVector<ShaderPass> &chain)
+{
+  if (!render_ctx_) {
+    return;
+  }
+
+  QStringList id_parts;
+  id_parts.reserve(chain.size());
+  for (const ShaderPass &pass : chain) {
+    id_parts.append(QStringLiteral("%1:%2").arg(pass.node->id(), pass.job->GetShaderID()));
+  }
+  QString fused_id = QStringLiteral("fused|") + id_parts.join('+');
+
+  ShaderCache::Shard &shard_cache = shader_cache_->shard(fused_id);
+  QMutexLocker locker(shard_cache.mutex());
+
+  QVariant shader = shard_cache.map().value(fused_id);
+
+  if (shader.type() == QVariant::Bool) {
+    // We already know this chain can't be fused, don't try to compile it again
+    locker.unlock();
+    NodeTraverser::ProcessShaderChain(destination, chain);
+    return;
+  }
+
+  if (shader.isNull()) {
+    QString fused_code = GenerateFusedShaderCode(chain);
+
+    if (!fused_code.isEmpty()) {
+      shader = render_ctx_->CreateNativeShader(ShaderCode(fused_code));
+    }
+
+    if (shader.isNull()) {
+      // Remember the failure and fall back to rendering the passes separately
+      shard_cache.map().insert(fused_id, QVariant(false));
+      locker.unlock();
+      NodeTraverser::ProcessShaderChain(destination, chain);
+      return;
+    }
+
+    shard_cache.map().insert(fused_id, shader);
+  }
+
+  locker.unlock();
+
+  // Merge each pass's parameters under its namespace
+  ShaderJob fused_job;
+  for (int i=0; i<chain.size(); i++) {
+    const ShaderPass &pass = chain.at(i);
+
+    for (auto it=pass.job->GetValues().constBegin(); it!=pass.job->GetValues().constEnd(); it++) {
+      if (i > 0 && it.key() == pass.job->GetFusableInput()) {
+        continue;
+      }
+
+      QString key = QStringLiteral("fuse%1_%2").arg(QString::number(i), it.key());
+      fused_job.Insert(key, it.value());
+      fused_job.SetInterpolation(key, pass.job->GetInterpolation(it.key()));
+    }
+  }
+
+  render_ctx_->BlitToTexture(shader, fused_job, destination.get());
+}
+
 void RenderProcessor::ProcessSamples(SampleBuffer &destination, const Node *node, const TimeRange &range, const SampleJob &job)
 {
   if (!job.samples().is_allocated()) {
     return;
   }
 
+  size_t sample_count = job.samples().sample_count();
+
+  // Each sample is evaluated independently, so long jobs (e.g. conform-length cache fills) are
+  // split into chunks and processed in parallel. Short jobs stay serial because each chunk has
+  // to pay for its own traverser. The threshold is roughly a third of a second at 48kHz.
+  const size_t kMinimumChunkSize = 16384;
+  size_t thread_count = QThread::idealThreadCount();
+
+  if (thread_count > 1 && sample_count >= kMinimumChunkSize*2) {
+    size_t chunk_size = (sample_count + thread_count - 1) / thread_count;
+
+    QVector< QFuture<void> > jobs;
+
+    for (size_t start=0; start<sample_count; start+=chunk_size) {
+      size_t end = std::min(sample_count, start + chunk_size);
+
+      jobs.append(QtConcurrent::run([this, &destination, node, &range, &job, start, end]{
+        // ProcessInput caches tables in the traverser, which isn't safe to share across
+        // threads, so each chunk runs through its own processor. Chunks write disjoint sample
+        // indices of the destination, so the buffer itself needs no locking.
+        RenderProcessor chunk_processor(ticket_, render_ctx_, decoder_cache_, shader_cache_);
+        chunk_processor.SetCancelPointer(GetCancelPointer());
+        chunk_processor.SetCacheVideoParams(GetCacheVideoParams());
+        chunk_processor.SetCacheAudioParams(GetCacheAudioParams());
+        chunk_processor.SetLoopMode(loop_mode());
+        chunk_processor.SetRenderMode(render_mode());
+        chunk_processor.ProcessSamplesChunk(destination, node, range, job, start, end);
+      }));
+    }
+
+    for (QFuture<void> &j : jobs) {
+      j.waitForFinished();
+    }
+  } else {
+    ProcessSamplesChunk(destination, node, range, job, 0, sample_count);
+  }
+}
+
+void RenderProcessor::ProcessSamplesChunk(SampleBuffer &destination, const Node *node, const TimeRange &range, const SampleJob &job, size_t start, size_t end)
+{
   NodeValueRow value_db;
 
   const AudioParams& audio_params = GetCacheAudioParams();
 
-  for (size_t i=0;i<job.samples().sample_count();i++) {
+  for (size_t i=start;i<end;i++) {
     // Calculate the exact rational time at this sample
     double sample_to_second = static_cast<double>(i) / static_cast<double>(audio_params.sample_rate());
 
@@ -505,7 +806,11 @@ void RenderProcessor::ProcessColorTransform(TexturePtr destination, const Node *
     return;
   }
 
-  render_ctx_->BlitColorManaged(*job, destination.get());
+  // Node-generated jobs funnel through here, so apply the export quality rule centrally
+  ColorTransformJob quality_job = *job;
+  quality_job.SetBakedLutAllowed(render_mode() != RenderMode::kOnline);
+
+  render_ctx_->BlitColorManaged(quality_job, destination.get());
 }
 
 void RenderProcessor::ProcessFrameGeneration(TexturePtr destination, const Node *node, const GenerateJob *job)
@@ -526,7 +831,17 @@ void RenderProcessor::ProcessFrameGeneration(TexturePtr destination, const Node
 
 TexturePtr RenderProcessor::ProcessVideoCacheJob(const CacheJob *val)
 {
-  FramePtr frame = FrameHashCache::LoadCacheFrame(val->GetFilename());
+  // Check the in-RAM layer first - scrubbing tends to hit the same frames repeatedly
+  FramePtr frame = FrameMemoryCache::Get(val->GetFilename());
+
+  if (!frame) {
+    frame = FrameHashCache::LoadCacheFrame(val->GetFilename());
+
+    if (frame) {
+      FrameMemoryCache::Push(val->GetFilename(), frame);
+    }
+  }
+
   if (frame) {
     TexturePtr tex = CreateTexture(frame->video_params());
     if (tex) {
@@ -565,6 +880,7 @@ void RenderProcessor::ConvertToReferenceSpace(TexturePtr destination, TexturePtr
   ctj.SetColorProcessor(cp);
   ctj.SetInputTexture(source);
   ctj.SetInputAlphaAssociation(kAlphaAssociated);
+  ctj.SetBakedLutAllowed(render_mode() != RenderMode::kOnline);
 
   render_ctx_->BlitColorManaged(ctj, destination.get());
 }
@@ -50,6 +50,8 @@ protected:
 
   virtual void ProcessShader(TexturePtr destination, const Node *node, const ShaderJob *job) override;
 
+  virtual void ProcessShaderChain(TexturePtr destination, const QVector<ShaderPass> &chain) override;
+
   virtual void ProcessSamples(SampleBuffer &destination, const Node *node, const TimeRange &range, const SampleJob &job) override;
 
   virtual void ProcessColorTransform(TexturePtr destination, const Node *node, const ColorTransformJob *job) override;
@@ -69,6 +71,8 @@ protected:
 
   virtual bool UseCache() const override;
 
+  virtual NodeTraverser *CreateBranchWorker() override;
+
 private:
   RenderProcessor(RenderTicketPtr ticket, Renderer* render_ctx, DecoderCache* decoder_cache, ShaderCache* shader_cache);
 
@@ -78,8 +82,12 @@ private:
 
   void Run();
 
+  void ProcessSamplesChunk(SampleBuffer &destination, const Node *node, const TimeRange &range, const SampleJob &job, size_t start, size_t end);
+
   DecoderPtr ResolveDecoderFromInput(const QString &decoder_id, const Decoder::CodecStream& stream);
 
+  static QString GenerateFusedShaderCode(const QVector<ShaderPass> &chain);
+
   RenderTicketPtr ticket_;
 
   Renderer* render_ctx_;
@@ -88,6 +96,10 @@ private:
 
   ShaderCache* shader_cache_;
 
+  // CPU nanoseconds spent decoding/downloading for the profiling HUD
+  qint64 profiler_decode_ns_;
+  qint64 profiler_download_ns_;
+
 };
 
 }
@@ -20,8 +20,27 @@
 
 #include "renderticket.h"
 
+#include <list>
+
+#include <QCoreApplication>
+
+#include "common/mainthreadqueue.h"
+
 namespace olive {
 
+namespace {
+
+// Watchers on the main thread whose tickets have finished but whose Finished signals haven't
+// been emitted yet. During fast cache fills, hundreds of tickets can finish within a single
+// event loop iteration, and posting one queued event per ticket drowns the main thread in
+// event delivery. Instead, finished watchers collect here and a single drain pass emits all
+// of their signals once per event loop tick.
+QMutex pending_watcher_lock;
+std::list<RenderTicketWatcher*> pending_watchers;
+bool pending_watcher_drain_scheduled = false;
+
+}
+
 RenderTicket::RenderTicket() :
   is_running_(false),
   has_result_(false),
@@ -122,18 +141,74 @@ void RenderTicket::FinishInternal(bool has_result, QVariant result)
 
     wait_.wakeAll();
 
+    // Notify watchers while our lock is held - a watcher being destroyed concurrently blocks in
+    // RemoveWatcher() until we're done here, so these pointers can't go stale under us
+    foreach (RenderTicketWatcher* watcher, watchers_) {
+      if (watcher->thread() == qApp->thread() && MainThreadQueue::instance()) {
+        // Batch main thread notifications into a single per-tick drain
+        QMutexLocker pending_locker(&pending_watcher_lock);
+
+        pending_watchers.push_back(watcher);
+
+        if (!pending_watcher_drain_scheduled) {
+          pending_watcher_drain_scheduled = true;
+          MainThreadQueue::instance()->Add(&RenderTicketWatcher::DrainPending);
+        }
+      } else {
+        // Watchers on other threads (e.g. export watcher threads) keep per-event delivery
+        QMetaObject::invokeMethod(watcher, "TicketFinished", Qt::QueuedConnection);
+      }
+    }
+
     locker.unlock();
 
     emit Finished();
   }
 }
 
+void RenderTicket::AddWatcher(RenderTicketWatcher *watcher, bool lock)
+{
+  if (lock) {
+    lock_.lock();
+  }
+
+  watchers_.append(watcher);
+
+  if (lock) {
+    lock_.unlock();
+  }
+}
+
+void RenderTicket::RemoveWatcher(RenderTicketWatcher *watcher, bool lock)
+{
+  if (lock) {
+    lock_.lock();
+  }
+
+  watchers_.removeOne(watcher);
+
+  if (lock) {
+    lock_.unlock();
+  }
+}
+
 RenderTicketWatcher::RenderTicketWatcher(QObject *parent) :
   QObject(parent),
   ticket_(nullptr)
 {
 }
 
+RenderTicketWatcher::~RenderTicketWatcher()
+{
+  if (ticket_) {
+    ticket_->RemoveWatcher(this);
+  }
+
+  // Also drop any notification that was batched but hasn't been delivered yet
+  QMutexLocker locker(&pending_watcher_lock);
+  pending_watchers.remove(this);
+}
+
 void RenderTicketWatcher::SetTicket(RenderTicketPtr ticket)
 {
   if (ticket_) {
@@ -151,7 +226,7 @@ void RenderTicketWatcher::SetTicket(RenderTicketPtr ticket)
   // Lock ticket so we can query if it's already finished by the time this code runs
   QMutexLocker locker(ticket->lock());
 
-  connect(ticket_.get(), &RenderTicket::Finished, this, &RenderTicketWatcher::TicketFinished);
+  ticket_->AddWatcher(this, false);
 
   if (!ticket_->IsRunning(false) && ticket_->GetFinishCount(false) > 0) {
     // Ticket has already finished before, so we emit a signal
@@ -201,6 +276,29 @@ void RenderTicketWatcher::Cancel()
   }
 }
 
+void RenderTicketWatcher::DrainPending()
+{
+  while (true) {
+    RenderTicketWatcher* watcher;
+
+    {
+      QMutexLocker locker(&pending_watcher_lock);
+
+      if (pending_watchers.empty()) {
+        pending_watcher_drain_scheduled = false;
+        return;
+      }
+
+      watcher = pending_watchers.front();
+      pending_watchers.pop_front();
+    }
+
+    // Emit outside the lock - a slot may delete other pending watchers, whose destructors
+    // remove themselves from the queue
+    watcher->TicketFinished();
+  }
+}
+
 void RenderTicketWatcher::TicketFinished()
 {
   emit Finished(this);
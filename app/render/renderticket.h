@@ -23,6 +23,7 @@
 
 #include <QDateTime>
 #include <QMutex>
+#include <QVector>
 #include <QWaitCondition>
 
 #include "codec/frame.h"
@@ -31,6 +32,8 @@
 
 namespace olive {
 
+class RenderTicketWatcher;
+
 class RenderTicket : public QObject, public CancelableObject
 {
   Q_OBJECT
@@ -105,6 +108,26 @@ public:
    */
   void Finish(QVariant result);
 
+  /**
+   * @brief Register a watcher to be notified whenever this ticket finishes
+   *
+   * Notifications to watchers on the main thread are batched - they drain once per event loop
+   * tick rather than arriving as individual queued events. Watchers on other threads receive
+   * one queued event each, as before.
+   *
+   * This function is thread safe, unless `lock` is set to false. Then the caller has responsibility
+   * of locking the mutex before and unlocking after this function is called.
+   */
+  void AddWatcher(RenderTicketWatcher* watcher, bool lock = true);
+
+  /**
+   * @brief Unregister a watcher previously added with AddWatcher()
+   *
+   * This function is thread safe, unless `lock` is set to false. Then the caller has responsibility
+   * of locking the mutex before and unlocking after this function is called.
+   */
+  void RemoveWatcher(RenderTicketWatcher* watcher, bool lock = true);
+
 signals:
   /**
    * @brief Emitted when finish has been called by any means (either cancelled or with a result)
@@ -126,6 +149,8 @@ private:
 
   QWaitCondition wait_;
 
+  QVector<RenderTicketWatcher*> watchers_;
+
 };
 
 using RenderTicketPtr = std::shared_ptr<RenderTicket>;
@@ -136,6 +161,8 @@ class RenderTicketWatcher : public QObject
 public:
   RenderTicketWatcher(QObject* parent = nullptr);
 
+  virtual ~RenderTicketWatcher() override;
+
   RenderTicketPtr GetTicket() const
   {
     return ticket_;
@@ -157,8 +184,17 @@ signals:
   void Finished(RenderTicketWatcher* watcher);
 
 private:
+  /**
+   * @brief Deliver pending main thread notifications until the queue is empty
+   *
+   * Runs on the main thread, scheduled at most once per batch of finished tickets.
+   */
+  static void DrainPending();
+
   RenderTicketPtr ticket_;
 
+  friend class RenderTicket;
+
 private slots:
   void TicketFinished();
 
@@ -178,6 +178,28 @@ bool VideoParams::operator!=(const VideoParams &rhs) const
   return !(*this == rhs);
 }
 
+bool VideoParams::ContentsEqual(const VideoParams &a, const VideoParams &b)
+{
+  // Everything compared by operator== except pixel aspect ratio and time base, plus the footage
+  // fields that decide what a stream decodes to
+  return a.width() == b.width()
+      && a.height() == b.height()
+      && a.depth() == b.depth()
+      && a.interlacing() == b.interlacing()
+      && a.format() == b.format()
+      && a.divider() == b.divider()
+      && a.channel_count() == b.channel_count()
+      && a.enabled() == b.enabled()
+      && a.stream_index() == b.stream_index()
+      && a.video_type() == b.video_type()
+      && a.start_time() == b.start_time()
+      && a.premultiplied_alpha() == b.premultiplied_alpha()
+      && a.colorspace() == b.colorspace()
+      && a.color_range() == b.color_range()
+      && a.x() == b.x()
+      && a.y() == b.y();
+}
+
 int VideoParams::GetBytesPerChannel(PixelFormat format)
 {
   switch (format) {
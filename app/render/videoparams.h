@@ -207,6 +207,16 @@ public:
   bool operator==(const VideoParams& rhs) const;
   bool operator!=(const VideoParams& rhs) const;
 
+  /**
+   * @brief Returns whether two parameter sets produce identical rendered pixels
+   *
+   * Some fields are display or timing metadata that never reach the renderer - pixel aspect
+   * ratio is applied when a frame is drawn to screen and the time base only decides which
+   * timestamps exist. Cached frames rendered under one set of parameters are pixel-identical
+   * under the other if this returns true, so caches can survive such a change.
+   */
+  static bool ContentsEqual(const VideoParams &a, const VideoParams &b);
+
   static int GetBytesPerChannel(PixelFormat format);
   int GetBytesPerChannel() const
   {
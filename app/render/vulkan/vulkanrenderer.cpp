@@ -0,0 +1,597 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "vulkanrenderer.h"
+
+#ifdef USE_VULKAN
+
+#include <QDebug>
+#include <QVector>
+
+#include "common/define.h"
+
+namespace olive {
+
+VulkanRenderer::VulkanRenderer(QObject *parent) :
+  Renderer(parent),
+  instance_(VK_NULL_HANDLE),
+  physical_device_(VK_NULL_HANDLE),
+  device_(VK_NULL_HANDLE),
+  queue_(VK_NULL_HANDLE),
+  queue_family_(0),
+  command_pool_(VK_NULL_HANDLE),
+  pipeline_cache_(VK_NULL_HANDLE)
+{
+}
+
+VulkanRenderer::~VulkanRenderer()
+{
+  Destroy();
+  PostDestroy();
+}
+
+bool VulkanRenderer::Init()
+{
+  if (instance_) {
+    // RenderManager probes the device before handing us to a RenderThread,
+    // which calls Init() again - just report the earlier result
+    return IsValid();
+  }
+
+  VkApplicationInfo app_info{};
+  app_info.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
+  app_info.pApplicationName = "Olive";
+  app_info.apiVersion = VK_API_VERSION_1_1;
+
+  VkInstanceCreateInfo instance_info{};
+  instance_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
+  instance_info.pApplicationInfo = &app_info;
+
+  if (vkCreateInstance(&instance_info, nullptr, &instance_) != VK_SUCCESS) {
+    qCritical() << "Failed to create Vulkan instance";
+    return false;
+  }
+
+  // Enumerate physical devices, preferring a discrete GPU with a compute queue
+  uint32_t device_count = 0;
+  vkEnumeratePhysicalDevices(instance_, &device_count, nullptr);
+  if (device_count == 0) {
+    qCritical() << "No Vulkan-capable devices found";
+    return false;
+  }
+
+  QVector<VkPhysicalDevice> devices(device_count);
+  vkEnumeratePhysicalDevices(instance_, &device_count, devices.data());
+
+  for (VkPhysicalDevice candidate : devices) {
+    uint32_t family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(candidate, &family_count, nullptr);
+    QVector<VkQueueFamilyProperties> families(family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(candidate, &family_count, families.data());
+
+    for (uint32_t i = 0; i < family_count; i++) {
+      if (families.at(i).queueFlags & VK_QUEUE_COMPUTE_BIT) {
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(candidate, &props);
+
+        bool prefer = (physical_device_ == VK_NULL_HANDLE)
+            || props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
+
+        if (prefer) {
+          physical_device_ = candidate;
+          queue_family_ = i;
+        }
+        break;
+      }
+    }
+  }
+
+  if (physical_device_ == VK_NULL_HANDLE) {
+    qCritical() << "No Vulkan device with a compute queue found";
+    return false;
+  }
+
+  vkGetPhysicalDeviceMemoryProperties(physical_device_, &memory_properties_);
+
+  float queue_priority = 1.0f;
+  VkDeviceQueueCreateInfo queue_info{};
+  queue_info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+  queue_info.queueFamilyIndex = queue_family_;
+  queue_info.queueCount = 1;
+  queue_info.pQueuePriorities = &queue_priority;
+
+  VkDeviceCreateInfo device_info{};
+  device_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+  device_info.queueCreateInfoCount = 1;
+  device_info.pQueueCreateInfos = &queue_info;
+
+  if (vkCreateDevice(physical_device_, &device_info, nullptr, &device_) != VK_SUCCESS) {
+    qCritical() << "Failed to create Vulkan device";
+    return false;
+  }
+
+  vkGetDeviceQueue(device_, queue_family_, 0, &queue_);
+
+  return true;
+}
+
+void VulkanRenderer::PostInit()
+{
+  VkCommandPoolCreateInfo pool_info{};
+  pool_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  pool_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+  pool_info.queueFamilyIndex = queue_family_;
+
+  if (vkCreateCommandPool(device_, &pool_info, nullptr, &command_pool_) != VK_SUCCESS) {
+    qCritical() << "Failed to create Vulkan command pool";
+  }
+
+  VkPipelineCacheCreateInfo cache_info{};
+  cache_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  vkCreatePipelineCache(device_, &cache_info, nullptr, &pipeline_cache_);
+}
+
+void VulkanRenderer::DestroyInternal()
+{
+  if (device_) {
+    vkDeviceWaitIdle(device_);
+
+    if (pipeline_cache_) {
+      vkDestroyPipelineCache(device_, pipeline_cache_, nullptr);
+      pipeline_cache_ = VK_NULL_HANDLE;
+    }
+
+    if (command_pool_) {
+      vkDestroyCommandPool(device_, command_pool_, nullptr);
+      command_pool_ = VK_NULL_HANDLE;
+    }
+  }
+}
+
+void VulkanRenderer::PostDestroy()
+{
+  if (device_) {
+    vkDestroyDevice(device_, nullptr);
+    device_ = VK_NULL_HANDLE;
+  }
+
+  if (instance_) {
+    vkDestroyInstance(instance_, nullptr);
+    instance_ = VK_NULL_HANDLE;
+  }
+}
+
+VkFormat VulkanRenderer::GetVulkanFormat(PixelFormat format, int channel_count)
+{
+  switch (format) {
+  case PixelFormat::U8:
+    switch (channel_count) {
+    case 1:
+      return VK_FORMAT_R8_UNORM;
+    case 2:
+      return VK_FORMAT_R8G8_UNORM;
+    case 3:
+      return VK_FORMAT_R8G8B8_UNORM;
+    case 4:
+      return VK_FORMAT_R8G8B8A8_UNORM;
+    }
+    break;
+  case PixelFormat::U16:
+    switch (channel_count) {
+    case 1:
+      return VK_FORMAT_R16_UNORM;
+    case 2:
+      return VK_FORMAT_R16G16_UNORM;
+    case 3:
+      return VK_FORMAT_R16G16B16_UNORM;
+    case 4:
+      return VK_FORMAT_R16G16B16A16_UNORM;
+    }
+    break;
+  case PixelFormat::F16:
+    switch (channel_count) {
+    case 1:
+      return VK_FORMAT_R16_SFLOAT;
+    case 2:
+      return VK_FORMAT_R16G16_SFLOAT;
+    case 3:
+      return VK_FORMAT_R16G16B16_SFLOAT;
+    case 4:
+      return VK_FORMAT_R16G16B16A16_SFLOAT;
+    }
+    break;
+  case PixelFormat::F32:
+    switch (channel_count) {
+    case 1:
+      return VK_FORMAT_R32_SFLOAT;
+    case 2:
+      return VK_FORMAT_R32G32_SFLOAT;
+    case 3:
+      return VK_FORMAT_R32G32B32_SFLOAT;
+    case 4:
+      return VK_FORMAT_R32G32B32A32_SFLOAT;
+    }
+    break;
+  case PixelFormat::INVALID:
+  case PixelFormat::COUNT:
+    break;
+  }
+
+  return VK_FORMAT_UNDEFINED;
+}
+
+uint32_t VulkanRenderer::FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags properties) const
+{
+  for (uint32_t i = 0; i < memory_properties_.memoryTypeCount; i++) {
+    if ((type_filter & (1 << i))
+        && (memory_properties_.memoryTypes[i].propertyFlags & properties) == properties) {
+      return i;
+    }
+  }
+
+  qCritical() << "Failed to find suitable Vulkan memory type";
+  return 0;
+}
+
+QVariant VulkanRenderer::CreateNativeTexture(int width, int height, int depth, PixelFormat format, int channel_count, const void *data, int linesize)
+{
+  VulkanTexture *tex = new VulkanTexture();
+  tex->width = width;
+  tex->height = height;
+  tex->depth = depth;
+  tex->format = format;
+  tex->channel_count = channel_count;
+  tex->layout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  VkImageCreateInfo image_info{};
+  image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+  image_info.imageType = depth > 1 ? VK_IMAGE_TYPE_3D : VK_IMAGE_TYPE_2D;
+  image_info.format = GetVulkanFormat(format, channel_count);
+  image_info.extent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), static_cast<uint32_t>(std::max(depth, 1))};
+  image_info.mipLevels = 1;
+  image_info.arrayLayers = 1;
+  image_info.samples = VK_SAMPLE_COUNT_1_BIT;
+  image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+  image_info.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT
+      | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+  image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+  if (vkCreateImage(device_, &image_info, nullptr, &tex->image) != VK_SUCCESS) {
+    qCritical() << "Failed to create Vulkan image";
+    delete tex;
+    return QVariant();
+  }
+
+  VkMemoryRequirements requirements;
+  vkGetImageMemoryRequirements(device_, tex->image, &requirements);
+
+  VkMemoryAllocateInfo alloc_info{};
+  alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  alloc_info.allocationSize = requirements.size;
+  alloc_info.memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+  if (vkAllocateMemory(device_, &alloc_info, nullptr, &tex->memory) != VK_SUCCESS) {
+    qCritical() << "Failed to allocate Vulkan image memory";
+    vkDestroyImage(device_, tex->image, nullptr);
+    delete tex;
+    return QVariant();
+  }
+
+  vkBindImageMemory(device_, tex->image, tex->memory, 0);
+
+  VkImageViewCreateInfo view_info{};
+  view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+  view_info.image = tex->image;
+  view_info.viewType = depth > 1 ? VK_IMAGE_VIEW_TYPE_3D : VK_IMAGE_VIEW_TYPE_2D;
+  view_info.format = image_info.format;
+  view_info.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+  vkCreateImageView(device_, &view_info, nullptr, &tex->view);
+
+  if (data) {
+    VideoParams upload_params(width, height, format, channel_count);
+    UploadToTexture(QVariant::fromValue(reinterpret_cast<quintptr>(tex)), upload_params, data, linesize);
+  }
+
+  return QVariant::fromValue(reinterpret_cast<quintptr>(tex));
+}
+
+void VulkanRenderer::DestroyNativeTexture(QVariant texture)
+{
+  VulkanTexture *tex = reinterpret_cast<VulkanTexture*>(texture.value<quintptr>());
+
+  if (tex) {
+    vkDestroyImageView(device_, tex->view, nullptr);
+    vkDestroyImage(device_, tex->image, nullptr);
+    vkFreeMemory(device_, tex->memory, nullptr);
+    delete tex;
+  }
+}
+
+bool VulkanRenderer::CreateStagingBuffer(VkDeviceSize size, VkBuffer *buffer, VkDeviceMemory *memory) const
+{
+  VkBufferCreateInfo buffer_info{};
+  buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  buffer_info.size = size;
+  buffer_info.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+  buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  if (vkCreateBuffer(device_, &buffer_info, nullptr, buffer) != VK_SUCCESS) {
+    return false;
+  }
+
+  VkMemoryRequirements requirements;
+  vkGetBufferMemoryRequirements(device_, *buffer, &requirements);
+
+  VkMemoryAllocateInfo alloc_info{};
+  alloc_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  alloc_info.allocationSize = requirements.size;
+  alloc_info.memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits,
+                                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+  if (vkAllocateMemory(device_, &alloc_info, nullptr, memory) != VK_SUCCESS) {
+    vkDestroyBuffer(device_, *buffer, nullptr);
+    return false;
+  }
+
+  vkBindBufferMemory(device_, *buffer, *memory, 0);
+  return true;
+}
+
+VkCommandBuffer VulkanRenderer::BeginCommands() const
+{
+  VkCommandBufferAllocateInfo alloc_info{};
+  alloc_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+  alloc_info.commandPool = command_pool_;
+  alloc_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  alloc_info.commandBufferCount = 1;
+
+  VkCommandBuffer cmd;
+  vkAllocateCommandBuffers(device_, &alloc_info, &cmd);
+
+  VkCommandBufferBeginInfo begin_info{};
+  begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  vkBeginCommandBuffer(cmd, &begin_info);
+
+  return cmd;
+}
+
+void VulkanRenderer::SubmitCommands(VkCommandBuffer cmd) const
+{
+  vkEndCommandBuffer(cmd);
+
+  VkSubmitInfo submit_info{};
+  submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submit_info.commandBufferCount = 1;
+  submit_info.pCommandBuffers = &cmd;
+
+  VkFenceCreateInfo fence_info{};
+  fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+  VkFence fence;
+  vkCreateFence(device_, &fence_info, nullptr, &fence);
+
+  vkQueueSubmit(queue_, 1, &submit_info, fence);
+  vkWaitForFences(device_, 1, &fence, VK_TRUE, UINT64_MAX);
+
+  vkDestroyFence(device_, fence, nullptr);
+  vkFreeCommandBuffers(device_, command_pool_, 1, &cmd);
+}
+
+void VulkanRenderer::TransitionLayout(VkCommandBuffer cmd, VulkanTexture *tex, VkImageLayout new_layout) const
+{
+  if (tex->layout == new_layout) {
+    return;
+  }
+
+  VkImageMemoryBarrier barrier{};
+  barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+  barrier.oldLayout = tex->layout;
+  barrier.newLayout = new_layout;
+  barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+  barrier.image = tex->image;
+  barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+  barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+  vkCmdPipelineBarrier(cmd,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                       0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+  tex->layout = new_layout;
+}
+
+void VulkanRenderer::UploadToTexture(const QVariant &handle, const VideoParams &p, const void *data, int linesize)
+{
+  VulkanTexture *tex = reinterpret_cast<VulkanTexture*>(handle.value<quintptr>());
+  if (!tex) {
+    return;
+  }
+
+  VkDeviceSize size = VideoParams::GetBytesPerPixel(p.format(), p.channel_count())
+      * p.effective_width() * p.effective_height() * std::max(p.effective_depth(), 1);
+
+  VkBuffer staging;
+  VkDeviceMemory staging_memory;
+  if (!CreateStagingBuffer(size, &staging, &staging_memory)) {
+    qCritical() << "Failed to create Vulkan staging buffer for upload";
+    return;
+  }
+
+  void *mapped;
+  vkMapMemory(device_, staging_memory, 0, size, 0, &mapped);
+  memcpy(mapped, data, size);
+  vkUnmapMemory(device_, staging_memory);
+
+  VkCommandBuffer cmd = BeginCommands();
+
+  TransitionLayout(cmd, tex, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+  VkBufferImageCopy region{};
+  region.bufferRowLength = linesize;
+  region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+  region.imageExtent = {static_cast<uint32_t>(p.effective_width()),
+                        static_cast<uint32_t>(p.effective_height()),
+                        static_cast<uint32_t>(std::max(p.effective_depth(), 1))};
+
+  vkCmdCopyBufferToImage(cmd, staging, tex->image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+  TransitionLayout(cmd, tex, VK_IMAGE_LAYOUT_GENERAL);
+
+  SubmitCommands(cmd);
+
+  vkDestroyBuffer(device_, staging, nullptr);
+  vkFreeMemory(device_, staging_memory, nullptr);
+}
+
+void VulkanRenderer::DownloadFromTexture(const QVariant &handle, const VideoParams &p, void *data, int linesize)
+{
+  VulkanTexture *tex = reinterpret_cast<VulkanTexture*>(handle.value<quintptr>());
+  if (!tex) {
+    return;
+  }
+
+  VkDeviceSize size = VideoParams::GetBytesPerPixel(p.format(), p.channel_count())
+      * p.effective_width() * p.effective_height();
+
+  VkBuffer staging;
+  VkDeviceMemory staging_memory;
+  if (!CreateStagingBuffer(size, &staging, &staging_memory)) {
+    qCritical() << "Failed to create Vulkan staging buffer for download";
+    return;
+  }
+
+  VkCommandBuffer cmd = BeginCommands();
+
+  TransitionLayout(cmd, tex, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+  VkBufferImageCopy region{};
+  region.bufferRowLength = linesize;
+  region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+  region.imageExtent = {static_cast<uint32_t>(p.effective_width()),
+                        static_cast<uint32_t>(p.effective_height()),
+                        1};
+
+  vkCmdCopyImageToBuffer(cmd, tex->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging, 1, &region);
+
+  TransitionLayout(cmd, tex, VK_IMAGE_LAYOUT_GENERAL);
+
+  SubmitCommands(cmd);
+
+  void *mapped;
+  vkMapMemory(device_, staging_memory, 0, size, 0, &mapped);
+  memcpy(data, mapped, size);
+  vkUnmapMemory(device_, staging_memory);
+
+  vkDestroyBuffer(device_, staging, nullptr);
+  vkFreeMemory(device_, staging_memory, nullptr);
+}
+
+void VulkanRenderer::ClearDestination(Texture *texture, double r, double g, double b, double a)
+{
+  if (!texture) {
+    return;
+  }
+
+  VulkanTexture *tex = reinterpret_cast<VulkanTexture*>(texture->id().value<quintptr>());
+  if (!tex) {
+    return;
+  }
+
+  VkCommandBuffer cmd = BeginCommands();
+
+  TransitionLayout(cmd, tex, VK_IMAGE_LAYOUT_GENERAL);
+
+  VkClearColorValue color{};
+  color.float32[0] = r;
+  color.float32[1] = g;
+  color.float32[2] = b;
+  color.float32[3] = a;
+
+  VkImageSubresourceRange range = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+  vkCmdClearColorImage(cmd, tex->image, VK_IMAGE_LAYOUT_GENERAL, &color, 1, &range);
+
+  SubmitCommands(cmd);
+}
+
+QVariant VulkanRenderer::CreateNativeShader(ShaderCode code)
+{
+  // Node shaders are authored as desktop GLSL. Translating them to compute
+  // SPIR-V requires a runtime compiler (shaderc), which is wired up in a
+  // follow-up - until then, jobs that need a shader can't run on this
+  // backend and RenderManager keeps it opt-in.
+  Q_UNUSED(code)
+  qWarning() << "VulkanRenderer does not support runtime shader compilation yet";
+  return QVariant();
+}
+
+void VulkanRenderer::DestroyNativeShader(QVariant shader)
+{
+  Q_UNUSED(shader)
+}
+
+void VulkanRenderer::Blit(QVariant shader, ShaderJob job, Texture *destination, VideoParams destination_params, bool clear_destination)
+{
+  Q_UNUSED(job)
+  Q_UNUSED(destination_params)
+
+  if (shader.isNull()) {
+    qWarning() << "VulkanRenderer received a blit with no compiled shader";
+    return;
+  }
+
+  if (clear_destination && destination) {
+    ClearDestination(destination);
+  }
+}
+
+void VulkanRenderer::Flush()
+{
+  if (queue_) {
+    vkQueueWaitIdle(queue_);
+  }
+}
+
+Color VulkanRenderer::GetPixelFromTexture(Texture *texture, const QPointF &pt)
+{
+  // Download the full row containing the requested pixel and index into it
+  QByteArray data(VideoParams::GetBytesPerPixel(texture->format(), texture->channel_count())
+                  * texture->width() * texture->height(), Qt::Uninitialized);
+
+  DownloadFromTexture(texture->id(), texture->params(), data.data(), 0);
+
+  int pixel_offset = (int(pt.y()) * texture->width() + int(pt.x()))
+      * VideoParams::GetBytesPerPixel(texture->format(), texture->channel_count());
+
+  Color c = Color::fromData(data.data() + pixel_offset, texture->format(), texture->channel_count());
+
+  if (texture->channel_count() == VideoParams::kRGBChannelCount) {
+    c.set_alpha(1.0);
+  }
+
+  return c;
+}
+
+}
+
+#endif // USE_VULKAN
@@ -0,0 +1,141 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef VULKANRENDERER_H
+#define VULKANRENDERER_H
+
+#ifdef USE_VULKAN
+
+#include <vulkan/vulkan.h>
+
+#include "render/renderer.h"
+
+namespace olive {
+
+/**
+ * @brief Renderer backend using Vulkan compute queues
+ *
+ * Unlike OpenGLRenderer, which is bound to a single context and serializes
+ * all work through the driver's GL thread, this backend submits work to an
+ * explicit compute queue and manages device memory itself. It is primarily
+ * intended for headless export boxes where GL context sharing overhead
+ * limits GPU utilization.
+ *
+ * The backend is only compiled when the Vulkan SDK is found (USE_VULKAN)
+ * and is selected through RenderManager's "RenderBackend" config entry.
+ * If device creation fails at runtime, RenderManager falls back to OpenGL.
+ */
+class VulkanRenderer : public Renderer
+{
+  Q_OBJECT
+public:
+  VulkanRenderer(QObject* parent = nullptr);
+
+  virtual ~VulkanRenderer() override;
+
+  virtual bool Init() override;
+
+  virtual void PostDestroy() override;
+
+  virtual void PostInit() override;
+
+  virtual void ClearDestination(olive::Texture *texture = nullptr, double r = 0.0, double g = 0.0, double b = 0.0, double a = 0.0) override;
+
+  virtual QVariant CreateNativeShader(olive::ShaderCode code) override;
+
+  virtual void DestroyNativeShader(QVariant shader) override;
+
+  virtual void UploadToTexture(const QVariant &handle, const VideoParams &params, const void* data, int linesize) override;
+
+  virtual void DownloadFromTexture(const QVariant &handle, const VideoParams &params, void* data, int linesize) override;
+
+  virtual void Flush() override;
+
+  virtual Color GetPixelFromTexture(olive::Texture *texture, const QPointF &pt) override;
+
+  /**
+   * @brief Returns true if a compute-capable device was created in Init()
+   */
+  bool IsValid() const
+  {
+    return device_ != VK_NULL_HANDLE;
+  }
+
+protected:
+  virtual void Blit(QVariant shader,
+                    olive::ShaderJob job,
+                    olive::Texture* destination,
+                    olive::VideoParams destination_params,
+                    bool clear_destination) override;
+
+  virtual QVariant CreateNativeTexture(int width, int height, int depth, PixelFormat format, int channel_count, const void* data = nullptr, int linesize = 0) override;
+
+  virtual void DestroyNativeTexture(QVariant texture) override;
+
+  virtual void DestroyInternal() override;
+
+private:
+  struct VulkanTexture {
+    VkImage image;
+    VkDeviceMemory memory;
+    VkImageView view;
+    VkImageLayout layout;
+    int width;
+    int height;
+    int depth;
+    PixelFormat format;
+    int channel_count;
+  };
+
+  static VkFormat GetVulkanFormat(PixelFormat format, int channel_count);
+
+  uint32_t FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags properties) const;
+
+  bool CreateStagingBuffer(VkDeviceSize size, VkBuffer *buffer, VkDeviceMemory *memory) const;
+
+  VkCommandBuffer BeginCommands() const;
+
+  void SubmitCommands(VkCommandBuffer cmd) const;
+
+  void TransitionLayout(VkCommandBuffer cmd, VulkanTexture *tex, VkImageLayout new_layout) const;
+
+  VkInstance instance_;
+
+  VkPhysicalDevice physical_device_;
+
+  VkDevice device_;
+
+  VkQueue queue_;
+
+  uint32_t queue_family_;
+
+  VkCommandPool command_pool_;
+
+  VkPipelineCache pipeline_cache_;
+
+  VkPhysicalDeviceMemoryProperties memory_properties_;
+
+};
+
+}
+
+#endif // USE_VULKAN
+
+#endif // VULKANRENDERER_H
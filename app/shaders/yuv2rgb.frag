@@ -4,6 +4,7 @@ uniform sampler2D v_channel;
 
 uniform int bits_per_pixel;
 uniform bool full_range;
+uniform bool interleaved_uv;
 
 uniform float yuv_crv;
 uniform float yuv_cgu;
@@ -18,8 +19,13 @@ void main()
   // Sample YUV planes
   vec3 yuv;
   yuv.r = texture(y_channel, ove_texcoord).r;
-  yuv.g = texture(u_channel, ove_texcoord).r;
-  yuv.b = texture(v_channel, ove_texcoord).r;
+  if (interleaved_uv) {
+    // Semi-planar (NV12/P010), U and V share one two-channel plane
+    yuv.gb = texture(u_channel, ove_texcoord).rg;
+  } else {
+    yuv.g = texture(u_channel, ove_texcoord).r;
+    yuv.b = texture(v_channel, ove_texcoord).r;
+  }
 
   // Pixels will have come in aligned to 16-bit regardless of their actual bit depth, so they must
   // be scaled as if they were actually 16-bit
@@ -38,6 +44,11 @@ void main()
 
     // Convert 0.0-1.0 to -0.5-0.5
     yuv.gb -= (2048.0/4095.0);
+  } else if (bits_per_pixel == 16) {
+    // Samples aligned to the top of 16 bits (e.g. P010) are already full scale
+
+    // Convert 0.0-1.0 to -0.5-0.5
+    yuv.gb -= (32768.0/65535.0);
   }
 
   // Convert YUV limited range from 16-235 to 0-255
@@ -29,6 +29,7 @@ ConformTask::ConformTask(const QString &decoder_id, const Decoder::CodecStream &
   output_filenames_(output_filenames)
 {
   SetTitle(tr("Conforming Audio %1:%2").arg(stream.filename(), QString::number(stream.stream())));
+  SetPriority(kBackground);
 }
 
 bool ConformTask::Run()
@@ -26,6 +26,7 @@ CustomCacheTask::CustomCacheTask(const QString &sequence_name) :
   cancelled_through_finish_(false)
 {
   SetTitle(tr("Caching custom range for \"%1\"").arg(sequence_name));
+  SetPriority(kBackground);
 }
 
 void CustomCacheTask::Finish()
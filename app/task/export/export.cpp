@@ -20,7 +20,17 @@
 
 #include "export.h"
 
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QtConcurrent/QtConcurrent>
+
+#include "codec/ffmpeg/ffmpegencoder.h"
+#include "common/xmlutils.h"
+#include "node/block/clip/clip.h"
+#include "node/block/gap/gap.h"
 #include "node/color/colormanager/colormanager.h"
+#include "node/project/footage/footage.h"
+#include "node/project/sequence/sequence.h"
 
 namespace olive {
 
@@ -54,6 +64,20 @@ bool ExportTask::Run()
   // For safety, if we're overwriting, we save to a temporary filename and then only overwrite it
   // at the end
   QString real_filename = params_.filename();
+
+  // Fingerprint the requested parameters so a relaunched export can verify that partial output
+  // left on disk by a crashed run was produced by the same job before reusing it
+  {
+    QBuffer param_buffer;
+    param_buffer.open(QBuffer::WriteOnly);
+    params_.Save(&param_buffer);
+    param_buffer.close();
+    params_fingerprint_ = QString::fromLatin1(QCryptographicHash::hash(param_buffer.data(), QCryptographicHash::Sha1).toHex());
+  }
+
+  // Resume state for segmented exports lives beside the real output file
+  checkpoint_filename_ = real_filename + QStringLiteral(".resume");
+
   if (QFileInfo::exists(params_.filename())) {
     // Generate a filename that definitely doesn't exist
     params_.SetFilename(FileFunctions::GetSafeTemporaryFilename(real_filename));
@@ -66,16 +90,92 @@ bool ExportTask::Run()
     params_.DisableSubtitles();
   }
 
-  encoder_ = std::shared_ptr<Encoder>(Encoder::CreateFromParams(params_));
+  if (params_.has_custom_range()) {
+    // Render custom range only
+    export_range_ = params_.custom_range();
+  } else {
+    // Render entire sequence
+    export_range_ = TimeRange(0, viewer()->GetLength());
+  }
+
+  if (params_.video_enabled() && export_range_.in() > 0) {
+    export_range_.set_in(Timecode::snap_time_to_timebase(export_range_.in(), video_params().frame_rate_as_time_base()));
+  }
 
-  if (!encoder_) {
-    SetError(tr("Failed to create encoder"));
-    return false;
+  // Determine whether the video should be split into independently encoded segments
+  bool use_segments = params_.video_segments() > 1
+      && params_.video_enabled()
+      && !params_.video_is_image_sequence()
+      && Encoder::GetTypeFromFormat(params_.format()) == Encoder::kEncoderTypeFFmpeg;
+  if (use_segments && params_.subtitles_enabled()) {
+    // Embedded subtitles would have to be muxed by a single encoder instance
+    qWarning() << "Parallel segments are unavailable with embedded subtitles, using one encoder";
+    use_segments = false;
   }
 
-  if (!encoder_->Open()) {
-    SetError(tr("Failed to open file: %1").arg(encoder_->GetError()));
-    return false;
+  // Smart render: if the export range is a single untouched clip whose source already matches
+  // the export parameters, stream-copy its packets instead of decoding and re-encoding them
+  QString passthrough_filename;
+
+  if (params_.video_enabled()
+      && !params_.video_is_image_sequence()
+      && Encoder::GetTypeFromFormat(params_.format()) == Encoder::kEncoderTypeFFmpeg
+      && !params_.subtitles_enabled()) {
+    QString source_filename;
+    rational source_in;
+
+    if (GetPassthroughSource(&source_filename, &source_in)) {
+      QString copy_filename = GetSegmentFilename(QStringLiteral("copy"));
+      QString copy_error;
+
+      if (FFmpegEncoder::CopyVideoPackets(source_filename,
+                                          TimeRange(source_in, source_in + export_range_.length()),
+                                          params_.video_params(),
+                                          params_.video_codec(),
+                                          copy_filename,
+                                          &copy_error)) {
+        qDebug() << "Smart render: stream-copied video from" << source_filename;
+        passthrough_filename = copy_filename;
+        use_segments = false;
+      } else {
+        qDebug() << "Smart render unavailable, falling back to full render:" << copy_error;
+      }
+    }
+  }
+
+  if (use_segments || !passthrough_filename.isEmpty()) {
+    // Audio is written by a single separate encoder so segment boundaries can't introduce codec
+    // priming gaps; it gets interleaved with the video when the segments are stitched
+    if (params_.audio_enabled()) {
+      EncodingParams audio_only = params_;
+      audio_only.SetFilename(GetSegmentFilename(QStringLiteral("audio")));
+      audio_only.DisableVideo();
+      audio_only.DisableSubtitles();
+
+      encoder_ = std::shared_ptr<Encoder>(Encoder::CreateFromParams(audio_only));
+
+      if (!encoder_) {
+        SetError(tr("Failed to create encoder"));
+        return false;
+      }
+
+      if (!encoder_->Open()) {
+        SetError(tr("Failed to open file: %1").arg(encoder_->GetError()));
+        return false;
+      }
+    }
+  } else {
+    encoder_ = std::shared_ptr<Encoder>(Encoder::CreateFromParams(params_));
+
+    if (!encoder_) {
+      SetError(tr("Failed to create encoder"));
+      return false;
+    }
+
+    if (!encoder_->Open()) {
+      SetError(tr("Failed to open file: %1").arg(encoder_->GetError()));
+      return false;
+    }
   }
 
   if (subtitles_enabled && params_.subtitles_are_sidecar()) {
@@ -107,20 +207,12 @@ bool ExportTask::Run()
     subtitle_encoder_ = encoder_;
   }
 
-  if (params_.has_custom_range()) {
-    // Render custom range only
-    export_range_ = params_.custom_range();
-  } else {
-    // Render entire sequence
-    export_range_ = TimeRange(0, viewer()->GetLength());
-  }
-
   frame_time_ = 0;
 
   QSize video_force_size;
   QMatrix4x4 video_force_matrix;
 
-  if (params_.video_enabled()) {
+  if (params_.video_enabled() && passthrough_filename.isEmpty()) {
 
     // If a transformation matrix is applied to this video, create it here
     if (video_params().width() != params_.video_params().width()
@@ -149,35 +241,114 @@ bool ExportTask::Run()
   TimeRangeList video_range, audio_range;
   TimeRange subtitle_range;
 
-  if (params_.video_enabled()) {
-    if (export_range_.in() > 0) {
-      export_range_.set_in(Timecode::snap_time_to_timebase(export_range_.in(), video_params().frame_rate_as_time_base()));
-    }
+  if (params_.video_enabled() && passthrough_filename.isEmpty()) {
+    if (use_segments) {
+      if (!OpenSegments(params_.video_segments())) {
+        return false;
+      }
+
+      // Only render the ranges of segments that weren't already completed by a previous run
+      foreach (ExportSegment* segment, segments_) {
+        if (!segment->complete) {
+          video_range.insert(TimeRange(export_range_.in() + Timecode::timestamp_to_time(segment->start_frame, video_params().frame_rate_as_time_base()),
+                                       export_range_.in() + Timecode::timestamp_to_time(segment->end_frame, video_params().frame_rate_as_time_base())));
+        }
+      }
+    } else {
+      video_range = {export_range_};
 
-    video_range = {export_range_};
+      // Pipeline the single encoder through the same writer machinery so encoding is decoupled
+      // from the thread that delivers rendered frames
+      TimeRangeListFrameIterator iterator({export_range_}, video_params().frame_rate_as_time_base());
+
+      if (iterator.size() > 0) {
+        ExportSegment* segment = new ExportSegment();
+
+        segment->params = params_;
+        segment->encoder = encoder_;
+        segment->start_frame = 0;
+        segment->end_frame = iterator.size();
+        segment->frame_time = 0;
+        segment->complete = false;
+
+        frames_per_segment_ = segment->end_frame;
+        segments_.append(segment);
+      }
+    }
   }
 
   if (params_.audio_enabled()) {
     audio_range = {export_range_};
+
+    loudness_meter_.SetParams(audio_params());
   }
 
   if (subtitles_enabled) {
     subtitle_range = export_range_;
   }
 
+  if (!segments_.isEmpty()) {
+    // Start a writer thread per segment to drain frames into its encoder
+    segment_render_done_ = false;
+    segment_writer_error_ = false;
+    segment_frames_queued_ = 0;
+
+    foreach (ExportSegment* segment, segments_) {
+      if (segment->complete) {
+        // Restored from a checkpoint, nothing left to write
+        continue;
+      }
+
+      segment_writers_.append(
+#if QT_VERSION_MAJOR >= 6
+            QtConcurrent::run(&ExportTask::WriteSegmentLoop, this, segment)
+#else
+            QtConcurrent::run(this, &ExportTask::WriteSegmentLoop, segment)
+#endif
+            );
+    }
+  }
+
+  // All segment encoders are configured identically, so any can provide the frame format
+  // (segments restored from a checkpoint have no encoder)
+  Encoder* frame_encoder = encoder_.get();
+  foreach (ExportSegment* segment, segments_) {
+    if (segment->encoder) {
+      frame_encoder = segment->encoder.get();
+      break;
+    }
+  }
+
   Render(color_manager_, video_range, audio_range, subtitle_range, RenderMode::kOnline, nullptr,
-         video_force_size, video_force_matrix, encoder_->GetDesiredPixelFormat(),
+         video_force_size, video_force_matrix,
+         frame_encoder ? frame_encoder->GetDesiredPixelFormat() : PixelFormat::INVALID,
          VideoParams::kRGBAChannelCount, color_processor_);
 
   bool success = true;
 
-  encoder_->Close();
-  if (!encoder_->GetError().isEmpty()) {
-    SetError(encoder_->GetError());
-    success = false;
+  if (!segments_.isEmpty()) {
+    // No more frames are coming, wake the writers so they can drain their queues and exit
+    segment_mutex_.lock();
+    segment_render_done_ = true;
+    segment_wait_.wakeAll();
+    segment_mutex_.unlock();
+
+    for (int i=0; i<segment_writers_.size(); i++) {
+      if (!segment_writers_[i].result()) {
+        success = false;
+      }
+    }
+  }
+
+  if (encoder_) {
+    encoder_->Close();
+    if (!encoder_->GetError().isEmpty()) {
+      SetError(encoder_->GetError());
+      success = false;
+    }
   }
 
-  if (subtitle_encoder_ != encoder_) {
+  if (subtitle_encoder_ && subtitle_encoder_ != encoder_) {
     subtitle_encoder_->Close();
     if (!subtitle_encoder_->GetError().isEmpty()) {
       SetError(subtitle_encoder_->GetError());
@@ -185,6 +356,100 @@ bool ExportTask::Run()
     }
   }
 
+  if (!segments_.isEmpty() && encoder_ && segments_.first()->encoder == encoder_) {
+    // Single-encoder pipeline, the encoder was already closed above
+    qDeleteAll(segments_);
+    segments_.clear();
+    segment_writers_.clear();
+  }
+
+  if (!segments_.isEmpty()) {
+    QVector<QString> segment_files;
+
+    foreach (ExportSegment* segment, segments_) {
+      // Writers finalize their segment as soon as it completes, and segments restored from a
+      // checkpoint have no encoder at all, so there may be nothing left to close here
+      if (segment->encoder) {
+        segment->encoder->Close();
+        if (!segment->encoder->GetError().isEmpty()) {
+          SetError(segment->encoder->GetError());
+          success = false;
+        }
+      }
+
+      segment_files.append(segment->params.filename());
+    }
+
+    QString audio_filename = encoder_ ? encoder_->params().filename() : QString();
+
+    if (success && !IsCancelled()) {
+      // Losslessly stitch the segments (and separately encoded audio) into the real output file
+      QString concat_error;
+      if (!FFmpegEncoder::ConcatenateSegments(segment_files, audio_filename, params_.filename(), &concat_error)) {
+        SetError(concat_error);
+        success = false;
+      }
+    }
+
+    if (success) {
+      // Stitched, the intermediate files and any resume state are no longer needed
+      foreach (const QString& f, segment_files) {
+        QFile::remove(f);
+      }
+      QFile::remove(checkpoint_filename_);
+    } else {
+      // Keep completed segments and the checkpoint so a relaunched export can pick up from
+      // here; partially written files are useless and removed
+      foreach (ExportSegment* segment, segments_) {
+        if (!segment->complete) {
+          QFile::remove(segment->params.filename());
+        }
+      }
+    }
+    if (!audio_filename.isEmpty()) {
+      // Audio can't be checkpointed mid-file, a resumed export re-encodes it from scratch
+      QFile::remove(audio_filename);
+    }
+
+    qDeleteAll(segments_);
+    segments_.clear();
+    segment_writers_.clear();
+  }
+
+  if (!passthrough_filename.isEmpty()) {
+    QString audio_filename = encoder_ ? encoder_->params().filename() : QString();
+
+    if (success && !IsCancelled()) {
+      // Mux the stream-copied video together with any separately encoded audio
+      QString concat_error;
+      if (!FFmpegEncoder::ConcatenateSegments({passthrough_filename}, audio_filename, params_.filename(), &concat_error)) {
+        SetError(concat_error);
+        success = false;
+      } else {
+        emit ProgressChanged(1);
+      }
+    }
+
+    QFile::remove(passthrough_filename);
+    if (!audio_filename.isEmpty()) {
+      QFile::remove(audio_filename);
+    }
+  }
+
+  if (success && !IsCancelled()) {
+    // A successful export supersedes any resume state left by earlier attempts
+    QFile::remove(checkpoint_filename_);
+
+    if (params_.audio_enabled()) {
+      double integrated = loudness_meter_.GetIntegratedLoudness();
+      if (!qIsInf(integrated)) {
+        // Leave the R128 measurement as the final status so a compliance check doesn't need a
+        // separate analysis pass
+        emit StatusChanged(tr("Integrated loudness: %1 LUFS").arg(QString::number(integrated, 'f', 1)));
+      }
+    }
+  }
+
   // If cancelled, delete the file we made, which is always a file we created since we write to a
   // temp file during the actual encoding process
   if (IsCancelled()) {
@@ -203,27 +468,34 @@ bool ExportTask::Run()
 
 bool ExportTask::FrameDownloaded(FramePtr f, const rational &time)
 {
+  if (segments_.isEmpty()) {
+    return true;
+  }
+
   rational actual_time = time - export_range_.in();
 
-  time_map_.insert(actual_time, f);
+  int64_t frame_index = Timecode::time_to_timestamp(actual_time, video_params().frame_rate_as_time_base());
+  int segment_index = qMin(int(frame_index / frames_per_segment_), segments_.size() - 1);
 
-  while (!IsCancelled()) {
-    rational real_time = Timecode::timestamp_to_time(frame_time_,
-                                                     video_params().frame_rate_as_time_base());
+  QMutexLocker locker(&segment_mutex_);
 
-    if (!time_map_.contains(real_time)) {
-      break;
-    }
+  if (segment_writer_error_) {
+    return false;
+  }
 
-    // Unfortunately this can't be done in another thread since the frames need to be sent
-    // one after the other chronologically.
-    if (!encoder_->WriteFrame(time_map_.take(real_time), real_time)) {
-      SetError(encoder_->GetError());
-      return false;
-    }
+  segments_.at(segment_index)->time_map.insert(frame_index, f);
+  segment_frames_queued_++;
+  segment_wait_.wakeAll();
 
-    frame_time_++;
-    emit ProgressChanged(double(frame_time_) / double(GetTotalNumberOfFrames()));
+  EmitPipelineStatus();
+
+  // Apply backpressure so rendering doesn't run arbitrarily far ahead of the encoders. Only
+  // wait while a writer actually has a frame to consume, otherwise we could deadlock here
+  // waiting on a frame that's queued up behind us on this thread.
+  while (!IsCancelled() && !segment_writer_error_
+         && segment_frames_queued_ >= QThread::idealThreadCount() * 2
+         && SegmentWritersHaveWork()) {
+    segment_wait_.wait(&segment_mutex_);
   }
 
   return true;
@@ -246,6 +518,9 @@ bool ExportTask::AudioDownloaded(const TimeRange &range, const SampleBuffer &sam
 
 bool ExportTask::EncodeSubtitle(const SubtitleBlock *sub)
 {
+  // The subtitle encoder may be shared with the video writer thread
+  QMutexLocker locker(&encoder_mutex_);
+
   if (!subtitle_encoder_->WriteSubtitle(sub)) {
     SetError(subtitle_encoder_->GetError());
     return false;
@@ -254,13 +529,45 @@ bool ExportTask::EncodeSubtitle(const SubtitleBlock *sub)
   }
 }
 
+bool ExportTask::EncodeSubtitles(const QVector<const SubtitleBlock*> &subtitles)
+{
+  if (subtitles.isEmpty()) {
+    return true;
+  }
+
+  // Mux the whole batch under one lock acquisition rather than contending with the video
+  // writer thread once per block
+  QMutexLocker locker(&encoder_mutex_);
+
+  foreach (const SubtitleBlock *sub, subtitles) {
+    if (!subtitle_encoder_->WriteSubtitle(sub)) {
+      SetError(subtitle_encoder_->GetError());
+      return false;
+    }
+  }
+
+  return true;
+}
+
 bool ExportTask::WriteAudioLoop(const TimeRange& time, const SampleBuffer &samples)
 {
-  if (!encoder_->WriteAudio(samples)) {
+  bool written;
+
+  {
+    // The encoder may be shared with the video writer thread
+    QMutexLocker locker(&encoder_mutex_);
+    written = encoder_->WriteAudio(samples);
+  }
+
+  if (!written) {
     SetError(encoder_->GetError());
     return false;
   }
 
+  // WriteAudioLoop only ever runs in presentation order, which is exactly what the loudness
+  // measurement needs
+  loudness_meter_.PushSamples(samples);
+
   audio_time_ = time.out();
 
   for (auto it=audio_map_.begin(); it!=audio_map_.end(); it++) {
@@ -284,4 +591,361 @@ bool ExportTask::WriteAudioLoop(const TimeRange& time, const SampleBuffer &sampl
   return true;
 }
 
+QString ExportTask::GetSegmentFilename(const QString &suffix) const
+{
+  // Insert the suffix before the extension so FFmpeg can still determine the format from it
+  QFileInfo fi(params_.filename());
+  return fi.dir().filePath(QStringLiteral("%1.%2.%3").arg(fi.completeBaseName(), suffix, fi.suffix()));
+}
+
+bool ExportTask::GetPassthroughSource(QString *filename, rational *source_in) const
+{
+  Sequence* sequence = dynamic_cast<Sequence*>(viewer());
+  if (!sequence) {
+    return false;
+  }
+
+  // Find exactly one clip covering the entire export range, with no other blocks but gaps
+  // composited anywhere over it
+  ClipBlock* candidate = nullptr;
+
+  TrackList* list = sequence->track_list(Track::kVideo);
+  for (int i=0; i<list->GetTrackCount(); i++) {
+    Track* track = list->GetTrackAt(i);
+    if (track->IsMuted()) {
+      continue;
+    }
+
+    foreach (Block* block, track->Blocks()) {
+      if (block->out() <= export_range_.in() || block->in() >= export_range_.out()) {
+        continue;
+      }
+
+      if (dynamic_cast<GapBlock*>(block)) {
+        continue;
+      }
+
+      ClipBlock* clip = dynamic_cast<ClipBlock*>(block);
+      if (!clip || !clip->is_enabled() || candidate
+          || clip->in() > export_range_.in() || clip->out() < export_range_.out()) {
+        return false;
+      }
+
+      candidate = clip;
+    }
+  }
+
+  if (!candidate) {
+    return false;
+  }
+
+  // The clip must not retime its media in any way
+  if (!qFuzzyCompare(candidate->speed(), 1.0) || candidate->reverse()
+      || candidate->in_transition() || candidate->out_transition()) {
+    return false;
+  }
+
+  // The clip must connect directly to FFmpeg footage with no nodes in between
+  Footage* footage = dynamic_cast<Footage*>(candidate->GetConnectedOutput(ClipBlock::kBufferIn));
+  if (!footage || !footage->IsValid() || footage->decoder() != QStringLiteral("ffmpeg")) {
+    return false;
+  }
+
+  const VideoParams& src = footage->GetVideoParams();
+  const VideoParams& dst = params_.video_params();
+  if (src.width() != dst.width() || src.height() != dst.height()
+      || src.frame_rate() != dst.frame_rate()
+      || src.pixel_aspect_ratio() != dst.pixel_aspect_ratio()
+      || src.interlacing() != dst.interlacing()) {
+    return false;
+  }
+
+  // Stream copying bypasses color management, so the source must already be in the space the
+  // export would convert to
+  QString src_colorspace = src.colorspace();
+  if (src_colorspace.isEmpty()) {
+    src_colorspace = color_manager_->GetDefaultInputColorSpace();
+  }
+  if (params_.color_transform().is_display() || params_.color_transform().output() != src_colorspace) {
+    return false;
+  }
+
+  rational media_start = candidate->media_in() + (export_range_.in() - candidate->in());
+  if (media_start < 0) {
+    return false;
+  }
+
+  *filename = footage->filename();
+  *source_in = media_start;
+
+  return true;
+}
+
+bool ExportTask::OpenSegments(int count)
+{
+  // Mirror the frame count Render() will produce for this range
+  TimeRangeListFrameIterator iterator({export_range_}, video_params().frame_rate_as_time_base());
+  int64_t total_frames = iterator.size();
+
+  frames_per_segment_ = (total_frames + count - 1) / count;
+  if (frames_per_segment_ == 0) {
+    frames_per_segment_ = 1;
+  }
+
+  // If a previous run of this export crashed or was cancelled partway, reuse the segment files
+  // it managed to finish instead of re-rendering them
+  QHash<int, QString> completed;
+  if (LoadCheckpoint(&completed)) {
+    qDebug() << "Resuming export from checkpoint with" << completed.size() << "completed segment(s)";
+  }
+
+  bool success = true;
+
+  for (int64_t start=0; start<total_frames && success; start+=frames_per_segment_) {
+    ExportSegment* segment = new ExportSegment();
+
+    segment->params = params_;
+    segment->params.SetFilename(GetSegmentFilename(QStringLiteral("seg%1").arg(segments_.size())));
+    segment->params.DisableAudio();
+    segment->params.DisableSubtitles();
+    segment->start_frame = start;
+    segment->end_frame = qMin(start + frames_per_segment_, total_frames);
+    segment->frame_time = 0;
+    segment->complete = false;
+
+    if (completed.contains(segments_.size())) {
+      // This segment was fully written and finalized by the previous run, no encoder needed
+      segment->params.SetFilename(completed.value(segments_.size()));
+      segment->frame_time = segment->end_frame - segment->start_frame;
+      segment->complete = true;
+      segments_.append(segment);
+      continue;
+    }
+
+    segment->encoder = std::shared_ptr<Encoder>(Encoder::CreateFromParams(segment->params));
+
+    if (!segment->encoder) {
+      SetError(tr("Failed to create encoder"));
+      delete segment;
+      success = false;
+      break;
+    }
+
+    if (!segment->encoder->Open()) {
+      SetError(tr("Failed to open file: %1").arg(segment->encoder->GetError()));
+      delete segment;
+      success = false;
+      break;
+    }
+
+    segments_.append(segment);
+  }
+
+  if (!success) {
+    // Opening a segment failed, close and remove the ones we already made (but leave files
+    // restored from a checkpoint alone so a later attempt can still resume)
+    foreach (ExportSegment* segment, segments_) {
+      if (segment->encoder) {
+        segment->encoder->Close();
+        QFile::remove(segment->params.filename());
+      }
+      delete segment;
+    }
+    segments_.clear();
+  }
+
+  return success;
+}
+
+void ExportTask::WriteCheckpoint()
+{
+  QFile file(checkpoint_filename_);
+  if (!file.open(QFile::WriteOnly)) {
+    // Not being able to checkpoint only costs resumability, the export itself can continue
+    qWarning() << "Failed to write export checkpoint to" << checkpoint_filename_;
+    return;
+  }
+
+  QXmlStreamWriter writer(&file);
+
+  writer.writeStartDocument();
+
+  writer.writeStartElement(QStringLiteral("resume"));
+  writer.writeAttribute(QStringLiteral("version"), QStringLiteral("1"));
+
+  writer.writeTextElement(QStringLiteral("params"), params_fingerprint_);
+  writer.writeTextElement(QStringLiteral("segmentsize"), QString::number(frames_per_segment_));
+
+  for (int i=0; i<segments_.size(); i++) {
+    if (segments_.at(i)->complete) {
+      writer.writeStartElement(QStringLiteral("segment"));
+      writer.writeAttribute(QStringLiteral("index"), QString::number(i));
+      writer.writeCharacters(segments_.at(i)->params.filename());
+      writer.writeEndElement(); // segment
+    }
+  }
+
+  writer.writeEndElement(); // resume
+
+  writer.writeEndDocument();
+}
+
+bool ExportTask::LoadCheckpoint(QHash<int, QString> *completed) const
+{
+  QFile file(checkpoint_filename_);
+  if (!file.open(QFile::ReadOnly)) {
+    return false;
+  }
+
+  QXmlStreamReader reader(&file);
+  QHash<int, QString> loaded;
+
+  while (XMLReadNextStartElement(&reader)) {
+    if (reader.name() == QStringLiteral("resume")) {
+      int version = 0;
+
+      XMLAttributeLoop((&reader), attr) {
+        if (attr.name() == QStringLiteral("version")) {
+          version = attr.value().toInt();
+        }
+      }
+
+      if (version != 1) {
+        return false;
+      }
+
+      while (XMLReadNextStartElement(&reader)) {
+        if (reader.name() == QStringLiteral("params")) {
+          if (reader.readElementText() != params_fingerprint_) {
+            // The parameters changed since the partial export was made, its segments can't be
+            // trusted to match what this job would produce
+            return false;
+          }
+        } else if (reader.name() == QStringLiteral("segmentsize")) {
+          if (reader.readElementText().toLongLong() != frames_per_segment_) {
+            return false;
+          }
+        } else if (reader.name() == QStringLiteral("segment")) {
+          int index = -1;
+
+          XMLAttributeLoop((&reader), attr) {
+            if (attr.name() == QStringLiteral("index")) {
+              index = attr.value().toInt();
+            }
+          }
+
+          QString segment_filename = reader.readElementText();
+          if (index >= 0 && QFileInfo::exists(segment_filename)) {
+            loaded.insert(index, segment_filename);
+          }
+        } else {
+          reader.skipCurrentElement();
+        }
+      }
+    } else {
+      reader.skipCurrentElement();
+    }
+  }
+
+  if (loaded.isEmpty()) {
+    return false;
+  }
+
+  *completed = loaded;
+  return true;
+}
+
+bool ExportTask::WriteSegmentLoop(ExportSegment *segment)
+{
+  QMutexLocker locker(&segment_mutex_);
+
+  while (!IsCancelled() && !segment_writer_error_) {
+    if (segment->frame_time == segment->end_frame - segment->start_frame) {
+      // All of this segment's frames have been written
+      if (segment->encoder != encoder_) {
+        // Finalize the file immediately so it survives a crash, then checkpoint it so a
+        // relaunched export knows it can be reused
+        locker.unlock();
+        segment->encoder->Close();
+        locker.relock();
+
+        if (segment->encoder->GetError().isEmpty()) {
+          segment->complete = true;
+          WriteCheckpoint();
+        }
+      }
+
+      return true;
+    }
+
+    int64_t expected = segment->start_frame + segment->frame_time;
+
+    if (!segment->time_map.contains(expected)) {
+      if (segment_render_done_) {
+        // No more frames are coming, so this segment will stay incomplete (cancel or error)
+        break;
+      }
+
+      segment_wait_.wait(&segment_mutex_);
+      continue;
+    }
+
+    FramePtr frame = segment->time_map.take(expected);
+    segment_frames_queued_--;
+    segment_wait_.wakeAll();
+
+    locker.unlock();
+
+    // Write with a time relative to this segment's start so its encoder starts at zero
+    rational segment_time = Timecode::timestamp_to_time(segment->frame_time,
+                                                        video_params().frame_rate_as_time_base());
+
+    bool written;
+    if (segment->encoder == encoder_) {
+      // This encoder is shared with the audio/subtitle writes on other threads
+      QMutexLocker encoder_locker(&encoder_mutex_);
+      written = segment->encoder->WriteFrame(frame, segment_time);
+    } else {
+      written = segment->encoder->WriteFrame(frame, segment_time);
+    }
+
+    locker.relock();
+
+    if (!written) {
+      SetError(segment->encoder->GetError());
+      segment_writer_error_ = true;
+      segment_wait_.wakeAll();
+      return false;
+    }
+
+    segment->frame_time++;
+
+    frame_time_++;
+    emit ProgressChanged(double(frame_time_) / double(GetTotalNumberOfFrames()));
+    EmitPipelineStatus();
+  }
+
+  return !IsCancelled() && !segment_writer_error_;
+}
+
+void ExportTask::EmitPipelineStatus()
+{
+  emit StatusChanged(tr("Rendering: %1 | Waiting for encoder: %2 | Encoded: %3/%4")
+                     .arg(QString::number(GetRunningTicketCount()),
+                          QString::number(segment_frames_queued_),
+                          QString::number(frame_time_),
+                          QString::number(GetTotalNumberOfFrames())));
+}
+
+bool ExportTask::SegmentWritersHaveWork() const
+{
+  foreach (ExportSegment* segment, segments_) {
+    if (segment->time_map.contains(segment->start_frame + segment->frame_time)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 }
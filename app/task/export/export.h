@@ -21,6 +21,11 @@
 #ifndef EXPORTTASK_H
 #define EXPORTTASK_H
 
+#include <QFuture>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "audio/loudnessanalyzer.h"
 #include "codec/encoder.h"
 #include "node/output/viewer/viewer.h"
 #include "render/colorprocessor.h"
@@ -45,17 +50,71 @@ protected:
 
   virtual bool EncodeSubtitle(const SubtitleBlock *sub) override;
 
+  virtual bool EncodeSubtitles(const QVector<const SubtitleBlock*> &subtitles) override;
+
   virtual bool TwoStepFrameRendering() const override
   {
     return false;
   }
 
 private:
+  /**
+   * @brief One slice of the export range encoded by its own independent encoder instance
+   */
+  struct ExportSegment {
+    EncodingParams params;
+    std::shared_ptr<Encoder> encoder;
+    int64_t start_frame;
+    int64_t end_frame;
+    int64_t frame_time;
+    bool complete;
+    QHash<int64_t, FramePtr> time_map;
+  };
+
   bool WriteAudioLoop(const TimeRange &time, const SampleBuffer &samples);
 
-  ProjectCopier *copier_;
+  QString GetSegmentFilename(const QString &suffix) const;
+
+  /**
+   * @brief Find a source file whose packets can be stream-copied for the whole export range
+   *
+   * Returns true only if the export range maps to a single clip whose node chain is identity
+   * (no effects, speed 1, no transitions, colorspace already matches) backed directly by FFmpeg
+   * footage with the same video parameters as the export. `source_in` receives the media time
+   * the export range starts at.
+   */
+  bool GetPassthroughSource(QString *filename, rational *source_in) const;
+
+  bool OpenSegments(int count);
+
+  /**
+   * @brief Record which segments are fully written and finalized so a relaunched export can
+   * resume from them (segment_mutex_ must be held)
+   */
+  void WriteCheckpoint();
+
+  /**
+   * @brief Read a previous run's checkpoint, returning the completed segment files that still
+   * exist and validate against the current job's parameters
+   */
+  bool LoadCheckpoint(QHash<int, QString> *completed) const;
+
+  /**
+   * @brief Thread body that drains one segment's frame queue into its encoder in order
+   */
+  bool WriteSegmentLoop(ExportSegment *segment);
+
+  /**
+   * @brief Returns true if any segment's next expected frame is queued (segment_mutex_ must be held)
+   */
+  bool SegmentWritersHaveWork() const;
+
+  /**
+   * @brief Emit a status line showing the occupancy of each pipeline stage (segment_mutex_ must be held)
+   */
+  void EmitPipelineStatus();
 
-  QHash<rational, FramePtr> time_map_;
+  ProjectCopier *copier_;
 
   QHash<TimeRange, SampleBuffer> audio_map_;
 
@@ -75,6 +134,31 @@ private:
 
   TimeRange export_range_;
 
+  QString checkpoint_filename_;
+
+  QString params_fingerprint_;
+
+  QVector<ExportSegment*> segments_;
+
+  QVector<QFuture<bool> > segment_writers_;
+
+  QMutex segment_mutex_;
+
+  QWaitCondition segment_wait_;
+
+  QMutex encoder_mutex_;
+
+  bool segment_render_done_;
+
+  bool segment_writer_error_;
+
+  int64_t segment_frames_queued_;
+
+  int64_t frames_per_segment_;
+
+  // Meters the encoded audio in presentation order for the R128 report at the end
+  LoudnessAnalyzer loudness_meter_;
+
 };
 
 }
@@ -51,6 +51,7 @@ PreCacheTask::PreCacheTask(Footage *footage, int index, Sequence* sequence)
   viewer()->SetValueHintForInput(ViewerOutput::kTextureInput, Node::ValueHint({NodeValue::kTexture}, Track::Reference(Track::kVideo, index).ToString()));
 
   SetTitle(tr("Pre-caching %1:%2").arg(footage_->filename(), QString::number(index)));
+  SetPriority(kBackground);
 }
 
 PreCacheTask::~PreCacheTask()
@@ -56,6 +56,12 @@ bool ProjectImportTask::Run()
 
   Import(folder_, filenames_, imported, command_);
 
+  // If anything was imported, a batch was started by the first AddItemToFolder - close it so
+  // the model updates stay bracketed in both the redo and the undo direction
+  if (command_->child_count() > 0) {
+    command_->add_child(new ProjectBatchOperationCommand(folder_->project(), false));
+  }
+
   if (IsCancelled()) {
     delete command_;
     command_ = nullptr;
@@ -226,6 +232,12 @@ void ProjectImportTask::AddItemToFolder(Folder *folder, Node *item, MultiUndoCom
   // Create undoable command that adds the items to the model
   Project* project = folder_->project();
 
+  if (command->child_count() == 0) {
+    // First item - suspend per-item view updates until the whole batch has landed, otherwise
+    // importing thousands of files is bounded by model churn rather than by probing
+    command->add_child(new ProjectBatchOperationCommand(project, true));
+  }
+
   NodeAddCommand* nac = new NodeAddCommand(project, item);
   nac->PushToThread(project->thread());
   command->add_child(nac);
@@ -21,7 +21,9 @@
 #include "load.h"
 
 #include <QApplication>
+#include <QtConcurrent/QtConcurrent>
 
+#include "node/project/footage/footage.h"
 #include "node/project/serializer/serializer.h"
 
 namespace olive {
@@ -37,8 +39,14 @@ bool ProjectLoadTask::Run()
 
   project_->set_filename(GetFilename());
 
+  // Setting each footage's filename during deserialization would otherwise probe that file on
+  // the spot, serializing all the probes. Defer them so they can run in parallel afterwards.
+  Footage::SetProbingDeferredForThisThread(true);
+
   ProjectSerializer::Result result = ProjectSerializer::Load(project_, GetFilename(), ProjectSerializer::kProject);
 
+  Footage::SetProbingDeferredForThisThread(false);
+
   layout_ = result.GetLoadData().layout;
 
   switch (result.code()) {
@@ -70,6 +78,34 @@ bool ProjectLoadTask::Run()
   }
 
   if (result == ProjectSerializer::kSuccess) {
+    // Warm the probe cache for every footage file concurrently. This is pure file I/O - the
+    // nodes aren't touched - so the expensive part (probing uncached files, which over network
+    // storage can take seconds each) costs the slowest file rather than the sum of all of them.
+    QVector<Footage*> footage;
+    foreach (Node *n, project_->nodes()) {
+      if (Footage *f = dynamic_cast<Footage*>(n)) {
+        footage.append(f);
+      }
+    }
+
+    QStringList filenames;
+    foreach (Footage *f, footage) {
+      QString fn = f->filename();
+      if (!fn.isEmpty() && QFileInfo::exists(fn)) {
+        filenames.append(fn);
+      }
+    }
+
+    QtConcurrent::blockingMap(filenames, [](const QString &fn){
+      Footage::GetFootageDescription(fn);
+    });
+
+    // Now apply the (cached) probe results to each node serially, since this does mutate the
+    // graph
+    foreach (Footage *f, footage) {
+      f->Reprobe();
+    }
+
     project_->moveToThread(qApp->thread());
     return true;
   } else {
@@ -31,6 +31,7 @@
 #include <QApplication>
 #include <QFileInfo>
 #include <QThread>
+#include <QtConcurrent/QtConcurrent>
 
 #include "core.h"
 #include "node/audio/volume/volume.h"
@@ -136,6 +137,12 @@ bool LoadOTIOTask::Run()
     return true;
   }
 
+  // Creating each Footage below would otherwise probe its file on the spot, serializing
+  // thousands of probes through the middle of the track building loop. Defer them so the
+  // timeline structure appears quickly and the probes can run in parallel afterwards, the same
+  // way ProjectLoadTask does.
+  Footage::SetProbingDeferredForThisThread(true);
+
   foreach (auto timeline, timeline_sequnce_map.keys()) {
     Sequence* sequence = timeline_sequnce_map.value(timeline);
     sequence->setParent(project_);
@@ -176,6 +183,7 @@ bool LoadOTIOTask::Run()
       // Get clips from track
       auto clip_map = otio_track->children();
       if (es.outcome != OTIO::ErrorStatus::Outcome::OK) {
+        Footage::SetProbingDeferredForThisThread(false);
         SetError(tr("Failed to load clip"));
         return false;
       }
@@ -325,6 +333,27 @@ bool LoadOTIOTask::Run()
     }
   }
 
+  Footage::SetProbingDeferredForThisThread(false);
+
+  // Warm the probe cache for every referenced file concurrently, then apply the (cached)
+  // results to each node serially since that mutates the graph. A feature-length conform's
+  // import cost becomes the slowest file rather than the sum of all of them.
+  QStringList probe_filenames;
+  foreach (Footage *f, imported_footage) {
+    QString fn = f->filename();
+    if (!fn.isEmpty() && QFileInfo::exists(fn)) {
+      probe_filenames.append(fn);
+    }
+  }
+
+  QtConcurrent::blockingMap(probe_filenames, [](const QString &fn){
+    Footage::GetFootageDescription(fn);
+  });
+
+  foreach (Footage *f, imported_footage) {
+    f->Reprobe();
+  }
+
   project_->moveToThread(qApp->thread());
 
   return true;
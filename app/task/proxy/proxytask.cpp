@@ -0,0 +1,181 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "proxytask.h"
+
+#include <QDir>
+
+#include "common/filefunctions.h"
+#include "node/project.h"
+#include "render/diskmanager.h"
+
+namespace olive {
+
+ProxyTask::ProxyTask(Footage *footage, int index, int divider) :
+  original_footage_(footage),
+  divider_(divider)
+{
+  // Create new project
+  project_ = new Project();
+
+  // Create viewer rendering at the footage's own resolution and frame rate
+  VideoParams vp = footage->GetVideoParams(index);
+
+  VideoParams render_params = vp;
+  render_params.set_divider(1);
+
+  set_viewer(new ViewerOutput());
+  viewer()->setParent(project_);
+  viewer()->SetVideoParams(render_params);
+  set_video_params(render_params);
+
+  // Copy project config nodes
+  Project::CopySettings(footage->project(), project_);
+
+  // Copy footage node so it can render without any modifications from the user screwing it up
+  footage_ = static_cast<Footage*>(footage->copy());
+  footage_->setParent(project_);
+  Node::CopyInputs(footage, footage_, false);
+
+  Node::ConnectEdge(footage_, NodeInput(viewer(), ViewerOutput::kTextureInput));
+  viewer()->SetValueHintForInput(ViewerOutput::kTextureInput, Node::ValueHint({NodeValue::kTexture}, Track::Reference(Track::kVideo, index).ToString()));
+
+  // Encode a ProRes intermediate at the divided resolution
+  VideoParams proxy_params = render_params;
+  proxy_params.set_width(VideoParams::GetScaledDimension(vp.width(), divider));
+  proxy_params.set_height(VideoParams::GetScaledDimension(vp.height(), divider));
+
+  params_.set_format(ExportFormat::kFormatQuickTime);
+  params_.EnableVideo(proxy_params, ExportCodec::kCodecProRes);
+  params_.set_video_pix_fmt(ExportFormat::GetPixelFormatsForCodec(ExportFormat::kFormatQuickTime, ExportCodec::kCodecProRes).first());
+  params_.SetFilename(GenerateProxyFilename(footage->filename(), index, divider));
+
+  // Encode the proxy in the footage's own colorspace so it can stand in for the original file
+  // without changing its appearance
+  QString colorspace = vp.colorspace();
+  if (colorspace.isEmpty()) {
+    colorspace = footage->project()->color_manager()->GetDefaultInputColorSpace();
+  }
+  params_.set_color_transform(ColorTransform(colorspace));
+
+  SetTitle(tr("Generating proxy of \"%1\"").arg(footage->filename()));
+  SetPriority(kBackground);
+}
+
+ProxyTask::~ProxyTask()
+{
+  // This should delete the footage we copied and the viewer we created
+  delete project_;
+}
+
+bool ProxyTask::Run()
+{
+  encoder_ = std::shared_ptr<Encoder>(Encoder::CreateFromParams(params_));
+
+  if (!encoder_) {
+    SetError(tr("Failed to create encoder"));
+    return false;
+  }
+
+  if (!encoder_->Open()) {
+    SetError(tr("Failed to open proxy file: %1").arg(encoder_->GetError()));
+    return false;
+  }
+
+  color_processor_ = ColorProcessor::Create(project_->color_manager(),
+                                            project_->color_manager()->GetReferenceColorSpace(),
+                                            params_.color_transform());
+
+  frame_time_ = 0;
+
+  TimeRange proxy_range(0, footage_->GetVideoLength());
+
+  Render(project_->color_manager(),
+         {proxy_range},
+         TimeRangeList(),
+         TimeRange(),
+         RenderMode::kOnline,
+         nullptr,
+         QSize(params_.video_params().width(), params_.video_params().height()),
+         QMatrix4x4(),
+         encoder_->GetDesiredPixelFormat(),
+         VideoParams::kRGBAChannelCount,
+         color_processor_);
+
+  bool success = true;
+
+  encoder_->Close();
+  if (!encoder_->GetError().isEmpty()) {
+    SetError(encoder_->GetError());
+    success = false;
+  }
+
+  // A half-written proxy must never be picked up by a later session
+  if (IsCancelled() || !success) {
+    QFile::remove(params_.filename());
+    return false;
+  }
+
+  return success;
+}
+
+bool ProxyTask::FrameDownloaded(FramePtr frame, const rational &time)
+{
+  time_map_.insert(time, frame);
+
+  while (!IsCancelled()) {
+    rational real_time = Timecode::timestamp_to_time(frame_time_,
+                                                     video_params().frame_rate_as_time_base());
+
+    if (!time_map_.contains(real_time)) {
+      break;
+    }
+
+    // Frames need to be sent one after the other chronologically
+    if (!encoder_->WriteFrame(time_map_.take(real_time), real_time)) {
+      SetError(encoder_->GetError());
+      return false;
+    }
+
+    frame_time_++;
+  }
+
+  return true;
+}
+
+bool ProxyTask::AudioDownloaded(const TimeRange &range, const SampleBuffer &samples)
+{
+  // Proxies only stand in for video, audio continues to be read from the original file
+
+  Q_UNUSED(range)
+  Q_UNUSED(samples)
+
+  return true;
+}
+
+QString ProxyTask::GenerateProxyFilename(const QString &source, int stream_index, int divider)
+{
+  return QDir(DiskManager::GetProxyPath()).filePath(QStringLiteral("%1-%2-%3.mov")
+                                                    .arg(FileFunctions::GetUniqueFileIdentifier(source),
+                                                         QString::number(stream_index),
+                                                         QString::number(divider)));
+}
+
+}
@@ -0,0 +1,97 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef PROXYTASK_H
+#define PROXYTASK_H
+
+#include <QPointer>
+
+#include "codec/encoder.h"
+#include "node/project/footage/footage.h"
+#include "task/render/render.h"
+
+namespace olive {
+
+/**
+ * @brief Task that encodes a downscaled intermediate of a footage's video stream
+ *
+ * The proxy is written to a central proxy folder and, once attached to the Footage with
+ * Footage::set_proxy(), is transparently decoded in place of the original file whenever the
+ * renderer requests a frame at the proxy's divider or smaller.
+ */
+class ProxyTask : public RenderTask
+{
+  Q_OBJECT
+public:
+  ProxyTask(Footage* footage, int index, int divider);
+
+  virtual ~ProxyTask() override;
+
+  /**
+   * @brief The footage this proxy was generated from, or null if it was deleted mid-task
+   */
+  Footage* footage() const
+  {
+    return original_footage_;
+  }
+
+  const QString& proxy_filename() const
+  {
+    return params_.filename();
+  }
+
+  int divider() const
+  {
+    return divider_;
+  }
+
+protected:
+  virtual bool Run() override;
+
+  virtual bool FrameDownloaded(FramePtr frame, const rational &time) override;
+
+  virtual bool AudioDownloaded(const TimeRange& range, const SampleBuffer &samples) override;
+
+private:
+  static QString GenerateProxyFilename(const QString& source, int stream_index, int divider);
+
+  Project* project_;
+
+  Footage* footage_;
+
+  QPointer<Footage> original_footage_;
+
+  int divider_;
+
+  EncodingParams params_;
+
+  std::shared_ptr<Encoder> encoder_;
+
+  ColorProcessorPtr color_processor_;
+
+  QMap<rational, FramePtr> time_map_;
+
+  int64_t frame_time_;
+
+};
+
+}
+
+#endif // PROXYTASK_H
@@ -25,9 +25,14 @@
 
 namespace olive {
 
+QThread *RenderTask::watcher_thread_ = nullptr;
+int RenderTask::watcher_thread_users_ = 0;
+QMutex RenderTask::watcher_thread_lock_;
+
 RenderTask::RenderTask() :
   running_tickets_(0),
-  native_progress_signalling_(true)
+  native_progress_signalling_(true),
+  background_render_qos_(false)
 {
 }
 
@@ -45,9 +50,9 @@ bool RenderTask::Render(ColorManager* manager,
 {
   QMetaObject::invokeMethod(RenderManager::instance(), "SetAggressiveGarbageCollection", Q_ARG(bool, true));
 
-  // Run watchers in another thread so they can accept signals even while this thread is blocked
-  QThread watcher_thread;
-  watcher_thread.start();
+  // Watchers need a thread that can accept signals even while this thread is blocked - all
+  // concurrent tasks share one since the handlers are trivial
+  QThread *watcher_thread = AcquireWatcherThread();
 
   double progress_counter = 0;
   double total_length = 0;
@@ -64,9 +69,11 @@ bool RenderTask::Render(ColorManager* manager,
                                          audio_params_,
                                          RenderMode::kOnline);
 
+    rap.background = background_render_qos_;
+
     RenderTicketWatcher* watcher = new RenderTicketWatcher();
     watcher->setProperty("range", QVariant::fromValue(range));
-    PrepareWatcher(watcher, &watcher_thread);
+    PrepareWatcher(watcher, watcher_thread);
     IncrementRunningTickets();
     watcher->SetTicket(RenderManager::instance()->RenderAudio(rap));
   }
@@ -84,14 +91,17 @@ bool RenderTask::Render(ColorManager* manager,
 
   rational next_frame;
   for (int i=0; i<maximum_rendered_frames && iterator.GetNext(&next_frame); i++) {
-    StartTicket(&watcher_thread, manager, next_frame, mode, cache, force_size, force_matrix, force_format, force_channel_count, force_color_output);
+    StartTicket(watcher_thread, manager, next_frame, mode, cache, force_size, force_matrix, force_format, force_channel_count, force_color_output);
   }
 
   bool result = true;
 
-  // Subtitle loop, loops over all blocks in sequence on all tracks
+  // Subtitle loop, collects all blocks in sequence on all tracks in time order, then hands
+  // them off as a single batch so the encoder can mux them in one pass
   if (!subtitle_range.length().isNull()) {
     if (Sequence *sequence = dynamic_cast<Sequence*>(viewer_)) {
+      QVector<const SubtitleBlock*> subtitles;
+
       TrackList *list = sequence->track_list(Track::kSubtitle);
       QVector<int> block_indexes(list->GetTrackCount(), 0);
 
@@ -128,16 +138,17 @@ bool RenderTask::Render(ColorManager* manager,
 
           if (const SubtitleBlock *sub = dynamic_cast<const SubtitleBlock*>(this_block)) {
             if (sub->is_enabled()) {
-              if (!EncodeSubtitle(sub)) {
-                result = false;
-                break;
-              }
+              subtitles.append(sub);
             }
           }
 
           block_indexes[tracks_to_push.at(i)]++;
         }
       } while (!tracks_to_push.isEmpty());
+
+      if (!EncodeSubtitles(subtitles)) {
+        result = false;
+      }
     }
   }
 
@@ -168,7 +179,7 @@ bool RenderTask::Render(ColorManager* manager,
 
       } else if (ticket_type == RenderManager::kTypeVideo && TwoStepFrameRendering()) {
 
-        if (!DownloadFrame(&watcher_thread, watcher->Get().value<FramePtr>(), watcher->property("time").value<rational>())) {
+        if (!DownloadFrame(watcher_thread, watcher->Get().value<FramePtr>(), watcher->property("time").value<rational>())) {
           result = false;
         }
 
@@ -195,7 +206,7 @@ bool RenderTask::Render(ColorManager* manager,
         }
 
         if (iterator.GetNext(&next_frame)) {
-          StartTicket(&watcher_thread, manager, next_frame, mode, cache, force_size, force_matrix, force_format, force_channel_count, force_color_output);
+          StartTicket(watcher_thread, manager, next_frame, mode, cache, force_size, force_matrix, force_format, force_channel_count, force_color_output);
         }
 
       }
@@ -234,8 +245,7 @@ bool RenderTask::Render(ColorManager* manager,
     }
   }
 
-  watcher_thread.quit();
-  watcher_thread.wait();
+  ReleaseWatcherThread();
 
   QMetaObject::invokeMethod(RenderManager::instance(), "SetAggressiveGarbageCollection", Q_ARG(bool, false));
 
@@ -261,6 +271,45 @@ bool RenderTask::EncodeSubtitle(const SubtitleBlock *subtitle)
   return true;
 }
 
+bool RenderTask::EncodeSubtitles(const QVector<const SubtitleBlock*> &subtitles)
+{
+  foreach (const SubtitleBlock *subtitle, subtitles) {
+    if (!EncodeSubtitle(subtitle)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+QThread *RenderTask::AcquireWatcherThread()
+{
+  QMutexLocker locker(&watcher_thread_lock_);
+
+  if (!watcher_thread_) {
+    watcher_thread_ = new QThread();
+    watcher_thread_->start();
+  }
+
+  watcher_thread_users_++;
+
+  return watcher_thread_;
+}
+
+void RenderTask::ReleaseWatcherThread()
+{
+  QMutexLocker locker(&watcher_thread_lock_);
+
+  watcher_thread_users_--;
+
+  if (watcher_thread_users_ == 0) {
+    watcher_thread_->quit();
+    watcher_thread_->wait();
+    delete watcher_thread_;
+    watcher_thread_ = nullptr;
+  }
+}
+
 void RenderTask::PrepareWatcher(RenderTicketWatcher *watcher, QThread *thread)
 {
   watcher->moveToThread(thread);
@@ -289,6 +338,7 @@ void RenderTask::StartTicket(QThread* watcher_thread, ColorManager* manager,
   rvp.force_format = force_format;
   rvp.force_color_output = force_color_output;
   rvp.force_channel_count = force_channel_count;
+  rvp.background = background_render_qos_;
 
   if (cache) {
     rvp.AddCache(cache);
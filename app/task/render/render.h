@@ -56,6 +56,14 @@ protected:
 
   virtual bool EncodeSubtitle(const SubtitleBlock *subtitle);
 
+  /**
+   * @brief Encode all of the sequence's subtitles, pre-collected in time order
+   *
+   * The default implementation calls EncodeSubtitle() per block; subclasses can override to
+   * prepare the whole batch at once.
+   */
+  virtual bool EncodeSubtitles(const QVector<const SubtitleBlock*> &subtitles);
+
   ViewerOutput* viewer() const
   {
     return viewer_;
@@ -103,6 +111,17 @@ protected:
     native_progress_signalling_ = e;
   }
 
+  /**
+   * @brief Issue this task's render tickets at background QoS
+   *
+   * Used when the task runs alongside an interactive editing session (e.g. a background
+   * export) so its tickets queue behind the editor's requests instead of ahead of them.
+   */
+  void SetBackgroundRenderQoS(bool e)
+  {
+    background_render_qos_ = e;
+  }
+
   /**
    * @brief Only valid after Render() is called
    */
@@ -111,7 +130,27 @@ protected:
     return total_number_of_frames_;
   }
 
+  /**
+   * @brief Number of render tickets currently in flight (approximate, for status display)
+   */
+  int GetRunningTicketCount() const
+  {
+    return running_tickets_;
+  }
+
 private:
+  /**
+   * @brief Acquire the watcher signal dispatch thread shared by all render-style tasks
+   *
+   * Watchers only need a thread with an event loop to receive ticket signals on while the task
+   * thread itself is blocked, and those handlers do nothing but enqueue-and-wake, so one thread
+   * comfortably multiplexes every concurrent task instead of each task starting its own. The
+   * thread is started on first acquire and torn down when the last task releases it.
+   */
+  static QThread *AcquireWatcherThread();
+
+  static void ReleaseWatcherThread();
+
   void PrepareWatcher(RenderTicketWatcher* watcher, QThread *thread);
 
   void IncrementRunningTickets();
@@ -132,8 +171,14 @@ private:
 
   bool native_progress_signalling_;
 
+  bool background_render_qos_;
+
   int64_t total_number_of_frames_;
 
+  static QThread *watcher_thread_;
+  static int watcher_thread_users_;
+  static QMutex watcher_thread_lock_;
+
 private slots:
   void TicketDone(RenderTicketWatcher *watcher);
 
@@ -51,14 +51,36 @@ class Task : public QObject, public CancelableObject
 {
   Q_OBJECT
 public:
+  /**
+   * @brief Scheduling class used by TaskManager
+   *
+   * Tasks the user is actively waiting on (exports, project saves/loads) should be
+   * kInteractive. Proactive media work the user didn't explicitly queue up and won't block on
+   * (conforms, proxies, precaches) should be kBackground so it can never starve an interactive
+   * task of a pool thread. Lower values are scheduled first.
+   */
+  enum Priority {
+    kInteractive,
+    kBackground
+  };
+
   /**
    * @brief Task Constructor
    */
   Task() :
     title_(tr("Task")),
     error_(tr("Unknown error")),
-    start_time_(0)
+    start_time_(0),
+    priority_(kInteractive)
+  {
+  }
+
+  /**
+   * @brief Retrieve the scheduling class of this Task
+   */
+  Priority GetPriority() const
   {
+    return priority_;
   }
 
   /**
@@ -150,6 +172,17 @@ protected:
     title_ = s;
   }
 
+  /**
+   * @brief Set the scheduling class of this Task
+   *
+   * Defaults to kInteractive. Like the title, this should be set in the constructor - changing
+   * it after the Task has been handed to TaskManager has no effect.
+   */
+  void SetPriority(Priority p)
+  {
+    priority_ = p;
+  }
+
 signals:
   void Started(qint64 start_time);
 
@@ -164,6 +197,14 @@ signals:
    */
   void ProgressChanged(double d);
 
+  /**
+   * @brief Signal emitted with a human-readable status line
+   *
+   * Optional; emit this throughout Action() to give the user more detail than the progress bar
+   * alone, such as which stage of a pipeline is currently limiting throughput.
+   */
+  void StatusChanged(const QString& status);
+
   /**
    * @brief Emitted when task is finished
    *
@@ -178,6 +219,8 @@ private:
 
   qint64 start_time_;
 
+  Priority priority_;
+
 };
 
 }
@@ -23,13 +23,18 @@
 #include <QDebug>
 #include <QThread>
 
+#include "common/tracerecorder.h"
+
 namespace olive {
 
 TaskManager* TaskManager::instance_ = nullptr;
 
 TaskManager::TaskManager()
 {
-  thread_pool_.setMaxThreadCount(1);
+  // Two threads so that a long-running background task (e.g. a conform) and an interactive
+  // task the user is waiting on can run concurrently. StartPendingTasks() reserves one of
+  // these threads for interactive work.
+  thread_pool_.setMaxThreadCount(2);
 }
 
 TaskManager::~TaskManager()
@@ -45,6 +50,10 @@ TaskManager::~TaskManager()
   foreach (Task* t, tasks_) {
     t->deleteLater();
   }
+
+  for (Task* t : pending_tasks_) {
+    t->deleteLater();
+  }
 }
 
 void TaskManager::CreateInstance()
@@ -65,16 +74,30 @@ TaskManager *TaskManager::instance()
 
 int TaskManager::GetTaskCount() const
 {
-  return tasks_.size();
+  return tasks_.size() + int(pending_tasks_.size());
 }
 
 Task *TaskManager::GetFirstTask() const
 {
-  return tasks_.begin().value();
+  if (!tasks_.isEmpty()) {
+    return tasks_.begin().value();
+  }
+
+  return pending_tasks_.front();
 }
 
 void TaskManager::CancelTaskAndWait(Task* t)
 {
+  auto pending = std::find(pending_tasks_.begin(), pending_tasks_.end(), t);
+  if (pending != pending_tasks_.end()) {
+    // Task never started, so there's nothing to wait for
+    pending_tasks_.erase(pending);
+    emit TaskRemoved(t);
+    t->deleteLater();
+    emit TaskListChanged();
+    return;
+  }
+
   t->Cancel();
 
   QFutureWatcher<bool>* w = tasks_.key(t);
@@ -86,30 +109,28 @@ void TaskManager::CancelTaskAndWait(Task* t)
 
 void TaskManager::AddTask(Task* t)
 {
-  // Create a watcher for signalling
-  QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>();
-  connect(watcher, &QFutureWatcher<bool>::finished, this, &TaskManager::TaskFinished);
-
   // Add the Task to the queue
-  tasks_.insert(watcher, t);
-
-  // Run task concurrently
-  watcher->setFuture(
-#if QT_VERSION_MAJOR >= 6
-        QtConcurrent::run(&thread_pool_, &Task::Start, t)
-#else
-        QtConcurrent::run(&thread_pool_, t, &Task::Start)
-#endif
-        );
+  pending_tasks_.push_back(t);
 
   // Emit signal that a Task was added
   emit TaskAdded(t);
   emit TaskListChanged();
+
+  // Run it now if a thread is available for its priority class
+  StartPendingTasks();
 }
 
 void TaskManager::CancelTask(Task *t)
 {
-  if (std::find(failed_tasks_.begin(), failed_tasks_.end(), t) != failed_tasks_.end()) {
+  auto pending = std::find(pending_tasks_.begin(), pending_tasks_.end(), t);
+
+  if (pending != pending_tasks_.end()) {
+    // Task never started, so it can be removed directly
+    pending_tasks_.erase(pending);
+    emit TaskRemoved(t);
+    t->deleteLater();
+    emit TaskListChanged();
+  } else if (std::find(failed_tasks_.begin(), failed_tasks_.end(), t) != failed_tasks_.end()) {
     failed_tasks_.remove(t);
     emit TaskRemoved(t);
     t->deleteLater();
@@ -118,6 +139,71 @@ void TaskManager::CancelTask(Task *t)
   }
 }
 
+void TaskManager::StartTask(Task *t)
+{
+  // Create a watcher for signalling
+  QFutureWatcher<bool>* watcher = new QFutureWatcher<bool>();
+  connect(watcher, &QFutureWatcher<bool>::finished, this, &TaskManager::TaskFinished);
+
+  // Add the Task to the running list
+  tasks_.insert(watcher, t);
+
+  // Run task concurrently. The lambda form works on both Qt 5 and 6 and gives us somewhere to
+  // record the task's trace span from its own thread.
+  watcher->setFuture(QtConcurrent::run(&thread_pool_, [t]{
+    TraceRecorder *trace = TraceRecorder::instance();
+
+    if (trace) {
+      trace->BeginEvent("task", t->GetTitle());
+    }
+
+    bool ret = t->Start();
+
+    if (trace) {
+      trace->EndEvent("task", t->GetTitle());
+    }
+
+    return ret;
+  }));
+}
+
+void TaskManager::StartPendingTasks()
+{
+  while (!pending_tasks_.empty() && tasks_.size() < thread_pool_.maxThreadCount()) {
+    // Pick the most urgent class first, preserving FIFO order within a class
+    auto best = pending_tasks_.begin();
+    for (auto it = pending_tasks_.begin(); it != pending_tasks_.end(); it++) {
+      if ((*it)->GetPriority() < (*best)->GetPriority()) {
+        best = it;
+      }
+    }
+
+    if ((*best)->GetPriority() != Task::kInteractive
+        && GetRunningBackgroundTaskCount() >= thread_pool_.maxThreadCount() - 1) {
+      // No interactive tasks are waiting (or `best` would be one), but we still keep one
+      // thread free for any that arrive while the background tasks grind on
+      break;
+    }
+
+    Task* t = *best;
+    pending_tasks_.erase(best);
+    StartTask(t);
+  }
+}
+
+int TaskManager::GetRunningBackgroundTaskCount() const
+{
+  int count = 0;
+
+  foreach (Task* t, tasks_) {
+    if (t->GetPriority() != Task::kInteractive) {
+      count++;
+    }
+  }
+
+  return count;
+}
+
 void TaskManager::TaskFinished()
 {
   QFutureWatcher<bool>* watcher = static_cast<QFutureWatcher<bool>*>(sender());
@@ -138,6 +224,9 @@ void TaskManager::TaskFinished()
   watcher->deleteLater();
 
   emit TaskListChanged();
+
+  // A thread just freed up, so start the next queued task if there is one
+  StartPendingTasks();
 }
 
 }
@@ -34,8 +34,9 @@ namespace olive {
  *
  * TaskManager handles the life of a Task object. After a new Task is created, it should be sent to TaskManager through
  * AddTask(). TaskManager will take ownership of the task and add it to a queue until it system resources are available
- * for it to run. Currently, TaskManager will run no more Tasks than there are threads on the system (one task per
- * thread). As Tasks finished, TaskManager will start the next in the queue.
+ * for it to run. Tasks are scheduled by their Task::Priority - interactive tasks always run before background ones,
+ * and one pool thread is kept free for interactive work so it never waits behind a long conform or proxy generation.
+ * As Tasks finish, TaskManager will start the next in the queue.
  */
 class TaskManager : public QObject
 {
@@ -112,10 +113,34 @@ signals:
 
 private:
   /**
-   * @brief Internal task array
+   * @brief Start `t` on the thread pool immediately
+   */
+  void StartTask(Task *t);
+
+  /**
+   * @brief Start queued tasks while threads are available
+   *
+   * Picks the most urgent priority class first (FIFO within a class), and keeps one thread free
+   * for interactive tasks so a long background job like a conform can never occupy the whole
+   * pool while the user waits on an export or save.
+   */
+  void StartPendingTasks();
+
+  /**
+   * @brief Number of currently running tasks that aren't Task::kInteractive
+   */
+  int GetRunningBackgroundTaskCount() const;
+
+  /**
+   * @brief Internal array of running tasks
    */
   QHash<QFutureWatcher<bool>*, Task*> tasks_;
 
+  /**
+   * @brief Tasks waiting for a thread, in the order they were added
+   */
+  std::list<Task*> pending_tasks_;
+
   /**
    * @brief Internal list of failed tasks
    */
@@ -238,23 +238,15 @@ void TimelineMarkerList::childEvent(QChildEvent *e)
 
 void TimelineMarkerList::InsertIntoList(TimelineMarker *marker)
 {
-  // Insertion sort by time to allow some loop optimizations
-  bool found = false;
-  for (auto it=markers_.begin(); it!=markers_.end(); it++) {
-    TimelineMarker *m = *it;
+  // Keep sorted by in point so lookups can binary search
+  auto it = std::lower_bound(markers_.begin(), markers_.end(), marker,
+                             [](TimelineMarker *a, TimelineMarker *b) { return a->time().in() < b->time().in(); });
 
-    Q_ASSERT(m->time().in() != marker->time().in());
+  Q_ASSERT(it == markers_.end() || (*it)->time().in() != marker->time().in());
 
-    if (m->time().in() > marker->time().in()) {
-      markers_.insert(it, marker);
-      found = true;
-      break;
-    }
-  }
+  markers_.insert(it, marker);
 
-  if (!found) {
-    markers_.push_back(marker);
-  }
+  RebuildRunningMaxOut();
 }
 
 bool TimelineMarkerList::RemoveFromList(TimelineMarker *marker)
@@ -263,12 +255,27 @@ bool TimelineMarkerList::RemoveFromList(TimelineMarker *marker)
 
   if (it != markers_.end()) {
     markers_.erase(it);
+    RebuildRunningMaxOut();
     return true;
   }
 
   return false;
 }
 
+void TimelineMarkerList::RebuildRunningMaxOut()
+{
+  running_max_out_.resize(markers_.size());
+
+  rational max;
+  for (size_t i=0; i<markers_.size(); i++) {
+    const rational &out = markers_[i]->time().out();
+    if (i == 0 || out > max) {
+      max = out;
+    }
+    running_max_out_[i] = max;
+  }
+}
+
 void TimelineMarkerList::HandleMarkerModification()
 {
   emit MarkerModified(static_cast<TimelineMarker*>(sender()));
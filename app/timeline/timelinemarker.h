@@ -21,6 +21,7 @@
 #ifndef TIMELINEMARKER_H
 #define TIMELINEMARKER_H
 
+#include <algorithm>
 #include <olive/core/core.h>
 #include <QPainter>
 #include <QString>
@@ -97,11 +98,12 @@ public:
 
   TimelineMarker *GetMarkerAtTime(const rational &t) const
   {
-    for (auto it=markers_.cbegin(); it!=markers_.cend(); it++) {
-      TimelineMarker *m = *it;
-      if (m->time().in() == t) {
-        return m;
-      }
+    // List is sorted by in point, so we can binary search
+    auto it = std::lower_bound(markers_.cbegin(), markers_.cend(), t,
+                               [](TimelineMarker *m, const rational &t) { return m->time().in() < t; });
+
+    if (it != markers_.cend() && (*it)->time().in() == t) {
+      return *it;
     }
 
     return nullptr;
@@ -109,27 +111,53 @@ public:
 
   TimelineMarker *GetClosestMarkerToTime(const rational &t) const
   {
-    TimelineMarker *closest = nullptr;
+    if (markers_.empty()) {
+      return nullptr;
+    }
 
-    for (auto it=markers_.cbegin(); it!=markers_.cend(); it++) {
-      TimelineMarker *m = *it;
+    // List is sorted by in point, so the closest marker is either side of the first marker
+    // at/after the time
+    auto after = std::lower_bound(markers_.cbegin(), markers_.cend(), t,
+                                  [](TimelineMarker *m, const rational &t) { return m->time().in() < t; });
 
-      rational this_diff = qAbs(m->time().in() - t);
+    if (after == markers_.cbegin()) {
+      return *after;
+    }
 
-      if (closest) {
-        rational stored_diff = qAbs(closest->time().in() - t);
+    if (after == markers_.cend()) {
+      return markers_.back();
+    }
 
-        if (this_diff > stored_diff) {
-          // Since the list is organized by time, if the diff increases, assume we are only going
-          // to move further away from here and there's no need to check
-          break;
-        }
-      }
+    TimelineMarker *before = *(after - 1);
 
-      closest = m;
+    if ((*after)->time().in() - t <= t - before->time().in()) {
+      return *after;
+    } else {
+      return before;
     }
+  }
 
-    return closest;
+  /**
+   * @brief Get the span of markers that may intersect a given time range
+   *
+   * Returns a [first, last) iterator pair. Markers outside the span are guaranteed not to
+   * intersect the range, so painters can iterate just the span rather than the whole list.
+   * Markers inside the span must still be tested individually, since a short marker can sit
+   * between two longer ones that do reach into the range.
+   */
+  std::pair<std::vector<TimelineMarker*>::const_iterator, std::vector<TimelineMarker*>::const_iterator> GetMarkersInRange(const TimeRange &range) const
+  {
+    // The running maximum of out points is non-decreasing, so the first marker that can reach
+    // the range's in point can be binary searched
+    auto max_it = std::lower_bound(running_max_out_.cbegin(), running_max_out_.cend(), range.in());
+    auto first = markers_.cbegin() + (max_it - running_max_out_.cbegin());
+
+    // Markers are sorted by in point, so the span ends at the first marker starting at/after
+    // the range's out point
+    auto last = std::lower_bound(first, markers_.cend(), range.out(),
+                                 [](TimelineMarker *m, const rational &t) { return m->time().in() < t; });
+
+    return std::make_pair(first, last);
   }
 
 signals:
@@ -146,8 +174,18 @@ private:
   void InsertIntoList(TimelineMarker *m);
   bool RemoveFromList(TimelineMarker *m);
 
+  void RebuildRunningMaxOut();
+
   std::vector<TimelineMarker*> markers_;
 
+  /**
+   * @brief Running maximum of marker out points, kept parallel to markers_
+   *
+   * Sorted by construction, which is what makes GetMarkersInRange() able to binary search for
+   * its lower cut even though out points themselves aren't sorted.
+   */
+  std::vector<rational> running_max_out_;
+
 private slots:
   void HandleMarkerModification();
 
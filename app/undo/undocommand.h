@@ -51,6 +51,24 @@ public:
 
   virtual Project* GetRelevantProject() const = 0;
 
+  /**
+   * @brief Identifier for coalescing sequential commands into one undo entry
+   *
+   * When a command is pushed directly after another with the same non-empty merge ID, UndoStack
+   * offers it to the previous command via MergeWith() instead of growing the stack. Used by
+   * repeatable gestures like nudging so holding the key doesn't produce one entry per repeat.
+   */
+  const QString &GetMergeId() const { return merge_id_; }
+  void SetMergeId(const QString &id) { merge_id_ = id; }
+
+  /**
+   * @brief Attempt to absorb a newer, already-redone command into this one
+   *
+   * Returning true means this command's undo() now covers both commands. The absorbed command
+   * is deleted by the stack afterwards, so implementations must take anything they need from it.
+   */
+  virtual bool MergeWith(UndoCommand *other) { Q_UNUSED(other); return false; }
+
 protected:
   virtual void prepare(){}
   virtual void redo() = 0;
@@ -59,6 +77,8 @@ protected:
 private:
   bool modified_;
 
+  QString merge_id_;
+
   Project* project_;
 
   bool prepared_;
@@ -92,6 +112,23 @@ public:
     return children_[i];
   }
 
+  /**
+   * @brief Coalesce another multi-command into this one by concatenating its children
+   *
+   * Undoing the combined children in reverse returns to the state before the first command, so
+   * concatenation is always a valid merge for two multi-commands.
+   */
+  virtual bool MergeWith(UndoCommand *other) override
+  {
+    if (MultiUndoCommand *mc = dynamic_cast<MultiUndoCommand*>(other)) {
+      children_.insert(children_.end(), mc->children_.begin(), mc->children_.end());
+      mc->children_.clear();
+      return true;
+    }
+
+    return false;
+  }
+
 protected:
   virtual void redo() override;
   virtual void undo() override;
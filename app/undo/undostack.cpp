@@ -22,9 +22,9 @@
 
 #include <QCoreApplication>
 
-namespace olive {
+#include "config/config.h"
 
-const int UndoStack::kMaxUndoCommands = 200;
+namespace olive {
 
 class EmptyCommand : public UndoCommand
 {
@@ -77,14 +77,28 @@ void UndoStack::push(UndoCommand *command, const QString &name)
   }
   this->endRemoveRows();
 
-  // Do command and push
-  this->beginInsertRows(QModelIndex(), commands_.size(), commands_.size());
+  // Do command
   command->redo_and_set_modified();
+
+  // If this command directly follows another with the same merge ID, coalesce them into one
+  // undo entry rather than growing the stack
+  if (!commands_.empty()
+      && !command->GetMergeId().isEmpty()
+      && commands_.back().command->GetMergeId() == command->GetMergeId()
+      && commands_.back().command->MergeWith(command)) {
+    delete command;
+    UpdateActions();
+    return;
+  }
+
+  // Push
+  this->beginInsertRows(QModelIndex(), commands_.size(), commands_.size());
   commands_.push_back({command, name});
   this->endInsertRows();
 
-  // Delete oldest
-  if (commands_.size() > kMaxUndoCommands) {
+  // Delete oldest commands beyond the configured cap - a loop since the user may have lowered
+  // the cap in the preferences since the last push
+  while (commands_.size() > size_t(OLIVE_CONFIG("UndoLimit").toInt())) {
     this->beginRemoveRows(QModelIndex(), 0, 0);
     delete commands_.front().command;
     commands_.pop_front();
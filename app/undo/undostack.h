@@ -79,8 +79,6 @@ public slots:
   void redo();
 
 private:
-  static const int kMaxUndoCommands;
-
   struct CommandEntry
   {
     UndoCommand *command;
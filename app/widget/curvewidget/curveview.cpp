@@ -64,6 +64,9 @@ void CurveView::ConnectInput(const NodeKeyframeTrackReference& ref)
   // Signal to CurveWidget to update its bezier/linear/hold buttons if a key type changes
   connect(track_con, &KeyframeViewInputConnection::TypeChanged, this, &CurveView::SelectionChanged);
 
+  // Drop the cached curve whenever this track's keyframes change
+  connect(track_con, &KeyframeViewInputConnection::RequireUpdate, this, &CurveView::InvalidateTrackCurve);
+
   // Append to the list
   connected_inputs_.append(ref);
 }
@@ -78,6 +81,8 @@ void CurveView::DisconnectInput(const NodeKeyframeTrackReference& ref)
   // Remove keyframes belonging to this element and track
   RemoveKeyframesOfTrack(track_connections_.take(ref));
 
+  curve_path_cache_.remove(ref);
+
   // Remove from the list
   connected_inputs_.removeOne(ref);
 }
@@ -168,13 +173,25 @@ void CurveView::drawBackground(QPainter *painter, const QRectF &rect)
         painter->setPen(QPen(keyframe_colors_.value(ref),
                              qMax(1, fontMetrics().height() / 4)));
 
+        QPointF first_key_pos = GetKeyframePosition(track.first());
+        QPointF last_key_pos = GetKeyframePosition(track.last());
+
+        // The lead-in/lead-out lines extend to the visible edges, which move with scrolling, so
+        // they're drawn outside the cached path
+        painter->drawLine(QPointF(scene_bottom_left.x(), first_key_pos.y()), first_key_pos);
+        painter->drawLine(last_key_pos, QPointF(scene_top_right.x(), last_key_pos.y()));
+
+        auto cached_path = curve_path_cache_.constFind(ref);
+        if (cached_path != curve_path_cache_.constEnd()) {
+          // Tessellating the curve is by far the most expensive part of this paint, so reuse the
+          // path built last time - it's only dropped when a keyframe or the scale changes
+          painter->drawPath(cached_path.value());
+          continue;
+        }
+
         // Create a path
         QPainterPath path;
-
-        // Draw straight line leading to first keyframe
-        QPointF first_key_pos = GetKeyframePosition(track.first());
-        path.moveTo(QPointF(scene_bottom_left.x(), first_key_pos.y()));
-        path.lineTo(first_key_pos);
+        path.moveTo(first_key_pos);
 
         // Draw lines between each keyframe
         for (int i=1;i<track.size();i++) {
@@ -229,9 +246,7 @@ void CurveView::drawBackground(QPainter *painter, const QRectF &rect)
           }
         }
 
-        // Draw straight line leading from end keyframe
-        QPointF last_key_pos = GetKeyframePosition(track.last());
-        path.lineTo(QPointF(scene_top_right.x(), last_key_pos.y()));
+        curve_path_cache_.insert(ref, path);
 
         painter->drawPath(path);
       }
@@ -246,6 +261,34 @@ void CurveView::drawForeground(QPainter *painter, const QRectF &rect)
   super::drawForeground(painter, rect);
 }
 
+void CurveView::InvalidateTrackCurve()
+{
+  KeyframeViewInputConnection *track = static_cast<KeyframeViewInputConnection*>(sender());
+
+  curve_path_cache_.remove(track->GetReference());
+}
+
+void CurveView::ScaleChangedEvent(const double &scale)
+{
+  curve_path_cache_.clear();
+
+  super::ScaleChangedEvent(scale);
+}
+
+void CurveView::VerticalScaleChangedEvent(double scale)
+{
+  curve_path_cache_.clear();
+
+  super::VerticalScaleChangedEvent(scale);
+}
+
+void CurveView::TimeTargetChangedEvent(ViewerOutput *v)
+{
+  curve_path_cache_.clear();
+
+  super::TimeTargetChangedEvent(v);
+}
+
 void CurveView::ContextMenuEvent(Menu &m)
 {
   // View settings
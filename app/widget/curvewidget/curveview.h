@@ -21,6 +21,8 @@
 #ifndef CURVEVIEW_H
 #define CURVEVIEW_H
 
+#include <QPainterPath>
+
 #include "node/keyframe.h"
 #include "widget/keyframeview/keyframeview.h"
 #include "widget/slider/floatslider.h"
@@ -65,6 +67,12 @@ protected:
 
   virtual void DrawKeyframe(QPainter *painter, NodeKeyframe *key, KeyframeViewInputConnection *track, const QRectF &key_rect) override;
 
+  virtual void ScaleChangedEvent(const double &scale) override;
+
+  virtual void VerticalScaleChangedEvent(double scale) override;
+
+  virtual void TimeTargetChangedEvent(ViewerOutput *v) override;
+
   virtual bool FirstChanceMousePress(QMouseEvent *event) override;
   virtual void FirstChanceMouseMove(QMouseEvent *event) override;
   virtual void FirstChanceMouseRelease(QMouseEvent *event) override;
@@ -98,6 +106,15 @@ private:
   QHash<NodeKeyframeTrackReference, QColor> keyframe_colors_;
   QHash<NodeKeyframeTrackReference, KeyframeViewInputConnection*> track_connections_;
 
+  /**
+   * @brief Tessellated curve of each track cached between paints
+   *
+   * Rebuilding these per paint made every playhead movement re-tessellate every bezier on
+   * screen. Entries are dropped when the track's keyframes change or the view scale/time
+   * target changes.
+   */
+  QHash<NodeKeyframeTrackReference, QPainterPath> curve_path_cache_;
+
   int text_padding_;
 
   int minimum_grid_space_;
@@ -120,6 +137,9 @@ private:
 
   QVector<QVariant> drag_keyframe_values_;
 
+private slots:
+  void InvalidateTrackCurve();
+
 };
 
 }
@@ -21,6 +21,7 @@
 #include "keyframeview.h"
 
 #include <QMouseEvent>
+#include <QtMath>
 #include <QToolTip>
 #include <QVBoxLayout>
 
@@ -359,6 +360,9 @@ void KeyframeView::drawForeground(QPainter *painter, const QRectF &rect)
 
   painter->setRenderHint(QPainter::Antialiasing);
 
+  // Icons are stamped from cached pixmaps at fractional positions
+  painter->setRenderHint(QPainter::SmoothPixmapTransform);
+
   foreach (KeyframeViewInputConnection *track, tracks_) {
     const QVector<NodeKeyframe*> &keys = track->GetKeyframes();
 
@@ -424,40 +428,85 @@ void KeyframeView::drawForeground(QPainter *painter, const QRectF &rect)
   super::drawForeground(painter, rect);
 }
 
+// Room around the icon for the pen to stroke outside the keyframe rect
+const int kKeyframeIconMargin = 1;
+
 void KeyframeView::DrawKeyframe(QPainter *painter, NodeKeyframe *key, KeyframeViewInputConnection *track, const QRectF &key_rect)
 {
-  painter->setPen(Qt::black);
+  selection_manager_.DeclareDrawnObject(key, key_rect);
+
+  if (key->type() == NodeKeyframe::kInvalid) {
+    return;
+  }
 
+  QColor color;
   if (IsKeyframeSelected(key)) {
-    painter->setBrush(palette().highlight());
+    color = palette().highlight().color();
   } else {
-    painter->setBrush(track->GetBrush());
+    color = track->GetBrush().color();
   }
 
-  selection_manager_.DeclareDrawnObject(key, key_rect);
+  painter->drawPixmap(key_rect.topLeft() - QPointF(kKeyframeIconMargin, kKeyframeIconMargin),
+                      GetKeyframeIcon(key->type(), color, qRound(key_rect.width())));
+}
+
+QPixmap KeyframeView::GetKeyframeIcon(NodeKeyframe::Type type, const QColor &color, int key_sz)
+{
+  quint64 cache_key = (quint64(color.rgba()) << 32) | (quint64(key_sz) << 8) | quint64(type);
+
+  QPixmap pm = keyframe_icon_cache_.value(cache_key);
+
+  if (pm.isNull()) {
+    qreal dpr = devicePixelRatioF();
+    int pm_sz = key_sz + kKeyframeIconMargin * 2;
 
-  switch (key->type()) {
-  case NodeKeyframe::kInvalid:
-    break;
-  case NodeKeyframe::kLinear:
-  {
-    QPointF points[] = {
-      QPointF(key_rect.center().x(), key_rect.top()),
-      QPointF(key_rect.right(), key_rect.center().y()),
-      QPointF(key_rect.center().x(), key_rect.bottom()),
-      QPointF(key_rect.left(), key_rect.center().y())
-    };
-
-    painter->drawPolygon(points, 4);
-    break;
+    pm = QPixmap(qCeil(pm_sz * dpr), qCeil(pm_sz * dpr));
+    pm.setDevicePixelRatio(dpr);
+    pm.fill(Qt::transparent);
+
+    QPainter p(&pm);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setPen(Qt::black);
+    p.setBrush(color);
+
+    QRectF key_rect(kKeyframeIconMargin, kKeyframeIconMargin, key_sz, key_sz);
+
+    switch (type) {
+    case NodeKeyframe::kInvalid:
+      break;
+    case NodeKeyframe::kLinear:
+    {
+      QPointF points[] = {
+        QPointF(key_rect.center().x(), key_rect.top()),
+        QPointF(key_rect.right(), key_rect.center().y()),
+        QPointF(key_rect.center().x(), key_rect.bottom()),
+        QPointF(key_rect.left(), key_rect.center().y())
+      };
+
+      p.drawPolygon(points, 4);
+      break;
+    }
+    case NodeKeyframe::kBezier:
+      p.drawEllipse(key_rect);
+      break;
+    case NodeKeyframe::kHold:
+      p.drawRect(key_rect);
+      break;
+    }
+
+    keyframe_icon_cache_.insert(cache_key, pm);
   }
-  case NodeKeyframe::kBezier:
-    painter->drawEllipse(key_rect);
-    break;
-  case NodeKeyframe::kHold:
-    painter->drawRect(key_rect);
-    break;
+
+  return pm;
+}
+
+void KeyframeView::changeEvent(QEvent *event)
+{
+  if (event->type() == QEvent::PaletteChange || event->type() == QEvent::FontChange) {
+    keyframe_icon_cache_.clear();
   }
+
+  super::changeEvent(event);
 }
 
 void KeyframeView::ScaleChangedEvent(const double &scale)
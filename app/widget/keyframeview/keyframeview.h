@@ -22,6 +22,7 @@
 #define KEYFRAMEVIEWBASE_H
 
 #include <functional>
+#include <QPixmap>
 
 #include "keyframeviewinputconnection.h"
 #include "node/keyframe.h"
@@ -107,6 +108,8 @@ protected:
 
   virtual void TimebaseChangedEvent(const rational &timebase) override;
 
+  virtual void changeEvent(QEvent *event) override;
+
   virtual void ContextMenuEvent(Menu &m);
 
   virtual bool FirstChanceMousePress(QMouseEvent *event){return false;}
@@ -151,8 +154,18 @@ protected slots:
 private:
   rational CalculateNewTimeFromScreen(const rational& old_time, double cursor_diff);
 
+  QPixmap GetKeyframeIcon(NodeKeyframe::Type type, const QColor &color, int key_sz);
+
   QVector<KeyframeViewInputConnection*> tracks_;
 
+  /**
+   * @brief Pre-rendered keyframe icons keyed by type/color/size
+   *
+   * Keyframe icons get stamped hundreds of times per paint, so rather than stroking and filling
+   * an antialiased shape for each one, they're rendered once here and blitted.
+   */
+  QHash<quint64, QPixmap> keyframe_icon_cache_;
+
   TimeBasedViewSelectionManager<NodeKeyframe> selection_manager_;
 
   bool autoselect_siblings_;
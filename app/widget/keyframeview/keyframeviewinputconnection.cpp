@@ -40,6 +40,7 @@ KeyframeViewInputConnection::KeyframeViewInputConnection(const NodeKeyframeTrack
   connect(n, &Node::KeyframeTypeChanged, this, &KeyframeViewInputConnection::KeyframeChanged);
   connect(n, &Node::KeyframeTypeChanged, this, &KeyframeViewInputConnection::KeyframeTypeChanged);
   connect(n, &Node::KeyframeValueChanged, this, &KeyframeViewInputConnection::KeyframeChanged);
+  connect(n, &Node::KeyframeBezierChanged, this, &KeyframeViewInputConnection::KeyframeChanged);
 }
 
 void KeyframeViewInputConnection::SetKeyframeY(int y)
@@ -0,0 +1,119 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "memorymonitorwidget.h"
+
+#include <QHBoxLayout>
+#include <QLocale>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+#include "common/memorytelemetry.h"
+
+namespace olive {
+
+MemoryMonitorWidget::MemoryMonitorWidget(QWidget *parent) :
+  QWidget(parent)
+{
+  QVBoxLayout *layout = new QVBoxLayout(this);
+
+  tree_ = new QTreeWidget(this);
+  tree_->setColumnCount(3);
+  tree_->setHeaderLabels({tr("Source"), tr("Current"), tr("Peak")});
+  tree_->setRootIsDecorated(false);
+  tree_->setSelectionMode(QAbstractItemView::NoSelection);
+  layout->addWidget(tree_);
+
+  QHBoxLayout *button_layout = new QHBoxLayout();
+  button_layout->addStretch();
+
+  QPushButton *reset_btn = new QPushButton(tr("Reset Peaks"), this);
+  connect(reset_btn, &QPushButton::clicked, this, &MemoryMonitorWidget::ResetPeaks);
+  button_layout->addWidget(reset_btn);
+
+  layout->addLayout(button_layout);
+
+  refresh_timer_.setInterval(1000);
+  connect(&refresh_timer_, &QTimer::timeout, this, &MemoryMonitorWidget::Refresh);
+}
+
+void MemoryMonitorWidget::showEvent(QShowEvent *event)
+{
+  QWidget::showEvent(event);
+
+  Refresh();
+  refresh_timer_.start();
+}
+
+void MemoryMonitorWidget::hideEvent(QHideEvent *event)
+{
+  QWidget::hideEvent(event);
+
+  refresh_timer_.stop();
+}
+
+void MemoryMonitorWidget::Refresh()
+{
+  QVector<MemoryTelemetry::Snapshot> snapshots = MemoryTelemetry::instance()->Poll();
+
+  // Sources only ever appear or disappear, never reorder, so update rows in place to avoid
+  // the flicker of clearing the tree every poll
+  while (tree_->topLevelItemCount() > snapshots.size() + 1) {
+    delete tree_->takeTopLevelItem(tree_->topLevelItemCount() - 1);
+  }
+  while (tree_->topLevelItemCount() < snapshots.size() + 1) {
+    tree_->addTopLevelItem(new QTreeWidgetItem(tree_));
+  }
+
+  QLocale locale;
+
+  qint64 total_current = 0;
+  qint64 total_peak = 0;
+
+  for (int i=0; i<snapshots.size(); i++) {
+    const MemoryTelemetry::Snapshot &s = snapshots.at(i);
+
+    QTreeWidgetItem *item = tree_->topLevelItem(i);
+    item->setText(0, s.name);
+    item->setText(1, locale.formattedDataSize(s.current));
+    item->setText(2, locale.formattedDataSize(s.peak));
+
+    total_current += s.current;
+    total_peak += s.peak;
+  }
+
+  QTreeWidgetItem *total_item = tree_->topLevelItem(snapshots.size());
+  QFont bold_font = total_item->font(0);
+  bold_font.setBold(true);
+  for (int i=0; i<tree_->columnCount(); i++) {
+    total_item->setFont(i, bold_font);
+  }
+  total_item->setText(0, tr("Total"));
+  total_item->setText(1, locale.formattedDataSize(total_current));
+  total_item->setText(2, locale.formattedDataSize(total_peak));
+}
+
+void MemoryMonitorWidget::ResetPeaks()
+{
+  MemoryTelemetry::instance()->ResetPeaks();
+  Refresh();
+}
+
+}
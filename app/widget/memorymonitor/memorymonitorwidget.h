@@ -0,0 +1,60 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef MEMORYMONITORWIDGET_H
+#define MEMORYMONITORWIDGET_H
+
+#include <QTimer>
+#include <QTreeWidget>
+#include <QWidget>
+
+namespace olive {
+
+/**
+ * @brief Table of live usage and high-water marks per MemoryTelemetry source
+ *
+ * Polls MemoryTelemetry on a timer while visible. Peaks accumulate in the registry itself,
+ * so they persist across the panel being closed and reopened until explicitly reset.
+ */
+class MemoryMonitorWidget : public QWidget
+{
+  Q_OBJECT
+public:
+  MemoryMonitorWidget(QWidget *parent = nullptr);
+
+protected:
+  virtual void showEvent(QShowEvent *event) override;
+  virtual void hideEvent(QHideEvent *event) override;
+
+private:
+  QTreeWidget *tree_;
+
+  QTimer refresh_timer_;
+
+private slots:
+  void Refresh();
+
+  void ResetPeaks();
+
+};
+
+}
+
+#endif // MEMORYMONITORWIDGET_H
@@ -727,6 +727,10 @@ void NodeParamView::AddNode(Node *n, Node *ctx, NodeParamViewContext *context)
     connect(item, &NodeParamViewItem::Moved, this, &NodeParamView::QueueKeyframePositionUpdate);
     connect(item, &NodeParamViewItem::InputArraySizeChanged, this, &NodeParamView::InputArraySizeChanged);
 
+    // Items create their bodies lazily when they scroll into view, at which point the keyframes
+    // need to move from the titlebar Y to their real rows
+    connect(item, &NodeParamViewItem::BodyCreated, this, &NodeParamView::QueueKeyframePositionUpdate);
+
     item->SetKeyframeConnections(keyframe_view_->AddKeyframesOfNode(n));
   }
 }
@@ -48,6 +48,7 @@ const int NodeParamViewItemBody::kMaxWidgetColumn = kArrayRemoveColumn;
 NodeParamViewItem::NodeParamViewItem(Node *node, NodeParamViewCheckBoxBehavior create_checkboxes, QWidget *parent) :
   super(parent),
   body_(nullptr),
+  body_create_queued_(false),
   node_(node),
   create_checkboxes_(create_checkboxes),
   ctx_(nullptr),
@@ -55,8 +56,8 @@ NodeParamViewItem::NodeParamViewItem(Node *node, NodeParamViewCheckBoxBehavior c
 {
   node_->Retranslate();
 
-  // Create and add contents widget
-  RecreateBody();
+  // The body (i.e. all the editor widgets) is expensive to create and most items never scroll
+  // into view, so it's deferred until our first paint event rather than created here
 
   connect(node_, &Node::LabelChanged, this, &NodeParamViewItem::Retranslate);
   connect(node_, &Node::InputArraySizeChanged, this, &NodeParamViewItem::InputArraySizeChanged);
@@ -81,7 +82,22 @@ void NodeParamViewItem::Retranslate()
 
   title_bar()->SetText(GetTitleBarTextFromNode(node_));
 
-  body_->Retranslate();
+  if (body_) {
+    body_->Retranslate();
+  }
+}
+
+void NodeParamViewItem::paintEvent(QPaintEvent *event)
+{
+  super::paintEvent(event);
+
+  if (!body_ && !body_create_queued_) {
+    // This item has scrolled into view for the first time, so create its widgets now. Queued
+    // rather than done here because constructing widgets inside a paint event is asking for
+    // trouble.
+    body_create_queued_ = true;
+    QMetaObject::invokeMethod(this, &NodeParamViewItem::RecreateBody, Qt::QueuedConnection);
+  }
 }
 
 void NodeParamViewItem::RecreateBody()
@@ -99,22 +115,40 @@ void NodeParamViewItem::RecreateBody()
   body_->Retranslate();
   body_->SetTimebase(timebase_);
   body_->SetTimeTarget(time_target_);
+
+  // Restore any checkbox state received before the body existed
+  foreach (const NodeInput &input, checked_inputs_) {
+    body_->SetInputChecked(input, true);
+  }
+
   SetBody(body_);
+
+  body_create_queued_ = false;
+
+  emit BodyCreated();
 }
 
 int NodeParamViewItem::GetElementY(const NodeInput &c) const
 {
-  if (IsExpanded()) {
+  if (IsExpanded() && body_) {
     return body_->GetElementY(c);
   } else {
-    // Not expanded, put keyframes at the titlebar Y
+    // Not expanded (or body not created yet), put keyframes at the titlebar Y
     return mapToGlobal(title_bar()->rect().center()).y();
   }
 }
 
 void NodeParamViewItem::SetInputChecked(const NodeInput &input, bool e)
 {
-  body_->SetInputChecked(input, e);
+  if (e) {
+    checked_inputs_.insert(input);
+  } else {
+    checked_inputs_.remove(input);
+  }
+
+  if (body_) {
+    body_->SetInputChecked(input, e);
+  }
 }
 
 NodeParamViewItemBody::NodeParamViewItemBody(Node* node, NodeParamViewCheckBoxBehavior create_checkboxes, QWidget *parent) :
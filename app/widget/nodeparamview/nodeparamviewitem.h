@@ -25,6 +25,7 @@
 #include <QGridLayout>
 #include <QLabel>
 #include <QPushButton>
+#include <QSet>
 #include <QVBoxLayout>
 #include <QWidget>
 
@@ -172,14 +173,18 @@ public:
   {
     time_target_ = target;
 
-    body_->SetTimeTarget(target);
+    if (body_) {
+      body_->SetTimeTarget(target);
+    }
   }
 
   void SetTimebase(const rational& timebase)
   {
     timebase_ = timebase;
 
-    body_->SetTimebase(timebase);
+    if (body_) {
+      body_->SetTimebase(timebase);
+    }
   }
 
   Node *GetContext() const
@@ -222,16 +227,31 @@ signals:
 
   void InputArraySizeChanged(const QString &input, int old_size, int new_size);
 
+  /**
+   * @brief Emitted when the body (and therefore the parameter rows) has been (re)created
+   */
+  void BodyCreated();
+
+protected:
+  virtual void paintEvent(QPaintEvent *event) override;
+
 protected slots:
   virtual void Retranslate() override;
 
 private:
   NodeParamViewItemBody* body_;
 
+  bool body_create_queued_;
+
   Node* node_;
 
   NodeParamViewCheckBoxBehavior create_checkboxes_;
 
+  /**
+   * @brief Inputs currently checked, kept here so the state survives body recreation
+   */
+  QSet<NodeInput> checked_inputs_;
+
   Node *ctx_;
 
   ViewerOutput *time_target_;
@@ -29,6 +29,7 @@ namespace olive {
 
 NodeParamViewItemBase::NodeParamViewItemBase(QWidget *parent) :
   super(parent),
+  body_(nullptr),
   highlighted_(false)
 {
   // Create title bar widget
@@ -94,7 +95,8 @@ void NodeParamViewItemBase::paintEvent(QPaintEvent *event)
 
 void NodeParamViewItemBase::SetExpanded(bool e)
 {
-  setWidget(e ? body_ : hidden_body_);
+  // Body may not have been created yet if this item hasn't scrolled into view
+  setWidget((e && body_) ? body_ : hidden_body_);
   title_bar_->SetExpanded(e);
 
   emit ExpandedChanged(e);
@@ -0,0 +1,205 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "nodeprofilerwidget.h"
+
+#include <QPainter>
+#include <QtMath>
+
+namespace olive {
+
+const int NodeProfilerWidget::kHistoryLength;
+
+NodeProfilerWidget::NodeProfilerWidget(QWidget *parent) :
+  QWidget(parent),
+  queue_stats_()
+{
+  refresh_timer_.setInterval(500);
+  connect(&refresh_timer_, &QTimer::timeout, this, &NodeProfilerWidget::Refresh);
+}
+
+void NodeProfilerWidget::paintEvent(QPaintEvent *event)
+{
+  QWidget::paintEvent(event);
+
+  QPainter p(this);
+
+  int margin = fontMetrics().height() / 2;
+  int row_height = fontMetrics().height() * 2 + margin;
+
+  int y = margin;
+
+  // Main-thread job queue latency header - the count of jobs that waited a frame or more is
+  // the number a responsiveness regression shows up in first
+  qint64 slow_jobs = 0;
+  for (int i=3; i<MainThreadQueue::kLatencyBucketCount; i++) {
+    slow_jobs += queue_stats_.histogram[i];
+  }
+
+  p.setPen(palette().text().color());
+  p.drawText(QRect(margin, y, width() - margin * 2, fontMetrics().height()),
+             Qt::AlignLeft | Qt::AlignVCenter,
+             tr("Main thread queue: %1 jobs, %2 waited over 16 ms, max wait %3 ms")
+             .arg(QString::number(queue_stats_.total_jobs),
+                  QString::number(slow_jobs),
+                  QString::number(queue_stats_.max_latency_ms)));
+
+  y += fontMetrics().height() + margin;
+
+  // Timeline interaction latency percentiles - input-to-paint per operation type, so an
+  // editing responsiveness regression can be pinned to the operation that got slower
+  for (auto it=interaction_stats_.constBegin(); it!=interaction_stats_.constEnd(); it++) {
+    const InteractionTracker::Stats &s = it.value();
+
+    p.drawText(QRect(margin, y, width() - margin * 2, fontMetrics().height()),
+               Qt::AlignLeft | Qt::AlignVCenter,
+               tr("%1: %2 edits, p50 %3 ms, p90 %4 ms, p99 %5 ms, max %6 ms")
+               .arg(it.key(),
+                    QString::number(s.count),
+                    QString::number(s.p50),
+                    QString::number(s.p90),
+                    QString::number(s.p99),
+                    QString::number(s.max)));
+
+    y += fontMetrics().height() + margin;
+  }
+
+  if (rows_.isEmpty()) {
+    p.drawText(QRect(0, y, width(), height() - y), Qt::AlignCenter,
+               tr("No data. Play or render something to profile it."));
+    return;
+  }
+
+  // Rank by cumulative time, most expensive first
+  QVector<const Row*> sorted;
+  sorted.reserve(rows_.size());
+  for (auto it=rows_.constBegin(); it!=rows_.constEnd(); it++) {
+    sorted.append(&it.value());
+  }
+  std::sort(sorted.begin(), sorted.end(), [](const Row *a, const Row *b){
+    return a->total_ns > b->total_ns;
+  });
+
+  int sparkline_width = width() / 3;
+
+  foreach (const Row *row, sorted) {
+    if (y >= height()) {
+      break;
+    }
+
+    QRect text_rect(margin, y, width() - sparkline_width - margin * 3, row_height);
+
+    p.setPen(palette().text().color());
+    p.drawText(text_rect, Qt::AlignLeft | Qt::AlignTop, row->label);
+
+    double total_ms = double(row->total_ns) * 0.000001;
+    double avg_ms = row->calls > 0 ? total_ms / double(row->calls) : 0.0;
+    p.drawText(text_rect, Qt::AlignLeft | Qt::AlignBottom,
+               tr("%1 ms total, %2 calls, %3 ms avg")
+               .arg(QString::number(total_ms, 'f', 1),
+                    QString::number(row->calls),
+                    QString::number(avg_ms, 'f', 2)));
+
+    // Sparkline of time spent per polling interval, scaled to its own maximum
+    if (!row->history.isEmpty()) {
+      QRect spark_rect(width() - sparkline_width - margin, y, sparkline_width, row_height - margin);
+
+      float max = 0.0f;
+      foreach (float f, row->history) {
+        max = qMax(max, f);
+      }
+
+      if (max > 0.0f) {
+        QPolygonF line;
+        line.reserve(row->history.size());
+
+        for (int i=0; i<row->history.size(); i++) {
+          double x = spark_rect.left() + double(i) / double(kHistoryLength - 1) * spark_rect.width();
+          double v = spark_rect.bottom() - double(row->history.at(i)) / double(max) * spark_rect.height();
+          line.append(QPointF(x, v));
+        }
+
+        p.setPen(palette().highlight().color());
+        p.drawPolyline(line);
+      }
+    }
+
+    y += row_height + margin;
+  }
+}
+
+void NodeProfilerWidget::showEvent(QShowEvent *event)
+{
+  QWidget::showEvent(event);
+
+  refresh_timer_.start();
+}
+
+void NodeProfilerWidget::hideEvent(QHideEvent *event)
+{
+  QWidget::hideEvent(event);
+
+  refresh_timer_.stop();
+}
+
+void NodeProfilerWidget::Refresh()
+{
+  if (MainThreadQueue::instance()) {
+    queue_stats_ = MainThreadQueue::instance()->GetLatencyStats();
+  }
+
+  interaction_stats_ = InteractionTracker::instance()->GetStats();
+
+  QHash<const Node*, NodeProfiler::Stats> stats = NodeProfiler::instance()->GetStats();
+
+  // Drop rows for nodes that have disappeared from the profiler (deleted or cleared)
+  for (auto it=rows_.begin(); it!=rows_.end(); ) {
+    if (!stats.contains(it.key())) {
+      it = rows_.erase(it);
+    } else {
+      it++;
+    }
+  }
+
+  for (auto it=stats.constBegin(); it!=stats.constEnd(); it++) {
+    const NodeProfiler::Stats &s = it.value();
+
+    qint64 total = 0;
+    for (int i=0; i<NodeProfiler::kCategoryCount; i++) {
+      total += s.time_ns[i];
+    }
+
+    Row &row = rows_[it.key()];
+
+    // Sparkline shows the delta since the last poll, not the cumulative total
+    row.history.append(float(total - row.total_ns));
+    while (row.history.size() > kHistoryLength) {
+      row.history.removeFirst();
+    }
+
+    row.label = s.label;
+    row.total_ns = total;
+    row.calls = s.calls;
+  }
+
+  update();
+}
+
+}
@@ -0,0 +1,80 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef NODEPROFILERWIDGET_H
+#define NODEPROFILERWIDGET_H
+
+#include <QTimer>
+#include <QWidget>
+
+#include "common/interactiontracker.h"
+#include "common/mainthreadqueue.h"
+#include "render/nodeprofiler.h"
+
+namespace olive {
+
+/**
+ * @brief Ranks nodes by render cost with a short sparkline history per node
+ *
+ * Also displays the main-thread job queue's latency stats (see MainThreadQueue) so UI
+ * responsiveness can be checked in the same place.
+ *
+ * Polls NodeProfiler on a timer and diffs each snapshot against the previous one, so the
+ * sparkline shows how much time each node consumed per polling interval rather than the
+ * cumulative total.
+ */
+class NodeProfilerWidget : public QWidget
+{
+  Q_OBJECT
+public:
+  NodeProfilerWidget(QWidget *parent = nullptr);
+
+protected:
+  virtual void paintEvent(QPaintEvent *event) override;
+
+  virtual void showEvent(QShowEvent *event) override;
+  virtual void hideEvent(QHideEvent *event) override;
+
+private:
+  struct Row {
+    QString label;
+    qint64 total_ns;
+    qint64 calls;
+    QVector<float> history;
+  };
+
+  static const int kHistoryLength = 64;
+
+  QHash<const Node*, Row> rows_;
+
+  MainThreadQueue::LatencyStats queue_stats_;
+
+  QMap<QString, InteractionTracker::Stats> interaction_stats_;
+
+  QTimer refresh_timer_;
+
+private slots:
+  void Refresh();
+
+};
+
+}
+
+#endif // NODEPROFILERWIDGET_H
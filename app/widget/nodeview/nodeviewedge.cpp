@@ -156,7 +156,13 @@ void NodeViewEdge::paint(QPainter *painter, const QStyleOptionGraphicsItem *opti
 
   painter->setPen(QPen(edge_color, edge_width_));
   painter->setBrush(Qt::NoBrush);
-  painter->drawPath(path());
+
+  if (curved_ && option->levelOfDetailFromTransform(painter->worldTransform()) < 0.4) {
+    // A bezier reads as a straight line at this zoom, so skip stroking the curve
+    painter->drawLine(mapFromScene(cached_start_), mapFromScene(cached_end_));
+  } else {
+    painter->drawPath(path());
+  }
 }
 
 void NodeViewEdge::Init()
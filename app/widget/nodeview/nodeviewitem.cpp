@@ -60,6 +60,10 @@ NodeViewItem::NodeViewItem(Node *node, const QString &input, int element, Node *
   // Set rect size to default
   SetRectSize();
 
+  // Cache the item's render at device resolution so panning doesn't re-run the text/palette
+  // painting for every visible node; zooming or any update() re-renders as usual
+  setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+
   // Create connector
   input_connector_ = new NodeViewItemConnector(false, this);
   output_connector_ = new NodeViewItemConnector(true, this);
@@ -358,53 +362,57 @@ void NodeViewItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *opti
     painter->drawRect(rect());
   }
 
-  // Determine what text to draw and whether to draw an arrow
-  QString node_label, node_name;
+  // At low zoom, text and the expand arrow are illegible anyway, so leave nodes as colored
+  // blocks - this is what keeps panning around huge graphs zoomed out cheap
+  if (option->levelOfDetailFromTransform(painter->worldTransform()) >= 0.4) {
+    // Determine what text to draw and whether to draw an arrow
+    QString node_label, node_name;
 
-  if (IsOutputItem()) {
-    if (label_as_output_) {
-      node_name = QCoreApplication::translate("NodeViewItem", "Output");
-    } else {
-      node_label = node_->GetLabel();
-      node_name = node_->ShortName();
-    }
-  } else {
-    if (element_ == -1) {
-      node_name = node_->GetInputName(input_);
+    if (IsOutputItem()) {
+      if (label_as_output_) {
+        node_name = QCoreApplication::translate("NodeViewItem", "Output");
+      } else {
+        node_label = node_->GetLabel();
+        node_name = node_->ShortName();
+      }
     } else {
-      node_name = QString::number(element_ + node_->GetInputProperty(input_, QStringLiteral("arraystart")).toInt());
+      if (element_ == -1) {
+        node_name = node_->GetInputName(input_);
+      } else {
+        node_name = QString::number(element_ + node_->GetInputProperty(input_, QStringLiteral("arraystart")).toInt());
+      }
     }
-  }
 
-  // Draw arrow if necessary
-  int arrow_size = CanBeExpanded() ? DrawExpandArrow(painter) : 0;
+    // Draw arrow if necessary
+    int arrow_size = CanBeExpanded() ? DrawExpandArrow(painter) : 0;
 
-  if (IsOutputItem()) {
-    // Determine the text color (automatically calculate from node background color)
-    painter->setPen(ColorCoding::GetUISelectorColor(node_->color()));
-  } else {
-    // Just use text item
-    painter->setPen(app_pal.text().color());
-  }
+    if (IsOutputItem()) {
+      // Determine the text color (automatically calculate from node background color)
+      painter->setPen(ColorCoding::GetUISelectorColor(node_->color()));
+    } else {
+      // Just use text item
+      painter->setPen(app_pal.text().color());
+    }
 
-  if (node_label.isEmpty()) {
-    // Draw name only
-    DrawNodeTitle(painter, node_name, single_unit_rect, Qt::AlignVCenter, arrow_size);
-  } else {
-    int text_pad = DefaultTextPadding()/2;
-    QRectF safe_label_bounds = single_unit_rect.adjusted(text_pad, text_pad, -text_pad, -text_pad);
-    QFont f;
-    qreal font_sz = f.pointSizeF();
-
-    // Draw label as larger/upper text
-    f.setPointSizeF(font_sz * 0.8);
-    painter->setFont(f);
-    DrawNodeTitle(painter, node_label, safe_label_bounds, Qt::AlignTop, arrow_size);
-
-    // Draw node name as smaller/lower text
-    f.setPointSizeF(font_sz * 0.6);
-    painter->setFont(f);
-    DrawNodeTitle(painter, node_name, safe_label_bounds, Qt::AlignBottom, arrow_size);
+    if (node_label.isEmpty()) {
+      // Draw name only
+      DrawNodeTitle(painter, node_name, single_unit_rect, Qt::AlignVCenter, arrow_size);
+    } else {
+      int text_pad = DefaultTextPadding()/2;
+      QRectF safe_label_bounds = single_unit_rect.adjusted(text_pad, text_pad, -text_pad, -text_pad);
+      QFont f;
+      qreal font_sz = f.pointSizeF();
+
+      // Draw label as larger/upper text
+      f.setPointSizeF(font_sz * 0.8);
+      painter->setFont(f);
+      DrawNodeTitle(painter, node_label, safe_label_bounds, Qt::AlignTop, arrow_size);
+
+      // Draw node name as smaller/lower text
+      f.setPointSizeF(font_sz * 0.6);
+      painter->setFont(f);
+      DrawNodeTitle(painter, node_name, safe_label_bounds, Qt::AlignBottom, arrow_size);
+    }
   }
 
   // Draw final border (output only)
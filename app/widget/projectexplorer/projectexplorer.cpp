@@ -35,6 +35,7 @@
 #include "dialog/sequence/sequence.h"
 #include "projectexplorerundo.h"
 #include "task/precache/precachetask.h"
+#include "task/proxy/proxytask.h"
 #include "task/taskmanager.h"
 #include "widget/menu/menu.h"
 #include "widget/menu/menushared.h"
@@ -399,6 +400,17 @@ void ProjectExplorer::ShowContextMenu()
 
         connect(proxy_menu, &Menu::triggered, this, &ProjectExplorer::ContextMenuStartProxy);
       }
+
+      Menu* generate_proxy_menu = new Menu(tr("Proxy"), &menu);
+      menu.addMenu(generate_proxy_menu);
+
+      QAction* half_proxy_action = generate_proxy_menu->addAction(tr("Create Half Resolution Proxy"));
+      half_proxy_action->setData(2);
+
+      QAction* quarter_proxy_action = generate_proxy_menu->addAction(tr("Create Quarter Resolution Proxy"));
+      quarter_proxy_action->setData(4);
+
+      connect(generate_proxy_menu, &Menu::triggered, this, &ProjectExplorer::ContextMenuGenerateProxy);
     }
 
     Q_UNUSED(all_items_are_footage_or_sequence)
@@ -523,6 +535,41 @@ void ProjectExplorer::ContextMenuStartProxy(QAction *a)
   }
 }
 
+void ProjectExplorer::ContextMenuGenerateProxy(QAction *a)
+{
+  int divider = a->data().toInt();
+
+  // To get here, the `context_menu_items_` must be all kFootage
+  foreach (Node* item, context_menu_items_) {
+    Footage* f = static_cast<Footage*>(item);
+
+    int sz = f->InputArraySize(Footage::kVideoParamsInput);
+
+    for (int j=0; j<sz; j++) {
+      VideoParams vp = f->GetVideoParams(j);
+
+      if (vp.enabled() && vp.video_type() == VideoParams::kVideoTypeVideo) {
+        // Start a background task to generate the proxy, attaching it when the task succeeds
+        ProxyTask* proxy_task = new ProxyTask(f, j, divider);
+        connect(proxy_task, &Task::Finished, this, &ProjectExplorer::ProxyTaskFinished);
+        TaskManager::instance()->AddTask(proxy_task);
+
+        // Only one proxy is attached per footage, so generate it from the first enabled stream
+        break;
+      }
+    }
+  }
+}
+
+void ProjectExplorer::ProxyTaskFinished(Task *task, bool succeeded)
+{
+  ProxyTask* proxy_task = static_cast<ProxyTask*>(task);
+
+  if (succeeded && proxy_task->footage()) {
+    proxy_task->footage()->set_proxy(proxy_task->proxy_filename(), proxy_task->divider());
+  }
+}
+
 void ProjectExplorer::ViewSelectionChanged()
 {
   QItemSelectionModel *model = static_cast<QItemSelectionModel *>(sender());
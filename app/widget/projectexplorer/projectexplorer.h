@@ -36,6 +36,8 @@
 
 namespace olive {
 
+class Task;
+
 /**
  * @brief A widget for browsing through a Project structure.
  *
@@ -189,6 +191,10 @@ private slots:
 
   void ContextMenuStartProxy(QAction* a);
 
+  void ContextMenuGenerateProxy(QAction* a);
+
+  void ProxyTaskFinished(Task* task, bool succeeded);
+
   void ViewSelectionChanged();
 
 };
@@ -20,14 +20,124 @@
 
 #include "projectexplorericonview.h"
 
+#include <QAbstractProxyModel>
+#include <QMouseEvent>
+
 namespace olive {
 
 ProjectExplorerIconView::ProjectExplorerIconView(QWidget *parent) :
-  ProjectExplorerListViewBase(parent)
+  ProjectExplorerListViewBase(parent),
+  hover_viewer_(nullptr)
 {
   setViewMode(QListView::IconMode);
 
   setItemDelegate(&delegate_);
+
+  // Required to receive move events for hover-scrubbing without a button held
+  setMouseTracking(true);
+}
+
+void ProjectExplorerIconView::mouseMoveEvent(QMouseEvent *event)
+{
+  ProjectExplorerListViewBase::mouseMoveEvent(event);
+
+  QModelIndex index = indexAt(event->pos());
+  ViewerOutput *viewer = GetViewerFromIndex(index);
+
+  if (!viewer || !viewer->HasEnabledVideoStreams() || viewer->GetVideoLength().isNull()) {
+    ClearHover();
+    return;
+  }
+
+  // Map the cursor's horizontal position across the item to a time in the media
+  QRect r = visualRect(index);
+  double fraction = qBound(0.0, double(event->pos().x() - r.left()) / double(qMax(1, r.width())), 1.0);
+
+  ThumbnailCache *thumbs = viewer->thumbnail_cache();
+  rational time = Timecode::snap_time_to_timebase(rational::fromDouble(viewer->GetVideoLength().toDouble() * fraction),
+                                                  thumbs->GetTimebase(),
+                                                  Timecode::kFloor);
+
+  if (viewer != hover_viewer_) {
+    if (hover_viewer_) {
+      disconnect(hover_viewer_->thumbnail_cache(), &PlaybackCache::Validated, this, &ProjectExplorerIconView::HoverThumbnailValidated);
+    }
+
+    hover_viewer_ = viewer;
+
+    // Repaint as soon as a background fill-in finishes rendering
+    connect(thumbs, &PlaybackCache::Validated, this, &ProjectExplorerIconView::HoverThumbnailValidated);
+  }
+
+  QPersistentModelIndex old_index = hover_index_;
+  hover_index_ = index;
+  hover_time_ = time;
+
+  QString filename = thumbs->GetValidCacheFilename(time);
+
+  if (filename.isEmpty()) {
+    // This step isn't cached yet - queue a background render. Until it lands we keep showing
+    // whatever frame we had, the hover itself never waits on a ticket.
+    thumbs->Request(viewer, TimeRange(time, time + thumbs->GetTimebase()));
+  }
+
+  if (!filename.isEmpty() || old_index != index) {
+    delegate_.SetHoverThumbnail(index, filename);
+
+    if (old_index.isValid() && old_index != index) {
+      update(old_index);
+    }
+    update(index);
+  }
+}
+
+void ProjectExplorerIconView::leaveEvent(QEvent *event)
+{
+  ProjectExplorerListViewBase::leaveEvent(event);
+
+  ClearHover();
+}
+
+ViewerOutput *ProjectExplorerIconView::GetViewerFromIndex(const QModelIndex &index) const
+{
+  if (!index.isValid()) {
+    return nullptr;
+  }
+
+  // The explorer puts a sort/filter proxy between the views and the project model
+  QModelIndex source = index;
+  if (const QAbstractProxyModel *proxy = qobject_cast<const QAbstractProxyModel*>(index.model())) {
+    source = proxy->mapToSource(index);
+  }
+
+  return dynamic_cast<ViewerOutput*>(static_cast<Node*>(source.internalPointer()));
+}
+
+void ProjectExplorerIconView::ClearHover()
+{
+  if (hover_viewer_) {
+    disconnect(hover_viewer_->thumbnail_cache(), &PlaybackCache::Validated, this, &ProjectExplorerIconView::HoverThumbnailValidated);
+    hover_viewer_ = nullptr;
+  }
+
+  if (hover_index_.isValid()) {
+    QModelIndex old = hover_index_;
+    hover_index_ = QPersistentModelIndex();
+    delegate_.SetHoverThumbnail(QModelIndex(), QString());
+    update(old);
+  }
+}
+
+void ProjectExplorerIconView::HoverThumbnailValidated(const TimeRange &range)
+{
+  if (hover_viewer_ && hover_index_.isValid() && range.Contains(hover_time_)) {
+    QString filename = hover_viewer_->thumbnail_cache()->GetValidCacheFilename(hover_time_);
+
+    if (!filename.isEmpty()) {
+      delegate_.SetHoverThumbnail(hover_index_, filename);
+      update(hover_index_);
+    }
+  }
 }
 
 }
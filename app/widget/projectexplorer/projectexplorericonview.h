@@ -21,6 +21,9 @@
 #ifndef PROJECTEXPLORERICONVIEW_H
 #define PROJECTEXPLORERICONVIEW_H
 
+#include <QPersistentModelIndex>
+
+#include "node/output/viewer/viewer.h"
 #include "projectexplorerlistviewbase.h"
 #include "projectexplorericonviewitemdelegate.h"
 
@@ -28,6 +31,10 @@ namespace olive {
 
 /**
  * @brief The view widget used when ProjectExplorer is in Icon View
+ *
+ * Also provides hover-scrubbing: moving the mouse across a footage or sequence icon previews
+ * the frame at the proportional time straight from its ThumbnailCache, with steps that aren't
+ * cached yet filled in by background renders - the hover itself never waits on a ticket.
  */
 class ProjectExplorerIconView : public ProjectExplorerListViewBase
 {
@@ -35,8 +42,30 @@ class ProjectExplorerIconView : public ProjectExplorerListViewBase
 public:
   ProjectExplorerIconView(QWidget* parent);
 
+protected:
+  virtual void mouseMoveEvent(QMouseEvent *event) override;
+
+  virtual void leaveEvent(QEvent *event) override;
+
 private:
+  /**
+   * @brief Resolve the (possibly proxied) index to a scrubbable ViewerOutput, if it is one
+   */
+  ViewerOutput *GetViewerFromIndex(const QModelIndex &index) const;
+
+  void ClearHover();
+
   ProjectExplorerIconViewItemDelegate delegate_;
+
+  QPersistentModelIndex hover_index_;
+
+  ViewerOutput *hover_viewer_;
+
+  rational hover_time_;
+
+private slots:
+  void HoverThumbnailValidated(const TimeRange &range);
+
 };
 
 }
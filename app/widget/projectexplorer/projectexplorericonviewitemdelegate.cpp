@@ -81,14 +81,24 @@ void ProjectExplorerIconViewItemDelegate::paint(QPainter *painter, const QStyleO
 
   }
 
-  // Draw image
-  QIcon ico = index.data(Qt::DecorationRole).value<QIcon>();
-  QSize icon_size = ico.actualSize(img_rect.size());
-  img_rect = QRect(img_rect.x() + (img_rect.width() / 2 - icon_size.width() / 2),
-                   img_rect.y() + (img_rect.height() / 2 - icon_size.height() / 2),
-                   icon_size.width(),
-                   icon_size.height());
-  painter->drawPixmap(img_rect, ico.pixmap(icon_size));
+  // Draw image - a hover-scrub preview frame if one is set for this item, the icon otherwise
+  if (index == hover_index_ && !hover_image_.isNull()) {
+    QSize scaled = hover_image_.size().scaled(img_rect.size(), Qt::KeepAspectRatio);
+    img_rect = QRect(img_rect.x() + (img_rect.width() - scaled.width()) / 2,
+                     img_rect.y() + (img_rect.height() - scaled.height()) / 2,
+                     scaled.width(),
+                     scaled.height());
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+    painter->drawImage(img_rect, hover_image_);
+  } else {
+    QIcon ico = index.data(Qt::DecorationRole).value<QIcon>();
+    QSize icon_size = ico.actualSize(img_rect.size());
+    img_rect = QRect(img_rect.x() + (img_rect.width() / 2 - icon_size.width() / 2),
+                     img_rect.y() + (img_rect.height() / 2 - icon_size.height() / 2),
+                     icon_size.width(),
+                     icon_size.height());
+    painter->drawPixmap(img_rect, ico.pixmap(icon_size));
+  }
 
   if (option.state & QStyle::State_Selected) {
     QColor highlight_color = option.palette.highlight().color();
@@ -99,4 +109,18 @@ void ProjectExplorerIconViewItemDelegate::paint(QPainter *painter, const QStyleO
   }
 }
 
+void ProjectExplorerIconViewItemDelegate::SetHoverThumbnail(const QModelIndex &index, const QString &filename)
+{
+  hover_index_ = index;
+
+  if (filename != hover_filename_) {
+    hover_filename_ = filename;
+    hover_image_ = QImage();
+
+    if (!filename.isEmpty()) {
+      hover_image_.load(filename, "jpg");
+    }
+  }
+}
+
 }
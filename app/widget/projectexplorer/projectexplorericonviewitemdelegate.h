@@ -21,6 +21,8 @@
 #ifndef PROJECTEXPLORERICONVIEWITEMDELEGATE_H
 #define PROJECTEXPLORERICONVIEWITEMDELEGATE_H
 
+#include <QImage>
+#include <QPersistentModelIndex>
 #include <QStyledItemDelegate>
 
 #include "common/define.h"
@@ -36,6 +38,21 @@ public:
 
   virtual QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
   virtual void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+  /**
+   * @brief Set the hover-scrub preview to paint over an item's icon
+   *
+   * `filename` is a cached thumbnail file (see ProjectExplorerIconView); it's only re-read when
+   * it changes, not per paint. An empty filename keeps the item on its regular icon.
+   */
+  void SetHoverThumbnail(const QModelIndex &index, const QString &filename);
+
+private:
+  QPersistentModelIndex hover_index_;
+
+  QString hover_filename_;
+
+  QImage hover_image_;
 };
 
 }
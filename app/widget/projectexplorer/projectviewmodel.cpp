@@ -32,7 +32,8 @@ namespace olive {
 
 ProjectViewModel::ProjectViewModel(QObject *parent) :
   QAbstractItemModel(parent),
-  project_(nullptr)
+  project_(nullptr),
+  batch_active_(false)
 {
 }
 
@@ -47,12 +48,16 @@ void ProjectViewModel::set_project(Project *p)
 
   if (project_) {
     DisconnectItem(project_->root());
+    disconnect(project_, &Project::BatchOperationStarted, this, &ProjectViewModel::ProjectBatchStarted);
+    disconnect(project_, &Project::BatchOperationEnded, this, &ProjectViewModel::ProjectBatchEnded);
   }
 
   project_ = p;
 
   if (project_) {
     ConnectItem(project_->root());
+    connect(project_, &Project::BatchOperationStarted, this, &ProjectViewModel::ProjectBatchStarted);
+    connect(project_, &Project::BatchOperationEnded, this, &ProjectViewModel::ProjectBatchEnded);
   }
 
   endResetModel();
@@ -493,6 +498,11 @@ void ProjectViewModel::FolderBeginInsertItem(Node *n, int insert_index)
 
   ConnectItem(n);
 
+  if (batch_active_) {
+    // A reset is in progress, individual row signals would be meaningless to views right now
+    return;
+  }
+
   QModelIndex index;
 
   if (folder != project_->root()) {
@@ -504,6 +514,10 @@ void ProjectViewModel::FolderBeginInsertItem(Node *n, int insert_index)
 
 void ProjectViewModel::FolderEndInsertItem()
 {
+  if (batch_active_) {
+    return;
+  }
+
   endInsertRows();
 }
 
@@ -513,6 +527,11 @@ void ProjectViewModel::FolderBeginRemoveItem(Node *n, int child_index)
 
   DisconnectItem(n);
 
+  if (batch_active_) {
+    // A reset is in progress, individual row signals would be meaningless to views right now
+    return;
+  }
+
   QModelIndex index;
 
   if (folder != project_->root()) {
@@ -524,11 +543,19 @@ void ProjectViewModel::FolderBeginRemoveItem(Node *n, int child_index)
 
 void ProjectViewModel::FolderEndRemoveItem()
 {
+  if (batch_active_) {
+    return;
+  }
+
   endRemoveRows();
 }
 
 void ProjectViewModel::ItemRenamed()
 {
+  if (batch_active_) {
+    return;
+  }
+
   Node* item = static_cast<Node*>(sender());
 
   QModelIndex index = CreateIndexFromItem(item);
@@ -536,6 +563,20 @@ void ProjectViewModel::ItemRenamed()
   emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
 }
 
+void ProjectViewModel::ProjectBatchStarted()
+{
+  // Views and sort proxies sit the whole batch out between these reset signals instead of
+  // re-sorting and repainting once per inserted item
+  beginResetModel();
+  batch_active_ = true;
+}
+
+void ProjectViewModel::ProjectBatchEnded()
+{
+  batch_active_ = false;
+  endResetModel();
+}
+
 QModelIndex ProjectViewModel::CreateIndexFromItem(Node *item, int column)
 {
   return createIndex(IndexOfChild(item), column, item);
@@ -148,6 +148,14 @@ private:
 
   Project* project_;
 
+  /**
+   * @brief Whether a project batch operation (and therefore a model reset) is in progress
+   *
+   * While true, per-item row signals are suppressed - views are told the model is resetting and
+   * repopulate once when the batch ends. See ProjectBatchStarted().
+   */
+  bool batch_active_;
+
 private slots:
   void FolderBeginInsertItem(Node *n, int insert_index);
 
@@ -159,6 +167,17 @@ private slots:
 
   void ItemRenamed();
 
+  /**
+   * @brief Bracket a bulk project change (e.g. importing thousands of files) in a model reset
+   *
+   * Emitting one reset instead of thousands of row insertions means attached views and sort
+   * proxies rebuild and sort once at the end, and only resolve data (including icons) for rows
+   * that actually become visible.
+   */
+  void ProjectBatchStarted();
+
+  void ProjectBatchEnded();
+
 };
 
 }
@@ -69,16 +69,45 @@ void ScopeBase::OnPaint()
 
   if (texture_) {
     // Convert reference frame to display space
-    if (!managed_tex_ || !managed_tex_up_to_date_
-        || managed_tex_->params() != texture_->params()) {
-      managed_tex_ = renderer()->CreateTexture(texture_->params());
+    if (!managed_tex_ || !managed_tex_up_to_date_) {
+      // Reduce the frame to a bounded size on the GPU before anything else touches it. The
+      // scope shaders sample their source once per covered fragment per row/column, so this
+      // makes a refresh cost track the scope's own resolution instead of the frame's, and only
+      // the reduced texture runs through the color transform. Our GL 3.2 baseline has no
+      // compute/atomic reductions, so a scaled blit is the reduction available everywhere.
+      TexturePtr scope_source = texture_;
+
+      if (texture_->width() > kMaxScopeSourceSize || texture_->height() > kMaxScopeSourceSize) {
+        double scale = double(kMaxScopeSourceSize) / double(qMax(texture_->width(), texture_->height()));
+        VideoParams reduced_params(qMax(1, int(texture_->width() * scale)),
+                                   qMax(1, int(texture_->height() * scale)),
+                                   texture_->format(),
+                                   texture_->channel_count());
+
+        if (!reduced_tex_ || reduced_tex_->params() != reduced_params) {
+          reduced_tex_ = renderer()->CreateTexture(reduced_params);
+        }
+
+        ShaderJob reduce_job;
+        reduce_job.Insert(QStringLiteral("ove_maintex"), NodeValue(NodeValue::kTexture, QVariant::fromValue(texture_)));
+        renderer()->BlitToTexture(renderer()->GetDefaultShader(), reduce_job, reduced_tex_.get());
+
+        scope_source = reduced_tex_;
+      }
+
+      if (!managed_tex_ || managed_tex_->params() != scope_source->params()) {
+        managed_tex_ = renderer()->CreateTexture(scope_source->params());
+      }
 
       ColorTransformJob job;
       job.SetColorProcessor(color_service());
-      job.SetInputTexture(texture_);
+      job.SetInputTexture(scope_source);
       job.SetInputAlphaAssociation(kAlphaNone);
 
       renderer()->BlitColorManaged(job, managed_tex_.get());
+
+      // Repaints without a new frame (window exposes, overlay updates) reuse the result
+      managed_tex_up_to_date_ = true;
     }
 
     DrawScope(managed_tex_, pipeline_);
@@ -88,6 +117,7 @@ void ScopeBase::OnPaint()
 void ScopeBase::OnDestroy()
 {
   managed_tex_ = nullptr;
+  reduced_tex_ = nullptr;
   texture_ = nullptr;
   pipeline_.clear();
 
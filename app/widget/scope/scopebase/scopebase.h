@@ -57,10 +57,17 @@ protected:
   virtual void DrawScope(TexturePtr managed_tex, QVariant pipeline);
 
 private:
+  /**
+   * @brief Largest dimension a scope will analyze - larger frames are GPU-downscaled first
+   */
+  static const int kMaxScopeSourceSize = 512;
+
   QVariant pipeline_;
 
   TexturePtr texture_;
 
+  TexturePtr reduced_tex_;
+
   TexturePtr managed_tex_;
 
   bool managed_tex_up_to_date_;
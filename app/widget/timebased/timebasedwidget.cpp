@@ -28,6 +28,7 @@
 #include "core.h"
 #include "dialog/markerproperties/markerpropertiesdialog.h"
 #include "node/project/sequence/sequence.h"
+#include "render/rendermanager.h"
 #include "timeline/timelineundoworkarea.h"
 #include "widget/timeruler/timeruler.h"
 
@@ -36,6 +37,7 @@ namespace olive {
 TimeBasedWidget::TimeBasedWidget(bool ruler_text_visible, bool ruler_cache_status_visible, QWidget *parent) :
   TimelineScaledWidget(parent),
   viewer_node_(nullptr),
+  cacher_visibility_registered_(false),
   auto_max_scrollbar_(false),
   toggle_show_all_(false),
   auto_set_timebase_(true),
@@ -57,6 +59,14 @@ TimeBasedWidget::TimeBasedWidget(bool ruler_text_visible, bool ruler_cache_statu
   connect(catchup_scroll_timer_, &QTimer::timeout, this, &TimeBasedWidget::CatchUpTimerTimeout);
 }
 
+TimeBasedWidget::~TimeBasedWidget()
+{
+  // Widgets aren't guaranteed a hide event before destruction
+  if (cacher_visibility_registered_) {
+    SetCacherContextVisibility(viewer_node_, false);
+  }
+}
+
 void TimeBasedWidget::SetScaleAndCenterOnPlayhead(const double &scale)
 {
   SetScale(scale);
@@ -83,6 +93,11 @@ void TimeBasedWidget::ConnectViewerNode(ViewerOutput *node)
   viewer_node_ = node;
 
   if (old) {
+    // This sequence no longer has a widget here for it to be seen in
+    if (cacher_visibility_registered_) {
+      SetCacherContextVisibility(old, false);
+    }
+
     // Call potential derivative functions for disconnecting the viewer node
     DisconnectNodeEvent(old);
 
@@ -128,6 +143,10 @@ void TimeBasedWidget::ConnectViewerNode(ViewerOutput *node)
 
     // Call derivatives
     ConnectNodeEvent(viewer_node_);
+
+    if (isVisible()) {
+      SetCacherContextVisibility(viewer_node_, true);
+    }
   }
 
   UpdateMaximumScroll();
@@ -313,6 +332,34 @@ void TimeBasedWidget::resizeEvent(QResizeEvent *event)
   UpdateMaximumScroll();
 }
 
+void TimeBasedWidget::showEvent(QShowEvent *event)
+{
+  QWidget::showEvent(event);
+
+  if (viewer_node_ && !cacher_visibility_registered_) {
+    SetCacherContextVisibility(viewer_node_, true);
+  }
+}
+
+void TimeBasedWidget::hideEvent(QHideEvent *event)
+{
+  QWidget::hideEvent(event);
+
+  if (cacher_visibility_registered_) {
+    SetCacherContextVisibility(viewer_node_, false);
+  }
+}
+
+void TimeBasedWidget::SetCacherContextVisibility(ViewerOutput *context, bool visible)
+{
+  // The render manager may already be gone during application shutdown
+  if (RenderManager::instance()) {
+    RenderManager::instance()->GetCacher()->SetContextVisibility(context, visible);
+  }
+
+  cacher_visibility_registered_ = visible;
+}
+
 void TimeBasedWidget::ConnectTimelineView(TimeBasedView *base)
 {
   // Connect scale
@@ -771,6 +818,28 @@ void AttemptSnap(std::vector<SnapData> &snap_data,
   }
 }
 
+void AttemptSnapSorted(std::vector<SnapData> &snap_data,
+                       const TimeBasedWidget *widget,
+                       const std::vector<double>& screen_pt,
+                       const std::vector<rational>& sorted_times,
+                       const std::vector<rational>& start_times)
+{
+  const qreal kSnapRange = 10; // FIXME: Hardcoded number
+
+  for (size_t i=0;i<screen_pt.size();i++) {
+    // Convert the screen-space snap range to a time range and binary search for candidates
+    // within it - equivalent to InRange() on screen coordinates since TimeToScene is linear
+    rational min_time = widget->SceneToTimeNoGrid(screen_pt.at(i) - kSnapRange);
+    rational max_time = widget->SceneToTimeNoGrid(screen_pt.at(i) + kSnapRange);
+
+    for (auto it=std::lower_bound(sorted_times.cbegin(), sorted_times.cend(), min_time);
+         it!=sorted_times.cend() && *it <= max_time;
+         it++) {
+      snap_data.push_back({*it, *it - start_times.at(i)});
+    }
+  }
+}
+
 bool TimeBasedWidget::SnapPoint(const std::vector<rational> &start_times, rational *movement, SnapMask snap_points)
 {
   std::vector<double> screen_pt(start_times.size());
@@ -787,7 +856,15 @@ bool TimeBasedWidget::SnapPoint(const std::vector<rational> &start_times, ration
     AttemptSnap(potential_snaps, screen_pt, playhead_pos, start_times, playhead_abs_time);
   }
 
-  if ((snap_points & kSnapToClips) && GetSnapBlocks()) {
+  if ((snap_points & kSnapToClips) && GetSnapTimeIndex()) {
+    const SnapTimeIndex *index = GetSnapTimeIndex();
+
+    AttemptSnapSorted(potential_snaps, this, screen_pt, index->block_times, start_times);
+
+    if (snap_points & kSnapToMarkers) {
+      AttemptSnapSorted(potential_snaps, this, screen_pt, index->marker_times, start_times);
+    }
+  } else if ((snap_points & kSnapToClips) && GetSnapBlocks()) {
     for (auto it=GetSnapBlocks()->cbegin(); it!=GetSnapBlocks()->cend(); it++) {
       Block *b = *it;
 
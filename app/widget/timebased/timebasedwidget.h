@@ -41,6 +41,8 @@ class TimeBasedWidget : public TimelineScaledWidget
 public:
   TimeBasedWidget(bool ruler_text_visible = true, bool ruler_cache_status_visible = false, QWidget* parent = nullptr);
 
+  virtual ~TimeBasedWidget() override;
+
   void ZoomIn();
 
   void ZoomOut();
@@ -138,12 +140,32 @@ protected:
 
   virtual void resizeEvent(QResizeEvent *event) override;
 
+  virtual void showEvent(QShowEvent *event) override;
+
+  virtual void hideEvent(QHideEvent *event) override;
+
   void ConnectTimelineView(TimeBasedView* base);
 
   void SetCatchUpScrollValue(QScrollBar *b, int v, int maximum);
   void StopCatchUpScrollTimer(QScrollBar *b);
 
+  /**
+   * @brief Sorted candidate times for snapping, queried by binary search
+   *
+   * Subclasses that track many blocks can provide this in place of per-call block scanning:
+   * when SnapPoint() finds an index here, it binary searches the sorted times instead of
+   * iterating GetSnapBlocks(), keeping drags responsive on very long timelines.
+   */
+  struct SnapTimeIndex {
+    /// Block in/out boundaries, sorted ascending
+    std::vector<rational> block_times;
+
+    /// Clip marker in/outs adjusted to sequence time, sorted ascending
+    std::vector<rational> marker_times;
+  };
+
   virtual const QVector<Block*> *GetSnapBlocks() const { return nullptr; }
+  virtual const SnapTimeIndex *GetSnapTimeIndex() const { return nullptr; }
   virtual const QVector<KeyframeViewInputConnection*> *GetSnapKeyframes() const { return nullptr; }
   virtual const TimeTargetObject *GetKeyframeTimeTarget() const { return nullptr; }
   virtual const std::vector<NodeKeyframe*> *GetSnapIgnoreKeyframes() const { return nullptr; }
@@ -203,8 +225,18 @@ private:
 
   bool UserIsDraggingPlayhead() const;
 
+  /**
+   * @brief Report to the autocacher whether `context` has a visible widget here
+   *
+   * Lets background work (autocache, thumbnails, waveforms) for sequences hidden behind tabs
+   * be deprioritized in favor of the sequence being edited.
+   */
+  void SetCacherContextVisibility(ViewerOutput *context, bool visible);
+
   ViewerOutput* viewer_node_;
 
+  bool cacher_visibility_registered_;
+
   TimeRuler* ruler_;
 
   ResizableTimelineScrollBar* scrollbar_;
@@ -20,18 +20,21 @@
 
 #include "timelinewidget.h"
 
+#include <algorithm>
 #include <cfloat>
 #include <QSplitter>
 #include <QVBoxLayout>
 #include <QtMath>
 
 #include "core.h"
+#include "common/interactiontracker.h"
 #include "common/range.h"
 #include "dialog/sequence/sequence.h"
 #include "dialog/speedduration/speeddurationdialog.h"
 #include "node/block/transition/transition.h"
 #include "node/nodeundo.h"
 #include "node/project/serializer/serializer.h"
+#include "render/rendermanager.h"
 #include "task/project/import/import.h"
 #include "timeline/timelineundogeneral.h"
 #include "timeline/timelineundopointer.h"
@@ -59,12 +62,47 @@
 
 namespace olive {
 
+namespace {
+
+// Operation names used to group interaction latency samples. Tools that don't commit edits
+// (hand, zoom, record) return an empty string and aren't measured.
+QString GetInteractionName(Tool::Item tool)
+{
+  switch (tool) {
+  case Tool::kPointer:
+    return QStringLiteral("Pointer");
+  case Tool::kEdit:
+    return QStringLiteral("Edit");
+  case Tool::kRipple:
+    return QStringLiteral("Ripple");
+  case Tool::kRolling:
+    return QStringLiteral("Rolling");
+  case Tool::kRazor:
+    return QStringLiteral("Razor");
+  case Tool::kSlip:
+    return QStringLiteral("Slip");
+  case Tool::kSlide:
+    return QStringLiteral("Slide");
+  case Tool::kTransition:
+    return QStringLiteral("Transition");
+  case Tool::kAdd:
+    return QStringLiteral("Add");
+  case Tool::kTrackSelect:
+    return QStringLiteral("Track Select");
+  default:
+    return QString();
+  }
+}
+
+}
+
 #define super TimeBasedWidget
 
 TimelineWidget::TimelineWidget(QWidget *parent) :
   super(true, true, parent),
   rubberband_(QRubberBand::Rectangle, this),
   active_tool_(nullptr),
+  snap_time_index_dirty_(true),
   use_audio_time_units_(false),
   subtitle_show_command_(nullptr),
   subtitle_tentative_track_(nullptr)
@@ -127,6 +165,7 @@ TimelineWidget::TimelineWidget(QWidget *parent) :
 
   // Global scrollbar
   connect(views_.first()->view()->horizontalScrollBar(), &QScrollBar::rangeChanged, scrollbar(), &QScrollBar::setRange);
+  connect(views_.first()->view()->horizontalScrollBar(), &QScrollBar::valueChanged, this, &TimelineWidget::ReportVisibleRange);
   vert_layout->addWidget(scrollbar());
 
   foreach (TimelineAndTrackView* tview, views_) {
@@ -152,6 +191,7 @@ TimelineWidget::TimelineWidget(QWidget *parent) :
     connect(view, &TimelineView::DragMoved, this, &TimelineWidget::ViewDragMoved);
     connect(view, &TimelineView::DragLeft, this, &TimelineWidget::ViewDragLeft);
     connect(view, &TimelineView::DragDropped, this, &TimelineWidget::ViewDragDropped);
+    connect(view, &TimelineView::PaintFinished, this, &TimelineWidget::InteractionPainted);
 
     connect(tview->splitter(), &QSplitter::splitterMoved, this, &TimelineWidget::UpdateHorizontalSplitters);
   }
@@ -235,6 +275,8 @@ void TimelineWidget::resizeEvent(QResizeEvent *event)
 
   // Update timecode label size
   UpdateTimecodeWidthFromSplitters(views_.first()->splitter());
+
+  ReportVisibleRange();
 }
 
 void TimelineWidget::TimeChangedEvent(const rational &t)
@@ -278,6 +320,8 @@ void TimelineWidget::ScaleChangedEvent(const double &scale)
   if (rubberband_.isVisible()) {
     QMetaObject::invokeMethod(this, &TimelineWidget::ForceUpdateRubberBand, Qt::QueuedConnection);
   }
+
+  ReportVisibleRange();
 }
 
 void TimelineWidget::ConnectNodeEvent(ViewerOutput *n)
@@ -1081,14 +1125,34 @@ void TimelineWidget::ViewMouseReleased(TimelineViewMouseEvent *event)
 
   if (active_tool_) {
     if (GetConnectedNode()) {
+      // The release is what commits the operation (undo command construction, cache
+      // invalidation fan-out), so time from here to the repaint that shows the result -
+      // that's the latency the user perceives
+      interaction_op_ = GetInteractionName(Core::instance()->tool());
+      interaction_timer_.start();
+
       active_tool_->MouseRelease(event);
       UpdateViewports();
+
+      if (!interaction_op_.isEmpty()) {
+        if (TimelineView *view = static_cast<TimelineView*>(sender())) {
+          view->NotifyNextPaint();
+        }
+      }
     }
 
     active_tool_ = nullptr;
   }
 }
 
+void TimelineWidget::InteractionPainted()
+{
+  if (!interaction_op_.isEmpty()) {
+    InteractionTracker::instance()->AddSample(interaction_op_, interaction_timer_.elapsed());
+    interaction_op_.clear();
+  }
+}
+
 void TimelineWidget::ViewMouseDoubleClicked(TimelineViewMouseEvent *event)
 {
   // kHand tool will return nullptr
@@ -1133,6 +1197,46 @@ void TimelineWidget::ViewDragDropped(TimelineViewMouseEvent *event)
   UpdateViewports();
 }
 
+const TimeBasedWidget::SnapTimeIndex *TimelineWidget::GetSnapTimeIndex() const
+{
+  if (snap_time_index_dirty_) {
+    snap_time_index_.block_times.clear();
+    snap_time_index_.marker_times.clear();
+
+    foreach (Block* block, added_blocks_) {
+      snap_time_index_.block_times.push_back(block->in());
+      snap_time_index_.block_times.push_back(block->out());
+
+      if (ClipBlock *clip = dynamic_cast<ClipBlock*>(block)) {
+        if (clip->connected_viewer()) {
+          TimelineMarkerList *markers = clip->connected_viewer()->GetMarkers();
+          for (auto it=markers->cbegin(); it!=markers->cend(); it++) {
+            TimeRange marker_range = (*it)->time() + clip->in() - clip->media_in();
+
+            snap_time_index_.marker_times.push_back(marker_range.in());
+
+            if (marker_range.out() != marker_range.in()) {
+              snap_time_index_.marker_times.push_back(marker_range.out());
+            }
+          }
+        }
+      }
+    }
+
+    std::sort(snap_time_index_.block_times.begin(), snap_time_index_.block_times.end());
+    std::sort(snap_time_index_.marker_times.begin(), snap_time_index_.marker_times.end());
+
+    snap_time_index_dirty_ = false;
+  }
+
+  return &snap_time_index_;
+}
+
+void TimelineWidget::InvalidateSnapTimeIndex()
+{
+  snap_time_index_dirty_ = true;
+}
+
 void TimelineWidget::AddBlock(Block *block)
 {
   // Set up clip with view parameters (clip item will automatically size its rect accordingly)
@@ -1145,6 +1249,20 @@ void TimelineWidget::AddBlock(Block *block)
 
     added_blocks_.append(block);
 
+    snap_time_index_dirty_ = true;
+
+    if (ClipBlock *clip = dynamic_cast<ClipBlock*>(block)) {
+      if (clip->connected_viewer()) {
+        // Keep the snap index in sync with clip marker edits. These connections intentionally
+        // aren't undone in RemoveBlock - several clips may share a viewer, and a spurious
+        // invalidation from an unwatched viewer is harmless
+        TimelineMarkerList *markers = clip->connected_viewer()->GetMarkers();
+        connect(markers, &TimelineMarkerList::MarkerAdded, this, &TimelineWidget::InvalidateSnapTimeIndex, Qt::UniqueConnection);
+        connect(markers, &TimelineMarkerList::MarkerRemoved, this, &TimelineWidget::InvalidateSnapTimeIndex, Qt::UniqueConnection);
+        connect(markers, &TimelineMarkerList::MarkerModified, this, &TimelineWidget::InvalidateSnapTimeIndex, Qt::UniqueConnection);
+      }
+    }
+
     if (selections_[block->track()->ToReference()].contains(block->range()) && !selected_blocks_.contains(block)) {
       selected_blocks_.append(block);
     }
@@ -1163,6 +1281,8 @@ void TimelineWidget::RemoveBlock(Block *block)
   // Take item from map
   added_blocks_.removeOne(block);
 
+  snap_time_index_dirty_ = true;
+
   // If selected, deselect it
   int select_index = selected_blocks_.indexOf(block);
   if (select_index > -1) {
@@ -1182,6 +1302,7 @@ void TimelineWidget::AddTrack(Track *track)
   connect(track, &Track::IndexChanged, this, &TimelineWidget::TrackUpdated);
   connect(track, &Track::IndexChanged, this, &TimelineWidget::TrackIndexChanged);
   connect(track, &Track::BlocksRefreshed, this, &TimelineWidget::TrackUpdated);
+  connect(track, &Track::BlocksRefreshed, this, &TimelineWidget::InvalidateSnapTimeIndex);
   connect(track, &Track::TrackHeightChanged, this, &TimelineWidget::TrackUpdated);
   connect(track, &Track::BlockAdded, this, &TimelineWidget::AddBlock);
   connect(track, &Track::BlockRemoved, this, &TimelineWidget::RemoveBlock);
@@ -1192,6 +1313,7 @@ void TimelineWidget::RemoveTrack(Track *track)
   disconnect(track, &Track::IndexChanged, this, &TimelineWidget::TrackUpdated);
   disconnect(track, &Track::IndexChanged, this, &TimelineWidget::TrackIndexChanged);
   disconnect(track, &Track::BlocksRefreshed, this, &TimelineWidget::TrackUpdated);
+  disconnect(track, &Track::BlocksRefreshed, this, &TimelineWidget::InvalidateSnapTimeIndex);
   disconnect(track, &Track::TrackHeightChanged, this, &TimelineWidget::TrackUpdated);
   disconnect(track, &Track::BlockAdded, this, &TimelineWidget::AddBlock);
   disconnect(track, &Track::BlockRemoved, this, &TimelineWidget::RemoveBlock);
@@ -1205,12 +1327,29 @@ void TimelineWidget::RemoveTrack(Track *track)
 
 void TimelineWidget::TrackUpdated()
 {
-  UpdateViewports(static_cast<Track*>(sender())->type());
+  Track *track = static_cast<Track*>(sender());
+
+  if (track->type() == Track::kNone) {
+    UpdateViewports();
+  } else {
+    // Only this track's band of the cached block layers needs re-rendering
+    TimelineView *view = views_.at(track->type())->view();
+    view->InvalidateTrackCache(track);
+    view->viewport()->update();
+  }
 }
 
 void TimelineWidget::BlockUpdated()
 {
-  UpdateViewports(static_cast<Block*>(sender())->track()->type());
+  Track *track = static_cast<Block*>(sender())->track();
+
+  if (track->type() == Track::kNone) {
+    UpdateViewports();
+  } else {
+    TimelineView *view = views_.at(track->type())->view();
+    view->InvalidateTrackCache(track);
+    view->viewport()->update();
+  }
 }
 
 void TimelineWidget::UpdateHorizontalSplitters()
@@ -1633,6 +1772,14 @@ void TimelineWidget::NudgeInternal(rational amount)
     new_sel.ShiftTime(amount);
     command->add_child(new TimelineWidget::SetSelectionsCommand(this, new_sel, GetSelections()));
 
+    // Holding the nudge key repeats quickly, so sequential nudges of the same clips coalesce
+    // into a single undo entry
+    QString merge_id = QStringLiteral("nudge");
+    foreach (Block* b, selected_blocks_) {
+      merge_id += QLatin1Char(':') + QString::number(reinterpret_cast<quintptr>(b), 16);
+    }
+    command->SetMergeId(merge_id);
+
     Core::instance()->undo_stack()->push(command, tr("Nudged Clips"));
   }
 }
@@ -1923,12 +2070,24 @@ void TimelineWidget::EditTo(Timeline::MovementMode mode)
 
 void TimelineWidget::UpdateViewports(const Track::Type &type)
 {
+  // Callers of this don't say which track changed, so conservatively re-render all cached block
+  // layers. Edits that do know their track go through TrackUpdated()/BlockUpdated() instead.
   if (type == Track::kNone) {
     foreach (TimelineAndTrackView* tview, views_) {
+      tview->view()->InvalidateAllTrackCaches();
       tview->view()->viewport()->update();
     }
   } else {
-    views_.at(type)->view()->viewport()->update();
+    TimelineView *view = views_.at(type)->view();
+    view->InvalidateAllTrackCaches();
+    view->viewport()->update();
+  }
+}
+
+void TimelineWidget::ReportVisibleRange()
+{
+  if (!views_.isEmpty()) {
+    RenderManager::instance()->GetCacher()->SetVisibleRange(views_.first()->view()->GetVisibleTimeRange());
   }
 }
 
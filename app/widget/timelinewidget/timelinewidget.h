@@ -21,6 +21,7 @@
 #ifndef TIMELINEWIDGET_H
 #define TIMELINEWIDGET_H
 
+#include <QElapsedTimer>
 #include <QScrollBar>
 #include <QRubberBand>
 #include <QWidget>
@@ -299,6 +300,8 @@ protected:
 
   virtual const QVector<Block*> *GetSnapBlocks() const override { return &added_blocks_; }
 
+  virtual const SnapTimeIndex *GetSnapTimeIndex() const override;
+
 protected slots:
   virtual void SendCatchUpScrollEvent() override;
 
@@ -317,6 +320,11 @@ private:
 
   QHash<Node*, Node*> GenerateExistingPasteMap(const ProjectSerializer::Result &r);
 
+  /**
+   * @brief Tell the auto-cacher which time range is on screen so thumbnails there render first
+   */
+  void ReportVisibleRange();
+
   QRubberBand rubberband_;
   QVector<QPointF> rubberband_scene_pos_;
   TimelineWidgetSelections rubberband_old_selections_;
@@ -334,6 +342,15 @@ private:
 
   TimelineTool* active_tool_;
 
+  /**
+   * @brief Interaction latency measurement state - see ViewMouseReleased()
+   *
+   * The timer starts when a committing input event arrives and stops at the next repaint of
+   * the view that received it, recorded against the operation name in InteractionTracker.
+   */
+  QElapsedTimer interaction_timer_;
+  QString interaction_op_;
+
   QVector<TimelineViewGhostItem*> ghost_items_;
 
   QVector<TimelineAndTrackView*> views_;
@@ -344,6 +361,17 @@ private:
 
   QVector<Block*> added_blocks_;
 
+  /**
+   * @brief Sorted snap-point index over added_blocks_, rebuilt lazily after edits
+   *
+   * GetSnapTimeIndex() rebuilds this on first use after an edit marked it dirty, so drags -
+   * where SnapPoint() runs on every mouse move against an unchanging timeline - binary search
+   * the sorted times instead of rescanning every block.
+   */
+  mutable SnapTimeIndex snap_time_index_;
+
+  mutable bool snap_time_index_dirty_;
+
   int deferred_scroll_value_;
 
   bool use_audio_time_units_;
@@ -393,6 +421,8 @@ private slots:
   void ViewMouseReleased(TimelineViewMouseEvent* event);
   void ViewMouseDoubleClicked(TimelineViewMouseEvent* event);
 
+  void InteractionPainted();
+
   void ViewDragEntered(TimelineViewMouseEvent* event);
   void ViewDragMoved(TimelineViewMouseEvent* event);
   void ViewDragLeft(QDragLeaveEvent* event);
@@ -407,6 +437,8 @@ private slots:
 
   void BlockUpdated();
 
+  void InvalidateSnapTimeIndex();
+
   void UpdateHorizontalSplitters();
 
   void UpdateTimecodeWidthFromSplitters(QSplitter *s);
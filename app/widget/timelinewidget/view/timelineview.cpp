@@ -39,6 +39,13 @@ namespace olive {
 
 #define super TimeBasedView
 
+// Blocks narrower than this are drawn as plain fills with no decoration, and runs of them are
+// merged into single density strips - see DrawAggregateStrip()
+static const qreal MINIMUM_RECT_WIDTH = 2;
+
+// Blocks narrower than this skip text, thumbnails and waveforms
+static const qreal MINIMUM_DETAIL_WIDTH = 8;
+
 TimelineView::TimelineView(Qt::Alignment vertical_alignment, QWidget *parent) :
   super(parent),
   selections_(nullptr),
@@ -46,7 +53,11 @@ TimelineView::TimelineView(Qt::Alignment vertical_alignment, QWidget *parent) :
   show_beam_cursor_(false),
   connected_track_list_(nullptr),
   transition_overlay_out_(nullptr),
-  transition_overlay_in_(nullptr)
+  transition_overlay_in_(nullptr),
+  block_layer_cache_scale_(0),
+  block_layer_cache_valid_(false),
+  all_tracks_dirty_(false),
+  paint_notify_pending_(false)
 {
   Q_ASSERT(vertical_alignment == Qt::AlignTop || vertical_alignment == Qt::AlignBottom);
   setAlignment(Qt::AlignLeft | vertical_alignment);
@@ -204,14 +215,31 @@ void TimelineView::drawBackground(QPainter *painter, const QRectF &rect)
   }
 }
 
+void TimelineView::paintEvent(QPaintEvent *event)
+{
+  super::paintEvent(event);
+
+  if (paint_notify_pending_) {
+    paint_notify_pending_ = false;
+    emit PaintFinished();
+  }
+}
+
 void TimelineView::drawForeground(QPainter *painter, const QRectF &rect)
 {
   if (!connected_track_list_) {
     return;
   }
 
+  // Re-render any portion of the cached block layers that has changed, then composite them.
+  // Repaints where no block changed (playhead motion, ghosts, selections) skip straight to
+  // compositing.
+  UpdateBlockLayerCache();
+
   // Draw block backgrounds
-  DrawBlocks(painter, false);
+  if (block_layer_cache_valid_) {
+    painter->drawPixmap(block_layer_cache_rect_.topLeft(), block_layer_cache_[0]);
+  }
 
   // Draw selections
   if (selections_ && !selections_->isEmpty()) {
@@ -233,7 +261,9 @@ void TimelineView::drawForeground(QPainter *painter, const QRectF &rect)
   }
 
   // Draw block foregrounds
-  DrawBlocks(painter, true);
+  if (block_layer_cache_valid_) {
+    painter->drawPixmap(block_layer_cache_rect_.topLeft(), block_layer_cache_[1]);
+  }
 
   // Draw ghosts
   if (ghosts_ && !ghosts_->isEmpty()) {
@@ -376,29 +406,198 @@ TimelineViewMouseEvent TimelineView::CreateMouseEvent(const QPoint& pos, Qt::Mou
                                 modifiers);
 }
 
-void TimelineView::DrawBlocks(QPainter *painter, bool foreground)
+void TimelineView::UpdateBlockLayerCache()
+{
+  const qreal dpr = devicePixelRatioF();
+
+  QRect scene_rect(qRound(GetTimelineLeftBound()),
+                   qRound(mapToScene(0, 0).y()),
+                   viewport()->width(),
+                   viewport()->height());
+
+  QSize pixmap_size = scene_rect.size() * dpr;
+
+  if (pixmap_size.isEmpty()) {
+    block_layer_cache_valid_ = false;
+    return;
+  }
+
+  bool render_all = false;
+
+  // Any change of viewport geometry, scroll position or zoom re-renders everything. While those
+  // are stable (e.g. during playback), only tracks whose blocks were edited are re-rendered.
+  if (!block_layer_cache_valid_
+      || block_layer_cache_rect_ != scene_rect
+      || block_layer_cache_scale_ != GetScale()
+      || block_layer_cache_[0].size() != pixmap_size) {
+    for (int i=0; i<2; i++) {
+      if (block_layer_cache_[i].size() != pixmap_size) {
+        block_layer_cache_[i] = QPixmap(pixmap_size);
+      }
+      block_layer_cache_[i].setDevicePixelRatio(dpr);
+    }
+
+    block_layer_cache_rect_ = scene_rect;
+    block_layer_cache_scale_ = GetScale();
+    block_layer_cache_valid_ = true;
+    render_all = true;
+  }
+
+  if (render_all || all_tracks_dirty_) {
+    RenderBlockLayers(nullptr);
+  } else {
+    foreach (Track* track, dirty_tracks_) {
+      // Tracks may have left this list since being marked dirty
+      if (connected_track_list_->GetTracks().contains(track)) {
+        RenderBlockLayers(track);
+      }
+    }
+  }
+
+  all_tracks_dirty_ = false;
+  dirty_tracks_.clear();
+}
+
+void TimelineView::RenderBlockLayers(Track *only_track)
+{
+  for (int pass=0; pass<2; pass++) {
+    QPainter p(&block_layer_cache_[pass]);
+    p.setFont(font());
+    p.translate(-block_layer_cache_rect_.topLeft());
+
+    QRect clear_rect = block_layer_cache_rect_;
+    if (only_track) {
+      clear_rect.setTop(GetTrackY(only_track->Index()));
+      clear_rect.setHeight(GetTrackHeight(only_track->Index()));
+      p.setClipRect(clear_rect);
+    }
+
+    // Clear to transparent so the layers composite over the view background
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    p.fillRect(clear_rect, Qt::transparent);
+    p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    if (only_track) {
+      DrawTrackBlocks(&p, pass == 1, only_track);
+    } else {
+      foreach (Track* track, connected_track_list_->GetTracks()) {
+        DrawTrackBlocks(&p, pass == 1, track);
+      }
+    }
+  }
+}
+
+void TimelineView::DrawTrackBlocks(QPainter *painter, bool foreground, Track *track)
 {
   rational start_time = SceneToTime(GetTimelineLeftBound());
   rational end_time = SceneToTime(GetTimelineRightBound());
 
-  foreach (Track* track, connected_track_list_->GetTracks()) {
-    // Get first visible block in this track
-    Block* block = track->NearestBlockBeforeOrAt(start_time);
+  // Get first visible block in this track
+  Block* block = track->NearestBlockBeforeOrAt(start_time);
+
+  qreal track_top = GetTrackY(track->Index());
+  qreal track_height = GetTrackHeight(track->Index());
 
-    qreal track_top = GetTrackY(track->Index());
-    qreal track_height = GetTrackHeight(track->Index());
+  while (block) {
+    // Merge runs of sub-pixel blocks into one strip rather than drawing thousands of
+    // individually invisible clips (a lone narrow block keeps the normal path)
+    if (TimeToScene(block->length()) < MINIMUM_RECT_WIDTH
+        && block->next()
+        && TimeToScene(block->next()->length()) < MINIMUM_RECT_WIDTH) {
+      block = DrawAggregateStrip(painter, foreground, block, track_top, track_height, end_time);
+      continue;
+    }
+
+    DrawBlock(painter, foreground, block, track_top, track_height);
+
+    if (block->out() >= end_time) {
+      // Rest of the clips are offscreen, can break loop now
+      break;
+    }
+
+    block = block->next();
+  }
+}
+
+Block *TimelineView::DrawAggregateStrip(QPainter *painter, bool foreground, Block *first, qreal track_top, qreal track_height, const rational &end_time)
+{
+  // Consume every consecutive block that's below the aggregation width
+  Block *last = first;
+  Block *next = nullptr;
+
+  for (Block *b = first; b; b = b->next()) {
+    if (TimeToScene(b->length()) >= MINIMUM_RECT_WIDTH) {
+      next = b;
+      break;
+    }
+
+    last = b;
+
+    if (b->out() >= end_time) {
+      // Rest of the run is offscreen
+      break;
+    }
+  }
+
+  if (foreground) {
+    // Aggregated blocks have no foreground decoration (labels, borders, links)
+    return next;
+  }
+
+  const qreal strip_left = qMax(GetTimelineLeftBound(), TimeToScene(first->in()));
+  const qreal strip_right = qMin(GetTimelineRightBound(), TimeToScene(last->out()));
 
-    while (block) {
-      DrawBlock(painter, foreground, block, track_top, track_height);
+  const int first_col = qFloor(strip_left);
+  const int col_count = qCeil(strip_right) - first_col;
 
-      if (block->out() >= end_time) {
-        // Rest of the clips are offscreen, can break loop now
-        break;
+  if (col_count <= 0) {
+    return next;
+  }
+
+  // Accumulate per-pixel-column clip coverage (gaps contribute nothing). Blocks in a track
+  // never overlap, so coverage stays within [0, 1].
+  QVector<qreal> coverage(col_count, 0);
+  QColor strip_color;
+
+  for (Block *b = first; b; b = b->next()) {
+    if (dynamic_cast<ClipBlock*>(b) || dynamic_cast<TransitionBlock*>(b)) {
+      if (!strip_color.isValid()) {
+        strip_color = b->is_enabled() ? QtUtils::toQColor(b->color()).darker() : QColor(Qt::darkGray).darker();
+      }
+
+      qreal block_left = qMax(strip_left, TimeToScene(b->in()));
+      qreal block_right = qMin(strip_right, TimeToScene(b->out()));
+
+      for (int col = qFloor(block_left); col < block_right; col++) {
+        coverage[col - first_col] += qMin(block_right, qreal(col + 1)) - qMax(block_left, qreal(col));
       }
+    }
+
+    if (b == last) {
+      break;
+    }
+  }
+
+  // Paint spans of equal density as single rects
+  painter->setPen(Qt::NoPen);
+
+  int col = 0;
+  while (col < col_count) {
+    int alpha = qMin(255, qRound(coverage[col] * 255.0));
+    int span_start = col;
 
-      block = block->next();
+    do {
+      col++;
+    } while (col < col_count && qMin(255, qRound(coverage[col] * 255.0)) == alpha);
+
+    if (alpha > 0) {
+      QColor c = strip_color;
+      c.setAlpha(alpha);
+      painter->fillRect(QRectF(first_col + span_start, track_top, col - span_start, track_height), c);
     }
   }
+
+  return next;
 }
 
 void TimelineView::DrawBlock(QPainter *painter, bool foreground, Block *block, qreal block_top, qreal block_height, const rational &in, const rational &out, const rational &media_in)
@@ -417,9 +616,6 @@ void TimelineView::DrawBlock(QPainter *painter, bool foreground, Block *block, q
 
     QColor shadow_color = block->is_enabled() ? QtUtils::toQColor(block->color()).darker() : QColor(Qt::darkGray).darker();
 
-    const qreal MINIMUM_RECT_WIDTH = 2;
-    const qreal MINIMUM_DETAIL_WIDTH = 8;
-
     if (r.width() <= MINIMUM_RECT_WIDTH) {
       if (!foreground) {
         // Just draw a green background
@@ -683,6 +879,11 @@ int TimelineView::GetHeightOfAllTracks() const
   }
 }
 
+TimeRange TimelineView::GetVisibleTimeRange() const
+{
+  return TimeRange(SceneToTime(GetTimelineLeftBound()), SceneToTime(GetTimelineRightBound()));
+}
+
 qreal TimelineView::GetTimelineLeftBound() const
 {
   return horizontalScrollBar()->value();
@@ -774,6 +975,9 @@ void TimelineView::ConnectTrackList(TrackList *list)
 
   connected_track_list_ = list;
 
+  dirty_tracks_.clear();
+  InvalidateAllTrackCaches();
+
   if (connected_track_list_) {
     connect(connected_track_list_, &TrackList::TrackListChanged, this, &TimelineView::TrackListChanged);
     connect(connected_track_list_, &TrackList::TrackHeightChanged, this, &TimelineView::TrackListChanged);
@@ -816,6 +1020,8 @@ void TimelineView::SetTransitionOverlay(ClipBlock *out, ClipBlock *in)
       transition_overlay_in_ = nullptr;
     }
 
+    // Overlay is baked into the block foreground layer
+    InvalidateAllTrackCaches();
     viewport()->update();
   }
 }
@@ -897,6 +1103,7 @@ QVector<Block *> TimelineView::GetItemsAtSceneRect(const QRectF &rect) const
 
 void TimelineView::TrackListChanged()
 {
+  InvalidateAllTrackCaches();
   UpdateSceneRect();
   viewport()->update();
 }
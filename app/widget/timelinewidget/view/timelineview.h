@@ -26,6 +26,8 @@
 #include <QDragMoveEvent>
 #include <QDragLeaveEvent>
 #include <QDropEvent>
+#include <QPixmap>
+#include <QSet>
 
 #include "node/block/clip/clip.h"
 #include "timelineviewmouseevent.h"
@@ -71,11 +73,45 @@ public:
 
   int SceneToTrack(double y);
 
+  /**
+   * @brief Return the range of time currently visible in the viewport
+   */
+  TimeRange GetVisibleTimeRange() const;
+
   Block* GetItemAtScenePos(const rational& time, int track_index) const;
 
   QVector<Block*> GetItemsAtSceneRect(const QRectF &rect) const;
 
+  /**
+   * @brief Mark one track's cached block layers as needing a re-render
+   *
+   * The block passes are rendered into cached pixmaps so high-frequency repaints (playhead
+   * motion, drag ghosts, selections) only composite them. Anything that changes how a track's
+   * blocks look must call this (or InvalidateAllTrackCaches()) before updating the viewport.
+   */
+  void InvalidateTrackCache(Track *track)
+  {
+    dirty_tracks_.insert(track);
+  }
+
+  void InvalidateAllTrackCaches()
+  {
+    all_tracks_dirty_ = true;
+  }
+
+  /**
+   * @brief Request a PaintFinished() signal once the next repaint has completed
+   *
+   * Used by TimelineWidget to measure input-to-paint latency of editing interactions.
+   */
+  void NotifyNextPaint()
+  {
+    paint_notify_pending_ = true;
+  }
+
 signals:
+  void PaintFinished();
+
   void MousePressed(TimelineViewMouseEvent* event);
   void MouseMoved(TimelineViewMouseEvent* event);
   void MouseReleased(TimelineViewMouseEvent* event);
@@ -97,6 +133,8 @@ protected:
   virtual void dragLeaveEvent(QDragLeaveEvent *event) override;
   virtual void dropEvent(QDropEvent *event) override;
 
+  virtual void paintEvent(QPaintEvent *event) override;
+
   virtual void drawBackground(QPainter *painter, const QRectF &rect) override;
   virtual void drawForeground(QPainter *painter, const QRectF &rect) override;
 
@@ -113,7 +151,26 @@ private:
   TimelineViewMouseEvent CreateMouseEvent(QMouseEvent* event);
   TimelineViewMouseEvent CreateMouseEvent(const QPoint &pos, Qt::MouseButton button, Qt::KeyboardModifiers modifiers);
 
-  void DrawBlocks(QPainter* painter, bool foreground);
+  void UpdateBlockLayerCache();
+
+  void RenderBlockLayers(Track *only_track);
+
+  void DrawTrackBlocks(QPainter *painter, bool foreground, Track *track);
+
+  /**
+   * @brief Draw a run of sub-pixel blocks as one density-colored strip
+   *
+   * When zoomed out far enough that individual blocks are under a couple of pixels wide (e.g.
+   * viewing a feature film in one screen), drawing every clip with full decoration is both slow
+   * and unreadable. Starting from `first`, this consumes consecutive blocks that are all below
+   * the aggregation width and paints a single strip whose opacity per pixel column reflects how
+   * much of that column is covered by clips. Thumbnails, waveforms, labels and borders are
+   * skipped entirely for aggregated blocks.
+   *
+   * Returns the first block that was NOT consumed (to continue drawing from), or null if the
+   * run reached `end_time` or the end of the track.
+   */
+  Block *DrawAggregateStrip(QPainter *painter, bool foreground, Block *first, qreal track_top, qreal track_height, const rational &end_time);
 
   void DrawBlock(QPainter *painter, bool foreground, Block *block, qreal top, qreal height, const rational &in, const rational &out, const rational &media_in);
   void DrawBlock(QPainter *painter, bool foreground, Block *block, qreal top, qreal height)
@@ -152,6 +209,23 @@ private:
   bool recording_overlay_;
   TimelineCoordinate recording_coord_;
 
+  /**
+   * @brief Cached renders of the two block passes (0 = backgrounds, 1 = foregrounds)
+   *
+   * Covers exactly the visible scene rect. While valid, repaints composite these instead of
+   * re-drawing blocks, thumbnails and waveforms; block edits re-render only the edited track's
+   * band via dirty_tracks_.
+   */
+  QPixmap block_layer_cache_[2];
+  QRect block_layer_cache_rect_;
+  qreal block_layer_cache_scale_;
+  bool block_layer_cache_valid_;
+
+  bool all_tracks_dirty_;
+
+  bool paint_notify_pending_;
+  QSet<Track*> dirty_tracks_;
+
 private slots:
   void TrackListChanged();
 
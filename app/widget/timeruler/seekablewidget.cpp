@@ -295,7 +295,11 @@ void SeekableWidget::DrawMarkers(QPainter *p, int marker_bottom)
     int lim_left = GetLeftLimit();
     int lim_right = GetRightLimit();
 
-    for (auto it=markers_->cbegin(); it!=markers_->cend(); it++) {
+    // Narrow iteration down to the markers that can actually appear in the visible range,
+    // widened by a pixel each side so scene/time rounding can't drop an edge marker
+    auto span = markers_->GetMarkersInRange(TimeRange(SceneToTimeNoGrid(lim_left - 1), SceneToTimeNoGrid(lim_right + 1)));
+
+    for (auto it=span.first; it!=span.second; it++) {
       TimelineMarker* marker = *it;
 
       int marker_right = TimeToScene(marker->time().out());
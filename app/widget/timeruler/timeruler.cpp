@@ -21,7 +21,9 @@
 #include "timeruler.h"
 
 #include <QDebug>
+#include <QEvent>
 #include <QPainter>
+#include <QtMath>
 
 #include "common/qtutils.h"
 #include "config/config.h"
@@ -38,7 +40,9 @@ TimeRuler::TimeRuler(bool text_visible, bool cache_status_visible, QWidget* pare
   text_visible_(text_visible),
   centered_text_(true),
   show_cache_status_(cache_status_visible),
-  playback_cache_(nullptr)
+  playback_cache_(nullptr),
+  tick_cache_scale_(0),
+  tick_cache_scroll_(0)
 {
   QFontMetrics fm = fontMetrics();
 
@@ -104,6 +108,77 @@ void TimeRuler::drawForeground(QPainter *p, const QRectF &rect)
   DrawWorkArea(p);
   DrawMarkers(p, marker_height);
 
+  // Composite the tick lines and timecode labels from the cached layer, re-rendering it only if
+  // the scroll/zoom/size/display has changed since last paint
+  UpdateTickCache();
+  p->drawPixmap(QPoint(GetScroll(), 0), tick_cache_);
+
+  int line_bottom = height();
+
+  if (show_cache_status_) {
+    line_bottom -= PlaybackCache::GetCacheIndicatorHeight();
+  }
+
+  // If cache status is enabled
+  if (show_cache_status_ && playback_cache_ && playback_cache_->HasValidatedRanges()) {
+    // FIXME: Hardcoded to get video length, if we ever need audio length, this will have to change
+    int h = PlaybackCache::GetCacheIndicatorHeight();
+    QRect cache_rect(0, height() - h, width(), h);
+
+    if (ViewerOutput *viewer = dynamic_cast<ViewerOutput*>(playback_cache_->parent())) {
+      int right = TimeToScene(viewer->GetVideoLength());
+      cache_rect.setWidth(std::max(0, right));
+    }
+
+    if (cache_rect.width() > 0) {
+      playback_cache_->Draw(p, SceneToTime(GetScroll()), GetScale(), cache_rect);
+    }
+  }
+
+  // Draw the playhead if it's on screen at the moment
+  int playhead_pos = TimeToScene(GetViewerNode()->GetPlayhead());
+  p->setPen(Qt::NoPen);
+  p->setBrush(PLAYHEAD_COLOR);
+  DrawPlayhead(p, playhead_pos, line_bottom);
+}
+
+void TimeRuler::UpdateTickCache()
+{
+  double scale = GetScale();
+  int scroll = GetScroll();
+  Timecode::Display display = Core::instance()->GetTimecodeDisplay();
+
+  if (!tick_cache_.isNull() && tick_cache_scale_ == scale && tick_cache_scroll_ == scroll
+      && tick_cache_size_ == size() && tick_cache_timebase_ == timebase()
+      && tick_cache_display_ == display) {
+    // Layer is still valid
+    return;
+  }
+
+  tick_cache_scale_ = scale;
+  tick_cache_scroll_ = scroll;
+  tick_cache_size_ = size();
+  tick_cache_timebase_ = timebase();
+  tick_cache_display_ = display;
+
+  qreal dpr = devicePixelRatioF();
+  tick_cache_ = QPixmap(qCeil(width() * dpr), qCeil(height() * dpr));
+  tick_cache_.setDevicePixelRatio(dpr);
+  tick_cache_.fill(Qt::transparent);
+
+  QPainter p(&tick_cache_);
+  p.setFont(font());
+
+  // Keep RenderTicks() painting in scene coordinates like drawForeground() used to
+  p.translate(-scroll, 0);
+
+  RenderTicks(&p);
+}
+
+void TimeRuler::RenderTicks(QPainter *p)
+{
+  int marker_height = TimelineMarker::GetMarkerHeight(p->fontMetrics());
+
   double width_of_frame = timebase_dbl() * GetScale();
   double width_of_second = 0;
   do {
@@ -248,28 +323,6 @@ void TimeRuler::drawForeground(QPainter *p, const QRectF &rect)
       }
     }
   }
-
-  // If cache status is enabled
-  if (show_cache_status_ && playback_cache_ && playback_cache_->HasValidatedRanges()) {
-    // FIXME: Hardcoded to get video length, if we ever need audio length, this will have to change
-    int h = PlaybackCache::GetCacheIndicatorHeight();
-    QRect cache_rect(0, height() - h, width(), h);
-
-    if (ViewerOutput *viewer = dynamic_cast<ViewerOutput*>(playback_cache_->parent())) {
-      int right = TimeToScene(viewer->GetVideoLength());
-      cache_rect.setWidth(std::max(0, right));
-    }
-
-    if (cache_rect.width() > 0) {
-      playback_cache_->Draw(p, SceneToTime(GetScroll()), GetScale(), cache_rect);
-    }
-  }
-
-  // Draw the playhead if it's on screen at the moment
-  int playhead_pos = TimeToScene(GetViewerNode()->GetPlayhead());
-  p->setPen(Qt::NoPen);
-  p->setBrush(PLAYHEAD_COLOR);
-  DrawPlayhead(p, playhead_pos, line_bottom);
 }
 
 void TimeRuler::TimebaseChangedEvent(const rational &tb)
@@ -281,6 +334,16 @@ void TimeRuler::TimebaseChangedEvent(const rational &tb)
   update();
 }
 
+void TimeRuler::changeEvent(QEvent *event)
+{
+  if (event->type() == QEvent::PaletteChange || event->type() == QEvent::FontChange) {
+    // Force the tick layer to re-render with the new colors/metrics
+    tick_cache_ = QPixmap();
+  }
+
+  super::changeEvent(event);
+}
+
 int TimeRuler::CacheStatusHeight() const
 {
   return fontMetrics().height() / 4;
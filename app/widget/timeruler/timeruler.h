@@ -21,6 +21,7 @@
 #ifndef TIMERULER_H
 #define TIMERULER_H
 
+#include <QPixmap>
 #include <QTimer>
 #include <QWidget>
 
@@ -44,6 +45,8 @@ protected:
 
   virtual void TimebaseChangedEvent(const rational& tb) override;
 
+  virtual void changeEvent(QEvent *event) override;
+
 protected slots:
   virtual bool ShowContextMenu(const QPoint &p) override;
 
@@ -52,6 +55,10 @@ private:
 
   int CacheStatusHeight() const;
 
+  void UpdateTickCache();
+
+  void RenderTicks(QPainter *p);
+
   int minimum_gap_between_lines_;
 
   bool text_visible_;
@@ -64,6 +71,20 @@ private:
 
   PlaybackCache* playback_cache_;
 
+  /**
+   * @brief Cached render of the tick lines and timecode labels
+   *
+   * During playback only the playhead changes, yet every repaint recomputed tick geometry and
+   * timecode strings for the whole ruler. This layer is only re-rendered when the scroll, zoom,
+   * timebase, widget size or timecode display mode changes.
+   */
+  QPixmap tick_cache_;
+  double tick_cache_scale_;
+  int tick_cache_scroll_;
+  QSize tick_cache_size_;
+  rational tick_cache_timebase_;
+  Timecode::Display tick_cache_display_;
+
 };
 
 }
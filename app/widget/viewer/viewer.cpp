@@ -32,6 +32,7 @@
 #include <QVBoxLayout>
 
 #include "audio/audiomanager.h"
+#include "common/performancelog.h"
 #include "common/ratiodialog.h"
 #include "config/config.h"
 #include "core.h"
@@ -63,6 +64,10 @@ const rational ViewerWidget::kAudioPlaybackInterval = rational(1, 4);
 
 const rational kVideoPlaybackInterval = rational(1, 2);
 
+// Bounds for the adaptive look-ahead in DeterminePlaybackQueueSize()
+const rational kMinVideoPlaybackInterval = rational(1, 4);
+const rational kMaxVideoPlaybackInterval = rational(2, 1);
+
 ViewerWidget::ViewerWidget(ViewerDisplayWidget *display, QWidget *parent) :
   super(false, true, parent),
   playback_speed_(0),
@@ -73,6 +78,9 @@ ViewerWidget::ViewerWidget(ViewerDisplayWidget *display, QWidget *parent) :
   record_armed_(false),
   recording_(false),
   first_requeue_watcher_(nullptr),
+  adaptive_divider_(0),
+  adaptive_skip_count_(0),
+  average_frame_render_ms_(0),
   enable_audio_scrubbing_(true),
   waveform_mode_(kWFAutomatic),
   ignore_scrub_(0),
@@ -88,6 +96,7 @@ ViewerWidget::ViewerWidget(ViewerDisplayWidget *display, QWidget *parent) :
 
   display_widget_ = display;
   display_widget_->SetShowWidgetBackground(true);
+  display_widget_->SetTextureShare(&texture_share_);
   playback_devices_.append(display_widget_);
   connect(display_widget_, &ViewerDisplayWidget::customContextMenuRequested, this, &ViewerWidget::ShowContextMenu);
   connect(display_widget_, &ViewerDisplayWidget::CursorColor, this, &ViewerWidget::CursorColor);
@@ -98,6 +107,7 @@ ViewerWidget::ViewerWidget(ViewerDisplayWidget *display, QWidget *parent) :
   connect(display_widget_, &ViewerDisplayWidget::TextureChanged, this, &ViewerWidget::TextureChanged);
   connect(display_widget_, &ViewerDisplayWidget::QueueStarved, this, &ViewerWidget::QueueStarved);
   connect(display_widget_, &ViewerDisplayWidget::QueueNoLongerStarved, this, &ViewerWidget::QueueNoLongerStarved);
+  connect(display_widget_, &ViewerDisplayWidget::FrameSkipped, this, &ViewerWidget::FrameSkippedDuringPlayback);
   connect(display_widget_, &ViewerDisplayWidget::CreateAddableAt, this, &ViewerWidget::CreateAddableAt);
   connect(sizer_, &ViewerSizer::RequestScale, display_widget_, &ViewerDisplayWidget::SetMatrixZoom);
   connect(sizer_, &ViewerSizer::RequestTranslate, display_widget_, &ViewerDisplayWidget::SetMatrixTranslate);
@@ -140,6 +150,10 @@ ViewerWidget::ViewerWidget(ViewerDisplayWidget *display, QWidget *parent) :
 
   connect(&playback_backup_timer_, &QTimer::timeout, this, &ViewerWidget::PlaybackTimerUpdate);
 
+  preroll_timer_.setSingleShot(true);
+  preroll_timer_.setInterval(250);
+  connect(&preroll_timer_, &QTimer::timeout, this, &ViewerWidget::PreRollAtPlayhead);
+
   SetAutoMaxScrollBar(true);
 
   instances_.append(this);
@@ -383,6 +397,7 @@ void ViewerWidget::SetFullScreen(QScreen *screen)
 
   vw->display_widget()->SetImage(QVariant::fromValue(display_widget()->GetCurrentTexture()));
 
+  vw->display_widget()->SetTextureShare(&texture_share_);
   playback_devices_.append(vw->display_widget());
 
   (*vw->display_widget()->queue()) = *playback_devices_.first()->queue();
@@ -507,16 +522,25 @@ void ViewerWidget::DisarmRecording()
 void ViewerWidget::UpdateAudioProcessor()
 {
   if (GetConnectedNode()) {
-    CloseAudioProcessor();
-
     AudioParams ap = GetConnectedNode()->GetAudioParams();
     ap.set_format(ViewerOutput::kDefaultSampleFormat);
 
-    AudioParams packed(OLIVE_CONFIG("AudioOutputSampleRate").toInt(),
-                       OLIVE_CONFIG("AudioOutputChannelLayout").toULongLong(),
-                       SampleFormat::from_string(OLIVE_CONFIG("AudioOutputSampleFormat").toString().toStdString()));
+    AudioParams packed = AudioManager::GetConfigOutputParams();
+
+    double tempo = (playback_speed_ == 0) ? 1 : std::abs(playback_speed_);
 
-    audio_processor_.Open(ap, packed, (playback_speed_ == 0) ? 1 : std::abs(playback_speed_));
+    // If only the speed changed, retune the existing filter graph with a live command rather
+    // than paying a full graph rebuild on every shuttle step
+    if (audio_processor_.IsOpen()
+        && audio_processor_.from() == ap
+        && audio_processor_.to() == packed
+        && audio_processor_.SetTempo(tempo)) {
+      return;
+    }
+
+    CloseAudioProcessor();
+
+    audio_processor_.Open(ap, packed, tempo);
   }
 }
 
@@ -613,6 +637,68 @@ void ViewerWidget::RequestNextDryRun()
   }
 }
 
+void ViewerWidget::PreRollAtPlayhead()
+{
+  if (!GetConnectedNode() || IsPlaying() || recording_ || timebase().isNull()) {
+    return;
+  }
+
+  // Dry-run a few frames each side of the paused playhead, nearest first. This renders nothing
+  // the user sees, but it leaves decoders seeked and caches warm at the position playback will
+  // start from, so the first frames after pressing play in either direction don't wait on a
+  // decoder seek.
+  static const int kPreRollFrames = 3;
+
+  const rational &playhead = GetConnectedNode()->GetPlayhead();
+
+  preroll_times_.clear();
+
+  for (int i=1; i<=kPreRollFrames; i++) {
+    rational offset = timebase() * rational(i);
+
+    rational ahead = playhead + offset;
+    if (FrameExistsAtTime(ahead)) {
+      preroll_times_.push_back(ahead);
+    }
+
+    rational behind = playhead - offset;
+    if (FrameExistsAtTime(behind)) {
+      preroll_times_.push_back(behind);
+    }
+  }
+
+  RequestNextPreRollFrame();
+}
+
+void ViewerWidget::RequestNextPreRollFrame()
+{
+  if (!GetConnectedNode() || IsPlaying() || preroll_times_.empty()) {
+    return;
+  }
+
+  // The cacher only holds one queued single-frame render at a time, so pre-roll frames are
+  // requested one by one as each finishes rather than all at once
+  rational t = preroll_times_.front();
+  preroll_times_.pop_front();
+
+  RenderTicketWatcher *watcher = new RenderTicketWatcher(this);
+  connect(watcher, &RenderTicketWatcher::Finished, this, &ViewerWidget::PreRollFrameFinished);
+  preroll_watchers_.append(watcher);
+  watcher->SetTicket(GetSingleFrame(t, true));
+}
+
+void ViewerWidget::PreRollFrameFinished()
+{
+  RenderTicketWatcher *w = static_cast<RenderTicketWatcher*>(sender());
+
+  if (preroll_watchers_.contains(w)) {
+    preroll_watchers_.removeOne(w);
+    RequestNextPreRollFrame();
+  }
+
+  w->deleteLater();
+}
+
 void ViewerWidget::SaveFrameAsImage()
 {
   Core::instance()->OpenExportDialogForViewer(GetConnectedNode(), true);
@@ -763,6 +849,11 @@ void ViewerWidget::ReceivedAudioBufferForPlayback()
           samples.reverse();
         }
 
+        // Meter the same samples that will be pushed to the output device
+        LoudnessAnalyzer *meter = AudioManager::instance()->loudness_meter();
+        meter->SetParams(samples.audio_params());
+        meter->PushSamples(samples);
+
         // Convert to packed data for audio output
         AudioProcessor::Buffer buf;
         int r = audio_processor_.Convert(samples.to_raw_ptrs().data(), samples.sample_count(), &buf);
@@ -856,6 +947,53 @@ void ViewerWidget::QueueNoLongerStarved()
   queue_starved_start_ = 0;
 }
 
+void ViewerWidget::FrameSkippedDuringPlayback()
+{
+  // Number of skipped frames we tolerate before dropping quality, so a single hiccup (e.g. from
+  // a window resize) doesn't cost the user resolution
+  static const int kSkipsBeforeQualityDrop = 5;
+
+  if (!IsPlaying() || !OLIVE_CONFIG("AdaptivePlaybackQuality").toBool()) {
+    return;
+  }
+
+  adaptive_skip_count_++;
+  if (adaptive_skip_count_ < kSkipsBeforeQualityDrop) {
+    return;
+  }
+  adaptive_skip_count_ = 0;
+
+  // Step up to the next supported divider from whatever we're currently rendering at
+  int current = adaptive_divider_ ? adaptive_divider_ : GetConnectedNode()->GetVideoParams().divider();
+  int next_divider = 0;
+  foreach (int d, VideoParams::kSupportedDividers) {
+    if (d > current) {
+      next_divider = d;
+      break;
+    }
+  }
+  if (!next_divider) {
+    // Already at the lowest resolution we support
+    return;
+  }
+
+  adaptive_divider_ = next_divider;
+  RenderManager::instance()->GetCacher()->SetDividerOverride(adaptive_divider_);
+
+  // Re-request the queue so the cheaper frames take effect immediately
+  ForceRequeueFromCurrentTime();
+}
+
+void ViewerWidget::ResetAdaptiveQuality()
+{
+  adaptive_skip_count_ = 0;
+
+  if (adaptive_divider_) {
+    adaptive_divider_ = 0;
+    RenderManager::instance()->GetCacher()->SetDividerOverride(0);
+  }
+}
+
 void ViewerWidget::ForceRequeueFromCurrentTime()
 {
   // Allow half a second for requeue to complete
@@ -905,6 +1043,9 @@ void ViewerWidget::UpdateTextureFromNode()
     DetectMulticamNode(time);
 
     watcher->SetTicket(GetFrame(time));
+
+    // Once this seek settles, warm the frames around the new position - see PreRollAtPlayhead()
+    preroll_timer_.start();
   } else {
     // There is definitely no frame here, we can immediately flip to showing nothing
     nonqueue_watchers_.clear();
@@ -954,6 +1095,11 @@ void ViewerWidget::PlayInternal(int speed, bool in_to_out_only)
     }
   }
 
+  // Abandon any paused pre-roll - its job is done once playback actually starts
+  preroll_timer_.stop();
+  preroll_times_.clear();
+  preroll_watchers_.clear();
+
   playback_speed_ = speed;
   play_in_to_out_only_ = in_to_out_only;
 
@@ -984,6 +1130,9 @@ void ViewerWidget::PlayInternal(int speed, bool in_to_out_only)
   if (ap.is_valid()) {
     UpdateAudioProcessor();
 
+    // Integrated loudness is measured per playback session
+    AudioManager::instance()->loudness_meter()->Reset();
+
     AudioManager::instance()->SetOutputNotifyInterval(audio_processor_.to().time_to_bytes(kAudioPlaybackInterval));
     connect(AudioManager::instance(), &AudioManager::OutputNotify, this, &ViewerWidget::QueueNextAudioBuffer);
 
@@ -1014,6 +1163,9 @@ void ViewerWidget::PauseInternal()
     playback_speed_ = 0;
     controls_->ShowPlayButton();
 
+    // Playback is over, so restore full preview quality
+    ResetAdaptiveQuality();
+
     foreach (ViewerDisplayWidget *dw, playback_devices_){
       dw->Pause();
     }
@@ -1063,10 +1215,19 @@ void ViewerWidget::PushScrubbedAudio()
         // NOTE: Hardcoded scrubbing interval (20ms)
         rational interval = rational(20, 1000);
 
+        // Cancel any scrub windows still pending - only the latest playhead position is worth
+        // hearing, and rendering stale ones just delays it
+        for (RenderTicketWatcher *stale : audio_scrub_watchers_) {
+          stale->Cancel();
+        }
+
         RenderTicketWatcher *watcher = new RenderTicketWatcher();
         connect(watcher, &RenderTicketWatcher::Finished, this, &ViewerWidget::ReceivedAudioBufferForScrubbing);
         audio_scrub_watchers_.push_back(watcher);
-        watcher->SetTicket(RenderManager::instance()->GetCacher()->GetRangeOfAudio(GetConnectedNode(), TimeRange(GetConnectedNode()->GetPlayhead(), GetConnectedNode()->GetPlayhead() + interval)));
+
+        // Prioritized so the window jumps ahead of queued waveform/cache audio jobs - scrubbed
+        // audio is only useful if it reaches the ear almost immediately
+        watcher->SetTicket(RenderManager::instance()->GetCacher()->GetRangeOfAudio(GetConnectedNode(), TimeRange(GetConnectedNode()->GetPlayhead(), GetConnectedNode()->GetPlayhead() + interval), true));
       }
     }
   }
@@ -1112,6 +1273,15 @@ bool ViewerWidget::ViewerMightBeAStill()
 
 void ViewerWidget::SetDisplayImage(RenderTicketPtr ticket)
 {
+  QString profile_text;
+  if (ticket && ticket->property("profiler_shader_ms").isValid()) {
+    profile_text = tr("decode %1 ms | shader %2 ms | download %3 ms | vram %4 MB")
+        .arg(QString::number(ticket->property("profiler_decode_ms").toDouble(), 'f', 2),
+             QString::number(ticket->property("profiler_shader_ms").toDouble(), 'f', 2),
+             QString::number(ticket->property("profiler_download_ms").toDouble(), 'f', 2),
+             QString::number(ticket->property("profiler_vram_mb").toDouble(), 'f', 1));
+  }
+
   foreach (ViewerDisplayWidget *dw, playback_devices_) {
     QVariant push;
     if (ticket) {
@@ -1121,6 +1291,7 @@ void ViewerWidget::SetDisplayImage(RenderTicketPtr ticket)
         push = ticket->Get();
       }
     }
+    dw->SetRenderProfileText(profile_text);
     dw->SetImage(push);
   }
 }
@@ -1138,6 +1309,7 @@ RenderTicketWatcher *ViewerWidget::RequestNextFrameForQueue(bool increment)
     }
 
     watcher = new RenderTicketWatcher();
+    watcher->setProperty("start", QDateTime::currentMSecsSinceEpoch());
     watcher->setProperty("time", QVariant::fromValue(next_time));
     DetectMulticamNode(next_time);
     connect(watcher, &RenderTicketWatcher::Finished, this, &ViewerWidget::RendererGeneratedFrameForQueue);
@@ -1152,7 +1324,13 @@ RenderTicketPtr ViewerWidget::GetFrame(const rational &t)
 {
   QString cache_fn = GetConnectedNode()->video_frame_cache()->GetValidCacheFilename(t);
 
-  if (!QFileInfo::exists(cache_fn)) {
+  bool cached = QFileInfo::exists(cache_fn);
+
+  if (PerformanceLog *perf = PerformanceLog::instance()) {
+    perf->RecordCacheQuery(cached);
+  }
+
+  if (!cached) {
     // Frame hasn't been cached, start render job
     return GetSingleFrame(t);
   } else {
@@ -1216,8 +1394,17 @@ int ViewerWidget::DeterminePlaybackQueueSize()
 
   int remaining_frames = (end_ts - GetTimestamp() - 1) / playback_speed_;
 
+  // Scale the look-ahead with how long frames are actually taking to render, so effect-heavy
+  // sections get a deeper buffer while simple ones don't hold frames they don't need
+  double interval = kVideoPlaybackInterval.toDouble();
+  if (average_frame_render_ms_ > 0) {
+    interval = std::clamp(average_frame_render_ms_ * 2.0 / 1000.0,
+                          kMinVideoPlaybackInterval.toDouble(),
+                          kMaxVideoPlaybackInterval.toDouble());
+  }
+
   // Generate maximum queue
-  int max_frames = qCeil(kVideoPlaybackInterval.toDouble() / timebase().toDouble());
+  int max_frames = qCeil(interval / timebase().toDouble());
 
   return qMin(max_frames, remaining_frames);
 }
@@ -1296,6 +1483,18 @@ void ViewerWidget::RendererGeneratedFrameForQueue()
     queue_watchers_.removeOne(watcher);
 
     if (watcher->HasResult()) {
+      // Fold this frame's wall time into the average used to size the look-ahead. This includes
+      // time spent waiting on the render pool, which is what we want - it reflects how far ahead
+      // we have to request frames for them to arrive by their deadline.
+      if (qint64 start = watcher->property("start").toLongLong()) {
+        double elapsed = QDateTime::currentMSecsSinceEpoch() - start;
+        if (average_frame_render_ms_ > 0) {
+          average_frame_render_ms_ = average_frame_render_ms_ * 0.9 + elapsed * 0.1;
+        } else {
+          average_frame_render_ms_ = elapsed;
+        }
+      }
+
       QVariant frame = watcher->Get();
 
       // Ignore this signal if we've paused now
@@ -1500,6 +1699,13 @@ void ViewerWidget::ShowContextMenu(const QPoint &pos)
     connect(show_fps_action, &QAction::triggered, display_widget_, &ViewerDisplayWidget::SetShowFPS);
   }
 
+  {
+    QAction* show_pacing_action = menu.addAction(tr("Show Frame Pacing"));
+    show_pacing_action->setCheckable(true);
+    show_pacing_action->setChecked(display_widget_->GetShowPacing());
+    connect(show_pacing_action, &QAction::triggered, display_widget_, &ViewerDisplayWidget::SetShowPacing);
+  }
+
   if (context_menu_widget_ == display_widget_) {
     auto subtitle_menu = new Menu(tr("Subtitles"), &menu);
     menu.addMenu(subtitle_menu);
@@ -298,10 +298,25 @@ private:
 
   QTimer playback_backup_timer_;
 
+  /**
+   * @brief Fires shortly after the paused playhead settles to warm the frames around it
+   *
+   * See PreRollAtPlayhead() - restarted on every paused seek so scrubbing doesn't trigger it.
+   */
+  QTimer preroll_timer_;
+
+  std::list<rational> preroll_times_;
+  QVector<RenderTicketWatcher*> preroll_watchers_;
+
   int64_t playback_queue_next_frame_;
   int64_t dry_run_next_frame_;
   QVector<ViewerDisplayWidget*> playback_devices_;
 
+  /**
+   * @brief Texture hand-off so displays fed the same frames only upload each frame once
+   */
+  ViewerTextureShare texture_share_;
+
   bool prequeuing_video_;
   int prequeuing_audio_;
 
@@ -334,6 +349,18 @@ private:
   qint64 queue_starved_start_;
   RenderTicketWatcher *first_requeue_watcher_;
 
+  // Adaptive playback quality state - see FrameSkippedDuringPlayback()
+  int adaptive_divider_;
+  int adaptive_skip_count_;
+
+  /**
+   * @brief Smoothed wall time of recent playback frame renders in milliseconds
+   *
+   * Used by DeterminePlaybackQueueSize() to size the look-ahead. 0 means nothing has been
+   * measured yet.
+   */
+  double average_frame_render_ms_;
+
   bool enable_audio_scrubbing_;
 
   WaveformMode waveform_mode_;
@@ -397,6 +424,16 @@ private slots:
   void QueueStarved();
   void QueueNoLongerStarved();
 
+  /**
+   * @brief Feedback controller for adaptive playback quality
+   *
+   * On sustained deadline misses during playback, raises the divider used for interactive
+   * frames so subsequent tickets render faster. Full quality is restored when playback stops.
+   */
+  void FrameSkippedDuringPlayback();
+
+  void ResetAdaptiveQuality();
+
   void ForceRequeueFromCurrentTime();
 
   void UpdateAudioProcessor();
@@ -411,6 +448,12 @@ private slots:
 
   void RequestNextDryRun();
 
+  void PreRollAtPlayhead();
+
+  void RequestNextPreRollFrame();
+
+  void PreRollFrameFinished();
+
   void SaveFrameAsImage();
 
   void DetectMulticamNodeNow();
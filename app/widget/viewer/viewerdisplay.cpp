@@ -33,9 +33,11 @@
 #include <QPushButton>
 #include <QScreen>
 #include <QTextEdit>
+#include <QWindow>
 
 #include "common/define.h"
 #include "common/html.h"
+#include "common/performancelog.h"
 #include "common/qtutils.h"
 #include "config/config.h"
 #include "core.h"
@@ -52,7 +54,7 @@ namespace olive {
 
 ViewerDisplayWidget::ViewerDisplayWidget(QWidget *parent) :
   super(parent),
-  deinterlace_texture_(nullptr),
+  texture_share_(nullptr),
   signal_cursor_color_(false),
   gizmos_(nullptr),
   current_gizmo_(nullptr),
@@ -63,6 +65,11 @@ ViewerDisplayWidget::ViewerDisplayWidget(QWidget *parent) :
   deinterlace_(false),
   show_fps_(false),
   frames_skipped_(0),
+  show_pacing_(false),
+  pacing_history_count_(0),
+  pacing_last_present_(0),
+  pacing_on_time_(0),
+  pacing_late_(0),
   show_widget_background_(false),
   playback_speed_(0),
   push_mode_(kPushNull),
@@ -78,6 +85,9 @@ ViewerDisplayWidget::ViewerDisplayWidget(QWidget *parent) :
   const int kFrameRateAverageCount = 8;
   frame_rate_averages_.resize(kFrameRateAverageCount);
 
+  const int kPacingHistorySize = 120;
+  pacing_history_ms_.resize(kPacingHistorySize);
+
   inner_widget()->setAcceptDrops(true);
 }
 
@@ -155,14 +165,6 @@ void ViewerDisplayWidget::SetDeinterlacing(bool e)
 {
   deinterlace_ = e;
 
-  if (!deinterlace_) {
-    if (!deinterlace_shader_.isNull()) {
-      renderer()->DestroyNativeShader(deinterlace_shader_);
-      deinterlace_shader_.clear();
-    }
-    deinterlace_texture_ = nullptr;
-  }
-
   update();
 }
 
@@ -247,6 +249,11 @@ void ViewerDisplayWidget::ResetFPSTimer()
   frames_skipped_ = 0;
   frame_rate_average_count_ = 0;
 
+  pacing_history_count_ = 0;
+  pacing_last_present_ = 0;
+  pacing_on_time_ = 0;
+  pacing_late_ = 0;
+
   Core::instance()->ClearStatusBarMessage();
 }
 
@@ -254,7 +261,13 @@ void ViewerDisplayWidget::IncrementSkippedFrames()
 {
   frames_skipped_++;
 
+  if (PerformanceLog *perf = PerformanceLog::instance()) {
+    perf->RecordDroppedFrame();
+  }
+
   Core::instance()->ShowStatusBarMessage(tr("%n skipped frame(s) detected during playback", nullptr, frames_skipped_), 10000);
+
+  emit FrameSkipped();
 }
 
 bool ViewerDisplayWidget::eventFilter(QObject *o, QEvent *e)
@@ -383,16 +396,26 @@ void ViewerDisplayWidget::OnPaint()
       DrawBlank(device_params);
     } else if (color_service()) {
       if (FramePtr frame = load_frame_.value<FramePtr>()) {
-        // This is a CPU frame, upload it now
-        if (!texture_
-            || texture_->renderer() != renderer() // Some implementations don't like it if we upload to a texture created in another (albeit shared) context
-            || texture_->width() != frame->width()
-            || texture_->height() != frame->height()
-            || texture_->format() != frame->format()
-            || texture_->channel_count() != frame->channel_count()) {
-          texture_ = renderer()->CreateTexture(frame->video_params(), frame->data(), frame->linesize_pixels());
+        TexturePtr shared = texture_share_ ? texture_share_->Get(frame) : nullptr;
+        if (shared) {
+          // Another display sharing our context already uploaded this frame, draw it directly
+          texture_ = shared;
         } else {
-          texture_->Upload(frame->data(), frame->linesize_pixels());
+          // This is a CPU frame, upload it now
+          if (!texture_
+              || texture_->renderer() != renderer() // Some implementations don't like it if we upload to a texture created in another (albeit shared) context
+              || texture_->width() != frame->width()
+              || texture_->height() != frame->height()
+              || texture_->format() != frame->format()
+              || texture_->channel_count() != frame->channel_count()) {
+            texture_ = renderer()->CreateTexture(frame->video_params(), frame->data(), frame->linesize_pixels());
+          } else {
+            texture_->Upload(frame->data(), frame->linesize_pixels());
+          }
+
+          if (texture_share_) {
+            texture_share_->Push(frame, texture_);
+          }
         }
       } else if (TexturePtr texture = load_frame_.value<TexturePtr>()) {
         // This is a GPU texture, switch to it directly
@@ -410,26 +433,6 @@ void ViewerDisplayWidget::OnPaint()
       if (!texture_to_draw || texture_to_draw->IsDummy()) {
         DrawBlank(device_params);
       } else {
-        if (deinterlace_) {
-          if (deinterlace_shader_.isNull()) {
-            deinterlace_shader_ = renderer()->CreateNativeShader(ShaderCode(FileFunctions::ReadFileAsString(QStringLiteral(":/shaders/deinterlace.frag"))));
-          }
-
-          if (!deinterlace_texture_
-              || deinterlace_texture_->params() != texture_to_draw->params()) {
-            // (Re)create texture
-            deinterlace_texture_ = renderer()->CreateTexture(texture_to_draw->params());
-          }
-
-          ShaderJob job;
-          job.Insert(QStringLiteral("resolution_in"), NodeValue(NodeValue::kVec2, QVector2D(texture_to_draw->width(), texture_to_draw->height())));
-          job.Insert(QStringLiteral("ove_maintex"), NodeValue(NodeValue::kTexture, QVariant::fromValue(texture_to_draw)));
-
-          renderer()->BlitToTexture(deinterlace_shader_, job, deinterlace_texture_.get());
-
-          texture_to_draw = deinterlace_texture_;
-        }
-
         ColorTransformJob ctj;
         ctj.SetColorProcessor(color_service());
         ctj.SetInputTexture(texture_to_draw);
@@ -439,6 +442,13 @@ void ViewerDisplayWidget::OnPaint()
         ctj.SetCropMatrix(crop_matrix_);
         ctj.SetForceOpaque(true);
 
+        if (deinterlace_) {
+          // Fuse deinterlacing into the display transform pass rather than writing and
+          // re-reading a full-resolution intermediate texture
+          ctj.SetShaderStub(QStringLiteral(":/shaders/deinterlacecolormanage.frag"));
+          ctj.Insert(QStringLiteral("resolution_in"), NodeValue(NodeValue::kVec2, QVector2D(texture_to_draw->width(), texture_to_draw->height())));
+        }
+
         renderer()->BlitColorManaged(ctj, device_params);
       }
     }
@@ -532,13 +542,67 @@ void ViewerDisplayWidget::OnPaint()
 
       DrawTextWithCrudeShadow(&p, GetInnerRect(), tr("%1 FPS").arg(QString::number(average, 'f', 1)));
 
+      int hud_line = 1;
+
       if (frames_skipped_ > 0) {
-        DrawTextWithCrudeShadow(&p, GetInnerRect().adjusted(0, p.fontMetrics().height(), 0, 0),
+        DrawTextWithCrudeShadow(&p, GetInnerRect().adjusted(0, p.fontMetrics().height() * hud_line, 0, 0),
                                 tr("%1 frames skipped").arg(frames_skipped_));
+        hud_line++;
+      }
+
+      if (!render_profile_text_.isEmpty()) {
+        DrawTextWithCrudeShadow(&p, GetInnerRect().adjusted(0, p.fontMetrics().height() * hud_line, 0, 0),
+                                render_profile_text_);
       }
     }
   }
 
+  if (show_pacing_ && pacing_history_count_ > 0) {
+    QPainter p(paint_device());
+
+    QRect inner = GetInnerRect();
+
+    // One bar per recorded presentation interval along the bottom edge, like a game
+    // frame-time graph: the dotted line is the target frame time, bars that cross it are
+    // frames that were presented late
+    const int kGraphHeight = 48;
+    double target_ms = playback_timebase_.toDouble() * 1000.0;
+
+    int bar_count = qMin(pacing_history_count_, int(pacing_history_ms_.size()));
+    int graph_bottom = inner.bottom();
+    double bar_width = double(inner.width()) / double(pacing_history_ms_.size());
+
+    for (int i=0; i<bar_count; i++) {
+      // Oldest to newest, left to right
+      int index = (pacing_history_count_ - bar_count + i) % pacing_history_ms_.size();
+      int interval = pacing_history_ms_.at(index);
+
+      // Target frame time reaches half the graph height
+      int h = qMin(kGraphHeight, int(double(interval) / target_ms * (kGraphHeight / 2)));
+
+      QColor color;
+      if (interval <= target_ms * 1.5) {
+        color = Qt::green;
+      } else if (interval <= target_ms * 3.0) {
+        color = Qt::yellow;
+      } else {
+        color = Qt::red;
+      }
+
+      p.fillRect(QRectF(inner.left() + i * bar_width, graph_bottom - h, qMax(1.0, bar_width - 1.0), h), color);
+    }
+
+    p.setPen(QPen(Qt::white, 0, Qt::DotLine));
+    p.drawLine(inner.left(), graph_bottom - kGraphHeight / 2, inner.right(), graph_bottom - kGraphHeight / 2);
+
+    DrawTextWithCrudeShadow(&p,
+                            inner.adjusted(0, 0, 0, -kGraphHeight),
+                            tr("%1 on time / %2 late / %3 skipped").arg(QString::number(pacing_on_time_),
+                                                                        QString::number(pacing_late_),
+                                                                        QString::number(frames_skipped_)),
+                            QTextOption(Qt::AlignLeft | Qt::AlignBottom));
+  }
+
   // Extraordinarily basic subtitle renderer. Hoping to swap this out with libass at some point.
   DrawSubtitleTracks();
 
@@ -554,19 +618,19 @@ void ViewerDisplayWidget::OnPaint()
 
 void ViewerDisplayWidget::OnDestroy()
 {
-  if (!deinterlace_shader_.isNull()) {
-    renderer()->DestroyNativeShader(deinterlace_shader_);
-    deinterlace_shader_.clear();
-  }
   if (!blank_shader_.isNull()) {
     renderer()->DestroyNativeShader(blank_shader_);
     blank_shader_.clear();
   }
 
+  // Don't leave other displays drawing a texture whose context is going away
+  if (texture_share_ && texture_share_->GetTexture() && texture_share_->GetTexture()->renderer() == renderer()) {
+    texture_share_->Clear();
+  }
+
   super::OnDestroy();
 
   texture_ = nullptr;
-  deinterlace_texture_ = nullptr;
   if (load_frame_.isNull()) {
     push_mode_ = kPushNull;
   } else {
@@ -684,23 +748,8 @@ NodeGizmo *ViewerDisplayWidget::TryGizmoPress(const NodeValueRow &row, const QPo
 
   for (auto it=gizmos_->GetGizmos().crbegin(); it!=gizmos_->GetGizmos().crend(); it++) {
     NodeGizmo *gizmo = *it;
-    if (gizmo->IsVisible()) {
-      if (PointGizmo *point = dynamic_cast<PointGizmo*>(gizmo)) {
-        if (point->GetClickingRect(gizmo_last_draw_transform_).contains(p)) {
-          return point;
-        }
-      } else if (PolygonGizmo *poly = dynamic_cast<PolygonGizmo*>(gizmo)) {
-        if (poly->GetPolygon().containsPoint(p, Qt::OddEvenFill)) {
-          return poly;
-        }
-      } else if (PathGizmo *path = dynamic_cast<PathGizmo*>(gizmo)) {
-        if (path->GetPath().contains(p)) {
-          return path;
-        }
-      } else if (ScreenGizmo *screen = dynamic_cast<ScreenGizmo*>(gizmo)) {
-        // NOTE: Perhaps this should limit to the actual visible screen space? We'll see.
-        return screen;
-      }
+    if (gizmo->IsVisible() && gizmo->HitTest(p, gizmo_last_draw_transform_)) {
+      return gizmo;
     }
   }
 
@@ -1038,8 +1087,6 @@ void ViewerDisplayWidget::DrawSubtitleTracks()
     return;
   }
 
-  QPainterPath path;
-
   QTransform transform = GenerateWorldTransform();
   QRect bounding_box = transform.mapRect(rect());
 
@@ -1055,55 +1102,68 @@ void ViewerDisplayWidget::DrawSubtitleTracks()
 
   bounding_box.adjust(bounding_box.width()/10, bounding_box.height()/10, -bounding_box.width()/10, -bounding_box.height()/10);
 
-  QFontMetrics fm(f);
-
+  // Collect the visible text before doing any shaping so we can key the raster cache - during
+  // playback the same subtitle is typically visible for dozens of frames in a row
+  QStringList visible_text;
   for (int j=subtitle_tracklist.size()-1; j>=0; j--) {
     Track *sub_track = subtitle_tracklist.at(j);
     if (!sub_track->IsMuted()) {
       if (SubtitleBlock *sub = dynamic_cast<SubtitleBlock*>(sub_track->VisibleBlockAtTime(time_))) {
-        // Split into lines
-        QStringList list = QtUtils::WordWrapString(sub->GetText(), fm, bounding_box.width());
-
-        for (int i=list.size()-1; i>=0; i--) {
-          int w = QtUtils::QFontMetricsWidth(fm, list.at(i));
-          path.addText(bounding_box.width()/2 - w/2, bounding_box.height() - fm.height() * (list.size() - i) + fm.ascent(), f, list.at(i));
-        }
+        visible_text.append(sub->GetText());
       }
     }
   }
 
-  bool antialias = OLIVE_CONFIG("AntialiasSubtitles").toBool();
-
-  QPixmap *aa_pixmap;
-  QPainter *text_painter;
-  if (antialias) {
-    // QPainter only supports anti-aliasing in software, so to achieve it, we draw to a
-    // software buffer first and then draw that onto the hardware
-    aa_pixmap = new QPixmap(bounding_box.width(), bounding_box.height());
-    aa_pixmap->fill(Qt::transparent);
-    text_painter = new QPainter(aa_pixmap);
-  } else {
-    // Just draw straight to the hardware
-    text_painter = new QPainter(paint_device());
-
-    // Offset path by however much is necessary
-    path.translate(bounding_box.x(), bounding_box.y());
+  if (visible_text.isEmpty()) {
+    subtitle_cache_key_.clear();
+    return;
   }
 
-  text_painter->setPen(QPen(Qt::black, f.pointSizeF() / 16));
-  text_painter->setBrush(Qt::white);
-  text_painter->setRenderHint(QPainter::Antialiasing);
+  bool antialias = OLIVE_CONFIG("AntialiasSubtitles").toBool();
 
-  text_painter->drawPath(path);
+  QString cache_key = QStringLiteral("%1|%2|%3|%4x%5|%6|").arg(f.family(),
+                                                               QString::number(f.pointSizeF()),
+                                                               QString::number(f.weight()),
+                                                               QString::number(bounding_box.width()),
+                                                               QString::number(bounding_box.height()),
+                                                               QString::number(antialias));
+  cache_key.append(visible_text.join(QLatin1Char('\x1f')));
+
+  if (cache_key != subtitle_cache_key_) {
+    QFontMetrics fm(f);
+    QPainterPath path;
+
+    foreach (const QString &text, visible_text) {
+      // Split into lines
+      QStringList list = QtUtils::WordWrapString(text, fm, bounding_box.width());
+
+      for (int i=list.size()-1; i>=0; i--) {
+        int w = QtUtils::QFontMetricsWidth(fm, list.at(i));
+        path.addText(bounding_box.width()/2 - w/2, bounding_box.height() - fm.height() * (list.size() - i) + fm.ascent(), f, list.at(i));
+      }
+    }
+
+    if (subtitle_cache_pixmap_.size() != bounding_box.size()) {
+      subtitle_cache_pixmap_ = QPixmap(bounding_box.width(), bounding_box.height());
+    }
+    subtitle_cache_pixmap_.fill(Qt::transparent);
+
+    QPainter text_painter(&subtitle_cache_pixmap_);
+    text_painter.setPen(QPen(Qt::black, f.pointSizeF() / 16));
+    text_painter.setBrush(Qt::white);
+    if (antialias) {
+      // QPainter only supports anti-aliasing in software, which is why we render to a pixmap
+      // rather than the hardware device
+      text_painter.setRenderHint(QPainter::Antialiasing);
+    }
 
-  delete text_painter;
+    text_painter.drawPath(path);
 
-  if (antialias) {
-    // We just drew to a software buffer, now draw this image onto the hardware device
-    QPainter p(paint_device());
-    p.drawPixmap(bounding_box.x(), bounding_box.y(), *aa_pixmap);
-    delete aa_pixmap;
+    subtitle_cache_key_ = cache_key;
   }
+
+  QPainter p(paint_device());
+  p.drawPixmap(bounding_box.x(), bounding_box.y(), subtitle_cache_pixmap_);
 }
 
 template <typename T>
@@ -1251,6 +1311,30 @@ void ViewerDisplayWidget::SetShowFPS(bool e)
   update();
 }
 
+void ViewerDisplayWidget::SetShowPacing(bool e)
+{
+  show_pacing_ = e;
+
+  update();
+}
+
+void ViewerDisplayWidget::RecordPresentedFrame(bool on_time)
+{
+  qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+  if (pacing_last_present_ > 0) {
+    pacing_history_ms_[pacing_history_count_ % pacing_history_ms_.size()] = int(now - pacing_last_present_);
+    pacing_history_count_++;
+  }
+  pacing_last_present_ = now;
+
+  if (on_time) {
+    pacing_on_time_++;
+  } else {
+    pacing_late_++;
+  }
+}
+
 void ViewerDisplayWidget::RequestStartEditingText()
 {
   if (gizmos_) {
@@ -1283,6 +1367,18 @@ void ViewerDisplayWidget::Pause()
 
   queue_.clear();
   queue_starved_ = false;
+
+  // Session summary: turns "it feels stuttery" reports into numbers
+  int presented = pacing_on_time_ + pacing_late_;
+  if (presented > 0) {
+    qInfo() << "Playback pacing:" << presented << "frames presented,"
+            << pacing_on_time_ << "on time," << pacing_late_ << "late,"
+            << frames_skipped_ << "skipped, target frame time"
+            << playback_timebase_.toDouble() * 1000.0 << "ms";
+
+    pacing_on_time_ = 0;
+    pacing_late_ = 0;
+  }
 }
 
 QPointF ViewerDisplayWidget::ScreenToScenePoint(const QPoint &p)
@@ -1296,7 +1392,21 @@ QPointF ViewerDisplayWidget::ScreenToScenePoint(const QPoint &p)
 
 void ViewerDisplayWidget::UpdateFromQueue()
 {
-  int64_t t = timer_.GetTimestampNow();
+  // With vsync on, a frame submitted now isn't seen until the next refresh, so judge the queue
+  // against that moment instead of the present. This keeps a steady 3:2 cadence for 24p on a
+  // 60Hz display, where judging against "now" flaps between two and three refreshes whenever a
+  // frame boundary drifts close to a vsync.
+  qint64 lookahead_ms = 0;
+  if (QWindow *win = window()->windowHandle()) {
+    if (QScreen *screen = win->screen()) {
+      qreal refresh = screen->refreshRate();
+      if (refresh > 0) {
+        lookahead_ms = qRound(500.0 / refresh);
+      }
+    }
+  }
+
+  int64_t t = timer_.GetTimestampNow(lookahead_ms);
 
   rational time = Timecode::timestamp_to_time(t, playback_timebase_);
 
@@ -1306,12 +1416,16 @@ void ViewerDisplayWidget::UpdateFromQueue()
     queue_starved_ = true;
     emit QueueStarved();
   } else {
+    ViewerPlaybackFrame late_frame;
+    bool have_late_frame = false;
+
     while (!queue_.empty()) {
       const ViewerPlaybackFrame& pf = queue_.front();
 
       if (pf.timestamp == time) {
 
         // Frame was in queue, no need to decode anything
+        RecordPresentedFrame(true);
         SetImage(pf.frame);
 
         if (queue_starved_) {
@@ -1328,6 +1442,10 @@ void ViewerDisplayWidget::UpdateFromQueue()
 
       } else {
 
+        // Frame has missed its deadline, remember it in case nothing on time arrives
+        late_frame = pf;
+        have_late_frame = true;
+
         queue_.pop_front();
 
         if (popped) {
@@ -1347,6 +1465,21 @@ void ViewerDisplayWidget::UpdateFromQueue()
 
       }
     }
+
+    if (have_late_frame) {
+      // The frame for this exact deadline never arrived, but something newer than what's on
+      // screen did. Showing the newest late frame keeps motion at a steady, if reduced, cadence
+      // when the renderer can't keep up, instead of freezing until an exact match comes in.
+      RecordPresentedFrame(false);
+      SetImage(late_frame.frame);
+
+      if (queue_starved_ && !queue_.empty()) {
+        queue_starved_ = false;
+        emit QueueNoLongerStarved();
+      }
+
+      return;
+    }
   }
 
   update();
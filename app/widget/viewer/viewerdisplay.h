@@ -22,6 +22,7 @@
 #define VIEWERGLWIDGET_H
 
 #include <QMatrix4x4>
+#include <QPixmap>
 #include <QRubberBand>
 
 #include "node/color/colormanager/colormanager.h"
@@ -39,6 +40,48 @@
 
 namespace olive {
 
+/**
+ * @brief Hand-off point for textures uploaded from CPU frames
+ *
+ * When several displays are fed the same frames (the Viewer panel plus one or more fullscreen
+ * ViewerWindows), each one used to upload the frame into its own texture. Since their GL
+ * contexts are shared, the first display to paint a frame can publish its uploaded texture here
+ * and the others draw it directly, leaving them only their own color transform blit.
+ *
+ * All access happens on the GUI thread during painting, so no locking is necessary.
+ */
+class ViewerTextureShare
+{
+public:
+  TexturePtr Get(const FramePtr &frame) const
+  {
+    return (frame == frame_) ? texture_ : nullptr;
+  }
+
+  const TexturePtr &GetTexture() const
+  {
+    return texture_;
+  }
+
+  void Push(const FramePtr &frame, const TexturePtr &texture)
+  {
+    frame_ = frame;
+    texture_ = texture;
+  }
+
+  void Clear()
+  {
+    frame_ = nullptr;
+    texture_ = nullptr;
+  }
+
+private:
+  FramePtr frame_;
+
+  TexturePtr texture_;
+
+};
+
 /**
  * @brief The inner display/rendering widget of a Viewer class.
  *
@@ -107,11 +150,26 @@ public:
     return show_fps_;
   }
 
+  bool GetShowPacing() const
+  {
+    return show_pacing_;
+  }
+
   bool GetShowSubtitles() const { return show_subtitles_; }
   void SetShowSubtitles(bool e) { show_subtitles_ = e; update(); }
 
   void IncrementSkippedFrames();
 
+  /**
+   * @brief Set the decode/shader/download timing line drawn with the FPS HUD
+   *
+   * Pass an empty string to hide it.
+   */
+  void SetRenderProfileText(const QString &text)
+  {
+    render_profile_text_ = text;
+  }
+
   void IncrementFrameCount()
   {
     fps_timer_update_count_++;
@@ -131,6 +189,14 @@ public:
     return &queue_;
   }
 
+  /**
+   * @brief Set a texture hand-off shared with other displays that are fed the same frames
+   */
+  void SetTextureShare(ViewerTextureShare *share)
+  {
+    texture_share_ = share;
+  }
+
   ViewerPlaybackTimer *timer()
   {
     return &timer_;
@@ -183,6 +249,8 @@ public slots:
 
   void SetShowFPS(bool e);
 
+  void SetShowPacing(bool e);
+
   void RequestStartEditingText();
 
 signals:
@@ -223,6 +291,11 @@ signals:
 
   void QueueNoLongerStarved();
 
+  /**
+   * @brief Signal emitted whenever a frame arrived too late to be shown during playback
+   */
+  void FrameSkipped();
+
   void CreateAddableAt(const QRectF &rect);
 
 protected:
@@ -266,6 +339,11 @@ private:
 
   static void DrawTextWithCrudeShadow(QPainter* painter, const QRect& rect, const QString& text, const QTextOption &opt = QTextOption());
 
+  /**
+   * @brief Record a presented playback frame for the pacing statistics
+   */
+  void RecordPresentedFrame(bool on_time);
+
   rational GetGizmoTime();
 
   bool IsHandDrag(QMouseEvent* event) const;
@@ -313,14 +391,9 @@ private:
   TexturePtr texture_;
 
   /**
-   * @brief Internal texture to deinterlace to
+   * @brief Texture hand-off shared with other displays fed the same frames, if any
    */
-  TexturePtr deinterlace_texture_;
-
-  /**
-   * @brief Deinterlace shader
-   */
-  QVariant deinterlace_shader_;
+  ViewerTextureShare *texture_share_;
 
   /**
    * @brief Blank shader
@@ -367,6 +440,17 @@ private:
   bool show_subtitles_;
   Sequence *subtitle_tracks_;
 
+  /**
+   * @brief Raster of the currently visible subtitles and the state it was rendered from
+   *
+   * Text shaping and rasterization are far too expensive to redo on every paint during
+   * playback, so DrawSubtitleTracks() only re-renders when the visible text, font settings or
+   * bounding box change. Qt keeps the pixmap in its GL texture cache between paints, so
+   * redrawing a cached subtitle costs a single textured quad.
+   */
+  QPixmap subtitle_cache_pixmap_;
+  QString subtitle_cache_key_;
+
   rational time_;
 
   /**
@@ -382,10 +466,27 @@ private:
 
   bool show_fps_;
   int frames_skipped_;
+  QString render_profile_text_;
 
   QVector<double> frame_rate_averages_;
   int frame_rate_average_count_;
 
+  /**
+   * @brief Frame pacing statistics for the current playback session
+   *
+   * Each presented frame is recorded as on time (the frame matching the playback clock was in
+   * the queue) or late (an older frame was shown because the right one never arrived), along
+   * with the wall-clock interval since the previous presentation. The intervals feed the
+   * pacing overlay's frame-time graph; the counters feed its text line and the session
+   * summary logged when playback pauses.
+   */
+  bool show_pacing_;
+  QVector<int> pacing_history_ms_;
+  int pacing_history_count_;
+  qint64 pacing_last_present_;
+  int pacing_on_time_;
+  int pacing_late_;
+
   bool show_widget_background_;
 
   QVariant load_frame_;
@@ -33,9 +33,9 @@ void ViewerPlaybackTimer::Start(const int64_t &start_timestamp, const int &playb
   timebase_ = timebase * 1000;
 }
 
-int64_t ViewerPlaybackTimer::GetTimestampNow() const
+int64_t ViewerPlaybackTimer::GetTimestampNow(qint64 lookahead_ms) const
 {
-  int64_t real_time = QDateTime::currentMSecsSinceEpoch() - start_msec_;
+  int64_t real_time = QDateTime::currentMSecsSinceEpoch() - start_msec_ + lookahead_ms;
 
   int64_t frames_since_start = qFloor(static_cast<double>(real_time) / (timebase_));
 
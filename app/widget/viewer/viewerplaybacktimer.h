@@ -31,7 +31,13 @@ class ViewerPlaybackTimer {
 public:
   void Start(const int64_t& start_timestamp, const int& playback_speed, const double& timebase);
 
-  int64_t GetTimestampNow() const;
+  /**
+   * @brief Timestamp at `lookahead_ms` in the future, in playback timebase units
+   *
+   * The lookahead lets presentation code judge frames against when they will actually reach
+   * the screen rather than when they were submitted.
+   */
+  int64_t GetTimestampNow(qint64 lookahead_ms = 0) const;
 
 private:
   qint64 start_msec_;
@@ -85,6 +85,8 @@ MainWindow::MainWindow(QWidget *parent) :
   AppendTimelinePanel();
   audio_monitor_panel_ = new AudioMonitorPanel();
   scope_panel_ = new ScopePanel();
+  profiler_panel_ = new ProfilerPanel();
+  memory_panel_ = new MemoryPanel();
   history_panel_ = new HistoryPanel();
 
   // HACK: The pixel sampler is closed by default, which signals to Core that
@@ -855,6 +857,8 @@ void MainWindow::SetDefaultLayout()
   task_man_panel_->close();
   curve_panel_->close();
   scope_panel_->close();
+  profiler_panel_->close();
+  memory_panel_->close();
   multicam_panel_->close();
   for (auto it = folder_panels_.cbegin(); it != folder_panels_.cend(); it++) {
     (*it)->close();
@@ -42,6 +42,8 @@
 #include "panel/footageviewer/footageviewer.h"
 #include "panel/sequenceviewer/sequenceviewer.h"
 #include "panel/pixelsampler/pixelsamplerpanel.h"
+#include "panel/profiler/profiler.h"
+#include "panel/memory/memory.h"
 
 #ifdef Q_OS_WINDOWS
 #include <shobjidl.h>
@@ -155,6 +157,8 @@ private:
   AudioMonitorPanel* audio_monitor_panel_;
   TaskManagerPanel* task_man_panel_;
   PixelSamplerPanel* pixel_sampler_panel_;
+  ProfilerPanel* profiler_panel_;
+  MemoryPanel* memory_panel_;
   ScopePanel* scope_panel_;
   QList<ViewerPanel*> viewer_panels_;
   MulticamPanel *multicam_panel_;
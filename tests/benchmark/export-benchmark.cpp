@@ -0,0 +1,204 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+/**
+ * Export throughput benchmark.
+ *
+ * Builds a synthetic project (generator clips on a timeline, no footage on disk so results
+ * are machine-independent) and measures frames per second through two stages:
+ *
+ *   render - the render/download pipeline with frames discarded
+ *   export - the full ExportTask pipeline including encoding to a temporary H.264 file
+ *
+ * Usage: export-benchmark [dummy|opengl] [seconds]
+ *
+ * The "dummy" backend performs no GPU work, isolating the threading/codec half of the
+ * pipeline; "opengl" (the default) measures the real thing. Run it on the same machine
+ * across releases to track regressions.
+ */
+
+#include <cstdio>
+
+#include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+
+#include "config/config.h"
+#include "node/block/clip/clip.h"
+#include "node/generator/noise/noise.h"
+#include "node/project.h"
+#include "node/project/sequence/sequence.h"
+#include "render/framemanager.h"
+#include "render/rendermanager.h"
+#include "task/export/export.h"
+
+namespace olive {
+
+/**
+ * @brief Renders the whole sequence and discards the frames, isolating the render stage
+ */
+class RenderOnlyTask : public RenderTask
+{
+public:
+  RenderOnlyTask(ViewerOutput *viewer, ColorManager *color_manager) :
+    color_manager_(color_manager)
+  {
+    set_viewer(viewer);
+    set_video_params(viewer->GetVideoParams());
+    set_audio_params(viewer->GetAudioParams());
+    SetNativeProgressSignallingEnabled(false);
+  }
+
+protected:
+  virtual bool Run() override
+  {
+    return Render(color_manager_, {TimeRange(0, viewer()->GetLength())}, TimeRangeList(),
+                  TimeRange(), RenderMode::kOnline, nullptr);
+  }
+
+  virtual bool FrameDownloaded(FramePtr frame, const rational &time) override
+  {
+    Q_UNUSED(frame)
+    Q_UNUSED(time)
+    return true;
+  }
+
+  virtual bool AudioDownloaded(const TimeRange &range, const SampleBuffer &samples) override
+  {
+    Q_UNUSED(range)
+    Q_UNUSED(samples)
+    return true;
+  }
+
+private:
+  ColorManager *color_manager_;
+
+};
+
+int RunExportBenchmark(int argc, char **argv)
+{
+  QApplication a(argc, argv);
+
+  QString backend = QStringLiteral("opengl");
+  int seconds = 10;
+
+  if (argc > 1) {
+    backend = QString::fromLocal8Bit(argv[1]);
+    if (backend != QStringLiteral("opengl") && backend != QStringLiteral("dummy")) {
+      fprintf(stderr, "Usage: %s [dummy|opengl] [seconds]\n", argv[0]);
+      return 1;
+    }
+  }
+  if (argc > 2) {
+    seconds = QString::fromLocal8Bit(argv[2]).toInt();
+    if (seconds <= 0) {
+      fprintf(stderr, "Invalid duration: %s\n", argv[2]);
+      return 1;
+    }
+  }
+
+  OLIVE_CONFIG("RenderBackend") = backend;
+
+  ColorManager::SetUpDefaultConfig();
+  FrameManager::CreateInstance();
+  RenderManager::CreateInstance();
+
+  // Build the synthetic project: a noise generator clip spanning the whole benchmark range.
+  // Noise changes every frame, so nothing can be satisfied from caches.
+  Project project;
+  Sequence sequence;
+  sequence.setParent(&project);
+  sequence.add_default_nodes();
+
+  Track *track = sequence.track_list(Track::kVideo)->GetTrackAt(0);
+
+  ClipBlock *clip = new ClipBlock();
+  clip->set_length_and_media_out(seconds);
+  clip->setParent(&project);
+  track->AppendBlock(clip);
+
+  NoiseGeneratorNode *noise = new NoiseGeneratorNode();
+  noise->setParent(&project);
+  Node::ConnectEdge(noise, NodeInput(clip, ClipBlock::kBufferIn));
+
+  const VideoParams &vp = sequence.GetVideoParams();
+  int64_t total_frames = TimeRangeListFrameIterator({TimeRange(0, sequence.GetLength())},
+                                                    vp.frame_rate_as_time_base()).size();
+
+  printf("Export benchmark: %s backend, %dx%d @ %g fps, %d second(s), %lld frame(s)\n",
+         backend.toUtf8().constData(), vp.width(), vp.height(), vp.frame_rate().toDouble(),
+         seconds, static_cast<long long>(total_frames));
+
+  QElapsedTimer timer;
+
+  // Stage 1: render only, frames discarded
+  {
+    RenderOnlyTask render_task(&sequence, project.color_manager());
+
+    timer.start();
+    bool ok = render_task.Start();
+    double elapsed = double(timer.elapsed()) / 1000.0;
+
+    if (!ok) {
+      fprintf(stderr, "Render stage failed: %s\n", render_task.GetError().toUtf8().constData());
+      return 1;
+    }
+
+    printf("  render: %6.1f frames/sec (%.2f sec)\n", double(total_frames) / elapsed, elapsed);
+  }
+
+  // Stage 2: full export pipeline including encoding
+  {
+    QString export_filename = QDir::temp().filePath(QStringLiteral("olive-export-benchmark.mp4"));
+
+    EncodingParams params;
+    params.SetFilename(export_filename);
+    params.set_format(ExportFormat::kFormatMPEG4Video);
+    params.EnableVideo(vp, ExportCodec::kCodecH264);
+    params.set_video_pix_fmt(QStringLiteral("yuv420p"));
+
+    ExportTask export_task(&sequence, project.color_manager(), params);
+
+    timer.start();
+    bool ok = export_task.Start();
+    double elapsed = double(timer.elapsed()) / 1000.0;
+
+    QFile::remove(export_filename);
+
+    if (!ok) {
+      fprintf(stderr, "Export stage failed: %s\n", export_task.GetError().toUtf8().constData());
+      return 1;
+    }
+
+    printf("  export: %6.1f frames/sec (%.2f sec)\n", double(total_frames) / elapsed, elapsed);
+  }
+
+  RenderManager::DestroyInstance();
+  FrameManager::DestroyInstance();
+
+  return 0;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  return olive::RunExportBenchmark(argc, argv);
+}
@@ -0,0 +1,257 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+/**
+ * Render pipeline micro-benchmarks.
+ *
+ * Where export-benchmark measures end-to-end throughput, this measures the unit-level hot
+ * paths underneath it against stable synthetic fixtures:
+ *
+ *   nodevaluetable       - NodeValueTable push/get
+ *   track-block-lookup   - Track::NearestBlockBeforeOrAt over a long track
+ *   nodetraverser-N      - NodeTraverser::GenerateTable over a math chain of N nodes
+ *   waveform-sumsamples  - AudioVisualWaveform::SumSamples over a 10s stereo buffer
+ *   framecache-save/load - FrameHashCache frame serialization round trip
+ *
+ * Usage: micro-benchmark [json-file]
+ *
+ * Results print human-readable to stdout; if a filename is given, they're also written as a
+ * JSON document so numbers can be attached to regression reports.
+ */
+
+extern "C" {
+#include <libavutil/channel_layout.h>
+}
+
+#include <cstdio>
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "audio/audiovisualwaveform.h"
+#include "node/block/gap/gap.h"
+#include "node/math/math/math.h"
+#include "node/output/track/track.h"
+#include "node/project.h"
+#include "node/traverser.h"
+#include "render/framehashcache.h"
+
+namespace olive {
+
+struct BenchResult
+{
+  QString name;
+  qint64 iterations;
+  double ns_per_iter;
+};
+
+QVector<BenchResult> results;
+
+template <typename Func>
+void RunBench(const QString &name, qint64 iterations, Func f)
+{
+  // Warm caches and fault in any lazily initialized state before timing
+  f();
+
+  QElapsedTimer timer;
+  timer.start();
+
+  for (qint64 i=0; i<iterations; i++) {
+    f();
+  }
+
+  double ns_per_iter = double(timer.nsecsElapsed()) / double(iterations);
+
+  printf("  %-24s %12.1f ns/iter (%lld iters)\n",
+         name.toUtf8().constData(), ns_per_iter, static_cast<long long>(iterations));
+
+  results.append({name, iterations, ns_per_iter});
+}
+
+void BenchNodeValueTable()
+{
+  MathNode source;
+
+  RunBench(QStringLiteral("nodevaluetable"), 100000, [&source]{
+    NodeValueTable table;
+
+    for (int i=0; i<8; i++) {
+      table.Push(NodeValue::kFloat, double(i), &source);
+    }
+    table.Push(NodeValue::kFloat, 1.0, &source, QStringLiteral("tagged"));
+
+    table.Get(NodeValue::kFloat);
+    table.Get(NodeValue::kFloat, QStringLiteral("tagged"));
+  });
+}
+
+void BenchTrackBlockLookup()
+{
+  Project project;
+
+  Track *track = new Track();
+  track->setParent(&project);
+
+  const int kBlockCount = 1000;
+  for (int i=0; i<kBlockCount; i++) {
+    GapBlock *gap = new GapBlock();
+    gap->setParent(&project);
+    gap->set_length_and_media_out(1);
+    track->AppendBlock(gap);
+  }
+
+  int query = 0;
+  RunBench(QStringLiteral("track-block-lookup"), 100000, [track, &query]{
+    track->NearestBlockBeforeOrAt(rational(query, 2));
+    query = (query + 1) % (kBlockCount * 2);
+  });
+}
+
+void BenchNodeTraverser()
+{
+  foreach (int chain_length, QVector<int>({10, 100, 1000})) {
+    Project project;
+
+    MathNode *last = nullptr;
+    for (int i=0; i<chain_length; i++) {
+      MathNode *math = new MathNode();
+      math->setParent(&project);
+      math->SetStandardValue(MathNode::kParamBIn, 1.0);
+
+      if (last) {
+        Node::ConnectEdge(last, NodeInput(math, MathNode::kParamAIn));
+      } else {
+        math->SetStandardValue(MathNode::kParamAIn, 1.0);
+      }
+
+      last = math;
+    }
+
+    NodeTraverser traverser;
+    TimeRange range(0, rational(1, 30));
+
+    RunBench(QStringLiteral("nodetraverser-%1").arg(chain_length), 100000 / chain_length,
+             [&traverser, last, &range]{
+      traverser.GenerateTable(last, range);
+    });
+  }
+}
+
+void BenchSumSamples()
+{
+  AudioParams params(48000, AV_CH_LAYOUT_STEREO, SampleFormat::F32);
+
+  const int kSampleCount = 48000 * 10;
+  SampleBuffer buffer(params, kSampleCount);
+
+  for (int channel=0; channel<params.channel_count(); channel++) {
+    float *data = buffer.data(channel);
+    for (int i=0; i<kSampleCount; i++) {
+      data[i] = float(i % 100) / 100.0f - 0.5f;
+    }
+  }
+
+  // One frame's worth of samples at 30 fps, the window the waveform cache sums at
+  const int kWindow = 1600;
+
+  RunBench(QStringLiteral("waveform-sumsamples"), 1000, [&buffer]{
+    for (int i=0; i+kWindow<=kSampleCount; i+=kWindow) {
+      AudioVisualWaveform::SumSamples(buffer, i, kWindow);
+    }
+  });
+}
+
+void BenchFrameCache()
+{
+  QDir bench_dir(QDir::temp().filePath(QStringLiteral("olive-micro-benchmark")));
+  bench_dir.mkpath(QStringLiteral("."));
+
+  FramePtr frame = Frame::Create();
+  frame->set_video_params(VideoParams(1920, 1080, PixelFormat::F16,
+                                      VideoParams::kRGBAChannelCount));
+  frame->allocate();
+
+  // Deterministic contents so compression work is stable across runs
+  uint8_t *data = reinterpret_cast<uint8_t*>(frame->data());
+  for (int i=0; i<frame->allocated_size(); i++) {
+    data[i] = i & 0xFF;
+  }
+
+  QString fn = bench_dir.filePath(QStringLiteral("frame"));
+
+  RunBench(QStringLiteral("framecache-save"), 50, [&fn, frame]{
+    FrameHashCache::SaveCacheFrame(fn, frame);
+  });
+
+  RunBench(QStringLiteral("framecache-load"), 50, [&fn]{
+    FrameHashCache::LoadCacheFrame(fn);
+  });
+
+  bench_dir.removeRecursively();
+}
+
+int RunMicroBenchmark(int argc, char **argv)
+{
+  QCoreApplication a(argc, argv);
+
+  printf("Render pipeline micro-benchmarks:\n");
+
+  BenchNodeValueTable();
+  BenchTrackBlockLookup();
+  BenchNodeTraverser();
+  BenchSumSamples();
+  BenchFrameCache();
+
+  if (argc > 1) {
+    QJsonArray benchmarks;
+    foreach (const BenchResult &r, results) {
+      QJsonObject o;
+      o.insert(QStringLiteral("name"), r.name);
+      o.insert(QStringLiteral("iterations"), r.iterations);
+      o.insert(QStringLiteral("ns_per_iter"), r.ns_per_iter);
+      benchmarks.append(o);
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("benchmarks"), benchmarks);
+
+    QFile json_file(QString::fromLocal8Bit(argv[1]));
+    if (!json_file.open(QFile::WriteOnly)) {
+      fprintf(stderr, "Failed to open JSON output file: %s\n", argv[1]);
+      return 1;
+    }
+    json_file.write(QJsonDocument(root).toJson());
+
+    printf("Results written to %s\n", argv[1]);
+  }
+
+  return 0;
+}
+
+}
+
+int main(int argc, char **argv)
+{
+  return olive::RunMicroBenchmark(argc, argv);
+}